@@ -0,0 +1,106 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+
+#include "JuceHeader.h"
+
+namespace Pedalboard {
+
+/**
+ * A fixed-capacity queue of multichannel audio that one thread can write to
+ * while another reads from it, without either thread taking a lock. Reads and
+ * writes are all-or-nothing: if there isn't enough space (or audio) for an
+ * entire call, nothing is written (or read) at all.
+ */
+template <typename SampleType> class AudioRingBuffer {
+public:
+  /**
+   * Allocate space for `capacity` samples per channel, and empty the buffer.
+   * Must not be called while any other thread is using this buffer.
+   */
+  void setSize(int numChannels, int capacity) {
+    // An AbstractFifo of size N only ever holds N - 1 items:
+    fifo.setTotalSize(capacity + 1);
+    fifo.reset();
+    buffer.setSize(numChannels, capacity + 1);
+    buffer.clear();
+  }
+
+  int getNumReady() const { return fifo.getNumReady(); }
+  int getFreeSpace() const { return fifo.getFreeSpace(); }
+
+  /**
+   * Append `numSamples` samples to this buffer. Each channel of this buffer is
+   * read from `channels[c % numChannels]`, or if `channels` is null, is
+   * filled with silence.
+   */
+  bool write(const SampleType *const *channels, int numChannels,
+             int numSamples) {
+    if (fifo.getFreeSpace() < numSamples)
+      return false;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+    for (int c = 0; c < buffer.getNumChannels(); c++) {
+      if (channels) {
+        const SampleType *source = channels[c % numChannels];
+        buffer.copyFrom(c, start1, source, size1);
+        if (size2 > 0)
+          buffer.copyFrom(c, start2, source + size1, size2);
+      } else {
+        buffer.clear(c, start1, size1);
+        if (size2 > 0)
+          buffer.clear(c, start2, size2);
+      }
+    }
+    fifo.finishedWrite(size1 + size2);
+    return true;
+  }
+
+  /**
+   * Remove `numSamples` samples from this buffer, copying channel c into
+   * `channels[c]` for every c < numChannels.
+   */
+  bool read(SampleType *const *channels, int numChannels, int numSamples) {
+    if (fifo.getNumReady() < numSamples)
+      return false;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(numSamples, start1, size1, start2, size2);
+    for (int c = 0; c < numChannels; c++) {
+      int sourceChannel = std::min(c, buffer.getNumChannels() - 1);
+      std::memcpy(channels[c], buffer.getReadPointer(sourceChannel, start1),
+                  size1 * sizeof(SampleType));
+      if (size2 > 0)
+        std::memcpy(channels[c] + size1,
+                    buffer.getReadPointer(sourceChannel, start2),
+                    size2 * sizeof(SampleType));
+    }
+    fifo.finishedRead(size1 + size2);
+    return true;
+  }
+
+private:
+  juce::AbstractFifo fifo{1};
+  juce::AudioBuffer<SampleType> buffer;
+};
+
+} // namespace Pedalboard
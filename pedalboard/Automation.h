@@ -0,0 +1,412 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include "JuceHeader.h"
+#include "Plugin.h"
+#include "Profiling.h"
+#include "RealtimeAudit.h"
+
+namespace py = pybind11;
+
+namespace Pedalboard {
+
+/**
+ * The default number of samples between updates of automated parameters.
+ */
+static constexpr int DEFAULT_AUTOMATION_INTERVAL = 32;
+
+/**
+ * The value of a single parameter over time, given either as one value per
+ * sample, or as (time in seconds, value) breakpoints between which the value
+ * is linearly interpolated. Before the first (or after the last) point, the
+ * first (or last) value is held.
+ */
+class AutomationCurve {
+public:
+  AutomationCurve(std::vector<float> valuePerSample)
+      : valuePerSample(std::move(valuePerSample)) {
+    if (this->valuePerSample.empty()) {
+      throw std::domain_error("Automation curves must contain at least one "
+                              "value.");
+    }
+    for (float value : this->valuePerSample)
+      throwIfNotFinite(value);
+  }
+
+  AutomationCurve(std::vector<std::pair<double, float>> breakpoints)
+      : breakpoints(std::move(breakpoints)) {
+    if (this->breakpoints.empty()) {
+      throw std::domain_error("Automation curves must contain at least one "
+                              "(time, value) point.");
+    }
+    for (size_t i = 0; i < this->breakpoints.size(); i++) {
+      double time = this->breakpoints[i].first;
+      if (!std::isfinite(time) || time < 0) {
+        throw std::domain_error(
+            "Automation point times must be non-negative numbers of seconds, "
+            "but got " +
+            std::to_string(time) + ".");
+      }
+      throwIfNotFinite(this->breakpoints[i].second);
+      if (i > 0 && time < this->breakpoints[i - 1].first) {
+        throw std::domain_error(
+            "Automation points must be sorted by time, but a point at " +
+            std::to_string(time) + " seconds follows a point at " +
+            std::to_string(this->breakpoints[i - 1].first) + " seconds.");
+      }
+    }
+  }
+
+  float getValueAt(long long sample, double sampleRate) const {
+    if (!valuePerSample.empty()) {
+      return valuePerSample[std::min(sample,
+                                     (long long)valuePerSample.size() - 1)];
+    }
+
+    double time = sample / sampleRate;
+    auto next = std::upper_bound(
+        breakpoints.begin(), breakpoints.end(), time,
+        [](double time, const auto &point) { return time < point.first; });
+    if (next == breakpoints.begin())
+      return next->second;
+    if (next == breakpoints.end())
+      return breakpoints.back().second;
+
+    auto previous = std::prev(next);
+    double position =
+        (time - previous->first) / (next->first - previous->first);
+    return (float)(previous->second +
+                   position * (next->second - previous->second));
+  }
+
+  float getMinimumValue() const { return getValueRange().first; }
+  float getMaximumValue() const { return getValueRange().second; }
+
+private:
+  static void throwIfNotFinite(float value) {
+    if (!std::isfinite(value)) {
+      throw std::domain_error("Automation values must be finite, but got " +
+                              std::to_string(value) + ".");
+    }
+  }
+
+  std::pair<float, float> getValueRange() const {
+    if (!valuePerSample.empty()) {
+      auto [minimum, maximum] =
+          std::minmax_element(valuePerSample.begin(), valuePerSample.end());
+      return {*minimum, *maximum};
+    }
+    auto [minimum, maximum] = std::minmax_element(
+        breakpoints.begin(), breakpoints.end(),
+        [](const auto &a, const auto &b) { return a.second < b.second; });
+    return {minimum->second, maximum->second};
+  }
+
+  std::vector<float> valuePerSample;
+  std::vector<std::pair<double, float>> breakpoints;
+};
+
+/**
+ * The automation curves applied to a single plugin's parameters while it
+ * processes audio. Parameters are updated every `interval` samples, counted
+ * from the last time the plugin was reset, so the same audio is produced
+ * regardless of the buffer size used.
+ */
+class PluginAutomation {
+public:
+  struct AutomatedParameter {
+    AutomationCurve curve;
+    std::function<void(float)> setValue;
+  };
+
+  /**
+   * Apply every curve at the current position if an update is due, and
+   * return the number of samples that can be processed before the next one.
+   */
+  int update(double sampleRate) {
+    int offsetInInterval = (int)(position % interval);
+    if (offsetInInterval == 0 || needsUpdate) {
+      for (auto &[name, parameter] : parameters) {
+        parameter.setValue(parameter.curve.getValueAt(position, sampleRate));
+      }
+      needsUpdate = false;
+    }
+    return interval - offsetInInterval;
+  }
+
+  std::map<std::string, AutomatedParameter> parameters;
+  int interval = DEFAULT_AUTOMATION_INTERVAL;
+
+  // The number of samples passed to this plugin since it was last reset:
+  long long position = 0;
+
+  // Set when the curves change, to apply them without waiting for the next
+  // multiple of `interval`:
+  bool needsUpdate = true;
+};
+
+/**
+ * A getter and setter for a float-valued parameter of a built-in plugin,
+ * which can be called without holding the GIL.
+ */
+struct AutomatableParameter {
+  std::function<float(Plugin &)> getValue;
+  std::function<void(Plugin &, float)> setValue;
+};
+
+inline std::map<std::pair<std::type_index, std::string>, AutomatableParameter> &
+getAutomatableParameters() {
+  // Leaked to avoid static destruction order issues at shutdown:
+  static auto *parameters =
+      new std::map<std::pair<std::type_index, std::string>,
+                   AutomatableParameter>();
+  return *parameters;
+}
+
+/**
+ * Allow the parameter with the given (Python) name to be automated on
+ * instances of PluginType. Called once per parameter at module load time,
+ * alongside the definition of the parameter's Python property.
+ */
+template <typename PluginType, typename Getter, typename Setter>
+void registerAutomatableParameter(const std::string &name, Getter getter,
+                                  Setter setter) {
+  getAutomatableParameters()[{std::type_index(typeid(PluginType)), name}] = {
+      [getter](Plugin &plugin) {
+        return (float)std::invoke(getter, static_cast<PluginType &>(plugin));
+      },
+      [setter](Plugin &plugin, float value) {
+        std::invoke(setter, static_cast<PluginType &>(plugin), value);
+      }};
+}
+
+inline std::vector<std::string> getAutomatableParameterNames(Plugin &plugin) {
+  std::vector<std::string> names;
+  for (const auto &[key, parameter] : getAutomatableParameters()) {
+    if (key.first == std::type_index(typeid(plugin)))
+      names.push_back(key.second);
+  }
+  return names;
+}
+
+/**
+ * Convert a Python automation curve (a 1D NumPy array with one value per
+ * sample, or a sequence of (time in seconds, value) pairs) to an
+ * AutomationCurve.
+ */
+inline AutomationCurve parseAutomationCurve(py::object values) {
+  if (py::isinstance<py::array>(values)) {
+    auto array = py::array_t<float, py::array::c_style |
+                                        py::array::forcecast>::ensure(values);
+    if (!array || array.ndim() != 1) {
+      throw std::domain_error(
+          "Automation values provided as an array must be one-dimensional, "
+          "with one value per sample.");
+    }
+    return AutomationCurve(
+        std::vector<float>(array.data(), array.data() + array.size()));
+  }
+
+  try {
+    return AutomationCurve(
+        values.cast<std::vector<std::pair<double, float>>>());
+  } catch (const py::cast_error &) {
+    throw py::type_error(
+        "Expected automation values to be a one-dimensional NumPy array (with "
+        "one value per sample) or a list of (time_in_seconds, value) pairs, "
+        "but got: " +
+        py::repr(values).cast<std::string>());
+  }
+}
+
+/**
+ * Replace (or if `curve` is empty, remove) the automation of one of a
+ * plugin's parameters. Takes the plugin's lock, so this never happens while
+ * the plugin is processing audio.
+ */
+inline void setParameterAutomation(Plugin &plugin, const std::string &name,
+                                   std::optional<AutomationCurve> curve,
+                                   std::function<void(float)> setValue) {
+  py::gil_scoped_release release;
+  std::lock_guard<std::mutex> lock(plugin.mutex);
+
+  if (!plugin.automation)
+    plugin.automation = std::make_shared<PluginAutomation>();
+
+  if (!curve) {
+    plugin.automation->parameters.erase(name);
+    return;
+  }
+
+  plugin.automation->parameters.insert_or_assign(
+      name, PluginAutomation::AutomatedParameter{*curve, setValue});
+  plugin.automation->needsUpdate = true;
+}
+
+inline bool isAutomated(const Plugin &plugin) {
+  return plugin.automation && !plugin.automation->parameters.empty();
+}
+
+template <typename SampleType>
+bool isSilent(const juce::dsp::AudioBlock<SampleType> &block) {
+  for (size_t c = 0; c < block.getNumChannels(); c++) {
+    const SampleType *channel = block.getChannelPointer(c);
+    for (size_t i = 0; i < block.getNumSamples(); i++) {
+      if (channel[i] != 0)
+        return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Check if the provided plugin can skip processing the provided block,
+ * which it can do if skipSilence is enabled, the block is entirely silent,
+ * and the plugin has already received at least getTailLengthSamples() of
+ * silence. (Any output from the plugin will have decayed to silence by then,
+ * so the block's contents are already the plugin's output.)
+ *
+ * The plugin is reset when it starts skipping, so that processing resumes
+ * from a silent state when the block is no longer silent. Plugins that are
+ * automated or have latency are never skipped.
+ *
+ * Must be called with the plugin's mutex held, on every block the plugin
+ * would otherwise process.
+ */
+template <typename SampleType>
+bool skipIfSilent(
+    Plugin &plugin,
+    const juce::dsp::ProcessContextReplacing<SampleType> &context) {
+  if (!plugin.skipSilence)
+    return false;
+
+  if (isAutomated(plugin)) {
+    plugin.silentInputSamples = 0;
+    plugin.skippingSilence = false;
+    return false;
+  }
+
+  auto block = context.getOutputBlock();
+  if (!isSilent(block)) {
+    plugin.silentInputSamples = 0;
+    plugin.skippingSilence = false;
+    return false;
+  }
+
+  long long silenceBeforeBlock = plugin.silentInputSamples;
+  plugin.silentInputSamples += block.getNumSamples();
+
+  if (plugin.skippingSilence)
+    return true;
+
+  if (plugin.getLatencyHint() != 0)
+    return false;
+
+  int tailLengthSamples = plugin.getTailLengthSamples();
+  if (tailLengthSamples < 0 || silenceBeforeBlock < tailLengthSamples)
+    return false;
+
+  plugin.reset();
+  plugin.skippingSilence = true;
+  return true;
+}
+
+/**
+ * Make every automated parameter of the provided plugins start from the
+ * beginning of its curve again. Called whenever the plugins are reset.
+ */
+inline void rewindAutomation(Plugin &plugin) {
+  if (plugin.automation) {
+    plugin.automation->position = 0;
+    plugin.automation->needsUpdate = true;
+  }
+}
+
+inline void
+rewindAutomation(const std::vector<std::shared_ptr<Plugin>> &plugins) {
+  for (auto &plugin : plugins) {
+    if (plugin)
+      rewindAutomation(*plugin);
+  }
+}
+
+/**
+ * Run a block of audio through a plugin, updating any of its automated
+ * parameters every PluginAutomation::interval samples along the way. As
+ * with Plugin::process, any output is right-aligned in the block.
+ */
+template <typename SampleType>
+int processWithAutomation(
+    Plugin &plugin,
+    const juce::dsp::ProcessContextReplacing<SampleType> &context,
+    double sampleRate) {
+  RealtimeAuditScope auditScope(plugin);
+  if (skipIfSilent(plugin, context))
+    return context.getOutputBlock().getNumSamples();
+
+  ProfilingScope profilingScope(plugin,
+                                context.getOutputBlock().getNumSamples());
+  if (!isAutomated(plugin))
+    return plugin.process(context);
+
+  PluginAutomation *automation = plugin.automation.get();
+  auto ioBlock = context.getOutputBlock();
+  const int numSamples = (int)ioBlock.getNumSamples();
+
+  int samplesOutput = 0;
+  for (int start = 0; start < numSamples;) {
+    int length = std::min(numSamples - start, automation->update(sampleRate));
+    auto subBlock = ioBlock.getSubBlock(start, length);
+    juce::dsp::ProcessContextReplacing<SampleType> subContext(subBlock);
+    int subBlockOutput = plugin.process(subContext);
+
+    // Each sub-block's output is right-aligned within that sub-block; move
+    // the output received so far up against it to keep it contiguous:
+    if (samplesOutput > 0 && subBlockOutput < length) {
+      for (size_t c = 0; c < ioBlock.getNumChannels(); c++) {
+        SampleType *channel = ioBlock.getChannelPointer(c);
+        std::memmove(channel + start + length - subBlockOutput - samplesOutput,
+                     channel + start - samplesOutput,
+                     sizeof(SampleType) * samplesOutput);
+      }
+    }
+
+    samplesOutput += subBlockOutput;
+    automation->position += length;
+    start += length;
+  }
+  return samplesOutput;
+}
+
+} // namespace Pedalboard
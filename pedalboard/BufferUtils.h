@@ -17,6 +17,23 @@
 
 #pragma once
 #include "JuceHeader.h"
+#include <algorithm>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                 \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <xmmintrin.h>
+#define PEDALBOARD_USE_SSE_TRANSPOSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define PEDALBOARD_USE_NEON_TRANSPOSE 1
+#endif
+
+#if PEDALBOARD_USE_SSE_TRANSPOSE || PEDALBOARD_USE_NEON_TRANSPOSE
+#define PEDALBOARD_HAS_SIMD_TRANSPOSE 1
+#endif
+
+#include "simd/Dispatch.h"
 
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
@@ -27,6 +44,255 @@ enum class ChannelLayout {
   NotInterleaved,
 };
 
+/**
+ * The number of frames to (de-)interleave at once. Processing interleaved
+ * audio in tiles of this many frames keeps both the interleaved source and
+ * each channel's destination in cache, regardless of the number of channels.
+ */
+static constexpr unsigned int INTERLEAVE_TILE_SIZE_FRAMES = 256;
+
+namespace simd {
+// (De-)interleaving stereo 32-bit float audio (by far the most common format
+// passed in from Python) is done by the runtime-dispatched kernels in
+// simd/Kernels.h. For any other number of channels, groups of four channels
+// are transposed four frames at a time, which 128-bit vectors do just as well
+// on every CPU:
+#if PEDALBOARD_USE_SSE_TRANSPOSE
+/**
+ * Load four floats from each of four source pointers and store them,
+ * transposed, to four destination pointers. (i.e.: destination[j][k] =
+ * source[k][j].)
+ */
+inline void transpose4x4(const float *const source[4],
+                         float *const destination[4]) {
+  __m128 r0 = _mm_loadu_ps(source[0]);
+  __m128 r1 = _mm_loadu_ps(source[1]);
+  __m128 r2 = _mm_loadu_ps(source[2]);
+  __m128 r3 = _mm_loadu_ps(source[3]);
+  _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+  _mm_storeu_ps(destination[0], r0);
+  _mm_storeu_ps(destination[1], r1);
+  _mm_storeu_ps(destination[2], r2);
+  _mm_storeu_ps(destination[3], r3);
+}
+#elif PEDALBOARD_USE_NEON_TRANSPOSE
+inline void transpose4x4(const float *const source[4],
+                         float *const destination[4]) {
+  float32x4x2_t t01 = vtrnq_f32(vld1q_f32(source[0]), vld1q_f32(source[1]));
+  float32x4x2_t t23 = vtrnq_f32(vld1q_f32(source[2]), vld1q_f32(source[3]));
+  vst1q_f32(destination[0], vcombine_f32(vget_low_f32(t01.val[0]),
+                                         vget_low_f32(t23.val[0])));
+  vst1q_f32(destination[1], vcombine_f32(vget_low_f32(t01.val[1]),
+                                         vget_low_f32(t23.val[1])));
+  vst1q_f32(destination[2], vcombine_f32(vget_high_f32(t01.val[0]),
+                                         vget_high_f32(t23.val[0])));
+  vst1q_f32(destination[3], vcombine_f32(vget_high_f32(t01.val[1]),
+                                         vget_high_f32(t23.val[1])));
+}
+#endif
+} // namespace simd
+
+/**
+ * Split interleaved audio (i.e.: [L, R, L, R, ...]) into separate buffers for
+ * each channel. Supports any number of channels.
+ */
+template <typename T>
+void deinterleaveSamples(const T *interleaved, T *const *channels,
+                         unsigned int numChannels, unsigned int numFrames) {
+  if (numChannels == 1) {
+    std::copy(interleaved, interleaved + numFrames, channels[0]);
+    return;
+  }
+
+  for (unsigned int tileStart = 0; tileStart < numFrames;
+       tileStart += INTERLEAVE_TILE_SIZE_FRAMES) {
+    unsigned int tileEnd =
+        std::min(tileStart + INTERLEAVE_TILE_SIZE_FRAMES, numFrames);
+
+    if (numChannels == 2) {
+      // By far the most common case, so avoid the inner loop over channels:
+      T *left = channels[0];
+      T *right = channels[1];
+      unsigned int i = tileStart;
+      if constexpr (std::is_same<T, float>::value) {
+        i += simd::getKernels().deinterleaveStereo(
+            interleaved + i * 2, left + i, right + i, tileEnd - i);
+      }
+      for (; i < tileEnd; i++) {
+        left[i] = interleaved[i * 2];
+        right[i] = interleaved[i * 2 + 1];
+      }
+    } else {
+      unsigned int c = 0;
+#if PEDALBOARD_HAS_SIMD_TRANSPOSE
+      if constexpr (std::is_same<T, float>::value) {
+        // Transpose groups of four channels, four frames at a time:
+        unsigned int vectorEnd = tileStart + ((tileEnd - tileStart) & ~3u);
+        for (; c + 4 <= numChannels; c += 4) {
+          for (unsigned int i = tileStart; i < vectorEnd; i += 4) {
+            const float *source[4];
+            float *destination[4];
+            for (unsigned int k = 0; k < 4; k++) {
+              source[k] = interleaved + (size_t)(i + k) * numChannels + c;
+              destination[k] = channels[c + k] + i;
+            }
+            simd::transpose4x4(source, destination);
+          }
+          for (unsigned int k = 0; k < 4; k++) {
+            for (unsigned int i = vectorEnd; i < tileEnd; i++) {
+              channels[c + k][i] = interleaved[(size_t)i * numChannels + c + k];
+            }
+          }
+        }
+      }
+#endif
+      for (; c < numChannels; c++) {
+        T *channel = channels[c];
+        const T *source = interleaved + c;
+        for (unsigned int i = tileStart; i < tileEnd; i++) {
+          channel[i] = source[(size_t)i * numChannels];
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Combine separate buffers for each channel into a single interleaved buffer
+ * (i.e.: [L, R, L, R, ...]). Supports any number of channels.
+ */
+template <typename T>
+void interleaveSamples(const T *const *channels, T *interleaved,
+                       unsigned int numChannels, unsigned int numFrames) {
+  if (numChannels == 1) {
+    std::copy(channels[0], channels[0] + numFrames, interleaved);
+    return;
+  }
+
+  for (unsigned int tileStart = 0; tileStart < numFrames;
+       tileStart += INTERLEAVE_TILE_SIZE_FRAMES) {
+    unsigned int tileEnd =
+        std::min(tileStart + INTERLEAVE_TILE_SIZE_FRAMES, numFrames);
+
+    if (numChannels == 2) {
+      const T *left = channels[0];
+      const T *right = channels[1];
+      unsigned int i = tileStart;
+      if constexpr (std::is_same<T, float>::value) {
+        i += simd::getKernels().interleaveStereo(left + i, right + i,
+                                                 interleaved + i * 2,
+                                                 tileEnd - i);
+      }
+      for (; i < tileEnd; i++) {
+        interleaved[i * 2] = left[i];
+        interleaved[i * 2 + 1] = right[i];
+      }
+    } else {
+      unsigned int c = 0;
+#if PEDALBOARD_HAS_SIMD_TRANSPOSE
+      if constexpr (std::is_same<T, float>::value) {
+        unsigned int vectorEnd = tileStart + ((tileEnd - tileStart) & ~3u);
+        for (; c + 4 <= numChannels; c += 4) {
+          for (unsigned int i = tileStart; i < vectorEnd; i += 4) {
+            const float *source[4];
+            float *destination[4];
+            for (unsigned int k = 0; k < 4; k++) {
+              source[k] = channels[c + k] + i;
+              destination[k] = interleaved + (size_t)(i + k) * numChannels + c;
+            }
+            simd::transpose4x4(source, destination);
+          }
+          for (unsigned int k = 0; k < 4; k++) {
+            for (unsigned int i = vectorEnd; i < tileEnd; i++) {
+              interleaved[(size_t)i * numChannels + c + k] = channels[c + k][i];
+            }
+          }
+        }
+      }
+#endif
+      for (; c < numChannels; c++) {
+        const T *channel = channels[c];
+        T *destination = interleaved + c;
+        for (unsigned int i = tileStart; i < tileEnd; i++) {
+          destination[(size_t)i * numChannels] = channel[i];
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Returns true if the provided object is not a NumPy array, but is a tensor
+ * that supports the DLPack protocol (i.e.: a PyTorch, JAX or TensorFlow
+ * tensor).
+ */
+inline bool isDLPackTensor(const py::handle &object) {
+  return !py::isinstance<py::array>(object) &&
+         py::hasattr(object, "__dlpack__");
+}
+
+/**
+ * Return the provided object as a NumPy array. DLPack-compatible tensors in
+ * CPU memory are wrapped without copying their data (via numpy.from_dlpack);
+ * tensors stored on other devices must be moved to the CPU first.
+ *
+ * If `allowConversion` is true, any other object is converted to an array
+ * with numpy.asarray (which may copy); otherwise, a TypeError is raised.
+ */
+inline py::array asArray(py::object input, bool allowConversion = true) {
+  if (py::isinstance<py::array>(input))
+    return input.cast<py::array>();
+
+  py::module_ numpy = py::module_::import("numpy");
+  if (isDLPackTensor(input)) {
+    if (py::hasattr(input, "__dlpack_device__")) {
+      // DLPack's device type enum uses 1 for CPU memory (kDLCPU):
+      int deviceType =
+          input.attr("__dlpack_device__")().cast<py::tuple>()[0].cast<int>();
+      if (deviceType != 1) {
+        throw py::type_error(
+            "Pedalboard can only process tensors stored in CPU memory. Move "
+            "this tensor to the CPU (i.e.: with .cpu()) before passing it to "
+            "Pedalboard.");
+      }
+    }
+
+    // NumPy 1.22 and later can import DLPack tensors without copying:
+    if (py::hasattr(numpy, "from_dlpack"))
+      return numpy.attr("from_dlpack")(input).cast<py::array>();
+    return numpy.attr("asarray")(input).cast<py::array>();
+  }
+
+  if (!allowConversion) {
+    throw py::type_error(
+        "Expected a NumPy array or a tensor supporting the DLPack protocol, "
+        "but got an object of type " +
+        py::str(py::type::handle_of(input).attr("__name__"))
+            .cast<std::string>() +
+        ".");
+  }
+  return numpy.attr("asarray")(input).cast<py::array>();
+}
+
+/**
+ * Return the provided output array as the same kind of object as `input`. If
+ * `input` was a DLPack-compatible tensor, the output is wrapped (without
+ * copying) in a tensor from the same library using its `from_dlpack`
+ * function, if it has one. Otherwise, the NumPy array is returned as-is.
+ */
+inline py::object wrapArrayLike(py::array output, const py::handle &input) {
+  if (!isDLPackTensor(input))
+    return std::move(output);
+
+  std::string moduleName =
+      py::type::handle_of(input).attr("__module__").cast<std::string>();
+  moduleName = moduleName.substr(0, moduleName.find('.'));
+  py::object module = py::module_::import(moduleName.c_str());
+  if (!py::hasattr(module, "from_dlpack"))
+    return std::move(output);
+  return module.attr("from_dlpack")(output);
+}
+
 template <typename T>
 ChannelLayout
 detectChannelLayout(const py::array_t<T, py::array::c_style> inputArray) {
@@ -50,23 +316,16 @@ detectChannelLayout(const py::array_t<T, py::array::c_style> inputArray) {
   }
 }
 
-template <typename T>
-juce::AudioBuffer<T> copyPyArrayIntoJuceBuffer(
-    const py::array_t<T, py::array::c_style> inputArray,
-    std::optional<ChannelLayout> providedChannelLayout = {}) {
-  // Numpy/Librosa convention is (num_samples, num_channels)
-  py::buffer_info inputInfo = inputArray.request();
-
+/**
+ * Return the number of channels and samples in a buffer requested from a 1D
+ * or 2D NumPy array with the provided channel layout.
+ */
+inline std::pair<unsigned int, unsigned int>
+getNumChannelsAndSamples(const py::buffer_info &inputInfo,
+                         ChannelLayout inputChannelLayout) {
   unsigned int numChannels = 0;
   unsigned int numSamples = 0;
 
-  ChannelLayout inputChannelLayout;
-  if (providedChannelLayout) {
-    inputChannelLayout = *providedChannelLayout;
-  } else {
-    inputChannelLayout = detectChannelLayout(inputArray);
-  }
-
   if (inputInfo.ndim == 1) {
     numSamples = inputInfo.shape[0];
     numChannels = 1;
@@ -91,11 +350,25 @@ juce::AudioBuffer<T> copyPyArrayIntoJuceBuffer(
 
   if (numChannels == 0) {
     throw std::runtime_error("No channels passed!");
-  } else if (numChannels > 2) {
-    throw std::runtime_error("More than two channels received!");
   }
 
-  juce::AudioBuffer<T> ioBuffer(numChannels, numSamples);
+  return {numChannels, numSamples};
+}
+
+/**
+ * Copy the audio in a buffer requested from a NumPy array into the start of
+ * the provided JUCE AudioBuffer, which must be at least as large. As this
+ * doesn't touch any Python objects, it can be called without holding the GIL
+ * (as long as the array the buffer was requested from is kept alive).
+ */
+template <typename T>
+void copyBufferInfoIntoJuceBuffer(const py::buffer_info &inputInfo,
+                                  ChannelLayout inputChannelLayout,
+                                  juce::AudioBuffer<T> &ioBuffer) {
+  auto [numChannels, numSamples] =
+      getNumChannelsAndSamples(inputInfo, inputChannelLayout);
+  jassert(ioBuffer.getNumChannels() >= (int)numChannels);
+  jassert(ioBuffer.getNumSamples() >= (int)numSamples);
 
   // Depending on the input channel layout, we need to copy data
   // differently. This loop is duplicated here to move the if statement
@@ -103,13 +376,10 @@ juce::AudioBuffer<T> copyPyArrayIntoJuceBuffer(
   // channel is still the same on every iteration of the loop.
   switch (inputChannelLayout) {
   case ChannelLayout::Interleaved:
-    for (unsigned int i = 0; i < numChannels; i++) {
-      T *channelBuffer = ioBuffer.getWritePointer(i);
-      // We're de-interleaving the data here, so we can't use copyFrom.
-      for (unsigned int j = 0; j < numSamples; j++) {
-        channelBuffer[j] = static_cast<T *>(inputInfo.ptr)[j * numChannels + i];
-      }
-    }
+    // We're de-interleaving the data here, so we can't use copyFrom.
+    deinterleaveSamples(static_cast<const T *>(inputInfo.ptr),
+                        ioBuffer.getArrayOfWritePointers(), numChannels,
+                        numSamples);
     break;
   case ChannelLayout::NotInterleaved:
     for (unsigned int i = 0; i < numChannels; i++) {
@@ -120,7 +390,26 @@ juce::AudioBuffer<T> copyPyArrayIntoJuceBuffer(
   default:
     throw std::runtime_error("Internal error: got unexpected channel layout.");
   }
+}
 
+template <typename T>
+juce::AudioBuffer<T> copyPyArrayIntoJuceBuffer(
+    const py::array_t<T, py::array::c_style> inputArray,
+    std::optional<ChannelLayout> providedChannelLayout = {}) {
+  // Numpy/Librosa convention is (num_samples, num_channels)
+  py::buffer_info inputInfo = inputArray.request();
+
+  ChannelLayout inputChannelLayout;
+  if (providedChannelLayout) {
+    inputChannelLayout = *providedChannelLayout;
+  } else {
+    inputChannelLayout = detectChannelLayout(inputArray);
+  }
+
+  auto [numChannels, numSamples] =
+      getNumChannelsAndSamples(inputInfo, inputChannelLayout);
+  juce::AudioBuffer<T> ioBuffer(numChannels, numSamples);
+  copyBufferInfoIntoJuceBuffer(inputInfo, inputChannelLayout, ioBuffer);
   return ioBuffer;
 }
 
@@ -173,8 +462,6 @@ const juce::AudioBuffer<T> convertPyArrayIntoJuceBuffer(
 
     if (numChannels == 0) {
       throw std::runtime_error("No channels passed!");
-    } else if (numChannels > 2) {
-      throw std::runtime_error("More than two channels received!");
     }
 
     T **channelPointers = (T **)alloca(numChannels * sizeof(T *));
@@ -189,6 +476,44 @@ const juce::AudioBuffer<T> convertPyArrayIntoJuceBuffer(
   }
 }
 
+/**
+ * Wrap a writeable, C-contiguous, non-interleaved Python array in a JUCE
+ * AudioBuffer that points directly at the array's memory. Any changes made to
+ * the returned buffer will be visible in the Python array. The Python array
+ * must outlive the returned buffer, and the returned buffer must never be
+ * resized.
+ */
+template <typename T>
+juce::AudioBuffer<T>
+wrapPyArrayAsJuceBuffer(py::array_t<T, py::array::c_style> &inputArray) {
+  py::buffer_info inputInfo = inputArray.request(/* writable= */ true);
+
+  unsigned int numChannels = 0;
+  unsigned int numSamples = 0;
+
+  if (inputInfo.ndim == 1) {
+    numSamples = inputInfo.shape[0];
+    numChannels = 1;
+  } else if (inputInfo.ndim == 2) {
+    numSamples = inputInfo.shape[1];
+    numChannels = inputInfo.shape[0];
+  } else {
+    throw std::runtime_error("Number of input dimensions must be 1 or 2 (got " +
+                             std::to_string(inputInfo.ndim) + ").");
+  }
+
+  if (numChannels == 0) {
+    throw std::runtime_error("No channels passed!");
+  }
+
+  T **channelPointers = (T **)alloca(numChannels * sizeof(T *));
+  for (unsigned int c = 0; c < numChannels; c++) {
+    channelPointers[c] = static_cast<T *>(inputInfo.ptr) + (c * numSamples);
+  }
+
+  return juce::AudioBuffer<T>(channelPointers, numChannels, numSamples);
+}
+
 template <typename T>
 py::array_t<T> copyJuceBufferIntoPyArray(const juce::AudioBuffer<T> &juceBuffer,
                                          ChannelLayout channelLayout,
@@ -226,15 +551,17 @@ py::array_t<T> copyJuceBufferIntoPyArray(const juce::AudioBuffer<T> &juceBuffer,
 
   if (juceBuffer.getNumSamples() > 0) {
     switch (channelLayout) {
-    case ChannelLayout::Interleaved:
+    case ChannelLayout::Interleaved: {
+      const T **channelPointers =
+          (const T **)alloca(numChannels * sizeof(const T *));
       for (unsigned int i = 0; i < numChannels; i++) {
-        const T *channelBuffer = juceBuffer.getReadPointer(i, offsetSamples);
-        // We're interleaving the data here, so we can't use copyFrom.
-        for (unsigned int j = 0; j < outputSampleCount; j++) {
-          outputBasePointer[j * numChannels + i] = channelBuffer[j];
-        }
+        channelPointers[i] = juceBuffer.getReadPointer(i, offsetSamples);
       }
+      // We're interleaving the data here, so we can't use copyFrom.
+      interleaveSamples(channelPointers, outputBasePointer, numChannels,
+                        outputSampleCount);
       break;
+    }
     case ChannelLayout::NotInterleaved:
       for (unsigned int i = 0; i < numChannels; i++) {
         const T *channelBuffer = juceBuffer.getReadPointer(i, offsetSamples);
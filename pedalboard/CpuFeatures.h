@@ -0,0 +1,85 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <pybind11/pybind11.h>
+
+#include "simd/Dispatch.h"
+
+namespace py = pybind11;
+
+namespace Pedalboard {
+
+inline void init_cpu_features(py::module &m) {
+  // Choose kernels when Pedalboard is imported, rather than the first time
+  // any audio is processed:
+  simd::getKernels();
+
+  m.def(
+      "cpu_features",
+      []() {
+        const simd::CpuFeatures &features = simd::getCpuFeatures();
+        py::dict result;
+        result["sse2"] = features.sse2;
+        result["sse4_1"] = features.sse41;
+        result["avx"] = features.avx;
+        result["avx2"] = features.avx2;
+        result["fma"] = features.fma;
+        result["avx512f"] = features.avx512f;
+        result["neon"] = features.neon;
+
+        py::list available;
+        for (const simd::Kernels *kernels :
+             simd::getSupportedKernels(features)) {
+          available.append(kernels->name);
+        }
+        result["available_kernels"] = available;
+        result["kernels"] = simd::getKernels().name;
+        return result;
+      },
+      R"(
+Return a dictionary describing the SIMD instruction sets supported by this
+CPU, and which of Pedalboard's SIMD kernels are in use.
+
+Pedalboard's hottest inner loops (including those used by :class:`Gain`,
+:class:`Clipping`, :class:`Bitcrush`, :class:`Convolution`, the filters used
+by :class:`EQ` and :class:`LoudnessMeter`, polyphase resampling, and the
+conversion of stereo audio to and from NumPy arrays) are compiled several
+times, once for each instruction set, and the most capable set of kernels
+supported by the CPU is chosen when Pedalboard is imported:
+
+ - ``"avx512"``: x86 CPUs with AVX-512F, AVX2, and FMA.
+ - ``"avx2"``: x86 CPUs with AVX2 and FMA.
+ - ``"sse2"``: all other 64-bit x86 CPUs.
+ - ``"neon"``: 64-bit ARM CPUs (including Apple Silicon and AWS Graviton).
+ - ``"scalar"``: any other CPU.
+
+The returned dictionary contains a boolean for each of the instruction set
+extensions ``sse2``, ``sse4_1``, ``avx``, ``avx2``, ``fma``, ``avx512f``, and
+``neon``, along with ``available_kernels`` (a list of the names of every set of
+kernels this CPU can run) and ``kernels`` (the name of the set in use).
+
+To use a specific set of kernels (i.e.: to compare their output or
+performance), set the ``PEDALBOARD_SIMD`` environment variable to one of the
+names in ``available_kernels`` before importing Pedalboard.
+
+*Introduced in v0.9.0.*
+)");
+}
+
+} // namespace Pedalboard
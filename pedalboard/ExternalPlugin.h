@@ -17,8 +17,15 @@
 
 #pragma once
 
+#include <atomic>
+#include <map>
 #include <mutex>
 #include <optional>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <variant>
+#include <vector>
 
 #include "JuceHeader.h"
 #if JUCE_LINUX
@@ -63,8 +70,9 @@ were returned than expected, the plugin has likely buffered audio inside
 itself. To receive the remaining audio, pass another audio buffer into 
 ``process`` with ``reset`` set to ``True``.
 
-If the provided buffer uses a 64-bit datatype, it will be converted to 32-bit
-for processing.
+If the provided buffer uses a 64-bit datatype, it will be processed and
+returned as 64-bit audio. (Plugins that don't support 64-bit processing
+natively will still process audio with 32-bit precision internally.)
 
 If provided MIDI messages as input, the provided ``midi_messages`` must be
 a Python ``List`` containing one of the following types:
@@ -165,6 +173,48 @@ An example of how to programmatically close an editor window::
    # This will block until the other thread calls .set():
    plugin.show_editor(close_window_event)
 )";
+static constexpr const char *EXTERNAL_PLUGIN_PROCESS_BATCH_DOCSTRING = R"(
+Run many independent audio buffers *or* MIDI clips through this plugin,
+returning a list of rendered buffers in the same order.
+
+When provided MIDI clips (each a list of MIDI messages, in any of the
+formats accepted by :py:meth:`process`), each clip is rendered into
+``duration`` seconds of audio. ``duration`` may be a single number, or a
+list with one duration per clip.
+
+Clips are spread across ``num_workers`` native threads (by default, one
+per CPU core) without holding Python's Global Interpreter Lock. Every
+thread other than the first renders clips through its own clone of this
+plugin, with its state copied from this plugin (via its
+``getStateInformation`` and ``setStateInformation`` methods) on every call.
+Clones are created the first time they're needed and are kept for later
+calls, as loading a plugin can be slow; as with loading a plugin, clones
+can only be created on the main thread.
+
+Before rendering each clip, the plugin rendering it is reset with its
+own ``reset`` method rather than being reloaded from scratch (as
+:py:meth:`process` does with ``reset=True`` for most instrument plugins),
+so instruments that keep sounding after being reset may produce sound
+from one clip at the start of the next.
+
+Audio buffers are processed exactly as they would be by
+:py:meth:`pedalboard.Plugin.process_batch`; only plugins that clear their
+internal buffers when reset can be processed on multiple threads.
+
+*Introduced in v0.9.0.*
+)";
+
+static constexpr const char *CLEAR_INSTANCE_POOL_DOCSTRING = R"(
+Delete all idle plugin instances of this format that were created with
+``pooled=True`` and returned to the instance pool when their plugin objects
+were destroyed. Returns the number of instances deleted.
+
+Pooled instances are kept loaded (along with the global state that
+plugins depend on) until this method is called, which happens automatically
+at interpreter exit.
+
+*Introduced in v0.9.0.*
+)";
 
 inline std::vector<std::string> findInstalledVSTPluginPaths() {
   // Ensure we have a MessageManager, which is required by the VST wrapper
@@ -304,33 +354,198 @@ static bool audioUnitIsInstalled(const juce::String audioUnitFilePath) {
   return audioUnitFilePath.contains("/Library/Audio/Plug-Ins/Components/");
 }
 
+/**
+ * An optional on-disk cache of the plugin descriptions found in each plugin
+ * file, similar to juce::KnownPluginList. Scanning a plugin file requires
+ * loading its code, which can be slow; if a cache file path has been set,
+ * files whose modification times haven't changed since they were last
+ * scanned are not scanned again.
+ *
+ * The cache file is re-read whenever it changes on disk, so that multiple
+ * processes can share the same cache file.
+ */
+class PluginScanCache {
+public:
+  static PluginScanCache &getInstance() {
+    static PluginScanCache *cache = new PluginScanCache();
+    return *cache;
+  }
+
+  std::optional<std::string> getPath() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (cacheFile == juce::File())
+      return {};
+    return cacheFile.getFullPathName().toStdString();
+  }
+
+  void setPath(std::optional<std::string> path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    lastLoadedModificationTime = 0;
+    cacheFile = path ? juce::File::getCurrentWorkingDirectory().getChildFile(
+                           juce::String(*path))
+                     : juce::File();
+  }
+
+  /**
+   * Add the cached descriptions of the plugins in the given file to
+   * typesFound, returning false if the file must be scanned instead.
+   */
+  bool lookup(const juce::String &formatName, const juce::String &pluginFile,
+              juce::OwnedArray<juce::PluginDescription> &typesFound) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (cacheFile == juce::File())
+      return false;
+    reloadIfChanged();
+
+    auto it = entries.find({formatName, pluginFile});
+    if (it == entries.end() ||
+        it->second.modificationTime != getModificationTime(pluginFile))
+      return false;
+
+    for (auto &description : it->second.descriptions)
+      typesFound.add(new juce::PluginDescription(description));
+    return true;
+  }
+
+  void store(const juce::String &formatName, const juce::String &pluginFile,
+             const juce::OwnedArray<juce::PluginDescription> &typesFound) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (cacheFile == juce::File())
+      return;
+    reloadIfChanged();
+
+    Entry &entry = entries[{formatName, pluginFile}];
+    entry.modificationTime = getModificationTime(pluginFile);
+    entry.descriptions.clear();
+    for (auto *description : typesFound)
+      entry.descriptions.push_back(*description);
+
+    save();
+  }
+
+private:
+  PluginScanCache() {}
+
+  struct Entry {
+    juce::int64 modificationTime = 0;
+    std::vector<juce::PluginDescription> descriptions;
+  };
+
+  static juce::int64 getModificationTime(const juce::String &pluginFile) {
+    return juce::File::createFileWithoutCheckingPath(pluginFile)
+        .getLastModificationTime()
+        .toMilliseconds();
+  }
+
+  void reloadIfChanged() {
+    auto modificationTime = cacheFile.getLastModificationTime().toMilliseconds();
+    if (modificationTime == lastLoadedModificationTime)
+      return;
+
+    entries.clear();
+    lastLoadedModificationTime = modificationTime;
+
+    // A missing or unreadable cache file is treated as an empty cache:
+    auto xml = juce::parseXMLIfTagMatches(cacheFile, "PEDALBOARDPLUGINCACHE");
+    if (!xml)
+      return;
+
+    for (auto *fileElement : xml->getChildWithTagNameIterator("FILE")) {
+      Entry entry;
+      entry.modificationTime =
+          fileElement->getStringAttribute("modified").getLargeIntValue();
+      for (auto *pluginElement : fileElement->getChildIterator()) {
+        juce::PluginDescription description;
+        if (description.loadFromXml(*pluginElement))
+          entry.descriptions.push_back(description);
+      }
+      entries[{fileElement->getStringAttribute("format"),
+               fileElement->getStringAttribute("path")}] = std::move(entry);
+    }
+  }
+
+  void save() {
+    juce::XmlElement xml("PEDALBOARDPLUGINCACHE");
+    for (auto &[key, entry] : entries) {
+      auto *fileElement = xml.createNewChildElement("FILE");
+      fileElement->setAttribute("format", key.first);
+      fileElement->setAttribute("path", key.second);
+      fileElement->setAttribute("modified",
+                                juce::String(entry.modificationTime));
+      for (auto &description : entry.descriptions)
+        fileElement->addChildElement(description.createXml().release());
+    }
+
+    // Write to a temporary file first, so that other processes reading the
+    // cache never see a partially-written file:
+    cacheFile.getParentDirectory().createDirectory();
+    juce::TemporaryFile temporaryFile(cacheFile);
+    if (xml.writeTo(temporaryFile.getFile()) &&
+        temporaryFile.overwriteTargetFileWithTemporary()) {
+      lastLoadedModificationTime =
+          cacheFile.getLastModificationTime().toMilliseconds();
+    }
+  }
+
+  std::mutex mutex;
+  juce::File cacheFile;
+  juce::int64 lastLoadedModificationTime = 0;
+
+  // Keyed by (plugin format name, path to plugin file):
+  std::map<std::pair<juce::String, juce::String>, Entry> entries;
+};
+
+/**
+ * Find all of the plugins contained in the given plugin file, using the
+ * PluginScanCache if possible.
+ */
+template <typename ExternalPluginType>
+static void scanPluginFile(const juce::String &pluginFile,
+                           juce::OwnedArray<juce::PluginDescription> &typesFound) {
+  ExternalPluginType format;
+  auto &cache = PluginScanCache::getInstance();
+  if (cache.lookup(format.getName(), pluginFile, typesFound))
+    return;
+
+#if JUCE_PLUGINHOST_AU && JUCE_MAC
+  if constexpr (std::is_same<ExternalPluginType,
+                             juce::AudioUnitPluginFormat>::value) {
+    auto identifiers = getAudioUnitIdentifiersFromFile(pluginFile);
+    // For each plugin in the identified bundle, scan using its AU identifier:
+    for (int i = 0; i < identifiers.size(); i++) {
+      format.findAllTypesForFile(typesFound, identifiers[i]);
+    }
+  } else {
+    format.findAllTypesForFile(typesFound, pluginFile);
+  }
+#else
+  format.findAllTypesForFile(typesFound, pluginFile);
+#endif
+
+  // Don't cache failures, which may be transient:
+  if (!typesFound.isEmpty())
+    cache.store(format.getName(), pluginFile, typesFound);
+}
+
 template <typename ExternalPluginType>
 static std::vector<std::string> getPluginNamesForFile(std::string filename) {
   juce::MessageManager::getInstance();
 
-  ExternalPluginType format;
   juce::OwnedArray<juce::PluginDescription> typesFound;
 
   std::string errorMessage = "Unable to scan plugin " + filename +
                              ": unsupported plugin format or scan failure.";
 
+  scanPluginFile<ExternalPluginType>(filename, typesFound);
+
 #if JUCE_PLUGINHOST_AU && JUCE_MAC
   if constexpr (std::is_same<ExternalPluginType,
                              juce::AudioUnitPluginFormat>::value) {
-    auto identifiers = getAudioUnitIdentifiersFromFile(filename);
-    // For each plugin in the identified bundle, scan using its AU identifier:
-    for (int i = 0; i < identifiers.size(); i++) {
-      format.findAllTypesForFile(typesFound, identifiers[i]);
-    }
-
     if (typesFound.isEmpty() && !audioUnitIsInstalled(filename)) {
       errorMessage += " " + AUDIO_UNIT_NOT_INSTALLED_ERROR;
     }
-  } else {
-    format.findAllTypesForFile(typesFound, filename);
   }
-#else
-  format.findAllTypesForFile(typesFound, filename);
 #endif
 
   if (typesFound.isEmpty()) {
@@ -461,6 +676,154 @@ enum class ExternalPluginReloadType {
   PersistsAudioOnReset,
 };
 
+/**
+ * Delete a plugin instance, shutting down JUCE's global state if this was the
+ * last external plugin instance alive in this process.
+ */
+inline void
+deleteExternalPluginInstance(std::unique_ptr<juce::AudioPluginInstance> instance) {
+  std::lock_guard<std::mutex> lock(EXTERNAL_PLUGIN_MUTEX);
+  instance.reset();
+  NUM_ACTIVE_EXTERNAL_PLUGINS--;
+
+  if (NUM_ACTIVE_EXTERNAL_PLUGINS == 0) {
+    juce::DeletedAtShutdown::deleteAll();
+    juce::MessageManager::deleteInstance();
+  }
+}
+
+/**
+ * A process-wide pool of idle, already-loaded external plugin instances.
+ *
+ * Loading an external plugin requires scanning its file, instantiating it,
+ * detecting its reload type and warming it up, which can take hundreds of
+ * milliseconds. Plugins created with `pooled=True` return their instance to
+ * this pool when they're destroyed (as long as the instance can be cleared
+ * with a cheap reset()), and the next plugin created with `pooled=True` for the
+ * same file and plugin name adopts that instance instead, restoring the state
+ * the instance had when it was first loaded.
+ *
+ * Pooled instances still count towards NUM_ACTIVE_EXTERNAL_PLUGINS, so JUCE's
+ * global state remains alive until the pool is cleared.
+ */
+class ExternalPluginInstancePool {
+public:
+  // (plugin format name, path to plugin file, plugin name)
+  using Key = std::tuple<std::string, std::string, std::string>;
+
+  struct Entry {
+    std::unique_ptr<juce::AudioPluginInstance> instance;
+    juce::PluginDescription description;
+    ExternalPluginReloadType reloadType = ExternalPluginReloadType::Unknown;
+
+    // The state of the instance immediately after it was first loaded:
+    juce::MemoryBlock initialState;
+    std::map<int, float> initialParameters;
+
+    // The spec that the instance was last prepared with:
+    juce::dsp::ProcessSpec lastSpec = {0, 0, 0};
+  };
+
+  static constexpr size_t MAX_INSTANCES_PER_KEY = 8;
+
+  static ExternalPluginInstancePool &getInstance() {
+    // Intentionally leaked, as plugin instances must not be
+    // deleted during static destruction; call clear() instead.
+    static ExternalPluginInstancePool *pool = new ExternalPluginInstancePool();
+    created = true;
+    return *pool;
+  }
+
+  /**
+   * Whether the pool has ever been used by this process. Allows the pool to
+   * be cleared at interpreter exit without constructing it (or any plugin
+   * formats) if no plugins were ever loaded.
+   */
+  static bool wasCreated() { return created; }
+
+  /**
+   * Take an idle instance out of the pool, or return an Entry with a null
+   * instance if no idle instances are available.
+   */
+  Entry acquire(const Key &key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = idleInstances.find(key);
+    if (it == idleInstances.end() || it->second.empty())
+      return {};
+
+    Entry entry = std::move(it->second.back());
+    it->second.pop_back();
+    return entry;
+  }
+
+  /**
+   * Return an instance to the pool. If the pool is already full for this key,
+   * the instance is handed back to the caller to be deleted.
+   */
+  std::unique_ptr<juce::AudioPluginInstance> release(const Key &key,
+                                                     Entry entry) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &entries = idleInstances[key];
+    if (entries.size() >= MAX_INSTANCES_PER_KEY)
+      return std::move(entry.instance);
+
+    entries.push_back(std::move(entry));
+    return nullptr;
+  }
+
+  /**
+   * Remember the description of a plugin that has been loaded with
+   * `pooled=True`, so that its file doesn't need to be scanned again.
+   */
+  void setDescription(const Key &key,
+                      const juce::PluginDescription &description) {
+    std::lock_guard<std::mutex> lock(mutex);
+    descriptions[key] = description;
+  }
+
+  std::optional<juce::PluginDescription> getDescription(const Key &key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = descriptions.find(key);
+    if (it == descriptions.end())
+      return {};
+    return it->second;
+  }
+
+  /**
+   * Delete all idle instances of the given plugin format, returning the number
+   * of instances deleted.
+   */
+  int clear(const std::string &pluginFormatName) {
+    std::vector<std::unique_ptr<juce::AudioPluginInstance>> toDelete;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      for (auto it = idleInstances.begin(); it != idleInstances.end();) {
+        if (std::get<0>(it->first) == pluginFormatName) {
+          for (auto &entry : it->second)
+            toDelete.push_back(std::move(entry.instance));
+          descriptions.erase(it->first);
+          it = idleInstances.erase(it);
+        } else {
+          it++;
+        }
+      }
+    }
+
+    for (auto &instance : toDelete)
+      deleteExternalPluginInstance(std::move(instance));
+    return (int)toDelete.size();
+  }
+
+private:
+  ExternalPluginInstancePool() {}
+
+  static inline std::atomic<bool> created = false;
+
+  std::mutex mutex;
+  std::map<Key, std::vector<Entry>> idleInstances;
+  std::map<Key, juce::PluginDescription> descriptions;
+};
+
 /**
  * @brief A C++ abstract base class that gets exposed to Python as
  * `ExternalPlugin`.
@@ -476,9 +839,10 @@ public:
   ExternalPlugin(
       std::string &_pathToPluginFile,
       std::optional<std::string> pluginName = {},
-      float initializationTimeout = DEFAULT_INITIALIZATION_TIMEOUT_SECONDS)
+      float initializationTimeout = DEFAULT_INITIALIZATION_TIMEOUT_SECONDS,
+      bool pooled = false)
       : pathToPluginFile(_pathToPluginFile),
-        initializationTimeout(initializationTimeout) {
+        initializationTimeout(initializationTimeout), pooled(pooled) {
     py::gil_scoped_release release;
     // Ensure we have a MessageManager, which is required by the VST wrapper
     // Without this, we get an assert(false) from JUCE at runtime
@@ -501,20 +865,26 @@ public:
                                    ": plugin file not found.");
     }
 
-#if JUCE_PLUGINHOST_AU && JUCE_MAC
-    if constexpr (std::is_same<ExternalPluginType,
-                               juce::AudioUnitPluginFormat>::value) {
-      auto identifiers = getAudioUnitIdentifiersFromFile(pluginFileStripped);
-      // For each plugin in the identified bundle, scan using its AU identifier:
-      for (int i = 0; i < identifiers.size(); i++) {
-        format.findAllTypesForFile(typesFound, identifiers[i]);
+    if (pooled) {
+      poolKey = {format.getName().toStdString(),
+                 pluginFileStripped.toStdString(), pluginName.value_or("")};
+
+      auto &pool = ExternalPluginInstancePool::getInstance();
+      auto entry = pool.acquire(poolKey);
+      if (entry.instance) {
+        adoptPooledInstance(std::move(entry));
+        return;
+      }
+
+      if (auto description = pool.getDescription(poolKey)) {
+        foundPluginDescription = *description;
+        reinstantiatePlugin();
+        rememberInitialState();
+        return;
       }
-    } else {
-      format.findAllTypesForFile(typesFound, pluginFileStripped);
     }
-#else
-    format.findAllTypesForFile(typesFound, pluginFileStripped);
-#endif
+
+    scanPluginFile<ExternalPluginType>(pluginFileStripped, typesFound);
 
     if (!typesFound.isEmpty()) {
       if (typesFound.size() == 1) {
@@ -557,6 +927,12 @@ public:
       }
 
       reinstantiatePlugin();
+
+      if (pooled) {
+        ExternalPluginInstancePool::getInstance().setDescription(
+            poolKey, foundPluginDescription);
+        rememberInitialState();
+      }
     } else {
       std::string errorMessage = "Unable to load plugin " +
                                  pathToPluginFile.toStdString() +
@@ -596,17 +972,52 @@ public:
     }
   }
 
-  ~ExternalPlugin() {
-    {
-      std::lock_guard<std::mutex> lock(EXTERNAL_PLUGIN_MUTEX);
-      pluginInstance.reset();
-      NUM_ACTIVE_EXTERNAL_PLUGINS--;
+  struct CloneOf {};
 
-      if (NUM_ACTIVE_EXTERNAL_PLUGINS == 0) {
-        juce::DeletedAtShutdown::deleteAll();
-        juce::MessageManager::deleteInstance();
-      }
+  /**
+   * Load a new instance of the same plugin as `other`, copying its state and
+   * parameters (but not any audio buffered inside it). Like any other plugin
+   * instantiation, this must be done on the main thread.
+   */
+  ExternalPlugin(CloneOf, ExternalPlugin &other)
+      : pathToPluginFile(other.pathToPluginFile),
+        foundPluginDescription(other.foundPluginDescription),
+        initializationTimeout(other.initializationTimeout) {
+    pluginFormatManager.addDefaultFormats();
+    pluginFormatManager.addFormat(new juce::PatchedVST3PluginFormat());
+
+    reloadType = other.reloadType;
+    reinstantiatePlugin();
+
+    juce::MemoryBlock state;
+    std::map<int, float> parameterValues;
+    other.pluginInstance->getStateInformation(state);
+    for (auto *parameter : other.pluginInstance->getParameters()) {
+      parameterValues[parameter->getParameterIndex()] = parameter->getValue();
     }
+    restoreState(state, parameterValues);
+  }
+
+  ~ExternalPlugin() {
+    // Plugins that can't be cleared with reset() would need to be reloaded
+    // before being used again anyways, so there's no point pooling them:
+    if (pooled && pluginInstance &&
+        reloadType == ExternalPluginReloadType::ClearsAudioOnReset) {
+      ExternalPluginInstancePool::Entry entry;
+      entry.instance = std::move(pluginInstance);
+      entry.description = foundPluginDescription;
+      entry.reloadType = reloadType;
+      entry.initialState = initialState;
+      entry.initialParameters = initialParameters;
+      entry.lastSpec = lastSpec;
+
+      pluginInstance = ExternalPluginInstancePool::getInstance().release(
+          poolKey, std::move(entry));
+      if (!pluginInstance)
+        return;
+    }
+
+    deleteExternalPluginInstance(std::move(pluginInstance));
   }
 
   struct PresetVisitor : public juce::ExtensionsVisitor {
@@ -648,6 +1059,8 @@ public:
           "if calling this plugin from a non-main thread.");
     }
 
+    clearParameterCaches();
+
     // If we have an existing plugin, save its state and reload its state
     // later:
     juce::MemoryBlock savedState;
@@ -716,20 +1129,7 @@ public:
       NUM_ACTIVE_EXTERNAL_PLUGINS++;
     }
 
-    pluginInstance->setStateInformation(savedState.getData(),
-                                        savedState.getSize());
-
-    // Set all of the parameters twice: we may have meta-parameters that
-    // change the validity of other `setValue` calls. (i.e.: param1 can't be
-    // set until param2 is set.)
-    for (int i = 0; i < 2; i++) {
-      for (auto *parameter : pluginInstance->getParameters()) {
-        if (currentParameters.count(parameter->getParameterIndex()) > 0) {
-          parameter->setValue(
-              currentParameters[parameter->getParameterIndex()]);
-        }
-      }
-    }
+    restoreState(savedState, currentParameters);
 
     if (lastSpec.numChannels != 0) {
       const juce::dsp::ProcessSpec _lastSpec = lastSpec;
@@ -746,6 +1146,57 @@ public:
     attemptToWarmUp();
   }
 
+  void restoreState(const juce::MemoryBlock &state,
+                    const std::map<int, float> &parameterValues) {
+    pluginInstance->setStateInformation(state.getData(), (int)state.getSize());
+
+    // Set all of the parameters twice: we may have meta-parameters that
+    // change the validity of other `setValue` calls. (i.e.: param1 can't be
+    // set until param2 is set.)
+    for (int i = 0; i < 2; i++) {
+      for (auto *parameter : pluginInstance->getParameters()) {
+        auto it = parameterValues.find(parameter->getParameterIndex());
+        if (it != parameterValues.end()) {
+          parameter->setValue(it->second);
+        }
+      }
+    }
+  }
+
+  /**
+   * Record the state of a freshly loaded plugin, to be restored whenever its
+   * instance is handed out again by the ExternalPluginInstancePool.
+   */
+  void rememberInitialState() {
+    initialState.reset();
+    initialParameters.clear();
+    pluginInstance->getStateInformation(initialState);
+    for (auto *parameter : pluginInstance->getParameters()) {
+      initialParameters[parameter->getParameterIndex()] = parameter->getValue();
+    }
+  }
+
+  /**
+   * Use an idle instance from the ExternalPluginInstancePool instead of
+   * loading this plugin from scratch. As the instance is known to clear its
+   * audio on reset(), restoring its initial state and calling reset() makes it
+   * indistinguishable from a freshly loaded instance.
+   */
+  void adoptPooledInstance(ExternalPluginInstancePool::Entry entry) {
+    clearParameterCaches();
+    pluginInstance = std::move(entry.instance);
+    foundPluginDescription = entry.description;
+    reloadType = entry.reloadType;
+    initialState = entry.initialState;
+    initialParameters = entry.initialParameters;
+    lastSpec = entry.lastSpec;
+
+    restoreState(initialState, initialParameters);
+    reset();
+  }
+
+  bool isPooled() const { return pooled; }
+
   void setNumChannels(int numChannels) {
     if (!pluginInstance)
       return;
@@ -1020,6 +1471,22 @@ public:
     }
   }
 
+  /**
+   * Clear this plugin's internal buffers with its own reset() method, without
+   * reloading it (regardless of its reload type).
+   */
+  void clearAudio() {
+    if (!pluginInstance)
+      return;
+
+    pluginInstance->reset();
+    pluginInstance->releaseResources();
+
+    // Force prepare() to be called again later by invalidating lastSpec:
+    lastSpec.maximumBlockSize = 0;
+    samplesProvided = 0;
+  }
+
   /**
    * reset() is only called if reset=True is passed.
    */
@@ -1074,14 +1541,23 @@ public:
 
       lastSpec = spec;
     }
+
+    // Depending on the bus layout, we may have to pass extra buffers to the
+    // plugin that we don't use; allocate those here rather than in process():
+    int numExtraChannels = std::max(
+        0, pluginInstance->getTotalNumOutputChannels() - (int)spec.numChannels);
+    if (extraChannels.getNumChannels() < numExtraChannels ||
+        extraChannels.getNumSamples() < (int)spec.maximumBlockSize) {
+      extraChannels.setSize(
+          std::max(numExtraChannels, extraChannels.getNumChannels()),
+          std::max((int)spec.maximumBlockSize, extraChannels.getNumSamples()));
+    }
   }
 
   int process(
       const juce::dsp::ProcessContextReplacing<float> &context) override {
 
     if (pluginInstance) {
-      juce::MidiBuffer emptyMidiBuffer;
-
       if (pluginInstance->getMainBusNumInputChannels() == 0 &&
           context.getInputBlock().getNumChannels() > 0) {
         throw std::invalid_argument(
@@ -1118,30 +1594,39 @@ public:
             "number of channels passed in.)");
       }
 
-      std::vector<float *> channelPointers(
-          pluginInstance->getTotalNumOutputChannels());
+      const int numChannels = pluginInstance->getTotalNumOutputChannels();
+      const int numSamples = (int)outputBlock.getNumSamples();
+      float **channelPointers = (float **)alloca(numChannels * sizeof(float *));
 
       for (size_t i = 0; i < outputBlock.getNumChannels(); i++) {
         channelPointers[i] = outputBlock.getChannelPointer(i);
       }
 
-      // Depending on the bus layout, we may have to pass extra buffers to the
-      // plugin that we don't use. Use vector here to ensure the memory is
-      // freed via RAII.
-      std::vector<std::vector<float>> dummyChannels;
-      for (size_t i = outputBlock.getNumChannels(); i < channelPointers.size();
-           i++) {
-        std::vector<float> dummyChannel(outputBlock.getNumSamples());
-        channelPointers[i] = dummyChannel.data();
-        dummyChannels.push_back(std::move(dummyChannel));
+      // Any extra channels required by the bus layout are backed by the
+      // (silent) buffers allocated in prepare(). These only need to be
+      // resized if the bus layout has changed since then:
+      const int numExtraChannels =
+          numChannels - (int)outputBlock.getNumChannels();
+      if (extraChannels.getNumChannels() < numExtraChannels ||
+          extraChannels.getNumSamples() < numSamples) {
+        extraChannels.setSize(
+            std::max(numExtraChannels, extraChannels.getNumChannels()),
+            std::max(numSamples, extraChannels.getNumSamples()));
+      }
+      for (int i = 0; i < numExtraChannels; i++) {
+        extraChannels.clear(i, 0, numSamples);
+        channelPointers[outputBlock.getNumChannels() + i] =
+            extraChannels.getWritePointer(i);
       }
 
       // Create an audio buffer that doesn't actually allocate anything, but
       // just points to the data in the ProcessContext.
-      juce::AudioBuffer<float> audioBuffer(channelPointers.data(),
-                                           channelPointers.size(),
-                                           outputBlock.getNumSamples());
+      juce::AudioBuffer<float> audioBuffer(channelPointers, numChannels,
+                                           numSamples);
 
+      // Plugins may add MIDI output to this buffer, but clearing it doesn't
+      // free its storage:
+      emptyMidiBuffer.clear();
       pluginInstance->processBlock(audioBuffer, emptyMidiBuffer);
       samplesProvided += outputBlock.getNumSamples();
 
@@ -1156,11 +1641,7 @@ public:
     return 0;
   }
 
-  py::array_t<float> renderMIDIMessages(py::object midiMessages, float duration,
-                                        float sampleRate,
-                                        unsigned int numChannels,
-                                        unsigned long bufferSize, bool reset) {
-
+  void throwIfDurationAndSampleRateFlipped(float duration, float sampleRate) {
     // Tiny quality-of-life improvement to try to detect if people have swapped
     // the duration and sample_rate arguments:
     if ((duration == 48000 || duration == 44100 || duration == 22050 ||
@@ -1175,6 +1656,13 @@ public:
           "audio to be rendered. Try reversing the order of the sample_rate "
           "and duration arguments provided to this method.");
     }
+  }
+
+  py::array_t<float> renderMIDIMessages(py::object midiMessages, float duration,
+                                        float sampleRate,
+                                        unsigned int numChannels,
+                                        unsigned long bufferSize, bool reset) {
+    throwIfDurationAndSampleRateFlipped(duration, sampleRate);
 
     std::scoped_lock<std::mutex>(this->mutex);
 
@@ -1192,57 +1680,227 @@ public:
     py::gil_scoped_release release;
 
     if (pluginInstance) {
-      if (reset)
+      if (reset) {
         this->reset();
+        rewindAutomation(*this);
+      }
 
-      juce::dsp::ProcessSpec spec;
-      spec.sampleRate = sampleRate;
-      spec.maximumBlockSize = (juce::uint32)bufferSize;
-      spec.numChannels = (juce::uint32)numChannels;
-      prepare(spec);
+      renderMidiBuffer(midiInputBuffer, outputArrayPointer, outputSampleCount,
+                       sampleRate, numChannels, bufferSize);
+    }
 
-      if (pluginInstance->getMainBusNumInputChannels() > 0) {
-        throw std::invalid_argument(
-            "Plugin '" + pluginInstance->getName().toStdString() +
-            "' expects audio as input, but was provided MIDI messages.");
+    return outputArray;
+  }
+
+  /**
+   * Render many independent MIDI clips through this (instrument) plugin,
+   * spreading them across this plugin and a pool of clones of it on separate
+   * threads. Clones are created the first time they're needed (which must be
+   * on the main thread) and kept for later calls; their state is copied from
+   * this plugin on every call.
+   */
+  std::vector<py::array_t<float>>
+  renderMIDIMessagesBatch(std::vector<py::object> midiClips,
+                          std::variant<float, std::vector<float>> durations,
+                          float sampleRate, unsigned int numChannels,
+                          std::optional<unsigned int> numWorkers,
+                          unsigned long bufferSize) {
+    if (numWorkers && *numWorkers == 0) {
+      throw std::domain_error("num_workers must be at least 1.");
+    }
+
+    if (auto *perClipDurations = std::get_if<std::vector<float>>(&durations)) {
+      if (perClipDurations->size() != midiClips.size()) {
+        throw std::domain_error(
+            "Expected one duration per MIDI clip (" +
+            std::to_string(midiClips.size()) + "), but received " +
+            std::to_string(perClipDurations->size()) + " durations.");
       }
+    }
 
-      if ((size_t)pluginInstance->getMainBusNumOutputChannels() !=
-          numChannels) {
-        throw std::invalid_argument(
-            "Plugin '" + pluginInstance->getName().toStdString() +
-            "' produces " +
-            std::to_string(pluginInstance->getMainBusNumOutputChannels()) +
-            "-channel output, but " + std::to_string(numChannels) +
-            " channels of output were requested.");
+    const auto getDuration = [&](size_t i) {
+      if (auto *duration = std::get_if<float>(&durations))
+        return *duration;
+      return std::get<std::vector<float>>(durations)[i];
+    };
+
+    std::vector<juce::MidiBuffer> midiBuffers;
+    std::vector<py::array_t<float>> outputArrays;
+    std::vector<float *> outputPointers;
+    for (size_t i = 0; i < midiClips.size(); i++) {
+      throwIfDurationAndSampleRateFlipped(getDuration(i), sampleRate);
+      midiBuffers.push_back(parseMidiBufferFromPython(midiClips[i], sampleRate));
+      outputArrays.push_back(py::array_t<float>(
+          {numChannels, (unsigned int)(getDuration(i) * sampleRate)}));
+      outputPointers.push_back(
+          static_cast<float *>(outputArrays.back().request().ptr));
+    }
+
+    py::gil_scoped_release release;
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    if (!pluginInstance || midiClips.empty())
+      return outputArrays;
+
+    unsigned int maximumWorkers =
+        numWorkers ? *numWorkers
+                   : std::max(1u, std::thread::hardware_concurrency());
+    maximumWorkers =
+        std::min(maximumWorkers, static_cast<unsigned int>(midiClips.size()));
+
+    // Clones don't copy automation curves, so automated plugins render every
+    // clip themselves:
+    if (isAutomated(*this))
+      maximumWorkers = 1;
+
+    // New plugin instances can only be created on the main thread; if we're
+    // not on the main thread, make do with the clones we already have.
+    if (juce::MessageManager::getInstance()->isThisTheMessageThread()) {
+      while (midiRenderingClones.size() + 1 < maximumWorkers) {
+        midiRenderingClones.push_back(
+            std::make_unique<ExternalPlugin>(CloneOf{}, *this));
       }
+    }
 
-      std::memset((void *)outputArrayPointer, 0,
-                  sizeof(float) * numChannels * outputSampleCount);
+    juce::MemoryBlock state;
+    std::map<int, float> parameterValues;
+    pluginInstance->getStateInformation(state);
+    for (auto *parameter : pluginInstance->getParameters()) {
+      parameterValues[parameter->getParameterIndex()] = parameter->getValue();
+    }
 
-      for (unsigned long i = 0; i < outputSampleCount; i += bufferSize) {
-        unsigned long chunkSampleCount =
-            std::min((unsigned long)bufferSize, outputSampleCount - i);
+    std::vector<ExternalPlugin *> workers = {this};
+    for (auto &clone : midiRenderingClones) {
+      if (workers.size() >= maximumWorkers)
+        break;
+      clone->restoreState(state, parameterValues);
+      workers.push_back(clone.get());
+    }
 
-        std::vector<float *> channelPointers(numChannels);
-        for (size_t c = 0; c < numChannels; c++) {
-          channelPointers[c] =
-              (outputArrayPointer + (outputSampleCount * c) + i);
+    std::atomic<size_t> nextClipIndex{0};
+    std::vector<std::exception_ptr> workerExceptions(workers.size());
+
+    auto runWorker = [&](size_t workerIndex) {
+      ExternalPlugin *worker = workers[workerIndex];
+      try {
+        while (true) {
+          size_t clipIndex = nextClipIndex++;
+          if (clipIndex >= midiClips.size())
+            break;
+
+          // Reloading the plugin between clips (as reset() does for most
+          // instrument plugins) is only possible on the main thread, and
+          // would be too slow anyways:
+          worker->clearAudio();
+          rewindAutomation(*worker);
+          worker->renderMidiBuffer(midiBuffers[clipIndex],
+                                   outputPointers[clipIndex],
+                                   getDuration(clipIndex) * sampleRate,
+                                   sampleRate, numChannels, bufferSize);
         }
+      } catch (...) {
+        workerExceptions[workerIndex] = std::current_exception();
+        // Stop all other workers from picking up new clips:
+        nextClipIndex = midiClips.size();
+      }
+    };
+
+    std::vector<std::thread> workerThreads;
+    for (size_t i = 1; i < workers.size(); i++) {
+      workerThreads.emplace_back(runWorker, i);
+    }
+    runWorker(0);
+    for (auto &thread : workerThreads) {
+      thread.join();
+    }
+
+    for (auto &exception : workerExceptions) {
+      if (exception)
+        std::rethrow_exception(exception);
+    }
+
+    return outputArrays;
+  }
+
+  /**
+   * Render a MIDI buffer through this (instrument) plugin into
+   * `numChannels` contiguous channels of `outputSampleCount` samples each.
+   * Does not require the GIL.
+   */
+  void renderMidiBuffer(const juce::MidiBuffer &midiInputBuffer,
+                        float *outputArrayPointer,
+                        unsigned long outputSampleCount, float sampleRate,
+                        unsigned int numChannels, unsigned long bufferSize) {
+    juce::dsp::ProcessSpec spec;
+    spec.sampleRate = sampleRate;
+    spec.maximumBlockSize = (juce::uint32)bufferSize;
+    spec.numChannels = (juce::uint32)numChannels;
+    prepare(spec);
+
+    if (pluginInstance->getMainBusNumInputChannels() > 0) {
+      throw std::invalid_argument(
+          "Plugin '" + pluginInstance->getName().toStdString() +
+          "' expects audio as input, but was provided MIDI messages.");
+    }
+
+    if ((size_t)pluginInstance->getMainBusNumOutputChannels() != numChannels) {
+      throw std::invalid_argument(
+          "Plugin '" + pluginInstance->getName().toStdString() +
+          "' produces " +
+          std::to_string(pluginInstance->getMainBusNumOutputChannels()) +
+          "-channel output, but " + std::to_string(numChannels) +
+          " channels of output were requested.");
+    }
+
+    std::memset((void *)outputArrayPointer, 0,
+                sizeof(float) * numChannels * outputSampleCount);
+
+    float **channelPointers = (float **)alloca(numChannels * sizeof(float *));
+    for (unsigned long i = 0; i < outputSampleCount;) {
+      unsigned long chunkSampleCount =
+          std::min((unsigned long)bufferSize, outputSampleCount - i);
+
+      // Render in shorter chunks if any parameters are automated, applying
+      // the automation before each chunk:
+      if (isAutomated(*this)) {
+        chunkSampleCount = std::min(
+            chunkSampleCount, (unsigned long)automation->update(sampleRate));
+        automation->position += chunkSampleCount;
+      }
+
+      for (size_t c = 0; c < numChannels; c++) {
+        channelPointers[c] = (outputArrayPointer + (outputSampleCount * c) + i);
+      }
 
-        // Create an audio buffer that doesn't actually allocate anything, but
-        // just points to the data in the output array.
-        juce::AudioBuffer<float> audioChunk(
-            channelPointers.data(), channelPointers.size(), chunkSampleCount);
+      // Create an audio buffer that doesn't actually allocate anything, but
+      // just points to the data in the output array.
+      juce::AudioBuffer<float> audioChunk(channelPointers, numChannels,
+                                          chunkSampleCount);
 
-        juce::MidiBuffer midiChunk;
-        midiChunk.addEvents(midiInputBuffer, i, chunkSampleCount, -i);
+      juce::MidiBuffer midiChunk;
+      midiChunk.addEvents(midiInputBuffer, i, chunkSampleCount, -i);
 
+      {
+        RealtimeAuditScope auditScope(*this);
         pluginInstance->processBlock(audioChunk, midiChunk);
       }
+      i += chunkSampleCount;
     }
+  }
 
-    return outputArray;
+  /**
+   * Create a new, independent instance of this plugin with the same state and
+   * parameters. Only plugins that clear their audio on reset() can be cloned,
+   * as the clone may need to be reset on a background thread, and new plugin
+   * instances can only be created on the main thread.
+   */
+  std::shared_ptr<Plugin> clone() override {
+    if (!pluginInstance ||
+        reloadType != ExternalPluginReloadType::ClearsAudioOnReset ||
+        !juce::MessageManager::getInstance()->isThisTheMessageThread()) {
+      return nullptr;
+    }
+    return std::make_shared<ExternalPlugin>(CloneOf{}, *this);
   }
 
   std::vector<juce::AudioProcessorParameter *> getParameters() const {
@@ -1254,12 +1912,165 @@ public:
   }
 
   juce::AudioProcessorParameter *getParameter(const std::string &name) const {
+    auto it = parametersByName.find(name);
+    if (it != parametersByName.end() &&
+        it->second->getName(512).toStdString() == name) {
+      return it->second;
+    }
+
+    // Either this is the first lookup, or the plugin has renamed (or
+    // replaced) its parameters since we last looked:
+    parametersByName.clear();
     for (auto *parameter : pluginInstance->getParameters()) {
-      if (parameter->getName(512).toStdString() == name) {
-        return parameter;
+      parametersByName.emplace(parameter->getName(512).toStdString(),
+                               parameter);
+    }
+
+    it = parametersByName.find(name);
+    return it == parametersByName.end() ? nullptr : it->second;
+  }
+
+  using ParameterTextRange = std::tuple<double, double, std::string>;
+
+  /**
+   * Sample the text that the named parameter displays at searchSteps + 1
+   * evenly-spaced raw values between 0 and 1, and return each range of raw
+   * values (start, end, text) over which that text stays the same.
+   *
+   * Some plugins don't implement getText() properly; if `slow` is true, each
+   * raw value is set on the parameter (and the original value restored
+   * afterwards) before reading its text.
+   *
+   * Results are cached per parameter, as this requires thousands of calls
+   * into the plugin.
+   */
+  std::vector<ParameterTextRange>
+  getParameterTextRanges(const std::string &name, int searchSteps, bool slow) {
+    if (searchSteps < 1) {
+      throw std::domain_error("search_steps must be at least 1, but was " +
+                              std::to_string(searchSteps) + ".");
+    }
+
+    auto *parameter = getParameter(name);
+    if (!parameter) {
+      throw std::invalid_argument("Parameter named \"" + name +
+                                  "\" not found.");
+    }
+
+    auto key = std::make_tuple(name, searchSteps, slow);
+    auto cached = parameterTextRanges.find(key);
+    if (cached != parameterTextRanges.end())
+      return cached->second;
+
+    const float originalValue = parameter->getValue();
+    std::vector<ParameterTextRange> ranges;
+    double startOfRange = 0;
+    std::string text;
+
+    for (int i = 0; i <= searchSteps; i++) {
+      double rawValue = (double)i / searchSteps;
+
+      std::string textForValue;
+      if (slow) {
+        parameter->setValue((float)rawValue);
+        textForValue = parameter->getCurrentValueAsText().toStdString();
+      } else {
+        textForValue = parameter->getText((float)rawValue, 512).toStdString();
+      }
+
+      if (i == 0) {
+        text = textForValue;
+      } else if (textForValue != text) {
+        ranges.push_back({startOfRange, rawValue, text});
+        text = textForValue;
+        startOfRange = rawValue;
       }
     }
-    return nullptr;
+
+    if (slow)
+      parameter->setValue(originalValue);
+
+    ranges.push_back({startOfRange, 1.0, text});
+    parameterTextRanges[key] = ranges;
+    return ranges;
+  }
+
+  /**
+   * Return the raw value and displayed text of every parameter, keyed by
+   * parameter name, in a single call.
+   */
+  std::map<std::string, std::tuple<float, std::string>>
+  getRawParameterValues() const {
+    std::map<std::string, std::tuple<float, std::string>> values;
+    for (auto *parameter : pluginInstance->getParameters()) {
+      values.emplace(parameter->getName(512).toStdString(),
+                     std::make_tuple(
+                         parameter->getValue(),
+                         parameter->getCurrentValueAsText().toStdString()));
+    }
+    return values;
+  }
+
+  /**
+   * Set the raw values of many parameters (keyed by parameter name) at once.
+   * No parameters are changed if any of the names are invalid.
+   */
+  void setRawParameterValues(const std::map<std::string, float> &values) {
+    std::vector<std::pair<juce::AudioProcessorParameter *, float>> changes;
+    changes.reserve(values.size());
+
+    for (const auto &[name, rawValue] : values) {
+      auto *parameter = getParameter(name);
+      if (!parameter) {
+        throw std::invalid_argument("Parameter named \"" + name +
+                                    "\" not found.");
+      }
+      changes.push_back({parameter, rawValue});
+    }
+
+    // As in restoreState, set everything twice in case some of these are
+    // meta-parameters that change the validity of other parameters' values:
+    for (int i = 0; i < 2; i++) {
+      for (const auto &[parameter, rawValue] : changes) {
+        parameter->setValue(rawValue);
+      }
+    }
+  }
+
+  /**
+   * Automate the named parameter (see Automation.h) with a curve of raw
+   * values between 0 and 1, which are passed directly to the parameter's
+   * setValue method.
+   */
+  void automateRawParameterValue(const std::string &name, py::object values) {
+    auto *parameter = getParameter(name);
+    if (!parameter) {
+      throw std::invalid_argument("Parameter named \"" + name +
+                                  "\" not found.");
+    }
+
+    std::optional<AutomationCurve> curve;
+    if (!values.is_none()) {
+      curve = parseAutomationCurve(values);
+      if (curve->getMinimumValue() < 0 || curve->getMaximumValue() > 1) {
+        throw std::domain_error("Raw values for parameter \"" + name +
+                                "\" must be between 0 and 1.");
+      }
+    }
+
+    int index = parameter->getParameterIndex();
+    setParameterAutomation(*this, name, curve, [this, index](float value) {
+      // Look the parameter up every time, as the plugin instance (and its
+      // parameters) may be replaced when this plugin is reset:
+      const auto &parameters = pluginInstance->getParameters();
+      if (index < parameters.size())
+        parameters[index]->setValue(value);
+    });
+  }
+
+  void clearParameterCaches() {
+    parametersByName.clear();
+    parameterTextRanges.clear();
   }
 
   virtual int getLatencyHint() override {
@@ -1312,6 +2123,26 @@ private:
 
   long samplesProvided = 0;
   float initializationTimeout = DEFAULT_INITIALIZATION_TIMEOUT_SECONDS;
+
+  // Used by renderMIDIMessagesBatch, and kept between calls as plugin
+  // instances are expensive to create:
+  std::vector<std::unique_ptr<ExternalPlugin>> midiRenderingClones;
+
+  // Scratch space for process(), allocated ahead of time in prepare():
+  juce::AudioBuffer<float> extraChannels;
+  juce::MidiBuffer emptyMidiBuffer;
+
+  // Caches for parameter lookups, which must be cleared whenever
+  // pluginInstance is replaced:
+  mutable std::unordered_map<std::string, juce::AudioProcessorParameter *>
+      parametersByName;
+  std::map<std::tuple<std::string, int, bool>, std::vector<ParameterTextRange>>
+      parameterTextRanges;
+
+  bool pooled = false;
+  ExternalPluginInstancePool::Key poolKey;
+  juce::MemoryBlock initialState;
+  std::map<int, float> initialParameters;
 };
 
 inline void init_external_plugins(py::module &m) {
@@ -1508,7 +2339,44 @@ inline void init_external_plugins(py::module &m) {
               py::arg("midi_messages"), py::arg("duration"),
               py::arg("sample_rate"), py::arg("num_channels") = 2,
               py::arg("buffer_size") = DEFAULT_BUFFER_SIZE,
-              py::arg("reset") = true);
+              py::arg("reset") = true)
+          .def(
+              "automate",
+              [](py::object self, std::string parameterName,
+                 py::object values) {
+                // Values are converted to raw parameter values in Python,
+                // using the same logic as setting a parameter attribute:
+                self.attr("_automate_parameter")(parameterName, values);
+              },
+              "Change the value of one of this plugin's parameters over time "
+              "while audio is processed. ``parameter_name`` must be one of "
+              "the keys of :py:attr:`parameters`, and ``values`` (in the "
+              "same units used when setting that parameter as an attribute) "
+              "may be a one-dimensional NumPy array with one value per "
+              "sample, or a list of ``(time_in_seconds, value)`` pairs. See "
+              ":py:meth:`pedalboard.Plugin.automate` for details.\n\n"
+              ".. note::\n    Values between ``(time_in_seconds, value)`` "
+              "pairs are interpolated linearly in the parameter's raw value "
+              "(see :py:attr:`AudioProcessorParameter.raw_value`), which may "
+              "not be linear in the parameter's units.\n\n"
+              "*Introduced in v0.9.0.*",
+              py::arg("parameter_name"), py::arg("values"))
+          .def_property_static(
+              "scan_cache_path",
+              py::cpp_function([](py::object /* cls */) {
+                return PluginScanCache::getInstance().getPath();
+              }),
+              py::cpp_function(
+                  [](py::object /* cls */, std::optional<std::string> path) {
+                    PluginScanCache::getInstance().setPath(path);
+                  }),
+              "The path of a file in which to cache the results of scanning "
+              "plugin files, or ``None`` (the default) to scan plugin files "
+              "every time they're loaded. Each plugin file is only re-scanned "
+              "if its modification time has changed since it was last "
+              "scanned, which can make loading plugins much faster. The file "
+              "will be created if it does not exist, and may be shared "
+              "between processes.\n\n*Introduced in v0.9.0.*");
 
 #if (JUCE_MAC || JUCE_WINDOWS || JUCE_LINUX)
   py::class_<ExternalPlugin<juce::PatchedVST3PluginFormat>,
@@ -1539,11 +2407,12 @@ example: a Windows VST3 plugin bundle will not load on Linux or macOS.)
       .def(
           py::init([](std::string &pathToPluginFile, py::object parameterValues,
                       std::optional<std::string> pluginName,
-                      float initializationTimeout) {
+                      float initializationTimeout, bool pooled) {
             std::shared_ptr<ExternalPlugin<juce::PatchedVST3PluginFormat>>
                 plugin = std::make_shared<
                     ExternalPlugin<juce::PatchedVST3PluginFormat>>(
-                    pathToPluginFile, pluginName, initializationTimeout);
+                    pathToPluginFile, pluginName, initializationTimeout,
+                    pooled);
             py::cast(plugin).attr("__set_initial_parameter_values__")(
                 parameterValues);
             return plugin;
@@ -1552,7 +2421,8 @@ example: a Windows VST3 plugin bundle will not load on Linux or macOS.)
           py::arg("parameter_values") = py::none(),
           py::arg("plugin_name") = py::none(),
           py::arg("initialization_timeout") =
-              DEFAULT_INITIALIZATION_TIMEOUT_SECONDS)
+              DEFAULT_INITIALIZATION_TIMEOUT_SECONDS,
+          py::arg("pooled") = false)
       .def("__repr__",
            [](ExternalPlugin<juce::PatchedVST3PluginFormat> &plugin) {
              std::ostringstream ss;
@@ -1566,6 +2436,23 @@ example: a Windows VST3 plugin bundle will not load on Linux or macOS.)
            &ExternalPlugin<juce::PatchedVST3PluginFormat>::loadPresetData,
            "Load a VST3 preset file in .vstpreset format.",
            py::arg("preset_file_path"))
+      .def_property_readonly(
+          "pooled", &ExternalPlugin<juce::PatchedVST3PluginFormat>::isPooled,
+          "Whether this plugin's instance will be returned to the instance "
+          "pool (rather than being unloaded) when this object is destroyed, "
+          "as set by passing ``pooled=True`` to the constructor.\n\n"
+          "*Introduced in v0.9.0.*")
+      .def_static(
+          "clear_instance_pool",
+          []() {
+            if (!ExternalPluginInstancePool::wasCreated())
+              return 0;
+
+            py::gil_scoped_release release;
+            return ExternalPluginInstancePool::getInstance().clear(
+                juce::PatchedVST3PluginFormat().getName().toStdString());
+          },
+          CLEAR_INSTANCE_POOL_DOCSTRING)
       .def_static(
           "get_plugin_names_for_file",
           [](std::string filename) {
@@ -1596,6 +2483,18 @@ example: a Windows VST3 plugin bundle will not load on Linux or macOS.)
       .def("_get_parameter",
            &ExternalPlugin<juce::PatchedVST3PluginFormat>::getParameter,
            py::return_value_policy::reference_internal)
+      .def("_get_parameter_text_ranges",
+           &ExternalPlugin<juce::PatchedVST3PluginFormat>::getParameterTextRanges,
+           py::arg("name"), py::arg("search_steps") = 1000,
+           py::arg("slow") = false)
+      .def("_get_raw_parameter_values",
+           &ExternalPlugin<juce::PatchedVST3PluginFormat>::getRawParameterValues)
+      .def("_set_raw_parameter_values",
+           &ExternalPlugin<juce::PatchedVST3PluginFormat>::setRawParameterValues,
+           py::arg("raw_values"))
+      .def("_automate_raw",
+           &ExternalPlugin<juce::PatchedVST3PluginFormat>::automateRawParameterValue,
+           py::arg("name"), py::arg("raw_values"))
       .def("show_editor",
            &ExternalPlugin<juce::PatchedVST3PluginFormat>::showEditor,
            SHOW_EDITOR_DOCSTRING, py::arg("close_event") = py::none())
@@ -1618,6 +2517,23 @@ example: a Windows VST3 plugin bundle will not load on Linux or macOS.)
           "audio. Alias for :py:meth:`process`.",
           py::arg("input_array"), py::arg("sample_rate"),
           py::arg("buffer_size") = DEFAULT_BUFFER_SIZE, py::arg("reset") = true)
+      .def("process_batch",
+           &ExternalPlugin<juce::PatchedVST3PluginFormat>::renderMIDIMessagesBatch,
+           EXTERNAL_PLUGIN_PROCESS_BATCH_DOCSTRING, py::arg("midi_clips"),
+           py::arg("duration"), py::arg("sample_rate"),
+           py::arg("num_channels") = 2, py::arg("num_workers") = py::none(),
+           py::arg("buffer_size") = DEFAULT_BUFFER_SIZE)
+      .def(
+          "process_batch",
+          [](std::shared_ptr<Plugin> self,
+             const std::vector<py::array> inputArrays, double sampleRate,
+             std::optional<unsigned int> numWorkers, unsigned int bufferSize) {
+            return processBatch(inputArrays, sampleRate, {self}, bufferSize,
+                                numWorkers);
+          },
+          EXTERNAL_PLUGIN_PROCESS_BATCH_DOCSTRING, py::arg("input_arrays"),
+          py::arg("sample_rate"), py::arg("num_workers") = py::none(),
+          py::arg("buffer_size") = DEFAULT_BUFFER_SIZE)
       .def("process",
            &ExternalPlugin<juce::PatchedVST3PluginFormat>::renderMIDIMessages,
            EXTERNAL_PLUGIN_PROCESS_DOCSTRING, py::arg("midi_messages"),
@@ -1674,11 +2590,12 @@ see :class:`pedalboard.VST3Plugin`.)
       .def(
           py::init([](std::string &pathToPluginFile, py::object parameterValues,
                       std::optional<std::string> pluginName,
-                      float initializationTimeout) {
+                      float initializationTimeout, bool pooled) {
             std::shared_ptr<ExternalPlugin<juce::AudioUnitPluginFormat>>
                 plugin = std::make_shared<
                     ExternalPlugin<juce::AudioUnitPluginFormat>>(
-                    pathToPluginFile, pluginName, initializationTimeout);
+                    pathToPluginFile, pluginName, initializationTimeout,
+                    pooled);
             py::cast(plugin).attr("__set_initial_parameter_values__")(
                 parameterValues);
             return plugin;
@@ -1687,7 +2604,8 @@ see :class:`pedalboard.VST3Plugin`.)
           py::arg("parameter_values") = py::none(),
           py::arg("plugin_name") = py::none(),
           py::arg("initialization_timeout") =
-              DEFAULT_INITIALIZATION_TIMEOUT_SECONDS)
+              DEFAULT_INITIALIZATION_TIMEOUT_SECONDS,
+          py::arg("pooled") = false)
       .def("__repr__",
            [](const ExternalPlugin<juce::AudioUnitPluginFormat> &plugin) {
              std::ostringstream ss;
@@ -1697,6 +2615,23 @@ see :class:`pedalboard.VST3Plugin`.)
              ss << ">";
              return ss.str();
            })
+      .def_property_readonly(
+          "pooled", &ExternalPlugin<juce::AudioUnitPluginFormat>::isPooled,
+          "Whether this plugin's instance will be returned to the instance "
+          "pool (rather than being unloaded) when this object is destroyed, "
+          "as set by passing ``pooled=True`` to the constructor.\n\n"
+          "*Introduced in v0.9.0.*")
+      .def_static(
+          "clear_instance_pool",
+          []() {
+            if (!ExternalPluginInstancePool::wasCreated())
+              return 0;
+
+            py::gil_scoped_release release;
+            return ExternalPluginInstancePool::getInstance().clear(
+                juce::AudioUnitPluginFormat().getName().toStdString());
+          },
+          CLEAR_INSTANCE_POOL_DOCSTRING)
       .def_static(
           "get_plugin_names_for_file",
           [](std::string filename) {
@@ -1732,6 +2667,18 @@ see :class:`pedalboard.VST3Plugin`.)
       .def("_get_parameter",
            &ExternalPlugin<juce::AudioUnitPluginFormat>::getParameter,
            py::return_value_policy::reference_internal)
+      .def("_get_parameter_text_ranges",
+           &ExternalPlugin<juce::AudioUnitPluginFormat>::getParameterTextRanges,
+           py::arg("name"), py::arg("search_steps") = 1000,
+           py::arg("slow") = false)
+      .def("_get_raw_parameter_values",
+           &ExternalPlugin<juce::AudioUnitPluginFormat>::getRawParameterValues)
+      .def("_set_raw_parameter_values",
+           &ExternalPlugin<juce::AudioUnitPluginFormat>::setRawParameterValues,
+           py::arg("raw_values"))
+      .def("_automate_raw",
+           &ExternalPlugin<juce::AudioUnitPluginFormat>::automateRawParameterValue,
+           py::arg("name"), py::arg("raw_values"))
       .def("show_editor",
            &ExternalPlugin<juce::AudioUnitPluginFormat>::showEditor,
            SHOW_EDITOR_DOCSTRING, py::arg("close_event") = py::none())
@@ -1754,6 +2701,23 @@ see :class:`pedalboard.VST3Plugin`.)
           "audio. Alias for :py:meth:`process`.",
           py::arg("input_array"), py::arg("sample_rate"),
           py::arg("buffer_size") = DEFAULT_BUFFER_SIZE, py::arg("reset") = true)
+      .def("process_batch",
+           &ExternalPlugin<juce::AudioUnitPluginFormat>::renderMIDIMessagesBatch,
+           EXTERNAL_PLUGIN_PROCESS_BATCH_DOCSTRING, py::arg("midi_clips"),
+           py::arg("duration"), py::arg("sample_rate"),
+           py::arg("num_channels") = 2, py::arg("num_workers") = py::none(),
+           py::arg("buffer_size") = DEFAULT_BUFFER_SIZE)
+      .def(
+          "process_batch",
+          [](std::shared_ptr<Plugin> self,
+             const std::vector<py::array> inputArrays, double sampleRate,
+             std::optional<unsigned int> numWorkers, unsigned int bufferSize) {
+            return processBatch(inputArrays, sampleRate, {self}, bufferSize,
+                                numWorkers);
+          },
+          EXTERNAL_PLUGIN_PROCESS_BATCH_DOCSTRING, py::arg("input_arrays"),
+          py::arg("sample_rate"), py::arg("num_workers") = py::none(),
+          py::arg("buffer_size") = DEFAULT_BUFFER_SIZE)
       .def("process",
            &ExternalPlugin<juce::AudioUnitPluginFormat>::renderMIDIMessages,
            EXTERNAL_PLUGIN_PROCESS_DOCSTRING, py::arg("midi_messages"),
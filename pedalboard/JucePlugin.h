@@ -40,6 +40,56 @@ public:                                                                        \
   }
 
 namespace Pedalboard {
+/**
+ * The maximum number of channels that a single instance of a given JUCE DSP
+ * type can process at once. Some JUCE DSP types (i.e.: juce::dsp::Reverb) only
+ * support mono or stereo audio; to process audio with more channels than
+ * this, JucePlugin will run multiple independent copies of the DSP type over
+ * consecutive groups of channels.
+ *
+ * Specialize this template for any DSP type that has a channel limit.
+ */
+template <typename DSPType> struct MaximumChannelsPerDSPInstance {
+  static constexpr unsigned int value = 0; // Unlimited.
+};
+
+template <> struct MaximumChannelsPerDSPInstance<juce::dsp::Reverb> {
+  static constexpr unsigned int value = 2;
+};
+
+/**
+ * Get the number of samples taken for the state of a first- or
+ * second-order IIR filter with the given coefficients to decay by 120dB,
+ * based on the radius of its poles. Returns -1 for unstable filters or
+ * filters of any other order.
+ */
+template <typename SampleType>
+int getTailLengthSamples(
+    const juce::dsp::IIR::Coefficients<SampleType> &coefficients) {
+  // JUCE stores coefficients as [b0, ..., bN, a1, ..., aN], normalized by a0:
+  const auto &c = coefficients.coefficients;
+  double poleRadius;
+  switch (coefficients.getFilterOrder()) {
+  case 1:
+    poleRadius = std::abs((double)c[2]);
+    break;
+  case 2: {
+    double a1 = c[3], a2 = c[4];
+    double discriminant = a1 * a1 - 4 * a2;
+    if (discriminant < 0) {
+      poleRadius = std::sqrt(a2);
+    } else {
+      double root = std::sqrt(discriminant);
+      poleRadius = std::max(std::abs(-a1 + root), std::abs(-a1 - root)) / 2;
+    }
+    break;
+  }
+  default:
+    return -1;
+  }
+  return Plugin::getDecaySamples(poleRadius, 1);
+}
+
 /**
  * A template class to adapt an arbitrary juce::dsp block to a Plugin.
  * Could technically be used with any type that provides prepare,
@@ -53,22 +103,92 @@ public:
     if (lastSpec.sampleRate != spec.sampleRate ||
         lastSpec.maximumBlockSize < spec.maximumBlockSize ||
         spec.numChannels != lastSpec.numChannels) {
-      dspBlock.prepare(spec);
+      unsigned int channelsPerDSP = getChannelsPerDSPInstance(spec);
+
+      juce::dsp::ProcessSpec firstSpec = spec;
+      firstSpec.numChannels = std::min(spec.numChannels, channelsPerDSP);
+      dspBlock.prepare(firstSpec);
+
+      additionalDSPBlocks.clear();
+      for (unsigned int startChannel = channelsPerDSP;
+           startChannel < spec.numChannels; startChannel += channelsPerDSP) {
+        juce::dsp::ProcessSpec groupSpec = spec;
+        groupSpec.numChannels =
+            std::min(spec.numChannels - startChannel, channelsPerDSP);
+
+        auto additionalDSPBlock = std::make_unique<DSPType>();
+        copyParametersTo(*additionalDSPBlock);
+        additionalDSPBlock->prepare(groupSpec);
+        additionalDSPBlocks.push_back(std::move(additionalDSPBlock));
+      }
+
       lastSpec = spec;
     }
   }
 
   int process(
       const juce::dsp::ProcessContextReplacing<float> &context) override {
-    dspBlock.process(context);
-    return context.getOutputBlock().getNumSamples();
+    if (additionalDSPBlocks.empty()) {
+      dspBlock.process(context);
+      return context.getOutputBlock().getNumSamples();
+    }
+
+    auto ioBlock = context.getOutputBlock();
+    unsigned int channelsPerDSP = getChannelsPerDSPInstance(lastSpec);
+
+    for (size_t i = 0; i <= additionalDSPBlocks.size(); i++) {
+      size_t startChannel = i * channelsPerDSP;
+      size_t numChannels = std::min((size_t)channelsPerDSP,
+                                    ioBlock.getNumChannels() - startChannel);
+      auto groupBlock =
+          ioBlock.getSubsetChannelBlock(startChannel, numChannels);
+      juce::dsp::ProcessContextReplacing<float> groupContext(groupBlock);
+
+      if (i == 0) {
+        dspBlock.process(groupContext);
+      } else {
+        // Parameters may have changed since the last call:
+        copyParametersTo(*additionalDSPBlocks[i - 1]);
+        additionalDSPBlocks[i - 1]->process(groupContext);
+      }
+    }
+
+    return ioBlock.getNumSamples();
+  }
+
+  void reset() override {
+    dspBlock.reset();
+    for (auto &additionalDSPBlock : additionalDSPBlocks)
+      additionalDSPBlock->reset();
   }
 
-  void reset() override { dspBlock.reset(); }
+  // Specialize this for any DSP type with a known tail length; see
+  // Plugin::getTailLengthSamples.
+  int getTailLengthSamples() override { return Plugin::getTailLengthSamples(); }
+
+  // Specialize this for any DSP type that can be copied; see Plugin::clone.
+  // (Subclasses of JucePlugin usually override this instead.)
+  std::shared_ptr<Plugin> clone() override { return Plugin::clone(); }
 
   DSPType &getDSP() { return dspBlock; };
 
+protected:
+  /**
+   * Copy this plugin's parameters from the primary DSP object to another
+   * instance of the same type. Only called for DSP types that have a
+   * MaximumChannelsPerDSPInstance, when processing audio with more channels
+   * than a single instance supports.
+   */
+  virtual void copyParametersTo(DSPType &other) {}
+
 private:
+  static unsigned int
+  getChannelsPerDSPInstance(const juce::dsp::ProcessSpec &spec) {
+    unsigned int limit = MaximumChannelsPerDSPInstance<DSPType>::value;
+    return limit == 0 ? std::max(spec.numChannels, 1u) : limit;
+  }
+
   DSPType dspBlock;
+  std::vector<std::unique_ptr<DSPType>> additionalDSPBlocks;
 };
-} // namespace Pedalboard
+} // namespace Pedalboard
\ No newline at end of file
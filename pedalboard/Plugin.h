@@ -18,11 +18,17 @@
 #pragma once
 
 #include "JuceHeader.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
 #include <mutex>
 
 static constexpr int DEFAULT_BUFFER_SIZE = 8192;
 
 namespace Pedalboard {
+class PluginAutomation;
+
 /**
  * A base class for all Pedalboard plugins, JUCE-derived or external.
  */
@@ -48,6 +54,47 @@ public:
   virtual int
   process(const juce::dsp::ProcessContextReplacing<float> &context) = 0;
 
+  /**
+   * Process a single buffer of 64-bit floating point audio through this
+   * plugin, with the same semantics as the 32-bit process() method above.
+   *
+   * By default, each block is converted to 32-bit floating point, passed to
+   * the 32-bit process() method, and converted back. Plugins that can operate
+   * on 64-bit audio directly should override this method to avoid the
+   * conversion (and the loss of precision that comes with it).
+   */
+  virtual int
+  process(const juce::dsp::ProcessContextReplacing<double> &context) {
+    auto ioBlock = context.getOutputBlock();
+    int numChannels = (int)ioBlock.getNumChannels();
+    int numSamples = (int)ioBlock.getNumSamples();
+
+    // Only reallocate if this block is larger than any we've seen before:
+    singlePrecisionBuffer.setSize(
+        std::max(numChannels, singlePrecisionBuffer.getNumChannels()),
+        std::max(numSamples, singlePrecisionBuffer.getNumSamples()),
+        /* keepExistingContent= */ false, /* clearExtraSpace= */ false,
+        /* avoidReallocating= */ true);
+
+    juce::dsp::AudioBlock<float> floatBlock(
+        singlePrecisionBuffer.getArrayOfWritePointers(), numChannels, 0,
+        numSamples);
+    for (int c = 0; c < numChannels; c++) {
+      const double *source = ioBlock.getChannelPointer(c);
+      std::copy(source, source + numSamples, floatBlock.getChannelPointer(c));
+    }
+
+    juce::dsp::ProcessContextReplacing<float> floatContext(floatBlock);
+    int samplesOutput = process(floatContext);
+
+    // Output is right-aligned, so copy back the whole block:
+    for (int c = 0; c < numChannels; c++) {
+      const float *source = floatBlock.getChannelPointer(c);
+      std::copy(source, source + numSamples, ioBlock.getChannelPointer(c));
+    }
+    return samplesOutput;
+  }
+
   /**
    * Reset this plugin's state, clearing any internal buffers or delay lines.
    */
@@ -72,17 +119,106 @@ public:
    */
   virtual int getLatencyHint() { return 0; }
 
+  /**
+   * Get the number of samples of silent input after which this plugin's
+   * output (and internal state) will have decayed to silence (below -120dB),
+   * such that processing more silence would be equivalent to calling
+   * reset(). Returns -1 if unknown, or if the plugin's output may never
+   * decay (i.e.: it generates sound on its own).
+   *
+   * Like getLatencyHint(), this is only called after prepare(). Plugins with
+   * a known tail can skip processing silence; see skipIfSilent().
+   */
+  virtual int getTailLengthSamples() { return -1; }
+
   /**
    * Returns true iff this plugin accepts audio input (i.e.: is an effect).
    */
   virtual bool acceptsAudioInput() { return true; }
 
+  /**
+   * Returns true iff processing a block of audio with this plugin gives the
+   * same result as processing it as any number of shorter, consecutive
+   * blocks (i.e.: the plugin only keeps per-sample state, like a filter) and
+   * every call to process() returns every sample it was given.
+   *
+   * Runs of consecutive tileable plugins in a fused Chain are run over small,
+   * cache-sized tiles of audio one after another, rather than each plugin
+   * streaming the whole buffer through memory in turn.
+   */
+  virtual bool isTileable() { return false; }
+
+  /**
+   * If this plugin is equivalent to running a list of other plugins one after
+   * the other, and those plugins should be run as a pipeline (each on its own
+   * thread, passing blocks of audio from one to the next) when rendering an
+   * entire buffer at once, return that list. See processPipelined().
+   */
+  virtual std::vector<std::shared_ptr<Plugin>> getPipelineStages() {
+    return {};
+  }
+
+  /**
+   * Create a new, independent instance of this plugin with identical
+   * parameters, but without any of this plugin's internal state (i.e.: delay
+   * lines, reverb tails, or buffered audio). The returned plugin can be used
+   * on another thread at the same time as this one.
+   *
+   * Returns nullptr if this plugin does not support being cloned.
+   */
+  virtual std::shared_ptr<Plugin> clone() { return nullptr; }
+
+  /**
+   * Return the number of samples taken for a signal to decay by 120dB, if
+   * it's multiplied by gainPerPeriod every periodSamples samples (as the
+   * state of a recursive filter is). Useful for implementing
+   * getTailLengthSamples().
+   */
+  static int getDecaySamples(double gainPerPeriod, double periodSamples) {
+    gainPerPeriod = std::abs(gainPerPeriod);
+    if (gainPerPeriod >= 1.0)
+      return -1;
+    if (gainPerPeriod <= 0.0)
+      return (int)std::ceil(periodSamples);
+    return (int)std::ceil(std::log(1e-6) / std::log(gainPerPeriod) *
+                          periodSamples);
+  }
+
   // A mutex to gate access to this plugin, as its internals may not be
   // thread-safe. Note: use std::lock or std::scoped_lock when locking multiple
   // plugins to avoid deadlocking.
   std::mutex mutex;
 
+  // The curves (if any) applied to this plugin's parameters while processing
+  // audio; see Automation.h. Only modified while holding `mutex`.
+  std::shared_ptr<PluginAutomation> automation;
+
+  // If true, this plugin isn't run on silent input once its tail has
+  // finished; see skipIfSilent(). Only modified while holding `mutex`.
+  bool skipSilence = false;
+  long long silentInputSamples = 0;
+  bool skippingSilence = false;
+
+  // The number of heap allocations and mutex acquisitions made while this
+  // plugin was processing audio, if real-time auditing is enabled; see
+  // RealtimeAudit.h.
+  std::atomic<unsigned long long> realtimeAuditAllocations = 0;
+  std::atomic<unsigned long long> realtimeAuditLockAcquisitions = 0;
+
+  // Cumulative statistics about this plugin's calls to process(), collected
+  // while profiling is enabled; see Profiling.h.
+  struct ProfilingCounters {
+    std::atomic<unsigned long long> calls = 0;
+    std::atomic<unsigned long long> samplesProcessed = 0;
+    std::atomic<unsigned long long> nanoseconds = 0;
+    std::atomic<unsigned long long> reallocations = 0;
+  } profilingCounters;
+
 protected:
   juce::dsp::ProcessSpec lastSpec = {0};
+
+private:
+  // Scratch space used to process 64-bit audio with a 32-bit process() call.
+  juce::AudioBuffer<float> singlePrecisionBuffer;
 };
 } // namespace Pedalboard
\ No newline at end of file
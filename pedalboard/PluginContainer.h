@@ -18,7 +18,10 @@
 #pragma once
 
 #include "JuceHeader.h"
+#include <atomic>
 #include <mutex>
+#include <optional>
+#include <shared_mutex>
 
 #include "Plugin.h"
 
@@ -63,8 +66,15 @@ public:
    * by this plugin, not including itself.
    */
   std::vector<std::shared_ptr<Plugin>> getAllPlugins() {
+    std::vector<std::shared_ptr<Plugin>> children;
+    {
+      // Don't hold this lock while recursing, to avoid nesting locks:
+      std::shared_lock lock(pluginListMutex);
+      children = plugins;
+    }
+
     std::vector<std::shared_ptr<Plugin>> flatList;
-    for (auto plugin : plugins) {
+    for (auto &plugin : children) {
       if (!plugin) {
         continue;
       }
@@ -79,6 +89,46 @@ public:
     return flatList;
   }
 
+  /*
+   * Clone each of the plugins contained by this plugin. Returns an empty
+   * optional if any of the contained plugins could not be cloned.
+   */
+  std::optional<std::vector<std::shared_ptr<Plugin>>> clonePlugins() {
+    std::vector<std::shared_ptr<Plugin>> clones;
+    for (auto &plugin : plugins) {
+      if (!plugin) {
+        clones.push_back(nullptr);
+        continue;
+      }
+
+      auto clone = plugin->clone();
+      if (!clone) {
+        return {};
+      }
+      clones.push_back(clone);
+    }
+    return clones;
+  }
+
+  /**
+   * Guards the list of plugins in this container (but not the plugins
+   * themselves). Hold this lock shared to read the list, or exclusively to
+   * modify it.
+   *
+   * Code that modifies the list must also hold this container's `mutex`,
+   * which is held for the duration of every render. This ensures that the
+   * list never changes while audio is being processed, while still allowing
+   * the list to be read (i.e.: by __len__ or __getitem__) during a render.
+   */
+  std::shared_mutex pluginListMutex;
+
+  /**
+   * Incremented whenever the list of plugins in any container is modified,
+   * allowing other threads (i.e.: AudioStream's) to cheaply poll for changes
+   * without taking any locks.
+   */
+  static inline std::atomic<unsigned long long> modificationCount{0};
+
 protected:
   std::vector<std::shared_ptr<Plugin>> plugins;
 };
@@ -103,7 +153,7 @@ inline void init_plugin_container(py::module &m) {
       .def(
           "__getitem__",
           [](PluginContainer &s, int i) {
-            std::scoped_lock lock(s.mutex);
+            std::shared_lock lock(s.pluginListMutex);
             if (i < 0)
               i = s.getPlugins().size() + i;
             if (i < 0)
@@ -118,7 +168,9 @@ inline void init_plugin_container(py::module &m) {
       .def(
           "__setitem__",
           [](PluginContainer &s, int i, std::shared_ptr<Plugin> plugin) {
-            std::scoped_lock lock(s.mutex);
+            std::scoped_lock renderLock(s.mutex);
+            std::unique_lock lock(s.pluginListMutex);
+            modificationCount++;
             if (i < 0)
               i = s.getPlugins().size() + i;
             if (i < 0)
@@ -141,7 +193,9 @@ inline void init_plugin_container(py::module &m) {
       .def(
           "__delitem__",
           [](PluginContainer &s, int i) {
-            std::scoped_lock lock(s.mutex);
+            std::scoped_lock renderLock(s.mutex);
+            std::unique_lock lock(s.pluginListMutex);
+            modificationCount++;
             if (i < 0)
               i = s.getPlugins().size() + i;
             if (i < 0)
@@ -157,14 +211,16 @@ inline void init_plugin_container(py::module &m) {
       .def(
           "__len__",
           [](PluginContainer &s) {
-            std::scoped_lock lock(s.mutex);
+            std::shared_lock lock(s.pluginListMutex);
             return s.getPlugins().size();
           },
           "Get the number of plugins in this container.")
       .def(
           "insert",
           [](PluginContainer &s, int i, std::shared_ptr<Plugin> plugin) {
-            std::scoped_lock lock(s.mutex);
+            std::scoped_lock renderLock(s.mutex);
+            std::unique_lock lock(s.pluginListMutex);
+            modificationCount++;
             if (i < 0)
               i = s.getPlugins().size() + i;
             if (i < 0)
@@ -187,7 +243,9 @@ inline void init_plugin_container(py::module &m) {
       .def(
           "append",
           [](PluginContainer &s, std::shared_ptr<Plugin> plugin) {
-            std::scoped_lock lock(s.mutex);
+            std::scoped_lock renderLock(s.mutex);
+            std::unique_lock lock(s.pluginListMutex);
+            modificationCount++;
 
             if (plugin && !plugin->acceptsAudioInput()) {
               throw std::domain_error(
@@ -202,7 +260,9 @@ inline void init_plugin_container(py::module &m) {
       .def(
           "remove",
           [](PluginContainer &s, std::shared_ptr<Plugin> plugin) {
-            std::scoped_lock lock(s.mutex);
+            std::scoped_lock renderLock(s.mutex);
+            std::unique_lock lock(s.pluginListMutex);
+            modificationCount++;
             auto &plugins = s.getPlugins();
             auto position = std::find(plugins.begin(), plugins.end(), plugin);
             if (position == plugins.end())
@@ -220,7 +280,7 @@ inline void init_plugin_container(py::module &m) {
       .def(
           "__contains__",
           [](PluginContainer &s, std::shared_ptr<Plugin> plugin) {
-            std::scoped_lock lock(s.mutex);
+            std::shared_lock lock(s.pluginListMutex);
             auto &plugins = s.getPlugins();
             return std::find(plugins.begin(), plugins.end(), plugin) !=
                    plugins.end();
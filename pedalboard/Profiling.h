@@ -0,0 +1,127 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+#include <pybind11/pybind11.h>
+
+#include "Plugin.h"
+#include "PluginContainer.h"
+
+namespace py = pybind11;
+
+namespace Pedalboard {
+
+inline std::atomic<bool> &getProfilingEnabled() {
+  static std::atomic<bool> enabled = false;
+  return enabled;
+}
+
+/**
+ * Adds the time taken (and the number of samples processed) by a single call
+ * to a plugin's process() method to that plugin's ProfilingCounters, if
+ * profiling is enabled. If it's not, this only costs one atomic load.
+ */
+class ProfilingScope {
+public:
+  ProfilingScope(Plugin &plugin, size_t numSamples)
+      : plugin(getProfilingEnabled().load(std::memory_order_relaxed)
+                   ? &plugin
+                   : nullptr),
+        numSamples(numSamples) {
+    if (this->plugin)
+      startTime = std::chrono::steady_clock::now();
+  }
+
+  ~ProfilingScope() {
+    if (!plugin)
+      return;
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - startTime);
+    auto &counters = plugin->profilingCounters;
+    counters.calls.fetch_add(1, std::memory_order_relaxed);
+    counters.samplesProcessed.fetch_add(numSamples, std::memory_order_relaxed);
+    counters.nanoseconds.fetch_add(elapsed.count(), std::memory_order_relaxed);
+  }
+
+  ProfilingScope(const ProfilingScope &) = delete;
+  ProfilingScope &operator=(const ProfilingScope &) = delete;
+
+  /**
+   * Record that the output buffer had to be reallocated to make room for the
+   * latency introduced by the provided plugin.
+   */
+  static void recordReallocation(Plugin *plugin) {
+    if (plugin && getProfilingEnabled().load(std::memory_order_relaxed)) {
+      plugin->profilingCounters.reallocations.fetch_add(
+          1, std::memory_order_relaxed);
+    }
+  }
+
+private:
+  Plugin *plugin;
+  size_t numSamples;
+  std::chrono::steady_clock::time_point startTime;
+};
+
+/**
+ * Return the profiling counters of the provided plugin and every plugin
+ * nested within it, as a dictionary keyed by plugin.
+ */
+inline py::dict getProfile(std::shared_ptr<Plugin> plugin, bool reset) {
+  std::vector<std::shared_ptr<Plugin>> plugins = {plugin};
+  if (auto *container = dynamic_cast<PluginContainer *>(plugin.get())) {
+    auto nestedPlugins = container->getAllPlugins();
+    plugins.insert(plugins.end(), nestedPlugins.begin(), nestedPlugins.end());
+  }
+
+  py::dict profile;
+  for (auto &plugin : plugins) {
+    auto &counters = plugin->profilingCounters;
+    const auto read = [reset](std::atomic<unsigned long long> &counter) {
+      return reset ? counter.exchange(0) : counter.load();
+    };
+
+    py::dict entry;
+    entry["calls"] = read(counters.calls);
+    entry["samples_processed"] = read(counters.samplesProcessed);
+    entry["seconds"] = read(counters.nanoseconds) / 1e9;
+    entry["reallocations"] = read(counters.reallocations);
+    entry["latency_samples"] = plugin->getLatencyHint();
+    profile[py::cast(plugin)] = entry;
+  }
+  return profile;
+}
+
+inline void init_profiling(py::module &m) {
+  m.def(
+      "set_profiling_enabled",
+      [](bool enabled) { getProfilingEnabled() = enabled; },
+      py::arg("enabled"), R"(
+Enable or disable collection of per-plugin profiling statistics (read with
+:py:meth:`Plugin.profile`) whenever any plugin processes audio. Profiling is
+disabled by default, and costs almost nothing while disabled.
+
+*Introduced in v0.9.0.*
+)");
+}
+
+} // namespace Pedalboard
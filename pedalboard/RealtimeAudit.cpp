@@ -0,0 +1,138 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Hooks that report heap allocations and mutex acquisitions made by
+ * Pedalboard's native code to RealtimeAuditScope. Only compiled into builds
+ * with PEDALBOARD_REALTIME_AUDIT set (see setup.py), as every allocation made
+ * by Pedalboard goes through these functions.
+ *
+ * On Linux, setup.py links with `--wrap` for each hooked symbol, so that
+ * calls from Pedalboard's objects (including JUCE and inlined standard
+ * library code) go to the __wrap_* functions below, which call through to
+ * the __real_* originals. On macOS, symbols defined here take precedence for
+ * calls from within the same image, and call through to the system's
+ * implementations directly. On Windows, only replacing `new` is possible.
+ */
+
+#if PEDALBOARD_REALTIME_AUDIT
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <pthread.h>
+#endif
+
+#if defined(__APPLE__)
+#include <dlfcn.h>
+#include <malloc/malloc.h>
+#endif
+
+#include "RealtimeAudit.h"
+
+using Pedalboard::RealtimeAuditScope;
+
+#if defined(__linux__)
+extern "C" {
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *pointer, size_t size);
+int __real_pthread_mutex_lock(pthread_mutex_t *mutex);
+
+void *__wrap_malloc(size_t size) {
+  RealtimeAuditScope::noteAllocation();
+  return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+  RealtimeAuditScope::noteAllocation();
+  return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *pointer, size_t size) {
+  RealtimeAuditScope::noteAllocation();
+  return __real_realloc(pointer, size);
+}
+
+int __wrap_pthread_mutex_lock(pthread_mutex_t *mutex) {
+  RealtimeAuditScope::noteLockAcquisition();
+  return __real_pthread_mutex_lock(mutex);
+}
+}
+#elif defined(__APPLE__)
+extern "C" {
+void *malloc(size_t size) {
+  RealtimeAuditScope::noteAllocation();
+  return malloc_zone_malloc(malloc_default_zone(), size);
+}
+
+void *calloc(size_t count, size_t size) {
+  RealtimeAuditScope::noteAllocation();
+  return malloc_zone_calloc(malloc_default_zone(), count, size);
+}
+
+void *realloc(void *pointer, size_t size) {
+  RealtimeAuditScope::noteAllocation();
+  return malloc_zone_realloc(malloc_default_zone(), pointer, size);
+}
+
+int pthread_mutex_lock(pthread_mutex_t *mutex) {
+  using LockFunction = int (*)(pthread_mutex_t *);
+  static LockFunction systemLock =
+      (LockFunction)dlsym(RTLD_NEXT, "pthread_mutex_lock");
+  RealtimeAuditScope::noteLockAcquisition();
+  return systemLock(mutex);
+}
+}
+#endif
+
+// The standard library's `new` calls its own (unhooked) malloc, so route
+// Pedalboard's calls to `new` through the hooked malloc above instead. (The
+// standard library's `delete` frees this memory correctly, as it comes from
+// the same system allocator either way.)
+static void *allocateForNew(std::size_t size) {
+  if (size == 0)
+    size = 1;
+#if defined(__linux__)
+  void *pointer = __wrap_malloc(size);
+#elif defined(__APPLE__)
+  void *pointer = malloc(size);
+#else
+  RealtimeAuditScope::noteAllocation();
+  void *pointer = std::malloc(size);
+#endif
+  if (!pointer)
+    throw std::bad_alloc();
+  return pointer;
+}
+
+#if defined(__linux__)
+// The mangled names of operator new(size_t) and operator new[](size_t):
+extern "C" {
+void *__wrap__Znwm(size_t size) { return allocateForNew(size); }
+void *__wrap__Znam(size_t size) { return allocateForNew(size); }
+}
+#else
+void *operator new(std::size_t size) { return allocateForNew(size); }
+void *operator new[](std::size_t size) { return allocateForNew(size); }
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+void operator delete[](void *pointer) noexcept { std::free(pointer); }
+#endif
+
+#endif
@@ -0,0 +1,218 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <typeinfo>
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include "Plugin.h"
+#include "PluginContainer.h"
+
+namespace py = pybind11;
+
+namespace Pedalboard {
+
+enum class RealtimeAuditMode {
+  // Nothing is counted:
+  Off,
+  // Heap allocations and lock acquisitions are counted per plugin:
+  Count,
+  // The process is aborted (i.e.: to break into a debugger) on the first
+  // heap allocation or lock acquisition:
+  Trap,
+};
+
+inline std::atomic<RealtimeAuditMode> &getRealtimeAuditMode() {
+  static std::atomic<RealtimeAuditMode> mode = RealtimeAuditMode::Off;
+  return mode;
+}
+
+/**
+ * Marks the current thread as processing audio with the given plugin for
+ * the lifetime of this object. Scopes nest, so that work done by a plugin
+ * container (like Chain or Mix) is attributed to the container, and work done
+ * by each of its plugins is attributed to that plugin.
+ *
+ * If Pedalboard is built with PEDALBOARD_REALTIME_AUDIT (i.e.: with
+ * USE_REALTIME_AUDIT=1 set when running setup.py), RealtimeAudit.cpp hooks
+ * heap allocations and mutex locks made by Pedalboard's native code
+ * (including JUCE) and reports them to the innermost scope on the current
+ * thread. Otherwise, this class does nothing and compiles away entirely.
+ */
+class RealtimeAuditScope {
+public:
+#if PEDALBOARD_REALTIME_AUDIT
+  explicit RealtimeAuditScope(Plugin &plugin)
+      : plugin(plugin), previous(current()) {
+    current() = this;
+  }
+  ~RealtimeAuditScope() { current() = previous; }
+
+  RealtimeAuditScope(const RealtimeAuditScope &) = delete;
+  RealtimeAuditScope &operator=(const RealtimeAuditScope &) = delete;
+
+  // Called from the allocation and locking hooks, so must not allocate,
+  // lock, or throw:
+  static void noteAllocation() {
+    note(&Plugin::realtimeAuditAllocations, "a heap allocation");
+  }
+
+  static void noteLockAcquisition() {
+    note(&Plugin::realtimeAuditLockAcquisitions, "a mutex acquisition");
+  }
+
+private:
+  static RealtimeAuditScope *&current() {
+    static thread_local RealtimeAuditScope *scope = nullptr;
+    return scope;
+  }
+
+  static void note(std::atomic<unsigned long long> Plugin::*counter,
+                   const char *description) {
+    RealtimeAuditScope *scope = current();
+    if (!scope)
+      return;
+
+    switch (getRealtimeAuditMode().load(std::memory_order_relaxed)) {
+    case RealtimeAuditMode::Off:
+      return;
+    case RealtimeAuditMode::Count:
+      (scope->plugin.*counter).fetch_add(1, std::memory_order_relaxed);
+      return;
+    case RealtimeAuditMode::Trap:
+      // Printing may allocate, so stop auditing this thread first:
+      current() = nullptr;
+      std::fprintf(stderr,
+                   "Pedalboard real-time audit: %s was made while processing "
+                   "audio with a plugin of type %s.\n",
+                   description, typeid(scope->plugin).name());
+      std::abort();
+    }
+  }
+
+  Plugin &plugin;
+  RealtimeAuditScope *previous;
+#else
+  explicit RealtimeAuditScope(Plugin &) {}
+
+  static void noteAllocation() {}
+  static void noteLockAcquisition() {}
+#endif
+};
+
+inline void init_realtime_audit(py::module &m) {
+  m.def(
+      "set_realtime_audit_mode",
+      [](std::string mode) {
+        RealtimeAuditMode newMode;
+        if (mode == "off") {
+          newMode = RealtimeAuditMode::Off;
+        } else if (mode == "count") {
+          newMode = RealtimeAuditMode::Count;
+        } else if (mode == "trap") {
+          newMode = RealtimeAuditMode::Trap;
+        } else {
+          throw std::invalid_argument("Expected mode to be one of \"off\", "
+                                      "\"count\", or \"trap\", but got \"" +
+                                      mode + "\".");
+        }
+
+#if !PEDALBOARD_REALTIME_AUDIT
+        if (newMode != RealtimeAuditMode::Off) {
+          throw std::runtime_error(
+              "This build of Pedalboard does not support real-time auditing. "
+              "To enable it, build Pedalboard from source with the "
+              "USE_REALTIME_AUDIT=1 environment variable set.");
+        }
+#endif
+        getRealtimeAuditMode() = newMode;
+      },
+      py::arg("mode"), R"(
+Enable or disable auditing of real-time safety while plugins process audio.
+Useful for finding the source of buffer underruns (xruns) when streaming audio
+with :class:`pedalboard.io.AudioStream`.
+
+While enabled, every heap allocation and mutex acquisition made by
+Pedalboard's native code while a plugin is processing audio (whether through
+:py:meth:`Plugin.process`, a :class:`Chain`, or an
+:class:`pedalboard.io.AudioStream`) is attributed to that plugin. ``mode`` may
+be one of:
+
+ - ``"off"`` (the default): nothing is audited.
+ - ``"count"``: violations are counted per plugin, and can be read with
+   :py:func:`get_realtime_audit_report`.
+ - ``"trap"``: the process is aborted with a message on the first violation,
+   to allow inspecting the stack in a debugger.
+
+.. note::
+    Auditing is only available in builds of Pedalboard compiled with the
+    ``USE_REALTIME_AUDIT=1`` environment variable set, and lock acquisitions
+    are only counted on macOS and Linux. Only allocations and locks made by
+    Pedalboard itself (including JUCE) are seen; those made inside of
+    third-party VST3 or Audio Unit plugins are not.
+
+*Introduced in v0.9.0.*
+)");
+
+  m.def(
+      "get_realtime_audit_report",
+      [](std::shared_ptr<Plugin> plugin, bool reset) {
+        std::vector<std::shared_ptr<Plugin>> plugins = {plugin};
+        if (auto *container = dynamic_cast<PluginContainer *>(plugin.get())) {
+          auto nestedPlugins = container->getAllPlugins();
+          plugins.insert(plugins.end(), nestedPlugins.begin(),
+                         nestedPlugins.end());
+        }
+
+        py::dict report;
+        for (auto &plugin : plugins) {
+          unsigned long long allocations =
+              reset ? plugin->realtimeAuditAllocations.exchange(0)
+                    : plugin->realtimeAuditAllocations.load();
+          unsigned long long lockAcquisitions =
+              reset ? plugin->realtimeAuditLockAcquisitions.exchange(0)
+                    : plugin->realtimeAuditLockAcquisitions.load();
+          if (allocations == 0 && lockAcquisitions == 0)
+            continue;
+
+          py::dict counts;
+          counts["allocations"] = allocations;
+          counts["lock_acquisitions"] = lockAcquisitions;
+          report[py::cast(plugin)] = counts;
+        }
+        return report;
+      },
+      py::arg("plugin"), py::arg("reset") = false, R"(
+Return the number of real-time safety violations (see
+:py:func:`set_realtime_audit_mode`) counted for the provided plugin and every
+plugin nested within it, as a dictionary mapping each plugin with one or more
+violations to a dictionary of ``allocations`` and ``lock_acquisitions``.
+
+If ``reset`` is ``True``, the counts of each plugin are set back to zero.
+
+*Introduced in v0.9.0.*
+)");
+}
+
+} // namespace Pedalboard
@@ -0,0 +1,335 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <variant>
+
+#include "JuceHeader.h"
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include "Plugin.h"
+#include "StreamingProcessor.h"
+#include "io/ReadableAudioFile.h"
+#include "io/WriteableAudioFile.h"
+
+namespace py = pybind11;
+
+namespace Pedalboard {
+
+/**
+ * A simple thread-safe FIFO queue that holds at most `capacity` items.
+ * push() blocks while the queue is full and pop() blocks while it is empty,
+ * until the queue is closed.
+ */
+template <typename T> class BoundedQueue {
+public:
+  BoundedQueue(size_t capacity) : capacity(std::max<size_t>(1, capacity)) {}
+
+  /**
+   * Add an item to the end of the queue, waiting for space if necessary.
+   * Returns false (and drops the item) if the queue has been closed.
+   */
+  bool push(T &&item) {
+    std::unique_lock<std::mutex> lock(mutex);
+    notFull.wait(lock, [&]() { return closed || items.size() < capacity; });
+    if (closed)
+      return false;
+
+    items.push_back(std::move(item));
+    notEmpty.notify_one();
+    return true;
+  }
+
+  /**
+   * Add an item to the end of the queue only if there's space for it right
+   * now. Returns false (and drops the item) otherwise.
+   */
+  bool tryPush(T &&item) {
+    std::scoped_lock lock(mutex);
+    if (closed || items.size() >= capacity)
+      return false;
+
+    items.push_back(std::move(item));
+    notEmpty.notify_one();
+    return true;
+  }
+
+  /**
+   * Remove an item from the front of the queue, waiting for one to arrive if
+   * necessary. Returns nothing once the queue is closed and empty.
+   */
+  std::optional<T> pop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    notEmpty.wait(lock, [&]() { return closed || !items.empty(); });
+    return popFront();
+  }
+
+  /**
+   * Remove an item from the front of the queue if one is available right now.
+   */
+  std::optional<T> tryPop() {
+    std::scoped_lock lock(mutex);
+    return popFront();
+  }
+
+  /**
+   * Prevent any more items from being added to this queue, and wake up any
+   * threads waiting on it. Items already in the queue can still be popped.
+   */
+  void close() {
+    std::scoped_lock lock(mutex);
+    closed = true;
+    notEmpty.notify_all();
+    notFull.notify_all();
+  }
+
+private:
+  std::optional<T> popFront() {
+    if (items.empty())
+      return {};
+
+    T item = std::move(items.front());
+    items.pop_front();
+    notFull.notify_one();
+    return {std::move(item)};
+  }
+
+  const size_t capacity;
+  std::deque<T> items;
+  bool closed = false;
+  std::mutex mutex;
+  std::condition_variable notEmpty;
+  std::condition_variable notFull;
+};
+
+/**
+ * Read an entire audio file, run it through the provided plugins, and write
+ * the result to another audio file. Decoding, processing, and encoding each
+ * run on their own thread, connected by queues that hold at most
+ * `queueSize` chunks of audio each, so the total time taken is roughly that
+ * of the slowest stage (rather than the sum of all three) and memory usage
+ * is bounded regardless of the length of the file.
+ *
+ * Must be called without holding the GIL. Returns the number of frames
+ * written to the output file.
+ */
+inline long long renderFile(ReadableAudioFile &input, WriteableAudioFile &output,
+                            const std::vector<std::shared_ptr<Plugin>> &plugins,
+                            unsigned int bufferSize, unsigned int chunkSize,
+                            unsigned int queueSize, bool reset) {
+  if (chunkSize == 0) {
+    throw std::domain_error("chunk_size must be at least 1.");
+  }
+  if (queueSize == 0) {
+    throw std::domain_error("queue_size must be at least 1.");
+  }
+
+  int numChannels = input.getNumChannels();
+  if (output.getNumChannels() != numChannels) {
+    throw std::domain_error(
+        "The output file was opened with num_channels=" +
+        std::to_string(output.getNumChannels()) +
+        ", but the input file contains " + std::to_string(numChannels) +
+        "-channel audio.");
+  }
+
+  StreamingProcessor processor(plugins, input.getSampleRateAsDouble(),
+                               numChannels, bufferSize, reset);
+
+  BoundedQueue<juce::AudioBuffer<float>> decodedChunks(queueSize);
+  BoundedQueue<juce::AudioBuffer<float>> processedChunks(queueSize);
+
+  // Buffers that have been written to the output file are handed back to the
+  // decoder to be reused, to avoid allocating memory for every chunk:
+  BoundedQueue<juce::AudioBuffer<float>> spareChunks(queueSize * 2 + 1);
+
+  std::exception_ptr decodeException;
+  std::exception_ptr processException;
+  std::exception_ptr encodeException;
+
+  auto stopAllStages = [&]() {
+    decodedChunks.close();
+    processedChunks.close();
+    spareChunks.close();
+  };
+
+  long long framesWritten = 0;
+
+  std::thread decodeThread([&]() {
+    try {
+      while (input.tell() < input.getLengthInSamples()) {
+        juce::AudioBuffer<float> chunk =
+            spareChunks.tryPop().value_or(juce::AudioBuffer<float>());
+        chunk.setSize(numChannels, chunkSize,
+                      /* keepExistingContent= */ false,
+                      /* clearExtraSpace= */ false,
+                      /* avoidReallocating= */ true);
+
+        long long framesRead =
+            input.readInto(chunk.getArrayOfWritePointers(), chunkSize);
+        if (framesRead <= 0)
+          break;
+
+        chunk.setSize(numChannels, framesRead, false, false, true);
+        if (!decodedChunks.push(std::move(chunk)))
+          break;
+      }
+      decodedChunks.close();
+    } catch (...) {
+      decodeException = std::current_exception();
+      stopAllStages();
+    }
+  });
+
+  std::thread encodeThread([&]() {
+    try {
+      while (std::optional<juce::AudioBuffer<float>> chunk =
+                 processedChunks.pop()) {
+        output.writeBuffer(*chunk, 0, chunk->getNumSamples());
+        framesWritten += chunk->getNumSamples();
+        spareChunks.tryPush(std::move(*chunk));
+      }
+    } catch (...) {
+      encodeException = std::current_exception();
+      stopAllStages();
+    }
+  });
+
+  // Process audio on the calling thread:
+  try {
+    bool stopped = false;
+    while (std::optional<juce::AudioBuffer<float>> chunk = decodedChunks.pop()) {
+      // The processed audio is never longer than the input chunk, so we can
+      // reuse the input chunk's memory to pass it along:
+      processor.push(*chunk, *chunk);
+      int numProcessedSamples = chunk->getNumSamples();
+
+      if (numProcessedSamples > 0) {
+        if (!processedChunks.push(std::move(*chunk))) {
+          // Another stage has failed:
+          stopped = true;
+          break;
+        }
+      } else {
+        spareChunks.tryPush(std::move(*chunk));
+      }
+    }
+
+    if (!stopped) {
+      // Return any audio still buffered in the plugins (i.e.: due to latency):
+      juce::AudioBuffer<float> tail;
+      processor.flush(tail);
+      if (tail.getNumSamples() > 0) {
+        processedChunks.push(std::move(tail));
+      }
+    }
+    processedChunks.close();
+  } catch (...) {
+    processException = std::current_exception();
+    stopAllStages();
+  }
+
+  decodeThread.join();
+  encodeThread.join();
+
+  for (auto exception : {decodeException, processException, encodeException}) {
+    if (exception)
+      std::rethrow_exception(exception);
+  }
+
+  return framesWritten;
+}
+
+inline void init_render_file(py::module &m) {
+  m.def(
+      "render_file",
+      [](std::variant<std::string, std::shared_ptr<ReadableAudioFile>> input,
+         std::variant<std::string, std::shared_ptr<WriteableAudioFile>> output,
+         std::shared_ptr<Plugin> plugin, unsigned int bufferSize,
+         unsigned int chunkSize, unsigned int queueSize, bool reset,
+         int bitDepth,
+         std::optional<std::variant<std::string, float>> quality) {
+        std::shared_ptr<ReadableAudioFile> inputFile;
+        if (auto *filename = std::get_if<std::string>(&input)) {
+          inputFile = std::make_shared<ReadableAudioFile>(*filename);
+        } else {
+          inputFile = std::get<std::shared_ptr<ReadableAudioFile>>(input);
+        }
+
+        std::shared_ptr<WriteableAudioFile> outputFile;
+        bool ownsOutputFile = false;
+        if (auto *filename = std::get_if<std::string>(&output)) {
+          outputFile = std::make_shared<WriteableAudioFile>(
+              *filename, inputFile->getSampleRateAsDouble(),
+              inputFile->getNumChannels(), bitDepth, quality);
+          ownsOutputFile = true;
+        } else {
+          outputFile = std::get<std::shared_ptr<WriteableAudioFile>>(output);
+        }
+
+        long long framesWritten;
+        {
+          py::gil_scoped_release release;
+          framesWritten = renderFile(*inputFile, *outputFile, {plugin},
+                                     bufferSize, chunkSize, queueSize, reset);
+        }
+
+        if (ownsOutputFile) {
+          outputFile->close();
+        }
+        return framesWritten;
+      },
+      R"(
+Read an audio file, process it with the provided plugin (or
+:class:`pedalboard.Pedalboard`), and write the result to another audio file.
+
+Decoding, processing, and encoding each run on their own native thread without
+holding Python's Global Interpreter Lock, passing chunks of ``chunk_size``
+frames between them through queues that hold at most ``queue_size`` chunks.
+This makes rendering a file take roughly as long as the slowest of those three
+stages (rather than all three added together) while using a constant amount of
+memory, regardless of the length of the file.
+
+``input`` may be a filename or a :class:`pedalboard.io.ReadableAudioFile`, and
+``output`` may be a filename or a :class:`pedalboard.io.WriteableAudioFile`. If
+``output`` is a filename, it will be opened with the same sample rate and number
+of channels as the input file (plus the provided ``bit_depth`` and ``quality``)
+and closed once rendering is complete. Files passed in as objects are not
+closed. Reading starts from the input file's current position.
+
+The rendered audio is latency-compensated and exactly as long as the audio that
+was read, just as if the entire file had been passed to :py:meth:`Plugin.process`
+at once. Returns the number of frames written.
+
+*Introduced in v0.9.0.*
+)",
+      py::arg("input"), py::arg("output"), py::arg("plugin"),
+      py::arg("buffer_size") = DEFAULT_BUFFER_SIZE,
+      py::arg("chunk_size") = DEFAULT_AUDIO_BUFFER_SIZE_FRAMES * 4,
+      py::arg("queue_size") = 4, py::arg("reset") = true,
+      py::arg("bit_depth") = 16, py::arg("quality") = py::none());
+}
+
+} // namespace Pedalboard
@@ -0,0 +1,126 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "JuceHeader.h"
+
+namespace Pedalboard {
+
+/**
+ * The largest buffer (in bytes, across all channels) that is kept for reuse
+ * by a thread once it's no longer needed. Larger buffers are freed as usual,
+ * so processing one long file doesn't pin its memory for the life of the
+ * thread; allocation costs are negligible compared to processing them anyways.
+ */
+static constexpr size_t MAX_SCRATCH_BUFFER_BYTES = 8 * 1024 * 1024;
+
+/**
+ * The number of idle buffers of each sample type that each thread keeps for
+ * reuse. Each process() call uses at most one or two at a time.
+ */
+static constexpr size_t MAX_SCRATCH_BUFFERS_PER_THREAD = 4;
+
+/**
+ * A per-thread pool of scratch audio buffers, used for the short-lived
+ * buffers allocated on every call to process() and friends. Processing many
+ * short clips would otherwise call malloc and free (and contend on the
+ * allocator's locks across threads) several times per clip; instead, each
+ * thread reuses the buffers it used on its last call.
+ *
+ * Buffers are leased with acquire() and returned to the calling thread's pool
+ * when the lease is destroyed, so leases must not outlive the thread they
+ * were acquired on (and should only be held for the duration of one call).
+ */
+template <typename SampleType> class ScratchBuffers {
+  struct Entry {
+    juce::AudioBuffer<SampleType> buffer;
+
+    // The largest size this buffer has been given, in bytes. AudioBuffer
+    // never shrinks its allocation, so this is (roughly) its capacity:
+    size_t capacityBytes = 0;
+  };
+
+public:
+  class Lease {
+  public:
+    Lease(std::unique_ptr<Entry> entry) : entry(std::move(entry)) {}
+    Lease(Lease &&) = default;
+    Lease &operator=(Lease &&) = default;
+    Lease(const Lease &) = delete;
+    Lease &operator=(const Lease &) = delete;
+
+    ~Lease() {
+      if (entry)
+        release(std::move(entry));
+    }
+
+    juce::AudioBuffer<SampleType> &operator*() { return entry->buffer; }
+    juce::AudioBuffer<SampleType> *operator->() { return &entry->buffer; }
+
+  private:
+    std::unique_ptr<Entry> entry;
+  };
+
+  /**
+   * Lease a buffer of the given size from this thread's pool (or a new
+   * buffer, if the pool is empty). Its contents are not cleared.
+   */
+  static Lease acquire(int numChannels, int numSamples) {
+    auto &pool = getPool();
+    std::unique_ptr<Entry> entry;
+    if (pool.empty()) {
+      entry = std::make_unique<Entry>();
+    } else {
+      entry = std::move(pool.back());
+      pool.pop_back();
+    }
+    entry->buffer.setSize(numChannels, numSamples,
+                          /* keepExistingContent= */ false,
+                          /* clearExtraSpace= */ false,
+                          /* avoidReallocating= */ true);
+    entry->capacityBytes = std::max(entry->capacityBytes, getBytes(*entry));
+    return Lease(std::move(entry));
+  }
+
+private:
+  static size_t getBytes(const Entry &entry) {
+    return sizeof(SampleType) * (size_t)entry.buffer.getNumChannels() *
+           (size_t)entry.buffer.getNumSamples();
+  }
+
+  static void release(std::unique_ptr<Entry> entry) {
+    // The buffer may have grown while it was leased:
+    entry->capacityBytes = std::max(entry->capacityBytes, getBytes(*entry));
+    auto &pool = getPool();
+    if (entry->capacityBytes <= MAX_SCRATCH_BUFFER_BYTES &&
+        pool.size() < MAX_SCRATCH_BUFFERS_PER_THREAD) {
+      pool.push_back(std::move(entry));
+    }
+  }
+
+  static std::vector<std::unique_ptr<Entry>> &getPool() {
+    thread_local std::vector<std::unique_ptr<Entry>> pool;
+    return pool;
+  }
+};
+
+} // namespace Pedalboard
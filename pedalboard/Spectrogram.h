@@ -0,0 +1,644 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <variant>
+#include <vector>
+
+#include "JuceHeader.h"
+#include <pybind11/complex.h>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include "BufferUtils.h"
+#include "io/ReadableAudioFile.h"
+#include "io/ResampledReadableAudioFile.h"
+
+namespace py = pybind11;
+
+namespace Pedalboard {
+
+// The number of frames windowed and transformed at once. Each batch's results
+// are stored (and later copied into the output array) as contiguous runs of
+// this many frames per bin, rather than one value at a time:
+static const int SPECTROGRAM_FRAMES_PER_BATCH = 64;
+
+/**
+ * Return a (shared, thread-safe) FFT of the given order (i.e.: size
+ * 2^order). Creating an FFT computes its twiddle factors (and on some
+ * platforms, allocates a plan), so each size is only created once per process.
+ */
+inline std::shared_ptr<const juce::dsp::FFT> getCachedFFT(int order) {
+  static std::mutex cacheMutex;
+  static std::map<int, std::shared_ptr<const juce::dsp::FFT>> cache;
+
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  std::shared_ptr<const juce::dsp::FFT> &fft = cache[order];
+  if (!fft)
+    fft = std::make_shared<const juce::dsp::FFT>(order);
+  return fft;
+}
+
+/**
+ * Create a periodic window function of the given size, as used for spectral
+ * analysis (and as returned by scipy.signal.get_window).
+ */
+inline std::vector<float> createAnalysisWindow(const std::string &name,
+                                               int size) {
+  std::vector<float> window(size);
+  for (int i = 0; i < size; i++) {
+    double phase = 2.0 * juce::MathConstants<double>::pi * i / size;
+    if (name == "hann") {
+      window[i] = (float)(0.5 - 0.5 * std::cos(phase));
+    } else if (name == "hamming") {
+      window[i] = (float)(0.54 - 0.46 * std::cos(phase));
+    } else if (name == "blackman") {
+      window[i] = (float)(0.42 - 0.5 * std::cos(phase) +
+                          0.08 * std::cos(2.0 * phase));
+    } else if (name == "boxcar") {
+      window[i] = 1.0f;
+    } else {
+      throw std::domain_error("window must be one of \"hann\", \"hamming\", "
+                              "\"blackman\", or \"boxcar\" (got \"" +
+                              name + "\").");
+    }
+  }
+  return window;
+}
+
+struct STFTSettings {
+  STFTSettings(int fftSize, std::optional<int> hopLength,
+               const std::string &window, bool center)
+      : fftSize(fftSize), hopLength(hopLength ? *hopLength : fftSize / 4),
+        center(center) {
+    if (fftSize < 2 || !juce::isPowerOfTwo(fftSize))
+      throw std::domain_error("n_fft must be a power of 2 (got " +
+                              std::to_string(fftSize) + ").");
+    if (this->hopLength < 1 || this->hopLength > fftSize)
+      throw std::domain_error("hop_length must be between 1 and n_fft (got " +
+                              std::to_string(this->hopLength) + ").");
+
+    fftOrder = juce::roundToInt(std::log2(fftSize));
+    this->window = createAnalysisWindow(window, fftSize);
+  }
+
+  int getNumBins() const { return fftSize / 2 + 1; }
+
+  int fftSize;
+  int fftOrder;
+  int hopLength;
+  bool center;
+  std::vector<float> window;
+};
+
+/**
+ * Split a stream of audio into overlapping frames, window them, and compute
+ * the FFT of each frame, a batch of frames at a time.
+ *
+ * Audio is pulled from `read(float **channels, long long numSamples)`, which
+ * should return the number of samples it read (and 0 once the stream is
+ * exhausted). For each batch, `onBatch(spectra, numFrames)` is called with
+ * the non-negative frequency bins of each frame, laid out as
+ * [channel][frame][bin]. If `center` is set, the stream is padded with
+ * n_fft / 2 zeros on either side, so that frame t is centered on sample
+ * t * hop_length.
+ *
+ * This function does not touch any Python objects, so can be called without
+ * holding the GIL (as long as `read` doesn't need it either).
+ */
+template <typename ReadFunction, typename BatchFunction>
+long long computeSTFT(int numChannels, const STFTSettings &settings,
+                      ReadFunction read, BatchFunction onBatch) {
+  const int fftSize = settings.fftSize;
+  const int hopLength = settings.hopLength;
+  const int numBins = settings.getNumBins();
+  const int padding = settings.center ? fftSize / 2 : 0;
+
+  // Enough audio to compute one full batch of frames, plus room for padding
+  // to be added after the last sample:
+  const int samplesPerBatch =
+      fftSize + (SPECTROGRAM_FRAMES_PER_BATCH - 1) * hopLength;
+  juce::AudioBuffer<float> pending(numChannels, samplesPerBatch + padding);
+  int numPendingSamples = padding;
+  pending.clear(0, padding);
+
+  std::shared_ptr<const juce::dsp::FFT> fft = getCachedFFT(settings.fftOrder);
+  juce::HeapBlock<float> fftBuffer(fftSize * 2);
+  std::vector<std::complex<float>> spectra(
+      (size_t)numChannels * SPECTROGRAM_FRAMES_PER_BATCH * numBins);
+
+  float **channelPointers = (float **)alloca(numChannels * sizeof(float *));
+  bool endOfStream = false;
+  long long numFramesComputed = 0;
+
+  while (true) {
+    while (!endOfStream && numPendingSamples < samplesPerBatch) {
+      for (int c = 0; c < numChannels; c++) {
+        channelPointers[c] = pending.getWritePointer(c, numPendingSamples);
+      }
+
+      long long samplesRead =
+          read(channelPointers, samplesPerBatch - numPendingSamples);
+      if (samplesRead <= 0) {
+        endOfStream = true;
+        pending.clear(numPendingSamples, padding);
+        numPendingSamples += padding;
+      } else {
+        numPendingSamples += (int)samplesRead;
+      }
+    }
+
+    int numFrames =
+        numPendingSamples < fftSize
+            ? 0
+            : std::min(SPECTROGRAM_FRAMES_PER_BATCH,
+                       1 + (numPendingSamples - fftSize) / hopLength);
+    if (numFrames == 0)
+      break;
+
+    for (int c = 0; c < numChannels; c++) {
+      const float *channel = pending.getReadPointer(c);
+      for (int f = 0; f < numFrames; f++) {
+        juce::FloatVectorOperations::multiply(fftBuffer.get(),
+                                              settings.window.data(),
+                                              channel + f * hopLength, fftSize);
+        fft->performRealOnlyForwardTransform(fftBuffer.get(), true);
+        std::memcpy(
+            &spectra[((size_t)c * SPECTROGRAM_FRAMES_PER_BATCH + f) * numBins],
+            fftBuffer.get(), numBins * sizeof(std::complex<float>));
+      }
+    }
+
+    onBatch(spectra.data(), numFrames);
+    numFramesComputed += numFrames;
+
+    // Drop the samples that no future frame will overlap:
+    int consumed = numFrames * hopLength;
+    for (int c = 0; c < numChannels; c++) {
+      float *channel = pending.getWritePointer(c);
+      std::memmove(channel, channel + consumed,
+                   (numPendingSamples - consumed) * sizeof(float));
+    }
+    numPendingSamples -= consumed;
+  }
+
+  return numFramesComputed;
+}
+
+/**
+ * Collects a number of rows (i.e.: frequency bins or mel bands) of values per
+ * channel, a batch of frames at a time, until the total number of frames is
+ * known and the results can be copied into a (channels, rows, frames) array.
+ */
+template <typename T> class FrameBatches {
+public:
+  FrameBatches(int numChannels, int numRows)
+      : numChannels(numChannels), numRows(numRows) {}
+
+  /**
+   * Return storage for the next batch of frames, laid out as
+   * [channel][row][frame].
+   */
+  T *addBatch(int numFrames) {
+    batches.emplace_back((size_t)numChannels * numRows * numFrames);
+    batchSizes.push_back(numFrames);
+    totalFrames += numFrames;
+    return batches.back().data();
+  }
+
+  py::array_t<T> toArray(bool includeChannelAxis) const {
+    py::array_t<T> output =
+        includeChannelAxis
+            ? py::array_t<T>({(long long)numChannels, (long long)numRows,
+                              totalFrames})
+            : py::array_t<T>({(long long)numRows, totalFrames});
+    T *outputPointer = static_cast<T *>(output.request().ptr);
+
+    {
+      py::gil_scoped_release release;
+      long long frameOffset = 0;
+      for (size_t b = 0; b < batches.size(); b++) {
+        int numFrames = batchSizes[b];
+        const T *batch = batches[b].data();
+        for (long long row = 0; row < (long long)numChannels * numRows;
+             row++) {
+          std::memcpy(outputPointer + row * totalFrames + frameOffset,
+                      batch + row * numFrames, numFrames * sizeof(T));
+        }
+        frameOffset += numFrames;
+      }
+    }
+
+    return output;
+  }
+
+private:
+  int numChannels;
+  int numRows;
+  long long totalFrames = 0;
+  std::vector<std::vector<T>> batches;
+  std::vector<int> batchSizes;
+};
+
+using SpectrogramInput =
+    std::variant<std::shared_ptr<ReadableAudioFile>,
+                 std::shared_ptr<ResampledReadableAudioFile>,
+                 py::array_t<float, py::array::c_style>>;
+
+/**
+ * Run computeSTFT over either a NumPy array or the remainder of an audio file
+ * (from its current position onwards), collecting `numRowsPerChannel` rows of
+ * results per channel for each frame. `onBatch(spectra, numChannels,
+ * numFrames, output)` is called for each batch of frames, and should fill
+ * `output` (laid out as [channel][row][frame]) from `spectra`.
+ *
+ * The GIL is released while the audio is read and transformed. Returns the
+ * collected results, and whether the output should have a channel axis.
+ */
+template <typename T, typename BatchFunction>
+std::pair<FrameBatches<T>, bool>
+computeSTFTOf(SpectrogramInput &input, const STFTSettings &settings,
+              int numRowsPerChannel, BatchFunction onBatch) {
+  if (auto *array =
+          std::get_if<py::array_t<float, py::array::c_style>>(&input)) {
+    ChannelLayout layout = detectChannelLayout(*array);
+    const juce::AudioBuffer<float> buffer =
+        convertPyArrayIntoJuceBuffer(*array, layout);
+    const int numChannels = buffer.getNumChannels();
+    FrameBatches<T> batches(numChannels, numRowsPerChannel);
+
+    {
+      py::gil_scoped_release release;
+      long long position = 0;
+      computeSTFT(
+          numChannels, settings,
+          [&](float **channels, long long numSamples) {
+            numSamples =
+                std::min(numSamples, buffer.getNumSamples() - position);
+            for (int c = 0; c < numChannels; c++) {
+              std::memcpy(channels[c], buffer.getReadPointer(c, position),
+                          numSamples * sizeof(float));
+            }
+            position += numSamples;
+            return numSamples;
+          },
+          [&](const std::complex<float> *spectra, int numFrames) {
+            onBatch(spectra, numChannels, numFrames,
+                    batches.addBatch(numFrames));
+          });
+    }
+
+    return {std::move(batches), array->ndim() > 1};
+  }
+
+  return std::visit(
+      [&](auto &&file) -> std::pair<FrameBatches<T>, bool> {
+        using FileType = std::decay_t<decltype(file)>;
+        if constexpr (std::is_same_v<FileType,
+                                     py::array_t<float, py::array::c_style>>) {
+          throw std::runtime_error(
+              "Internal error: array input should have been handled above.");
+        } else {
+          if (file->isClosed())
+            throw std::runtime_error("I/O operation on a closed file.");
+
+          const int numChannels = file->getNumChannels();
+          FrameBatches<T> batches(numChannels, numRowsPerChannel);
+          {
+            py::gil_scoped_release release;
+            computeSTFT(
+                numChannels, settings,
+                [&](float **channels, long long numSamples) {
+                  return file->readInto(channels, numSamples);
+                },
+                [&](const std::complex<float> *spectra, int numFrames) {
+                  onBatch(spectra, numChannels, numFrames,
+                          batches.addBatch(numFrames));
+                });
+          }
+          return {std::move(batches), true};
+        }
+      },
+      input);
+}
+
+/**
+ * Convert a frequency (in Hz) to the mel scale, using the formula from
+ * Malcolm Slaney's Auditory Toolbox (as used by librosa by default): linear
+ * below 1kHz and logarithmic above.
+ */
+inline double hzToMel(double hz) {
+  const double linearStep = 200.0 / 3;
+  const double minLogHz = 1000.0;
+  const double minLogMel = minLogHz / linearStep;
+  const double logStep = std::log(6.4) / 27.0;
+  if (hz < minLogHz)
+    return hz / linearStep;
+  return minLogMel + std::log(hz / minLogHz) / logStep;
+}
+
+inline double melToHz(double mel) {
+  const double linearStep = 200.0 / 3;
+  const double minLogHz = 1000.0;
+  const double minLogMel = minLogHz / linearStep;
+  const double logStep = std::log(6.4) / 27.0;
+  if (mel < minLogMel)
+    return mel * linearStep;
+  return minLogHz * std::exp(logStep * (mel - minLogMel));
+}
+
+class MelSpectrogram {
+public:
+  MelSpectrogram(double sampleRate, int fftSize, std::optional<int> hopLength,
+                 int numMels, double minFrequency,
+                 std::optional<double> maxFrequency, double power,
+                 std::string window, bool center)
+      : sampleRate(sampleRate),
+        settings(fftSize, hopLength, window, center), windowName(window),
+        numMels(numMels), minFrequency(minFrequency),
+        maxFrequency(maxFrequency ? *maxFrequency : sampleRate / 2),
+        power(power) {
+    if (sampleRate <= 0)
+      throw std::domain_error("sample_rate must be greater than 0.");
+    if (numMels < 1)
+      throw std::domain_error("n_mels must be at least 1.");
+    if (minFrequency < 0 || this->maxFrequency <= minFrequency)
+      throw std::domain_error(
+          "f_min must be non-negative and less than f_max.");
+    if (power <= 0)
+      throw std::domain_error("power must be greater than 0.");
+
+    createFilters();
+  }
+
+  py::array_t<float> process(SpectrogramInput input) const {
+    auto [batches, includeChannelAxis] = computeSTFTOf<float>(
+        input, settings, numMels,
+        [&](const std::complex<float> *spectra, int numChannels,
+            int numFrames, float *output) {
+          computeBatch(spectra, numChannels, numFrames, output);
+        });
+    return batches.toArray(includeChannelAxis);
+  }
+
+  double getSampleRate() const { return sampleRate; }
+  int getFFTSize() const { return settings.fftSize; }
+  int getHopLength() const { return settings.hopLength; }
+  int getNumMels() const { return numMels; }
+  double getMinFrequency() const { return minFrequency; }
+  double getMaxFrequency() const { return maxFrequency; }
+  double getPower() const { return power; }
+  const std::string &getWindow() const { return windowName; }
+  bool getCenter() const { return settings.center; }
+
+private:
+  /**
+   * A triangular mel filter, stored sparsely as the weights of the run of
+   * FFT bins that it covers.
+   */
+  struct MelFilter {
+    int firstBin = 0;
+    std::vector<float> weights;
+  };
+
+  void createFilters() {
+    const int numBins = settings.getNumBins();
+
+    // The edges (and centers) of each filter, evenly spaced in mels:
+    std::vector<double> edges(numMels + 2);
+    const double minMel = hzToMel(minFrequency);
+    const double maxMel = hzToMel(maxFrequency);
+    for (int i = 0; i < numMels + 2; i++) {
+      edges[i] = melToHz(minMel + (maxMel - minMel) * i / (numMels + 1));
+    }
+
+    filters.resize(numMels);
+    for (int m = 0; m < numMels; m++) {
+      // Normalize each filter to unit area ("Slaney-style" normalization):
+      double normalization = 2.0 / (edges[m + 2] - edges[m]);
+
+      MelFilter &filter = filters[m];
+      filter.firstBin = numBins;
+      for (int bin = 0; bin < numBins; bin++) {
+        double frequency = bin * sampleRate / settings.fftSize;
+        double lower = (frequency - edges[m]) / (edges[m + 1] - edges[m]);
+        double upper =
+            (edges[m + 2] - frequency) / (edges[m + 2] - edges[m + 1]);
+        double weight = std::max(0.0, std::min(lower, upper));
+        if (weight <= 0)
+          continue;
+
+        if (filter.weights.empty())
+          filter.firstBin = bin;
+        filter.weights.resize(bin - filter.firstBin + 1, 0.0f);
+        filter.weights.back() = (float)(weight * normalization);
+      }
+    }
+  }
+
+  /**
+   * Convert a batch of spectra (laid out as [channel][frame][bin]) into mel
+   * bands (laid out as [channel][band][frame]).
+   */
+  void computeBatch(const std::complex<float> *spectra, int numChannels,
+                    int numFrames, float *output) const {
+    const int numBins = settings.getNumBins();
+    std::vector<float> magnitudes(numBins);
+
+    for (int c = 0; c < numChannels; c++) {
+      for (int f = 0; f < numFrames; f++) {
+        const std::complex<float> *spectrum =
+            spectra + ((size_t)c * SPECTROGRAM_FRAMES_PER_BATCH + f) * numBins;
+        for (int bin = 0; bin < numBins; bin++) {
+          magnitudes[bin] = std::norm(spectrum[bin]);
+        }
+
+        if (power == 1.0) {
+          for (float &magnitude : magnitudes)
+            magnitude = std::sqrt(magnitude);
+        } else if (power != 2.0) {
+          for (float &magnitude : magnitudes)
+            magnitude = (float)std::pow(magnitude, power / 2.0);
+        }
+
+        float *channelOutput = output + (size_t)c * numMels * numFrames;
+        for (int m = 0; m < numMels; m++) {
+          const MelFilter &filter = filters[m];
+          const float *bins = magnitudes.data() + filter.firstBin;
+          float sum = 0;
+          for (size_t i = 0; i < filter.weights.size(); i++) {
+            sum += filter.weights[i] * bins[i];
+          }
+          channelOutput[(size_t)m * numFrames + f] = sum;
+        }
+      }
+    }
+  }
+
+  double sampleRate;
+  STFTSettings settings;
+  std::string windowName;
+  int numMels;
+  double minFrequency;
+  double maxFrequency;
+  double power;
+  std::vector<MelFilter> filters;
+};
+
+/**
+ * Compute the complex short-time Fourier transform of an array or the
+ * remainder of an audio file, returned with shape (bins, frames) for 1D input
+ * or (channels, bins, frames) otherwise.
+ */
+inline py::array_t<std::complex<float>> stft(SpectrogramInput input,
+                                             const STFTSettings &settings) {
+  const int numBins = settings.getNumBins();
+  auto [batches, includeChannelAxis] = computeSTFTOf<std::complex<float>>(
+      input, settings, numBins,
+      [&](const std::complex<float> *spectra, int numChannels, int numFrames,
+          std::complex<float> *output) {
+        for (int c = 0; c < numChannels; c++) {
+          const std::complex<float> *channelSpectra =
+              spectra + (size_t)c * SPECTROGRAM_FRAMES_PER_BATCH * numBins;
+          std::complex<float> *channelOutput =
+              output + (size_t)c * numBins * numFrames;
+          for (int bin = 0; bin < numBins; bin++) {
+            for (int f = 0; f < numFrames; f++) {
+              channelOutput[(size_t)bin * numFrames + f] =
+                  channelSpectra[(size_t)f * numBins + bin];
+            }
+          }
+        }
+      });
+  return batches.toArray(includeChannelAxis);
+}
+
+inline void init_spectrogram(py::module &m) {
+  m.def(
+      "stft",
+      [](SpectrogramInput input, int fftSize, std::optional<int> hopLength,
+         std::string window, bool center) {
+        return stft(input, STFTSettings(fftSize, hopLength, window, center));
+      },
+      py::arg("input"), py::arg("n_fft") = 2048,
+      py::arg("hop_length") = py::none(), py::arg("window") = "hann",
+      py::arg("center") = true,
+      R"(
+Compute the short-time Fourier transform (STFT) of a buffer of audio, or of an
+audio file, returning a complex-valued :class:`numpy.ndarray` of frequency bins
+per frame.
+
+``input`` may be a ``float32`` :class:`numpy.ndarray` of audio, or a
+:class:`pedalboard.io.ReadableAudioFile` (or resampled file) to be read from its
+current position to its end. When passed a file, its audio is decoded and
+transformed a few frames at a time, without ever holding the entire file in
+memory and without holding Python's Global Interpreter Lock.
+
+The returned array has the shape ``(1 + n_fft // 2, num_frames)`` for 1D input,
+or ``(num_channels, 1 + n_fft // 2, num_frames)`` for 2D input or audio files.
+The transform follows the same conventions as ``librosa.stft``:
+
+ - ``n_fft`` is the size of each frame (and must be a power of 2).
+ - ``hop_length`` is the number of samples between the starts of consecutive
+   frames, and defaults to ``n_fft // 4``.
+ - ``window`` is the name of a periodic window function to apply to each
+   frame: one of ``"hann"`` (the default), ``"hamming"``, ``"blackman"``,
+   or ``"boxcar"``.
+ - If ``center`` is ``True`` (the default), the audio is padded with
+   ``n_fft // 2`` zeros on either side, so that frame ``t`` is centered on
+   sample ``t * hop_length``.
+
+FFT plans are created once per size and reused across calls.
+
+*Introduced in v0.9.0.*
+)");
+
+  py::class_<MelSpectrogram, std::shared_ptr<MelSpectrogram>>(m,
+                                                              "MelSpectrogram",
+                                                              R"(
+Computes mel-scaled spectrograms of audio buffers or audio files, with the same
+conventions (and default parameters) as ``librosa.feature.melspectrogram``.
+
+Each frame's magnitude spectrum (raised to ``power``) is weighted by a bank of
+``n_mels`` triangular filters, evenly spaced on the mel scale between ``f_min``
+and ``f_max`` (which defaults to half of ``sample_rate``). As in librosa, the
+mel scale and filter normalization follow Slaney's Auditory Toolbox.
+
+See :func:`stft` for a description of the other parameters.
+
+*Introduced in v0.9.0.*
+)")
+      .def(py::init([](double sampleRate, int fftSize,
+                       std::optional<int> hopLength, int numMels,
+                       double minFrequency, std::optional<double> maxFrequency,
+                       double power, std::string window, bool center) {
+             return std::make_shared<MelSpectrogram>(
+                 sampleRate, fftSize, hopLength, numMels, minFrequency,
+                 maxFrequency, power, window, center);
+           }),
+           py::arg("sample_rate"), py::arg("n_fft") = 2048,
+           py::arg("hop_length") = py::none(), py::arg("n_mels") = 128,
+           py::arg("f_min") = 0.0, py::arg("f_max") = py::none(),
+           py::arg("power") = 2.0, py::arg("window") = "hann",
+           py::arg("center") = true)
+      .def("__call__", &MelSpectrogram::process, py::arg("input"),
+           R"(
+Compute the mel spectrogram of ``input``, which may be a ``float32``
+:class:`numpy.ndarray` of audio or a :class:`pedalboard.io.ReadableAudioFile`
+(or resampled file) to be read from its current position to its end.
+
+Returns a ``float32`` :class:`numpy.ndarray` with the shape
+``(n_mels, num_frames)`` for 1D input, or ``(num_channels, n_mels, num_frames)``
+for 2D input or audio files.
+)")
+      .def("__repr__",
+           [](const MelSpectrogram &spectrogram) {
+             std::ostringstream ss;
+             ss << "<pedalboard.MelSpectrogram";
+             ss << " sample_rate=" << spectrogram.getSampleRate();
+             ss << " n_fft=" << spectrogram.getFFTSize();
+             ss << " hop_length=" << spectrogram.getHopLength();
+             ss << " n_mels=" << spectrogram.getNumMels();
+             ss << " f_min=" << spectrogram.getMinFrequency();
+             ss << " f_max=" << spectrogram.getMaxFrequency();
+             ss << " power=" << spectrogram.getPower();
+             ss << " at " << &spectrogram;
+             ss << ">";
+             return ss.str();
+           })
+      .def_property_readonly("sample_rate", &MelSpectrogram::getSampleRate)
+      .def_property_readonly("n_fft", &MelSpectrogram::getFFTSize)
+      .def_property_readonly("hop_length", &MelSpectrogram::getHopLength)
+      .def_property_readonly("n_mels", &MelSpectrogram::getNumMels)
+      .def_property_readonly("f_min", &MelSpectrogram::getMinFrequency)
+      .def_property_readonly("f_max", &MelSpectrogram::getMaxFrequency)
+      .def_property_readonly("power", &MelSpectrogram::getPower)
+      .def_property_readonly("window", &MelSpectrogram::getWindow)
+      .def_property_readonly("center", &MelSpectrogram::getCenter);
+}
+
+} // namespace Pedalboard
@@ -0,0 +1,431 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <optional>
+
+#include "JuceHeader.h"
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include "BufferUtils.h"
+#include "Plugin.h"
+#include "process.h"
+
+namespace py = pybind11;
+
+namespace Pedalboard {
+
+/**
+ * Runs a potentially-unbounded stream of audio through a list of plugins,
+ * one chunk at a time. Plugins are prepared once (when the stream starts)
+ * rather than on every chunk, and the internal buffers used for processing
+ * are reused between chunks.
+ *
+ * The audio returned across all calls to push() and flush() is
+ * latency-compensated and exactly as long as the audio that was pushed, just
+ * as if the entire stream had been passed to process() at once.
+ */
+class StreamingProcessor {
+public:
+  StreamingProcessor(std::vector<std::shared_ptr<Plugin>> plugins,
+                     double sampleRate, int numChannels,
+                     unsigned int bufferSize, bool reset)
+      : plugins(plugins), sampleRate(sampleRate), numChannels(numChannels),
+        bufferSize(bufferSize), resetOnStart(reset) {
+    if (sampleRate <= 0) {
+      throw std::domain_error("sample_rate must be greater than 0.");
+    }
+    if (numChannels < 1) {
+      throw std::domain_error("num_channels must be at least 1.");
+    }
+    if (bufferSize == 0) {
+      throw std::domain_error("buffer_size must be at least 1.");
+    }
+
+    spec.sampleRate = sampleRate;
+    spec.maximumBlockSize = static_cast<juce::uint32>(bufferSize);
+    spec.numChannels = static_cast<juce::uint32>(numChannels);
+  }
+
+  /**
+   * Process the provided chunk of audio, replacing the contents of `output`
+   * (which may be the input buffer itself) with all of the output that was
+   * produced. Fewer samples than were provided may be returned if the
+   * plugins introduce latency; the remaining samples will be returned by
+   * later calls to push() or to flush().
+   *
+   * Output is copied into a buffer owned by the caller before the lock is
+   * released, as other threads may push into this stream at any time.
+   */
+  template <typename SampleType>
+  void push(const juce::AudioBuffer<SampleType> &input,
+            juce::AudioBuffer<SampleType> &output) {
+    if (input.getNumChannels() != numChannels) {
+      throw std::domain_error(
+          "Expected " + std::to_string(numChannels) +
+          "-channel input, but was provided a buffer with " +
+          std::to_string(input.getNumChannels()) + " channels and " +
+          std::to_string(input.getNumSamples()) + " samples.");
+    }
+
+    std::scoped_lock lock(mutex);
+    auto pluginLocks = lockAllPlugins(plugins);
+    startStreamIfNecessary();
+
+    juce::AudioBuffer<SampleType> &ioBuffer = getBuffer<SampleType>();
+    ioBuffer.setSize(numChannels, input.getNumSamples(),
+                     /* keepExistingContent= */ false,
+                     /* clearExtraSpace= */ false,
+                     /* avoidReallocating= */ true);
+    for (int c = 0; c < numChannels; c++) {
+      ioBuffer.copyFrom(c, 0, input, c, 0, input.getNumSamples());
+    }
+
+    int samplesReturned = process(ioBuffer, spec, plugins, false);
+    samplesInput += input.getNumSamples();
+
+    // Output is right-aligned; copy out just the output:
+    int outputStart = ioBuffer.getNumSamples() - samplesReturned;
+    output.setSize(numChannels, samplesReturned,
+                   /* keepExistingContent= */ false,
+                   /* clearExtraSpace= */ false,
+                   /* avoidReallocating= */ true);
+    for (int c = 0; c < numChannels; c++) {
+      output.copyFrom(c, 0, ioBuffer, c, outputStart, samplesReturned);
+    }
+    samplesOutput += samplesReturned;
+  }
+
+  /**
+   * Feed silence through the plugins until all of the audio that has been
+   * pushed so far has been written into `output`, then reset the plugins so
+   * that a new stream can be started.
+   */
+  template <typename SampleType>
+  void flush(juce::AudioBuffer<SampleType> &output) {
+    std::scoped_lock lock(mutex);
+    auto pluginLocks = lockAllPlugins(plugins);
+
+    int samplesRemaining = (int)(samplesInput - samplesOutput);
+    output.setSize(numChannels, std::max(0, samplesRemaining),
+                   /* keepExistingContent= */ false,
+                   /* clearExtraSpace= */ false,
+                   /* avoidReallocating= */ true);
+    output.clear();
+
+    if (streamStarted && samplesRemaining > 0) {
+      int expectedOutputLatency = getTotalLatencyHint(plugins);
+
+      // If a plugin's latency hint was too small, we may need to feed in more
+      // silence than expected, but don't loop forever if a plugin never
+      // returns its output:
+      int maximumSilenceSamples =
+          samplesRemaining + expectedOutputLatency + (int)bufferSize;
+
+      juce::AudioBuffer<SampleType> silence(numChannels, bufferSize);
+      int samplesFlushed = 0;
+      for (int silenceSamples = 0;
+           samplesFlushed < samplesRemaining &&
+           silenceSamples < maximumSilenceSamples;
+           silenceSamples += bufferSize) {
+        silence.clear();
+        int samplesReturned = process(silence, spec, plugins, false);
+        int samplesToCopy =
+            std::min(samplesReturned, samplesRemaining - samplesFlushed);
+        for (int c = 0; c < numChannels; c++) {
+          output.copyFrom(c, samplesFlushed, silence, c,
+                          silence.getNumSamples() - samplesReturned,
+                          samplesToCopy);
+        }
+        samplesFlushed += samplesToCopy;
+      }
+    }
+
+    reset_unlocked();
+  }
+
+  /**
+   * Discard any buffered audio and start a new stream. The plugins will be
+   * reset (and prepared again) when the next chunk is pushed.
+   */
+  void reset() {
+    std::scoped_lock lock(mutex);
+    reset_unlocked();
+  }
+
+  double getSampleRate() const { return sampleRate; }
+  int getNumChannels() const { return numChannels; }
+  unsigned int getBufferSize() const { return bufferSize; }
+  long long getSamplesInput() const { return samplesInput; }
+  long long getSamplesOutput() const { return samplesOutput; }
+
+  /**
+   * The channel layout of the first chunk pushed into this stream, used to
+   * interpret (and return) subsequent chunks that might be too short to
+   * detect their own layout.
+   */
+  std::optional<ChannelLayout> getLastChannelLayout() const {
+    return lastChannelLayout;
+  }
+  int getLastNumDimensions() const { return lastNumDimensions; }
+  void setLastChannelLayout(ChannelLayout layout, int ndim) {
+    lastChannelLayout = {layout};
+    lastNumDimensions = ndim;
+  }
+
+  /**
+   * The dtype of the audio in this stream; every chunk pushed into a stream
+   * must use the same sample type, as some plugins buffer 32-bit and 64-bit
+   * audio separately.
+   */
+  std::optional<char> getSampleType() const { return sampleType; }
+  void setSampleType(char type) { sampleType = {type}; }
+
+  std::vector<std::shared_ptr<Plugin>> plugins;
+
+private:
+  void startStreamIfNecessary() {
+    if (streamStarted)
+      return;
+
+    // Always reset when starting a stream after the first, so that audio
+    // doesn't leak between streams:
+    if (resetOnStart || hasStreamed) {
+      for (auto &plugin : plugins) {
+        if (plugin)
+          plugin->reset();
+      }
+      rewindAutomation(getAllPluginsSorted(plugins));
+    }
+
+    for (auto &plugin : plugins) {
+      if (plugin)
+        plugin->prepare(spec);
+    }
+
+    streamStarted = true;
+    hasStreamed = true;
+  }
+
+  void reset_unlocked() {
+    streamStarted = false;
+    samplesInput = 0;
+    samplesOutput = 0;
+    lastChannelLayout = {};
+    lastNumDimensions = 2;
+    sampleType = {};
+  }
+
+  template <typename SampleType> juce::AudioBuffer<SampleType> &getBuffer();
+
+  double sampleRate;
+  int numChannels;
+  unsigned int bufferSize;
+  bool resetOnStart;
+
+  juce::dsp::ProcessSpec spec;
+  bool streamStarted = false;
+  bool hasStreamed = false;
+  long long samplesInput = 0;
+  long long samplesOutput = 0;
+  std::optional<ChannelLayout> lastChannelLayout;
+  int lastNumDimensions = 2;
+  std::optional<char> sampleType;
+
+  juce::AudioBuffer<float> floatBuffer;
+  juce::AudioBuffer<double> doubleBuffer;
+
+  std::mutex mutex;
+};
+
+template <>
+inline juce::AudioBuffer<float> &StreamingProcessor::getBuffer<float>() {
+  return floatBuffer;
+}
+
+template <>
+inline juce::AudioBuffer<double> &StreamingProcessor::getBuffer<double>() {
+  return doubleBuffer;
+}
+
+template <typename SampleType>
+py::array pushPyArray(StreamingProcessor &processor,
+                      const py::array_t<SampleType, py::array::c_style> input) {
+  std::optional<ChannelLayout> layout = processor.getLastChannelLayout();
+  if (!layout) {
+    // Chunks may be shorter than the number of channels, so use the expected
+    // channel count to figure out the layout where possible:
+    py::buffer_info inputInfo = input.request();
+    int numChannels = processor.getNumChannels();
+    if (inputInfo.ndim == 2 && inputInfo.shape[0] == numChannels &&
+        inputInfo.shape[1] != numChannels) {
+      layout = ChannelLayout::NotInterleaved;
+    } else if (inputInfo.ndim == 2 && inputInfo.shape[1] == numChannels &&
+               inputInfo.shape[0] != numChannels) {
+      layout = ChannelLayout::Interleaved;
+    } else {
+      layout = detectChannelLayout(input);
+    }
+    processor.setLastChannelLayout(*layout, inputInfo.ndim);
+  }
+  const juce::AudioBuffer<SampleType> inputBuffer =
+      convertPyArrayIntoJuceBuffer(input, *layout);
+
+  juce::AudioBuffer<SampleType> output;
+  {
+    py::gil_scoped_release release;
+    processor.push(inputBuffer, output);
+  }
+  return copyJuceBufferIntoPyArray(output, *layout, 0, input.request().ndim);
+}
+
+template <typename SampleType>
+py::array flushPyArray(StreamingProcessor &processor, ChannelLayout layout,
+                       int ndim) {
+  juce::AudioBuffer<SampleType> output;
+  {
+    py::gil_scoped_release release;
+    processor.flush(output);
+  }
+  return copyJuceBufferIntoPyArray(output, layout, 0, ndim);
+}
+
+inline void init_streaming_processor(py::module &m) {
+  py::class_<StreamingProcessor, std::shared_ptr<StreamingProcessor>>(
+      m, "StreamingProcessor",
+      R"(
+Processes a potentially-unbounded stream of audio through one or more plugins,
+one chunk at a time, using a constant amount of memory.
+
+Unlike calling :py:meth:`Plugin.process` repeatedly with ``reset=False``, a
+:class:`StreamingProcessor` prepares its plugins only once per stream and
+reuses its internal buffers between chunks. The audio returned across all
+calls to :py:meth:`push` and :py:meth:`flush` is latency-compensated and
+exactly as long as the audio that was pushed, just as if the entire stream had
+been passed to :py:meth:`Plugin.process` at once.
+
+Create one with :py:meth:`Plugin.stream`, or by passing a list of plugins::
+
+   with AudioFile("podcast.mp3") as f, AudioFile("out.wav", "w", f.samplerate, f.num_channels) as o:
+       stream = board.stream(f.samplerate, f.num_channels)
+       while f.tell() < f.frames:
+           o.write(stream.push(f.read(f.samplerate)))
+       o.write(stream.flush())
+
+.. note::
+    The plugins used by a :class:`StreamingProcessor` should not be used to
+    process other audio until the stream has been flushed, as doing so would
+    change their internal state.
+
+*Introduced in v0.9.0.*
+)")
+      .def(py::init([](std::vector<std::shared_ptr<Plugin>> plugins,
+                       double sampleRate, int numChannels,
+                       unsigned int bufferSize, bool reset) {
+             return std::make_shared<StreamingProcessor>(
+                 plugins, sampleRate, numChannels, bufferSize, reset);
+           }),
+           py::arg("plugins"), py::arg("sample_rate"), py::arg("num_channels"),
+           py::arg("buffer_size") = DEFAULT_BUFFER_SIZE,
+           py::arg("reset") = true,
+           "Create a new StreamingProcessor that will run audio through the "
+           "provided plugins, in order. If ``reset`` is ``True``, the "
+           "plugins will be reset before the first chunk is processed.")
+      .def("__repr__",
+           [](const StreamingProcessor &processor) {
+             std::ostringstream ss;
+             ss << "<pedalboard.StreamingProcessor";
+             ss << " sample_rate=" << processor.getSampleRate();
+             ss << " num_channels=" << processor.getNumChannels();
+             ss << " buffer_size=" << processor.getBufferSize();
+             ss << " plugins=" << processor.plugins.size();
+             ss << " at " << &processor;
+             ss << ">";
+             return ss.str();
+           })
+      .def(
+          "push",
+          [](StreamingProcessor &processor, py::array input) -> py::array {
+            throwIfUnsupportedSampleType(input);
+            char type = input.dtype().char_();
+            if (processor.getSampleType() &&
+                *processor.getSampleType() != type) {
+              throw py::type_error(
+                  "All chunks passed to push() must have the same dtype; "
+                  "call flush() or reset() before changing dtypes.");
+            }
+            processor.setSampleType(type);
+
+            if (type == 'd') {
+              return pushPyArray<double>(
+                  processor,
+                  py::array_t<double, py::array::c_style>::ensure(input));
+            }
+            return pushPyArray<float>(
+                processor,
+                py::array_t<float, py::array::c_style>::ensure(input));
+          },
+          py::arg("chunk"),
+          "Process the provided chunk of 32-bit or 64-bit floating point "
+          "audio, returning all of the output that is available so far in "
+          "the same format. Fewer samples than were provided may be returned "
+          "if the plugins introduce latency; the remaining audio will be "
+          "returned by later calls to :py:meth:`push` or :py:meth:`flush`.")
+      .def(
+          "flush",
+          [](StreamingProcessor &processor) -> py::array {
+            ChannelLayout layout = processor.getLastChannelLayout().value_or(
+                ChannelLayout::NotInterleaved);
+            int ndim = processor.getLastNumDimensions();
+            if (processor.getSampleType().value_or('f') == 'd') {
+              return flushPyArray<double>(processor, layout, ndim);
+            }
+            return flushPyArray<float>(processor, layout, ndim);
+          },
+          "Return all of the audio that remains buffered in the plugins, "
+          "such that the total amount of audio returned is the same length "
+          "as the audio that was pushed. After flushing, the next call to "
+          ":py:meth:`push` will start a new stream.")
+      .def("reset", &StreamingProcessor::reset,
+           "Discard any buffered audio and start a new stream. The plugins "
+           "will be reset when the next chunk is pushed.")
+      .def_readonly("plugins", &StreamingProcessor::plugins,
+                    "The plugins that audio is processed through.")
+      .def_property_readonly("sample_rate", &StreamingProcessor::getSampleRate,
+                             "The sample rate of the audio in this stream.")
+      .def_property_readonly(
+          "num_channels", &StreamingProcessor::getNumChannels,
+          "The number of channels expected to be passed in every call to "
+          ":py:meth:`push`.")
+      .def_property_readonly(
+          "buffer_size", &StreamingProcessor::getBufferSize,
+          "The maximum number of samples passed to the plugins at once.")
+      .def_property_readonly(
+          "samples_pushed", &StreamingProcessor::getSamplesInput,
+          "The number of samples (per channel) pushed into the current "
+          "stream.")
+      .def_property_readonly(
+          "samples_returned", &StreamingProcessor::getSamplesOutput,
+          "The number of samples (per channel) returned from the current "
+          "stream so far.");
+}
+
+} // namespace Pedalboard
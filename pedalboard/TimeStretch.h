@@ -17,6 +17,7 @@
 
 #include "../vendors/rubberband/rubberband/RubberBandStretcher.h"
 #include "StreamUtils.h"
+#include "process.h"
 
 using namespace RubberBand;
 
@@ -24,23 +25,37 @@ namespace Pedalboard {
 
 static const int MAX_SEMITONES_TO_PITCH_SHIFT = 72;
 
+// The largest number of samples passed to (or retrieved from) Rubber Band at
+// once when time stretching in streaming mode:
+static const size_t TIME_STRETCH_STREAMING_BLOCK_SIZE = 1024;
+
+// When time stretching in parallel, the input is only split into segments of
+// at least this many seconds; shorter segments would give the stretcher too
+// little context to work with, and the joins would be more frequent:
+static const double TIME_STRETCH_MIN_SEGMENT_SECONDS = 10.0;
+
+// The amount of extra input (in seconds) given to each segment on either side
+// of its boundaries, half of which is crossfaded with its neighbour:
+static const double TIME_STRETCH_SEGMENT_OVERLAP_SECONDS = 0.5;
+
+// How far (in seconds) either side of an evenly-spaced split point to look
+// for the quietest place to split the input:
+static const double TIME_STRETCH_SPLIT_SEARCH_SECONDS = 1.0;
+
+// The length of the windows (in samples) whose energy is compared when
+// looking for a split point:
+static const int TIME_STRETCH_SPLIT_WINDOW_SIZE = 1024;
+
 /*
- * A wrapper around Rubber Band that allows calling it independently of a plugin
- * context, to allow for both pitch shifting and time stretching on fixed-size
- * chunks of audio.
- *
- * The `Plugin` base class requires that one sample of audio output is always
- * provided for every sample input, but this assumption does not hold true
+ * Convert the arguments of time_stretch into Rubber Band options, to be
+ * combined with either OptionProcessOffline or OptionProcessRealTime.
  */
-static juce::AudioBuffer<float>
-timeStretch(const juce::AudioBuffer<float> input, double sampleRate,
-            double stretchFactor, double pitchShiftInSemitones,
-            bool highQuality, std::string transientMode,
-            std::string transientDetector, bool retainPhaseContinuity,
-            std::optional<bool> useLongFFTWindow, bool useTimeDomainSmoothing,
-            bool preserveFormants) {
+static RubberBandStretcher::Options
+getTimeStretchOptions(bool highQuality, std::string transientMode,
+                      std::string transientDetector, bool retainPhaseContinuity,
+                      std::optional<bool> useLongFFTWindow,
+                      bool useTimeDomainSmoothing, bool preserveFormants) {
   RubberBandStretcher::Options options =
-      RubberBandStretcher::OptionProcessOffline |
       RubberBandStretcher::OptionThreadingNever |
       RubberBandStretcher::OptionChannelsTogether |
       RubberBandStretcher::OptionPitchHighQuality;
@@ -98,9 +113,25 @@ timeStretch(const juce::AudioBuffer<float> input, double sampleRate,
     options |= RubberBandStretcher::OptionFormantPreserved;
   }
 
+  return options;
+}
+
+/*
+ * A wrapper around Rubber Band that allows calling it independently of a plugin
+ * context, to allow for both pitch shifting and time stretching on fixed-size
+ * chunks of audio.
+ *
+ * The `Plugin` base class requires that one sample of audio output is always
+ * provided for every sample input, but this assumption does not hold true
+ */
+static juce::AudioBuffer<float>
+timeStretchOffline(const juce::AudioBuffer<float> &input, double sampleRate,
+                   double stretchFactor, double pitchShiftInSemitones,
+                   RubberBandStretcher::Options options) {
   SuppressOutput suppress_cerr(std::cerr);
   RubberBandStretcher rubberBandStretcher(
-      sampleRate, input.getNumChannels(), options, 1.0 / stretchFactor,
+      sampleRate, input.getNumChannels(),
+      options | RubberBandStretcher::OptionProcessOffline, 1.0 / stretchFactor,
       pow(2.0, (pitchShiftInSemitones / 12.0)));
   rubberBandStretcher.setMaxProcessSize(input.getNumSamples());
   rubberBandStretcher.setExpectedInputDuration(input.getNumSamples());
@@ -161,6 +192,318 @@ timeStretch(const juce::AudioBuffer<float> input, double sampleRate,
   return output;
 }
 
+/*
+ * Time stretch with Rubber Band's real-time engine, which (unlike the offline
+ * engine) doesn't need to study the entire input first. Input is passed in
+ * (and output retrieved) in chunks of at most
+ * TIME_STRETCH_STREAMING_BLOCK_SIZE samples, directly into an output buffer
+ * allocated up front, so the stretcher's memory use doesn't depend on the
+ * length of the input.
+ */
+static juce::AudioBuffer<float>
+timeStretchStreaming(const juce::AudioBuffer<float> &input, double sampleRate,
+                     double stretchFactor, double pitchShiftInSemitones,
+                     RubberBandStretcher::Options options) {
+  SuppressOutput suppress_cerr(std::cerr);
+  RubberBandStretcher rubberBandStretcher(
+      sampleRate, input.getNumChannels(),
+      options | RubberBandStretcher::OptionProcessRealTime, 1.0 / stretchFactor,
+      pow(2.0, (pitchShiftInSemitones / 12.0)));
+  rubberBandStretcher.setMaxProcessSize(TIME_STRETCH_STREAMING_BLOCK_SIZE);
+
+  const int numChannels = input.getNumChannels();
+  const size_t numInputSamples = input.getNumSamples();
+
+  // Return exactly as many samples as the offline engine would:
+  size_t numOutputSamples = (((double)numInputSamples) / stretchFactor);
+  juce::AudioBuffer<float> output(numChannels, numOutputSamples);
+  output.clear();
+
+  // Silence to pad the start of the input with, and somewhere to put the
+  // stretcher's start delay, which we don't need:
+  juce::AudioBuffer<float> silence(numChannels,
+                                   TIME_STRETCH_STREAMING_BLOCK_SIZE);
+  silence.clear();
+  juce::AudioBuffer<float> discarded(numChannels,
+                                     TIME_STRETCH_STREAMING_BLOCK_SIZE);
+
+  const float **inputChannelPointers =
+      (const float **)alloca(sizeof(float *) * numChannels);
+  float **outputChannelPointers =
+      (float **)alloca(sizeof(float *) * numChannels);
+
+  // Padding the start of the input with silence, and then discarding the
+  // start delay from the output, aligns the output with the input:
+  size_t paddingRemaining = rubberBandStretcher.getPreferredStartPad();
+  size_t delayRemaining = rubberBandStretcher.getStartDelay();
+  size_t inputPosition = 0;
+  size_t outputPosition = 0;
+
+  while (outputPosition < numOutputSamples) {
+    if (paddingRemaining > 0) {
+      size_t chunkSize =
+          std::min(paddingRemaining, TIME_STRETCH_STREAMING_BLOCK_SIZE);
+      for (int c = 0; c < numChannels; c++) {
+        inputChannelPointers[c] = silence.getReadPointer(c);
+      }
+      rubberBandStretcher.process(inputChannelPointers, chunkSize,
+                                  numInputSamples == 0 &&
+                                      chunkSize == paddingRemaining);
+      paddingRemaining -= chunkSize;
+    } else if (inputPosition < numInputSamples) {
+      // Only pass in as much as the stretcher needs to produce more output,
+      // so that its internal buffers never grow:
+      size_t samplesRequired = rubberBandStretcher.getSamplesRequired();
+      if (samplesRequired == 0)
+        samplesRequired = TIME_STRETCH_STREAMING_BLOCK_SIZE;
+      size_t chunkSize =
+          std::min({samplesRequired, TIME_STRETCH_STREAMING_BLOCK_SIZE,
+                    numInputSamples - inputPosition});
+      for (int c = 0; c < numChannels; c++) {
+        inputChannelPointers[c] = input.getReadPointer(c, inputPosition);
+      }
+      inputPosition += chunkSize;
+      rubberBandStretcher.process(inputChannelPointers, chunkSize,
+                                  inputPosition == numInputSamples);
+    }
+
+    int available = rubberBandStretcher.available();
+    if (available < 0) {
+      // The stretcher has finished; any remaining output stays silent.
+      break;
+    }
+    if (available == 0) {
+      if (paddingRemaining == 0 && inputPosition == numInputSamples) {
+        // All input has been passed in, but none is available yet; this
+        // shouldn't happen, but avoid spinning forever if it does.
+        break;
+      }
+      continue;
+    }
+
+    while (available > 0 && delayRemaining > 0) {
+      size_t discard = std::min({(size_t)available, delayRemaining,
+                                 TIME_STRETCH_STREAMING_BLOCK_SIZE});
+      for (int c = 0; c < numChannels; c++) {
+        outputChannelPointers[c] = discarded.getWritePointer(c);
+      }
+      size_t retrieved =
+          rubberBandStretcher.retrieve(outputChannelPointers, discard);
+      delayRemaining -= retrieved;
+      available -= retrieved;
+    }
+
+    if (available > 0) {
+      size_t chunkSize =
+          std::min((size_t)available, numOutputSamples - outputPosition);
+      for (int c = 0; c < numChannels; c++) {
+        outputChannelPointers[c] = output.getWritePointer(c, outputPosition);
+      }
+      outputPosition +=
+          rubberBandStretcher.retrieve(outputChannelPointers, chunkSize);
+    }
+  }
+
+  return output;
+}
+
+/*
+ * Find the quietest window within TIME_STRETCH_SPLIT_SEARCH_SECONDS of
+ * `target`, and return the index of its centre. Splitting in a quiet place
+ * keeps transients (which the stretcher treats specially, and which would be
+ * smeared by a crossfade) away from the joins between segments.
+ */
+static int findTimeStretchSplitPoint(const juce::AudioBuffer<float> &input,
+                                     double sampleRate, int target, int lowest,
+                                     int highest) {
+  const int searchRadius =
+      (int)(TIME_STRETCH_SPLIT_SEARCH_SECONDS * sampleRate);
+  const int hopSize = TIME_STRETCH_SPLIT_WINDOW_SIZE / 4;
+  const int start = std::max(lowest, target - searchRadius);
+  const int end = std::min(highest, target + searchRadius) -
+                  TIME_STRETCH_SPLIT_WINDOW_SIZE;
+
+  int bestSplitPoint = target;
+  double lowestEnergy = std::numeric_limits<double>::max();
+  for (int i = start; i <= end; i += hopSize) {
+    double energy = 0;
+    for (int c = 0; c < input.getNumChannels(); c++) {
+      const float *channel = input.getReadPointer(c, i);
+      for (int j = 0; j < TIME_STRETCH_SPLIT_WINDOW_SIZE; j++) {
+        energy += channel[j] * channel[j];
+      }
+    }
+
+    // Prefer split points closer to the target if energies are equal, to keep
+    // segments (and therefore the work given to each thread) evenly sized:
+    if (energy < lowestEnergy ||
+        (energy == lowestEnergy &&
+         std::abs(i + TIME_STRETCH_SPLIT_WINDOW_SIZE / 2 - target) <
+             std::abs(bestSplitPoint - target))) {
+      lowestEnergy = energy;
+      bestSplitPoint = i + TIME_STRETCH_SPLIT_WINDOW_SIZE / 2;
+    }
+  }
+  return bestSplitPoint;
+}
+
+/*
+ * Time stretch in parallel, by splitting the input into overlapping segments
+ * (and, if `independentChannels` is set, into individual channels), each of
+ * which is stretched on its own thread by `stretchSegment`. Adjacent segments
+ * are crossfaded together in the output, over half of their overlap.
+ *
+ * Each segment is stretched without any knowledge of its neighbours, so this
+ * may sound very slightly different around the joins than stretching the
+ * entire input at once.
+ */
+template <typename StretchSegment>
+static juce::AudioBuffer<float>
+timeStretchInParallel(const juce::AudioBuffer<float> &input, double sampleRate,
+                      double stretchFactor, bool independentChannels,
+                      unsigned int numWorkers,
+                      StretchSegment &&stretchSegment) {
+  const int numChannels = input.getNumChannels();
+  const int numInputSamples = input.getNumSamples();
+  const int numChannelGroups = independentChannels ? numChannels : 1;
+  const int channelsPerGroup = independentChannels ? 1 : numChannels;
+
+  // Split the input into segments only if there aren't already enough
+  // channels to keep every worker busy:
+  const int minSegmentSamples =
+      (int)(TIME_STRETCH_MIN_SEGMENT_SECONDS * sampleRate);
+  const int numSegments = std::max(
+      1, std::min((int)((numWorkers + numChannelGroups - 1) / numChannelGroups),
+                  minSegmentSamples > 0 ? numInputSamples / minSegmentSamples
+                                        : 1));
+
+  // Segment i covers [splitPoints[i], splitPoints[i + 1]) of the input:
+  std::vector<int> splitPoints = {0};
+  for (int i = 1; i < numSegments; i++) {
+    int target = (int)(((long long)numInputSamples * i) / numSegments);
+    splitPoints.push_back(findTimeStretchSplitPoint(
+        input, sampleRate, target,
+        splitPoints.back() + minSegmentSamples / 2,
+        numInputSamples - minSegmentSamples / 2));
+  }
+  splitPoints.push_back(numInputSamples);
+
+  const int overlap = (int)(TIME_STRETCH_SEGMENT_OVERLAP_SECONDS * sampleRate);
+  auto getSegmentStart = [&](int segment) {
+    return std::max(0, splitPoints[segment] - overlap);
+  };
+  auto getSegmentEnd = [&](int segment) {
+    return std::min(numInputSamples, splitPoints[segment + 1] + overlap);
+  };
+
+  const size_t numItems = (size_t)numChannelGroups * numSegments;
+  std::vector<juce::AudioBuffer<float>> stretchedItems(numItems);
+  runOnWorkers(numItems, std::min((size_t)numWorkers, numItems),
+               [&](size_t itemIndex, size_t) {
+                 int group = itemIndex / numSegments;
+                 int segment = itemIndex % numSegments;
+                 int start = getSegmentStart(segment);
+                 int end = getSegmentEnd(segment);
+
+                 // Refer to the input's memory directly, without copying:
+                 juce::AudioBuffer<float> segmentInput(
+                     (float *const *)input.getArrayOfReadPointers() +
+                         group * channelsPerGroup,
+                     channelsPerGroup, start, end - start);
+                 stretchedItems[itemIndex] = stretchSegment(segmentInput);
+               });
+
+  const int numOutputSamples = (int)(((double)numInputSamples) / stretchFactor);
+  juce::AudioBuffer<float> output(numChannels, numOutputSamples);
+  output.clear();
+
+  // Crossfade over half of the overlap (in output samples), centred on the
+  // join, to stay clear of the edges of each segment's output:
+  const int crossfadeRadius =
+      std::max(0, (int)(overlap / stretchFactor / 4.0));
+
+  for (int segment = 0; segment < numSegments; segment++) {
+    const int outputOffset =
+        (int)std::llround(getSegmentStart(segment) / stretchFactor);
+    const int fadeInCentre =
+        (int)std::llround(splitPoints[segment] / stretchFactor);
+    const int fadeOutCentre =
+        (int)std::llround(splitPoints[segment + 1] / stretchFactor);
+    const int firstSample =
+        segment == 0 ? 0 : std::max(0, fadeInCentre - crossfadeRadius);
+    const int lastSample = segment == numSegments - 1
+                               ? numOutputSamples
+                               : std::min(numOutputSamples,
+                                          fadeOutCentre + crossfadeRadius);
+
+    for (int group = 0; group < numChannelGroups; group++) {
+      const auto &stretched = stretchedItems[group * numSegments + segment];
+
+      for (int i = firstSample; i < lastSample; i++) {
+        int segmentIndex = i - outputOffset;
+        if (segmentIndex < 0 || segmentIndex >= stretched.getNumSamples())
+          continue;
+
+        // Raised-cosine fades in and out of each join, which sum to unity:
+        float gain = 1.0f;
+        const float fadeLength = 2.0f * crossfadeRadius;
+        if (segment > 0 && i < fadeInCentre + crossfadeRadius) {
+          float position = (i - (fadeInCentre - crossfadeRadius)) / fadeLength;
+          gain *= 0.5f - 0.5f * std::cos(juce::MathConstants<float>::pi *
+                                         position);
+        }
+        if (segment < numSegments - 1 &&
+            i >= fadeOutCentre - crossfadeRadius) {
+          float position =
+              (i - (fadeOutCentre - crossfadeRadius)) / fadeLength;
+          gain *= 0.5f + 0.5f * std::cos(juce::MathConstants<float>::pi *
+                                         position);
+        }
+
+        for (int c = 0; c < channelsPerGroup; c++) {
+          output.addSample(group * channelsPerGroup + c, i,
+                           gain * stretched.getSample(c, segmentIndex));
+        }
+      }
+    }
+  }
+
+  return output;
+}
+
+static juce::AudioBuffer<float>
+timeStretch(const juce::AudioBuffer<float> &input, double sampleRate,
+            double stretchFactor, double pitchShiftInSemitones,
+            bool highQuality, std::string transientMode,
+            std::string transientDetector, bool retainPhaseContinuity,
+            std::optional<bool> useLongFFTWindow, bool useTimeDomainSmoothing,
+            bool preserveFormants, bool streaming, bool independentChannels,
+            unsigned int numWorkers) {
+  RubberBandStretcher::Options options = getTimeStretchOptions(
+      highQuality, transientMode, transientDetector, retainPhaseContinuity,
+      useLongFFTWindow, useTimeDomainSmoothing, preserveFormants);
+
+  if (independentChannels || numWorkers > 1) {
+    return timeStretchInParallel(
+        input, sampleRate, stretchFactor, independentChannels, numWorkers,
+        [&](const juce::AudioBuffer<float> &segment) {
+          if (streaming) {
+            return timeStretchStreaming(segment, sampleRate, stretchFactor,
+                                        pitchShiftInSemitones, options);
+          }
+          return timeStretchOffline(segment, sampleRate, stretchFactor,
+                                    pitchShiftInSemitones, options);
+        });
+  }
+
+  if (streaming) {
+    return timeStretchStreaming(input, sampleRate, stretchFactor,
+                                pitchShiftInSemitones, options);
+  }
+  return timeStretchOffline(input, sampleRate, stretchFactor,
+                            pitchShiftInSemitones, options);
+}
+
 inline void init_time_stretch(py::module &m) {
   m.def(
       "time_stretch",
@@ -168,7 +511,8 @@ inline void init_time_stretch(py::module &m) {
          double stretchFactor, double pitchShiftInSemitones, bool highQuality,
          std::string transientMode, std::string transientDetector,
          bool retainPhaseContinuity, std::optional<bool> useLongFFTWindow,
-         bool useTimeDomainSmoothing, bool preserveFormants) {
+         bool useTimeDomainSmoothing, bool preserveFormants, bool streaming,
+         bool independentChannels, std::optional<unsigned int> numWorkers) {
         if (stretchFactor == 0)
           throw std::domain_error(
               "stretch_factor must be greater than 0.0x, but was passed " +
@@ -183,6 +527,9 @@ inline void init_time_stretch(py::module &m) {
               " semitones, but was passed " +
               std::to_string(pitchShiftInSemitones) + " semitones.");
 
+        if (numWorkers && *numWorkers == 0)
+          throw std::domain_error("num_workers must be at least 1.");
+
         juce::AudioBuffer<float> inputBuffer =
             convertPyArrayIntoJuceBuffer(input, detectChannelLayout(input));
 
@@ -193,7 +540,11 @@ inline void init_time_stretch(py::module &m) {
                                pitchShiftInSemitones, highQuality,
                                transientMode, transientDetector,
                                retainPhaseContinuity, useLongFFTWindow,
-                               useTimeDomainSmoothing, preserveFormants);
+                               useTimeDomainSmoothing, preserveFormants,
+                               streaming, independentChannels,
+                               numWorkers ? *numWorkers
+                                          : std::max(1u, std::thread::
+                                                             hardware_concurrency()));
         }
 
         return copyJuceBufferIntoPyArray(output, detectChannelLayout(input), 0);
@@ -241,6 +592,24 @@ over the behavior of the time stretcher:
   - ``preserve_formants`` allows shifting the pitch of notes without substantially
     affecting the pitch profile (formants) of a voice or instrument.
 
+  - ``streaming`` uses Rubber Band's real-time engine, which processes the audio
+    in small chunks rather than studying the entire buffer first. This uses less
+    memory for long inputs (and returns the same number of samples), but may
+    sound slightly different. *Introduced in v0.9.0.*
+
+  - ``independent_channels`` stretches each channel separately, rather than
+    keeping the channels in phase with each other. This may sound better for
+    inputs whose channels are unrelated (e.g.: different instruments), and
+    allows each channel to be stretched on its own thread. *Introduced in v0.9.0.*
+
+  - ``num_workers`` controls how many native threads are used (or, if
+    ``None``, one per CPU core). With more than one worker, inputs longer than
+    about 20 seconds are split into overlapping segments (at the quietest
+    point near each split, to avoid splitting transients), which are stretched
+    in parallel and crossfaded back together. The output may differ very
+    slightly around each join from stretching the input all at once, which is
+    what the default of ``num_workers=1`` does. *Introduced in v0.9.0.*
+
 .. warning::
     This is a function, not a :py:class:`Plugin` instance, and cannot be
     used in :py:class:`Pedalboard` objects, as it changes the duration of
@@ -254,6 +623,8 @@ over the behavior of the time stretcher:
       py::arg("retain_phase_continuity") = true,
       py::arg("use_long_fft_window") = py::none(),
       py::arg("use_time_domain_smoothing") = false,
-      py::arg("preserve_formants") = true);
+      py::arg("preserve_formants") = true, py::arg("streaming") = false,
+      py::arg("independent_channels") = false,
+      py::arg("num_workers") = 1);
 }
 }; // namespace Pedalboard
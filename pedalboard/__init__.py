@@ -42,6 +42,8 @@ from ._pedalboard import (  # noqa: F401
     Pedalboard,  # noqa: F401
     load_plugin,  # noqa: F401
 )
+from ._out_of_process import OutOfProcessPlugin  # noqa: F401
+from ._render_cache import RenderCache  # noqa: F401
 
 # noqa: F401
 from .version import __version__  # noqa: F401
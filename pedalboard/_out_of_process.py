@@ -0,0 +1,422 @@
+#! /usr/bin/env python
+#
+# Copyright 2023 Spotify AB
+#
+# Licensed under the GNU Public License, Version 3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import sys
+import threading
+import weakref
+from typing import Any, Dict, Optional, Union
+
+import numpy as np
+
+# Audio is passed through shared memory as 32-bit floats, which is what
+# external plugins process internally anyways:
+_SAMPLE_DTYPE = np.float32
+
+# Shared memory segments are allocated in multiples of this size, to avoid
+# reallocating them every time the size of the audio being processed changes:
+_SHARED_MEMORY_GRANULARITY = 1024 * 1024
+
+# How long to wait for a host process to exit cleanly before terminating it:
+_SHUTDOWN_TIMEOUT_SECONDS = 5.0
+
+
+def _open_shared_memory(name: str):
+    from multiprocessing import resource_tracker, shared_memory
+
+    if sys.version_info >= (3, 13):
+        return shared_memory.SharedMemory(name=name, track=False)  # type: ignore
+
+    # Before Python 3.13, attaching to shared memory registers it with the
+    # resource tracker, which would then try to clean it up a second time
+    # after the parent process unlinks it:
+    segment = shared_memory.SharedMemory(name=name)
+    resource_tracker.unregister(segment._name, "shared_memory")  # type: ignore
+    return segment
+
+
+def _host_main(connection) -> None:
+    """
+    The entry point of a plugin host process, which loads a single plugin and
+    then serves requests from its parent process until told to exit (or until
+    its parent process goes away).
+    """
+    from pedalboard import load_plugin
+
+    plugin: Any = None
+    segment = None
+
+    while True:
+        try:
+            message = connection.recv()
+        except (EOFError, KeyboardInterrupt):
+            break
+
+        command, args = message[0], message[1:]
+        if command == "close":
+            break
+
+        try:
+            result: Any = None
+            if command == "load":
+                path_to_plugin_file, parameter_values, plugin_name, initialization_timeout = args
+                plugin = load_plugin(
+                    path_to_plugin_file,
+                    parameter_values=parameter_values,
+                    plugin_name=plugin_name,
+                    initialization_timeout=initialization_timeout,
+                )
+                result = (plugin.name, plugin.is_effect, plugin.is_instrument)
+            elif command in ("process", "render"):
+                if segment is None or segment.name != args[0]:
+                    if segment is not None:
+                        segment.close()
+                    segment = _open_shared_memory(args[0])
+
+                if command == "process":
+                    shape, sample_rate, buffer_size, reset = args[1:]
+                    output = plugin.process(
+                        np.ndarray(shape, dtype=_SAMPLE_DTYPE, buffer=segment.buf),
+                        sample_rate,
+                        buffer_size,
+                        reset,
+                    )
+                else:
+                    output = plugin.process(*args[1:])
+
+                # The input has already been consumed, so the output can be
+                # written over it:
+                np.copyto(
+                    np.ndarray(output.shape, dtype=_SAMPLE_DTYPE, buffer=segment.buf), output
+                )
+                result = output.shape
+            elif command == "get_parameter_values":
+                result = plugin.get_parameter_values()
+            elif command == "set_parameter_values":
+                plugin.set_parameter_values(args[0])
+            elif command == "load_preset":
+                plugin.load_preset(args[0])
+            elif command == "reset":
+                plugin.reset()
+            else:
+                raise ValueError(f"Unknown plugin host command: {command!r}")
+            connection.send(("ok", result))
+        except Exception as e:
+            connection.send(("error", e))
+
+    if segment is not None:
+        segment.close()
+    connection.close()
+
+
+class _HostProcess:
+    """
+    The parent process's handle on a plugin host process, and on the shared
+    memory used to pass audio to and from it. Kept separate from
+    OutOfProcessPlugin so that it can be cleaned up by a finalizer.
+    """
+
+    def __init__(self, context):
+        self.connection, child_connection = context.Pipe()
+        self.process = context.Process(
+            target=_host_main,
+            args=(child_connection,),
+            name="pedalboard-plugin-host",
+            daemon=True,
+        )
+        self.process.start()
+        # Only the host process should hold this end of the pipe, so that we
+        # get an EOFError (rather than a hang) if the host process dies:
+        child_connection.close()
+        self.segment = None
+
+    def ensure_shared_memory(self, num_bytes: int):
+        from multiprocessing import shared_memory
+
+        if self.segment is None or self.segment.size < num_bytes:
+            num_bytes = max(num_bytes, 1)
+            size = (
+                (num_bytes + _SHARED_MEMORY_GRANULARITY - 1) // _SHARED_MEMORY_GRANULARITY
+            ) * _SHARED_MEMORY_GRANULARITY
+            self.release_shared_memory()
+            self.segment = shared_memory.SharedMemory(create=True, size=size)
+        return self.segment
+
+    def release_shared_memory(self):
+        # The host process keeps its own mapping of this segment (if any) until
+        # it's told to use a different one, so it's safe to unlink it here:
+        if self.segment is not None:
+            self.segment.close()
+            self.segment.unlink()
+            self.segment = None
+
+    def close(self, terminate: bool = False):
+        if self.connection is not None:
+            if not terminate and self.process.is_alive():
+                try:
+                    self.connection.send(("close",))
+                except OSError:
+                    pass
+                self.process.join(_SHUTDOWN_TIMEOUT_SECONDS)
+            if self.process.is_alive():
+                self.process.terminate()
+                self.process.join(_SHUTDOWN_TIMEOUT_SECONDS)
+            if self.process.is_alive():
+                self.process.kill()
+                self.process.join()
+            self.connection.close()
+            self.connection = None
+        self.release_shared_memory()
+
+
+class OutOfProcessPlugin:
+    """
+    A VST3® or Audio Unit plugin that is loaded (with :func:`pedalboard.load_plugin`)
+    and run in a separate host process, so that a plugin that crashes or hangs
+    cannot take the current Python process down with it.
+
+    Audio is passed to and from the host process through shared memory rather
+    than being pickled, and each call to :py:meth:`process` only sends a small
+    message through a pipe to the host process, so the overhead of each call
+    is on the order of tens of microseconds (plus the time taken to copy audio
+    into and out of shared memory). To minimize this overhead, pass audio to
+    :py:meth:`process` in large chunks (using ``reset=False`` for streaming).
+
+    If the host process crashes, the call that was running raises a
+    :class:`RuntimeError`, as do all later calls. If a ``timeout`` (in seconds)
+    is provided and any single call takes longer than ``timeout``, the host
+    process is terminated and a :class:`TimeoutError` is raised.
+
+    Host processes are started with the ``spawn`` method of :mod:`multiprocessing`,
+    so scripts that create an :class:`OutOfProcessPlugin` must guard their entry point
+    with ``if __name__ == "__main__":``.
+
+    .. note::
+        Out-of-process plugins can't be added to a :class:`pedalboard.Pedalboard`,
+        as audio must cross a process boundary every time they're called. Plugins
+        from Pedalboard itself can be run on the output of :py:meth:`process` instead.
+
+    *Introduced in v0.9.0.*
+    """
+
+    def __init__(
+        self,
+        path_to_plugin_file: str,
+        parameter_values: Optional[Dict[str, Union[str, int, float, bool]]] = None,
+        plugin_name: Optional[str] = None,
+        initialization_timeout: float = 10.0,
+        timeout: Optional[float] = None,
+    ):
+        if sys.version_info < (3, 8):
+            raise RuntimeError("OutOfProcessPlugin requires Python 3.8 or newer.")
+
+        self._path_to_plugin_file = path_to_plugin_file
+        self._timeout = timeout
+        # Imported here rather than at the top of the file, as importing multiprocessing
+        # noticeably slows down `import pedalboard` for everyone who never uses this class:
+        import multiprocessing
+
+        self._lock = threading.Lock()
+        self._host: Optional[_HostProcess] = _HostProcess(multiprocessing.get_context("spawn"))
+        self._finalizer = weakref.finalize(self, self._host.close)
+
+        try:
+            self._name, self._is_effect, self._is_instrument = self._request(
+                "load",
+                path_to_plugin_file,
+                parameter_values or {},
+                plugin_name,
+                initialization_timeout,
+                timeout=None if timeout is None else timeout + initialization_timeout,
+            )
+        except BaseException:
+            self.close()
+            raise
+
+    def _get_host(self) -> _HostProcess:
+        if self._host is None:
+            raise RuntimeError(
+                f"The host process for plugin {self._path_to_plugin_file} is no longer running."
+            )
+        return self._host
+
+    def _request(self, *message, timeout: Optional[float] = None) -> Any:
+        host = self._get_host()
+
+        try:
+            host.connection.send(message)
+            if not host.connection.poll(timeout):
+                self._host = None
+                self._finalizer.detach()
+                host.close(terminate=True)
+                raise TimeoutError(
+                    f"Plugin {self._path_to_plugin_file} did not respond within {timeout} seconds,"
+                    " and its host process has been terminated."
+                )
+            status, result = host.connection.recv()
+        except (EOFError, OSError):
+            self._host = None
+            self._finalizer.detach()
+            host.close(terminate=True)
+            raise RuntimeError(
+                f"The host process for plugin {self._path_to_plugin_file} exited unexpectedly"
+                f" (with exit code {host.process.exitcode})."
+            ) from None
+
+        if status == "error":
+            raise result
+        return result
+
+    def process(self, input_array_or_midi_messages, *args, **kwargs) -> np.ndarray:
+        """
+        Pass a buffer of audio (as a 32- or 64-bit NumPy array) *or* a list of
+        MIDI messages to this plugin, returning audio. This method accepts the
+        same arguments as :py:meth:`pedalboard.VST3Plugin.process`.
+        """
+        if isinstance(input_array_or_midi_messages, np.ndarray):
+            return self._process_audio(input_array_or_midi_messages, *args, **kwargs)
+        return self._render_midi_messages(input_array_or_midi_messages, *args, **kwargs)
+
+    __call__ = process
+
+    def _process_audio(
+        self,
+        input_array: np.ndarray,
+        sample_rate: float,
+        buffer_size: int = 8192,
+        reset: bool = True,
+    ) -> np.ndarray:
+        audio = np.ascontiguousarray(input_array, dtype=_SAMPLE_DTYPE)
+        with self._lock:
+            segment = self._get_host().ensure_shared_memory(audio.nbytes)
+            np.copyto(np.ndarray(audio.shape, dtype=_SAMPLE_DTYPE, buffer=segment.buf), audio)
+            shape = self._request(
+                "process",
+                segment.name,
+                audio.shape,
+                float(sample_rate),
+                int(buffer_size),
+                bool(reset),
+                timeout=self._timeout,
+            )
+            output = np.ndarray(shape, dtype=_SAMPLE_DTYPE, buffer=segment.buf).copy()
+
+        if input_array.dtype == np.float64:
+            return output.astype(np.float64)
+        return output
+
+    def _render_midi_messages(
+        self,
+        midi_messages,
+        duration: float,
+        sample_rate: float,
+        num_channels: int = 2,
+        buffer_size: int = 8192,
+        reset: bool = True,
+    ) -> np.ndarray:
+        # Send raw MIDI bytes, to avoid requiring the host process to unpickle
+        # (for example) Mido message objects:
+        messages = [
+            (bytes(message.bytes()), message.time) if hasattr(message, "bytes") else message
+            for message in midi_messages
+        ]
+        num_bytes = num_channels * int(duration * sample_rate) * np.dtype(_SAMPLE_DTYPE).itemsize
+        with self._lock:
+            segment = self._get_host().ensure_shared_memory(num_bytes)
+            shape = self._request(
+                "render",
+                segment.name,
+                messages,
+                float(duration),
+                float(sample_rate),
+                int(num_channels),
+                int(buffer_size),
+                bool(reset),
+                timeout=self._timeout,
+            )
+            return np.ndarray(shape, dtype=_SAMPLE_DTYPE, buffer=segment.buf).copy()
+
+    def reset(self) -> None:
+        """
+        Clear any internal state stored by this plugin (e.g.: reverb tails,
+        delay lines, LFO state, etc).
+        """
+        with self._lock:
+            self._request("reset", timeout=self._timeout)
+
+    def load_preset(self, preset_file_path: str) -> None:
+        """
+        Load a preset file into this plugin. (Only supported for VST3® plugins;
+        see :py:meth:`pedalboard.VST3Plugin.load_preset`.)
+        """
+        with self._lock:
+            self._request("load_preset", preset_file_path, timeout=self._timeout)
+
+    def get_parameter_values(self) -> Dict[str, Union[str, float, bool]]:
+        """
+        Return a dictionary of the current values of this plugin's parameters,
+        keyed by the same names used in :py:attr:`pedalboard.ExternalPlugin.parameters`.
+        """
+        with self._lock:
+            return self._request("get_parameter_values", timeout=self._timeout)
+
+    def set_parameter_values(self, parameter_values: Dict[str, Union[str, int, float, bool]]):
+        """
+        Set the values of some of this plugin's parameters, keyed by the same names
+        used in :py:attr:`pedalboard.ExternalPlugin.parameters`.
+        """
+        with self._lock:
+            self._request("set_parameter_values", dict(parameter_values), timeout=self._timeout)
+
+    def close(self) -> None:
+        """
+        Unload this plugin and stop its host process. This is also done
+        automatically when this object is garbage collected.
+        """
+        with self._lock:
+            host, self._host = self._host, None
+            self._finalizer.detach()
+            if host is not None:
+                host.close()
+
+    def __enter__(self) -> "OutOfProcessPlugin":
+        return self
+
+    def __exit__(self, *_) -> None:
+        self.close()
+
+    @property
+    def name(self) -> str:
+        """The name of this plugin, as reported by the plugin itself."""
+        return self._name
+
+    @property
+    def is_effect(self) -> bool:
+        """True iff this plugin is an audio effect and accepts audio as input."""
+        return self._is_effect
+
+    @property
+    def is_instrument(self) -> bool:
+        """True iff this plugin is not an audio effect and accepts only MIDI input, not audio."""
+        return self._is_instrument
+
+    @property
+    def is_alive(self) -> bool:
+        """True iff this plugin's host process is still running."""
+        host = self._host
+        return host is not None and host.process.is_alive()
+
+    def __repr__(self) -> str:
+        return f'<pedalboard.OutOfProcessPlugin "{self._name}" at {hex(id(self))}>'
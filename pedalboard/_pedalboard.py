@@ -14,6 +14,7 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import atexit
 import platform
 import re
 import weakref
@@ -31,6 +32,8 @@ from typing import (
     no_type_check,
 )
 
+import numpy as np
+
 from pedalboard_native import (  # type: ignore
     ExternalPlugin,
     Plugin,
@@ -58,8 +61,13 @@ class Pedalboard(Chain):
         for which :attr:`is_instrument` is ``True``).
     """
 
-    def __init__(self, plugins: Optional[List[Plugin]] = None):
-        super().__init__(plugins or [])
+    def __init__(
+        self,
+        plugins: Optional[List[Plugin]] = None,
+        fused: bool = False,
+        pipelined: bool = False,
+    ):
+        super().__init__(plugins or [], fused, pipelined)
 
     def __repr__(self) -> str:
         return "<{} with {} plugin{}: {}>".format(
@@ -69,6 +77,18 @@ class Pedalboard(Chain):
             list(self),
         )
 
+    def clone(self) -> "Pedalboard":
+        """
+        Return a new, independent copy of this :class:`Pedalboard` and of every plugin
+        it contains. See :py:meth:`Plugin.clone` for details.
+        """
+        cloned = super().clone()
+        return self.__class__(
+            list(cloned),
+            fused=cloned.fused,
+            pipelined=cloned.pipelined,
+        )  # type: ignore
+
 
 FLOAT_SUFFIXES_TO_IGNORE: Set[str] = set(
     ["x", "%", "*", ",", ".", "hz", "ms", "sec", "seconds", "dB", "dBTP"]
@@ -262,31 +282,24 @@ class AudioProcessorParameter(object):
 
         with self.__get_cpp_parameter() as cpp_parameter:
             for fetch_slow in (False, True):
-                start_of_range: float = 0
-                text_value: Optional[str] = None
-
-                self.ranges = {}
-                for x in range(0, search_steps + 1):
-                    raw_value = x / search_steps
-                    x_text_value = get_text_for_raw_value(cpp_parameter, raw_value, fetch_slow)
-                    if text_value is None:
-                        text_value = x_text_value
-                    elif x_text_value != text_value:
-                        # End current range and start a new one
-                        self.ranges[(start_of_range, raw_value)] = text_value
-                        text_value = x_text_value
-                        start_of_range = raw_value
-                results_look_incorrect = not self.ranges or (
-                    len(self.ranges) == 1 and all(looks_like_float(v) for v in self.ranges.values())
+                # The sweep across all raw values happens (and is cached) in C++;
+                # the last range returned always extends to a raw value of 1:
+                text_ranges = plugin._get_parameter_text_ranges(
+                    parameter_name, search_steps, fetch_slow
+                )
+                closed_ranges = text_ranges[:-1]
+                results_look_incorrect = not closed_ranges or (
+                    len(closed_ranges) == 1
+                    and all(looks_like_float(text) for _, _, text in closed_ranges)
                 )
                 if not results_look_incorrect:
                     break
-            if text_value is None:
+            if not text_ranges:
                 raise NotImplementedError(
                     f"Plugin parameter '{parameter_name}' failed to return a valid string for its"
                     " value."
                 )
-            self.ranges[(start_of_range, 1)] = text_value
+            self.ranges = {(start, end): text for start, end, text in text_ranges}
 
             self.python_name = to_python_parameter_name(cpp_parameter)
 
@@ -603,14 +616,92 @@ class _PythonExternalPluginMixin:
                 ' "plugin_name=..." as a keyword argument instead.)'
             )
         parameters = self.parameters
-        for key, value in parameter_values.items():
+        for key in parameter_values.keys():
             if key not in parameters:
                 raise AttributeError(
                     'Parameter named "{}" not found. Valid options: {}'.format(
-                        key, ", ".join(self._parameter_weakrefs.keys())
+                        key, ", ".join(parameters.keys())
                     )
                 )
-            setattr(self, key, value)
+        self.set_parameter_values(parameter_values)
+
+    def get_parameter_values(self) -> Dict[str, Union[str, float, bool]]:
+        """
+        Return the current values of all of this plugin's parameters, keyed by
+        the names used in :py:attr:`parameters`. This is equivalent to (but
+        much faster than) reading each parameter as an attribute of this plugin,
+        as all of the values are fetched from the plugin in a single call.
+
+        *Introduced in v0.9.0.*
+        """
+        raw_values = self._get_raw_parameter_values()
+        values: Dict[str, Union[str, float, bool]] = {}
+        for python_name, parameter in self._get_parameters().items():
+            raw_value, string_value = raw_values[self.__python_to_cpp_names__[python_name]]
+            if parameter.type is float:
+                values[python_name] = float(strip_common_float_suffixes(string_value))
+            elif parameter.type is bool:
+                values[python_name] = raw_value >= 0.5
+            else:
+                values[python_name] = str(string_value)
+        return values
+
+    def set_parameter_values(self, parameter_values: Dict[str, Union[str, int, float, bool]]):
+        """
+        Set the values of many of this plugin's parameters at once, keyed by
+        the names used in :py:attr:`parameters`. This is equivalent to (but
+        much faster than) setting each parameter as an attribute of this
+        plugin, as all of the values are validated before any are changed and
+        then passed to the plugin in a single call.
+
+        *Introduced in v0.9.0.*
+        """
+        parameters = self._get_parameters()
+        raw_values: Dict[str, float] = {}
+        for python_name, value in parameter_values.items():
+            parameter = parameters.get(python_name)
+            if parameter is None:
+                raise AttributeError(
+                    'Parameter named "{}" not found. Valid options: {}'.format(
+                        python_name, ", ".join(parameters.keys())
+                    )
+                )
+            cpp_name = self.__python_to_cpp_names__[python_name]
+            raw_values[cpp_name] = parameter.get_raw_value_for(value)
+        self._set_raw_parameter_values(raw_values)
+
+    def _automate_parameter(self, parameter_name: str, values):
+        parameters = self._get_parameters()
+        parameter = parameters.get(parameter_name)
+        if parameter is None:
+            raise AttributeError(
+                'Parameter named "{}" not found. Valid options: {}'.format(
+                    parameter_name, ", ".join(parameters.keys())
+                )
+            )
+        cpp_name = self.__python_to_cpp_names__[parameter_name]
+
+        if values is None:
+            raw_values = None
+        elif isinstance(values, np.ndarray):
+            if values.ndim != 1:
+                raise ValueError(
+                    "Automation values provided as an array must be one-dimensional, with one"
+                    " value per sample."
+                )
+            # Each distinct value only needs to be converted (and validated) once:
+            unique_values, inverse = np.unique(values, return_inverse=True)
+            if parameter.type is bool:
+                unique_values = unique_values.astype(bool)
+            raw_values = np.array(
+                [parameter.get_raw_value_for(value) for value in unique_values.tolist()],
+                dtype=np.float32,
+            )[inverse]
+        else:
+            raw_values = [
+                (float(time), parameter.get_raw_value_for(value)) for time, value in values
+            ]
+        self._automate_raw(cpp_name, raw_values)
 
     @property
     def parameters(self) -> Dict[str, AudioProcessorParameter]:
@@ -721,11 +812,18 @@ except ImportError:
     pass
 
 
+@atexit.register
+def _clear_external_plugin_instance_pools():
+    for plugin_class in _AVAILABLE_PLUGIN_CLASSES:
+        plugin_class.clear_instance_pool()  # type: ignore
+
+
 def load_plugin(
     path_to_plugin_file: str,
     parameter_values: Dict[str, Union[str, int, float, bool]] = {},
     plugin_name: Union[str, None] = None,
     initialization_timeout: float = 10.0,
+    pooled: bool = False,
 ) -> ExternalPlugin:
     """
     Load an audio plugin.
@@ -758,6 +856,22 @@ def load_plugin(
 
             *Introduced in v0.7.6.*
 
+        pooled (``bool``):
+            If ``True``, reuse an idle, already-loaded instance of this plugin
+            if one is available, and return this plugin's instance to a
+            process-wide pool (instead of unloading it) when the returned
+            object is garbage collected. Reused instances are reset and have
+            the state they had when they were first loaded restored, which is
+            much faster than loading the plugin from scratch. This is useful
+            when loading the same plugins repeatedly, like in a server.
+
+            Only plugins that clear their audio buffers when reset (see
+            ``ExternalPluginReloadType``) are returned to the pool. Idle
+            instances can be unloaded with
+            :py:meth:`VST3Plugin.clear_instance_pool`.
+
+            *Introduced in v0.9.0.*
+
     Returns:
         an instance of :class:`pedalboard.VST3Plugin` or :class:`pedalboard.AudioUnitPlugin`
 
@@ -781,6 +895,7 @@ def load_plugin(
                 parameter_values=parameter_values,  # type: ignore
                 plugin_name=plugin_name,  # type: ignore
                 initialization_timeout=initialization_timeout,  # type: ignore
+                pooled=pooled,  # type: ignore
             )  # type: ignore
         except ImportError as e:
             exceptions.append(e)
@@ -0,0 +1,305 @@
+#! /usr/bin/env python
+#
+# Copyright 2023 Spotify AB
+#
+# Licensed under the GNU Public License, Version 3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import functools
+import hashlib
+import os
+import tempfile
+import threading
+from collections import OrderedDict
+from typing import Any, List, Optional, Tuple
+
+import numpy as np
+
+from pedalboard_native import (  # type: ignore
+    ExternalPlugin,
+    LoudnessMeter,
+    Plugin,
+    PluginContainer,
+    cpu_features,
+)
+
+from .version import __version__
+
+# Plugins whose output can't be reproduced from their parameters alone (like
+# external plugins, which may have hidden state or be non-deterministic), or
+# which have side effects that would be skipped if their output was cached:
+_UNCACHEABLE_PLUGIN_TYPES: Tuple[type, ...] = (ExternalPlugin, LoudnessMeter)
+
+# Parameters that name a file that the plugin reads from, which are described
+# by the file's size and modification time as well as its path, so that
+# modifying the file invalidates any audio rendered with its old contents:
+_FILENAME_PARAMETER_NAMES = frozenset({"impulse_response_filename"})
+
+# The default number of bytes of rendered audio to keep in memory:
+_DEFAULT_MAX_MEMORY_BYTES = 256 * 1024 * 1024
+
+
+class _Uncacheable(Exception):
+    pass
+
+
+@functools.lru_cache(maxsize=None)
+def _get_parameter_names(plugin_class: type) -> List[str]:
+    """
+    Return the names of every public property defined on the provided plugin
+    class (or its base classes), which together describe its configuration.
+    """
+    names = set()
+    for klass in plugin_class.__mro__:
+        for name, attribute in vars(klass).items():
+            # Static properties (whose type is a subclass of property) don't
+            # describe the configuration of any one instance:
+            if type(attribute) is property and not name.startswith("_"):
+                names.add(name)
+    return sorted(names)
+
+
+def _hash_array(array: np.ndarray) -> str:
+    array = np.ascontiguousarray(array)
+    digest = hashlib.blake2b(digest_size=32)
+    digest.update(f"{array.dtype.str}{array.shape}".encode("utf-8"))
+    digest.update(memoryview(array).cast("B"))
+    return digest.hexdigest()
+
+
+def _describe_value(value: Any) -> Any:
+    if isinstance(value, Plugin):
+        return _describe_plugin(value)
+    if isinstance(value, np.ndarray):
+        return ("ndarray", _hash_array(value))
+    if isinstance(value, (list, tuple)):
+        return [_describe_value(item) for item in value]
+    # Everything else (including enums) is described by its type and repr.
+    # At worst, a repr that includes an address prevents cache hits, but
+    # never causes an incorrect one:
+    return f"{type(value).__qualname__}:{value!r}"
+
+
+def _describe_file(filename: str) -> Any:
+    try:
+        stat = os.stat(filename)
+    except OSError as e:
+        raise _Uncacheable(f"Unable to read {filename}: {e}")
+    return ("file", os.path.abspath(filename), stat.st_size, stat.st_mtime_ns)
+
+
+def _describe_plugin(plugin: Plugin) -> Any:
+    if isinstance(plugin, _UNCACHEABLE_PLUGIN_TYPES):
+        raise _Uncacheable(f"{type(plugin).__name__} plugins are not deterministic.")
+    if plugin.automated_parameters:
+        raise _Uncacheable("Automated plugins cannot be cached.")
+
+    plugin_class = type(plugin)
+    description: List[Any] = [f"{plugin_class.__module__}.{plugin_class.__qualname__}"]
+    for name in _get_parameter_names(plugin_class):
+        try:
+            value = getattr(plugin, name)
+        except Exception as e:
+            raise _Uncacheable(f"Unable to read {name} from {plugin_class.__name__}: {e}")
+        if name in _FILENAME_PARAMETER_NAMES and value is not None:
+            description.append((name, _describe_file(value)))
+        else:
+            description.append((name, _describe_value(value)))
+
+    # Nested plugins are described in order, so that (for example) a Mix and a
+    # Chain containing the same plugins produce different keys:
+    if isinstance(plugin, PluginContainer):
+        description.append([_describe_value(child) for child in plugin])
+    return description
+
+
+class RenderCache:
+    """
+    An opt-in cache of rendered audio, for applications that repeatedly render
+    the same audio through the same plugins (i.e.: to show previews, or to
+    retry failed jobs).
+
+    Each call to :py:meth:`process` computes a key from a hash of the input
+    audio, the sample rate, the buffer size, and the values of every parameter
+    of the provided plugin (including every plugin nested within it, for
+    :class:`Pedalboard`, :class:`Chain` and :class:`Mix` objects). If audio
+    has already been rendered with the same key, it's returned without
+    running any plugins; otherwise, the audio is rendered and stored. Files
+    that plugins read from (like the impulse response of a
+    :class:`Convolution`) are identified by their path, size and modification
+    time, so modifying such a file causes audio to be rendered again.
+
+    Rendered audio is kept in memory (up to ``max_memory_bytes``, evicting the
+    least recently used audio first) and, if a ``directory`` is provided, also
+    saved as a ``.npy`` file in that directory. Audio found on disk is
+    memory-mapped rather than read into memory, so cached renders can be shared
+    between processes (or kept across restarts) without using any extra memory.
+    Files in ``directory`` are never deleted by Pedalboard; the directory may
+    be cleared at any time.
+
+    Plugins whose output doesn't depend on their parameters alone are never
+    cached: boards containing any external plugins (i.e.: :class:`VST3Plugin`
+    or :class:`AudioUnitPlugin`), any :class:`LoudnessMeter` (whose
+    measurements would not be updated if rendering were skipped), or any
+    plugins with automated parameters are rendered normally every time. The
+    number of calls that were served from the cache, rendered and stored, or
+    rendered without being cached are counted in :py:attr:`hits`,
+    :py:attr:`misses` and :py:attr:`uncacheable` respectively.
+
+    .. note::
+        Audio is always rendered with ``reset=True``, and the returned arrays
+        are read-only, as they may be returned again by later calls. Copy the
+        result before modifying it.
+
+    .. note::
+        Cache keys include the version of Pedalboard and the SIMD kernels in
+        use (see :func:`pedalboard.cpu_features`), as either may change the
+        output by a tiny amount.
+
+    *Introduced in v0.9.0.*
+    """
+
+    def __init__(
+        self,
+        directory: Optional[str] = None,
+        max_memory_bytes: int = _DEFAULT_MAX_MEMORY_BYTES,
+    ):
+        if max_memory_bytes < 0:
+            raise ValueError(f"max_memory_bytes must be non-negative, but was {max_memory_bytes}.")
+
+        self.directory = directory
+        self.max_memory_bytes = max_memory_bytes
+        if directory is not None:
+            os.makedirs(directory, exist_ok=True)
+
+        self._lock = threading.Lock()
+        self._memory: "OrderedDict[str, np.ndarray]" = OrderedDict()
+        self._memory_bytes = 0
+
+        self.hits = 0
+        self.misses = 0
+        self.uncacheable = 0
+
+    def get_key(
+        self,
+        plugin: Plugin,
+        input_array: np.ndarray,
+        sample_rate: float,
+        buffer_size: int = 8192,
+    ) -> Optional[str]:
+        """
+        Return the (hexadecimal) key that audio rendered with these arguments
+        would be cached under, or ``None`` if the provided plugin can't be cached.
+        """
+        try:
+            description = _describe_plugin(plugin)
+        except _Uncacheable:
+            return None
+
+        input_array = np.asarray(input_array)
+        key = repr(
+            (
+                __version__,
+                cpu_features()["kernels"],
+                _hash_array(input_array),
+                float(sample_rate),
+                int(buffer_size),
+                description,
+            )
+        )
+        return hashlib.sha256(key.encode("utf-8")).hexdigest()
+
+    def process(
+        self,
+        plugin: Plugin,
+        input_array: np.ndarray,
+        sample_rate: float,
+        buffer_size: int = 8192,
+    ) -> np.ndarray:
+        """
+        Render ``input_array`` through ``plugin`` (with the same arguments as
+        :py:meth:`pedalboard.Plugin.process`), returning cached audio if the
+        same audio has been rendered through identically-configured plugins before.
+        """
+        input_array = np.asarray(input_array)
+        key = self.get_key(plugin, input_array, sample_rate, buffer_size)
+        if key is None:
+            with self._lock:
+                self.uncacheable += 1
+            return plugin(input_array, sample_rate, buffer_size=buffer_size, reset=True)
+
+        cached = self._get(key)
+        if cached is not None:
+            with self._lock:
+                self.hits += 1
+            return cached
+
+        output = plugin(input_array, sample_rate, buffer_size=buffer_size, reset=True)
+        output.setflags(write=False)
+        with self._lock:
+            self.misses += 1
+        self._put(key, output)
+        return output
+
+    def clear(self) -> None:
+        """
+        Remove all cached audio from memory. Files in ``directory`` are not deleted.
+        """
+        with self._lock:
+            self._memory.clear()
+            self._memory_bytes = 0
+
+    def _get_path(self, key: str) -> Optional[str]:
+        if self.directory is None:
+            return None
+        return os.path.join(self.directory, f"{key}.npy")
+
+    def _get(self, key: str) -> Optional[np.ndarray]:
+        with self._lock:
+            if key in self._memory:
+                self._memory.move_to_end(key)
+                return self._memory[key]
+
+        path = self._get_path(key)
+        if path is not None and os.path.exists(path):
+            try:
+                return np.load(path, mmap_mode="r")
+            except (OSError, ValueError):
+                # A corrupt or truncated file is rendered (and written) again:
+                return None
+        return None
+
+    def _put(self, key: str, output: np.ndarray) -> None:
+        path = self._get_path(key)
+        if path is not None:
+            # Write to a temporary file first, so that other processes never
+            # see a partially-written file:
+            handle, temporary_path = tempfile.mkstemp(dir=self.directory, suffix=".npy.tmp")
+            try:
+                with os.fdopen(handle, "wb") as f:
+                    np.save(f, output)
+                os.replace(temporary_path, path)
+            except BaseException:
+                os.unlink(temporary_path)
+                raise
+
+        if output.nbytes > self.max_memory_bytes:
+            return
+
+        with self._lock:
+            if key in self._memory:
+                return
+            self._memory[key] = output
+            self._memory_bytes += output.nbytes
+            while self._memory_bytes > self.max_memory_bytes:
+                _, evicted = self._memory.popitem(last=False)
+                self._memory_bytes -= evicted.nbytes
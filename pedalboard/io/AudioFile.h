@@ -17,9 +17,15 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 #include "../juce_overrides/juce_PatchedFLACAudioFormat.h"
 #include "../juce_overrides/juce_PatchedMP3AudioFormat.h"
 #include "AudioFile.h"
+#include "IOStatistics.h"
 #include "LameMP3AudioFormat.h"
 
 namespace Pedalboard {
@@ -56,6 +62,134 @@ void registerPedalboardAudioFormats(juce::AudioFormatManager &manager,
 #endif
 }
 
-class AudioFile {};
+/**
+ * A process-wide registry of Pedalboard's audio formats. Constructing each
+ * format (and registering it with an AudioFormatManager) isn't free, so this
+ * is done only once per process (for reading and for writing) and the
+ * resulting AudioFormatManager is shared by every file that gets opened.
+ *
+ * The registry also remembers which format was used for each file extension,
+ * so that lookups by extension (and the probing of file-like objects, which
+ * may have no usable extension at all) try the most likely format first.
+ *
+ * All methods are thread-safe. The underlying AudioFormatManager is never
+ * modified after construction.
+ */
+class AudioFormatRegistry {
+public:
+  static AudioFormatRegistry &get(bool forWriting) {
+    // These are intentionally never deleted, as files (and their readers or
+    // writers) may still hold references to these formats during shutdown.
+    // Each is only created when first needed, so that processes that only
+    // read audio never construct (for instance) the LAME MP3 encoder:
+    if (forWriting) {
+      static AudioFormatRegistry *writeRegistry = new AudioFormatRegistry(true);
+      return *writeRegistry;
+    }
+    static AudioFormatRegistry *readRegistry = new AudioFormatRegistry(false);
+    return *readRegistry;
+  }
+
+  std::shared_ptr<juce::AudioFormatManager> getFormatManager() const {
+    return formatManager;
+  }
+
+  /**
+   * Return the format that handles files with the given extension (with or
+   * without a leading dot, in any case), or nullptr if no format does.
+   */
+  juce::AudioFormat *findFormatForFileExtension(const juce::String &extension) {
+    juce::String key = normalizeExtension(extension);
+    if (key.isEmpty())
+      return nullptr;
+
+    {
+      std::scoped_lock lock(cacheMutex);
+      auto cached = formatsByExtension.find(key.toStdString());
+      if (cached != formatsByExtension.end())
+        return cached->second;
+    }
+
+    juce::AudioFormat *format = formatManager->findFormatForFileExtension(key);
+
+    std::scoped_lock lock(cacheMutex);
+    formatsByExtension.emplace(key.toStdString(), format);
+    return format;
+  }
+
+  /**
+   * Return every known format in the order in which they should be tried
+   * when probing a stream that claims to have the provided extension. The
+   * format that last successfully opened a stream with this extension (or
+   * failing that, the format that handles this extension) is tried first,
+   * followed by all others in registration order. Streams without an
+   * extension are always probed in registration order, as some formats (like
+   * MP3) are lenient enough to misidentify other formats' data.
+   */
+  std::vector<juce::AudioFormat *>
+  getFormatsToProbe(const juce::String &extension) {
+    juce::AudioFormat *likelyFormat = nullptr;
+    juce::String key = normalizeExtension(extension);
+
+    if (key.isNotEmpty()) {
+      std::scoped_lock lock(cacheMutex);
+      auto probed = probedFormatsByExtension.find(key.toStdString());
+      if (probed != probedFormatsByExtension.end())
+        likelyFormat = probed->second;
+    }
+
+    if (!likelyFormat && key.isNotEmpty())
+      likelyFormat = findFormatForFileExtension(key);
+
+    std::vector<juce::AudioFormat *> formats;
+    formats.reserve(formatManager->getNumKnownFormats());
+    if (likelyFormat)
+      formats.push_back(likelyFormat);
+    for (int i = 0; i < formatManager->getNumKnownFormats(); i++) {
+      auto *format = formatManager->getKnownFormat(i);
+      if (format != likelyFormat)
+        formats.push_back(format);
+    }
+    return formats;
+  }
+
+  /**
+   * Record that a stream with the provided extension was successfully opened
+   * with the given format, to allow getFormatsToProbe to try it first next
+   * time.
+   */
+  void recordProbedFormat(const juce::String &extension,
+                          juce::AudioFormat *format) {
+    juce::String key = normalizeExtension(extension);
+    if (key.isEmpty())
+      return;
+
+    std::scoped_lock lock(cacheMutex);
+    probedFormatsByExtension[key.toStdString()] = format;
+  }
+
+private:
+  AudioFormatRegistry(bool forWriting)
+      : formatManager(std::make_shared<juce::AudioFormatManager>()) {
+    registerPedalboardAudioFormats(*formatManager, forWriting);
+  }
+
+  static juce::String normalizeExtension(const juce::String &extension) {
+    return extension.trim().trimCharactersAtStart(".").toLowerCase();
+  }
+
+  const std::shared_ptr<juce::AudioFormatManager> formatManager;
+
+  std::mutex cacheMutex;
+  std::unordered_map<std::string, juce::AudioFormat *> formatsByExtension;
+  std::unordered_map<std::string, juce::AudioFormat *> probedFormatsByExtension;
+};
+
+class AudioFile {
+public:
+  // Shared with any Python stream this file reads from or writes to, and
+  // with any ResampledReadableAudioFile wrapping this file:
+  std::shared_ptr<IOStatistics> statistics = std::make_shared<IOStatistics>();
+};
 
 } // namespace Pedalboard
@@ -136,11 +136,37 @@ inline void init_audio_file(
   pyAudioFile
       .def(py::init<>()) // Make this class effectively abstract; we can only
                          // instantiate subclasses via __new__.
+      // This overload must come before the filename overloads, as pybind11
+      // would otherwise convert bytes objects into filenames:
       .def_static(
           "__new__",
-          [](const py::object *, std::string filename, std::string mode) {
+          [](const py::object *, py::buffer buffer, std::string mode) {
             if (mode == "r") {
-              return std::make_shared<ReadableAudioFile>(filename);
+              return std::make_shared<ReadableAudioFile>(
+                  std::make_unique<PythonMemoryInputStream>(buffer));
+            } else if (mode == "w") {
+              throw py::type_error(
+                  "Audio files can only be written to filenames or file-like "
+                  "objects, not to bytes or other buffers. (Try writing to an "
+                  "io.BytesIO object instead.)");
+            } else {
+              throw py::type_error("AudioFile instances can only be opened in "
+                                   "read mode (\"r\") or write mode (\"w\").");
+            }
+          },
+          py::arg("cls"), py::arg("buffer"), py::arg("mode") = "r",
+          "Open an audio file stored in memory for reading. The provided "
+          "object may be any object that supports Python's buffer protocol "
+          "(i.e.: ``bytes``, ``bytearray``, ``memoryview``, or a contiguous "
+          "NumPy array). Audio is decoded directly from the object's memory "
+          "without copying it, and the object cannot be resized while the "
+          "returned file is open.")
+      .def_static(
+          "__new__",
+          [](const py::object *, std::string filename, std::string mode,
+             bool memoryMap) {
+            if (mode == "r") {
+              return std::make_shared<ReadableAudioFile>(filename, memoryMap);
             } else if (mode == "w") {
               throw py::type_error("Opening an audio file for writing requires "
                                    "samplerate and num_channels arguments.");
@@ -150,7 +176,10 @@ inline void init_audio_file(
             }
           },
           py::arg("cls"), py::arg("filename"), py::arg("mode") = "r",
-          "Open an audio file for reading.")
+          py::kw_only(), py::arg("memory_map") = false,
+          "Open an audio file for reading. If ``memory_map`` is ``True`` and "
+          "the file is uncompressed (i.e.: WAV or AIFF), it will be read "
+          "directly from a memory mapping rather than through a stream.")
       .def_static(
           "__new__",
           [](const py::object *, py::object filelike, std::string mode) {
@@ -182,7 +211,8 @@ inline void init_audio_file(
           "__new__",
           [](const py::object *, std::string filename, std::string mode,
              std::optional<double> sampleRate, int numChannels, int bitDepth,
-             std::optional<std::variant<std::string, float>> quality) {
+             std::optional<std::variant<std::string, float>> quality,
+             int numThreads, bool dither) {
             if (mode == "r") {
               throw py::type_error(
                   "Opening an audio file for reading does not require "
@@ -197,7 +227,8 @@ inline void init_audio_file(
               }
 
               return std::make_shared<WriteableAudioFile>(
-                  filename, *sampleRate, numChannels, bitDepth, quality);
+                  filename, *sampleRate, numChannels, bitDepth, quality,
+                  numThreads, dither);
             } else {
               throw py::type_error("AudioFile instances can only be opened in "
                                    "read mode (\"r\") or write mode (\"w\").");
@@ -205,13 +236,14 @@ inline void init_audio_file(
           },
           py::arg("cls"), py::arg("filename"), py::arg("mode") = "w",
           py::arg("samplerate") = py::none(), py::arg("num_channels") = 1,
-          py::arg("bit_depth") = 16, py::arg("quality") = py::none())
+          py::arg("bit_depth") = 16, py::arg("quality") = py::none(),
+          py::kw_only(), py::arg("num_threads") = 1, py::arg("dither") = false)
       .def_static(
           "__new__",
           [](const py::object *, py::object filelike, std::string mode,
              std::optional<double> sampleRate, int numChannels, int bitDepth,
              std::optional<std::variant<std::string, float>> quality,
-             std::optional<std::string> format) {
+             std::optional<std::string> format, int numThreads, bool dither) {
             if (mode == "r") {
               throw py::type_error(
                   "Opening a file-like object for reading does not require "
@@ -245,7 +277,7 @@ inline void init_audio_file(
 
               return std::make_shared<WriteableAudioFile>(
                   format.value_or(""), std::move(stream), *sampleRate,
-                  numChannels, bitDepth, quality);
+                  numChannels, bitDepth, quality, numThreads, dither);
             } else {
               throw py::type_error("AudioFile instances can only be opened in "
                                    "read mode (\"r\") or write mode (\"w\").");
@@ -254,6 +286,41 @@ inline void init_audio_file(
           py::arg("cls"), py::arg("file_like"), py::arg("mode") = "w",
           py::arg("samplerate") = py::none(), py::arg("num_channels") = 1,
           py::arg("bit_depth") = 16, py::arg("quality") = py::none(),
-          py::arg("format") = py::none());
+          py::arg("format") = py::none(), py::kw_only(),
+          py::arg("num_threads") = 1, py::arg("dither") = false)
+      .def(
+          "stats",
+          [](AudioFile &file, bool reset) {
+            return file.statistics->toDict(reset);
+          },
+          py::arg("reset") = false, R"(
+Return the I/O statistics collected for this file while I/O statistics were
+enabled (see :func:`set_io_statistics_enabled`), as a dictionary with the
+following keys:
+
+ - ``bytes_read`` and ``bytes_written``: the number of bytes read from or
+   written to a Python file-like object (not including any files on disk or
+   buffers in memory, which are accessed directly)
+ - ``python_read_calls``, ``python_seek_calls``, ``python_tell_calls`` and
+   ``python_write_calls``: the number of calls made to each method of a
+   Python file-like object
+ - ``python_seconds``: the time spent calling methods of a Python
+   file-like object, including the time taken to acquire the GIL
+ - ``frames_decoded`` and ``decode_seconds``: the number of frames decoded
+   and the time spent decoding them
+ - ``frames_encoded`` and ``encode_seconds``: the number of frames encoded
+   and the time spent encoding (and flushing) them
+ - ``frames_resampled`` and ``resample_seconds``: the number of frames
+   produced by a :class:`ResampledReadableAudioFile`, and the time spent
+   resampling them
+
+Decoding and encoding times include any time spent in calls to Python
+file-like objects. A :class:`ResampledReadableAudioFile` shares its
+statistics with the file it resamples.
+
+If ``reset`` is ``True``, every counter is set to zero after being read.
+
+*Introduced in v0.9.0.*
+)");
 }
 } // namespace Pedalboard
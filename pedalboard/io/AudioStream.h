@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <optional>
 
@@ -26,6 +28,7 @@
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 
+#include "../AudioRingBuffer.h"
 #include "../BufferUtils.h"
 #include "../JuceHeader.h"
 #include "../plugins/Chain.h"
@@ -44,14 +47,26 @@ public:
   AudioStream(std::string inputDeviceName, std::string outputDeviceName,
               std::optional<std::shared_ptr<Chain>> pedalboard,
               std::optional<double> sampleRate, int bufferSize,
-              bool allowFeedback)
+              bool allowFeedback, std::optional<int> engineBlockSize = {},
+              int ringBufferBlocks = 2)
 #ifdef JUCE_MODULE_AVAILABLE_juce_audio_devices
-      : pedalboard(pedalboard ? *pedalboard
+      : engineBlockSize(engineBlockSize ? *engineBlockSize : 0),
+        ringBufferBlocks(ringBufferBlocks),
+        pedalboard(pedalboard ? *pedalboard
                               : std::make_shared<Chain>(
-                                    std::vector<std::shared_ptr<Plugin>>())),
-        livePedalboard(std::vector<std::shared_ptr<Plugin>>())
+                                    std::vector<std::shared_ptr<Plugin>>()))
 #endif
   {
+    if (engineBlockSize && *engineBlockSize < 1) {
+      throw std::domain_error("engine_block_size must be at least 1, but was " +
+                              std::to_string(*engineBlockSize) + ".");
+    }
+    if (ringBufferBlocks < 1) {
+      throw std::domain_error(
+          "ring_buffer_blocks must be at least 1, but was " +
+          std::to_string(ringBufferBlocks) + ".");
+    }
+
 #ifdef JUCE_MODULE_AVAILABLE_juce_audio_devices
     juce::AudioDeviceManager::AudioDeviceSetup setup;
     setup.inputDeviceName = inputDeviceName;
@@ -87,21 +102,29 @@ public:
     close();
   }
 
-  std::shared_ptr<Chain> getPedalboard() { return pedalboard; }
+  std::shared_ptr<Chain> getPedalboard() {
+    return std::atomic_load(&pedalboard);
+  }
 
-  void setPedalboard(std::shared_ptr<Chain> chain) { pedalboard = chain; }
+  void setPedalboard(std::shared_ptr<Chain> chain) {
+    std::atomic_store(&pedalboard, chain);
+  }
 
   void close() { deviceManager.closeAudioDevice(); }
 
   void start() {
     isRunning = true;
+    // Add the callback first, so that the device's sample rate and buffer
+    // size are known before any plugins are prepared:
+    deviceManager.addAudioCallback(this);
     changeObserverThread =
         std::thread(&AudioStream::propagateChangesToAudioThread, this);
-    deviceManager.addAudioCallback(this);
   }
 
   void stop() {
+    // This also calls audioDeviceStopped, which stops the engine thread:
     deviceManager.removeAudioCallback(this);
+    stopEngineThread();
     isRunning = false;
     if (changeObserverThread.joinable()) {
       changeObserverThread.join();
@@ -109,28 +132,27 @@ public:
   }
 
   void propagateChangesToAudioThread() {
+    std::shared_ptr<Chain> lastPedalboard;
+    unsigned long long lastModificationCount = 0;
+
     while (isRunning) {
-      std::this_thread::sleep_for(std::chrono::milliseconds(50));
-
-      // Make sure nobody modifies the Python-side object while we're reading
-      // it (without taking the GIL, which would be expensive)
-      std::unique_lock<std::mutex> lock(pedalboard->mutex, std::try_to_lock);
-      if (lock.owns_lock()) {
-        // We can read livePedalboard's plugins without a lock, as we're the
-        // only writer:
-        if (pedalboard->getAllPlugins() != livePedalboard.getAllPlugins()) {
-          // But if we need to write, then we need to try to get the lock:
-          juce::SpinLock::ScopedTryLockType tryLock(livePedalboardMutex);
-          if (tryLock.isLocked()) {
-            livePedalboard.getPlugins().clear();
-
-            for (auto plugin : pedalboard->getPlugins()) {
-              plugin->prepare(spec);
-              livePedalboard.getPlugins().push_back(plugin);
-            }
-          }
-        }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      freeRetiredSnapshots();
+
+      // Only rebuild the snapshot if a plugin list (anywhere) has changed.
+      // The count is read first, so that a change made while the snapshot is
+      // being built triggers another rebuild:
+      unsigned long long modificationCount =
+          PluginContainer::modificationCount.load();
+      std::shared_ptr<Chain> currentPedalboard = getPedalboard();
+      if (currentPedalboard == lastPedalboard &&
+          modificationCount == lastModificationCount) {
+        continue;
       }
+
+      updateLiveSnapshot(currentPedalboard);
+      lastPedalboard = currentPedalboard;
+      lastModificationCount = modificationCount;
     }
   }
 
@@ -182,48 +204,83 @@ public:
                                      int numInputChannels,
                                      float **outputChannelData,
                                      int numOutputChannels, int numSamples) {
+    if (engineBlockSize > 0) {
+      // Hand the input to the engine thread, and play back whatever it has
+      // finished processing; never wait for it:
+      if (!inputRing.write(inputChannelData, numInputChannels, numSamples)) {
+        overrunCount++;
+      }
+      if (!outputRing.read(outputChannelData, numOutputChannels, numSamples)) {
+        underrunCount++;
+        for (int i = 0; i < numOutputChannels; i++) {
+          std::memset(outputChannelData[i], 0, numSamples * sizeof(float));
+        }
+      }
+      engineWakeUp.signal();
+      return;
+    }
+
     for (int i = 0; i < numOutputChannels; i++) {
       const float *inputChannel = inputChannelData[i % numInputChannels];
       std::memcpy((char *)outputChannelData[i], (char *)inputChannel,
                   numSamples * sizeof(float));
     }
 
-    auto ioBlock = juce::dsp::AudioBlock<float>(
-        outputChannelData, numOutputChannels, 0, numSamples);
-    juce::dsp::ProcessContextReplacing<float> context(ioBlock);
-
-    juce::SpinLock::ScopedTryLockType tryLock(livePedalboardMutex);
-    if (tryLock.isLocked()) {
-      for (auto plugin : livePedalboard.getPlugins()) {
-        std::unique_lock<std::mutex> lock(pedalboard->mutex, std::try_to_lock);
-        // If someone's running audio through this plugin in parallel (offline,
-        // or in a different AudioStream object) then don't corrupt its state by
-        // calling it here too; instead, just skip it:
-        if (lock.owns_lock()) {
-          plugin->process(context);
-        }
-      }
-    }
+    processWithLiveSnapshot(outputChannelData, numOutputChannels, numSamples);
   }
 
   virtual void audioDeviceAboutToStart(juce::AudioIODevice *device) {
+    stopEngineThread();
+
+    std::lock_guard<std::mutex> lock(snapshotWriterMutex);
     spec.sampleRate = deviceManager.getAudioDeviceSetup().sampleRate;
     spec.maximumBlockSize = static_cast<juce::uint32>(
-        deviceManager.getAudioDeviceSetup().bufferSize);
+        engineBlockSize > 0 ? engineBlockSize
+                            : deviceManager.getAudioDeviceSetup().bufferSize);
     spec.numChannels = static_cast<juce::uint32>(
         device->getActiveOutputChannels().countNumberOfSetBits());
 
-    juce::SpinLock::ScopedLockType lock(livePedalboardMutex);
-    for (auto plugin : livePedalboard.getPlugins()) {
-      plugin->prepare(spec);
+    int engineLatency = 0;
+    if (engineBlockSize > 0) {
+      // The output ring starts out holding enough silence to cover one full
+      // engine block (which can't be processed until all of its input has
+      // arrived) plus one device block, plus however many extra engine blocks
+      // of slack were asked for. The total amount of audio in both rings stays
+      // constant from then on (unless an underrun or overrun occurs), so this
+      // is also the latency added by the engine thread:
+      int deviceBlockSize = device->getCurrentBufferSizeSamples();
+      engineLatency = ringBufferBlocks * engineBlockSize + deviceBlockSize;
+      int capacity = engineLatency + engineBlockSize + deviceBlockSize;
+      inputRing.setSize(spec.numChannels, capacity);
+      outputRing.setSize(spec.numChannels, capacity);
+      outputRing.write(nullptr, 0, engineLatency);
+      engineBuffer.setSize(spec.numChannels, engineBlockSize);
+    }
+    roundTripLatency = device->getInputLatencyInSamples() +
+                       device->getOutputLatencyInSamples() + engineLatency;
+
+    if (currentSnapshot) {
+      for (const auto &entry : currentSnapshot->entries) {
+        auto pluginLocks = lockAllPlugins({entry.plugin});
+        entry.plugin->prepare(spec);
+      }
+    }
+
+    if (engineBlockSize > 0) {
+      engineThread = std::make_unique<EngineThread>(*this);
+      engineThread->startThread(ENGINE_THREAD_PRIORITY);
     }
   }
 
   virtual void audioDeviceStopped() {
-    juce::SpinLock::ScopedLockType lock(livePedalboardMutex);
+    stopEngineThread();
 
-    for (auto plugin : livePedalboard.getPlugins()) {
-      plugin->reset();
+    std::lock_guard<std::mutex> lock(snapshotWriterMutex);
+    if (currentSnapshot) {
+      for (const auto &entry : currentSnapshot->entries) {
+        auto pluginLocks = lockAllPlugins({entry.plugin});
+        entry.plugin->reset();
+      }
     }
   }
 
@@ -233,29 +290,258 @@ public:
     return deviceManager.getAudioDeviceSetup();
   }
 
+  std::optional<int> getEngineBlockSize() const {
+    if (engineBlockSize > 0)
+      return engineBlockSize;
+    return {};
+  }
+
+  int getRingBufferBlocks() const { return ringBufferBlocks; }
+  unsigned long long getUnderrunCount() const { return underrunCount; }
+  unsigned long long getOverrunCount() const { return overrunCount; }
+  int getRoundTripLatency() const { return roundTripLatency; }
+
 private:
-  juce::AudioDeviceManager deviceManager;
-  juce::dsp::ProcessSpec spec;
-  bool isRunning = false;
+  // The priority (from 0 to 10) of the thread that runs plugins in engine
+  // mode, which should be as high as the device callback's:
+  static constexpr int ENGINE_THREAD_PRIORITY = 10;
+
+  class EngineThread : public juce::Thread {
+  public:
+    EngineThread(AudioStream &stream)
+        : juce::Thread("AudioStream engine"), stream(stream) {}
+    void run() override { stream.runEngine(*this); }
+
+  private:
+    AudioStream &stream;
+  };
+
+  /**
+   * The body of the engine thread: whenever a full engine block of input is
+   * available (and there's room for its output), process it through the
+   * live snapshot and queue it for playback.
+   */
+  void runEngine(juce::Thread &thread) {
+    const int numChannels = engineBuffer.getNumChannels();
+    while (!thread.threadShouldExit()) {
+      if (inputRing.getNumReady() < engineBlockSize ||
+          outputRing.getFreeSpace() < engineBlockSize) {
+        // Woken by every device callback; the timeout only bounds how long
+        // it takes for this thread to notice it should exit:
+        engineWakeUp.wait(ENGINE_WAKE_UP_TIMEOUT_MS);
+        continue;
+      }
+
+      inputRing.read(engineBuffer.getArrayOfWritePointers(), numChannels,
+                     engineBlockSize);
+      processWithLiveSnapshot(engineBuffer.getArrayOfWritePointers(),
+                              numChannels, engineBlockSize);
+      outputRing.write(engineBuffer.getArrayOfReadPointers(), numChannels,
+                       engineBlockSize);
+    }
+  }
+
+  void stopEngineThread() {
+    if (engineThread) {
+      engineThread->signalThreadShouldExit();
+      engineWakeUp.signal();
+      engineThread->stopThread(ENGINE_STOP_TIMEOUT_MS);
+      engineThread.reset();
+    }
+  }
+
+  /**
+   * Run the current live snapshot's plugins over the provided audio, in
+   * place. Called from the device callback, or from the engine thread in
+   * engine mode (but never both at once).
+   */
+  void processWithLiveSnapshot(float *const *channels, int numChannels,
+                               int numSamples) {
+    auto ioBlock =
+        juce::dsp::AudioBlock<float>(channels, numChannels, 0, numSamples);
+    juce::dsp::ProcessContextReplacing<float> context(ioBlock);
+
+    // Announce that we're about to read the live snapshot, so that it isn't
+    // freed until this call is finished with it (see publishSnapshot):
+    callbacksStarted++;
+    if (const LiveSnapshot *snapshot = liveSnapshot.load()) {
+      for (const auto &entry : snapshot->entries) {
+        // If someone's running audio through this plugin in parallel
+        // (offline, or in a different AudioStream object) then don't corrupt
+        // its state by calling it here too; instead, just skip it:
+        if (tryLockAll(entry.allPlugins)) {
+          RealtimeAuditScope auditScope(*entry.plugin);
+          ProfilingScope profilingScope(*entry.plugin, numSamples);
+          entry.plugin->process(context);
+          unlockAll(entry.allPlugins, entry.allPlugins.size());
+        }
+      }
+    }
+    callbacksFinished++;
+  }
+
+  /**
+   * An immutable copy of the list of plugins to run on the audio thread.
+   * Snapshots are only created and destroyed off of the audio thread.
+   */
+  struct LiveSnapshot {
+    struct Entry {
+      std::shared_ptr<Plugin> plugin;
+
+      // This plugin and every plugin nested within it, sorted by address (as
+      // with lockAllPlugins):
+      std::vector<std::shared_ptr<Plugin>> allPlugins;
+    };
+    std::vector<Entry> entries;
+  };
+
+  static bool tryLockAll(const std::vector<std::shared_ptr<Plugin>> &plugins) {
+    for (size_t i = 0; i < plugins.size(); i++) {
+      if (!plugins[i]->mutex.try_lock()) {
+        unlockAll(plugins, i);
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static void unlockAll(const std::vector<std::shared_ptr<Plugin>> &plugins,
+                        size_t count) {
+    for (size_t i = 0; i < count; i++)
+      plugins[i]->mutex.unlock();
+  }
+
+  /**
+   * Build a new snapshot of the provided pedalboard and publish it to the
+   * audio thread. Only plugins that are new (or whose nested plugins have
+   * changed) are prepared; plugins that were already live are never touched,
+   * so the audio thread can keep running them in the meantime.
+   */
+  void updateLiveSnapshot(std::shared_ptr<Chain> chain) {
+    std::vector<std::shared_ptr<Plugin>> plugins;
+    {
+      std::shared_lock lock(chain->pluginListMutex);
+      plugins = chain->getPlugins();
+    }
+
+    auto snapshot = std::make_unique<LiveSnapshot>();
+    for (auto plugin : plugins) {
+      if (plugin)
+        snapshot->entries.push_back({plugin, getAllPluginsSorted({plugin})});
+    }
+
+    std::lock_guard<std::mutex> lock(snapshotWriterMutex);
+    std::vector<LiveSnapshot::Entry> entries;
+    for (auto &entry : snapshot->entries) {
+      bool wasAlreadyLive = false;
+      if (currentSnapshot) {
+        for (const auto &liveEntry : currentSnapshot->entries) {
+          if (liveEntry.allPlugins == entry.allPlugins) {
+            wasAlreadyLive = true;
+            break;
+          }
+        }
+      }
 
+      if (!wasAlreadyLive) {
+        try {
+          auto pluginLocks = lockAllPlugins({entry.plugin});
+          entry.plugin->prepare(spec);
+        } catch (const std::exception &) {
+          // There's nobody to report this to from this thread, so leave this
+          // plugin out of the stream rather than crashing:
+          continue;
+        }
+      }
+      entries.push_back(std::move(entry));
+    }
+    snapshot->entries = std::move(entries);
+    publishSnapshot(std::move(snapshot));
+  }
+
+  /**
+   * Atomically replace the snapshot used by the audio thread. The previous
+   * snapshot is freed (by freeRetiredSnapshots) only once every callback that
+   * could have loaded it has finished: any callback that starts after the
+   * new snapshot is stored must see the new snapshot, and every callback
+   * that started before then will have finished once callbacksFinished
+   * reaches the current value of callbacksStarted.
+   */
+  void publishSnapshot(std::unique_ptr<LiveSnapshot> snapshot) {
+    liveSnapshot.store(snapshot.get());
+    if (currentSnapshot) {
+      retiredSnapshots.push_back(
+          {callbacksStarted.load(), std::move(currentSnapshot)});
+    }
+    currentSnapshot = std::move(snapshot);
+  }
+
+  void freeRetiredSnapshots() {
+    std::lock_guard<std::mutex> lock(snapshotWriterMutex);
+    unsigned long long finished = callbacksFinished.load();
+    retiredSnapshots.erase(
+        std::remove_if(retiredSnapshots.begin(), retiredSnapshots.end(),
+                       [finished](const auto &retired) {
+                         return retired.first <= finished;
+                       }),
+        retiredSnapshots.end());
+  }
+
+  juce::AudioDeviceManager deviceManager;
+  juce::dsp::ProcessSpec spec = {0};
+  std::atomic<bool> isRunning = false;
+
+  // If non-zero, plugins are run on a separate engine thread in blocks of
+  // exactly this many samples, rather than in the device callback:
+  const int engineBlockSize = 0;
+  const int ringBufferBlocks = 2;
+  static constexpr int ENGINE_WAKE_UP_TIMEOUT_MS = 5;
+  static constexpr int ENGINE_STOP_TIMEOUT_MS = 1000;
+
+  // Audio passed between the device callback (which writes to inputRing and
+  // reads from outputRing) and the engine thread (which does the opposite).
+  // Only resized while the engine thread isn't running.
+  AudioRingBuffer<float> inputRing;
+  AudioRingBuffer<float> outputRing;
+  juce::AudioBuffer<float> engineBuffer;
+  juce::WaitableEvent engineWakeUp;
+  std::unique_ptr<EngineThread> engineThread;
+
+  // The number of device callbacks that couldn't be given any (or all) of
+  // their output because the engine thread had fallen behind (underruns),
+  // or that had to drop their input because the engine thread's input
+  // queue was full (overruns):
+  std::atomic<unsigned long long> underrunCount = 0;
+  std::atomic<unsigned long long> overrunCount = 0;
+
+  // The total latency from input to output, in samples, as reported by the
+  // device plus any latency added by the engine thread:
+  std::atomic<int> roundTripLatency = 0;
+
+  // The Pedalboard object exposed to Python, which may be modified (or
+  // replaced) at any time. Only accessed with std::atomic_load/atomic_store.
   std::shared_ptr<Chain> pedalboard;
 
-  // A simple spin-lock mutex that we can try to acquire from
-  // the audio thread, allowing us to avoid modifying state that's
-  // currently being used for rendering.
-  // The `livePedalboard` object already has a std::mutex on it,
-  // but we want something that's faster and callable from the
-  // dudio thread.
-  juce::SpinLock livePedalboardMutex;
+  // The snapshot currently being used by the audio thread. The audio thread
+  // never takes a lock to read this, and never frees a snapshot.
+  std::atomic<const LiveSnapshot *> liveSnapshot = nullptr;
+
+  // Counts of audio callbacks started and finished, used to tell when a
+  // replaced snapshot can no longer be in use by the audio thread.
+  std::atomic<unsigned long long> callbacksStarted = 0;
+  std::atomic<unsigned long long> callbacksFinished = 0;
 
-  // A "live" pedalboard, called from the audio thread.
-  // This is not exposed to Python, and is only updated from C++.
-  Chain livePedalboard;
+  // Guards everything below (and `spec`), which are never touched by the
+  // audio thread.
+  std::mutex snapshotWriterMutex;
+  std::unique_ptr<LiveSnapshot> currentSnapshot;
+  std::vector<std::pair<unsigned long long, std::unique_ptr<LiveSnapshot>>>
+      retiredSnapshots;
 
   // A background thread, independent of the audio thread, that
   // watches for any changes to the Pedalboard object (which may
-  // happen in Python) and copies those changes over to data
-  // structures used by the audio thread.
+  // happen in Python) and publishes a new snapshot of it to the
+  // audio thread.
   std::thread changeObserverThread;
 #endif
 };
@@ -300,6 +586,17 @@ passing it through a :class:`pedalboard.Pedalboard` to add effects.
     Python code; the only way to interact with the audio stream is through
     the :py:attr:`plugins` attribute.
 
+By default, plugins are run directly in the audio device's callback, in blocks
+of the device's buffer size. If any plugin takes too long, the device runs out
+of audio to play, causing audible dropouts. Passing ``engine_block_size``
+instead runs plugins on a separate high-priority thread, in blocks of exactly
+``engine_block_size`` samples, which exchanges audio with the device through
+lock-free queues. ``ring_buffer_blocks`` engine blocks of audio are buffered
+ahead of the device (at the cost of that much extra latency), which absorbs
+occasional slow blocks; :py:attr:`underrun_count`, :py:attr:`overrun_count`
+and :py:attr:`round_trip_latency` can be used to tune these settings.
+*Engine mode introduced in v0.9.0.*
+
 .. warning::
     The :class:`AudioStream` class implements a context manager interface
     to ensure that audio streams are never left "dangling" (i.e.: running in
@@ -321,15 +618,20 @@ passing it through a :class:`pedalboard.Pedalboard` to add effects.
                            std::string outputDeviceName,
                            std::optional<std::shared_ptr<Chain>> pedalboard,
                            std::optional<double> sampleRate, int bufferSize,
-                           bool allowFeedback) {
+                           bool allowFeedback,
+                           std::optional<int> engineBlockSize,
+                           int ringBufferBlocks) {
                  return std::make_shared<AudioStream>(
                      inputDeviceName, outputDeviceName, pedalboard, sampleRate,
-                     bufferSize, allowFeedback);
+                     bufferSize, allowFeedback, engineBlockSize,
+                     ringBufferBlocks);
                }),
                py::arg("input_device_name"), py::arg("output_device_name"),
                py::arg("plugins") = py::none(),
                py::arg("sample_rate") = py::none(),
-               py::arg("buffer_size") = 512, py::arg("allow_feedback") = false);
+               py::arg("buffer_size") = 512, py::arg("allow_feedback") = false,
+               py::kw_only(), py::arg("engine_block_size") = py::none(),
+               py::arg("ring_buffer_blocks") = 2);
 #ifdef JUCE_MODULE_AVAILABLE_juce_audio_devices
   audioStream
       .def("run", &AudioStream::stream,
@@ -361,6 +663,9 @@ passing it through a :class:`pedalboard.Pedalboard` to add effects.
              ss << " sample_rate="
                 << juce::String(audioDeviceSetup.sampleRate, 2).toStdString();
              ss << " buffer_size=" << audioDeviceSetup.bufferSize;
+             if (auto engineBlockSize = stream.getEngineBlockSize()) {
+               ss << " engine_block_size=" << *engineBlockSize;
+             }
              if (stream.getIsRunning()) {
                ss << " running";
              } else {
@@ -373,7 +678,41 @@ passing it through a :class:`pedalboard.Pedalboard` to add effects.
       .def_property("plugins", &AudioStream::getPedalboard,
                     &AudioStream::setPedalboard,
                     "The Pedalboard object that this AudioStream will use to "
-                    "process audio.");
+                    "process audio.")
+      .def_property_readonly(
+          "engine_block_size", &AudioStream::getEngineBlockSize,
+          "The number of samples that plugins are given at once when running "
+          "on a separate engine thread, or :py:const:`None` if plugins are "
+          "run directly in the audio device's callback.\n\n*Introduced in "
+          "v0.9.0.*")
+      .def_property_readonly(
+          "ring_buffer_blocks", &AudioStream::getRingBufferBlocks,
+          "The number of extra engine blocks of audio buffered between the "
+          "engine thread and the audio device, if :py:attr:`engine_block_size` "
+          "is set.\n\n*Introduced in v0.9.0.*")
+      .def_property_readonly(
+          "underrun_count", &AudioStream::getUnderrunCount,
+          "The number of times that the audio device has needed more audio "
+          "than the engine thread had finished processing, causing a "
+          "dropout. Always 0 unless :py:attr:`engine_block_size` is "
+          "set.\n\n*Introduced in v0.9.0.*")
+      .def_property_readonly(
+          "overrun_count", &AudioStream::getOverrunCount,
+          "The number of times that input audio has been dropped because the "
+          "engine thread had fallen too far behind to accept it. Always 0 "
+          "unless :py:attr:`engine_block_size` is set.\n\n*Introduced in "
+          "v0.9.0.*")
+      .def_property_readonly(
+          "round_trip_latency",
+          [](const AudioStream &stream) {
+            double sampleRate = stream.getAudioDeviceSetup().sampleRate;
+            return sampleRate > 0 ? stream.getRoundTripLatency() / sampleRate
+                                  : 0.0;
+          },
+          "The total time (in seconds) that audio takes to get from the "
+          "input device to the output device while this stream is running, "
+          "as reported by the devices themselves plus any buffering added by "
+          "the engine thread.\n\n*Introduced in v0.9.0.*");
 #endif
   audioStream
       .def_property_readonly_static(
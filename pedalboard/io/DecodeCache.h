@@ -0,0 +1,195 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <optional>
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include "../JuceHeader.h"
+#include "AudioFile.h"
+#include "ReadableAudioFile.h"
+#include "ResampledReadableAudioFile.h"
+#include "WriteableAudioFile.h"
+
+namespace py = pybind11;
+
+namespace Pedalboard {
+
+/**
+ * Return a string that uniquely identifies the decoded (and possibly
+ * resampled) contents of the provided file. Any change to the file's size or
+ * modification time will change this key.
+ */
+inline juce::String
+getDecodeCacheKey(const juce::File &file,
+                  std::optional<double> targetSampleRate,
+                  ResamplingQuality quality) {
+  juce::String key = file.getFullPathName() + "\n" +
+                     juce::String(file.getSize()) + "\n" +
+                     juce::String(file.getLastModificationTime().toMilliseconds());
+  if (targetSampleRate) {
+    key += "\n" + juce::String(*targetSampleRate, 6) + "\n" +
+           juce::String((int)quality);
+  }
+  return key;
+}
+
+/**
+ * Decode the entire provided file (resampling it if necessary) into a
+ * float32 WAV file at cacheFile. The file is written to a temporary file
+ * first and then moved into place, so other readers never see partial data.
+ *
+ * Must be called with the GIL held.
+ */
+inline void writeDecodeCacheEntry(const std::string &filename,
+                                  const juce::File &cacheFile,
+                                  std::optional<double> targetSampleRate,
+                                  ResamplingQuality quality) {
+  auto input = std::make_shared<ReadableAudioFile>(filename);
+  bool needsResampling = targetSampleRate &&
+                         *targetSampleRate != input->getSampleRateAsDouble();
+  double outputSampleRate =
+      needsResampling ? *targetSampleRate : input->getSampleRateAsDouble();
+
+  juce::TemporaryFile temporaryFile(cacheFile);
+  {
+    WriteableAudioFile output(
+        temporaryFile.getFile().getFullPathName().toStdString(),
+        outputSampleRate, input->getNumChannels(), 32);
+
+    if (needsResampling) {
+      std::shared_ptr<ResampledReadableAudioFile> resampled =
+          createResampledReadableAudioFile(input, *targetSampleRate, quality);
+      while (true) {
+        py::array_t<float> chunk =
+            resampled->read((long long)DEFAULT_AUDIO_BUFFER_SIZE_FRAMES);
+        if (chunk.shape(1) == 0)
+          break;
+        output.write(chunk);
+      }
+    } else {
+      py::gil_scoped_release release;
+      juce::AudioBuffer<float> chunk(input->getNumChannels(),
+                                     DEFAULT_AUDIO_BUFFER_SIZE_FRAMES);
+      while (true) {
+        long long framesRead = input->readInto(chunk.getArrayOfWritePointers(),
+                                               chunk.getNumSamples());
+        if (framesRead <= 0)
+          break;
+        output.writeBuffer(chunk, 0, framesRead);
+      }
+    }
+
+    output.close();
+  }
+
+  if (!temporaryFile.overwriteTargetFileWithTemporary()) {
+    throw std::runtime_error("Failed to write decoded audio to cache file: " +
+                             cacheFile.getFullPathName().toStdString());
+  }
+}
+
+/**
+ * Open a float32 WAV copy of the decoded (and optionally resampled) contents
+ * of the provided file from the given cache directory, decoding the file into
+ * the cache first if it isn't already present.
+ *
+ * Must be called with the GIL held.
+ */
+inline std::shared_ptr<ReadableAudioFile>
+openCachedAudioFile(const std::string &filename, const std::string &cacheDir,
+                    std::optional<double> targetSampleRate,
+                    ResamplingQuality quality, bool memoryMap) {
+  juce::File file(filename);
+  if (!file.existsAsFile()) {
+    throw std::domain_error(
+        "Failed to open audio file: file does not exist: " + filename);
+  }
+
+  juce::File cacheDirectory(cacheDir);
+  juce::Result result = cacheDirectory.createDirectory();
+  if (result.failed()) {
+    throw std::domain_error("Failed to create decoded audio cache directory " +
+                            cacheDir + ": " +
+                            result.getErrorMessage().toStdString());
+  }
+
+  juce::String key = getDecodeCacheKey(file, targetSampleRate, quality);
+
+  // The hash may collide, so the full key is stored alongside each entry to
+  // confirm that it contains the audio we expect:
+  juce::String entryName = juce::String::toHexString(key.hashCode64());
+  juce::File cacheFile = cacheDirectory.getChildFile(entryName + ".wav");
+  juce::File keyFile = cacheDirectory.getChildFile(entryName + ".key");
+
+  if (!cacheFile.existsAsFile() || !keyFile.existsAsFile() ||
+      keyFile.loadFileAsString() != key) {
+    keyFile.deleteFile();
+    writeDecodeCacheEntry(filename, cacheFile, targetSampleRate, quality);
+    if (!keyFile.replaceWithText(key)) {
+      throw std::runtime_error("Failed to write decoded audio cache key: " +
+                               keyFile.getFullPathName().toStdString());
+    }
+  }
+
+  return std::make_shared<ReadableAudioFile>(
+      cacheFile.getFullPathName().toStdString(), memoryMap);
+}
+
+inline void init_decode_cache(py::module &m) {
+  m.def(
+      "open_cached",
+      [](std::string filename, std::string cacheDir,
+         std::optional<double> targetSampleRate, ResamplingQuality quality,
+         bool memoryMap) {
+        return openCachedAudioFile(filename, cacheDir, targetSampleRate,
+                                   quality, memoryMap);
+      },
+      R"(
+Open an audio file through a persistent cache of decoded audio stored in
+``cache_dir``, returning a :class:`ReadableAudioFile`.
+
+The first time a file is opened, its entire contents are decoded (and
+resampled to ``target_sample_rate``, if provided and different from the file's
+own sample rate) and stored in ``cache_dir`` as an uncompressed 32-bit
+floating-point WAV file. Later calls with the same arguments skip decoding and
+resampling entirely, and (with ``memory_map=True``, the default) read audio
+directly from the memory-mapped cache file without copying it.
+
+Cache entries are keyed by the file's path, size, and modification time (and
+the target sample rate and resampling quality), so modifying a file will cause
+it to be decoded again. Cache entries are never deleted by Pedalboard; the
+cache directory may be cleared at any time when no files are being opened.
+
+.. note::
+    The returned :class:`ReadableAudioFile` reads from the cache file, so its
+    :py:attr:`name` will point into ``cache_dir``, and its
+    :py:attr:`file_dtype` will always be ``"float32"``.
+
+*Introduced in v0.9.0.*
+)",
+      py::arg("filename"), py::arg("cache_dir"),
+      py::arg("target_sample_rate") = py::none(),
+      py::arg("quality") = ResamplingQuality::WindowedSinc,
+      py::arg("memory_map") = true);
+}
+
+} // namespace Pedalboard
@@ -0,0 +1,231 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <pybind11/pybind11.h>
+
+namespace py = pybind11;
+
+namespace Pedalboard {
+
+inline std::atomic<bool> &getIOStatisticsEnabled() {
+  static std::atomic<bool> enabled = false;
+  return enabled;
+}
+
+/**
+ * Counters describing the I/O done by one audio file, or by every audio file
+ * of one format.
+ */
+struct IOCounters {
+  using Counter = std::atomic<unsigned long long>;
+
+  // Bytes passed to or from Python file-like objects:
+  Counter bytesRead = 0;
+  Counter bytesWritten = 0;
+
+  // Calls to the methods of Python file-like objects, and the total time
+  // spent holding the GIL to make those calls:
+  Counter pythonReadCalls = 0;
+  Counter pythonSeekCalls = 0;
+  Counter pythonTellCalls = 0;
+  Counter pythonWriteCalls = 0;
+  Counter pythonNanoseconds = 0;
+
+  Counter framesDecoded = 0;
+  Counter decodeNanoseconds = 0;
+  Counter framesEncoded = 0;
+  Counter encodeNanoseconds = 0;
+  Counter framesResampled = 0;
+  Counter resampleNanoseconds = 0;
+
+  static constexpr Counter IOCounters::*ALL_COUNTERS[] = {
+      &IOCounters::bytesRead,           &IOCounters::bytesWritten,
+      &IOCounters::pythonReadCalls,     &IOCounters::pythonSeekCalls,
+      &IOCounters::pythonTellCalls,     &IOCounters::pythonWriteCalls,
+      &IOCounters::pythonNanoseconds,   &IOCounters::framesDecoded,
+      &IOCounters::decodeNanoseconds,   &IOCounters::framesEncoded,
+      &IOCounters::encodeNanoseconds,   &IOCounters::framesResampled,
+      &IOCounters::resampleNanoseconds,
+  };
+
+  void addTo(IOCounters &other) const {
+    for (auto counter : ALL_COUNTERS)
+      (other.*counter).fetch_add((this->*counter).load(),
+                                 std::memory_order_relaxed);
+  }
+
+  py::dict toDict(bool reset) {
+    const auto read = [reset](Counter &counter) {
+      return reset ? counter.exchange(0) : counter.load();
+    };
+
+    py::dict dict;
+    dict["bytes_read"] = read(bytesRead);
+    dict["bytes_written"] = read(bytesWritten);
+    dict["python_read_calls"] = read(pythonReadCalls);
+    dict["python_seek_calls"] = read(pythonSeekCalls);
+    dict["python_tell_calls"] = read(pythonTellCalls);
+    dict["python_write_calls"] = read(pythonWriteCalls);
+    dict["python_seconds"] = read(pythonNanoseconds) / 1e9;
+    dict["frames_decoded"] = read(framesDecoded);
+    dict["decode_seconds"] = read(decodeNanoseconds) / 1e9;
+    dict["frames_encoded"] = read(framesEncoded);
+    dict["encode_seconds"] = read(encodeNanoseconds) / 1e9;
+    dict["frames_resampled"] = read(framesResampled);
+    dict["resample_seconds"] = read(resampleNanoseconds) / 1e9;
+    return dict;
+  }
+};
+
+/**
+ * The I/O statistics of a single audio file (and any Python file-like object
+ * it reads from or writes to). Once the file's format is known, every update
+ * is also added to the process-wide totals for that format.
+ *
+ * Updates are only made while I/O statistics are enabled; if they're not,
+ * each update costs one atomic load.
+ */
+class IOStatistics {
+public:
+  using Counter = IOCounters::Counter;
+
+  static bool isEnabled() {
+    return getIOStatisticsEnabled().load(std::memory_order_relaxed);
+  }
+
+  void add(Counter IOCounters::*counter, unsigned long long amount) {
+    if (!isEnabled())
+      return;
+
+    (counters.*counter).fetch_add(amount, std::memory_order_relaxed);
+    if (IOCounters *totals = formatTotals.load(std::memory_order_acquire))
+      (totals->*counter).fetch_add(amount, std::memory_order_relaxed);
+  }
+
+  /**
+   * Start adding to the totals of the provided format, including anything
+   * counted so far (i.e.: while probing a stream to find its format). Must be
+   * called at most once.
+   */
+  void setFormat(const std::string &formatName) {
+    IOCounters &totals = getTotals(formatName);
+    counters.addTo(totals);
+    formatTotals.store(&totals, std::memory_order_release);
+  }
+
+  py::dict toDict(bool reset) { return counters.toDict(reset); }
+
+  static IOCounters &getTotals(const std::string &formatName) {
+    std::lock_guard<std::mutex> lock(getTotalsMutex());
+    return getTotalsByFormat()[formatName];
+  }
+
+  static py::dict getAllTotals(bool reset) {
+    py::dict totals;
+    std::lock_guard<std::mutex> lock(getTotalsMutex());
+    for (auto &[formatName, counters] : getTotalsByFormat())
+      totals[py::str(formatName)] = counters.toDict(reset);
+    return totals;
+  }
+
+private:
+  // Leaked, as files may still be updating these during static destruction.
+  // Entries are never removed, so references to them remain valid.
+  static std::map<std::string, IOCounters> &getTotalsByFormat() {
+    static auto *totals = new std::map<std::string, IOCounters>();
+    return *totals;
+  }
+
+  static std::mutex &getTotalsMutex() {
+    static auto *mutex = new std::mutex();
+    return *mutex;
+  }
+
+  IOCounters counters;
+  std::atomic<IOCounters *> formatTotals = nullptr;
+};
+
+/**
+ * Adds the time between its construction and destruction to one of the
+ * provided statistics' counters, if I/O statistics are enabled.
+ */
+class IOTimer {
+public:
+  IOTimer(IOStatistics *statistics, IOStatistics::Counter IOCounters::*counter)
+      : statistics(statistics && IOStatistics::isEnabled() ? statistics
+                                                           : nullptr),
+        counter(counter) {
+    if (this->statistics)
+      startTime = std::chrono::steady_clock::now();
+  }
+
+  ~IOTimer() {
+    if (!statistics)
+      return;
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - startTime);
+    statistics->add(counter, elapsed.count());
+  }
+
+  IOTimer(const IOTimer &) = delete;
+  IOTimer &operator=(const IOTimer &) = delete;
+
+private:
+  IOStatistics *statistics;
+  IOStatistics::Counter IOCounters::*counter;
+  std::chrono::steady_clock::time_point startTime;
+};
+
+inline void init_io_statistics(py::module &m) {
+  m.def(
+      "set_io_statistics_enabled",
+      [](bool enabled) { getIOStatisticsEnabled() = enabled; },
+      py::arg("enabled"), R"(
+Enable or disable collection of I/O statistics (read with
+:py:meth:`AudioFile.stats` or :func:`get_io_statistics`) whenever audio files
+are read, written, or resampled. I/O statistics are disabled by default, and
+cost almost nothing while disabled.
+
+*Introduced in v0.9.0.*
+)");
+
+  m.def(
+      "get_io_statistics",
+      [](bool reset) { return IOStatistics::getAllTotals(reset); },
+      py::arg("reset") = false, R"(
+Return the I/O statistics collected from every audio file opened by this
+process while I/O statistics were enabled (see
+:func:`set_io_statistics_enabled`), as a dictionary mapping the name of each
+audio format (i.e.: ``"WAV file"``) to a dictionary with the same keys as
+:py:meth:`AudioFile.stats`, ready to be exported to a metrics system. If
+``reset`` is ``True``, all totals are set to zero after being read.
+
+*Introduced in v0.9.0.*
+)");
+}
+
+} // namespace Pedalboard
@@ -23,6 +23,7 @@
 namespace py = pybind11;
 
 #include "../JuceHeader.h"
+#include "IOStatistics.h"
 
 namespace Pedalboard {
 
@@ -90,9 +91,11 @@ public:
 
   juce::int64 getPosition() noexcept {
     py::gil_scoped_acquire acquire;
+    IOTimer timer(statistics.get(), &IOCounters::pythonNanoseconds);
 
     if (!PythonException::isPending()) {
       try {
+        addToStatistics(&IOCounters::pythonTellCalls);
         return fileLike.attr("tell")().cast<juce::int64>();
       } catch (py::error_already_set e) {
         e.restore();
@@ -106,10 +109,13 @@ public:
 
   bool setPosition(juce::int64 pos) noexcept {
     py::gil_scoped_acquire acquire;
+    IOTimer timer(statistics.get(), &IOCounters::pythonNanoseconds);
 
     if (!PythonException::isPending()) {
       try {
+        addToStatistics(&IOCounters::pythonSeekCalls);
         fileLike.attr("seek")(pos);
+        addToStatistics(&IOCounters::pythonTellCalls);
         return fileLike.attr("tell")().cast<juce::int64>() == pos;
       } catch (py::error_already_set e) {
         e.restore();
@@ -123,7 +129,23 @@ public:
 
   py::object getFileLikeObject() { return fileLike; }
 
+  /**
+   * Count the calls made to the file-like object (and the bytes passed to or
+   * from it) in the provided statistics, usually those of the audio file
+   * that owns this stream.
+   */
+  void setStatistics(std::shared_ptr<IOStatistics> newStatistics) {
+    statistics = newStatistics;
+  }
+
 protected:
+  void addToStatistics(IOStatistics::Counter IOCounters::*counter,
+                       unsigned long long amount = 1) {
+    if (statistics)
+      statistics->add(counter, amount);
+  }
+
   py::object fileLike;
+  std::shared_ptr<IOStatistics> statistics;
 };
 }; // namespace Pedalboard
\ No newline at end of file
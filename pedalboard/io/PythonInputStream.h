@@ -19,6 +19,7 @@
 
 #include <mutex>
 #include <optional>
+#include <vector>
 
 namespace py = pybind11;
 
@@ -35,14 +36,28 @@ bool isReadableFileLike(py::object fileLike) {
 /**
  * A juce::InputStream subclass that fetches its
  * data from a provided Python file-like object.
+ *
+ * Data is read from Python in large blocks and kept in a read-ahead buffer,
+ * so that the many small reads and seeks made by most decoders can be served
+ * without acquiring the GIL or calling into Python. The read-ahead size
+ * starts small (to avoid over-reading when only a file's header is needed)
+ * and doubles with each sequential read, up to `maxReadAheadBytes`.
  */
 class PythonInputStream : public juce::InputStream, public PythonFileLike {
 public:
-  PythonInputStream(py::object fileLike) : PythonFileLike(fileLike) {
+  static constexpr size_t DEFAULT_MAX_READ_AHEAD_BYTES = 1024 * 1024;
+  static constexpr size_t MIN_READ_AHEAD_BYTES = 64 * 1024;
+
+  PythonInputStream(py::object fileLike,
+                    size_t maxReadAheadBytes = DEFAULT_MAX_READ_AHEAD_BYTES)
+      : PythonFileLike(fileLike), maxReadAheadBytes(maxReadAheadBytes),
+        readAheadBytes(std::min(MIN_READ_AHEAD_BYTES, maxReadAheadBytes)) {
     if (!isReadableFileLike(fileLike)) {
       throw py::type_error("Expected a file-like object (with read, seek, "
                            "seekable, and tell methods).");
     }
+
+    canReadFromBuffer = isUnmodifiedBytesIO(fileLike);
   }
 
   bool isSeekable() noexcept {
@@ -63,7 +78,11 @@ public:
   }
 
   juce::int64 getTotalLength() noexcept {
+    if (totalLength != -1)
+      return totalLength;
+
     py::gil_scoped_acquire acquire;
+    IOTimer timer(statistics.get(), &IOCounters::pythonNanoseconds);
 
     if (PythonException::isPending())
       return -1;
@@ -77,17 +96,20 @@ public:
         return -1;
       }
 
-      if (totalLength == -1) {
-        juce::int64 pos = fileLike.attr("tell")().cast<juce::int64>();
-        fileLike.attr("seek")(0, 2);
-        totalLength = fileLike.attr("tell")().cast<juce::int64>();
-        fileLike.attr("seek")(pos, 0);
-      }
+      addToStatistics(&IOCounters::pythonTellCalls, 2);
+      addToStatistics(&IOCounters::pythonSeekCalls, 2);
+      juce::int64 pos = fileLike.attr("tell")().cast<juce::int64>();
+      fileLike.attr("seek")(0, 2);
+      totalLength = fileLike.attr("tell")().cast<juce::int64>();
+      fileLike.attr("seek")(pos, 0);
+      pythonPosition = pos;
     } catch (py::error_already_set e) {
       e.restore();
+      pythonPosition = -1;
       return -1;
     } catch (const py::builtin_exception &e) {
       e.set_error();
+      pythonPosition = -1;
       return -1;
     }
 
@@ -99,91 +121,93 @@ public:
     // sign that something is broken!
     jassert(buffer != nullptr && bytesToRead >= 0);
 
-    if (PythonException::isPending())
-      return 0;
-
-    py::gil_scoped_acquire acquire;
-    try {
-      auto readResult = fileLike.attr("read")(bytesToRead);
-
-      if (!py::isinstance<py::bytes>(readResult)) {
-        std::string message =
-            "File-like object passed to AudioFile was expected to return "
-            "bytes from its read(...) method, but "
-            "returned " +
-            py::str(readResult.get_type().attr("__name__"))
-                .cast<std::string>() +
-            ".";
-
-        if (py::hasattr(fileLike, "mode") &&
-            py::str(fileLike.attr("mode")).cast<std::string>() == "r") {
-          message += " (Try opening the stream in \"rb\" mode instead of "
-                     "\"r\" mode if possible.)";
-        }
-
-        throw py::type_error(message);
-        return 0;
-      }
+    char *destination = static_cast<char *>(buffer);
+    int bytesRead = 0;
+
+    // Serve as much as we can from the read-ahead buffer without the GIL:
+    if (position >= bufferStart && position < bufferStart + bufferLength) {
+      int bytesFromBuffer = (int)std::min<juce::int64>(
+          bytesToRead, bufferStart + bufferLength - position);
+      std::memcpy(destination,
+                  readAheadBuffer.data() + (position - bufferStart),
+                  bytesFromBuffer);
+      position += bytesFromBuffer;
+      bytesRead += bytesFromBuffer;
+    }
 
-      py::bytes bytesObject = readResult.cast<py::bytes>();
-      char *pythonBuffer = nullptr;
-      py::ssize_t pythonLength = 0;
+    if (bytesRead < bytesToRead) {
+      py::gil_scoped_acquire acquire;
+      IOTimer timer(statistics.get(), &IOCounters::pythonNanoseconds);
 
-      if (PYBIND11_BYTES_AS_STRING_AND_SIZE(bytesObject.ptr(), &pythonBuffer,
-                                            &pythonLength)) {
-        throw py::buffer_error(
-            "Internal error: failed to read bytes from bytes object!");
-      }
+      if (PythonException::isPending())
+        return bytesRead;
 
-      if (!buffer && pythonLength > 0) {
-        throw py::buffer_error("Internal error: bytes pointer is null, but a "
-                               "non-zero number of bytes were returned!");
-      }
+      try {
+        if (position < 0) {
+          addToStatistics(&IOCounters::pythonTellCalls);
+          position = fileLike.attr("tell")().cast<juce::int64>();
+          pythonPosition = position;
+        }
 
-      if (buffer && pythonLength) {
-        std::memcpy(buffer, pythonBuffer, pythonLength);
+        int bytesRemaining = bytesToRead - bytesRead;
+        if ((size_t)bytesRemaining >= readAheadBytes) {
+          // Large reads go straight into the caller's buffer:
+          int bytesFromPython = readFromPython(destination + bytesRead,
+                                               position, bytesRemaining);
+          position += bytesFromPython;
+          bytesRead += bytesFromPython;
+        } else {
+          fillReadAheadBuffer();
+          int bytesFromBuffer =
+              (int)std::min<juce::int64>(bytesRemaining, bufferLength);
+          std::memcpy(destination + bytesRead, readAheadBuffer.data(),
+                      bytesFromBuffer);
+          position += bytesFromBuffer;
+          bytesRead += bytesFromBuffer;
+        }
+      } catch (py::error_already_set e) {
+        e.restore();
+        invalidateBuffer();
+        return bytesRead;
+      } catch (const py::builtin_exception &e) {
+        e.set_error();
+        invalidateBuffer();
+        return bytesRead;
       }
-
-      lastReadWasSmallerThanExpected = bytesToRead > pythonLength;
-      return pythonLength;
-    } catch (py::error_already_set e) {
-      e.restore();
-      return 0;
-    } catch (const py::builtin_exception &e) {
-      e.set_error();
-      return 0;
     }
+
+    lastReadWasSmallerThanExpected = bytesToRead > bytesRead;
+    return bytesRead;
   }
 
   bool isExhausted() noexcept {
-    py::gil_scoped_acquire acquire;
-
-    if (PythonException::isPending())
+    if (lastReadWasSmallerThanExpected) {
       return true;
+    }
 
-    try {
-      if (lastReadWasSmallerThanExpected) {
-        return true;
-      }
-
-      return fileLike.attr("tell")().cast<juce::int64>() == getTotalLength();
-    } catch (py::error_already_set e) {
-      e.restore();
-      return true;
-    } catch (const py::builtin_exception &e) {
-      e.set_error();
-      return true;
+    juce::int64 length = getTotalLength();
+    if (length == -1) {
+      return PythonException::isPending();
     }
+
+    return getPosition() == length;
   }
 
   juce::int64 getPosition() noexcept {
+    if (position >= 0)
+      return position;
+
     py::gil_scoped_acquire acquire;
+    IOTimer timer(statistics.get(), &IOCounters::pythonNanoseconds);
 
     if (PythonException::isPending())
       return -1;
 
     try {
-      return fileLike.attr("tell")().cast<juce::int64>();
+      addToStatistics(&IOCounters::pythonTellCalls);
+      position = fileLike.attr("tell")().cast<juce::int64>();
+      pythonPosition = position;
+      return position;
     } catch (py::error_already_set e) {
       e.restore();
       return -1;
@@ -194,29 +218,189 @@ public:
   }
 
   bool setPosition(juce::int64 pos) noexcept {
+    // Seeks within the read-ahead buffer don't need to touch Python at all:
+    if (bufferLength > 0 && pos >= bufferStart &&
+        pos <= bufferStart + bufferLength) {
+      position = pos;
+      lastReadWasSmallerThanExpected = false;
+      return true;
+    }
+
     py::gil_scoped_acquire acquire;
+    IOTimer timer(statistics.get(), &IOCounters::pythonNanoseconds);
 
     if (PythonException::isPending())
       return false;
 
     try {
       if (fileLike.attr("seekable")().cast<bool>()) {
+        addToStatistics(&IOCounters::pythonSeekCalls);
         fileLike.attr("seek")(pos);
         lastReadWasSmallerThanExpected = false;
       }
 
-      return fileLike.attr("tell")().cast<juce::int64>() == pos;
+      addToStatistics(&IOCounters::pythonTellCalls);
+      position = fileLike.attr("tell")().cast<juce::int64>();
+      pythonPosition = position;
+      return position == pos;
     } catch (py::error_already_set e) {
       e.restore();
+      position = -1;
+      pythonPosition = -1;
       return false;
     } catch (const py::builtin_exception &e) {
       e.set_error();
+      position = -1;
+      pythonPosition = -1;
       return false;
     }
   }
 
 private:
+  /**
+   * Returns true if the provided object is an io.BytesIO whose methods
+   * haven't been replaced on the instance, in which case we can copy data
+   * straight out of its buffer rather than calling its read method.
+   */
+  static bool isUnmodifiedBytesIO(py::object fileLike) {
+    if (!py::type::of(fileLike).is(py::module::import("io").attr("BytesIO"))) {
+      return false;
+    }
+
+    if (py::hasattr(fileLike, "__dict__")) {
+      py::dict attributes = fileLike.attr("__dict__");
+      for (const char *name : {"read", "seek", "tell", "seekable"}) {
+        if (attributes.contains(name))
+          return false;
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * Read up to `bytesToRead` bytes starting at byte `offset` of the file-like
+   * object into `destination`, returning the number of bytes read.
+   *
+   * Must be called with the GIL held; throws if any Python call fails.
+   */
+  int readFromPython(char *destination, juce::int64 offset, int bytesToRead) {
+    if (canReadFromBuffer) {
+      // Copy directly from the BytesIO's internal buffer. The memoryview is
+      // released before returning, as the BytesIO can't be resized while any
+      // views of it exist.
+      py::buffer view = fileLike.attr("getbuffer")().cast<py::buffer>();
+      py::buffer_info info = view.request();
+      juce::int64 bytesAvailable = std::max<juce::int64>(0, info.size - offset);
+      int bytesCopied =
+          (int)std::min<juce::int64>(bytesToRead, bytesAvailable);
+      if (bytesCopied > 0) {
+        std::memcpy(destination, static_cast<const char *>(info.ptr) + offset,
+                    bytesCopied);
+      }
+      addToStatistics(&IOCounters::pythonReadCalls);
+      addToStatistics(&IOCounters::bytesRead, bytesCopied);
+      return bytesCopied;
+    }
+
+    if (pythonPosition != offset) {
+      addToStatistics(&IOCounters::pythonSeekCalls);
+      fileLike.attr("seek")(offset);
+      pythonPosition = offset;
+    }
+
+    addToStatistics(&IOCounters::pythonReadCalls);
+    auto readResult = fileLike.attr("read")(bytesToRead);
+
+    if (!py::isinstance<py::bytes>(readResult)) {
+      std::string message =
+          "File-like object passed to AudioFile was expected to return "
+          "bytes from its read(...) method, but "
+          "returned " +
+          py::str(readResult.get_type().attr("__name__")).cast<std::string>() +
+          ".";
+
+      if (py::hasattr(fileLike, "mode") &&
+          py::str(fileLike.attr("mode")).cast<std::string>() == "r") {
+        message += " (Try opening the stream in \"rb\" mode instead of "
+                   "\"r\" mode if possible.)";
+      }
+
+      throw py::type_error(message);
+    }
+
+    py::bytes bytesObject = readResult.cast<py::bytes>();
+    char *pythonBuffer = nullptr;
+    py::ssize_t pythonLength = 0;
+
+    if (PYBIND11_BYTES_AS_STRING_AND_SIZE(bytesObject.ptr(), &pythonBuffer,
+                                          &pythonLength)) {
+      throw py::buffer_error(
+          "Internal error: failed to read bytes from bytes object!");
+    }
+
+    if (!pythonBuffer && pythonLength > 0) {
+      throw py::buffer_error("Internal error: bytes pointer is null, but a "
+                             "non-zero number of bytes were returned!");
+    }
+
+    if (pythonLength > bytesToRead) {
+      throw py::buffer_error(
+          "File-like object passed to AudioFile returned " +
+          std::to_string(pythonLength) + " bytes from its read(...) method, "
+          "but only " + std::to_string(bytesToRead) + " bytes were requested.");
+    }
+
+    if (pythonLength) {
+      std::memcpy(destination, pythonBuffer, pythonLength);
+    }
+
+    addToStatistics(&IOCounters::bytesRead, pythonLength);
+    pythonPosition += pythonLength;
+    return (int)pythonLength;
+  }
+
+  /**
+   * Replace the contents of the read-ahead buffer with data starting at the
+   * current position. Must be called with the GIL held.
+   */
+  void fillReadAheadBuffer() {
+    bool isSequential =
+        bufferLength > 0 && position == bufferStart + bufferLength;
+    readAheadBytes = isSequential
+                         ? std::min(readAheadBytes * 2, maxReadAheadBytes)
+                         : std::min(MIN_READ_AHEAD_BYTES, maxReadAheadBytes);
+
+    if (readAheadBuffer.size() < readAheadBytes) {
+      readAheadBuffer.resize(readAheadBytes);
+    }
+
+    invalidateBuffer();
+    bufferStart = position;
+    bufferLength = readFromPython(readAheadBuffer.data(), position,
+                                  (int)readAheadBytes);
+  }
+
+  void invalidateBuffer() {
+    bufferStart = 0;
+    bufferLength = 0;
+  }
+
+  const size_t maxReadAheadBytes;
+  size_t readAheadBytes;
+  std::vector<char> readAheadBuffer;
+
+  // The range of the file-like object's contents held in readAheadBuffer:
+  juce::int64 bufferStart = 0;
+  juce::int64 bufferLength = 0;
+
+  // Our logical position in the stream, and the position we expect the
+  // file-like object to be at (or -1 if unknown):
+  juce::int64 position = -1;
+  juce::int64 pythonPosition = -1;
+
+  bool canReadFromBuffer = false;
   juce::int64 totalLength = -1;
   bool lastReadWasSmallerThanExpected = false;
 };
-}; // namespace Pedalboard
\ No newline at end of file
+}; // namespace Pedalboard
@@ -0,0 +1,77 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <pybind11/pybind11.h>
+
+#include "../JuceHeader.h"
+
+namespace py = pybind11;
+
+namespace Pedalboard {
+
+/**
+ * Holds a reference to the memory of a Python object that supports the
+ * buffer protocol, preventing that memory from being moved or freed until
+ * this object is destroyed.
+ */
+class PinnedPythonBuffer {
+public:
+  /**
+   * Must be called with the GIL held. Throws if the object does not support
+   * the buffer protocol or its memory is not C-contiguous.
+   */
+  PinnedPythonBuffer(py::object object) {
+    if (PyObject_GetBuffer(object.ptr(), &view, PyBUF_C_CONTIGUOUS) != 0) {
+      throw py::error_already_set();
+    }
+  }
+
+  ~PinnedPythonBuffer() {
+    py::gil_scoped_acquire acquire;
+    PyBuffer_Release(&view);
+  }
+
+  const void *getData() const { return view.buf; }
+  size_t getSize() const { return (size_t)view.len; }
+
+private:
+  Py_buffer view;
+
+  JUCE_DECLARE_NON_COPYABLE(PinnedPythonBuffer)
+};
+
+/**
+ * A juce::InputStream that reads directly from the memory of a Python
+ * buffer-protocol object (i.e.: bytes, bytearray, memoryview, or a NumPy
+ * array). The object's memory stays pinned for as long as this stream
+ * exists, so reading never copies the data up front or acquires the GIL.
+ */
+class PythonMemoryInputStream : private PinnedPythonBuffer,
+                                public juce::MemoryInputStream {
+public:
+  /**
+   * Must be called with the GIL held.
+   */
+  PythonMemoryInputStream(py::object object)
+      : PinnedPythonBuffer(object),
+        juce::MemoryInputStream(getData(), getSize(),
+                                /* keepInternalCopyOfData= */ false) {}
+};
+
+} // namespace Pedalboard
@@ -19,6 +19,7 @@
 
 #include <mutex>
 #include <optional>
+#include <vector>
 
 namespace py = pybind11;
 
@@ -35,18 +36,34 @@ bool isWriteableFileLike(py::object fileLike) {
 /**
  * A juce::OutputStream subclass that writes its
  * data to a provided Python file-like object.
+ *
+ * Writes are collected in a buffer and passed to Python in large blocks, so
+ * that encoders (which tend to emit many small chunks of data) can run
+ * without acquiring the GIL for each write. Buffered data is written to the
+ * file-like object when the buffer fills, before seeking, when flushed, and
+ * when this stream is destroyed.
  */
 class PythonOutputStream : public juce::OutputStream, public PythonFileLike {
 public:
-  PythonOutputStream(py::object fileLike) : PythonFileLike(fileLike) {
+  static constexpr size_t DEFAULT_WRITE_BUFFER_BYTES = 1024 * 1024;
+
+  PythonOutputStream(py::object fileLike,
+                     size_t writeBufferBytes = DEFAULT_WRITE_BUFFER_BYTES)
+      : PythonFileLike(fileLike), writeBufferBytes(writeBufferBytes) {
     if (!isWriteableFileLike(fileLike)) {
       throw py::type_error("Expected a file-like object (with write, seek, "
                            "seekable, and tell methods).");
     }
   }
 
+  ~PythonOutputStream() { flushWriteBuffer(); }
+
   virtual void flush() noexcept override {
+    if (!flushWriteBuffer())
+      return;
+
     py::gil_scoped_acquire acquire;
+    IOTimer timer(statistics.get(), &IOCounters::pythonNanoseconds);
 
     if (PythonException::isPending())
       return;
@@ -65,24 +82,82 @@ public:
   }
 
   virtual juce::int64 getPosition() noexcept override {
-    return PythonFileLike::getPosition();
+    if (pythonPosition == -1) {
+      pythonPosition = PythonFileLike::getPosition();
+      if (pythonPosition == -1)
+        return -1;
+    }
+
+    return pythonPosition + writeBuffer.size();
   }
 
   virtual bool setPosition(juce::int64 pos) noexcept override {
-    return PythonFileLike::setPosition(pos);
+    if (!flushWriteBuffer())
+      return false;
+
+    bool succeeded = PythonFileLike::setPosition(pos);
+    pythonPosition = succeeded ? pos : -1;
+    return succeeded;
   }
 
   virtual bool write(const void *ptr, size_t numBytes) noexcept override {
+    if (writeBuffer.size() + numBytes > writeBufferBytes) {
+      if (!flushWriteBuffer())
+        return false;
+    }
+
+    if (numBytes >= writeBufferBytes) {
+      // Large writes can go straight to Python without being copied:
+      return writeToPython((const char *)ptr, numBytes);
+    }
+
+    writeBuffer.insert(writeBuffer.end(), (const char *)ptr,
+                       (const char *)ptr + numBytes);
+    return true;
+  }
+
+  virtual bool writeRepeatedByte(juce::uint8 byte,
+                                 size_t numTimesToRepeat) noexcept override {
+    const size_t maxEffectiveSize = std::min(numTimesToRepeat, (size_t)8192);
+    std::vector<char> buffer(maxEffectiveSize, byte);
+
+    for (size_t i = 0; i < numTimesToRepeat; i += buffer.size()) {
+      const size_t chunkSize = std::min(numTimesToRepeat - i, buffer.size());
+      if (!write(buffer.data(), chunkSize)) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+private:
+  /**
+   * Pass any buffered data to the file-like object's write method.
+   * Returns false if the write failed.
+   */
+  bool flushWriteBuffer() noexcept {
+    if (writeBuffer.empty())
+      return true;
+
+    bool succeeded = writeToPython(writeBuffer.data(), writeBuffer.size());
+    writeBuffer.clear();
+    return succeeded;
+  }
+
+  bool writeToPython(const char *ptr, size_t numBytes) noexcept {
     py::gil_scoped_acquire acquire;
+    IOTimer timer(statistics.get(), &IOCounters::pythonNanoseconds);
 
     if (PythonException::isPending())
       return false;
 
     try {
+      addToStatistics(&IOCounters::pythonWriteCalls);
       py::object writeResponse =
-          fileLike.attr("write")(py::bytes((const char *)ptr, numBytes));
+          fileLike.attr("write")(py::bytes(ptr, numBytes));
 
-      int bytesWritten;
+      long long bytesWritten;
       if (writeResponse.is_none()) {
         // Assume bytesWritten is numBytes if `write` returned None.
         // This shouldn't happen, but sometimes does if the file-like
@@ -90,7 +165,7 @@ public:
         bytesWritten = numBytes;
       } else {
         try {
-          bytesWritten = writeResponse.cast<int>();
+          bytesWritten = writeResponse.cast<long long>();
         } catch (const py::cast_error &e) {
           throw py::type_error(
               py::repr(fileLike.attr("write")).cast<std::string>() +
@@ -99,66 +174,31 @@ public:
         }
       }
 
-      if (bytesWritten < numBytes) {
+      if (bytesWritten < (long long)numBytes) {
+        pythonPosition = -1;
         return false;
       }
     } catch (py::error_already_set e) {
       e.restore();
+      pythonPosition = -1;
       return false;
     } catch (const py::builtin_exception &e) {
       e.set_error();
+      pythonPosition = -1;
       return false;
     }
+
+    addToStatistics(&IOCounters::bytesWritten, numBytes);
+    if (pythonPosition != -1)
+      pythonPosition += numBytes;
     return true;
   }
 
-  virtual bool writeRepeatedByte(juce::uint8 byte,
-                                 size_t numTimesToRepeat) noexcept override {
-    py::gil_scoped_acquire acquire;
-
-    if (PythonException::isPending())
-      return false;
-
-    try {
-      const size_t maxEffectiveSize = std::min(numTimesToRepeat, (size_t)8192);
-      std::vector<char> buffer(maxEffectiveSize, byte);
-
-      for (size_t i = 0; i < numTimesToRepeat; i += buffer.size()) {
-        const size_t chunkSize = std::min(numTimesToRepeat - i, buffer.size());
-
-        py::object writeResponse = fileLike.attr("write")(
-            py::bytes((const char *)buffer.data(), chunkSize));
-
-        int bytesWritten;
-        if (writeResponse.is_none()) {
-          // Assume bytesWritten is numBytes if `write` returned None.
-          // This shouldn't happen, but sometimes does if the file-like
-          // object is not fully compliant with io.RawIOBase.
-          bytesWritten = chunkSize;
-        } else {
-          try {
-            bytesWritten = writeResponse.cast<int>();
-          } catch (const py::cast_error &e) {
-            throw py::type_error(
-                py::repr(fileLike.attr("write")).cast<std::string>() +
-                " was expected to return an integer, but got " +
-                py::repr(writeResponse).cast<std::string>());
-          }
-        }
+  const size_t writeBufferBytes;
+  std::vector<char> writeBuffer;
 
-        if (bytesWritten != chunkSize) {
-          return false;
-        }
-      }
-    } catch (py::error_already_set e) {
-      e.restore();
-      return false;
-    } catch (const py::builtin_exception &e) {
-      e.set_error();
-      return false;
-    }
-
-    return true;
-  }
+  // The position of the file-like object, which does not include any data
+  // still in writeBuffer (or -1 if unknown):
+  juce::int64 pythonPosition = -1;
 };
 }; // namespace Pedalboard
@@ -0,0 +1,175 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../JuceHeader.h"
+
+namespace Pedalboard {
+
+/**
+ * Decodes audio on a background thread into a bounded number of fixed-size
+ * chunks, ahead of a consumer that reads the same audio sequentially.
+ *
+ * The provided decode function is called repeatedly on the background thread
+ * to fill one chunk at a time, and must return the number of frames it
+ * decoded; a short (or empty) chunk marks the end of the stream. Any
+ * exception thrown by the decode function is rethrown to the consumer once
+ * all of the audio decoded before it has been read.
+ *
+ * Destroying a ReadAheadBuffer waits for any in-progress decode to finish, so
+ * it must not be destroyed while holding a lock that the decode function
+ * needs. The decode function must not require the GIL.
+ */
+class ReadAheadBuffer {
+public:
+  using DecodeFunction = std::function<long long(float **, long long)>;
+
+  ReadAheadBuffer(int numChannels, long long framesPerChunk,
+                  DecodeFunction decode, int numChunks = 2)
+      : framesPerChunk(framesPerChunk), decode(decode) {
+    for (int i = 0; i < numChunks; i++) {
+      chunks.emplace_back(numChannels, (int)framesPerChunk);
+    }
+    thread = std::thread([this]() { run(); });
+  }
+
+  ~ReadAheadBuffer() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    condition.notify_all();
+    thread.join();
+  }
+
+  /**
+   * Copy up to numFrames frames of decoded audio into the provided channel
+   * pointers, waiting for the background thread if no decoded audio is
+   * available yet. Fewer frames are returned only at the end of the stream
+   * (or just before an error).
+   */
+  long long read(float **output, long long numFrames) {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    long long framesRead = 0;
+    while (framesRead < numFrames) {
+      condition.wait(lock,
+                     [this]() { return numFilled > 0 || endOfStream || error; });
+
+      if (numFilled == 0) {
+        if (error && framesRead == 0)
+          std::rethrow_exception(error);
+        break;
+      }
+
+      Chunk &chunk = chunks[readIndex];
+      long long framesToCopy =
+          std::min(numFrames - framesRead, chunk.numFrames - readOffset);
+      for (int c = 0; c < chunk.audio.getNumChannels(); c++) {
+        std::memcpy(output[c] + framesRead,
+                    chunk.audio.getReadPointer(c) + readOffset,
+                    framesToCopy * sizeof(float));
+      }
+      readOffset += framesToCopy;
+      framesRead += framesToCopy;
+
+      if (readOffset == chunk.numFrames) {
+        readOffset = 0;
+        readIndex = (readIndex + 1) % chunks.size();
+        numFilled--;
+        condition.notify_all();
+      }
+    }
+
+    return framesRead;
+  }
+
+private:
+  struct Chunk {
+    Chunk(int numChannels, int numFrames) : audio(numChannels, numFrames) {}
+
+    juce::AudioBuffer<float> audio;
+    long long numFrames = 0;
+  };
+
+  void run() {
+    while (true) {
+      size_t writeIndex;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this]() {
+          return stopping ||
+                 (numFilled < chunks.size() && !endOfStream && !error);
+        });
+        if (stopping)
+          return;
+        writeIndex = (readIndex + numFilled) % chunks.size();
+      }
+
+      // The consumer never touches chunks that haven't been filled yet, so
+      // this chunk can be decoded into without holding the lock:
+      Chunk &chunk = chunks[writeIndex];
+      long long framesDecoded = 0;
+      std::exception_ptr decodeError;
+      try {
+        framesDecoded =
+            decode(chunk.audio.getArrayOfWritePointers(), framesPerChunk);
+      } catch (...) {
+        decodeError = std::current_exception();
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        chunk.numFrames = framesDecoded;
+        if (framesDecoded > 0)
+          numFilled++;
+        if (framesDecoded < framesPerChunk)
+          endOfStream = true;
+        error = decodeError;
+      }
+      condition.notify_all();
+    }
+  }
+
+  const long long framesPerChunk;
+  const DecodeFunction decode;
+
+  std::vector<Chunk> chunks;
+  size_t readIndex = 0;
+  size_t numFilled = 0;
+  long long readOffset = 0;
+  bool endOfStream = false;
+  bool stopping = false;
+  std::exception_ptr error;
+
+  std::mutex mutex;
+  std::condition_variable condition;
+
+  // Must be declared last, so that it starts after everything else is ready:
+  std::thread thread;
+};
+
+} // namespace Pedalboard
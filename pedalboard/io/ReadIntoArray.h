@@ -0,0 +1,132 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include "../JuceHeader.h"
+#include "AudioFile.h"
+
+namespace py = pybind11;
+
+namespace Pedalboard {
+
+/**
+ * Read audio into the provided writable float32 NumPy array, which may be
+ * shaped either (num_channels, num_frames) or (num_frames, num_channels) (or
+ * (num_frames,) for mono audio) and may have any strides. Returns the number
+ * of frames written, which will be fewer than the array can hold only once
+ * `read` returns fewer frames than requested.
+ *
+ * `read` must have the signature `long long(float **channels, long long
+ * numFrames)`, fill one contiguous array per channel, and not require the
+ * GIL. If each channel of `output` is already contiguous, audio is read
+ * directly into it; otherwise, audio is read in chunks through a reusable
+ * per-thread buffer and copied into place.
+ *
+ * Must be called with the GIL held.
+ */
+template <typename ReadFunction>
+long long readIntoArray(py::array output, long long numChannels,
+                        ReadFunction read) {
+  if (!py::isinstance<py::array_t<float>>(output)) {
+    throw py::type_error("read_into expects a float32 NumPy array to read "
+                         "audio into, but got an array of type " +
+                         py::str(output.dtype()).cast<std::string>() + ".");
+  }
+
+  py::buffer_info outputInfo = output.request(/* writable= */ true);
+
+  long long channelDimension = -1;
+  if (outputInfo.ndim == 1 && numChannels == 1) {
+    channelDimension = 1;
+  } else if (outputInfo.ndim == 2) {
+    if (outputInfo.shape[0] == numChannels) {
+      channelDimension = 0;
+    } else if (outputInfo.shape[1] == numChannels) {
+      channelDimension = 1;
+    }
+  }
+
+  if (channelDimension == -1) {
+    throw std::domain_error(
+        "Expected an output buffer with shape (" + std::to_string(numChannels) +
+        ", num_frames) or (num_frames, " + std::to_string(numChannels) +
+        "), but was provided a buffer with shape " +
+        py::str(output.attr("shape")).cast<std::string>() + ".");
+  }
+
+  for (auto stride : outputInfo.strides) {
+    if (stride % (py::ssize_t)sizeof(float)) {
+      throw std::domain_error("read_into requires an output buffer whose "
+                              "samples are aligned to multiples of 4 bytes.");
+    }
+  }
+
+  long long frameDimension = outputInfo.ndim == 1 ? 0 : 1 - channelDimension;
+  long long numFrames = outputInfo.shape[frameDimension];
+  long long frameStride =
+      outputInfo.strides[frameDimension] / (long long)sizeof(float);
+  long long channelStride =
+      outputInfo.ndim == 1
+          ? 0
+          : outputInfo.strides[channelDimension] / (long long)sizeof(float);
+  float *outputPointer = static_cast<float *>(outputInfo.ptr);
+
+  float **channelPointers = (float **)alloca(numChannels * sizeof(float *));
+
+  py::gil_scoped_release release;
+  if (frameStride == 1 || numFrames <= 1) {
+    for (long long c = 0; c < numChannels; c++) {
+      channelPointers[c] = outputPointer + c * channelStride;
+    }
+    return read(channelPointers, numFrames);
+  }
+
+  // Interleaved (or otherwise strided) output must be read into contiguous
+  // channels first:
+  thread_local juce::AudioBuffer<float> chunk;
+  chunk.setSize((int)numChannels, DEFAULT_AUDIO_BUFFER_SIZE_FRAMES,
+                /* keepExistingContent= */ false, /* clearExtraSpace= */ false,
+                /* avoidReallocating= */ true);
+
+  long long framesWritten = 0;
+  while (framesWritten < numFrames) {
+    long long framesToRead = std::min(numFrames - framesWritten,
+                                      (long long)chunk.getNumSamples());
+    long long framesRead =
+        read(chunk.getArrayOfWritePointers(), framesToRead);
+
+    for (long long c = 0; c < numChannels; c++) {
+      const float *source = chunk.getReadPointer((int)c);
+      float *destination =
+          outputPointer + c * channelStride + framesWritten * frameStride;
+      for (long long i = 0; i < framesRead; i++) {
+        destination[i * frameStride] = source[i];
+      }
+    }
+
+    framesWritten += framesRead;
+    if (framesRead < framesToRead)
+      break;
+  }
+  return framesWritten;
+}
+
+} // namespace Pedalboard
@@ -0,0 +1,229 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <optional>
+#include <thread>
+#include <variant>
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include "../JuceHeader.h"
+#include "AudioFile.h"
+#include "ReadableAudioFile.h"
+
+namespace py = pybind11;
+
+namespace Pedalboard {
+
+/**
+ * Decode a section of each of the provided audio files into memory, spreading
+ * the work across a pool of native threads. All files are opened with the
+ * process-wide AudioFormatManager.
+ *
+ * `offsets` and `numFrames` (if provided) must have one entry per file. If
+ * no number of frames is given for a file, it will be read to its end.
+ *
+ * Must be called without holding the GIL.
+ */
+inline std::vector<juce::AudioBuffer<float>>
+readManyIntoBuffers(const std::vector<std::string> &filenames,
+                    const std::vector<long long> &offsets,
+                    const std::vector<std::optional<long long>> &numFrames,
+                    unsigned int numWorkers) {
+  std::shared_ptr<juce::AudioFormatManager> formatManager =
+      AudioFormatRegistry::get(false).getFormatManager();
+
+  std::vector<juce::AudioBuffer<float>> buffers(filenames.size());
+  std::atomic<size_t> nextFileIndex{0};
+  std::vector<std::exception_ptr> workerExceptions(numWorkers);
+
+  auto runWorker = [&](size_t workerIndex) {
+    try {
+      while (true) {
+        size_t i = nextFileIndex++;
+        if (i >= filenames.size())
+          break;
+
+        ReadableAudioFile file(filenames[i], formatManager);
+        file.seek(offsets[i]);
+
+        long long framesRemaining = file.getLengthInSamples() - file.tell();
+        long long framesToRead =
+            numFrames[i] ? std::min(*numFrames[i], framesRemaining)
+                         : framesRemaining;
+
+        juce::AudioBuffer<float> &buffer = buffers[i];
+        buffer.setSize(file.getNumChannels(), (int)framesToRead);
+        long long framesRead =
+            file.readInto(buffer.getArrayOfWritePointers(), framesToRead);
+        if (framesRead < framesToRead) {
+          buffer.setSize(buffer.getNumChannels(), (int)framesRead,
+                         /* keepExistingContent= */ true,
+                         /* clearExtraSpace= */ false,
+                         /* avoidReallocating= */ true);
+        }
+      }
+    } catch (...) {
+      workerExceptions[workerIndex] = std::current_exception();
+      // Stop all other workers from picking up new files:
+      nextFileIndex = filenames.size();
+    }
+  };
+
+  std::vector<std::thread> workerThreads;
+  for (size_t i = 1; i < numWorkers; i++) {
+    workerThreads.emplace_back(runWorker, i);
+  }
+  runWorker(0);
+  for (auto &thread : workerThreads) {
+    thread.join();
+  }
+
+  for (auto &exception : workerExceptions) {
+    if (exception)
+      std::rethrow_exception(exception);
+  }
+
+  return buffers;
+}
+
+inline void init_read_many(py::module &m) {
+  m.def(
+      "read_many",
+      [](std::vector<std::string> filenames,
+         std::optional<std::vector<long long>> offsets,
+         std::optional<std::variant<long long, std::vector<long long>>>
+             numFrames,
+         std::optional<unsigned int> numWorkers, bool pad) -> py::object {
+        if (offsets && offsets->size() != filenames.size()) {
+          throw std::domain_error(
+              "Expected one offset per file (" +
+              std::to_string(filenames.size()) + "), but got " +
+              std::to_string(offsets->size()) + ".");
+        }
+        if (numWorkers && *numWorkers == 0) {
+          throw std::domain_error("num_workers must be at least 1.");
+        }
+
+        std::vector<long long> offsetsPerFile =
+            offsets ? *offsets : std::vector<long long>(filenames.size(), 0);
+
+        std::vector<std::optional<long long>> framesPerFile(filenames.size());
+        if (numFrames) {
+          if (auto *frames = std::get_if<long long>(&*numFrames)) {
+            framesPerFile.assign(filenames.size(), *frames);
+          } else {
+            auto &frameList = std::get<std::vector<long long>>(*numFrames);
+            if (frameList.size() != filenames.size()) {
+              throw std::domain_error(
+                  "Expected one value of num_frames per file (" +
+                  std::to_string(filenames.size()) + "), but got " +
+                  std::to_string(frameList.size()) + ".");
+            }
+            for (size_t i = 0; i < frameList.size(); i++) {
+              framesPerFile[i] = frameList[i];
+            }
+          }
+        }
+
+        for (size_t i = 0; i < filenames.size(); i++) {
+          if (framesPerFile[i] && *framesPerFile[i] < 0) {
+            throw std::domain_error("num_frames must not be negative.");
+          }
+        }
+
+        unsigned int workers =
+            numWorkers ? *numWorkers
+                       : std::max(1u, std::thread::hardware_concurrency());
+        workers = std::max(
+            1u, std::min(workers, static_cast<unsigned int>(filenames.size())));
+
+        std::vector<juce::AudioBuffer<float>> buffers;
+        {
+          py::gil_scoped_release release;
+          buffers = readManyIntoBuffers(filenames, offsetsPerFile,
+                                        framesPerFile, workers);
+        }
+
+        if (pad) {
+          long long maxChannels = 0;
+          long long maxFrames = 0;
+          for (auto &buffer : buffers) {
+            maxChannels = std::max(maxChannels, (long long)buffer.getNumChannels());
+            maxFrames = std::max(maxFrames, (long long)buffer.getNumSamples());
+          }
+
+          py::array_t<float> output(
+              {(long long)buffers.size(), maxChannels, maxFrames});
+          float *outputPointer = static_cast<float *>(output.request().ptr);
+          {
+            py::gil_scoped_release release;
+            std::memset(outputPointer, 0,
+                        sizeof(float) * buffers.size() * maxChannels *
+                            maxFrames);
+            for (size_t i = 0; i < buffers.size(); i++) {
+              for (int c = 0; c < buffers[i].getNumChannels(); c++) {
+                std::memcpy(outputPointer +
+                                ((i * maxChannels) + c) * maxFrames,
+                            buffers[i].getReadPointer(c),
+                            sizeof(float) * buffers[i].getNumSamples());
+              }
+            }
+          }
+          return std::move(output);
+        }
+
+        py::list outputs;
+        for (auto &buffer : buffers) {
+          outputs.append(copyJuceBufferIntoPyArray(
+              buffer, ChannelLayout::NotInterleaved, 0));
+        }
+        return std::move(outputs);
+      },
+      R"(
+Read many audio files at once, decoding them in parallel on a pool of native
+threads without holding Python's Global Interpreter Lock. This is much faster
+than opening each file with :class:`AudioFile` in a loop, especially when
+reading many short files (i.e.: in a data loader).
+
+``offsets`` may contain the frame to start reading from in each file (by
+default, the start of the file), and ``num_frames`` may be either a single
+number of frames to read from every file or one number per file. If
+``num_frames`` is not provided, each file is read until its end; files that end
+before ``num_frames`` will return fewer frames.
+
+By default, a list of ``float32`` arrays (each with shape
+``(num_channels, num_frames)``, just like :py:meth:`ReadableAudioFile.read`)
+is returned in the same order as ``filenames``. If ``pad`` is ``True``, a single
+array of shape ``(num_files, max_num_channels, max_num_frames)`` is returned
+instead, with shorter files (or files with fewer channels) padded with silence.
+
+*Introduced in v0.9.0.*
+)",
+      py::arg("filenames"), py::arg("offsets") = py::none(),
+      py::arg("num_frames") = py::none(), py::arg("num_workers") = py::none(),
+      py::arg("pad") = false);
+}
+
+} // namespace Pedalboard
@@ -17,8 +17,10 @@
 
 #pragma once
 
+#include <limits>
 #include <mutex>
 #include <optional>
+#include <thread>
 
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
@@ -28,11 +30,21 @@
 #include "../juce_overrides/juce_PatchedMP3AudioFormat.h"
 #include "AudioFile.h"
 #include "PythonInputStream.h"
+#include "PythonMemoryInputStream.h"
+#include "ReadAheadBuffer.h"
+#include "ReadIntoArray.h"
+#include "SampleConversion.h"
 
 namespace py = pybind11;
 
 namespace Pedalboard {
 
+/**
+ * The fewest frames that each thread decodes when reading in parallel; for
+ * shorter reads, the cost of opening another reader outweighs the benefit.
+ */
+static constexpr long long MIN_PARALLEL_READ_FRAMES_PER_THREAD = 1 << 18;
+
 inline long long parseNumSamples(std::variant<double, long long> numSamples) {
   // Unfortunately, std::visit cannot be used here due to macOS version
   // issues: https://stackoverflow.com/q/52310835/679081
@@ -60,9 +72,20 @@ class ReadableAudioFile
     : public AudioFile,
       public std::enable_shared_from_this<ReadableAudioFile> {
 public:
-  ReadableAudioFile(std::string filename) : filename(filename) {
-    registerPedalboardAudioFormats(formatManager, false);
-
+  ReadableAudioFile(std::string filename, bool memoryMap = false)
+      : ReadableAudioFile(
+            filename,
+            AudioFormatRegistry::get(false).getFormatManager(), memoryMap) {}
+
+  /**
+   * Open the provided file using an existing AudioFormatManager, which may
+   * be shared with other ReadableAudioFile objects to avoid the cost of
+   * creating every audio format for each file.
+   */
+  ReadableAudioFile(std::string filename,
+                    std::shared_ptr<juce::AudioFormatManager> formatManager,
+                    bool memoryMap = false)
+      : formatManager(formatManager), filename(filename) {
     juce::File file(filename);
 
     if (!file.existsAsFile()) {
@@ -70,22 +93,40 @@ public:
           "Failed to open audio file: file does not exist: " + filename);
     }
 
+    if (memoryMap) {
+      openMemoryMapped(file);
+    }
+
     // createReaderFor(juce::File) is fast, as it only looks at file extension:
-    reader.reset(formatManager.createReaderFor(file));
+    if (!reader) {
+      reader.reset(formatManager->createReaderFor(file));
+    }
     if (!reader) {
       // This is slower but more thorough:
-      reader.reset(formatManager.createReaderFor(file.createInputStream()));
+      reader.reset(formatManager->createReaderFor(file.createInputStream()));
     }
 
     if (!reader)
       throw std::domain_error("Failed to open audio file: file \"" + filename +
                               "\" does not seem to contain audio data in a "
                               "known or supported format.");
+    statistics->setFormat(reader->getFormatName().toStdString());
   }
 
-  ReadableAudioFile(std::unique_ptr<PythonInputStream> inputStream) {
-    registerPedalboardAudioFormats(formatManager, false);
+  /**
+   * Wrap an already-opened reader for the provided file.
+   */
+  ReadableAudioFile(std::string filename,
+                    std::unique_ptr<juce::AudioFormatReader> reader,
+                    std::shared_ptr<juce::AudioFormatManager> formatManager)
+      : formatManager(formatManager), filename(filename),
+        reader(std::move(reader)) {
+    statistics->setFormat(this->reader->getFormatName().toStdString());
+  }
 
+  ReadableAudioFile(std::unique_ptr<PythonInputStream> inputStream)
+      : formatManager(AudioFormatRegistry::get(false).getFormatManager()) {
+    inputStream->setStatistics(statistics);
     if (!inputStream->isSeekable()) {
       PythonException::raise();
       throw std::domain_error("Failed to open audio file-like object: input "
@@ -96,13 +137,21 @@ public:
 
     auto originalStreamPosition = inputStream->getPosition();
 
-    if (!reader) {
-      for (int i = 0; i < formatManager.getNumKnownFormats(); i++) {
-        auto *af = formatManager.getKnownFormat(i);
+    // If the file-like object has a name, try the format that most recently
+    // opened a stream with the same extension first:
+    juce::String extension;
+    if (auto streamName = inputStream->getFilename()) {
+      extension = juce::File::createFileWithoutCheckingPath(*streamName)
+                      .getFileExtension();
+    }
 
+    AudioFormatRegistry &registry = AudioFormatRegistry::get(false);
+    if (!reader) {
+      for (auto *af : registry.getFormatsToProbe(extension)) {
         if (auto *r = af->createReaderFor(inputStream.get(), false)) {
           inputStream.release();
           reader.reset(r);
+          registry.recordProbedFormat(extension, af);
           break;
         }
 
@@ -160,6 +209,45 @@ public:
     }
 
     PythonException::raise();
+    statistics->setFormat(reader->getFormatName().toStdString());
+  }
+
+  /**
+   * Open an audio file stored in memory (i.e.: in a Python bytes object).
+   * As the data is already in memory, decoding never needs to acquire the
+   * GIL, and the data is never copied.
+   *
+   * Must be called with the GIL held.
+   */
+  ReadableAudioFile(std::unique_ptr<PythonMemoryInputStream> inputStream)
+      : formatManager(AudioFormatRegistry::get(false).getFormatManager()) {
+    bool isEmpty = inputStream->getDataSize() == 0;
+
+    {
+      py::gil_scoped_release release;
+      AudioFormatRegistry &registry = AudioFormatRegistry::get(false);
+      for (auto *af : registry.getFormatsToProbe(juce::String())) {
+        if (auto *r = af->createReaderFor(inputStream.get(), false)) {
+          inputStream.release();
+          reader.reset(r);
+          break;
+        }
+        inputStream->setPosition(0);
+      }
+    }
+
+    if (!reader) {
+      if (isEmpty) {
+        throw std::domain_error(
+            "Failed to open audio file from memory: the provided buffer is "
+            "empty.");
+      }
+      throw std::domain_error("Failed to open audio file from memory: the "
+                              "provided buffer does not seem to contain audio "
+                              "data in a known or supported format.");
+    }
+
+    statistics->setFormat(reader->getFormatName().toStdString());
   }
 
   std::variant<double, long> getSampleRate() const {
@@ -241,7 +329,11 @@ public:
   }
 
   py::array_t<float, py::array::c_style>
-  read(std::variant<double, long long> numSamplesVariant) {
+  read(std::variant<double, long long> numSamplesVariant,
+       unsigned int numThreads = 1) {
+    if (numThreads < 1)
+      throw std::domain_error("num_threads must be at least 1.");
+
     long long numSamples = parseNumSamples(numSamplesVariant);
 
     if (numSamples == 0)
@@ -251,115 +343,287 @@ public:
           "pass a number of frames to read (available from the 'frames' "
           "attribute).");
 
-    const juce::ScopedLock scopedLock(objectLock);
-    if (!reader)
-      throw std::runtime_error("I/O operation on a closed file.");
+    // This lock is held for the entire read (so the read position can't
+    // change underneath us) but isn't needed by the prefetching thread:
+    const juce::ScopedLock readAheadScopedLock(readAheadLock);
 
     // Allocate a buffer to return of up to numSamples:
-    long long numChannels = reader->numChannels;
-    numSamples =
-        std::min(numSamples, (reader->lengthInSamples +
-                              (lengthCorrection ? *lengthCorrection : 0)) -
-                                 currentPosition);
+    long long numChannels;
+    {
+      const juce::ScopedLock scopedLock(objectLock);
+      if (!reader)
+        throw std::runtime_error("I/O operation on a closed file.");
+
+      numChannels = reader->numChannels;
+      numSamples = std::min(numSamples, getLengthInSamples() - currentPosition);
+    }
     py::array_t<float> buffer =
         py::array_t<float>({(long long)numChannels, (long long)numSamples});
 
-    long long numSamplesToKeep = numSamples;
-
     py::buffer_info outputInfo = buffer.request();
 
+    float **channelPointers = (float **)alloca(numChannels * sizeof(float *));
+    for (long long c = 0; c < numChannels; c++) {
+      channelPointers[c] = ((float *)outputInfo.ptr) + (numSamples * c);
+    }
+
+    long long numSamplesToKeep;
     {
       py::gil_scoped_release release;
+      numSamplesToKeep =
+          numThreads > 1
+              ? readIntoInParallel(channelPointers, numSamples, numThreads)
+              : readInto(channelPointers, numSamples);
+    }
 
-      // If the file being read does not have enough content, it _should_ pad
-      // the rest of the array with zeroes. Unfortunately, this does not seem to
-      // be true in practice, so we pre-zero the array to be returned here:
-      std::memset((void *)outputInfo.ptr, 0,
-                  numChannels * numSamples * sizeof(float));
+    if (numSamplesToKeep < numSamples) {
+      buffer.resize({(long long)numChannels, (long long)numSamplesToKeep});
+    }
 
-      float **channelPointers = (float **)alloca(numChannels * sizeof(float *));
-      for (long long c = 0; c < numChannels; c++) {
-        channelPointers[c] = ((float *)outputInfo.ptr) + (numSamples * c);
+    return buffer;
+  }
+
+  /**
+   * Read up to numSamples frames of audio into the provided channel pointers
+   * (one per channel in this file, each with room for numSamples floats),
+   * advancing the current read position. Returns the number of frames
+   * actually read, which may be fewer than requested at the end of the file.
+   *
+   * If prefetch_frames is set, audio is returned from (and decoded ahead of
+   * time into) a buffer filled by a background thread.
+   *
+   * This method does not require the GIL to be held.
+   */
+  long long readInto(float **channelPointers, long long numSamples) {
+    const juce::ScopedLock readAheadScopedLock(readAheadLock);
+
+    long long position;
+    long long numChannels;
+    {
+      const juce::ScopedLock scopedLock(objectLock);
+      if (!reader)
+        throw std::runtime_error("I/O operation on a closed file.");
+
+      if (prefetchFrames == 0) {
+        long long samplesRead =
+            decodeInto(*reader, channelPointers, currentPosition, numSamples);
+        currentPosition += samplesRead;
+        return samplesRead;
       }
 
-      if (reader->usesFloatingPointData || reader->bitsPerSample == 32) {
-        auto readResult = reader->read(channelPointers, numChannels,
-                                       currentPosition, numSamples);
-        PythonException::raise();
+      position = currentPosition;
+      numChannels = reader->numChannels;
+      numSamples = std::min(numSamples, getLengthInSamples() - position);
+    }
 
-        juce::int64 samplesRead = numSamples;
-        if (juce::AudioFormatReaderWithPosition *positionAware =
-                dynamic_cast<juce::AudioFormatReaderWithPosition *>(
-                    reader.get())) {
-          samplesRead = positionAware->getCurrentPosition() - currentPosition;
-        }
+    // Prefetched audio is only usable if nothing else has moved the read
+    // position since the last read (i.e.: a memory-mapped view):
+    if (readAhead && readAheadPosition != position) {
+      readAhead.reset();
+    }
 
-        bool hitEndOfFile =
-            (samplesRead + currentPosition) == reader->lengthInSamples;
+    if (!readAhead) {
+      {
+        const juce::ScopedLock scopedLock(objectLock);
+        decodeAheadPosition = position;
+      }
+      readAheadPosition = position;
+      readAhead = std::make_unique<ReadAheadBuffer>(
+          numChannels, prefetchFrames,
+          [this](float **output, long long numFrames) {
+            return decodeAhead(output, numFrames);
+          });
+    }
 
-        // We read some data, but not as much as we asked for!
-        // This will only happen for lossy, header-optional formats
-        // like MP3.
-        if (samplesRead < numSamples || hitEndOfFile) {
-          lengthCorrection =
-              (samplesRead + currentPosition) - reader->lengthInSamples;
-        } else if (!readResult) {
-          throwReadError(currentPosition, numSamples, samplesRead);
-        }
+    long long samplesRead =
+        readAhead->read(channelPointers, std::max(0LL, numSamples));
+    readAheadPosition += samplesRead;
 
-        numSamplesToKeep = samplesRead;
-      } else {
-        // If the audio is stored in an integral format, read it as integers
-        // and do the floating-point conversion ourselves to work around
-        // floating-point imprecision in JUCE when reading formats smaller than
-        // 32-bit (i.e.: 16-bit audio is off by about 0.003%)
-        auto readResult =
-            reader->readSamples((int **)channelPointers, numChannels, 0,
-                                currentPosition, numSamples);
-        PythonException::raise();
-        if (!readResult) {
-          throwReadError(currentPosition, numSamples);
-        }
+    const juce::ScopedLock scopedLock(objectLock);
+    currentPosition = position + samplesRead;
+    return samplesRead;
+  }
 
-        // When converting 24-bit, 16-bit, or 8-bit data from int to float,
-        // the values provided by the above read() call are shifted left
-        // (such that the least significant bits are all zero)
-        // JUCE will then divide these values by 0x7FFFFFFF, even though
-        // the least significant bits are zero, effectively losing precision.
-        // Instead, here we set the scale factor appropriately.
-        int maxValueAsInt;
-        switch (reader->bitsPerSample) {
-        case 24:
-          maxValueAsInt = 0x7FFFFF00;
-          break;
-        case 16:
-          maxValueAsInt = 0x7FFF0000;
-          break;
-        case 8:
-          maxValueAsInt = 0x7F000000;
-          break;
-        default:
-          throw std::runtime_error("Not sure how to convert data from " +
-                                   std::to_string(reader->bitsPerSample) +
-                                   " bits per sample to floating point!");
-        }
-        float scaleFactor = 1.0f / static_cast<float>(maxValueAsInt);
+  /**
+   * Like readInto, but split the read into up to numThreads segments, each of
+   * which is decoded concurrently by its own reader of the same file. Only
+   * possible for files opened by filename whose audio can be decoded from
+   * any point without decoding what came before (i.e.: PCM audio in WAV and
+   * AIFF files, or FLAC files, whose frames are independent). Falls back to
+   * readInto in all other cases, or if prefetching is enabled.
+   *
+   * This method does not require the GIL to be held.
+   */
+  long long readIntoInParallel(float **channelPointers, long long numSamples,
+                               unsigned int numThreads) {
+    const juce::ScopedLock readAheadScopedLock(readAheadLock);
+    const juce::ScopedLock scopedLock(objectLock);
+    if (!reader)
+      throw std::runtime_error("I/O operation on a closed file.");
+
+    const long long startPosition = currentPosition;
+    numSamples = std::max(
+        0LL, std::min(numSamples, getLengthInSamples() - startPosition));
+    long long numSegments =
+        std::min((long long)numThreads,
+                 numSamples / MIN_PARALLEL_READ_FRAMES_PER_THREAD);
+    if (numSegments < 2 || prefetchFrames > 0 || !supportsParallelReads())
+      return readInto(channelPointers, numSamples);
+
+    // Start each segment at the beginning of a FLAC frame (if possible), so
+    // that no frame is decoded by more than one reader:
+    std::vector<long long> segmentStarts = {startPosition};
+    for (long long i = 1; i < numSegments; i++) {
+      long long target = startPosition + (numSamples * i) / numSegments;
+      segmentStarts.push_back(std::max(
+          segmentStarts.back(),
+          (long long)juce::PatchedFlacAudioFormat::getStartOfFrameContaining(
+              reader.get(), target)));
+    }
+    segmentStarts.push_back(startPosition + numSamples);
 
+    const long long numChannels = reader->numChannels;
+    std::vector<long long> samplesRead(numSegments, 0);
+    std::vector<std::exception_ptr> segmentExceptions(numSegments);
+
+    auto decodeSegment = [&](long long segment) {
+      try {
+        long long segmentStart = segmentStarts[segment];
+        long long segmentLength = segmentStarts[segment + 1] - segmentStart;
+        float **segmentPointers =
+            (float **)alloca(numChannels * sizeof(float *));
         for (long long c = 0; c < numChannels; c++) {
-          juce::FloatVectorOperations::convertFixedToFloat(
-              channelPointers[c], (const int *)channelPointers[c], scaleFactor,
-              static_cast<int>(numSamples));
+          segmentPointers[c] =
+              channelPointers[c] + (segmentStart - startPosition);
+        }
+
+        // The first segment continues from where this file's reader already
+        // is; every other segment gets a reader of its own:
+        if (segment == 0) {
+          samplesRead[segment] = decodeInto(*reader, segmentPointers,
+                                            segmentStart, segmentLength);
+          return;
         }
+
+        std::unique_ptr<juce::AudioFormatReader> segmentReader(
+            formatManager->createReaderFor(juce::File(filename)));
+        if (!segmentReader)
+          throw std::runtime_error("Failed to reopen audio file \"" +
+                                   filename + "\" to read it in parallel.");
+        samplesRead[segment] = decodeInto(*segmentReader, segmentPointers,
+                                          segmentStart, segmentLength);
+      } catch (...) {
+        segmentExceptions[segment] = std::current_exception();
       }
+    };
+
+    std::vector<std::thread> segmentThreads;
+    for (long long i = 1; i < numSegments; i++) {
+      segmentThreads.emplace_back(decodeSegment, i);
+    }
+    decodeSegment(0);
+    for (auto &thread : segmentThreads) {
+      thread.join();
     }
 
-    currentPosition += numSamplesToKeep;
+    for (auto &exception : segmentExceptions) {
+      if (exception)
+        std::rethrow_exception(exception);
+    }
 
-    if (numSamplesToKeep < numSamples) {
-      buffer.resize({(long long)numChannels, (long long)numSamplesToKeep});
+    // Only return audio up to the first segment that came up short:
+    long long totalSamplesRead = 0;
+    for (long long i = 0; i < numSegments; i++) {
+      totalSamplesRead += samplesRead[i];
+      if (samplesRead[i] < segmentStarts[i + 1] - segmentStarts[i])
+        break;
     }
 
-    return buffer;
+    currentPosition = startPosition + totalSamplesRead;
+    return totalSamplesRead;
+  }
+
+  /**
+   * The number of frames decoded ahead of time by a background thread, or 0
+   * if prefetching is disabled. Changing this discards any prefetched audio.
+   */
+  long long getPrefetchFrames() const {
+    const juce::ScopedLock scopedLock(objectLock);
+    return prefetchFrames;
+  }
+
+  void setPrefetchFrames(long long numFrames) {
+    if (numFrames < 0)
+      throw std::domain_error("prefetch_frames must not be negative.");
+    if (numFrames > std::numeric_limits<int>::max())
+      throw std::domain_error("prefetch_frames is too large.");
+
+    const juce::ScopedLock readAheadScopedLock(readAheadLock);
+    {
+      const juce::ScopedLock scopedLock(objectLock);
+      if (!reader)
+        throw std::runtime_error("I/O operation on a closed file.");
+
+      // Reading from a Python file-like object requires the GIL, which the
+      // consumer may be holding while waiting for the prefetching thread:
+      if (numFrames > 0 && getPythonInputStream())
+        throw std::domain_error(
+            "prefetch_frames is not supported when reading from a Python "
+            "file-like object.");
+    }
+
+    readAhead.reset();
+
+    const juce::ScopedLock scopedLock(objectLock);
+    prefetchFrames = numFrames;
+  }
+
+  /**
+   * Like read(), but if this file is memory-mapped and its samples are
+   * stored on disk as native-endian float32, return a read-only view
+   * directly into the mapped file rather than a copy. (This view will keep
+   * the mapping alive, even if this file is closed.)
+   */
+  py::array readPreferringView(std::variant<double, long long> numSamplesVariant,
+                               unsigned int numThreads = 1) {
+    long long numSamples = parseNumSamples(numSamplesVariant);
+    const juce::ScopedLock readAheadScopedLock(readAheadLock);
+
+    {
+      const juce::ScopedLock scopedLock(objectLock);
+      if (reader && numSamples != 0 && floatSampleMapping) {
+        long long numChannels = reader->numChannels;
+        numSamples = std::max(
+            0LL, std::min(numSamples, getLengthInSamples() - currentPosition));
+
+        const float *firstSample =
+            reinterpret_cast<const float *>(
+                static_cast<const char *>(floatSampleMapping->getData()) +
+                floatSampleDataOffset) +
+            (currentPosition * numChannels);
+
+        // Keep the mapping alive for as long as the returned view exists:
+        py::capsule mappingOwner(
+            new std::shared_ptr<juce::MemoryMappedFile>(floatSampleMapping),
+            [](void *mapping) {
+              delete static_cast<std::shared_ptr<juce::MemoryMappedFile> *>(
+                  mapping);
+            });
+
+        // Samples are interleaved on disk, so each channel of the returned
+        // (channels, samples) view is strided:
+        py::array_t<float> view(
+            {numChannels, numSamples},
+            {(long long)sizeof(float), (long long)(sizeof(float) * numChannels)},
+            firstSample, mappingOwner);
+        view.attr("setflags")(py::arg("write") = false);
+
+        currentPosition += numSamples;
+        return view;
+      }
+    }
+
+    return read(numSamplesVariant, numThreads);
   }
 
   py::array readRaw(std::variant<double, long long> numSamplesVariant) {
@@ -371,25 +635,36 @@ public:
           "pass a number of frames to read (available from the 'frames' "
           "attribute).");
 
+    const juce::ScopedLock readAheadScopedLock(readAheadLock);
+    bool usesFloatingPointData;
+    {
+      const juce::ScopedLock scopedLock(objectLock);
+      if (!reader)
+        throw std::runtime_error("I/O operation on a closed file.");
+      usesFloatingPointData = reader->usesFloatingPointData;
+    }
+
+    if (usesFloatingPointData)
+      return readPreferringView(numSamples);
+
+    // Raw integer reads bypass (and invalidate) any prefetched audio:
+    readAhead.reset();
+
     const juce::ScopedLock scopedLock(objectLock);
     if (!reader)
       throw std::runtime_error("I/O operation on a closed file.");
 
-    if (reader->usesFloatingPointData) {
-      return read(numSamples);
-    } else {
-      switch (reader->bitsPerSample) {
-      case 32:
-        return readInteger<int>(numSamples);
-      case 16:
-        return readInteger<short>(numSamples);
-      case 8:
-        return readInteger<char>(numSamples);
-      default:
-        throw std::runtime_error("Not sure how to read " +
-                                 std::to_string(reader->bitsPerSample) +
-                                 "-bit audio data!");
-      }
+    switch (reader->bitsPerSample) {
+    case 32:
+      return readInteger<int>(numSamples);
+    case 16:
+      return readInteger<short>(numSamples);
+    case 8:
+      return readInteger<char>(numSamples);
+    default:
+      throw std::runtime_error("Not sure how to read " +
+                               std::to_string(reader->bitsPerSample) +
+                               "-bit audio data!");
     }
   }
 
@@ -413,6 +688,7 @@ public:
 
     {
       py::gil_scoped_release release;
+      IOTimer timer(statistics.get(), &IOCounters::decodeNanoseconds);
       if (reader->bitsPerSample > 16) {
         if (sizeof(SampleType) < 4) {
           throw std::runtime_error("Output array not wide enough to store " +
@@ -467,19 +743,23 @@ public:
           for (long long c = 0; c < numChannels; c++) {
             SampleType *outputChannelPointer =
                 (((SampleType *)outputInfo.ptr) + (c * numSamples));
-            for (long long i = 0; i < samplesToRead; i++) {
-              outputChannelPointer[startSample + i] = intBuffers[c][i] >> shift;
-            }
+            convertFixedToInteger(intBuffers[c].data(),
+                                  outputChannelPointer + startSample,
+                                  (unsigned int)samplesToRead, shift);
           }
         }
       }
     }
 
+    statistics->add(&IOCounters::framesDecoded, numSamples);
     currentPosition += numSamples;
     return buffer;
   }
 
   void seek(long long targetPosition) {
+    const juce::ScopedLock readAheadScopedLock(readAheadLock);
+    readAhead.reset();
+
     const juce::ScopedLock scopedLock(objectLock);
     if (!reader)
       throw std::runtime_error("I/O operation on a closed file.");
@@ -503,8 +783,12 @@ public:
   }
 
   void close() {
+    const juce::ScopedLock readAheadScopedLock(readAheadLock);
+    readAhead.reset();
+
     const juce::ScopedLock scopedLock(objectLock);
     reader.reset();
+    floatSampleMapping.reset();
   }
 
   bool isClosed() const {
@@ -512,6 +796,12 @@ public:
     return !reader;
   }
 
+  bool isMemoryMapped() const {
+    const juce::ScopedLock scopedLock(objectLock);
+    return reader &&
+           dynamic_cast<juce::MemoryMappedAudioFormatReader *>(reader.get());
+  }
+
   bool isSeekable() const {
     const juce::ScopedLock scopedLock(objectLock);
 
@@ -539,8 +829,98 @@ public:
     return true;
   }
 
+  /**
+   * Make this file's length exact (if it isn't already), by scanning only
+   * the headers of each of its frames if the reader supports it (i.e.: MP3),
+   * or by decoding the entire file if not. Returns the exact length.
+   */
+  long long computeExactDuration() {
+    py::gil_scoped_release release;
+    const juce::ScopedLock readAheadScopedLock(readAheadLock);
+    const juce::ScopedLock scopedLock(objectLock);
+    if (!reader)
+      throw std::runtime_error("I/O operation on a closed file.");
+
+    if (exactDurationKnown())
+      return getLengthInSamples();
+
+    if (juce::AudioFormatReaderWithPosition *approximateLengthReader =
+            dynamic_cast<juce::AudioFormatReaderWithPosition *>(reader.get())) {
+      bool found = approximateLengthReader->findExactLength();
+      raisePendingPythonException();
+      if (found)
+        return getLengthInSamples();
+    }
+
+    // Decode (and discard) audio until we hit the end of the file, which
+    // corrects its length without moving the current read position:
+    juce::AudioBuffer<float> discardedAudio(reader->numChannels,
+                                            DEFAULT_AUDIO_BUFFER_SIZE_FRAMES);
+    long long position = 0;
+    while (!exactDurationKnown()) {
+      long long samplesRead =
+          decodeInto(*reader, discardedAudio.getArrayOfWritePointers(),
+                     position, discardedAudio.getNumSamples());
+      if (samplesRead == 0)
+        break;
+      position += samplesRead;
+    }
+
+    return getLengthInSamples();
+  }
+
   std::optional<std::string> getFilename() const { return filename; }
 
+  /**
+   * If this file's decoder can produce audio at a fraction of the file's
+   * sample rate more cheaply than by resampling it (i.e.: MP3), return a new
+   * ReadableAudioFile that decodes the same file at the lowest such sample
+   * rate that is still at least minimumSampleRate. Otherwise, return nullptr.
+   *
+   * This is only possible for files opened by filename that have not yet been
+   * read from or seeked.
+   */
+  std::shared_ptr<ReadableAudioFile>
+  openDownsampled(double minimumSampleRate) const {
+    const juce::ScopedLock scopedLock(objectLock);
+    if (!reader || filename.empty() || currentPosition != 0)
+      return nullptr;
+
+    juce::PatchedMP3AudioFormat *mp3Format = nullptr;
+    for (int i = 0; i < formatManager->getNumKnownFormats(); i++) {
+      if (auto *format = dynamic_cast<juce::PatchedMP3AudioFormat *>(
+              formatManager->getKnownFormat(i))) {
+        mp3Format = format;
+        break;
+      }
+    }
+    if (!mp3Format || reader->getFormatName() != mp3Format->getFormatName())
+      return nullptr;
+
+    int downsamplingFactor = 4;
+    while (downsamplingFactor > 1 &&
+           reader->sampleRate / downsamplingFactor < minimumSampleRate) {
+      downsamplingFactor /= 2;
+    }
+    if (downsamplingFactor == 1)
+      return nullptr;
+
+    std::unique_ptr<juce::FileInputStream> inputStream =
+        juce::File(filename).createInputStream();
+    if (!inputStream)
+      return nullptr;
+
+    std::unique_ptr<juce::AudioFormatReader> downsampledReader(
+        mp3Format->createDownsampledReaderFor(
+            inputStream.release(), /* deleteStreamIfOpeningFails= */ true,
+            downsamplingFactor));
+    if (!downsampledReader)
+      return nullptr;
+
+    return std::make_shared<ReadableAudioFile>(
+        filename, std::move(downsampledReader), formatManager);
+  }
+
   PythonInputStream *getPythonInputStream() const {
     if (!filename.empty()) {
       return nullptr;
@@ -550,8 +930,9 @@ public:
     }
 
     // the AudioFormatReader retains exclusive ownership over the input stream,
-    // so we have to cast here instead of holding a shared_ptr:
-    return (PythonInputStream *)reader->input;
+    // so we have to cast here instead of holding a shared_ptr. (The stream
+    // may also be a PythonMemoryInputStream, if reading from a buffer.)
+    return dynamic_cast<PythonInputStream *>(reader->input);
   }
 
   std::shared_ptr<ReadableAudioFile> enter() { return shared_from_this(); }
@@ -566,6 +947,183 @@ public:
   }
 
 private:
+  /**
+   * Called on the prefetching thread to decode the next chunk of audio.
+   */
+  long long decodeAhead(float **channelPointers, long long numSamples) {
+    const juce::ScopedLock scopedLock(objectLock);
+    if (!reader)
+      return 0;
+
+    long long samplesRead =
+        decodeInto(*reader, channelPointers, decodeAheadPosition, numSamples);
+    decodeAheadPosition += samplesRead;
+    return samplesRead;
+  }
+
+  /**
+   * Whether reads can be split up between several readers of this file (see
+   * readIntoInParallel). Must be called with objectLock held.
+   */
+  bool supportsParallelReads() const {
+    if (filename.empty() || getPythonInputStream())
+      return false;
+
+    juce::String formatName = reader->getFormatName();
+    return formatName == "WAV file" || formatName == "AIFF file" ||
+           formatName == "FLAC file";
+  }
+
+  /**
+   * Decode up to numSamples frames starting at startPosition from the
+   * provided reader (either this file's reader, or another reader of the same
+   * file), without moving the current read position. Must be called with
+   * objectLock held.
+   */
+  long long decodeInto(juce::AudioFormatReader &source, float **channelPointers,
+                       long long startPosition, long long numSamples) {
+    IOTimer timer(statistics.get(), &IOCounters::decodeNanoseconds);
+    long long numChannels = source.numChannels;
+    numSamples = std::min(numSamples, getLengthInSamples() - startPosition);
+    long long numSamplesToKeep = numSamples;
+
+    // If the file being read does not have enough content, it _should_ pad
+    // the rest of the array with zeroes. Unfortunately, this does not seem to
+    // be true in practice, so we pre-zero the array to be returned here:
+    for (long long c = 0; c < numChannels; c++) {
+      std::memset((void *)channelPointers[c], 0, numSamples * sizeof(float));
+    }
+
+    if (source.usesFloatingPointData || source.bitsPerSample == 32) {
+      auto readResult = source.read(channelPointers, numChannels,
+                                    startPosition, numSamples);
+      raisePendingPythonException();
+
+      juce::int64 samplesRead = numSamples;
+      if (juce::AudioFormatReaderWithPosition *positionAware =
+              dynamic_cast<juce::AudioFormatReaderWithPosition *>(&source)) {
+        samplesRead = positionAware->getCurrentPosition() - startPosition;
+      }
+
+      bool hitEndOfFile =
+          (samplesRead + startPosition) == source.lengthInSamples;
+
+      // We read some data, but not as much as we asked for!
+      // This will only happen for lossy, header-optional formats
+      // like MP3. (Other readers of this file, used for parallel reads,
+      // leave the length of this file alone.)
+      if (samplesRead < numSamples || hitEndOfFile) {
+        if (&source == reader.get())
+          lengthCorrection =
+              (samplesRead + startPosition) - source.lengthInSamples;
+      } else if (!readResult) {
+        throwReadError(startPosition, numSamples, samplesRead);
+      }
+
+      numSamplesToKeep = samplesRead;
+    } else {
+      // If the audio is stored in an integral format, read it as integers
+      // and do the floating-point conversion ourselves to work around
+      // floating-point imprecision in JUCE when reading formats smaller than
+      // 32-bit (i.e.: 16-bit audio is off by about 0.003%)
+      auto readResult =
+          source.readSamples((int **)channelPointers, numChannels, 0,
+                             startPosition, numSamples);
+      raisePendingPythonException();
+      if (!readResult) {
+        throwReadError(startPosition, numSamples);
+      }
+
+      // When converting 24-bit, 16-bit, or 8-bit data from int to float,
+      // the values provided by the above read() call are shifted left
+      // (such that the least significant bits are all zero)
+      // JUCE will then divide these values by 0x7FFFFFFF, even though
+      // the least significant bits are zero, effectively losing precision.
+      // Instead, here we set the scale factor appropriately.
+      int maxValueAsInt;
+      switch (source.bitsPerSample) {
+      case 24:
+        maxValueAsInt = 0x7FFFFF00;
+        break;
+      case 16:
+        maxValueAsInt = 0x7FFF0000;
+        break;
+      case 8:
+        maxValueAsInt = 0x7F000000;
+        break;
+      default:
+        throw std::runtime_error("Not sure how to convert data from " +
+                                 std::to_string(source.bitsPerSample) +
+                                 " bits per sample to floating point!");
+      }
+      float scaleFactor = 1.0f / static_cast<float>(maxValueAsInt);
+
+      for (long long c = 0; c < numChannels; c++) {
+        juce::FloatVectorOperations::convertFixedToFloat(
+            channelPointers[c], (const int *)channelPointers[c], scaleFactor,
+            static_cast<int>(numSamples));
+      }
+    }
+
+    statistics->add(&IOCounters::framesDecoded, numSamplesToKeep);
+    return numSamplesToKeep;
+  }
+
+  /**
+   * Try to open the provided file with a memory-mapped reader, which is only
+   * supported for some uncompressed formats (i.e.: WAV and AIFF). If
+   * successful, reads will come directly from the mapped file rather than
+   * through an input stream. Leaves `reader` empty if not possible.
+   */
+  void openMemoryMapped(const juce::File &file) {
+    juce::AudioFormat *format =
+        AudioFormatRegistry::get(false).findFormatForFileExtension(
+            file.getFileExtension());
+    if (!format)
+      return;
+
+    std::unique_ptr<juce::MemoryMappedAudioFormatReader> mappedReader(
+        format->createMemoryMappedReader(file));
+    if (!mappedReader || !mappedReader->mapEntireFile())
+      return;
+
+    reader = std::move(mappedReader);
+
+    // If the file's samples are already stored in the format we return
+    // (native-endian float32) then we can skip decoding entirely and return
+    // views into the file itself. JUCE doesn't expose where the samples
+    // start in the file, so find the WAV file's data chunk ourselves:
+    if (!reader->usesFloatingPointData || reader->bitsPerSample != 32 ||
+        juce::ByteOrder::isBigEndian())
+      return;
+
+    auto mapping = std::make_shared<juce::MemoryMappedFile>(
+        file, juce::MemoryMappedFile::readOnly);
+    const char *data = static_cast<const char *>(mapping->getData());
+    size_t size = mapping->getSize();
+    if (!data || size < 12 || std::memcmp(data, "RIFF", 4) != 0 ||
+        std::memcmp(data + 8, "WAVE", 4) != 0)
+      return;
+
+    size_t position = 12;
+    while (position + 8 <= size) {
+      size_t chunkSize = juce::ByteOrder::littleEndianInt(data + position + 4);
+      if (std::memcmp(data + position, "data", 4) == 0) {
+        size_t dataOffset = position + 8;
+        size_t expectedSize =
+            (size_t)reader->lengthInSamples * reader->numChannels * sizeof(float);
+        if (dataOffset + expectedSize <= size) {
+          floatSampleMapping = mapping;
+          floatSampleDataOffset = dataOffset;
+        }
+        return;
+      }
+
+      // Chunks are padded to an even number of bytes:
+      position += 8 + chunkSize + (chunkSize & 1);
+    }
+  }
+
   void throwReadError(long long currentPosition, long long numSamples,
                       long long samplesRead = -1) {
     std::ostringstream ss;
@@ -608,16 +1166,32 @@ private:
     // In case any of the calls above to PythonInputStream cause an exception in
     // Python, this line will re-raise those so that the Python exception is
     // visible:
-    PythonException::raise();
+    raisePendingPythonException();
 
     throw std::runtime_error(ss.str());
   }
 
-  juce::AudioFormatManager formatManager;
+  /**
+   * Only Python file-like objects can cause Python exceptions while being
+   * read, so this avoids acquiring the GIL (which the prefetching thread must
+   * never do) when reading from anything else.
+   */
+  void raisePendingPythonException() const {
+    if (getPythonInputStream())
+      PythonException::raise();
+  }
+
+  std::shared_ptr<juce::AudioFormatManager> formatManager;
   std::string filename;
   std::unique_ptr<juce::AudioFormatReader> reader;
   juce::CriticalSection objectLock;
 
+  // If this file is memory-mapped and stores native-endian float32 samples,
+  // a mapping of the whole file (and the offset of the first sample in it)
+  // used to return samples without copying them:
+  std::shared_ptr<juce::MemoryMappedFile> floatSampleMapping;
+  size_t floatSampleDataOffset = 0;
+
   int currentPosition = 0;
 
   // Certain files (notably CBR MP3 files) can report the wrong number of
@@ -627,6 +1201,23 @@ private:
   // will be greater than 0; if fewer are present, `lengthCorrection` will
   // be less than 0.
   std::optional<long long> lengthCorrection = {};
+
+  // Held for the duration of each read or seek, so that the read position
+  // can't change mid-read. Unlike objectLock, this is never needed by the
+  // prefetching thread, so it may be held while waiting for that thread.
+  // Must always be acquired before objectLock.
+  juce::CriticalSection readAheadLock;
+  long long prefetchFrames = 0;
+
+  // The read position at which the audio in readAhead starts:
+  long long readAheadPosition = 0;
+
+  // The position at which the prefetching thread will next decode audio:
+  long long decodeAheadPosition = 0;
+
+  // Declared last, so that the prefetching thread is stopped before any of
+  // the state it uses is destroyed:
+  std::unique_ptr<ReadAheadBuffer> readAhead;
 };
 
 inline py::class_<ReadableAudioFile, AudioFile,
@@ -666,19 +1257,31 @@ Pedalboard.)
 }
 
 class ResampledReadableAudioFile;
+inline std::shared_ptr<ResampledReadableAudioFile>
+createResampledReadableAudioFile(std::shared_ptr<ReadableAudioFile> audioFile,
+                                 float targetSampleRate,
+                                 ResamplingQuality quality);
 
 inline void init_readable_audio_file(
     py::module &m,
     py::class_<ReadableAudioFile, AudioFile, std::shared_ptr<ReadableAudioFile>>
         &pyReadableAudioFile) {
   pyReadableAudioFile
-      .def(py::init([](std::string filename) -> ReadableAudioFile * {
+      .def(py::init([](py::buffer buffer) -> ReadableAudioFile * {
              // This definition is only here to provide nice docstrings.
              throw std::runtime_error(
                  "Internal error: __init__ should never be called, as this "
                  "class implements __new__.");
            }),
-           py::arg("filename"))
+           py::arg("buffer"))
+      .def(py::init([](std::string filename,
+                       bool memoryMap) -> ReadableAudioFile * {
+             // This definition is only here to provide nice docstrings.
+             throw std::runtime_error(
+                 "Internal error: __init__ should never be called, as this "
+                 "class implements __new__.");
+           }),
+           py::arg("filename"), py::kw_only(), py::arg("memory_map") = false)
       .def(py::init([](py::object filelike) -> ReadableAudioFile * {
              // This definition is only here to provide nice docstrings.
              throw std::runtime_error(
@@ -686,12 +1289,22 @@ inline void init_readable_audio_file(
                  "class implements __new__.");
            }),
            py::arg("file_like"))
+      // This overload must come before the filename overload, as pybind11
+      // would otherwise convert bytes objects into filenames:
+      .def_static(
+          "__new__",
+          [](const py::object *, py::buffer buffer) {
+            return std::make_shared<ReadableAudioFile>(
+                std::make_unique<PythonMemoryInputStream>(buffer));
+          },
+          py::arg("cls"), py::arg("buffer"))
       .def_static(
           "__new__",
-          [](const py::object *, std::string filename) {
-            return std::make_shared<ReadableAudioFile>(filename);
+          [](const py::object *, std::string filename, bool memoryMap) {
+            return std::make_shared<ReadableAudioFile>(filename, memoryMap);
           },
-          py::arg("cls"), py::arg("filename"))
+          py::arg("cls"), py::arg("filename"), py::kw_only(),
+          py::arg("memory_map") = false)
       .def_static(
           "__new__",
           [](const py::object *, py::object filelike) {
@@ -706,7 +1319,9 @@ inline void init_readable_audio_file(
                 std::make_unique<PythonInputStream>(filelike));
           },
           py::arg("cls"), py::arg("file_like"))
-      .def("read", &ReadableAudioFile::read, py::arg("num_frames") = 0, R"(
+      .def("read", &ReadableAudioFile::readPreferringView,
+           py::arg("num_frames") = 0, py::kw_only(),
+           py::arg("num_threads") = 1, R"(
 Read the given number of frames (samples in each channel) from this audio file at its current position.
 
 ``num_frames`` is a required argument, as audio files can be deceptively large. (Consider that 
@@ -727,6 +1342,20 @@ in which this may occur.)
 For most (but not all) audio files, the minimum possible sample value will be ``-1.0f`` and the
 maximum sample value will be ``+1.0f``.
 
+If this file was opened with ``memory_map=True`` and stores its samples as ``float32``
+(as is common for uncompressed WAV files), the returned array will be a read-only view
+directly into the file's memory mapping instead of a copy. Opening and reading such files
+is nearly instant, and the operating system's page cache is shared between all processes
+that read the same file. Call ``.copy()`` on the returned array to get a writeable copy.
+
+If ``num_threads`` is greater than 1 and this file was opened by filename, long reads from
+WAV, AIFF, and FLAC files are split into up to ``num_threads`` segments (each at least
+262,144 frames long), which are decoded at the same time by separate readers of the same
+file. For FLAC files, segments start on frame boundaries, so no audio is decoded twice. The
+returned audio is identical to that returned with ``num_threads=1``. Reads from other formats
+(or files opened from file-like objects or memory, or with :py:attr:`prefetch_frames` set)
+ignore this argument. *Introduced in v0.9.0.*
+
 .. note::
     For convenience, the ``num_frames`` argument may be a floating-point number. However, if the
     provided number of frames contains a fractional part (i.e.: ``1.01`` instead of ``1.00``) then
@@ -756,6 +1385,32 @@ in which this may occur.)
     For convenience, the ``num_frames`` argument may be a floating-point number. However, if the
     provided number of frames contains a fractional part (i.e.: ``1.01`` instead of ``1.00``) then
     an exception will be thrown, as a fractional number of samples cannot be returned.
+)")
+      .def(
+          "read_into",
+          [](std::shared_ptr<ReadableAudioFile> file, py::array output) {
+            return readIntoArray(output, file->getNumChannels(),
+                                 [&](float **channels, long long numFrames) {
+                                   return file->readInto(channels, numFrames);
+                                 });
+          },
+          py::arg("output"),
+          R"(
+Read audio from this file at its current position directly into ``output``,
+a preallocated, writable ``float32`` :class:`numpy.ndarray`, instead of
+allocating a new array like :meth:`read` does. This allows reading many
+fixed-size windows of audio without allocating memory for each one.
+
+``output`` may be shaped either ``(num_channels, num_frames)`` or
+``(num_frames, num_channels)`` (or ``(num_frames,)`` for mono audio), and may
+be any strided view of a larger array. As many frames are read as ``output``
+can hold.
+
+Returns the number of frames written into ``output``, which will be smaller
+than the number of frames ``output`` can hold only if the end of the file was
+reached. Any remaining frames in ``output`` are left unchanged.
+
+*Introduced in v0.9.0.*
 )")
       .def("seekable", &ReadableAudioFile::isSeekable,
            "Returns True if this file is currently open and calls to seek() "
@@ -807,6 +1462,13 @@ in which this may occur.)
       .def_property_readonly("closed", &ReadableAudioFile::isClosed,
                              "True iff this file is closed (and no longer "
                              "usable), False otherwise.")
+      .def_property_readonly(
+          "memory_mapped", &ReadableAudioFile::isMemoryMapped,
+          "True iff this file was opened with ``memory_map=True`` and is "
+          "being read directly from a memory mapping. Only uncompressed "
+          "formats (i.e.: WAV and AIFF) can be memory-mapped; other files "
+          "opened with ``memory_map=True`` are read normally.\n\n*Introduced "
+          "in v0.9.0.*")
       .def_property_readonly(
           "samplerate", &ReadableAudioFile::getSampleRate,
           "The sample rate of this file in samples (per channel) per second "
@@ -834,6 +1496,24 @@ for the same :py:class:`AudioFile` object (even after calls to :meth:`seek`).
     :py:attr:`exact_duration_known` will always be equal to :py:const:`True`.
 
 *Introduced in v0.7.2.*
+)")
+      .def("compute_exact_duration", &ReadableAudioFile::computeExactDuration,
+           R"(
+Find the exact number of frames in this file (without changing the current
+read position), update :py:attr:`frames` and :py:attr:`duration` to match,
+and return it. After this call, :py:attr:`exact_duration_known` will be
+:py:const:`True`.
+
+For MP3 files without a ``Xing`` or ``Info`` header, this reads only the
+header of each MP3 frame and skips over the compressed audio in between,
+which takes a small fraction of the time required to decode the file. If the
+file's frame headers can't be followed to the end of the file (i.e.: if the
+file is corrupt), or for any other file whose duration is not exactly known,
+the entire file is decoded instead.
+
+For all other files, this returns :py:attr:`frames` immediately.
+
+*Introduced in v0.9.0.*
 )")
       .def_property_readonly("frames", &ReadableAudioFile::getLengthInSamples,
                              R"(
@@ -856,7 +1536,9 @@ of 44,100 Hz, ``frames`` will return ``441,000``.
     bitrate and size. This may result in an overestimate of the file's duration
     if there is additional data present in the file after the audio stream is finished.
 
-    If the exact number of frames in the file is required, read the entire file
+    If the exact number of frames in the file is required, call
+    :meth:`compute_exact_duration`, which quickly scans the file's frame headers
+    without decoding any audio. Alternatively, read the entire file
     first before accessing the :py:attr:`frames` or :py:attr:`duration` properties.
     This operation forces each frame to be parsed and guarantees that
     :py:attr:`frames` and :py:attr:`duration` are correct, at the expense of
@@ -894,6 +1576,23 @@ The duration of this file in seconds (``frames`` divided by ``samplerate``).
           "return a ``float32`` array, regardless of the value of this "
           "property. Use :meth:`read_raw` to read data from the file in its "
           "``file_dtype``.")
+      .def_property(
+          "prefetch_frames", &ReadableAudioFile::getPrefetchFrames,
+          &ReadableAudioFile::setPrefetchFrames,
+          R"(
+The number of frames to decode ahead of time on a background thread, or ``0``
+(the default) to decode audio only when :meth:`read` is called.
+
+When reading a file sequentially in chunks, setting this to (at least) the size
+of each chunk allows the next chunk to be decoded while the current one is being
+processed, hiding the latency of decoding. Up to two chunks of
+``prefetch_frames`` frames each are kept in memory. Any prefetched audio is
+discarded when :meth:`seek` is called.
+
+Prefetching is not supported when reading from a Python file-like object.
+
+*Introduced in v0.9.0.*
+)")
       .def(
           "resampled_to",
           [](std::shared_ptr<ReadableAudioFile> file, double targetSampleRate,
@@ -903,8 +1602,8 @@ The duration of this file in seconds (``frames`` divided by ``samplerate``).
             if (file->getSampleRateAsDouble() == targetSampleRate)
               return {file};
 
-            return {std::make_shared<ResampledReadableAudioFile>(
-                file, targetSampleRate, quality)};
+            return {createResampledReadableAudioFile(file, targetSampleRate,
+                                                     quality)};
           },
           py::arg("target_sample_rate"),
           py::arg("quality") = ResamplingQuality::WindowedSinc,
@@ -916,10 +1615,9 @@ The duration of this file in seconds (``frames`` divided by ``samplerate``).
           "v0.6.0.*");
 
   m.def("get_supported_read_formats", []() {
-    juce::AudioFormatManager manager;
-    registerPedalboardAudioFormats(manager, false);
+    juce::AudioFormatManager &manager =
+        *AudioFormatRegistry::get(false).getFormatManager();
 
-    std::vector<std::string> formatNames(manager.getNumKnownFormats());
     juce::StringArray extensions;
     for (int i = 0; i < manager.getNumKnownFormats(); i++) {
       auto *format = manager.getKnownFormat(i);
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <limits>
 #include <mutex>
 #include <optional>
 
@@ -27,6 +28,8 @@
 #include "../JuceHeader.h"
 #include "AudioFile.h"
 #include "PythonInputStream.h"
+#include "ReadAheadBuffer.h"
+#include "ReadIntoArray.h"
 #include "ReadableAudioFile.h"
 #include "StreamResampler.h"
 
@@ -46,6 +49,9 @@ static inline int inputBufferSizeFor(ResamplingQuality quality) {
     return 5;
   case ResamplingQuality::WindowedSinc:
     return 200;
+  case ResamplingQuality::Polyphase:
+    // Depends on the resampling ratio; see getInputLatency().
+    return 0;
   }
   return 0;
 }
@@ -56,9 +62,27 @@ class ResampledReadableAudioFile
 public:
   ResampledReadableAudioFile(std::shared_ptr<ReadableAudioFile> audioFile,
                              float targetSampleRate, ResamplingQuality quality)
-      : audioFile(audioFile),
-        resampler(audioFile->getSampleRateAsDouble(), targetSampleRate,
-                  audioFile->getNumChannels(), quality) {}
+      : ResampledReadableAudioFile(audioFile, audioFile, targetSampleRate,
+                                   quality) {}
+
+  /**
+   * Resample the audio decoded by `decodingFile`, which must be a separate
+   * reader of the same audio as `sourceFile` (possibly at a lower sample
+   * rate). This object is considered closed once `sourceFile` is closed.
+   */
+  ResampledReadableAudioFile(std::shared_ptr<ReadableAudioFile> sourceFile,
+                             std::shared_ptr<ReadableAudioFile> decodingFile,
+                             float targetSampleRate, ResamplingQuality quality)
+      : sourceFile(sourceFile), audioFile(decodingFile),
+        resampler(decodingFile->getSampleRateAsDouble(), targetSampleRate,
+                  decodingFile->getNumChannels(), quality),
+        sourceBuffer(decodingFile->getNumChannels(),
+                     DEFAULT_AUDIO_BUFFER_SIZE_FRAMES) {
+    // Report everything done to produce this file's audio (including any
+    // decoding by a separate decodingFile) in the source file's statistics:
+    statistics = sourceFile->statistics;
+    decodingFile->statistics = sourceFile->statistics;
+  }
 
   std::variant<double, long> getSampleRate() const {
     double integerPart;
@@ -100,7 +124,6 @@ public:
   ResamplingQuality getQuality() const { return resampler.getQuality(); }
 
   py::array_t<float> read(std::variant<double, long long> numSamplesVariant) {
-    py::gil_scoped_release release;
     long long numSamples = parseNumSamples(numSamplesVariant);
     if (numSamples == 0)
       throw std::domain_error(
@@ -109,120 +132,198 @@ public:
           "memory. Please pass a number of frames to read (available from "
           "the 'frames' attribute).");
 
-    const juce::ScopedLock scopedLock(objectLock);
+    long long numChannels = audioFile->getNumChannels();
+    py::array_t<float> buffer =
+        py::array_t<float>({(long long)numChannels, (long long)numSamples});
+    float *outputPointer = static_cast<float *>(buffer.request().ptr);
 
-    long long samplesInResampledBuffer = 0;
-    juce::AudioBuffer<float> resampledBuffer(audioFile->getNumChannels(),
-                                             numSamples);
-
-    // Any samples in the existing outputBuffer from last time
-    // should be copied into resampledBuffer:
-    int samplesToPullFromOutputBuffer =
-        std::min(outputBuffer.getNumSamples(), (int)numSamples);
-    if (samplesToPullFromOutputBuffer > 0) {
-      for (int c = 0; c < resampledBuffer.getNumChannels(); c++) {
-        resampledBuffer.copyFrom(c, 0, outputBuffer, c, 0,
-                                 samplesToPullFromOutputBuffer);
-      }
-      samplesInResampledBuffer += samplesToPullFromOutputBuffer;
-
-      // Remove the used samples from outputBuffer:
-      if (outputBuffer.getNumSamples() - samplesToPullFromOutputBuffer) {
-        for (int c = 0; c < resampledBuffer.getNumChannels(); c++) {
-          // Use std::memmove instead of copyFrom here, as copyFrom is not
-          // overlap-safe.
-          std::memmove(
-              outputBuffer.getWritePointer(c),
-              outputBuffer.getReadPointer(c, samplesToPullFromOutputBuffer),
-              (outputBuffer.getNumSamples() - samplesToPullFromOutputBuffer) *
-                  sizeof(float));
-        }
-      }
-      outputBuffer.setSize(outputBuffer.getNumChannels(),
-                           outputBuffer.getNumSamples() -
-                               samplesToPullFromOutputBuffer,
-                           /* keepExistingContent */ true);
+    float **channelPointers = (float **)alloca(numChannels * sizeof(float *));
+    for (long long c = 0; c < numChannels; c++) {
+      channelPointers[c] = outputPointer + (numSamples * c);
+    }
+
+    long long numSamplesToKeep;
+    {
+      py::gil_scoped_release release;
+      numSamplesToKeep = readInto(channelPointers, numSamples);
     }
 
-    long long inputSamplesRequired =
-        (long long)(((numSamples - samplesToPullFromOutputBuffer) *
-                     audioFile->getSampleRateAsDouble()) /
-                    resampler.getTargetSampleRate());
-
-    while (samplesInResampledBuffer < numSamples) {
-      std::optional<juce::AudioBuffer<float>> resamplerInput;
-
-      juce::AudioBuffer<float> sourceSamples;
-      if (inputSamplesRequired > 0) {
-        {
-          py::gil_scoped_acquire gil;
-          sourceSamples =
-              copyPyArrayIntoJuceBuffer(audioFile->read(inputSamplesRequired),
-                                        {ChannelLayout::NotInterleaved});
-        }
-
-        if (sourceSamples.getNumSamples() == 0) {
-          resamplerInput = {};
-        } else {
-          resamplerInput =
-              std::optional<juce::AudioBuffer<float>>(sourceSamples);
-        }
-      } else {
-        sourceSamples =
-            juce::AudioBuffer<float>(audioFile->getNumChannels(), 0);
-        resamplerInput = std::optional<juce::AudioBuffer<float>>(sourceSamples);
+    if (numSamplesToKeep < numSamples) {
+      // Pack the channels together before shrinking the array:
+      for (long long c = 1; c < numChannels; c++) {
+        std::memmove(outputPointer + (numSamplesToKeep * c),
+                     channelPointers[c], numSamplesToKeep * sizeof(float));
       }
+      buffer.resize({(long long)numChannels, (long long)numSamplesToKeep});
+    }
 
-      // TODO: Provide an alternative interface to write to the output buffer
-      juce::AudioBuffer<float> newResampledSamples =
-          resampler.process(resamplerInput);
-
-      int offsetInNewResampledSamples = 0;
-      if (newResampledSamples.getNumSamples() >
-          numSamples - samplesInResampledBuffer) {
-        int samplesToCache = newResampledSamples.getNumSamples() -
-                             (numSamples - samplesInResampledBuffer);
-        outputBuffer.setSize(newResampledSamples.getNumChannels(),
-                             samplesToCache);
-        for (int c = 0; c < outputBuffer.getNumChannels(); c++) {
-          outputBuffer.copyFrom(c, 0, newResampledSamples, c,
-                                newResampledSamples.getNumSamples() -
-                                    samplesToCache,
-                                samplesToCache);
-        }
+    return buffer;
+  }
+
+  /**
+   * Read up to numSamples frames of resampled audio into the provided channel
+   * pointers (one per channel, each with room for numSamples floats). Audio
+   * is decoded into a fixed-size buffer and resampled directly into the
+   * output, so this method does not allocate.
+   *
+   * If prefetch_frames is set, audio is returned from (and resampled ahead
+   * of time into) a buffer filled by a background thread.
+   *
+   * This method does not require the GIL to be held.
+   */
+  long long readInto(float **channelPointers, long long numSamples) {
+    const juce::ScopedLock readAheadScopedLock(readAheadLock);
+    if (prefetchFrames == 0)
+      return resampleInto(channelPointers, numSamples);
+
+    if (!readAhead) {
+      {
+        const juce::ScopedLock scopedLock(objectLock);
+        readAheadPosition = positionInTargetSampleRate;
       }
+      readAhead = std::make_unique<ReadAheadBuffer>(
+          audioFile->getNumChannels(), prefetchFrames,
+          [this](float **output, long long numFrames) {
+            return resampleInto(output, numFrames);
+          });
+    }
 
-      if (!resamplerInput && newResampledSamples.getNumSamples() == 0) {
-        resampledBuffer.setSize(resampledBuffer.getNumChannels(),
-                                samplesInResampledBuffer,
-                                /* keepExistingContent */ true);
-        break;
+    long long samplesRead = readAhead->read(channelPointers, numSamples);
+    readAheadPosition += samplesRead;
+    return samplesRead;
+  }
+
+  /**
+   * The number of frames decoded and resampled ahead of time by a background
+   * thread, or 0 if prefetching is disabled.
+   */
+  long long getPrefetchFrames() const {
+    const juce::ScopedLock readAheadScopedLock(readAheadLock);
+    return prefetchFrames;
+  }
+
+  void setPrefetchFrames(long long numFrames) {
+    if (numFrames < 0)
+      throw std::domain_error("prefetch_frames must not be negative.");
+    if (numFrames > std::numeric_limits<int>::max())
+      throw std::domain_error("prefetch_frames is too large.");
+    if (isClosed())
+      throw std::runtime_error("I/O operation on a closed file.");
+
+    // Reading from a Python file-like object requires the GIL, which the
+    // consumer may be holding while waiting for the prefetching thread:
+    if (numFrames > 0 && audioFile->getPythonInputStream())
+      throw std::domain_error("prefetch_frames is not supported when reading "
+                              "from a Python file-like object.");
+
+    const juce::ScopedLock readAheadScopedLock(readAheadLock);
+    stopReadAhead();
+    prefetchFrames = numFrames;
+  }
+
+  void seek(long long targetPosition) {
+    const juce::ScopedLock readAheadScopedLock(readAheadLock);
+    readAhead.reset();
+    seekWithoutReadAhead(targetPosition);
+  }
+
+  long long tell() const {
+    const juce::ScopedLock readAheadScopedLock(readAheadLock);
+    return readAhead ? readAheadPosition : positionInTargetSampleRate;
+  }
+
+  void close() {
+    const juce::ScopedLock readAheadScopedLock(readAheadLock);
+    readAhead.reset();
+
+    const juce::ScopedLock scopedLock(objectLock);
+    _isClosed = true;
+
+    // If we opened our own reader for the source file, nobody else needs it:
+    if (audioFile != sourceFile)
+      audioFile->close();
+  }
+
+  bool isClosed() const { return sourceFile->isClosed() || _isClosed; }
+
+  bool isSeekable() const { return audioFile->isSeekable(); }
+
+  std::optional<std::string> getFilename() const {
+    return audioFile->getFilename();
+  }
+
+  PythonInputStream *getPythonInputStream() const {
+    return audioFile->getPythonInputStream();
+  }
+
+  std::shared_ptr<ResampledReadableAudioFile> enter() {
+    return shared_from_this();
+  }
+
+  void exit(const py::object &type, const py::object &value,
+            const py::object &traceback) {
+    bool shouldThrow = PythonException::isPending();
+    close();
+
+    if (shouldThrow || PythonException::isPending())
+      throw py::error_already_set();
+  }
+
+private:
+  /**
+   * Resample up to numSamples frames into the provided channel pointers,
+   * continuing from wherever the last call left off. This is called on the
+   * prefetching thread if prefetching is enabled.
+   */
+  long long resampleInto(float **channelPointers, long long numSamples) {
+    const juce::ScopedLock scopedLock(objectLock);
+
+    long long numChannels = audioFile->getNumChannels();
+    const float **sourcePointers =
+        (const float **)alloca(numChannels * sizeof(const float *));
+    float **outputPointers = (float **)alloca(numChannels * sizeof(float *));
+
+    long long samplesWritten = 0;
+    while (samplesWritten < numSamples && !resamplerFlushed) {
+      if (sourceSamplesAvailable == 0 && !sourceExhausted) {
+        sourceSamplesStart = 0;
+        sourceSamplesAvailable =
+            audioFile->readInto(sourceBuffer.getArrayOfWritePointers(),
+                                sourceBuffer.getNumSamples());
+        sourceExhausted = sourceSamplesAvailable == 0;
       }
 
-      int startSample = samplesInResampledBuffer;
-      int samplesToCopy = std::min(
-          newResampledSamples.getNumSamples() - offsetInNewResampledSamples,
-          (int)(numSamples - samplesInResampledBuffer));
-      if (samplesToCopy > 0) {
-        for (int c = 0; c < resampledBuffer.getNumChannels(); c++) {
-          resampledBuffer.copyFrom(c, startSample, newResampledSamples, c,
-                                   offsetInNewResampledSamples, samplesToCopy);
-        }
+      for (long long c = 0; c < numChannels; c++) {
+        sourcePointers[c] = sourceBuffer.getReadPointer(c) + sourceSamplesStart;
+        outputPointers[c] = channelPointers[c] + samplesWritten;
       }
-      samplesInResampledBuffer += samplesToCopy;
 
-      // TODO: Tune this carefully to avoid unnecessary calls to read()
-      // Too large, and we buffer too much audio using too much memory
-      // Too short, and we slow down
-      inputSamplesRequired = 1;
+      long long outputCapacity = numSamples - samplesWritten;
+      IOTimer timer(statistics.get(), &IOCounters::resampleNanoseconds);
+      auto [samplesConsumed, samplesProduced] = resampler.processInto(
+          sourceExhausted ? nullptr : sourcePointers, sourceSamplesAvailable, 1,
+          outputPointers, outputCapacity);
+      statistics->add(&IOCounters::framesResampled, samplesProduced);
+
+      sourceSamplesStart += samplesConsumed;
+      sourceSamplesAvailable -= samplesConsumed;
+      samplesWritten += samplesProduced;
+
+      if (sourceExhausted && samplesProduced < outputCapacity) {
+        resamplerFlushed = true;
+      } else if (samplesConsumed == 0 && samplesProduced == 0) {
+        break;
+      }
     }
-    positionInTargetSampleRate += resampledBuffer.getNumSamples();
-    py::gil_scoped_acquire acquire;
-    return copyJuceBufferIntoPyArray(resampledBuffer,
-                                     ChannelLayout::NotInterleaved, 0);
+
+    positionInTargetSampleRate += samplesWritten;
+    return samplesWritten;
   }
 
-  void seek(long long targetPosition) {
+  /**
+   * Must be called with readAheadLock held and no prefetching thread running.
+   */
+  void seekWithoutReadAhead(long long targetPosition) {
     long long positionToSeekToIncludingBuffers = targetPosition;
 
     long long targetPositionInSourceSampleRate =
@@ -230,8 +331,10 @@ public:
                                    resampler.getSourceSampleRate()) /
                                   resampler.getTargetSampleRate()));
 
+    // Pre-roll enough input to fill the resampler's filter with real audio:
     targetPositionInSourceSampleRate -=
-        inputBufferSizeFor(resampler.getQuality());
+        std::max((long long)inputBufferSizeFor(resampler.getQuality()),
+                 (long long)std::ceil(2 * resampler.getInputLatency()));
 
     long long maximumOverflow = (long long)std::ceil(
         resampler.getSourceSampleRate() / resampler.getTargetSampleRate());
@@ -256,56 +359,97 @@ public:
 
     audioFile->seek(std::max(0LL, targetPositionInSourceSampleRate));
 
-    outputBuffer.setSize(0, 0);
+    sourceSamplesStart = 0;
+    sourceSamplesAvailable = 0;
+    sourceExhausted = false;
+    resamplerFlushed = false;
 
-    const long long chunkSize = 1024 * 1024;
-    for (long long i = positionInTargetSampleRate; i < targetPosition;
-         i += chunkSize) {
-      long long numSamples = std::min(chunkSize, targetPosition - i);
-      this->read(numSamples);
+    // Resample (and discard) the audio between the pre-roll position and the
+    // target position:
+    py::gil_scoped_release release;
+    juce::AudioBuffer<float> discardedAudio(audioFile->getNumChannels(),
+                                            DEFAULT_AUDIO_BUFFER_SIZE_FRAMES);
+    while (positionInTargetSampleRate < targetPosition) {
+      long long numSamples =
+          std::min((long long)discardedAudio.getNumSamples(),
+                   targetPosition - positionInTargetSampleRate);
+      if (resampleInto(discardedAudio.getArrayOfWritePointers(), numSamples) ==
+          0)
+        break;
     }
   }
 
-  long long tell() const { return positionInTargetSampleRate; }
-
-  void close() {
-    const juce::ScopedLock scopedLock(objectLock);
-    _isClosed = true;
+  /**
+   * Stop the prefetching thread (if any) and discard its audio, leaving this
+   * file positioned where its consumer last read up to. Must be called with
+   * readAheadLock held.
+   */
+  void stopReadAhead() {
+    if (!readAhead)
+      return;
+
+    readAhead.reset();
+    if (readAheadPosition != positionInTargetSampleRate)
+      seekWithoutReadAhead(readAheadPosition);
   }
 
-  bool isClosed() const { return audioFile->isClosed() || _isClosed; }
+  // The file that this object was created from:
+  std::shared_ptr<ReadableAudioFile> sourceFile;
 
-  bool isSeekable() const { return audioFile->isSeekable(); }
+  // The file that audio is actually decoded from. This is usually the same
+  // as sourceFile, but may be a separate reduced-sample-rate reader of it:
+  std::shared_ptr<ReadableAudioFile> audioFile;
+  StreamResampler<float> resampler;
 
-  std::optional<std::string> getFilename() const {
-    return audioFile->getFilename();
-  }
+  // Audio decoded from audioFile but not yet consumed by the resampler:
+  juce::AudioBuffer<float> sourceBuffer;
+  long long sourceSamplesStart = 0;
+  long long sourceSamplesAvailable = 0;
+  bool sourceExhausted = false;
+  bool resamplerFlushed = false;
 
-  PythonInputStream *getPythonInputStream() const {
-    return audioFile->getPythonInputStream();
-  }
+  long long positionInTargetSampleRate = 0;
+  juce::CriticalSection objectLock;
+  bool _isClosed = false;
 
-  std::shared_ptr<ResampledReadableAudioFile> enter() {
-    return shared_from_this();
-  }
+  // Held for the duration of each read or seek. Unlike objectLock, this is
+  // never needed by the prefetching thread, so it may be held while waiting
+  // for that thread. Must always be acquired before objectLock.
+  juce::CriticalSection readAheadLock;
+  long long prefetchFrames = 0;
 
-  void exit(const py::object &type, const py::object &value,
-            const py::object &traceback) {
-    bool shouldThrow = PythonException::isPending();
-    close();
+  // The position that the consumer of readAhead has read up to. (While
+  // prefetching, positionInTargetSampleRate is the position that the
+  // prefetching thread has resampled up to.)
+  long long readAheadPosition = 0;
 
-    if (shouldThrow || PythonException::isPending())
-      throw py::error_already_set();
+  // Declared last, so that the prefetching thread is stopped before any of
+  // the state it uses is destroyed:
+  std::unique_ptr<ReadAheadBuffer> readAhead;
+};
+
+/**
+ * Create a ResampledReadableAudioFile for the provided file. If the file's
+ * decoder can cheaply produce audio at a fraction of the file's sample rate
+ * that's still at or above the target sample rate (i.e.: for MP3 files), the
+ * file is decoded at that reduced rate, leaving much less work for the
+ * resampler.
+ *
+ * Must be called with the GIL held.
+ */
+inline std::shared_ptr<ResampledReadableAudioFile>
+createResampledReadableAudioFile(std::shared_ptr<ReadableAudioFile> audioFile,
+                                 float targetSampleRate,
+                                 ResamplingQuality quality) {
+  if (std::shared_ptr<ReadableAudioFile> downsampledFile =
+          audioFile->openDownsampled(targetSampleRate)) {
+    return std::make_shared<ResampledReadableAudioFile>(
+        audioFile, downsampledFile, targetSampleRate, quality);
   }
 
-private:
-  std::shared_ptr<ReadableAudioFile> audioFile;
-  StreamResampler<float> resampler;
-  juce::AudioBuffer<float> outputBuffer;
-  long long positionInTargetSampleRate = 0;
-  juce::CriticalSection objectLock;
-  bool _isClosed = false;
-};
+  return std::make_shared<ResampledReadableAudioFile>(
+      audioFile, targetSampleRate, quality);
+}
 
 inline py::class_<ResampledReadableAudioFile, AudioFile,
                   std::shared_ptr<ResampledReadableAudioFile>>
@@ -336,10 +480,21 @@ Fractional (real-valued, non-integer) sample rates are supported.
 Under the hood, :class:`ResampledReadableAudioFile` uses a stateful
 :class:`StreamResampler` instance, which uses a constant amount of
 memory to resample potentially-unbounded streams of audio. The audio
-output by :class:`ResampledReadableAudioFile` will always be identical
-to the result obtained by passing the entire audio file through a
-:class:`StreamResampler`, with the added benefits of allowing chunked
-reads, seeking through files, and using a constant amount of memory.
+output by :class:`ResampledReadableAudioFile` will be identical to the
+result obtained by passing the entire audio file through a
+:class:`StreamResampler` (except for some MP3 files, as noted below),
+with the added benefits of allowing chunked reads, seeking through
+files, and using a constant amount of memory.
+
+.. note::
+    When reading an MP3 file from disk at a sample rate of at most half (or
+    a quarter) of its native sample rate, the file is decoded directly at that
+    reduced rate by skipping the synthesis of its upper frequency bands, and
+    only the remaining difference is resampled. This is much faster than
+    decoding the entire file at its native rate, but may produce very slightly
+    different output near the target Nyquist frequency.
+
+    *Introduced in v0.9.0.*
 )");
 }
 
@@ -363,8 +518,8 @@ inline void init_resampled_readable_audio_file(
           "__new__",
           [](const py::object *, std::shared_ptr<ReadableAudioFile> audioFile,
              float targetSampleRate, ResamplingQuality quality) {
-            return std::make_shared<ResampledReadableAudioFile>(
-                audioFile, targetSampleRate, quality);
+            return createResampledReadableAudioFile(audioFile,
+                                                    targetSampleRate, quality);
           },
           py::arg("cls"), py::arg("audio_file"), py::arg("target_sample_rate"),
           py::arg("resampling_quality") = ResamplingQuality::WindowedSinc)
@@ -396,6 +551,32 @@ maximum sample value will be ``+1.0f``.
     For convenience, the ``num_frames`` argument may be a floating-point number. However, if the
     provided number of frames contains a fractional part (i.e.: ``1.01`` instead of ``1.00``) then
     an exception will be thrown, as a fractional number of samples cannot be returned.
+)")
+      .def(
+          "read_into",
+          [](std::shared_ptr<ResampledReadableAudioFile> file, py::array output) {
+            return readIntoArray(output, file->getNumChannels(),
+                                 [&](float **channels, long long numFrames) {
+                                   return file->readInto(channels, numFrames);
+                                 });
+          },
+          py::arg("output"),
+          R"(
+Read audio from this file at its current position directly into ``output``,
+a preallocated, writable ``float32`` :class:`numpy.ndarray`, instead of
+allocating a new array like :meth:`read` does. This allows reading many
+fixed-size windows of audio without allocating memory for each one.
+
+``output`` may be shaped either ``(num_channels, num_frames)`` or
+``(num_frames, num_channels)`` (or ``(num_frames,)`` for mono audio), and may
+be any strided view of a larger array. As many frames are read as ``output``
+can hold (at the target sample rate).
+
+Returns the number of frames written into ``output``, which will be smaller
+than the number of frames ``output`` can hold only if the end of the file was
+reached. Any remaining frames in ``output`` are left unchanged.
+
+*Introduced in v0.9.0.*
 )")
       .def("seekable", &ResampledReadableAudioFile::isSeekable,
            "Returns True if this file is currently open and calls to seek() "
@@ -521,6 +702,23 @@ this value will not change back to :py:const:`False` for the same
       .def_property_readonly(
           "resampling_quality", &ResampledReadableAudioFile::getQuality,
           "The resampling algorithm used to resample from the original file's "
-          "sample rate to the ``target_sample_rate``.");
+          "sample rate to the ``target_sample_rate``.")
+      .def_property(
+          "prefetch_frames", &ResampledReadableAudioFile::getPrefetchFrames,
+          &ResampledReadableAudioFile::setPrefetchFrames,
+          R"(
+The number of frames to decode and resample ahead of time on a background
+thread, or ``0`` (the default) to do so only when :meth:`read` is called.
+
+When reading a file sequentially in chunks, setting this to (at least) the size
+of each chunk allows the next chunk to be decoded and resampled while the
+current one is being processed. Up to two chunks of ``prefetch_frames`` frames
+each are kept in memory. Any prefetched audio is discarded when :meth:`seek` is
+called.
+
+Prefetching is not supported when reading from a Python file-like object.
+
+*Introduced in v0.9.0.*
+)");
 }
 } // namespace Pedalboard
@@ -0,0 +1,450 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "../BufferUtils.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define PEDALBOARD_USE_AVX2_CONVERSION 1
+#elif defined(__SSE2__) || defined(_M_X64) ||                                 \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PEDALBOARD_USE_SSE_CONVERSION 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+// Only AArch64 NEON supports the double-precision arithmetic used below:
+#include <arm_neon.h>
+#define PEDALBOARD_USE_NEON_CONVERSION 1
+#endif
+
+#if PEDALBOARD_USE_AVX2_CONVERSION || PEDALBOARD_USE_SSE_CONVERSION ||         \
+    PEDALBOARD_USE_NEON_CONVERSION
+#define PEDALBOARD_HAS_SIMD_CONVERSION 1
+#endif
+
+namespace Pedalboard {
+
+/**
+ * A source of triangular-PDF (TPDF) dither noise, spanning (-1, 1) LSB.
+ * Uses a small xorshift generator, as dither doesn't need to be
+ * cryptographically random, just cheap and uncorrelated with the signal.
+ */
+class TriangularDither {
+public:
+  float next() noexcept { return nextUniform() - nextUniform(); }
+
+private:
+  float nextUniform() noexcept {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return (float)(state >> 8) * (1.0f / 16777216.0f);
+  }
+
+  uint32_t state = 0x9E3779B9;
+};
+
+// Fixed-point ("left-aligned") samples are 32-bit integers whose most
+// significant bits hold the sample, as JUCE's AudioFormatReader::readSamples
+// returns and AudioFormatWriter::write expects.
+static constexpr double FIXED_POINT_FULL_SCALE = 2147483647.0;
+
+/**
+ * Convert one floating-point sample to fixed point, rounding and clipping
+ * exactly as juce::AudioFormatWriter::writeFromFloatArrays does.
+ */
+static inline int floatToFixed(double sample) noexcept {
+  if (sample <= -1.0)
+    return std::numeric_limits<int>::min();
+  if (sample >= 1.0)
+    return std::numeric_limits<int>::max();
+  return (int)std::nearbyint(sample * FIXED_POINT_FULL_SCALE);
+}
+
+/**
+ * Convert one 8-, 16-, or 32-bit integer sample to fixed point, by shifting
+ * it left to fill all 32 bits.
+ */
+template <typename T> static inline int integerToFixed(T sample) noexcept {
+  constexpr int shift =
+      std::numeric_limits<int>::digits - std::numeric_limits<T>::digits;
+  return (int)((unsigned int)(int)sample << shift);
+}
+
+namespace simd {
+// Vectorized conversion kernels. Each kernel handles as many samples as it
+// can and returns the number of samples processed, leaving any remainder to
+// the scalar loops below.
+#if PEDALBOARD_USE_AVX2_CONVERSION
+static inline unsigned int floatToFixed(const float *source, int *destination,
+                                        unsigned int numSamples) noexcept {
+  const __m256d scale = _mm256_set1_pd(FIXED_POINT_FULL_SCALE);
+  const __m256d minusOne = _mm256_set1_pd(-1.0);
+  const __m256d minimum = _mm256_set1_pd(-2147483648.0);
+
+  unsigned int i = 0;
+  for (; i + 4 <= numSamples; i += 4) {
+    __m256d samples = _mm256_cvtps_pd(_mm_loadu_ps(source + i));
+    __m256d scaled = _mm256_min_pd(_mm256_mul_pd(samples, scale), scale);
+    scaled = _mm256_blendv_pd(scaled, minimum,
+                              _mm256_cmp_pd(samples, minusOne, _CMP_LE_OQ));
+    _mm_storeu_si128((__m128i *)(destination + i), _mm256_cvtpd_epi32(scaled));
+  }
+  return i;
+}
+
+static inline unsigned int shortToFixed(const short *source, int *destination,
+                                        unsigned int numSamples) noexcept {
+  unsigned int i = 0;
+  for (; i + 8 <= numSamples; i += 8) {
+    __m256i samples =
+        _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(source + i)));
+    _mm256_storeu_si256((__m256i *)(destination + i),
+                        _mm256_slli_epi32(samples, 16));
+  }
+  return i;
+}
+
+static inline unsigned int fixedToShort(const int *source, short *destination,
+                                        unsigned int numSamples,
+                                        int shift) noexcept {
+  const __m128i count = _mm_cvtsi32_si128(shift);
+  unsigned int i = 0;
+  for (; i + 16 <= numSamples; i += 16) {
+    __m256i a = _mm256_sra_epi32(
+        _mm256_loadu_si256((const __m256i *)(source + i)), count);
+    __m256i b = _mm256_sra_epi32(
+        _mm256_loadu_si256((const __m256i *)(source + i + 8)), count);
+    // packs operates within 128-bit lanes, so restore the order afterwards:
+    __m256i packed =
+        _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0b11011000);
+    _mm256_storeu_si256((__m256i *)(destination + i), packed);
+  }
+  return i;
+}
+
+static inline unsigned int
+deinterleaveStereoShortToFixed(const short *interleaved, int *left, int *right,
+                               unsigned int numFrames) noexcept {
+  // Each 32-bit lane holds one frame, with the left sample in its low half:
+  const __m256i highHalf = _mm256_set1_epi32((int)0xFFFF0000);
+  unsigned int i = 0;
+  for (; i + 8 <= numFrames; i += 8) {
+    __m256i frames =
+        _mm256_loadu_si256((const __m256i *)(interleaved + i * 2));
+    _mm256_storeu_si256((__m256i *)(left + i), _mm256_slli_epi32(frames, 16));
+    _mm256_storeu_si256((__m256i *)(right + i),
+                        _mm256_and_si256(frames, highHalf));
+  }
+  return i;
+}
+#elif PEDALBOARD_USE_SSE_CONVERSION
+static inline __m128d floatToFixedScaled(__m128d samples) noexcept {
+  const __m128d scale = _mm_set1_pd(FIXED_POINT_FULL_SCALE);
+  const __m128d minusOne = _mm_set1_pd(-1.0);
+  const __m128d minimum = _mm_set1_pd(-2147483648.0);
+
+  __m128d scaled = _mm_min_pd(_mm_mul_pd(samples, scale), scale);
+  __m128d clipped = _mm_cmple_pd(samples, minusOne);
+  return _mm_or_pd(_mm_and_pd(clipped, minimum),
+                   _mm_andnot_pd(clipped, scaled));
+}
+
+static inline unsigned int floatToFixed(const float *source, int *destination,
+                                        unsigned int numSamples) noexcept {
+  unsigned int i = 0;
+  for (; i + 4 <= numSamples; i += 4) {
+    __m128 samples = _mm_loadu_ps(source + i);
+    __m128i low = _mm_cvtpd_epi32(floatToFixedScaled(_mm_cvtps_pd(samples)));
+    __m128i high = _mm_cvtpd_epi32(
+        floatToFixedScaled(_mm_cvtps_pd(_mm_movehl_ps(samples, samples))));
+    _mm_storeu_si128((__m128i *)(destination + i),
+                     _mm_unpacklo_epi64(low, high));
+  }
+  return i;
+}
+
+static inline unsigned int shortToFixed(const short *source, int *destination,
+                                        unsigned int numSamples) noexcept {
+  // Interleaving zeros below each sample shifts it into the high half:
+  const __m128i zero = _mm_setzero_si128();
+  unsigned int i = 0;
+  for (; i + 8 <= numSamples; i += 8) {
+    __m128i samples = _mm_loadu_si128((const __m128i *)(source + i));
+    _mm_storeu_si128((__m128i *)(destination + i),
+                     _mm_unpacklo_epi16(zero, samples));
+    _mm_storeu_si128((__m128i *)(destination + i + 4),
+                     _mm_unpackhi_epi16(zero, samples));
+  }
+  return i;
+}
+
+static inline unsigned int fixedToShort(const int *source, short *destination,
+                                        unsigned int numSamples,
+                                        int shift) noexcept {
+  const __m128i count = _mm_cvtsi32_si128(shift);
+  unsigned int i = 0;
+  for (; i + 8 <= numSamples; i += 8) {
+    __m128i a =
+        _mm_sra_epi32(_mm_loadu_si128((const __m128i *)(source + i)), count);
+    __m128i b = _mm_sra_epi32(
+        _mm_loadu_si128((const __m128i *)(source + i + 4)), count);
+    _mm_storeu_si128((__m128i *)(destination + i), _mm_packs_epi32(a, b));
+  }
+  return i;
+}
+
+static inline unsigned int
+deinterleaveStereoShortToFixed(const short *interleaved, int *left, int *right,
+                               unsigned int numFrames) noexcept {
+  // Each 32-bit lane holds one frame, with the left sample in its low half:
+  const __m128i highHalf = _mm_set1_epi32((int)0xFFFF0000);
+  unsigned int i = 0;
+  for (; i + 4 <= numFrames; i += 4) {
+    __m128i frames = _mm_loadu_si128((const __m128i *)(interleaved + i * 2));
+    _mm_storeu_si128((__m128i *)(left + i), _mm_slli_epi32(frames, 16));
+    _mm_storeu_si128((__m128i *)(right + i), _mm_and_si128(frames, highHalf));
+  }
+  return i;
+}
+#elif PEDALBOARD_USE_NEON_CONVERSION
+static inline int32x2_t floatToFixedScaled(float64x2_t samples) noexcept {
+  const float64x2_t scale = vdupq_n_f64(FIXED_POINT_FULL_SCALE);
+  const float64x2_t minimum = vdupq_n_f64(-2147483648.0);
+
+  float64x2_t scaled = vminq_f64(vmulq_f64(samples, scale), scale);
+  scaled = vbslq_f64(vcleq_f64(samples, vdupq_n_f64(-1.0)), minimum, scaled);
+  return vmovn_s64(vcvtnq_s64_f64(scaled));
+}
+
+static inline unsigned int floatToFixed(const float *source, int *destination,
+                                        unsigned int numSamples) noexcept {
+  unsigned int i = 0;
+  for (; i + 4 <= numSamples; i += 4) {
+    float32x4_t samples = vld1q_f32(source + i);
+    vst1q_s32(destination + i,
+              vcombine_s32(
+                  floatToFixedScaled(vcvt_f64_f32(vget_low_f32(samples))),
+                  floatToFixedScaled(vcvt_high_f64_f32(samples))));
+  }
+  return i;
+}
+
+static inline unsigned int shortToFixed(const short *source, int *destination,
+                                        unsigned int numSamples) noexcept {
+  unsigned int i = 0;
+  for (; i + 8 <= numSamples; i += 8) {
+    int16x8_t samples = vld1q_s16(source + i);
+    vst1q_s32(destination + i, vshll_n_s16(vget_low_s16(samples), 16));
+    vst1q_s32(destination + i + 4, vshll_high_n_s16(samples, 16));
+  }
+  return i;
+}
+
+static inline unsigned int fixedToShort(const int *source, short *destination,
+                                        unsigned int numSamples,
+                                        int shift) noexcept {
+  const int32x4_t count = vdupq_n_s32(-shift);
+  unsigned int i = 0;
+  for (; i + 8 <= numSamples; i += 8) {
+    int32x4_t a = vshlq_s32(vld1q_s32(source + i), count);
+    int32x4_t b = vshlq_s32(vld1q_s32(source + i + 4), count);
+    vst1q_s16(destination + i, vcombine_s16(vqmovn_s32(a), vqmovn_s32(b)));
+  }
+  return i;
+}
+
+static inline unsigned int
+deinterleaveStereoShortToFixed(const short *interleaved, int *left, int *right,
+                               unsigned int numFrames) noexcept {
+  unsigned int i = 0;
+  for (; i + 8 <= numFrames; i += 8) {
+    int16x8x2_t frames = vld2q_s16(interleaved + i * 2);
+    vst1q_s32(left + i, vshll_n_s16(vget_low_s16(frames.val[0]), 16));
+    vst1q_s32(left + i + 4, vshll_high_n_s16(frames.val[0], 16));
+    vst1q_s32(right + i, vshll_n_s16(vget_low_s16(frames.val[1]), 16));
+    vst1q_s32(right + i + 4, vshll_high_n_s16(frames.val[1], 16));
+  }
+  return i;
+}
+#endif
+} // namespace simd
+
+/**
+ * Convert floating-point samples into fixed point, rounding and clipping
+ * exactly as juce::AudioFormatWriter::writeFromFloatArrays does. The source
+ * and destination may be the same memory.
+ */
+template <typename T>
+void convertFloatToFixed(const T *source, int *destination,
+                         unsigned int numSamples) {
+  unsigned int i = 0;
+#if PEDALBOARD_HAS_SIMD_CONVERSION
+  if constexpr (std::is_same<T, float>::value) {
+    i += simd::floatToFixed(source, destination, numSamples);
+  }
+#endif
+  for (; i < numSamples; i++) {
+    // Round double-precision input to float first, to match the output of
+    // writing the same audio as float32:
+    destination[i] = floatToFixed((float)source[i]);
+  }
+}
+
+/**
+ * Convert floating-point samples into fixed point, quantizing them to
+ * bitsPerSample bits with TPDF dither (rather than truncating them, as
+ * convertFloatToFixed and the writer would).
+ */
+template <typename T>
+void convertFloatToFixedWithDither(const T *source, int *destination,
+                                   unsigned int numSamples, int bitsPerSample,
+                                   TriangularDither &dither) {
+  if (bitsPerSample >= 32) {
+    convertFloatToFixed(source, destination, numSamples);
+    return;
+  }
+
+  const int shift = 32 - bitsPerSample;
+  const double maximum = (double)((1LL << (bitsPerSample - 1)) - 1);
+  const double minimum = -maximum - 1;
+  for (unsigned int i = 0; i < numSamples; i++) {
+    double quantized = std::floor((double)source[i] * maximum + 0.5 +
+                                  (double)dither.next());
+    quantized = std::max(minimum, std::min(maximum, quantized));
+    destination[i] = (int)((long long)quantized * (1LL << shift));
+  }
+}
+
+/**
+ * Convert 8-, 16-, or 32-bit integer samples into fixed point, by shifting
+ * them left to fill all 32 bits.
+ */
+template <typename T>
+void convertIntegerToFixed(const T *source, int *destination,
+                           unsigned int numSamples) {
+  unsigned int i = 0;
+#if PEDALBOARD_HAS_SIMD_CONVERSION
+  if constexpr (std::is_same<T, short>::value) {
+    i += simd::shortToFixed(source, destination, numSamples);
+  }
+#endif
+  for (; i < numSamples; i++) {
+    destination[i] = integerToFixed(source[i]);
+  }
+}
+
+/**
+ * Convert fixed-point samples into a narrower integer type, by shifting them
+ * right by the given number of bits (which must leave values that fit in T).
+ */
+template <typename T>
+void convertFixedToInteger(const int *source, T *destination,
+                           unsigned int numSamples, int shift) {
+  unsigned int i = 0;
+#if PEDALBOARD_HAS_SIMD_CONVERSION
+  if constexpr (std::is_same<T, short>::value) {
+    i += simd::fixedToShort(source, destination, numSamples, shift);
+  }
+#endif
+  for (; i < numSamples; i++) {
+    destination[i] = (T)(source[i] >> shift);
+  }
+}
+
+/**
+ * Split interleaved integer or floating-point audio into separate buffers of
+ * fixed-point samples for each channel, converting it in the same pass. If
+ * dither is provided, floating-point audio is dithered to bitsPerSample bits.
+ */
+template <typename T>
+void deinterleaveToFixed(const T *interleaved, int *const *channels,
+                         unsigned int numChannels, unsigned int numFrames,
+                         TriangularDither *dither = nullptr,
+                         int bitsPerSample = 32) {
+  int **tileChannels = (int **)alloca(numChannels * sizeof(int *));
+
+  for (unsigned int tileStart = 0; tileStart < numFrames;
+       tileStart += INTERLEAVE_TILE_SIZE_FRAMES) {
+    unsigned int tileFrames =
+        std::min(INTERLEAVE_TILE_SIZE_FRAMES, numFrames - tileStart);
+    const T *tile = interleaved + (size_t)tileStart * numChannels;
+
+    for (unsigned int c = 0; c < numChannels; c++) {
+      tileChannels[c] = channels[c] + tileStart;
+    }
+
+    if constexpr (std::is_same<T, float>::value) {
+      // Deinterleave into the (identically sized) output samples, then
+      // convert each channel in place while it's still in cache:
+      deinterleaveSamples(tile, (float *const *)tileChannels, numChannels,
+                          tileFrames);
+      for (unsigned int c = 0; c < numChannels; c++) {
+        const float *samples = (const float *)tileChannels[c];
+        if (dither) {
+          convertFloatToFixedWithDither(samples, tileChannels[c], tileFrames,
+                                        bitsPerSample, *dither);
+        } else {
+          convertFloatToFixed(samples, tileChannels[c], tileFrames);
+        }
+      }
+    } else if constexpr (std::is_floating_point<T>::value) {
+      for (unsigned int c = 0; c < numChannels; c++) {
+        T samples[INTERLEAVE_TILE_SIZE_FRAMES];
+        for (unsigned int i = 0; i < tileFrames; i++) {
+          samples[i] = tile[(size_t)i * numChannels + c];
+        }
+        if (dither) {
+          convertFloatToFixedWithDither(samples, tileChannels[c], tileFrames,
+                                        bitsPerSample, *dither);
+        } else {
+          convertFloatToFixed(samples, tileChannels[c], tileFrames);
+        }
+      }
+    } else {
+      unsigned int c = 0;
+#if PEDALBOARD_HAS_SIMD_CONVERSION
+      if constexpr (std::is_same<T, short>::value) {
+        if (numChannels == 2) {
+          unsigned int i = simd::deinterleaveStereoShortToFixed(
+              tile, tileChannels[0], tileChannels[1], tileFrames);
+          for (; i < tileFrames; i++) {
+            tileChannels[0][i] = integerToFixed(tile[i * 2]);
+            tileChannels[1][i] = integerToFixed(tile[i * 2 + 1]);
+          }
+          c = 2;
+        }
+      }
+#endif
+      for (; c < numChannels; c++) {
+        int *channel = tileChannels[c];
+        for (unsigned int i = 0; i < tileFrames; i++) {
+          channel[i] = integerToFixed(tile[(size_t)i * numChannels + c]);
+        }
+      }
+    }
+  }
+}
+
+} // namespace Pedalboard
@@ -17,35 +17,140 @@
 #pragma once
 
 #include "../BufferUtils.h"
+#include "../ScratchBuffers.h"
 #include "../plugin_templates/Resample.h"
+#include <cstring>
+#include <map>
 #include <mutex>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 namespace Pedalboard {
 
+static constexpr const unsigned int DEFAULT_STAGING_BUFFER_SAMPLES = 8192;
+
+/**
+ * The number of output samples between each of the interpolator states cached
+ * by getInterpolatorStateAfter, which bounds the cost of each call to it.
+ */
+static constexpr long long INTERPOLATOR_STATE_CACHE_INTERVAL = 1 << 14;
+
+/**
+ * The number of distinct resampling ratios for which interpolator states are
+ * cached at once. (Each ratio's cache takes 16 bytes per cache interval.)
+ */
+static constexpr size_t MAX_CACHED_INTERPOLATOR_RATIOS = 64;
+
+/**
+ * Return the number of input samples consumed by (and the sub-sample position
+ * left behind in) a freshly-reset JUCE interpolator after it produces the
+ * given number of output samples at the given speed ratio.
+ *
+ * NOTE(psobot): This could be calculated in constant time, _but_ due to
+ * floating point accumulation errors, that produces slightly different output
+ * than actually running the interpolator. This would mean that users who call
+ * seek() on a resampled stream would end up with a very slightly different
+ * copy of the stream. This nondeterminism is not worth the speedup.
+ *
+ * Instead, this replays the interpolator's arithmetic exactly, but caches its
+ * state every INTERPOLATOR_STATE_CACHE_INTERVAL output samples (shared between
+ * all resamplers with the same ratio) so that only the remainder needs to be
+ * replayed. After the first seek to a given position, seeking anywhere before
+ * it (in any file resampled at the same ratio) takes constant time.
+ */
+inline std::pair<long long, double>
+getInterpolatorStateAfter(double speedRatio, long long numOutputSamples) {
+  auto replay = [speedRatio](long long &numInputSamplesUsed,
+                             double &subSamplePos, long long numSamples) {
+    for (; numSamples > 0; numSamples--) {
+      while (subSamplePos >= 1.0) {
+        numInputSamplesUsed++;
+        subSamplePos -= 1.0;
+      }
+      subSamplePos += speedRatio;
+    }
+  };
+
+  long long numInputSamplesUsed = 0;
+  double subSamplePos = 1.0;
+  long long numSamplesReplayed = 0;
+
+  {
+    static std::mutex cacheMutex;
+    static std::map<double, std::vector<std::pair<long long, double>>> cache;
+    std::scoped_lock lock(cacheMutex);
+
+    if (cache.size() >= MAX_CACHED_INTERPOLATOR_RATIOS &&
+        cache.find(speedRatio) == cache.end())
+      cache.clear();
+
+    // The state after (i + 1) * INTERPOLATOR_STATE_CACHE_INTERVAL samples:
+    auto &states = cache[speedRatio];
+    size_t numStatesNeeded =
+        (size_t)(numOutputSamples / INTERPOLATOR_STATE_CACHE_INTERVAL);
+    size_t numStatesToUse = std::min(states.size(), numStatesNeeded);
+    if (numStatesToUse > 0) {
+      std::tie(numInputSamplesUsed, subSamplePos) = states[numStatesToUse - 1];
+      numSamplesReplayed = numStatesToUse * INTERPOLATOR_STATE_CACHE_INTERVAL;
+    }
+
+    while (states.size() < numStatesNeeded) {
+      replay(numInputSamplesUsed, subSamplePos,
+             INTERPOLATOR_STATE_CACHE_INTERVAL);
+      numSamplesReplayed += INTERPOLATOR_STATE_CACHE_INTERVAL;
+      states.push_back({numInputSamplesUsed, subSamplePos});
+    }
+  }
+
+  replay(numInputSamplesUsed, subSamplePos,
+         numOutputSamples - numSamplesReplayed);
+  return {numInputSamplesUsed, subSamplePos};
+}
+
 template <typename SampleType = float> class StreamResampler {
 public:
   StreamResampler(double sourceSampleRate, double targetSampleRate,
                   int numChannels, ResamplingQuality quality)
       : sourceSampleRate(sourceSampleRate), targetSampleRate(targetSampleRate),
         numChannels(numChannels), quality(quality) {
-    overflowSamples.resize(numChannels);
+    resamplerRatio = sourceSampleRate / targetSampleRate;
     resamplers.resize(numChannels);
 
     for (int i = 0; i < numChannels; i++) {
-      resamplers[i].setQuality(quality);
+      resamplers[i].setQuality(quality, resamplerRatio);
       resamplers[i].reset();
     }
 
-    resamplerRatio = sourceSampleRate / targetSampleRate;
     inputLatency = resamplers[0].getBaseLatency();
     outputLatency = inputLatency / resamplerRatio;
 
     outputSamplesToSkip = outputLatency;
+
+    // The staging buffer must be large enough that it can always produce at
+    // least one output sample once full, regardless of the resampling ratio:
+    stagingBuffer.setSize(
+        numChannels,
+        std::max((int)DEFAULT_STAGING_BUFFER_SAMPLES,
+                 (int)std::ceil(resamplerRatio) * 2 + 2));
+    skippedOutput.setSize(numChannels, (int)std::ceil(outputLatency) + 1);
   }
 
   juce::AudioBuffer<SampleType>
   process(std::optional<juce::AudioBuffer<SampleType>> &_input,
           double maxSamplesToReturn = 1e40) {
+    juce::AudioBuffer<SampleType> output;
+    process(_input, output);
+    return output;
+  }
+
+  /**
+   * Resample the provided input (or flush, if no input is provided) into the
+   * provided output buffer, which is resized to fit the resampled audio. The
+   * output buffer's existing allocation is reused if it's large enough.
+   */
+  void process(std::optional<juce::AudioBuffer<SampleType>> &_input,
+               juce::AudioBuffer<SampleType> &output) {
     if (_input && _input->getNumChannels() != numChannels) {
       throw std::domain_error(
           "Expected " + std::to_string(numChannels) +
@@ -56,94 +161,52 @@ public:
 
     std::scoped_lock lock(mutex);
 
-    juce::AudioBuffer<SampleType> input;
-    bool isFlushing = false;
-    int numNewInputSamples = 0;
-
-    if (_input) {
-      input = prependWith(*_input, overflowSamples);
-      numNewInputSamples = input.getNumSamples();
-    } else {
-      isFlushing = true;
-      int samplesToFlush = inputLatency;
-
-      input = juce::AudioBuffer<float>(numChannels, samplesToFlush);
-      inputSamplesBufferedInResampler = 0;
-      input.clear();
-      input = prependWith(input, overflowSamples);
-    }
-
-    double expectedResampledSamples =
-        std::max(0.0, ((totalSamplesInput + input.getNumSamples()) *
-                       targetSampleRate / sourceSampleRate) -
-                          totalSamplesOutput);
-
-    // TODO: Don't copy the entire input buffer multiple times here!
-    juce::AudioBuffer<SampleType> output(input.getNumChannels(),
-                                         (int)expectedResampledSamples);
-
-    for (size_t c = 0; c < input.getNumChannels(); c++) {
-      if (input.getNumSamples() > 0) {
-        long long inputSamplesConsumed = resamplers[c].process(
-            resamplerRatio, input.getReadPointer(c), output.getWritePointer(c),
-            (int)expectedResampledSamples);
-
-        if (c == 0) {
-          if (!isFlushing) {
-            totalSamplesInput += inputSamplesConsumed;
-          }
-          totalSamplesOutput += (int)expectedResampledSamples;
-        }
-
-        if (!isFlushing) {
-          for (int i = inputSamplesConsumed; i < input.getNumSamples(); i++) {
-            overflowSamples[c].push_back(input.getReadPointer(c)[i]);
-          }
-          if (c == 0) {
-            inputSamplesBufferedInResampler += inputSamplesConsumed;
-            if (inputSamplesBufferedInResampler > inputLatency) {
-              inputSamplesBufferedInResampler = inputLatency;
-            }
-          }
-        }
-      }
-    }
-
-    // Chop off the first _n_ samples if necessary:
-    if (outputSamplesToSkip > 0) {
-      long long intOutputSamplesToSkip = (int)std::round(outputSamplesToSkip);
-      if (intOutputSamplesToSkip) {
-        outputSamplesToSkip -=
-            std::min(intOutputSamplesToSkip, (long long)output.getNumSamples());
-
-        int newNumOutputSamples =
-            output.getNumSamples() - intOutputSamplesToSkip;
-        if (newNumOutputSamples <= 0) {
-          if (isFlushing) {
-            reset_unlocked();
-          }
-          return juce::AudioBuffer<SampleType>(input.getNumChannels(), 0);
-        }
-
-        juce::AudioBuffer<SampleType> choppedOutput(input.getNumChannels(),
-                                                    newNumOutputSamples);
-        for (int c = 0; c < numChannels; c++) {
-          choppedOutput.copyFrom(c, 0, output, c, intOutputSamplesToSkip,
-                                 newNumOutputSamples);
-        }
-
-        if (isFlushing) {
-          reset_unlocked();
-        }
-        return choppedOutput;
-      }
-    }
-
-    if (isFlushing) {
-      reset_unlocked();
-    }
+    long long numInputSamples = _input ? _input->getNumSamples() : 0;
+    long long inputSamplesToResample =
+        stagedSamples + (_input ? numInputSamples
+                                : (isFlushing ? flushSamplesRemaining
+                                              : (long long)inputLatency));
+
+    // The most output we could produce is enough to consume all of the input,
+    // including any samples that will be skipped to compensate for latency:
+    output.setSize(numChannels,
+                   (int)getExpectedOutputSamples(inputSamplesToResample),
+                   /* keepExistingContent= */ false,
+                   /* clearExtraSpace= */ false,
+                   /* avoidReallocating= */ true);
+
+    long long samplesWritten =
+        processInto_unlocked(
+            _input ? _input->getArrayOfReadPointers() : nullptr,
+            numInputSamples, 1, output.getArrayOfWritePointers(),
+            output.getNumSamples())
+            .second;
+
+    output.setSize(numChannels, (int)samplesWritten,
+                   /* keepExistingContent= */ true,
+                   /* clearExtraSpace= */ false,
+                   /* avoidReallocating= */ true);
+  }
 
-    return output;
+  /**
+   * Resample up to numInputSamples frames from the provided input channels
+   * (each of which has samples spaced inputSampleStride apart), writing at
+   * most outputCapacity frames directly into the provided output channels.
+   * Pass nullptr as the input to flush the resampler; flushing is complete
+   * once fewer than outputCapacity frames are returned.
+   *
+   * Input samples are copied once into a fixed-size staging buffer, and are
+   * only consumed from the caller while there is room for them, so this
+   * method never allocates. Returns a pair of (input frames consumed, output
+   * frames written); any unconsumed input should be passed in again.
+   */
+  std::pair<long long, long long>
+  processInto(const SampleType *const *input, long long numInputSamples,
+              long long inputSampleStride, SampleType *const *output,
+              long long outputCapacity) {
+    std::scoped_lock lock(mutex);
+    return processInto_unlocked(input, numInputSamples, inputSampleStride,
+                                output, outputCapacity);
   }
 
   void reset() {
@@ -158,9 +221,10 @@ public:
 
     inputSamplesBufferedInResampler = 0;
     outputSamplesToSkip = outputLatency;
-    for (auto &overflowBuffer : overflowSamples) {
-      overflowBuffer.clear();
-    }
+    stagedStart = 0;
+    stagedSamples = 0;
+    isFlushing = false;
+    flushSamplesRemaining = 0;
 
     totalSamplesInput = 0;
     totalSamplesOutput = 0;
@@ -175,11 +239,11 @@ public:
   double getOutputLatency() const { return outputLatency; }
 
   int getBufferedInputSamples() const {
-    return inputSamplesBufferedInResampler;
+    return (int)inputSamplesBufferedInResampler;
   }
 
   // TODO: Rename me!
-  int getOverflowSamples() const { return overflowSamples[0].size(); }
+  int getOverflowSamples() const { return (int)stagedSamples; }
 
   /**
    * Advance the internal state of this resampler, as if the given
@@ -189,51 +253,8 @@ public:
    * the resampler, but will not clear all of the samples buffered internally.
    */
   long long advanceResamplerState(long long numOutputSamples) {
-    double newSubSamplePos = 1.0;
-    long long numOutputSamplesToProduce = numOutputSamples;
-
-    long long numInputSamplesUsed = 0;
-
-    static const bool USE_CONSTANT_TIME_CALCULATION = false;
-    if (USE_CONSTANT_TIME_CALCULATION) {
-      /**
-       * NOTE(psobot): This calculation is faster than the below (as it runs in
-       * constant time) _but_ due to floating point accumulation errors, this
-       * produces slightly different output than the `while` loops below. This
-       * would mean that users who call seek() on a resampled stream would end
-       * up with a very slightly different copy of the stream. This
-       * nondeterminism is not worth the speedup.
-       *
-       * The probable way to fix this is to rewrite juce::GenericInterpolator to
-       * use two `long long` variables to track the subsample position, rather
-       * than relying on a single `double` whose precision errors can accumulate
-       * over time. That is not a refactor I want to start at 4:44pm on a
-       * Friday.
-       */
-
-      double numInputSamplesNeeded =
-          std::max(0LL, numOutputSamplesToProduce - 1) * resamplerRatio;
-      numInputSamplesUsed = std::ceil(numInputSamplesNeeded);
-      newSubSamplePos = numInputSamplesNeeded - numInputSamplesUsed + 1;
-
-      if (numOutputSamplesToProduce) {
-        while (newSubSamplePos >= 1.0) {
-          numInputSamplesUsed++;
-          newSubSamplePos -= 1.0;
-        }
-        newSubSamplePos += resamplerRatio;
-      }
-    } else {
-      while (numOutputSamplesToProduce > 0) {
-        while (newSubSamplePos >= 1.0) {
-          numInputSamplesUsed++;
-          newSubSamplePos -= 1.0;
-        }
-
-        newSubSamplePos += resamplerRatio;
-        --numOutputSamplesToProduce;
-      }
-    }
+    auto [numInputSamplesUsed, newSubSamplePos] =
+        getInterpolatorStateAfter(resamplerRatio, numOutputSamples);
 
     float zero = 0.0;
     for (auto &resampler : resamplers) {
@@ -254,24 +275,141 @@ public:
   }
 
 private:
-  juce::AudioBuffer<SampleType>
-  prependWith(juce::AudioBuffer<SampleType> &input,
-              std::vector<std::vector<SampleType>> &toPrepend) {
-    int prependSize = toPrepend[0].size();
-    juce::AudioBuffer<SampleType> output(input.getNumChannels(),
-                                         input.getNumSamples() + prependSize);
-
-    for (int c = 0; c < input.getNumChannels(); c++) {
-      SampleType *channelPointer = output.getWritePointer(c);
-      for (int i = 0; i < prependSize; i++) {
-        channelPointer[i] = toPrepend[c][i];
+  /**
+   * The number of output samples (including those that will be skipped to
+   * compensate for latency) that will be produced once the given number of
+   * not-yet-consumed input samples have been passed to the resamplers.
+   */
+  long long getExpectedOutputSamples(long long inputSamplesToResample) const {
+    return (long long)std::max(
+        0.0, ((totalSamplesInput + inputSamplesToResample) * targetSampleRate /
+              sourceSampleRate) -
+                 totalSamplesOutput);
+  }
+
+  std::pair<long long, long long>
+  processInto_unlocked(const SampleType *const *input, long long numInputSamples,
+                       long long inputSampleStride, SampleType *const *output,
+                       long long outputCapacity) {
+    if (input && isFlushing) {
+      throw std::runtime_error(
+          "This resampler is being flushed; no more input can be provided "
+          "until flushing is complete or reset() is called.");
+    }
+
+    if (!input && !isFlushing) {
+      isFlushing = true;
+      flushSamplesRemaining = (long long)inputLatency;
+      inputSamplesBufferedInResampler = 0;
+    }
+
+    long long inputSamplesConsumed = 0;
+    long long outputSamplesWritten = 0;
+
+    while (true) {
+      // Only the few samples left over from the last iteration usually need
+      // to be moved here, as the resamplers consume almost all of their input.
+      if (stagedStart > 0 &&
+          stagedStart + stagedSamples == stagingBuffer.getNumSamples()) {
+        for (int c = 0; c < numChannels; c++) {
+          std::memmove(stagingBuffer.getWritePointer(c),
+                       stagingBuffer.getReadPointer(c) + stagedStart,
+                       stagedSamples * sizeof(SampleType));
+        }
+        stagedStart = 0;
       }
-      toPrepend[c].clear();
 
-      output.copyFrom(c, prependSize, input, c, 0, input.getNumSamples());
+      long long stagingSpace =
+          stagingBuffer.getNumSamples() - (stagedStart + stagedSamples);
+      long long samplesToStage = 0;
+      if (isFlushing) {
+        samplesToStage = std::min(stagingSpace, flushSamplesRemaining);
+        for (int c = 0; c < numChannels; c++) {
+          juce::FloatVectorOperations::clear(
+              stagingBuffer.getWritePointer(c) + stagedStart + stagedSamples,
+              (int)samplesToStage);
+        }
+        flushSamplesRemaining -= samplesToStage;
+      } else {
+        samplesToStage =
+            std::min(stagingSpace, numInputSamples - inputSamplesConsumed);
+        for (int c = 0; c < numChannels; c++) {
+          SampleType *destination =
+              stagingBuffer.getWritePointer(c) + stagedStart + stagedSamples;
+          const SampleType *source =
+              input[c] + inputSamplesConsumed * inputSampleStride;
+          if (inputSampleStride == 1) {
+            std::memcpy(destination, source,
+                        samplesToStage * sizeof(SampleType));
+          } else {
+            for (long long i = 0; i < samplesToStage; i++) {
+              destination[i] = source[i * inputSampleStride];
+            }
+          }
+        }
+        inputSamplesConsumed += samplesToStage;
+      }
+      stagedSamples += samplesToStage;
+
+      long long expectedOutputSamples = getExpectedOutputSamples(stagedSamples);
+      long long outputSamplesProduced = 0;
+
+      // Chop off the first _n_ samples if necessary:
+      if (outputSamplesToSkip > 0) {
+        long long samplesToSkip = std::min(
+            (long long)std::round(outputSamplesToSkip), expectedOutputSamples);
+        if (samplesToSkip > 0) {
+          resampleStagedSamples(skippedOutput.getArrayOfWritePointers(), 0,
+                                samplesToSkip);
+          outputSamplesToSkip -= samplesToSkip;
+          expectedOutputSamples -= samplesToSkip;
+          outputSamplesProduced += samplesToSkip;
+        }
+      }
+
+      long long samplesToOutput = std::min(
+          expectedOutputSamples, outputCapacity - outputSamplesWritten);
+      if (samplesToOutput > 0) {
+        resampleStagedSamples(output, outputSamplesWritten, samplesToOutput);
+        outputSamplesWritten += samplesToOutput;
+        outputSamplesProduced += samplesToOutput;
+      }
+
+      if (samplesToStage == 0 && outputSamplesProduced == 0)
+        break;
     }
 
-    return output;
+    if (isFlushing && flushSamplesRemaining == 0 &&
+        getExpectedOutputSamples(stagedSamples) == 0) {
+      reset_unlocked();
+    }
+
+    return {inputSamplesConsumed, outputSamplesWritten};
+  }
+
+  /**
+   * Run each channel's resampler over the staging buffer, writing
+   * numOutputSamples samples to each output channel at the given offset.
+   */
+  void resampleStagedSamples(SampleType *const *output, long long outputOffset,
+                             long long numOutputSamples) {
+    long long inputSamplesConsumed = 0;
+    for (int c = 0; c < numChannels; c++) {
+      inputSamplesConsumed = resamplers[c].process(
+          resamplerRatio, stagingBuffer.getReadPointer(c) + stagedStart,
+          output[c] + outputOffset, (int)numOutputSamples);
+    }
+
+    stagedStart += inputSamplesConsumed;
+    stagedSamples -= inputSamplesConsumed;
+    totalSamplesInput += inputSamplesConsumed;
+    totalSamplesOutput += numOutputSamples;
+
+    if (!isFlushing) {
+      inputSamplesBufferedInResampler =
+          std::min((long long)inputLatency,
+                   inputSamplesBufferedInResampler + inputSamplesConsumed);
+    }
   }
 
   double sourceSampleRate;
@@ -280,14 +418,26 @@ private:
   std::vector<VariableQualityResampler> resamplers;
 
   double resamplerRatio = 1.0;
-  std::vector<std::vector<SampleType>> overflowSamples;
+
+  // Input samples that have been provided but not yet consumed by the
+  // resamplers, stored in a buffer whose size is fixed at construction time:
+  juce::AudioBuffer<SampleType> stagingBuffer;
+  long long stagedStart = 0;
+  long long stagedSamples = 0;
+
+  // Scratch space for the output samples skipped to compensate for latency:
+  juce::AudioBuffer<SampleType> skippedOutput;
+
+  bool isFlushing = false;
+  long long flushSamplesRemaining = 0;
+
   double inputLatency = 0;
   double outputLatency = 0;
 
   long long totalSamplesInput = 0;
   long long totalSamplesOutput = 0;
 
-  int inputSamplesBufferedInResampler = 0;
+  long long inputSamplesBufferedInResampler = 0;
   int numChannels = 1;
   double outputSamplesToSkip = 0.0;
 
@@ -346,6 +496,9 @@ inline void init_stream_resampler(py::module &m) {
     case ResamplingQuality::WindowedSinc:
       ss << "WindowedSinc";
       break;
+    case ResamplingQuality::Polyphase:
+      ss << "Polyphase";
+      break;
     default:
       ss << "unknown";
       break;
@@ -358,37 +511,171 @@ inline void init_stream_resampler(py::module &m) {
 
   resampler.def(
       "process",
-      [](StreamResampler<float> &resampler,
-         std::optional<py::array_t<float, py::array::c_style>> input) {
+      [](StreamResampler<float> &resampler, std::optional<py::object> input) {
+        // Must outlive inputBuffer, which may point directly at its memory:
+        py::array_t<float, py::array::c_style> inputArray;
         std::optional<juce::AudioBuffer<float>> inputBuffer;
         if (input) {
+          inputArray =
+              py::array_t<float, py::array::c_style>::ensure(asArray(*input));
+          if (!inputArray) {
+            throw py::type_error(
+                "StreamResampler.process expects a float32 array.");
+          }
           std::optional<ChannelLayout> layout =
               resampler.getLastChannelLayout();
           if (!layout) {
             try {
-              layout = detectChannelLayout(*input);
+              layout = detectChannelLayout(inputArray);
               resampler.setLastChannelLayout(*layout);
             } catch (...) {
               // Use the last cached layout.
             }
           }
-          inputBuffer = convertPyArrayIntoJuceBuffer(*input, *layout);
+          inputBuffer = convertPyArrayIntoJuceBuffer(inputArray, *layout);
         }
 
-        juce::AudioBuffer<float> output;
+        auto output = ScratchBuffers<float>::acquire(0, 0);
         {
           py::gil_scoped_release release;
-          output = resampler.process(inputBuffer);
+          resampler.process(inputBuffer, *output);
         }
 
-        return copyJuceBufferIntoPyArray(output,
-                                         *resampler.getLastChannelLayout(), 0);
+        py::array outputArray = copyJuceBufferIntoPyArray(
+            *output, *resampler.getLastChannelLayout(), 0);
+        if (input)
+          return wrapArrayLike(outputArray, *input);
+        return py::object(outputArray);
       },
       py::arg("input") = py::none(),
       "Resample a 32-bit floating-point audio buffer. The returned buffer may "
       "be smaller than the provided buffer depending on the quality method "
       "used. Call :meth:`process()` without any arguments to flush the "
-      "internal buffers and return all remaining audio.");
+      "internal buffers and return all remaining audio.\n\n"
+      "A PyTorch (or other DLPack-compatible) tensor in CPU memory may be "
+      "passed instead of a NumPy array, in which case a tensor of the same "
+      "type is returned.");
+
+  resampler.def(
+      "process_into",
+      [](StreamResampler<float> &resampler,
+         std::optional<py::array_t<float>> input, py::array output) {
+        long long numChannels = resampler.getNumChannels();
+
+        if (!py::isinstance<py::array_t<float>>(output)) {
+          throw py::type_error(
+              "process_into expects a float32 NumPy array to write output "
+              "into, but got an array of type " +
+              py::str(output.dtype()).cast<std::string>() + ".");
+        }
+
+        py::buffer_info outputInfo = output.request(/* writable= */ true);
+        long long outputCapacity = 0;
+        long long outputChannelStride = 0;
+        if (outputInfo.ndim == 1 && numChannels == 1) {
+          outputCapacity = outputInfo.shape[0];
+        } else if (outputInfo.ndim == 2 && outputInfo.shape[0] == numChannels) {
+          outputCapacity = outputInfo.shape[1];
+          outputChannelStride = outputInfo.strides[0] / (long long)sizeof(float);
+        } else {
+          throw std::domain_error(
+              "Expected an output buffer with shape (" +
+              std::to_string(numChannels) +
+              ", num_frames), but was provided a buffer with shape " +
+              py::str(output.attr("shape")).cast<std::string>() + ".");
+        }
+
+        if (outputCapacity > 1 &&
+            outputInfo.strides[outputInfo.ndim - 1] != (py::ssize_t)sizeof(float)) {
+          throw std::domain_error(
+              "process_into requires the frames of each channel in the output "
+              "buffer to be contiguous in memory.");
+        }
+
+        float **outputPointers = (float **)alloca(numChannels * sizeof(float *));
+        for (long long c = 0; c < numChannels; c++) {
+          outputPointers[c] = ((float *)outputInfo.ptr) + c * outputChannelStride;
+        }
+
+        const float **inputPointers = nullptr;
+        long long numInputSamples = 0;
+        long long inputSampleStride = 1;
+        py::buffer_info inputInfo;
+        if (input) {
+          inputInfo = input->request();
+
+          // Input may be provided as (num_channels, num_frames) or as
+          // (num_frames, num_channels), with any strides:
+          long long channelDimension = -1;
+          if (inputInfo.ndim == 1 && numChannels == 1) {
+            channelDimension = 1;
+          } else if (inputInfo.ndim == 2) {
+            if (inputInfo.shape[0] == numChannels) {
+              channelDimension = 0;
+            } else if (inputInfo.shape[1] == numChannels) {
+              channelDimension = 1;
+            }
+          }
+
+          if (channelDimension == -1) {
+            throw std::domain_error(
+                "Expected " + std::to_string(numChannels) +
+                "-channel input, but was provided a buffer with shape " +
+                py::str(input->attr("shape")).cast<std::string>() + ".");
+          }
+
+          for (auto stride : inputInfo.strides) {
+            if (stride % (py::ssize_t)sizeof(float)) {
+              throw std::domain_error(
+                  "process_into requires an input buffer whose samples are "
+                  "aligned to multiples of 4 bytes.");
+            }
+          }
+
+          long long frameDimension = inputInfo.ndim == 1 ? 0 : 1 - channelDimension;
+          numInputSamples = inputInfo.shape[frameDimension];
+          inputSampleStride =
+              inputInfo.strides[frameDimension] / (long long)sizeof(float);
+          long long inputChannelStride =
+              inputInfo.ndim == 1 ? 0
+                                  : inputInfo.strides[channelDimension] /
+                                        (long long)sizeof(float);
+
+          inputPointers = (const float **)alloca(numChannels * sizeof(float *));
+          for (long long c = 0; c < numChannels; c++) {
+            inputPointers[c] =
+                ((const float *)inputInfo.ptr) + c * inputChannelStride;
+          }
+        }
+
+        py::gil_scoped_release release;
+        return resampler.processInto(inputPointers, numInputSamples,
+                                     inputSampleStride, outputPointers,
+                                     outputCapacity);
+      },
+      py::arg("input"), py::arg("output"),
+      R"(
+Resample a 32-bit floating-point audio buffer, writing the resampled audio
+directly into the provided ``output`` array rather than allocating a new one.
+This allows long streams to be resampled without allocating any memory after
+the first call, and without copying any audio more than once.
+
+``input`` may be shaped either ``(num_channels, num_frames)`` or
+``(num_frames, num_channels)``, and may be any (strided) view of a ``float32``
+array. ``output`` must be a writable ``float32`` array of shape
+``(num_channels, num_frames)`` (or ``(num_frames,)`` for mono audio).
+
+Returns a tuple of ``(input_frames_consumed, output_frames_written)``. The
+resampler buffers only a small, fixed amount of input, so if ``output`` is too
+small to hold all of the resampled audio, fewer than all of the input frames
+may be consumed; the remaining frames should be passed to the next call.
+
+To flush the resampler's internal buffers, pass ``None`` as ``input`` and call
+:meth:`process_into` repeatedly until it writes fewer frames than fit into
+``output``.
+
+*Introduced in v0.9.0.*
+)");
 
   resampler.def("reset", &StreamResampler<float>::reset,
                 "Used to reset the internal state of this resampler. Call this "
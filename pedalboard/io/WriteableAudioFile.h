@@ -28,6 +28,7 @@
 #include "AudioFile.h"
 #include "LameMP3AudioFormat.h"
 #include "PythonOutputStream.h"
+#include "SampleConversion.h"
 
 namespace py = pybind11;
 
@@ -222,17 +223,24 @@ public:
   WriteableAudioFile(
       std::string filename, double writeSampleRate, int numChannels = 1,
       int bitDepth = 16,
-      std::optional<std::variant<std::string, float>> qualityInput = {})
+      std::optional<std::variant<std::string, float>> qualityInput = {},
+      int numThreads = 1, bool dither = false)
       : WriteableAudioFile(filename, nullptr, writeSampleRate, numChannels,
-                           bitDepth, qualityInput) {}
+                           bitDepth, qualityInput, numThreads, dither) {}
 
   WriteableAudioFile(
       std::string filename,
       std::unique_ptr<PythonOutputStream> pythonOutputStream,
       double writeSampleRate, int numChannels = 1, int bitDepth = 16,
-      std::optional<std::variant<std::string, float>> qualityInput = {}) {
+      std::optional<std::variant<std::string, float>> qualityInput = {},
+      int numThreads = 1, bool dither = false)
+      : ditherEnabled(dither) {
     pybind11::gil_scoped_release release;
 
+    if (numThreads < 1) {
+      throw std::domain_error("num_threads must be at least 1.");
+    }
+
     if (!isInteger(writeSampleRate)) {
       throw py::type_error(
           "Opening an audio file for writing requires an integer sample rate.");
@@ -262,13 +270,13 @@ public:
           "and num_channels arguments.");
     }
 
-    registerPedalboardAudioFormats(formatManager, true);
-
     std::unique_ptr<juce::OutputStream> outputStream;
     juce::AudioFormat *format = nullptr;
     std::string extension;
 
     if (pythonOutputStream) {
+      pythonOutputStream->setStatistics(statistics);
+
       // Use the pythonOutputStream's filename if possible, falling back to the
       // provided filename string (which should contain an extension) if
       // necessary.
@@ -283,7 +291,8 @@ public:
         extension = file.getFileExtension().toStdString();
       }
 
-      format = formatManager.findFormatForFileExtension(extension);
+      format = AudioFormatRegistry::get(true).findFormatForFileExtension(
+          extension);
 
       if (!format) {
         if (pythonOutputStream->getFilename()) {
@@ -310,7 +319,8 @@ public:
                                 filename);
       }
 
-      format = formatManager.findFormatForFileExtension(extension);
+      format = AudioFormatRegistry::get(true).findFormatForFileExtension(
+          extension);
 
       if (!format) {
         if (extension.empty()) {
@@ -346,9 +356,16 @@ public:
     }
 
     juce::StringPairArray emptyMetadata;
-    writer.reset(format->createWriterFor(outputStream.get(), writeSampleRate,
-                                         numChannels, bitDepth, emptyMetadata,
-                                         qualityOptionIndex));
+    auto *flacFormat = dynamic_cast<juce::PatchedFlacAudioFormat *>(format);
+    if (flacFormat && numThreads > 1) {
+      writer.reset(flacFormat->createParallelWriterFor(
+          outputStream.get(), writeSampleRate, numChannels, bitDepth,
+          qualityOptionIndex, numThreads));
+    } else {
+      writer.reset(format->createWriterFor(outputStream.get(), writeSampleRate,
+                                           numChannels, bitDepth,
+                                           emptyMetadata, qualityOptionIndex));
+    }
     if (!writer) {
       PythonException::raise();
 
@@ -413,6 +430,7 @@ public:
       // the stream will leak.
       outputStream.release();
       PythonException::raise();
+      statistics->setFormat(format->getFormatName().toStdString());
     }
   }
 
@@ -462,6 +480,7 @@ public:
     // Release the GIL when we do the writing, after we
     // already have a reference to the input array:
     pybind11::gil_scoped_release release;
+    IOTimer timer(statistics.get(), &IOCounters::encodeNanoseconds);
 
     if (inputInfo.ndim == 1) {
       numSamples = inputInfo.shape[0];
@@ -509,6 +528,41 @@ public:
     // channel is still the same on every iteration of the loop.
     switch (inputChannelLayout) {
     case ChannelLayout::Interleaved: {
+      if (!writer->isFloatingPoint()) {
+        // Integer formats require fixed-point samples, so convert the audio
+        // as we de-interleave it, rather than making a second pass over it:
+        std::vector<std::vector<int>> fixedPointBuffers;
+        fixedPointBuffers.resize(numChannels);
+
+        int **fixedPointPointers = (int **)alloca(numChannels * sizeof(int *));
+        for (int c = 0; c < numChannels; c++) {
+          fixedPointBuffers[c].resize(
+              std::min(numSamples, DEFAULT_AUDIO_BUFFER_SIZE_FRAMES));
+          fixedPointPointers[c] = fixedPointBuffers[c].data();
+        }
+
+        for (int startSample = 0; startSample < numSamples;
+             startSample += DEFAULT_AUDIO_BUFFER_SIZE_FRAMES) {
+          int samplesToWrite = std::min(numSamples - startSample,
+                                        DEFAULT_AUDIO_BUFFER_SIZE_FRAMES);
+
+          deinterleaveToFixed(static_cast<const SampleType *>(inputInfo.ptr) +
+                                  ((size_t)startSample * numChannels),
+                              fixedPointPointers, numChannels, samplesToWrite,
+                              ditherEnabled ? &ditherState : nullptr,
+                              writer->getBitsPerSample());
+
+          bool writeSuccessful = writer->write(
+              const_cast<const int **>(fixedPointPointers), samplesToWrite);
+          PythonException::raise();
+          if (!writeSuccessful) {
+            throw std::runtime_error("Unable to write data to audio file.");
+          }
+        }
+
+        break;
+      }
+
       std::vector<std::vector<SampleType>> deinterleaveBuffers;
 
       // Use a temporary buffer to chunk the audio input
@@ -516,24 +570,25 @@ public:
       // than de-interleaving the entire buffer at once:
       deinterleaveBuffers.resize(numChannels);
 
+      SampleType **deinterleavePointers =
+          (SampleType **)alloca(numChannels * sizeof(SampleType *));
+      for (int c = 0; c < numChannels; c++) {
+        deinterleaveBuffers[c].resize(
+            std::min(numSamples, DEFAULT_AUDIO_BUFFER_SIZE_FRAMES));
+        deinterleavePointers[c] = deinterleaveBuffers[c].data();
+      }
       const SampleType **channelPointers =
-          (const SampleType **)alloca(numChannels * sizeof(SampleType *));
+          const_cast<const SampleType **>(deinterleavePointers);
+
       for (int startSample = 0; startSample < numSamples;
            startSample += DEFAULT_AUDIO_BUFFER_SIZE_FRAMES) {
         int samplesToWrite = std::min(numSamples - startSample,
                                       DEFAULT_AUDIO_BUFFER_SIZE_FRAMES);
 
-        for (int c = 0; c < numChannels; c++) {
-          deinterleaveBuffers[c].resize(samplesToWrite);
-          channelPointers[c] = deinterleaveBuffers[c].data();
-
-          // We're de-interleaving the data here, so we can't use copyFrom.
-          for (unsigned int i = 0; i < samplesToWrite; i++) {
-            deinterleaveBuffers[c][i] =
-                ((SampleType
-                      *)(inputInfo.ptr))[((i + startSample) * numChannels) + c];
-          }
-        }
+        // We're de-interleaving the data here, so we can't use copyFrom.
+        deinterleaveSamples(static_cast<const SampleType *>(inputInfo.ptr) +
+                                ((size_t)startSample * numChannels),
+                            deinterleavePointers, numChannels, samplesToWrite);
 
         bool writeSuccessful =
             write(channelPointers, numChannels, samplesToWrite);
@@ -565,6 +620,7 @@ public:
           "Internal error: got unexpected channel layout.");
     }
 
+    statistics->add(&IOCounters::framesEncoded, numSamples);
     framesWritten += numSamples;
   }
 
@@ -572,6 +628,10 @@ public:
             unsigned int bufferSize = DEFAULT_AUDIO_BUFFER_SIZE_FRAMES>
   bool writeConvertingTo(const InputType **channels, int numChannels,
                          unsigned int numSamples) {
+    static_assert(std::is_same<TargetType, int>::value ||
+                      std::is_same<TargetType, float>::value,
+                  "Audio can only be written as fixed-point or float32 data");
+
     std::vector<std::vector<TargetType>> targetTypeBuffers;
     targetTypeBuffers.resize(numChannels);
 
@@ -585,40 +645,19 @@ public:
         targetTypeBuffers[c].resize(samplesToWrite);
         channelPointers[c] = targetTypeBuffers[c].data();
 
-        if constexpr (std::is_integral<InputType>::value) {
-          if constexpr (std::is_integral<TargetType>::value) {
-            for (unsigned int i = 0; i < samplesToWrite; i++) {
-              // Left-align the samples to use all 32 bits, as JUCE requires:
-              targetTypeBuffers[c][i] =
-                  ((int)channels[c][startSample + i])
-                  << (std::numeric_limits<int>::digits -
-                      std::numeric_limits<InputType>::digits);
-            }
-          } else if constexpr (std::is_same<TargetType, float>::value) {
-            constexpr auto scaleFactor =
-                1.0f / static_cast<float>(std::numeric_limits<int>::max());
-            juce::FloatVectorOperations::convertFixedToFloat(
-                targetTypeBuffers[c].data(), channels[c] + startSample,
-                scaleFactor, samplesToWrite);
-          } else {
-            // We should never get here - this would only be true
-            // if converting to double, which no formats require:
-            static_assert(std::is_integral<InputType>::value &&
-                              std::is_same<TargetType, double>::value,
-                          "Can't convert to double");
-          }
+        if constexpr (std::is_same<TargetType, int>::value) {
+          convertToFixed(channels[c] + startSample,
+                         targetTypeBuffers[c].data(), samplesToWrite);
+        } else if constexpr (std::is_integral<InputType>::value) {
+          constexpr auto scaleFactor =
+              1.0f / static_cast<float>(std::numeric_limits<int>::max());
+          juce::FloatVectorOperations::convertFixedToFloat(
+              targetTypeBuffers[c].data(), channels[c] + startSample,
+              scaleFactor, samplesToWrite);
         } else {
-          if constexpr (std::is_integral<TargetType>::value) {
-            // We should never get here - this would only be true
-            // if converting float to int, which JUCE handles for us:
-            static_assert(std::is_integral<TargetType>::value &&
-                              !std::is_integral<InputType>::value,
-                          "Can't convert float to int");
-          } else {
-            // Converting double to float:
-            for (unsigned int i = 0; i < samplesToWrite; i++) {
-              targetTypeBuffers[c][i] = channels[c][startSample + i];
-            }
+          // Converting double to float:
+          for (unsigned int i = 0; i < samplesToWrite; i++) {
+            targetTypeBuffers[c][i] = channels[c][startSample + i];
           }
         }
       }
@@ -651,20 +690,83 @@ public:
         // works (and is documented!)
         return writer->write((const int **)channels, numSamples);
       } else {
-        // Convert floating-point to fixed point, but let JUCE do that for us:
-        return writer->writeFromFloatArrays(channels, numChannels, numSamples);
+        return writeConvertingTo<int>(channels, numChannels, numSamples);
       }
     } else {
       // We must have double-format data:
-      return writeConvertingTo<float>(channels, numChannels, numSamples);
+      if (writer->isFloatingPoint()) {
+        return writeConvertingTo<float>(channels, numChannels, numSamples);
+      } else {
+        return writeConvertingTo<int>(channels, numChannels, numSamples);
+      }
+    }
+  }
+
+  /**
+   * Convert samples into the fixed-point format expected by integer writers,
+   * dithering floating-point audio first if requested.
+   */
+  template <typename InputType>
+  void convertToFixed(const InputType *source, int *destination,
+                      unsigned int numSamples) {
+    if constexpr (std::is_integral<InputType>::value) {
+      convertIntegerToFixed(source, destination, numSamples);
+    } else if (ditherEnabled) {
+      convertFloatToFixedWithDither(source, destination, numSamples,
+                                    writer->getBitsPerSample(), ditherState);
+    } else {
+      convertFloatToFixed(source, destination, numSamples);
     }
   }
 
+  /**
+   * Write numSamples frames of non-interleaved audio from the provided
+   * buffer, starting at startSample. Unlike the Python-facing write methods,
+   * this method does not require the GIL to be held.
+   */
+  template <typename SampleType>
+  void writeBuffer(const juce::AudioBuffer<SampleType> &buffer,
+                   int startSample, int numSamples) {
+    const juce::ScopedLock scopedLock(objectLock);
+
+    if (!writer)
+      throw std::runtime_error("I/O operation on a closed file.");
+
+    if (buffer.getNumChannels() != getNumChannels()) {
+      throw std::runtime_error(
+          "WriteableAudioFile was opened with num_channels=" +
+          std::to_string(getNumChannels()) +
+          ", but was passed a buffer containing " +
+          std::to_string(buffer.getNumChannels()) + "-channel audio!");
+    }
+
+    if (numSamples <= 0)
+      return;
+
+    IOTimer timer(statistics.get(), &IOCounters::encodeNanoseconds);
+    int numChannels = buffer.getNumChannels();
+    const SampleType **channelPointers =
+        (const SampleType **)alloca(numChannels * sizeof(SampleType *));
+    for (int c = 0; c < numChannels; c++) {
+      channelPointers[c] = buffer.getReadPointer(c, startSample);
+    }
+
+    bool writeSuccessful = write(channelPointers, numChannels, numSamples);
+    PythonException::raise();
+    if (!writeSuccessful) {
+      throw std::runtime_error("Unable to write data to audio file.");
+    }
+
+    statistics->add(&IOCounters::framesEncoded, numSamples);
+    framesWritten += numSamples;
+  }
+
   void flush() {
     if (!writer)
       throw std::runtime_error("I/O operation on a closed file.");
     const juce::ScopedLock scopedLock(objectLock);
     pybind11::gil_scoped_release release;
+    IOTimer timer(statistics.get(), &IOCounters::encodeNanoseconds);
 
     if (!writer->flush()) {
       throw std::runtime_error(
@@ -676,7 +778,14 @@ public:
     if (!writer)
       throw std::runtime_error("Cannot close closed file.");
     const juce::ScopedLock scopedLock(objectLock);
-    writer.reset();
+
+    // Destroying the writer may write buffered data to a Python file-like
+    // object, which could throw:
+    {
+      IOTimer timer(statistics.get(), &IOCounters::encodeNanoseconds);
+      writer.reset();
+    }
+    PythonException::raise();
   }
 
   bool isClosed() const {
@@ -775,13 +884,14 @@ public:
   }
 
 private:
-  juce::AudioFormatManager formatManager;
   std::string filename;
   std::optional<std::string> quality;
   std::unique_ptr<juce::AudioFormatWriter> writer;
   PythonOutputStream *unsafeOutputStream = nullptr;
   juce::CriticalSection objectLock;
   int framesWritten = 0;
+  bool ditherEnabled = false;
+  TriangularDither ditherState;
 };
 
 inline py::class_<WriteableAudioFile, AudioFile,
@@ -828,6 +938,27 @@ Args:
         may be passed as a string. The strings ``"best"``, ``"worst"``,
         ``"fastest"``, and ``"slowest"`` will also work for any codec.
 
+    num_threads:
+        The number of threads to use when encoding audio. Only FLAC files
+        currently support encoding on multiple threads; other formats will
+        always be encoded on a single thread. Audio is encoded in segments of
+        a few seconds each, so multiple threads only help when writing more
+        than a few seconds of audio at a time. Files written with more than
+        one thread are valid FLAC files with the same audio content, but may
+        not be byte-for-byte identical to files encoded on one thread.
+
+        *Introduced in v0.9.0.*
+
+    dither:
+        If ``True``, add triangular (TPDF) dither when converting floating-point
+        audio to a lower integer bit depth (i.e.: writing float32 audio to a
+        16-bit WAV file), rounding each sample to the nearest integer value
+        instead of truncating it. This trades a small amount of noise for the
+        removal of quantization distortion on quiet signals. Has no effect on
+        integer input audio or on formats that store floating-point samples.
+
+        *Introduced in v0.9.0.*
+
 .. note::
     You probably don't want to use this class directly: all of the parameters
     accepted by the :class:`WriteableAudioFile` constructor will be accepted by
@@ -844,7 +975,8 @@ inline void init_writeable_audio_file(
   pyWriteableAudioFile
       .def(py::init([](std::string filename, double sampleRate, int numChannels,
                        int bitDepth,
-                       std::optional<std::variant<std::string, float>> quality)
+                       std::optional<std::variant<std::string, float>> quality,
+                       int numThreads, bool dither)
                         -> WriteableAudioFile * {
              // This definition is only here to provide nice docstrings.
              throw std::runtime_error(
@@ -853,12 +985,14 @@ inline void init_writeable_audio_file(
            }),
            py::arg("filename"), py::arg("samplerate"),
            py::arg("num_channels") = 1, py::arg("bit_depth") = 16,
-           py::arg("quality") = py::none())
+           py::arg("quality") = py::none(), py::kw_only(),
+           py::arg("num_threads") = 1, py::arg("dither") = false)
       .def(py::init(
                [](py::object filelike, double sampleRate, int numChannels,
                   int bitDepth,
                   std::optional<std::variant<std::string, float>> quality,
-                  std::optional<std::string> format) -> WriteableAudioFile * {
+                  std::optional<std::string> format,
+                  int numThreads, bool dither) -> WriteableAudioFile * {
                  // This definition is only here to provide nice docstrings.
                  throw std::runtime_error(
                      "Internal error: __init__ should never be called, as this "
@@ -866,29 +1000,33 @@ inline void init_writeable_audio_file(
                }),
            py::arg("file_like"), py::arg("samplerate"),
            py::arg("num_channels") = 1, py::arg("bit_depth") = 16,
-           py::arg("quality") = py::none(), py::arg("format") = py::none())
+           py::arg("quality") = py::none(), py::arg("format") = py::none(),
+           py::kw_only(), py::arg("num_threads") = 1, py::arg("dither") = false)
       .def_static(
           "__new__",
           [](const py::object *, std::string filename,
              std::optional<double> sampleRate, int numChannels, int bitDepth,
-             std::optional<std::variant<std::string, float>> quality) {
+             std::optional<std::variant<std::string, float>> quality,
+             int numThreads, bool dither) {
             if (!sampleRate) {
               throw py::type_error(
                   "Opening an audio file for writing requires a samplerate "
                   "argument to be provided.");
             }
             return std::make_shared<WriteableAudioFile>(
-                filename, *sampleRate, numChannels, bitDepth, quality);
+                filename, *sampleRate, numChannels, bitDepth, quality,
+                numThreads, dither);
           },
           py::arg("cls"), py::arg("filename"),
           py::arg("samplerate") = py::none(), py::arg("num_channels") = 1,
-          py::arg("bit_depth") = 16, py::arg("quality") = py::none())
+          py::arg("bit_depth") = 16, py::arg("quality") = py::none(),
+          py::kw_only(), py::arg("num_threads") = 1, py::arg("dither") = false)
       .def_static(
           "__new__",
           [](const py::object *, py::object filelike,
              std::optional<double> sampleRate, int numChannels, int bitDepth,
              std::optional<std::variant<std::string, float>> quality,
-             std::optional<std::string> format) {
+             std::optional<std::string> format, int numThreads, bool dither) {
             if (!sampleRate) {
               throw py::type_error(
                   "Opening an audio file for writing requires a samplerate "
@@ -914,18 +1052,19 @@ inline void init_writeable_audio_file(
 
             return std::make_shared<WriteableAudioFile>(
                 format.value_or(""), std::move(stream), *sampleRate,
-                numChannels, bitDepth, quality);
+                numChannels, bitDepth, quality, numThreads, dither);
           },
           py::arg("cls"), py::arg("file_like"),
           py::arg("samplerate") = py::none(), py::arg("num_channels") = 1,
           py::arg("bit_depth") = 16, py::arg("quality") = py::none(),
-          py::arg("format") = py::none())
+          py::arg("format") = py::none(), py::kw_only(),
+          py::arg("num_threads") = 1, py::arg("dither") = false)
       .def(
           "write",
-          [](WriteableAudioFile &file, py::array samples) {
-            file.write(samples);
+          [](WriteableAudioFile &file, py::object samples) {
+            file.write(asArray(samples, /* allowConversion= */ false));
           },
-          py::arg("samples").noconvert(),
+          py::arg("samples"),
           "Encode an array of audio data and write "
           "it to this file. The number of channels in the array must match the "
           "number of channels used to open the file. The array may contain "
@@ -934,7 +1073,10 @@ inline void init_writeable_audio_file(
           "converted.\n\n"
           "Arrays of type int8, int16, int32, float32, and float64 are "
           "supported. If an array of an unsupported ``dtype`` is provided, a "
-          "``TypeError`` will be raised.")
+          "``TypeError`` will be raised.\n\n"
+          "PyTorch (or other DLPack-compatible) tensors in CPU memory may "
+          "also be written directly, without first being copied into a NumPy "
+          "array.")
       .def("flush", &WriteableAudioFile::flush,
            "Attempt to flush this audio file's contents to disk. Not all "
            "formats support flushing, so this may throw a RuntimeError. (If "
@@ -1,4 +1,12 @@
 #include "juce_BlockingConvolution.h"
+#include "../simd/Dispatch.h"
+
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
 
 /*
   ==============================================================================
@@ -37,56 +45,81 @@ namespace dsp {
 
 //==============================================================================
 //==============================================================================
-struct ConvolutionEngine {
-  ConvolutionEngine(const float *samples, size_t numSamples,
-                    size_t maxBlockSize)
-      : blockSize((size_t)nextPowerOfTwo((int)maxBlockSize)),
-        fftSize(blockSize > 128 ? 2 * blockSize : 4 * blockSize),
-        fftObject(std::make_unique<FFT>(roundToInt(std::log2(fftSize)))),
-        numSegments(numSamples / (fftSize - blockSize) + 1u),
-        numInputSegments((blockSize > 128 ? numSegments : 3 * numSegments)),
-        bufferInput(1, static_cast<int>(fftSize)),
-        bufferOutput(1, static_cast<int>(fftSize * 2)),
-        bufferTempOutput(1, static_cast<int>(fftSize * 2)),
-        bufferOverlap(1, static_cast<int>(fftSize)) {
-    bufferOutput.clear();
+// After each FFT, this function is called to allow convolution to be
+// performed with only 4 SIMD functions calls.
+static void prepareForConvolution(float *samples, size_t fftSize) noexcept {
+  auto FFTSizeDiv2 = fftSize / 2;
 
-    auto updateSegmentsIfNecessary =
-        [this](size_t numSegmentsToUpdate,
-               std::vector<AudioBuffer<float>> &segments) {
-          if (numSegmentsToUpdate == 0 ||
-              numSegmentsToUpdate != (size_t)segments.size() ||
-              (size_t)segments[0].getNumSamples() != fftSize * 2) {
-            segments.clear();
+  for (size_t i = 0; i < FFTSizeDiv2; i++)
+    samples[i] = samples[i << 1];
 
-            for (size_t i = 0; i < numSegmentsToUpdate; ++i)
-              segments.push_back({1, static_cast<int>(fftSize * 2)});
-          }
-        };
+  samples[FFTSizeDiv2] = 0;
 
-    updateSegmentsIfNecessary(numInputSegments, buffersInputSegments);
-    updateSegmentsIfNecessary(numSegments, buffersImpulseSegments);
+  for (size_t i = 1; i < FFTSizeDiv2; i++)
+    samples[i + FFTSizeDiv2] = -samples[((fftSize - i) << 1) + 1];
+}
 
-    auto FFTTempObject = std::make_unique<FFT>(roundToInt(std::log2(fftSize)));
+// The frequency-domain partitions of one channel of an impulse response.
+// These never change once computed, so they can be shared between any number
+// of ConvolutionEngines (and threads).
+struct ConvolutionPartitions {
+  ConvolutionPartitions(const float *samples, size_t numSamples,
+                        size_t maxBlockSize)
+      : blockSize((size_t)nextPowerOfTwo((int)maxBlockSize)),
+        fftSize(blockSize > 128 ? 2 * blockSize : 4 * blockSize),
+        numSegments(numSamples / (fftSize - blockSize) + 1u) {
+    FFT fft(roundToInt(std::log2(fftSize)));
     size_t currentPtr = 0;
 
-    for (auto &buf : buffersImpulseSegments) {
+    for (size_t i = 0; i < numSegments; ++i) {
+      segments.push_back({1, static_cast<int>(fftSize * 2)});
+      auto &buf = segments.back();
       buf.clear();
 
       auto *impulseResponse = buf.getWritePointer(0);
 
-      if (&buf == &buffersImpulseSegments.front())
+      if (i == 0)
         impulseResponse[0] = 1.0f;
 
       FloatVectorOperations::copy(
           impulseResponse, samples + currentPtr,
           static_cast<int>(jmin(fftSize - blockSize, numSamples - currentPtr)));
 
-      FFTTempObject->performRealOnlyForwardTransform(impulseResponse);
-      prepareForConvolution(impulseResponse);
+      fft.performRealOnlyForwardTransform(impulseResponse);
+      prepareForConvolution(impulseResponse, fftSize);
 
       currentPtr += (fftSize - blockSize);
     }
+  }
+
+  const float *getSegment(size_t index) const {
+    return segments[index].getReadPointer(0);
+  }
+
+  const size_t blockSize;
+  const size_t fftSize;
+  const size_t numSegments;
+
+private:
+  std::vector<AudioBuffer<float>> segments;
+};
+
+//==============================================================================
+struct ConvolutionEngine {
+  ConvolutionEngine(std::shared_ptr<const ConvolutionPartitions> partitionsIn)
+      : partitions(std::move(partitionsIn)), blockSize(partitions->blockSize),
+        fftSize(partitions->fftSize),
+        fftObject(std::make_unique<FFT>(roundToInt(std::log2(fftSize)))),
+        numSegments(partitions->numSegments),
+        numInputSegments((blockSize > 128 ? numSegments : 3 * numSegments)),
+        bufferInput(1, static_cast<int>(fftSize)),
+        bufferOutput(1, static_cast<int>(fftSize * 2)),
+        bufferTempOutput(1, static_cast<int>(fftSize * 2)),
+        bufferOverlap(1, static_cast<int>(fftSize)) {
+    bufferOutput.clear();
+
+    for (size_t i = 0; i < numInputSegments; ++i)
+      buffersInputSegments.push_back({1, static_cast<int>(fftSize * 2)});
 
     reset();
   }
@@ -130,7 +163,7 @@ struct ConvolutionEngine {
                                   static_cast<int>(fftSize));
 
       fftObject->performRealOnlyForwardTransform(inputSegmentData);
-      prepareForConvolution(inputSegmentData);
+      prepareForConvolution(inputSegmentData, fftSize);
 
       // Complex multiplication
       if (inputDataWasEmpty) {
@@ -147,7 +180,7 @@ struct ConvolutionEngine {
 
           convolutionProcessingAndAccumulate(
               buffersInputSegments[index].getWritePointer(0),
-              buffersImpulseSegments[i].getWritePointer(0), outputTempData);
+              partitions->getSegment(i), outputTempData);
         }
       }
 
@@ -155,8 +188,7 @@ struct ConvolutionEngine {
                                   static_cast<int>(fftSize + 1));
 
       convolutionProcessingAndAccumulate(
-          inputSegmentData, buffersImpulseSegments.front().getWritePointer(0),
-          outputData);
+          inputSegmentData, partitions->getSegment(0), outputData);
 
       updateSymmetricFrequencyDomainData(outputData);
       fftObject->performRealOnlyInverseTransform(outputData);
@@ -228,7 +260,7 @@ struct ConvolutionEngine {
                                     static_cast<int>(fftSize));
 
         fftObject->performRealOnlyForwardTransform(inputSegmentData);
-        prepareForConvolution(inputSegmentData);
+        prepareForConvolution(inputSegmentData, fftSize);
 
         // Complex multiplication
         FloatVectorOperations::fill(outputTempData, 0,
@@ -244,15 +276,14 @@ struct ConvolutionEngine {
 
           convolutionProcessingAndAccumulate(
               buffersInputSegments[index].getWritePointer(0),
-              buffersImpulseSegments[i].getWritePointer(0), outputTempData);
+              partitions->getSegment(i), outputTempData);
         }
 
         FloatVectorOperations::copy(outputData, outputTempData,
                                     static_cast<int>(fftSize + 1));
 
         convolutionProcessingAndAccumulate(
-            inputSegmentData, buffersImpulseSegments.front().getWritePointer(0),
-            outputData);
+            inputSegmentData, partitions->getSegment(0), outputData);
 
         updateSymmetricFrequencyDomainData(outputData);
         fftObject->performRealOnlyInverseTransform(outputData);
@@ -281,38 +312,17 @@ struct ConvolutionEngine {
     }
   }
 
-  // After each FFT, this function is called to allow convolution to be
-  // performed with only 4 SIMD functions calls.
-  void prepareForConvolution(float *samples) noexcept {
-    auto FFTSizeDiv2 = fftSize / 2;
-
-    for (size_t i = 0; i < FFTSizeDiv2; i++)
-      samples[i] = samples[i << 1];
-
-    samples[FFTSizeDiv2] = 0;
-
-    for (size_t i = 1; i < FFTSizeDiv2; i++)
-      samples[i + FFTSizeDiv2] = -samples[((fftSize - i) << 1) + 1];
-  }
-
   // Does the convolution operation itself only on half of the frequency domain
   // samples.
   void convolutionProcessingAndAccumulate(const float *input,
                                           const float *impulse, float *output) {
     auto FFTSizeDiv2 = fftSize / 2;
 
-    FloatVectorOperations::addWithMultiply(output, input, impulse,
-                                           static_cast<int>(FFTSizeDiv2));
-    FloatVectorOperations::subtractWithMultiply(output, &(input[FFTSizeDiv2]),
-                                                &(impulse[FFTSizeDiv2]),
-                                                static_cast<int>(FFTSizeDiv2));
-
-    FloatVectorOperations::addWithMultiply(&(output[FFTSizeDiv2]), input,
-                                           &(impulse[FFTSizeDiv2]),
-                                           static_cast<int>(FFTSizeDiv2));
-    FloatVectorOperations::addWithMultiply(&(output[FFTSizeDiv2]),
-                                           &(input[FFTSizeDiv2]), impulse,
-                                           static_cast<int>(FFTSizeDiv2));
+    // Unlike JUCE's four separate passes over the spectra, a single fused
+    // pass (dispatched at runtime to the best available instruction set)
+    // reads each input only once:
+    Pedalboard::simd::getKernels().complexMultiplyAccumulate(
+        output, input, impulse, static_cast<int>(FFTSizeDiv2));
 
     output[fftSize] += input[fftSize] * impulse[fftSize];
   }
@@ -338,6 +348,7 @@ struct ConvolutionEngine {
   }
 
   //==============================================================================
+  const std::shared_ptr<const ConvolutionPartitions> partitions;
   const size_t blockSize;
   const size_t fftSize;
   const std::unique_ptr<FFT> fftObject;
@@ -346,46 +357,75 @@ struct ConvolutionEngine {
   size_t currentSegment = 0, inputDataPos = 0;
 
   AudioBuffer<float> bufferInput, bufferOutput, bufferTempOutput, bufferOverlap;
-  std::vector<AudioBuffer<float>> buffersInputSegments, buffersImpulseSegments;
+  std::vector<AudioBuffer<float>> buffersInputSegments;
+};
+
+//==============================================================================
+// The partitions of every channel of an impulse response's head (and of its
+// tail, when using non-uniform partitioning). Like ConvolutionPartitions,
+// these are immutable, and can be shared between MultichannelEngines.
+struct MultichannelPartitions {
+  MultichannelPartitions(const AudioBuffer<float> &buf, int maxBufferSize,
+                         Convolution::NonUniform headSizeIn, bool isZeroDelay)
+      : irSize(buf.getNumSamples()) {
+    for (int channel = 0; channel < buf.getNumChannels(); ++channel) {
+      const auto makePartitions = [&](int offset, int length,
+                                      uint32 thisBlockSize) {
+        return std::make_shared<const ConvolutionPartitions>(
+            buf.getReadPointer(channel, offset), length,
+            static_cast<size_t>(thisBlockSize));
+      };
+
+      if (headSizeIn.headSizeInSamples == 0) {
+        head.push_back(makePartitions(0, buf.getNumSamples(),
+                                      static_cast<uint32>(maxBufferSize)));
+      } else {
+        const auto size =
+            jmin(buf.getNumSamples(), headSizeIn.headSizeInSamples);
+
+        head.push_back(
+            makePartitions(0, size, static_cast<uint32>(maxBufferSize)));
+
+        const auto tailBufferSize = static_cast<uint32>(
+            headSizeIn.headSizeInSamples + (isZeroDelay ? 0 : maxBufferSize));
+
+        if (size != buf.getNumSamples())
+          tail.push_back(makePartitions(size, buf.getNumSamples() - size,
+                                        tailBufferSize));
+      }
+    }
+  }
+
+  const int irSize;
+  std::vector<std::shared_ptr<const ConvolutionPartitions>> head, tail;
 };
 
 //==============================================================================
 class MultichannelEngine {
 public:
-  MultichannelEngine(const AudioBuffer<float> &buf, int maxBlockSize,
-                     int maxBufferSize, Convolution::NonUniform headSizeIn,
-                     bool isZeroDelayIn)
-      : tailBuffer(1, maxBlockSize), latency(isZeroDelayIn ? 0 : maxBufferSize),
-        irSize(buf.getNumSamples()), blockSize(maxBlockSize),
+  MultichannelEngine(std::shared_ptr<const MultichannelPartitions> partitions,
+                     int maxBlockSize, int maxBufferSize, bool isZeroDelayIn,
+                     int numChannelsIn)
+      : tailBuffer(jmax(2, numChannelsIn), maxBlockSize),
+        tailInputBuffer(jmax(2, numChannelsIn), maxBlockSize),
+        latency(isZeroDelayIn ? 0 : maxBufferSize),
+        irSize(partitions->irSize), blockSize(maxBlockSize),
         isZeroDelay(isZeroDelayIn) {
-    constexpr auto numChannels = 2;
-
-    const auto makeEngine = [&](int channel, int offset, int length,
-                                uint32 thisBlockSize) {
-      return std::make_unique<ConvolutionEngine>(
-          buf.getReadPointer(jmin(buf.getNumChannels() - 1, channel), offset),
-          length, static_cast<size_t>(thisBlockSize));
-    };
-
-    if (headSizeIn.headSizeInSamples == 0) {
-      for (int i = 0; i < numChannels; ++i)
-        head.emplace_back(makeEngine(i, 0, buf.getNumSamples(),
-                                     static_cast<uint32>(maxBufferSize)));
-    } else {
-      const auto size = jmin(buf.getNumSamples(), headSizeIn.headSizeInSamples);
-
-      for (int i = 0; i < numChannels; ++i)
-        head.emplace_back(
-            makeEngine(i, 0, size, static_cast<uint32>(maxBufferSize)));
-
-      const auto tailBufferSize = static_cast<uint32>(
-          headSizeIn.headSizeInSamples + (isZeroDelay ? 0 : maxBufferSize));
-
-      if (size != buf.getNumSamples())
-        for (int i = 0; i < numChannels; ++i)
-          tail.emplace_back(
-              makeEngine(i, size, buf.getNumSamples() - size, tailBufferSize));
-    }
+    // Create one engine per channel (rather than always two) so
+    // that multichannel audio is convolved on every channel. Channels beyond
+    // the impulse response's channel count alternate between its channels
+    // (i.e.: L, R, L, R, ... for a stereo impulse response), sharing their
+    // partitions.
+    const auto numChannels = static_cast<size_t>(jmax(2, numChannelsIn));
+
+    for (size_t i = 0; i < numChannels; ++i)
+      head.emplace_back(std::make_unique<ConvolutionEngine>(
+          partitions->head[i % partitions->head.size()]));
+
+    if (!partitions->tail.empty())
+      for (size_t i = 0; i < numChannels; ++i)
+        tail.emplace_back(std::make_unique<ConvolutionEngine>(
+            partitions->tail[i % partitions->tail.size()]));
   }
 
   void reset() {
@@ -397,22 +437,23 @@ public:
   }
 
   void processSamples(const AudioBlock<const float> &input,
-                      AudioBlock<float> &output) {
+                      AudioBlock<float> &output,
+                      ThreadPool *threadPool = nullptr) {
     const auto numChannels =
         jmin(head.size(), input.getNumChannels(), output.getNumChannels());
     const auto numSamples = jmin(input.getNumSamples(), output.getNumSamples());
 
+    if (numChannels == 0)
+      return;
+
+    // Each channel's tail is convolved into its own channel of tailBuffer, so
+    // that heads and tails can be computed independently of one another:
     const AudioBlock<float> fullTailBlock(tailBuffer);
     const auto tailBlock = fullTailBlock.getSubBlock(0, (size_t)numSamples);
 
     const auto isUniform = tail.empty();
 
-    for (size_t channel = 0; channel < numChannels; ++channel) {
-      if (!isUniform)
-        tail[channel]->processSamplesWithAddedLatency(
-            input.getChannelPointer(channel), tailBlock.getChannelPointer(0),
-            numSamples);
-
+    const auto processHead = [&](size_t channel) {
       if (isZeroDelay)
         head[channel]->processSamples(input.getChannelPointer(channel),
                                       output.getChannelPointer(channel),
@@ -421,11 +462,71 @@ public:
         head[channel]->processSamplesWithAddedLatency(
             input.getChannelPointer(channel), output.getChannelPointer(channel),
             numSamples);
+    };
+
+    // When processing in place, a channel's head may overwrite its input
+    // while its tail is still reading it, so concurrent tails read a copy:
+    const auto tailReadsCopy = [&](size_t channel) {
+      return threadPool != nullptr &&
+             input.getChannelPointer(channel) ==
+                 output.getChannelPointer(channel);
+    };
 
-      if (!isUniform)
-        output.getSingleChannelBlock(channel) += tailBlock;
+    const auto processTail = [&](size_t channel) {
+      tail[channel]->processSamplesWithAddedLatency(
+          tailReadsCopy(channel) ? tailInputBuffer.getReadPointer((int)channel)
+                                 : input.getChannelPointer(channel),
+          tailBlock.getChannelPointer(channel), numSamples);
+    };
+
+    if (threadPool == nullptr) {
+      for (size_t channel = 0; channel < numChannels; ++channel) {
+        if (!isUniform)
+          processTail(channel);
+        processHead(channel);
+      }
+    } else {
+      std::mutex jobsRemainingMutex;
+      std::condition_variable allJobsDone;
+      size_t jobsRemaining = (numChannels - 1) + (isUniform ? 0 : numChannels);
+
+      const auto addJob = [&](std::function<void()> job) {
+        threadPool->addJob([&, job]() {
+          job();
+
+          // Notify while holding the lock, as the waiting thread will destroy
+          // this condition variable as soon as it's able to return:
+          std::lock_guard<std::mutex> lock(jobsRemainingMutex);
+          if (--jobsRemaining == 0)
+            allJobsDone.notify_one();
+        });
+      };
+
+      // Tails are the most expensive to compute, so start them first:
+      if (!isUniform) {
+        for (size_t channel = 0; channel < numChannels; ++channel) {
+          if (tailReadsCopy(channel))
+            FloatVectorOperations::copy(
+                tailInputBuffer.getWritePointer((int)channel),
+                input.getChannelPointer(channel), (int)numSamples);
+          addJob([&, channel]() { processTail(channel); });
+        }
+      }
+
+      for (size_t channel = 1; channel < numChannels; ++channel)
+        addJob([&, channel]() { processHead(channel); });
+
+      processHead(0);
+
+      std::unique_lock<std::mutex> lock(jobsRemainingMutex);
+      allJobsDone.wait(lock, [&]() { return jobsRemaining == 0; });
     }
 
+    if (!isUniform)
+      for (size_t channel = 0; channel < numChannels; ++channel)
+        output.getSingleChannelBlock(channel) +=
+            tailBlock.getSingleChannelBlock(channel);
+
     const auto numOutputChannels = output.getNumChannels();
 
     for (auto i = numChannels; i < numOutputChannels; ++i)
@@ -438,7 +539,7 @@ public:
 
 private:
   std::vector<std::unique_ptr<ConvolutionEngine>> head, tail;
-  AudioBuffer<float> tailBuffer;
+  AudioBuffer<float> tailBuffer, tailInputBuffer;
 
   const int latency;
   const int irSize;
@@ -603,6 +704,87 @@ loadStreamToBuffer(std::unique_ptr<InputStream> stream, size_t maxLength) {
   return result;
 }
 
+// A process-wide cache of immutable values, each of which is shared between
+// every user of the same key and freed once the last of them is destroyed.
+template <typename Value> class SharedValueCache {
+public:
+  template <typename BuildFunction>
+  std::shared_ptr<const Value> get(const String &key, BuildFunction build) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (auto value = entries[key].lock())
+        return value;
+    }
+
+    // Values can be expensive to build, so build them without holding the
+    // lock (so that unrelated values can be built concurrently):
+    std::shared_ptr<const Value> value = build();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &entry = entries[key];
+
+    // Another thread may have built the same value in the meantime:
+    if (auto existing = entry.lock())
+      return existing;
+
+    for (auto it = entries.begin(); it != entries.end();) {
+      if (&it->second != &entry && it->second.expired())
+        it = entries.erase(it);
+      else
+        ++it;
+    }
+
+    entry = value;
+    return value;
+  }
+
+private:
+  std::mutex mutex;
+  std::map<String, std::weak_ptr<const Value>> entries;
+};
+
+// A hash of an impulse response's samples, shape and sample rate, used to
+// identify impulse responses that were provided as buffers:
+static String hashImpulseResponse(const BufferWithSampleRate &ir) {
+  // 64-bit FNV-1a, applied to whole words rather than to individual bytes:
+  uint64 hash = 14695981039346656037ull;
+  const auto combine = [&hash](uint64 value) {
+    hash = (hash ^ value) * 1099511628211ull;
+  };
+
+  uint64 sampleRateBits;
+  std::memcpy(&sampleRateBits, &ir.sampleRate, sizeof(sampleRateBits));
+  combine(sampleRateBits);
+  combine((uint64)ir.buffer.getNumChannels());
+  combine((uint64)ir.buffer.getNumSamples());
+
+  for (int channel = 0; channel < ir.buffer.getNumChannels(); ++channel) {
+    const auto *samples = ir.buffer.getReadPointer(channel);
+    for (int i = 0; i < ir.buffer.getNumSamples(); ++i) {
+      uint32 sampleBits;
+      std::memcpy(&sampleBits, samples + i, sizeof(sampleBits));
+      combine(sampleBits);
+    }
+  }
+
+  return String::toHexString((int64)hash) + "x" +
+         String(ir.buffer.getNumChannels()) + "x" +
+         String(ir.buffer.getNumSamples());
+}
+
+// Decoded (and trimmed) impulse responses loaded from files or buffers:
+static SharedValueCache<BufferWithSampleRate> &getImpulseResponseCache() {
+  static SharedValueCache<BufferWithSampleRate> cache;
+  return cache;
+}
+
+// Resampled, normalised and transformed impulse responses, ready for use by
+// MultichannelEngines:
+static SharedValueCache<MultichannelPartitions> &getPartitionsCache() {
+  static SharedValueCache<MultichannelPartitions> cache;
+  return cache;
+}
+
 // This class caches the data required to build a new convolution engine
 // (in particular, impulse response data and a ProcessSpec).
 // Calls to `setProcessSpec` and `setImpulseResponse` construct a
@@ -640,18 +822,50 @@ public:
   void setImpulseResponse(BufferWithSampleRate &&buf,
                           Convolution::Stereo stereo, Convolution::Trim trim,
                           Convolution::Normalise normalise) {
-    wantsNormalise = normalise;
-    originalSampleRate = buf.sampleRate;
+    // Buffers are identified by their contents, so that passing the same
+    // impulse response again reuses its partitions:
+    const auto key = "buffer|" + hashImpulseResponse(buf) + "|" +
+                     String((int)stereo) + "|" + String((int)trim);
 
-    impulseResponse = [&] {
-      auto corrected = fixNumChannels(buf.buffer, stereo);
-      return trim == Convolution::Trim::yes ? trimImpulseResponse(corrected)
-                                            : corrected;
-    }();
+    auto prepared = getImpulseResponseCache().get(key, [&] {
+      return std::make_shared<const BufferWithSampleRate>(
+          prepareImpulseResponse(buf, stereo, trim));
+    });
+
+    setImpulseResponse(std::move(prepared), key, normalise);
+  }
+
+  // Use an impulse response that has already been passed through
+  // prepareImpulseResponse. If a non-empty key is provided, it must uniquely
+  // identify the impulse response's contents, and the engine's partitions
+  // will be shared with every other factory using the same key and settings.
+  void setImpulseResponse(std::shared_ptr<const BufferWithSampleRate> buf,
+                          const String &key,
+                          Convolution::Normalise normalise) {
+    wantsNormalise = normalise;
+    impulseResponse = std::move(buf);
+    impulseResponseKey = key;
 
     engine = makeEngine();
   }
 
+  // Use the same impulse response (and process spec) as another factory,
+  // so that the new engine's partitions are shared with the other's.
+  void setImpulseResponseFrom(const BlockingConvolutionEngineFactory &other) {
+    processSpec = other.processSpec;
+    setImpulseResponse(other.impulseResponse, other.impulseResponseKey,
+                       other.wantsNormalise);
+  }
+
+  static BufferWithSampleRate
+  prepareImpulseResponse(const BufferWithSampleRate &buf,
+                         Convolution::Stereo stereo, Convolution::Trim trim) {
+    auto corrected = fixNumChannels(buf.buffer, stereo);
+    return {trim == Convolution::Trim::yes ? trimImpulseResponse(corrected)
+                                           : std::move(corrected),
+            buf.sampleRate};
+  }
+
   MultichannelEngine &getEngine() const {
     if (!engine) {
       throw std::runtime_error("Attempted to use Convolution without setting "
@@ -662,32 +876,54 @@ public:
 
 private:
   std::unique_ptr<MultichannelEngine> makeEngine() {
-    auto resampled = resampleImpulseResponse(
-        impulseResponse, originalSampleRate, processSpec.sampleRate);
-
-    if (wantsNormalise == Convolution::Normalise::yes)
-      normaliseImpulseResponse(resampled);
-
     const auto currentLatency =
         jmax(processSpec.maximumBlockSize, (uint32)latency.latencyInSamples);
     const auto maxBufferSize =
         shouldBeZeroLatency ? static_cast<int>(processSpec.maximumBlockSize)
                             : nextPowerOfTwo(static_cast<int>(currentLatency));
 
+    const auto makePartitions = [&] {
+      auto resampled = resampleImpulseResponse(impulseResponse->buffer,
+                                               impulseResponse->sampleRate,
+                                               processSpec.sampleRate);
+
+      if (wantsNormalise == Convolution::Normalise::yes)
+        normaliseImpulseResponse(resampled);
+
+      return std::make_shared<const MultichannelPartitions>(
+          resampled, maxBufferSize, headSize, shouldBeZeroLatency);
+    };
+
+    // The partitions depend only on the impulse response and on the settings
+    // below (and not on the number of channels being processed):
+    const auto partitions =
+        impulseResponseKey.isEmpty()
+            ? makePartitions()
+            : getPartitionsCache().get(
+                  impulseResponseKey + "|" +
+                      String(processSpec.sampleRate, 6) + "|" +
+                      String(maxBufferSize) + "|" +
+                      String(headSize.headSizeInSamples) + "|" +
+                      String((int)shouldBeZeroLatency) + "|" +
+                      String((int)wantsNormalise),
+                  makePartitions);
+
     return std::make_unique<MultichannelEngine>(
-        resampled, processSpec.maximumBlockSize, maxBufferSize, headSize,
-        shouldBeZeroLatency);
+        partitions, processSpec.maximumBlockSize, maxBufferSize,
+        shouldBeZeroLatency, static_cast<int>(processSpec.numChannels));
   }
 
-  static AudioBuffer<float> makeImpulseBuffer() {
+  static std::shared_ptr<const BufferWithSampleRate> makeImpulseBuffer() {
     AudioBuffer<float> result(1, 1);
     result.setSample(0, 0, 1.0f);
-    return result;
+    return std::make_shared<const BufferWithSampleRate>(std::move(result),
+                                                        44100.0);
   }
 
   ProcessSpec processSpec{44100.0, 128, 2};
-  AudioBuffer<float> impulseResponse = makeImpulseBuffer();
-  double originalSampleRate = processSpec.sampleRate;
+  std::shared_ptr<const BufferWithSampleRate> impulseResponse =
+      makeImpulseBuffer();
+  String impulseResponseKey;
   Convolution::Normalise wantsNormalise = Convolution::Normalise::no;
   const Convolution::Latency latency;
   const Convolution::NonUniform headSize;
@@ -713,10 +949,24 @@ static void setImpulseResponse(BlockingConvolutionEngineFactory &factory,
                                Convolution::Stereo stereo,
                                Convolution::Trim trim, size_t size,
                                Convolution::Normalise normalise) {
-  factory.setImpulseResponse(
-      loadStreamToBuffer(std::make_unique<FileInputStream>(fileImpulseResponse),
-                         size),
-      stereo, trim, normalise);
+  // Files are identified by their path and by their size and modification
+  // time, so that a file that changes on disk is loaded again:
+  const auto key = fileImpulseResponse.getFullPathName() + "|" +
+                   String(fileImpulseResponse.getLastModificationTime()
+                              .toMilliseconds()) +
+                   "|" + String(fileImpulseResponse.getSize()) + "|" +
+                   String((uint64)size) + "|" + String((int)stereo) + "|" +
+                   String((int)trim);
+
+  auto impulseResponse = getImpulseResponseCache().get(key, [&] {
+    return std::make_shared<const BufferWithSampleRate>(
+        BlockingConvolutionEngineFactory::prepareImpulseResponse(
+            loadStreamToBuffer(
+                std::make_unique<FileInputStream>(fileImpulseResponse), size),
+            stereo, trim));
+  });
+
+  factory.setImpulseResponse(std::move(impulseResponse), key, normalise);
 }
 
 class BlockingConvolution::Impl {
@@ -731,9 +981,22 @@ public:
 
   void processSamples(const AudioBlock<const float> &input,
                       AudioBlock<float> &output) {
-    engineFactory.getEngine().processSamples(input, output);
+    engineFactory.getEngine().processSamples(input, output, threadPool.get());
   }
 
+  void setNumThreads(int newNumThreads) {
+    numThreads = jmax(1, newNumThreads);
+
+    // The calling thread does some of the work itself, so the pool only needs
+    // numThreads - 1 workers:
+    if (numThreads == 1)
+      threadPool.reset();
+    else if (!threadPool || threadPool->getNumThreads() != numThreads - 1)
+      threadPool = std::make_unique<ThreadPool>(numThreads - 1);
+  }
+
+  int getNumThreads() const { return numThreads; }
+
   int getCurrentIRSize() const { return engineFactory.getEngine().getIRSize(); }
 
   int getLatency() const { return engineFactory.getEngine().getLatency(); }
@@ -761,8 +1024,14 @@ public:
                        normalise);
   }
 
+  void loadImpulseResponseFrom(const Impl &other) {
+    engineFactory.setImpulseResponseFrom(other.engineFactory);
+  }
+
 private:
   BlockingConvolutionEngineFactory engineFactory;
+  std::unique_ptr<ThreadPool> threadPool;
+  int numThreads = 1;
 };
 
 //==============================================================================
@@ -806,6 +1075,11 @@ void BlockingConvolution::loadImpulseResponse(
                              trim, normalise);
 }
 
+void BlockingConvolution::loadImpulseResponseFrom(
+    const BlockingConvolution &other) {
+  pimpl->loadImpulseResponseFrom(*other.pimpl);
+}
+
 void BlockingConvolution::prepare(const ProcessSpec &spec) {
   pimpl->prepare(spec);
   isActive = true;
@@ -833,5 +1107,13 @@ int BlockingConvolution::getCurrentIRSize() const {
 
 int BlockingConvolution::getLatency() const { return pimpl->getLatency(); }
 
+void BlockingConvolution::setNumThreads(int numThreads) {
+  pimpl->setNumThreads(numThreads);
+}
+
+int BlockingConvolution::getNumThreads() const {
+  return pimpl->getNumThreads();
+}
+
 } // namespace dsp
 } // namespace juce
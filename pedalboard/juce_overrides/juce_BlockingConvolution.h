@@ -189,6 +189,13 @@ public:
                            Convolution::Trim requiresTrimming,
                            Convolution::Normalise requiresNormalisation);
 
+  /** Use the same impulse response as another BlockingConvolution, sharing
+      its (immutable) decoded impulse response and, when prepared with the
+      same settings, its transformed partitions rather than copying them.
+      The other convolution's latency and head size are not copied.
+  */
+  void loadImpulseResponseFrom(const BlockingConvolution &other);
+
   /** This function returns the size of the current IR in samples. */
   int getCurrentIRSize() const;
 
@@ -200,6 +207,18 @@ public:
   */
   int getLatency() const;
 
+  /** Sets the number of threads used to convolve audio. With more than one
+      thread, the head and tail partitions of each channel are convolved
+      concurrently, with all but one channel's head computed on a pool of
+      worker threads owned by this object. Each partition is still computed
+      in the same order, so the output does not depend on the number of
+      threads.
+  */
+  void setNumThreads(int numThreads);
+
+  /** Returns the number of threads used to convolve audio. */
+  int getNumThreads() const;
+
 private:
   //==============================================================================
   BlockingConvolution(const Convolution::Latency &,
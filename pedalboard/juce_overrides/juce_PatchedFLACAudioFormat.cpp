@@ -24,6 +24,12 @@
 */
 
 #include "juce_PatchedFLACAudioFormat.h"
+#include "juce_SeekTableCache.h"
+
+#include <atomic>
+#include <map>
+#include <thread>
+#include <vector>
 
 #if defined _WIN32 && !defined __CYGWIN__
 #include <io.h>
@@ -164,6 +170,19 @@ template <typename Item> auto emptyRange(Item item) {
   return Range<Item>::emptyRange(item);
 }
 
+//==============================================================================
+/** The location of a single FLAC frame within a stream. */
+struct FlacFrameLocation {
+  int64 byteOffset = 0;
+  int numSamples = 0;
+};
+
+/**
+ * Maps the first sample of each known frame in a FLAC stream to its location.
+ * Not every frame needs to be present; gaps are filled in as needed.
+ */
+using FlacFrameIndex = std::map<int64, FlacFrameLocation>;
+
 //==============================================================================
 class PatchedFlacReader : public AudioFormatReader {
 public:
@@ -171,6 +190,10 @@ public:
     lengthInSamples = 0;
     decoder = PatchedFlacNamespace::FLAC__stream_decoder_new();
 
+    // Seek tables (if present) are used to build our own frame index:
+    FLAC__stream_decoder_set_metadata_respond(
+        decoder, PatchedFlacNamespace::FLAC__METADATA_TYPE_SEEKTABLE);
+
     ok = FLAC__stream_decoder_init_stream(
              decoder, readCallback_, seekCallback_, tellCallback_,
              lengthCallback_, eofCallback_, writeCallback_, metadataCallback_,
@@ -192,6 +215,8 @@ public:
         FLAC__stream_decoder_process_until_end_of_metadata(decoder);
         lengthInSamples = tempLength;
       }
+
+      initialiseFrameIndex();
     }
   }
 
@@ -205,6 +230,8 @@ public:
     bitsPerSample = info.bits_per_sample;
     lengthInSamples = (unsigned int)info.total_samples;
     numChannels = info.channels;
+    minBlockSize = (int)info.min_blocksize;
+    maxFrameSize = (int)info.max_framesize;
 
     reservoir.setSize((int)numChannels, 2 * (int)info.max_blocksize, false,
                       false, true);
@@ -243,6 +270,9 @@ public:
 
       if (requestedStart < bufferedRange.getStart() ||
           requestedStart > bufferedRange.getEnd()) {
+        if (seekToFrameContaining(requestedStart))
+          return;
+
         bufferedRange = emptyRange(requestedStart);
         FLAC__stream_decoder_seek_absolute(
             decoder,
@@ -267,6 +297,33 @@ public:
     return true;
   }
 
+  /**
+   * Return the first sample of the frame containing the provided sample, or
+   * the provided sample itself if that frame can't be found without decoding.
+   * Doesn't change the position that the next read will decode from.
+   */
+  int64 getStartOfFrameContaining(int64 sample) {
+    if (!ok || frameIndex.empty())
+      return sample;
+
+    const auto originalPosition = input->getPosition();
+    FlacFrameIndex::const_iterator frame;
+    const bool found = findFrameContaining(sample, frame);
+    input->setPosition(originalPosition);
+    return found ? frame->first : sample;
+  }
+
+  void
+  useSeekTable(const PatchedFlacNamespace::FLAC__StreamMetadata_SeekTable &table) {
+    seekPoints.clearQuick();
+    for (unsigned int i = 0; i < table.num_points; i++) {
+      // Placeholder points have no location, and are ignored:
+      if (table.points[i].sample_number !=
+          PatchedFlacNamespace::FLAC__STREAM_METADATA_SEEKPOINT_PLACEHOLDER)
+        seekPoints.add(table.points[i]);
+    }
+  }
+
   void useSamples(const PatchedFlacNamespace::FLAC__int32 *const buffer[],
                   int numSamples) {
     if (scanningForLength) {
@@ -311,7 +368,7 @@ public:
                 PatchedFlacNamespace::FLAC__uint64 absolute_byte_offset,
                 void *client_data) {
     static_cast<const PatchedFlacReader *>(client_data)
-        ->input->setPosition((int)absolute_byte_offset);
+        ->input->setPosition((int64)absolute_byte_offset);
     return PatchedFlacNamespace::FLAC__STREAM_DECODER_SEEK_STATUS_OK;
   }
 
@@ -356,8 +413,12 @@ public:
   metadataCallback_(const PatchedFlacNamespace::FLAC__StreamDecoder *,
                     const PatchedFlacNamespace::FLAC__StreamMetadata *metadata,
                     void *client_data) {
-    static_cast<PatchedFlacReader *>(client_data)
-        ->useMetadata(metadata->data.stream_info);
+    auto *reader = static_cast<PatchedFlacReader *>(client_data);
+    if (metadata->type == PatchedFlacNamespace::FLAC__METADATA_TYPE_STREAMINFO)
+      reader->useMetadata(metadata->data.stream_info);
+    else if (metadata->type ==
+             PatchedFlacNamespace::FLAC__METADATA_TYPE_SEEKTABLE)
+      reader->useSeekTable(metadata->data.seek_table);
   }
 
   static void
@@ -366,11 +427,283 @@ public:
   }
 
 private:
+  /**
+   * The longest possible FLAC frame header: sync code and flags (4 bytes), the
+   * sample or frame number (up to 7 bytes), an explicit block size and sample
+   * rate (up to 2 bytes each) and a CRC-8.
+   */
+  static constexpr int maxFrameHeaderSize = 16;
+
+  struct FrameHeader {
+    int64 firstSample = 0;
+    int numSamples = 0;
+  };
+
+  /**
+   * Parse (and verify the CRC of) a FLAC frame header from the provided bytes.
+   */
+  bool parseFrameHeader(const uint8 *data, int numBytes,
+                        FrameHeader &header) const {
+    if (numBytes < 5 || data[0] != 0xff || (data[1] & 0xfe) != 0xf8)
+      return false;
+
+    const bool variableBlockSize = (data[1] & 1) != 0;
+    const int blockSizeCode = data[2] >> 4;
+    const int sampleRateCode = data[2] & 15;
+    const int channelCode = data[3] >> 4;
+    const int sampleSizeCode = (data[3] >> 1) & 7;
+
+    if (blockSizeCode == 0 || sampleRateCode == 15 || channelCode > 10 ||
+        sampleSizeCode == 3 || sampleSizeCode == 7 || (data[3] & 1) != 0)
+      return false;
+
+    // The frame or sample number is stored in an extended UTF-8 encoding:
+    int position = 4;
+    const uint8 firstByte = data[position++];
+    uint64 number = 0;
+    int numContinuationBytes = 0;
+
+    if ((firstByte & 0x80) == 0) {
+      number = firstByte;
+    } else if ((firstByte & 0xe0) == 0xc0) {
+      number = firstByte & 0x1f;
+      numContinuationBytes = 1;
+    } else if ((firstByte & 0xf0) == 0xe0) {
+      number = firstByte & 0x0f;
+      numContinuationBytes = 2;
+    } else if ((firstByte & 0xf8) == 0xf0) {
+      number = firstByte & 0x07;
+      numContinuationBytes = 3;
+    } else if ((firstByte & 0xfc) == 0xf8) {
+      number = firstByte & 0x03;
+      numContinuationBytes = 4;
+    } else if ((firstByte & 0xfe) == 0xfc) {
+      number = firstByte & 0x01;
+      numContinuationBytes = 5;
+    } else if (firstByte == 0xfe && variableBlockSize) {
+      numContinuationBytes = 6;
+    } else {
+      return false;
+    }
+
+    // Bytes following the frame number: an optional block size and sample
+    // rate, then the CRC-8 of the header:
+    const int numTrailingBytes =
+        (blockSizeCode == 6 ? 1 : (blockSizeCode == 7 ? 2 : 0)) +
+        (sampleRateCode == 12 ? 1
+                              : (sampleRateCode == 13 || sampleRateCode == 14)
+                                    ? 2
+                                    : 0) +
+        1;
+
+    if (position + numContinuationBytes + numTrailingBytes > numBytes)
+      return false;
+
+    for (int i = 0; i < numContinuationBytes; i++) {
+      const uint8 byte = data[position++];
+      if ((byte & 0xc0) != 0x80)
+        return false;
+      number = (number << 6) | (byte & 0x3f);
+    }
+
+    if (blockSizeCode == 1) {
+      header.numSamples = 192;
+    } else if (blockSizeCode <= 5) {
+      header.numSamples = 576 << (blockSizeCode - 2);
+    } else if (blockSizeCode == 6) {
+      header.numSamples = data[position++] + 1;
+    } else if (blockSizeCode == 7) {
+      header.numSamples = ((data[position] << 8) | data[position + 1]) + 1;
+      position += 2;
+    } else {
+      header.numSamples = 256 << (blockSizeCode - 8);
+    }
+
+    if (sampleRateCode == 12)
+      position += 1;
+    else if (sampleRateCode == 13 || sampleRateCode == 14)
+      position += 2;
+
+    if (PatchedFlacNamespace::FLAC__crc8(data, (unsigned)position) !=
+        data[position])
+      return false;
+
+    header.firstSample =
+        variableBlockSize ? (int64)number : (int64)number * minBlockSize;
+    return true;
+  }
+
+  bool readFrameHeaderAt(int64 byteOffset, FrameHeader &header) {
+    uint8 data[maxFrameHeaderSize];
+    if (!input->setPosition(byteOffset))
+      return false;
+    return parseFrameHeader(data, input->read(data, sizeof(data)), header);
+  }
+
+  /**
+   * Create an index of the frames in this stream, from the stream's
+   * SEEKTABLE (if present) and a cached index of the same file (if one
+   * exists). Gaps between the frames in this index are filled in as
+   * necessary when seeking.
+   */
+  void initialiseFrameIndex() {
+    PatchedFlacNamespace::FLAC__uint64 position = 0;
+    if (!FLAC__stream_decoder_get_decode_position(decoder, &position))
+      return;
+    firstFrameOffset = (int64)position;
+
+    frameIndexCacheKey = SeekTableCache<FlacFrameIndex>::getKeyFor(input);
+    if (SeekTableCache<FlacFrameIndex>::getInstance().get(frameIndexCacheKey,
+                                                          frameIndex))
+      return;
+
+    FrameHeader header;
+    const auto originalPosition = input->getPosition();
+    if (readFrameHeaderAt(firstFrameOffset, header) && header.firstSample == 0)
+      frameIndex[0] = {firstFrameOffset, header.numSamples};
+
+    for (auto &point : seekPoints) {
+      if (point.frame_samples > 0)
+        frameIndex[(int64)point.sample_number] = {
+            firstFrameOffset + (int64)point.stream_offset,
+            (int)point.frame_samples};
+    }
+    input->setPosition(originalPosition);
+  }
+
+  /**
+   * Find the location of the frame that contains the provided sample, by
+   * scanning forward through frame headers from the closest known frame. Any
+   * frames found along the way are added to the frame index.
+   */
+  bool findFrameContaining(int64 sample,
+                           FlacFrameIndex::const_iterator &result) {
+    auto frame = frameIndex.upper_bound(sample);
+    if (frame == frameIndex.begin())
+      return false;
+    --frame;
+
+    static constexpr int windowSize = 65536;
+    HeapBlock<uint8> window;
+    int64 windowStart = 0;
+    int windowLength = 0;
+    bool indexChanged = false;
+
+    // Without a maximum frame size in the stream info, allow frames of up to
+    // the largest possible size of an uncompressed frame:
+    const int64 maxDistance =
+        maxFrameSize > 0
+            ? (int64)maxFrameSize
+            : (int64)65536 * (int64)jmax(1u, numChannels) * 4 + 16;
+
+    while (frame->first + frame->second.numSamples <= sample) {
+      const int64 expectedFirstSample =
+          frame->first + frame->second.numSamples;
+      auto next = frameIndex.find(expectedFirstSample);
+
+      if (next == frameIndex.end()) {
+        // Search for the header of the next frame, which must start with
+        // the sample immediately after the end of the current frame:
+        const int64 searchStart = frame->second.byteOffset + 2;
+        const int64 searchEnd = frame->second.byteOffset + maxDistance + 1;
+        int64 nextOffset = -1;
+        FrameHeader header;
+
+        for (int64 offset = searchStart; offset < searchEnd; offset++) {
+          if (offset < windowStart ||
+              offset + maxFrameHeaderSize > windowStart + windowLength) {
+            if (windowLength > 0 && windowLength < windowSize &&
+                offset >= windowStart + windowLength)
+              break; // We've reached the end of the stream
+
+            if (window == nullptr)
+              window.malloc(windowSize);
+
+            windowStart = offset;
+            if (!input->setPosition(windowStart))
+              break;
+            windowLength = input->read(window, windowSize);
+            if (windowLength <= 0)
+              break;
+          }
+
+          const uint8 *data = window + (offset - windowStart);
+          if (data[0] != 0xff || (data[1] & 0xfe) != 0xf8)
+            continue;
+
+          const int available = (int)(windowStart + windowLength - offset);
+          if (parseFrameHeader(data, jmin(available, maxFrameHeaderSize),
+                               header) &&
+              header.firstSample == expectedFirstSample) {
+            nextOffset = offset;
+            break;
+          }
+        }
+
+        if (nextOffset < 0)
+          break;
+
+        next = frameIndex
+                   .insert({expectedFirstSample, {nextOffset, header.numSamples}})
+                   .first;
+        indexChanged = true;
+      }
+
+      frame = next;
+    }
+
+    if (indexChanged) {
+      SeekTableCache<FlacFrameIndex>::getInstance().set(
+          frameIndexCacheKey, frameIndex,
+          frameIndex.size() * (sizeof(int64) + sizeof(FlacFrameLocation) + 32));
+    }
+
+    if (frame->first + frame->second.numSamples <= sample)
+      return false;
+
+    result = frame;
+    return true;
+  }
+
+  /**
+   * Seek directly to (and decode) the frame containing the provided sample,
+   * if its location is known or can be found without decoding. Returns false
+   * if libFLAC's (slower) seeking should be used instead.
+   */
+  bool seekToFrameContaining(int64 sample) {
+    if (frameIndex.empty())
+      return false;
+
+    FlacFrameIndex::const_iterator frame;
+    if (!findFrameContaining(sample, frame))
+      return false;
+
+    // Ensure that the frame is where we expect it to be before using it:
+    FrameHeader header;
+    if (!readFrameHeaderAt(frame->second.byteOffset, header) ||
+        header.firstSample != frame->first) {
+      frameIndex.erase(frame);
+      return false;
+    }
+
+    input->setPosition(frame->second.byteOffset);
+    FLAC__stream_decoder_flush(decoder);
+    bufferedRange = emptyRange(frame->first);
+    FLAC__stream_decoder_process_single(decoder);
+    return bufferedRange.contains(sample);
+  }
+
   PatchedFlacNamespace::FLAC__StreamDecoder *decoder;
   AudioBuffer<float> reservoir;
   Range<int64> bufferedRange;
   bool ok = false, scanningForLength = false;
 
+  int minBlockSize = 0, maxFrameSize = 0;
+  Array<PatchedFlacNamespace::FLAC__StreamMetadata_SeekPoint> seekPoints;
+  int64 firstFrameOffset = 0;
+  FlacFrameIndex frameIndex;
+  String frameIndexCacheKey;
+
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PatchedFlacReader)
 };
 
@@ -383,19 +716,8 @@ public:
         streamStartPos(output != nullptr ? jmax(output->getPosition(), 0ll)
                                          : 0ll) {
     encoder = PatchedFlacNamespace::FLAC__stream_encoder_new();
-
-    if (qualityOptionIndex > 0)
-      FLAC__stream_encoder_set_compression_level(
-          encoder, (uint32)jmin(8, qualityOptionIndex));
-
-    FLAC__stream_encoder_set_do_mid_side_stereo(encoder, numChannels == 2);
-    FLAC__stream_encoder_set_loose_mid_side_stereo(encoder, numChannels == 2);
-    FLAC__stream_encoder_set_channels(encoder, numChannels);
-    FLAC__stream_encoder_set_bits_per_sample(
-        encoder, jmin((unsigned int)24, bitsPerSample));
-    FLAC__stream_encoder_set_sample_rate(encoder, (unsigned int)sampleRate);
-    FLAC__stream_encoder_set_blocksize(encoder, 0);
-    FLAC__stream_encoder_set_do_escape_coding(encoder, true);
+    configureEncoder(encoder, numChannels, bitsPerSample, sampleRate,
+                     qualityOptionIndex);
 
     // Create a seek table, which is empty by default:
     seektable = PatchedFlacNamespace::FLAC__metadata_object_new(
@@ -424,6 +746,28 @@ public:
          PatchedFlacNamespace::FLAC__STREAM_ENCODER_INIT_STATUS_OK;
   }
 
+  /**
+   * Apply the settings used by all of our FLAC writers to a (not yet
+   * initialised) libFLAC encoder.
+   */
+  static void
+  configureEncoder(PatchedFlacNamespace::FLAC__StreamEncoder *encoder,
+                   uint32 numChannels, uint32 bitsPerSample, double sampleRate,
+                   int qualityOptionIndex) {
+    if (qualityOptionIndex > 0)
+      FLAC__stream_encoder_set_compression_level(
+          encoder, (uint32)jmin(8, qualityOptionIndex));
+
+    FLAC__stream_encoder_set_do_mid_side_stereo(encoder, numChannels == 2);
+    FLAC__stream_encoder_set_loose_mid_side_stereo(encoder, numChannels == 2);
+    FLAC__stream_encoder_set_channels(encoder, numChannels);
+    FLAC__stream_encoder_set_bits_per_sample(
+        encoder, jmin((unsigned int)24, bitsPerSample));
+    FLAC__stream_encoder_set_sample_rate(encoder, (unsigned int)sampleRate);
+    FLAC__stream_encoder_set_blocksize(encoder, 0);
+    FLAC__stream_encoder_set_do_escape_coding(encoder, true);
+  }
+
   ~PatchedFlacWriter() override {
     if (ok) {
       PatchedFlacNamespace::FLAC__stream_encoder_finish(encoder);
@@ -536,6 +880,361 @@ private:
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PatchedFlacWriter)
 };
 
+//==============================================================================
+/**
+ * A FLAC writer that encodes audio on multiple threads. Incoming audio is
+ * split into segments of a whole number of FLAC frames, and each segment is
+ * encoded by its own libFLAC encoder on a worker thread. As FLAC frames are
+ * independent of each other, the encoded frames of each segment can then be
+ * renumbered and written out in order to produce a single valid stream.
+ *
+ * libFLAC expects to write the stream's metadata itself, so this writer
+ * writes the STREAMINFO block (including the MD5 checksum of the audio)
+ * and an empty SEEKTABLE block itself, rewriting STREAMINFO on completion.
+ */
+class ParallelFlacWriter : public AudioFormatWriter {
+public:
+  // Each segment of audio contains this many FLAC frames:
+  static constexpr int framesPerSegment = 64;
+
+  ParallelFlacWriter(OutputStream *out, double rate, uint32 numChans,
+                     uint32 bits, int qualityOptionIndex, int numThreads)
+      : AudioFormatWriter(out, flacFormatName, rate, numChans, bits),
+        streamStartPos(output != nullptr ? jmax(output->getPosition(), 0ll)
+                                         : 0ll),
+        qualityOptionIndex(qualityOptionIndex),
+        numThreads(jmax(1, numThreads)) {
+    // Use a temporary encoder to find out which block size libFLAC would
+    // choose for these settings, so that every segment uses the same one:
+    auto *encoder = PatchedFlacNamespace::FLAC__stream_encoder_new();
+    if (encoder == nullptr)
+      return;
+    PatchedFlacWriter::configureEncoder(encoder, numChannels, bitsPerSample,
+                                        sampleRate, qualityOptionIndex);
+    blockSize =
+        PatchedFlacNamespace::FLAC__stream_encoder_get_max_lpc_order(encoder) ==
+                0
+            ? 1152
+            : 4096;
+    PatchedFlacNamespace::FLAC__stream_encoder_delete(encoder);
+
+    segmentSize = blockSize * framesPerSegment;
+    pendingSamples.resize(numChannels);
+    for (auto &channel : pendingSamples)
+      channel.resize((size_t)segmentSize * this->numThreads);
+
+    PatchedFlacNamespace::FLAC__MD5Init(&md5Context);
+    ok = writeMetadata();
+  }
+
+  ~ParallelFlacWriter() override {
+    bool succeeded = ok && !encodeFailed && encodePendingSamples();
+
+    PatchedFlacNamespace::FLAC__byte digest[16];
+    PatchedFlacNamespace::FLAC__MD5Final(digest, &md5Context);
+
+    if (ok) {
+      if (succeeded &&
+          output->setPosition(streamStartPos + streamInfoOffset)) {
+        writeStreamInfo(digest);
+      }
+      output->flush();
+    } else {
+      output = nullptr; // to stop the base class deleting this, as it needs to
+                        // be returned to the caller of createWriter()
+    }
+  }
+
+  //==============================================================================
+  bool write(const int **samplesToWrite, int numSamples) override {
+    if (!ok || encodeFailed)
+      return false;
+
+    auto bitsToShift = 32 - (int)bitsPerSample;
+    int bufferSize = (int)pendingSamples[0].size();
+
+    for (int offset = 0; offset < numSamples;) {
+      int samplesToCopy = jmin(numSamples - offset, bufferSize - numPending);
+
+      for (unsigned int c = 0; c < numChannels; ++c) {
+        if (samplesToWrite[c] == nullptr)
+          return false;
+
+        auto *destData = pendingSamples[c].data() + numPending;
+        for (int j = 0; j < samplesToCopy; ++j)
+          destData[j] = samplesToWrite[c][offset + j] >> bitsToShift;
+      }
+
+      numPending += samplesToCopy;
+      offset += samplesToCopy;
+
+      if (numPending == bufferSize && !encodePendingSamples()) {
+        encodeFailed = true;
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  bool ok = false;
+
+private:
+  /** The encoded frames of one segment of audio. */
+  struct EncodedSegment {
+    MemoryOutputStream data;
+    Array<int> frameSizes;
+    int64 firstFrameNumber = 0;
+    bool failed = false;
+  };
+
+  /**
+   * Encode all of the audio in pendingSamples in parallel, and write the
+   * resulting frames to the output stream in order.
+   */
+  bool encodePendingSamples() {
+    if (numPending == 0)
+      return true;
+
+    int numSegments = (numPending + segmentSize - 1) / segmentSize;
+    std::vector<EncodedSegment> segments(numSegments);
+    std::atomic<int> nextSegment{0};
+
+    auto runWorker = [&]() {
+      while (true) {
+        int i = nextSegment++;
+        if (i >= numSegments)
+          break;
+
+        int startSample = i * segmentSize;
+        segments[i].firstFrameNumber =
+            nextFrameNumber + (int64)i * framesPerSegment;
+        encodeSegment(startSample, jmin(segmentSize, numPending - startSample),
+                      segments[i]);
+      }
+    };
+
+    std::vector<std::thread> workers;
+    for (int i = 1; i < jmin(numThreads, numSegments); i++)
+      workers.emplace_back(runWorker);
+
+    // The MD5 checksum must be computed over all samples in order, so we
+    // compute that on this thread while the workers encode:
+    std::vector<const PatchedFlacNamespace::FLAC__int32 *> channels;
+    for (auto &channel : pendingSamples)
+      channels.push_back(channel.data());
+    bool md5Succeeded = PatchedFlacNamespace::FLAC__MD5Accumulate(
+        &md5Context, channels.data(), numChannels, (unsigned)numPending,
+        (bitsPerSample + 7) / 8);
+
+    runWorker();
+    for (auto &worker : workers)
+      worker.join();
+
+    totalSamples += numPending;
+    numPending = 0;
+
+    if (!md5Succeeded)
+      return false;
+
+    for (auto &segment : segments) {
+      if (segment.failed)
+        return false;
+
+      for (int frameSize : segment.frameSizes) {
+        minFrameSize =
+            minFrameSize == 0 ? frameSize : jmin(minFrameSize, frameSize);
+        maxFrameSize = jmax(maxFrameSize, frameSize);
+      }
+      nextFrameNumber += segment.frameSizes.size();
+
+      if (!output->write(segment.data.getData(), segment.data.getDataSize()))
+        return false;
+    }
+
+    return true;
+  }
+
+  /**
+   * Encode the given range of pendingSamples with a new libFLAC encoder,
+   * storing renumbered frames into the provided segment. Called from worker
+   * threads.
+   */
+  void encodeSegment(int startSample, int numSamples, EncodedSegment &segment) {
+    auto *encoder = PatchedFlacNamespace::FLAC__stream_encoder_new();
+    if (encoder == nullptr) {
+      segment.failed = true;
+      return;
+    }
+
+    PatchedFlacWriter::configureEncoder(encoder, numChannels, bitsPerSample,
+                                        sampleRate, qualityOptionIndex);
+    FLAC__stream_encoder_set_blocksize(encoder, (unsigned)blockSize);
+
+    // The checksum of the whole stream is computed in encodePendingSamples:
+    FLAC__stream_encoder_set_do_md5(encoder, false);
+
+    std::vector<const PatchedFlacNamespace::FLAC__int32 *> channels;
+    for (auto &channel : pendingSamples)
+      channels.push_back(channel.data() + startSample);
+
+    segment.failed =
+        FLAC__stream_encoder_init_stream(encoder, segmentWriteCallback, nullptr,
+                                         nullptr, nullptr, &segment) !=
+            PatchedFlacNamespace::FLAC__STREAM_ENCODER_INIT_STATUS_OK ||
+        !FLAC__stream_encoder_process(encoder, channels.data(),
+                                      (unsigned)numSamples) ||
+        !PatchedFlacNamespace::FLAC__stream_encoder_finish(encoder) ||
+        segment.failed;
+
+    PatchedFlacNamespace::FLAC__stream_encoder_delete(encoder);
+  }
+
+  static PatchedFlacNamespace::FLAC__StreamEncoderWriteStatus
+  segmentWriteCallback(const PatchedFlacNamespace::FLAC__StreamEncoder *,
+                       const PatchedFlacNamespace::FLAC__byte buffer[],
+                       size_t bytes, unsigned int samples,
+                       unsigned int currentFrame, void *clientData) {
+    // Each encoder writes its own stream metadata first, which we discard:
+    if (samples == 0)
+      return PatchedFlacNamespace::FLAC__STREAM_ENCODER_WRITE_STATUS_OK;
+
+    auto *segment = static_cast<EncodedSegment *>(clientData);
+    auto sizeBefore = segment->data.getDataSize();
+    if (!renumberFrame(buffer, bytes, segment->firstFrameNumber + currentFrame,
+                       segment->data)) {
+      segment->failed = true;
+      return PatchedFlacNamespace::
+          FLAC__STREAM_ENCODER_WRITE_STATUS_FATAL_ERROR;
+    }
+
+    segment->frameSizes.add((int)(segment->data.getDataSize() - sizeBefore));
+    return PatchedFlacNamespace::FLAC__STREAM_ENCODER_WRITE_STATUS_OK;
+  }
+
+  /**
+   * Copy a single encoded FLAC frame into the provided stream, replacing the
+   * frame number in its header and recomputing both of its checksums.
+   */
+  static bool renumberFrame(const PatchedFlacNamespace::FLAC__byte *frame,
+                            size_t numBytes, uint64 frameNumber,
+                            MemoryOutputStream &out) {
+    if (numBytes < 7)
+      return false;
+
+    // The frame number is stored as a UTF-8-style variable-length integer:
+    int oldNumberLength = 1;
+    for (uint8 mask = 0x80; oldNumberLength < 7 && (frame[4] & mask) &&
+                            (frame[4] & (mask >> 1));
+         mask >>= 1)
+      oldNumberLength++;
+
+    const int blockSizeCode = frame[2] >> 4;
+    const int sampleRateCode = frame[2] & 0x0f;
+    const int numExtraBytes = (blockSizeCode == 6   ? 1
+                               : blockSizeCode == 7 ? 2
+                                                    : 0) +
+                              (sampleRateCode == 12 ? 1
+                               : sampleRateCode == 13 || sampleRateCode == 14
+                                   ? 2
+                                   : 0);
+
+    const size_t oldHeaderSize = 4 + oldNumberLength + numExtraBytes + 1;
+    if (numBytes < oldHeaderSize + 2)
+      return false;
+
+    std::vector<PatchedFlacNamespace::FLAC__byte> result(frame, frame + 4);
+
+    if (frameNumber < 0x80) {
+      result.push_back((uint8)frameNumber);
+    } else {
+      int numContinuationBytes = 1;
+      while (numContinuationBytes < 6 &&
+             frameNumber >= (1ull << (5 * numContinuationBytes + 6)))
+        numContinuationBytes++;
+
+      const uint8 lengthMarker = (uint8)(0xff00 >> (numContinuationBytes + 1));
+      result.push_back(
+          (uint8)(lengthMarker | (frameNumber >> (6 * numContinuationBytes))));
+      for (int i = numContinuationBytes - 1; i >= 0; i--)
+        result.push_back((uint8)(0x80 | ((frameNumber >> (6 * i)) & 0x3f)));
+    }
+
+    const auto *extraBytes = frame + 4 + oldNumberLength;
+    result.insert(result.end(), extraBytes, extraBytes + numExtraBytes);
+    result.push_back(PatchedFlacNamespace::FLAC__crc8(
+        result.data(), (unsigned)result.size()));
+
+    result.insert(result.end(), frame + oldHeaderSize, frame + numBytes - 2);
+    auto crc16 = PatchedFlacNamespace::FLAC__crc16(result.data(),
+                                                   (unsigned)result.size());
+    result.push_back((uint8)(crc16 >> 8));
+    result.push_back((uint8)(crc16 & 0xff));
+
+    return out.write(result.data(), result.size());
+  }
+
+  /**
+   * Write the stream marker, a STREAMINFO block (to be overwritten once we
+   * know the length and checksum of the audio), and a SEEKTABLE containing a
+   * single placeholder, just like PatchedFlacWriter.
+   */
+  bool writeMetadata() {
+    const uint8 marker[] = {'f', 'L', 'a', 'C', 0x00, 0x00, 0x00, 34};
+    if (!output->write(marker, sizeof(marker)))
+      return false;
+
+    const PatchedFlacNamespace::FLAC__byte emptyDigest[16] = {};
+    if (!writeStreamInfo(emptyDigest))
+      return false;
+
+    uint8 seekTable[4 + 18] = {0x80 | 3, 0x00, 0x00, 18};
+    for (int i = 0; i < 8; i++)
+      seekTable[4 + i] = 0xff; // FLAC__STREAM_METADATA_SEEKPOINT_PLACEHOLDER
+    return output->write(seekTable, sizeof(seekTable));
+  }
+
+  bool writeStreamInfo(const PatchedFlacNamespace::FLAC__byte digest[16]) {
+    uint8 streamInfo[34] = {};
+    PatchedFlacWriter::packUint32((uint32)blockSize, streamInfo, 2);
+    PatchedFlacWriter::packUint32((uint32)blockSize, streamInfo + 2, 2);
+    PatchedFlacWriter::packUint32((uint32)minFrameSize, streamInfo + 4, 3);
+    PatchedFlacWriter::packUint32((uint32)maxFrameSize, streamInfo + 7, 3);
+
+    const uint64 packedFormat =
+        ((uint64)sampleRate << 44) | ((uint64)(numChannels - 1) << 41) |
+        ((uint64)(jmin((uint32)24, bitsPerSample) - 1) << 36) |
+        ((uint64)totalSamples & 0xfffffffffull);
+    PatchedFlacWriter::packUint32((uint32)(packedFormat >> 32), streamInfo + 10,
+                                  4);
+    PatchedFlacWriter::packUint32((uint32)packedFormat, streamInfo + 14, 4);
+
+    memcpy(streamInfo + 18, digest, 16);
+    return output->write(streamInfo, sizeof(streamInfo));
+  }
+
+  // The STREAMINFO block starts after the "fLaC" marker and its own header:
+  static constexpr int64 streamInfoOffset = 8;
+
+  const int64 streamStartPos;
+  const int qualityOptionIndex;
+  const int numThreads;
+
+  int blockSize = 4096;
+  int segmentSize = 0;
+
+  std::vector<std::vector<PatchedFlacNamespace::FLAC__int32>> pendingSamples;
+  int numPending = 0;
+
+  PatchedFlacNamespace::FLAC__MD5Context md5Context;
+  int64 totalSamples = 0;
+  int64 nextFrameNumber = 0;
+  int minFrameSize = 0, maxFrameSize = 0;
+  bool encodeFailed = false;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ParallelFlacWriter)
+};
+
 //==============================================================================
 PatchedFlacAudioFormat::PatchedFlacAudioFormat()
     : AudioFormat(flacFormatName, ".flac") {}
@@ -581,6 +1280,27 @@ AudioFormatWriter *PatchedFlacAudioFormat::createWriterFor(
   return nullptr;
 }
 
+AudioFormatWriter *PatchedFlacAudioFormat::createParallelWriterFor(
+    OutputStream *out, double sampleRate, unsigned int numberOfChannels,
+    int bitsPerSample, int qualityOptionIndex, int numThreads) {
+  if (out != nullptr && getPossibleBitDepths().contains(bitsPerSample)) {
+    std::unique_ptr<ParallelFlacWriter> w(new ParallelFlacWriter(
+        out, sampleRate, numberOfChannels, (uint32)bitsPerSample,
+        qualityOptionIndex, numThreads));
+    if (w->ok)
+      return w.release();
+  }
+
+  return nullptr;
+}
+
+int64 PatchedFlacAudioFormat::getStartOfFrameContaining(
+    AudioFormatReader *reader, int64 sample) {
+  if (auto *flacReader = dynamic_cast<PatchedFlacReader *>(reader))
+    return flacReader->getStartOfFrameContaining(sample);
+  return sample;
+}
+
 StringArray PatchedFlacAudioFormat::getQualityOptions() {
   return {"0 (Fastest)",        "1", "2", "3", "4", "5 (Default)", "6", "7",
           "8 (Highest quality)"};
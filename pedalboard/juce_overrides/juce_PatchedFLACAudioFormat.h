@@ -63,6 +63,29 @@ public:
                                      int qualityOptionIndex) override;
   using AudioFormat::createWriterFor;
 
+  /**
+      Create a writer that splits the audio it receives into segments and
+      encodes each segment on one of `numThreads` threads. The resulting
+      stream is a valid FLAC stream, although it won't be byte-for-byte
+      identical to the output of a single-threaded writer.
+  */
+  AudioFormatWriter *createParallelWriterFor(OutputStream *streamToWriteTo,
+                                             double sampleRateToUse,
+                                             unsigned int numberOfChannels,
+                                             int bitsPerSample,
+                                             int qualityOptionIndex,
+                                             int numThreads);
+
+  /**
+      If `reader` was created by this format, return the first sample of the
+      FLAC frame that contains `sample`, if that frame can be found without
+      decoding any audio. As each FLAC frame can be decoded independently,
+      decoding from the start of a frame never requires decoding any earlier
+      audio. Otherwise, returns `sample` unchanged.
+  */
+  static int64 getStartOfFrameContaining(AudioFormatReader *reader,
+                                         int64 sample);
+
 private:
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PatchedFlacAudioFormat)
 };
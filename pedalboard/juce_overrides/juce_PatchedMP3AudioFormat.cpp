@@ -24,6 +24,7 @@
 */
 
 #include "juce_PatchedMP3AudioFormat.h"
+#include "juce_SeekTableCache.h"
 
 namespace juce {
 
@@ -1979,7 +1980,13 @@ struct PatchedMP3Stream {
   bool seek(int frameIndex) {
     frameIndex = jmax(0, frameIndex);
 
-    while (frameIndex >= frameStreamPositions.size() * storedStartPosInterval) {
+    // Finding frames by decoding them is slow, so try to find the positions
+    // of all frames in the stream at once by only reading their headers:
+    if (frameIndex >= frameStreamPositions.size() * storedStartPosInterval)
+      buildSeekTable();
+
+    while (!seekTableComplete &&
+           frameIndex >= frameStreamPositions.size() * storedStartPosInterval) {
       int dummy = 0;
       auto result = decodeNextBlock(nullptr, nullptr, dummy);
 
@@ -2001,11 +2008,133 @@ struct PatchedMP3Stream {
     return true;
   }
 
+  /**
+   * Find the stream position of every frame in the stream (or rather, of
+   * every storedStartPosInterval-th frame, as seek() needs) by reading only
+   * frame headers and skipping over their contents, which is much faster than
+   * finding frames by decoding them. Frames are located exactly as
+   * decodeNextBlock() would find them, so seeking produces identical output.
+   *
+   * This is only attempted once per stream. Returns true if the positions of
+   * all frames in the stream are now known (in which case, the number of audio
+   * frames in the stream is also stored in numAudioFramesScanned).
+   */
+  bool buildSeekTable() {
+    if (seekTableScanned || firstFramePosition < 0)
+      return seekTableComplete;
+    seekTableScanned = true;
+
+    const auto originalPosition = stream.getPosition();
+
+    Array<int64> positions;
+    MP3Frame scannedFrame;
+    int64 position = firstFramePosition;
+    int scannedFrameSize = -1;
+    bool scannedNeedToSync = true;
+    bool reachedEnd = false;
+    int64 numAudioFrames = 0;
+
+    for (int frameIndex = 0;; ++frameIndex) {
+      const int64 headerPosition =
+          findFrameHeader(position, scannedFrame.layer, reachedEnd);
+      if (headerPosition < 0)
+        break;
+
+      if ((frameIndex & (storedStartPosInterval - 1)) == 0)
+        positions.add(headerPosition);
+
+      // Mirror the logic in decodeNextBlock(), which checks for a VBR header
+      // (which takes up an entire frame) at the start of the stream:
+      if (scannedFrameSize == -1 || scannedNeedToSync) {
+        scannedNeedToSync = false;
+
+        uint8 xing[194] = {};
+        VBRTagData tagData;
+        stream.setPosition(position);
+        stream.read(xing, sizeof(xing));
+
+        if (tagData.read(xing)) {
+          position += jmax(tagData.headersize, 1);
+          continue;
+        }
+      }
+
+      const auto skippedBytes = (int)(headerPosition - position);
+      if (skippedBytes > 0) {
+        scannedNeedToSync = true;
+        scannedFrameSize += skippedBytes;
+      }
+
+      stream.setPosition(headerPosition);
+      if (scannedFrame.decodeHeader((uint32)stream.readIntBigEndian()) ==
+          MP3Frame::ParseSuccessful::no)
+        break;
+
+      ++numAudioFrames;
+      scannedFrameSize = scannedFrame.frameSize;
+      position = headerPosition + 4 + scannedFrame.frameSize;
+    }
+
+    stream.setPosition(originalPosition);
+
+    if (positions.size() > frameStreamPositions.size())
+      frameStreamPositions = positions;
+
+    // If we stopped before reaching the end of the stream, seek() will fall
+    // back to decoding frames to find positions beyond those we found here:
+    seekTableComplete =
+        seekTableComplete || (reachedEnd && !frameStreamPositions.isEmpty());
+
+    if (reachedEnd)
+      numAudioFramesScanned = numAudioFrames;
+
+    return seekTableComplete;
+  }
+
+  /**
+   * Count the audio frames in this stream by only reading their headers (see
+   * buildSeekTable), without moving the stream's position. Returns -1 if the
+   * end of the stream could not be found this way.
+   */
+  int64 countAudioFrames() {
+    if (numAudioFramesScanned < 0 && firstFramePosition >= 0) {
+      // Seek tables provided by setSeekTable() don't include a frame count:
+      seekTableScanned = false;
+      buildSeekTable();
+    }
+
+    return numAudioFramesScanned;
+  }
+
+  bool hasCompleteSeekTable() const noexcept { return seekTableComplete; }
+
+  const Array<int64> &getSeekTable() const noexcept {
+    return frameStreamPositions;
+  }
+
+  /**
+   * Use a seek table previously returned by getSeekTable() on an identical
+   * stream, to avoid needing to scan this stream again.
+   */
+  void setSeekTable(const Array<int64> &positions) {
+    if (positions.isEmpty())
+      return;
+
+    frameStreamPositions = positions;
+    seekTableScanned = seekTableComplete = true;
+  }
+
   MP3Frame frame;
   VBRTagData vbrTagData;
   BufferedInputStream stream;
   int numFrames = 0, currentFrameIndex = 0;
   bool vbrHeaderFound = false;
+  int64 firstFramePosition = -1;
+
+  // If non-zero, output audio at 1/(2^synthesisShift) of the stream's sample
+  // rate by only synthesising the lower subbands, which requires less work
+  // than decoding at the full rate and then resampling:
+  int synthesisShift = 0;
 
 private:
   bool headerParsed, sideParsed, dataParsed, needToSyncBitStream;
@@ -2044,6 +2173,8 @@ private:
 
   enum { storedStartPosInterval = 4 };
   Array<int64> frameStreamPositions;
+  bool seekTableScanned = false, seekTableComplete = false;
+  int64 numAudioFramesScanned = -1;
 
   struct SideInfoLayer1 {
     uint8 allocation[32][2];
@@ -2185,6 +2316,38 @@ private:
     return offset;
   }
 
+  /**
+   * Find the next valid frame header at or after startPosition, using the
+   * same rules as scanForNextFrameHeader(false), but without changing any
+   * decoding state. Returns the position of the header, or -1 if none was
+   * found (setting reachedEnd if the end of the stream was hit).
+   */
+  int64 findFrameHeader(int64 startPosition, int layer, bool &reachedEnd) {
+    stream.setPosition(startPosition);
+    int offset = -3;
+    uint32 header = 0;
+
+    for (;;) {
+      if (stream.isExhausted()) {
+        reachedEnd = true;
+        return -1;
+      }
+
+      if (stream.getPosition() > startPosition + 32768)
+        return -1;
+
+      header = (header << 8) | (uint8)stream.readByte();
+
+      if (offset >= 0 && isValidHeader(header, layer))
+        return startPosition + offset;
+
+      if (startPosition == 0 && offset == 0)
+        return -1;
+
+      ++offset;
+    }
+  }
+
   void readVBRHeader() {
     auto oldPos = stream.getPosition();
     uint8 xing[194];
@@ -3215,6 +3378,19 @@ private:
   void synthesise(const float *bandPtr, int channel, float *out,
                   int &samplesDone) {
     out += samplesDone;
+
+    // When synthesising at a reduced sample rate, the subbands above the new
+    // Nyquist frequency are dropped to avoid aliasing, and only every
+    // (1 << synthesisShift)th output sample is computed:
+    const int step = 1 << synthesisShift;
+    float limitedBands[32];
+    if (synthesisShift > 0) {
+      const int numBands = 32 >> synthesisShift;
+      memcpy(limitedBands, bandPtr, (size_t)numBands * sizeof(float));
+      zeromem(limitedBands + numBands, (size_t)(32 - numBands) * sizeof(float));
+      bandPtr = limitedBands;
+    }
+
     const int bo = channel == 0 ? ((synthBo - 1) & 15) : synthBo;
     float(*buf)[0x110] = synthBuffers[channel];
     float *b0;
@@ -3232,7 +3408,8 @@ private:
     synthBo = bo;
     const float *window = constants.decodeWin + 16 - bo1;
 
-    for (int j = 16; j != 0; --j, b0 += 16, window += 32) {
+    for (int j = 16 / step; j != 0;
+         --j, b0 += 16 * step, window += 32 * step) {
       auto sum = window[0] * b0[0];
       sum -= window[1] * b0[1];
       sum += window[2] * b0[2];
@@ -3262,12 +3439,13 @@ private:
       sum += window[12] * b0[12];
       sum += window[14] * b0[14];
       *out++ = sum;
-      b0 -= 16;
-      window -= 32;
+      b0 -= 16 * step;
+      window -= 32 * step;
       window += (ptrdiff_t)bo1 << 1;
     }
 
-    for (int j = 15; j != 0; --j, b0 -= 16, window -= 32) {
+    for (int j = 16 / step - 1; j != 0;
+         --j, b0 -= 16 * step, window -= 32 * step) {
       auto sum = -window[-1] * b0[0];
       sum -= window[-2] * b0[1];
       sum -= window[-3] * b0[2];
@@ -3287,7 +3465,7 @@ private:
       *out++ = sum;
     }
 
-    samplesDone += 32;
+    samplesDone += 32 / step;
   }
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PatchedMP3Stream)
@@ -3299,19 +3477,27 @@ static const char *const mp3FormatName = "MP3 file";
 //==============================================================================
 class PatchedMP3Reader : public AudioFormatReaderWithPosition {
 public:
-  PatchedMP3Reader(InputStream *const in)
+  PatchedMP3Reader(InputStream *const in, int synthesisShift = 0)
       : AudioFormatReaderWithPosition(in, mp3FormatName), stream(*in),
         currentPosition(0), decodedStart(0), decodedEnd(0) {
+    stream.synthesisShift = synthesisShift;
     skipID3();
     const int64 streamPos = stream.stream.getPosition();
+    stream.firstFramePosition = streamPos;
 
     if (readNextBlock()) {
       bitsPerSample = 32;
       usesFloatingPointData = true;
-      sampleRate = stream.frame.getFrequency();
+      sampleRate = stream.frame.getFrequency() / (1 << synthesisShift);
       numChannels = (unsigned int)stream.frame.numChannels;
-      samplesPerFrame = stream.frame.numSamples();
+      samplesPerFrame = stream.frame.numSamples() >> synthesisShift;
       lengthInSamples = findLength(streamPos);
+
+      seekTableCacheKey = SeekTableCache<Array<int64>>::getKeyFor(in);
+      Array<int64> cachedSeekTable;
+      if (SeekTableCache<Array<int64>>::getInstance().get(seekTableCacheKey,
+                                                          cachedSeekTable))
+        stream.setSeekTable(cachedSeekTable);
     }
   }
 
@@ -3324,7 +3510,16 @@ public:
     }
 
     if (currentPosition != startSampleInFile) {
-      if (!stream.seek((int)(startSampleInFile / samplesPerFrame - 1))) {
+      const bool hadSeekTable = stream.hasCompleteSeekTable();
+      const bool seekSucceeded =
+          stream.seek((int)(startSampleInFile / samplesPerFrame - 1));
+
+      if (!hadSeekTable && stream.hasCompleteSeekTable())
+        SeekTableCache<Array<int64>>::getInstance().set(
+            seekTableCacheKey, stream.getSeekTable(),
+            (size_t)stream.getSeekTable().size() * sizeof(int64));
+
+      if (!seekSucceeded) {
         currentPosition = -1;
         createEmptyDecodedData();
       } else {
@@ -3387,13 +3582,35 @@ public:
   bool lengthIsApproximate() const override {
     // stream.numFrames will only be set if we have a VBR header,
     // which identifies the exact number of samples expected in the stream:
-    return stream.numFrames <= 0;
+    return stream.numFrames <= 0 && !exactLengthFound;
+  }
+
+  bool findExactLength() override {
+    if (!lengthIsApproximate())
+      return true;
+
+    const bool hadSeekTable = stream.hasCompleteSeekTable();
+    const int64 numAudioFrames = stream.countAudioFrames();
+    if (numAudioFrames < 0)
+      return false;
+
+    // Counting frames finds their positions too, which we may as well keep:
+    if (!hadSeekTable && stream.hasCompleteSeekTable())
+      SeekTableCache<Array<int64>>::getInstance().set(
+          seekTableCacheKey, stream.getSeekTable(),
+          (size_t)stream.getSeekTable().size() * sizeof(int64));
+
+    lengthInSamples = numAudioFrames * samplesPerFrame;
+    exactLengthFound = true;
+    return true;
   }
 
 private:
   PatchedMP3Stream stream;
+  String seekTableCacheKey;
   int64 currentPosition;
   int samplesPerFrame;
+  bool exactLengthFound = false;
   enum { decodedDataSize = 1152 };
   float decoded0[decodedDataSize], decoded1[decodedDataSize];
   int decodedStart, decodedEnd;
@@ -3493,8 +3710,20 @@ StringArray PatchedMP3AudioFormat::getQualityOptions() { return {}; }
 AudioFormatReader *
 PatchedMP3AudioFormat::createReaderFor(InputStream *sourceStream,
                                        const bool deleteStreamIfOpeningFails) {
+  return createDownsampledReaderFor(sourceStream, deleteStreamIfOpeningFails,
+                                    1);
+}
+
+AudioFormatReader *PatchedMP3AudioFormat::createDownsampledReaderFor(
+    InputStream *sourceStream, const bool deleteStreamIfOpeningFails,
+    int downsamplingFactor) {
+  jassert(isValidDownsamplingFactor(downsamplingFactor));
+  const int synthesisShift = downsamplingFactor == 4   ? 2
+                             : downsamplingFactor == 2 ? 1
+                                                       : 0;
+
   std::unique_ptr<PatchedMP3Decoder::PatchedMP3Reader> r(
-      new PatchedMP3Decoder::PatchedMP3Reader(sourceStream));
+      new PatchedMP3Decoder::PatchedMP3Reader(sourceStream, synthesisShift));
 
   if (r->lengthInSamples > 0)
     return r.release();
@@ -62,6 +62,22 @@ public:
   AudioFormatReader *createReaderFor(InputStream *,
                                      bool deleteStreamIfOpeningFails) override;
 
+  /** Creates a reader that decodes audio at 1/downsamplingFactor of the
+      stream's sample rate, by skipping the synthesis of any subbands above
+      the reduced Nyquist frequency. This is much cheaper than decoding at the
+      full sample rate and resampling afterwards.
+
+      downsamplingFactor must be 1, 2, or 4.
+  */
+  AudioFormatReader *createDownsampledReaderFor(InputStream *,
+                                                bool deleteStreamIfOpeningFails,
+                                                int downsamplingFactor);
+
+  static bool isValidDownsamplingFactor(int downsamplingFactor) {
+    return downsamplingFactor == 1 || downsamplingFactor == 2 ||
+           downsamplingFactor == 4;
+  }
+
   AudioFormatWriter *createWriterFor(OutputStream *, double sampleRateToUse,
                                      unsigned int numberOfChannels,
                                      int bitsPerSample,
@@ -77,6 +93,12 @@ public:
       : AudioFormatReader(sourceStream, formatName) {}
   virtual int64 getCurrentPosition() const = 0;
   virtual bool lengthIsApproximate() const { return false; };
+
+  /** If lengthIsApproximate(), try to find the exact length of the stream
+      without decoding it, updating lengthInSamples if successful. Returns
+      true if lengthInSamples is now exact.
+  */
+  virtual bool findExactLength() { return !lengthIsApproximate(); };
 };
 
 } // namespace juce
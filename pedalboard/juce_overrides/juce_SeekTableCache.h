@@ -0,0 +1,102 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "../JuceHeader.h"
+
+namespace juce {
+
+//==============================================================================
+/**
+ * A process-wide cache of seek tables (of any type) for audio files on disk,
+ * keyed by each file's path, size and modification time. This allows files
+ * that are opened repeatedly (i.e.: by a data loader that reads random
+ * sections of each file) to seek without scanning the file again.
+ *
+ * Each type of seek table has its own cache, which holds roughly 32MB of
+ * tables at most; the oldest tables are evicted first.
+ */
+template <typename SeekTable> class SeekTableCache {
+public:
+  static SeekTableCache &getInstance() {
+    static SeekTableCache instance;
+    return instance;
+  }
+
+  /**
+   * Returns a key identifying the file being read by the given stream, or an
+   * empty string if the stream is not reading from a file.
+   */
+  static String getKeyFor(InputStream *input) {
+    if (auto *fileStream = dynamic_cast<FileInputStream *>(input)) {
+      const File &file = fileStream->getFile();
+      return file.getFullPathName() + "|" + String(file.getSize()) + "|" +
+             String(file.getLastModificationTime().toMilliseconds());
+    }
+    return {};
+  }
+
+  bool get(const String &key, SeekTable &table) {
+    const ScopedLock scopedLock(lock);
+    if (key.isEmpty() || !entries.contains(key))
+      return false;
+    table = entries[key].table;
+    return true;
+  }
+
+  /**
+   * Store (or replace) the seek table for the given key. `numBytes` should
+   * be roughly the amount of memory used by the table.
+   */
+  void set(const String &key, const SeekTable &table, size_t numBytes) {
+    const ScopedLock scopedLock(lock);
+    if (key.isEmpty())
+      return;
+
+    if (entries.contains(key)) {
+      numBytesStored -= entries[key].numBytes;
+      insertionOrder.removeString(key);
+    }
+
+    entries.set(key, {table, numBytes});
+    insertionOrder.add(key);
+    numBytesStored += numBytes;
+
+    while (numBytesStored > maxBytesStored && insertionOrder.size() > 1) {
+      const String oldest = insertionOrder[0];
+      numBytesStored -= entries[oldest].numBytes;
+      entries.remove(oldest);
+      insertionOrder.remove(0);
+    }
+  }
+
+private:
+  static constexpr size_t maxBytesStored = 32 * 1024 * 1024;
+
+  struct Entry {
+    SeekTable table;
+    size_t numBytes = 0;
+  };
+
+  CriticalSection lock;
+  HashMap<String, Entry> entries;
+  StringArray insertionOrder;
+  size_t numBytesStored = 0;
+};
+
+} // namespace juce
@@ -0,0 +1,220 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "../simd/Dispatch.h"
+
+namespace Pedalboard {
+
+/**
+ * A cascade of biquad filters (in transposed direct form II, like
+ * juce::dsp::IIR::Filter) applied to every channel of a buffer, which
+ * processes several channels and several stages at once in SIMD lanes.
+ *
+ * Channels are packed into groups of C lanes (the number of channels rounded
+ * up to a power of two, up to the vector width of the runtime-dispatched
+ * kernels), and the remaining lanes run P = lanes / C consecutive stages as a
+ * pipeline: at every step, lane p filters the sample that lane p - 1 filtered
+ * on the previous step. Only the first and last P - 1 steps of each call
+ * (where the pipeline fills and drains) are run one lane at a time, so no
+ * state is left in flight between calls and coefficients can be changed
+ * between any two calls.
+ */
+class BiquadCascade {
+public:
+  // The most lanes used by any kernel's biquadSteps (i.e.: AVX-512):
+  static constexpr int MAX_LANES = 16;
+
+  struct Coefficients {
+    // Normalized so that a0 = 1:
+    float b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+  };
+
+  /**
+   * Set the number of channels and stages to process. The filter state is
+   * only cleared (and all coefficients are only reset to pass audio through
+   * unchanged) if either of these changes.
+   */
+  void prepare(int newNumChannels, int newNumStages) {
+    if (newNumChannels == numChannels && newNumStages == numStages)
+      return;
+
+    numChannels = newNumChannels;
+    numStages = newNumStages;
+
+    lanesPerChannelGroup = 1;
+    while (lanesPerChannelGroup < std::min(numChannels, lanes))
+      lanesPerChannelGroup *= 2;
+    stagesPerStageGroup = lanes / lanesPerChannelGroup;
+    numChannelGroups =
+        (numChannels + lanesPerChannelGroup - 1) / lanesPerChannelGroup;
+    numStageGroups =
+        (numStages + stagesPerStageGroup - 1) / stagesPerStageGroup;
+
+    size_t coefficientSize = (size_t)numStageGroups * lanes;
+    for (auto *coefficient : {&b0, &b1, &b2, &a1, &a2})
+      coefficient->assign(coefficientSize, 0.0f);
+    std::fill(b0.begin(), b0.end(), 1.0f);
+
+    z1.assign(coefficientSize * numChannelGroups, 0.0f);
+    z2.assign(coefficientSize * numChannelGroups, 0.0f);
+  }
+
+  void reset() {
+    std::fill(z1.begin(), z1.end(), 0.0f);
+    std::fill(z2.begin(), z2.end(), 0.0f);
+  }
+
+  void setCoefficients(int stage, const Coefficients &coefficients) {
+    int group = stage / stagesPerStageGroup;
+    int firstLane = group * lanes +
+                    (stage % stagesPerStageGroup) * lanesPerChannelGroup;
+    for (int lane = firstLane; lane < firstLane + lanesPerChannelGroup;
+         lane++) {
+      b0[lane] = coefficients.b0;
+      b1[lane] = coefficients.b1;
+      b2[lane] = coefficients.b2;
+      a1[lane] = coefficients.a1;
+      a2[lane] = coefficients.a2;
+    }
+  }
+
+  /**
+   * Filter numSamples samples of each of the numChannels channels (as passed
+   * to prepare()) in place.
+   */
+  void process(float *const *channels, int numSamples) {
+    if (numStages == 0 || numSamples == 0)
+      return;
+
+    // Lanes without a channel of their own read (and write) silence, which
+    // filters to silence:
+    if (numChannelGroups * lanesPerChannelGroup > numChannels &&
+        (int)silence.size() < numSamples) {
+      silence.assign(numSamples, 0.0f);
+    }
+
+    float *groupChannels[MAX_LANES];
+    for (int channelGroup = 0; channelGroup < numChannelGroups;
+         channelGroup++) {
+      for (int c = 0; c < lanesPerChannelGroup; c++) {
+        int channel = channelGroup * lanesPerChannelGroup + c;
+        groupChannels[c] =
+            channel < numChannels ? channels[channel] : silence.data();
+      }
+
+      for (int stageGroup = 0; stageGroup < numStageGroups; stageGroup++) {
+        size_t offset =
+            ((size_t)channelGroup * numStageGroups + stageGroup) * lanes;
+        processStageGroup(groupChannels, numSamples,
+                          (size_t)stageGroup * lanes,
+                          z1.data() + offset, z2.data() + offset);
+      }
+    }
+  }
+
+private:
+  void processStageGroup(float *const *groupChannels, int numSamples,
+                         size_t coefficientOffset, float *groupZ1,
+                         float *groupZ2) {
+    const int C = lanesPerChannelGroup;
+    const int P = stagesPerStageGroup;
+    const float *groupB0 = b0.data() + coefficientOffset;
+    const float *groupB1 = b1.data() + coefficientOffset;
+    const float *groupB2 = b2.data() + coefficientOffset;
+    const float *groupA1 = a1.data() + coefficientOffset;
+    const float *groupA2 = a2.data() + coefficientOffset;
+
+    // The next input sample of each channel, followed by the most recent
+    // output of every lane. Loading one vector from the start of this array
+    // gives the next input of every lane:
+    float scratch[2 * MAX_LANES] = {0};
+    float *outputs = scratch + C;
+
+    // Run step t one lane at a time, where lane p (of stage p) filters sample
+    // t - p if that sample exists. Later stages go first, so that each stage
+    // reads the output of the previous stage from the previous step:
+    const auto processStepOneLaneAtATime = [&](int t) {
+      for (int p = std::min(P - 1, t); p >= 0; p--) {
+        int i = t - p;
+        if (i >= numSamples)
+          break;
+        for (int c = 0; c < C; c++) {
+          int lane = p * C + c;
+          float x = p == 0 ? groupChannels[c][i] : outputs[lane - C];
+          float y = groupB0[lane] * x + groupZ1[lane];
+          groupZ1[lane] =
+              groupB1[lane] * x - groupA1[lane] * y + groupZ2[lane];
+          groupZ2[lane] = groupB2[lane] * x - groupA2[lane] * y;
+          outputs[lane] = y;
+          if (p == P - 1)
+            groupChannels[c][i] = y;
+        }
+      }
+    };
+
+    const int numSteps = numSamples + P - 1;
+    const int firstFullStep = P - 1;
+    const int lastFullStep = std::max(firstFullStep, numSamples);
+
+    int t = 0;
+    for (; t < firstFullStep && t < numSteps; t++)
+      processStepOneLaneAtATime(t);
+
+    if (t < lastFullStep) {
+      simd::BiquadStageGroup group;
+      group.b0 = groupB0;
+      group.b1 = groupB1;
+      group.b2 = groupB2;
+      group.a1 = groupA1;
+      group.a2 = groupA2;
+      group.z1 = groupZ1;
+      group.z2 = groupZ2;
+      group.channels = groupChannels;
+      group.lanesPerChannelGroup = C;
+      group.scratch = scratch;
+      kernels->biquadSteps(group, t, lastFullStep);
+      t = lastFullStep;
+    }
+
+    for (; t < numSteps; t++)
+      processStepOneLaneAtATime(t);
+  }
+
+  const simd::Kernels *kernels = &simd::getKernels();
+  int lanes = simd::getKernels().biquadLanes;
+
+  int numChannels = 0;
+  int numStages = 0;
+  int lanesPerChannelGroup = 1;
+  int stagesPerStageGroup = 1;
+  int numChannelGroups = 0;
+  int numStageGroups = 0;
+
+  // Per-lane coefficients, for each group of stages:
+  std::vector<float> b0, b1, b2, a1, a2;
+
+  // Per-lane state, for each group of channels and each group of stages:
+  std::vector<float> z1, z2;
+
+  std::vector<float> silence;
+};
+
+} // namespace Pedalboard
@@ -0,0 +1,737 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define PEDALBOARD_USE_AVX2_DYNAMICS 1
+#elif defined(__SSE2__) || defined(_M_X64) ||                                 \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PEDALBOARD_USE_SSE2_DYNAMICS 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define PEDALBOARD_USE_NEON_DYNAMICS 1
+#endif
+
+#include "../JuceHeader.h"
+
+namespace Pedalboard {
+
+namespace dynamics {
+
+// Audio is processed in chunks of at most this many samples, so that the
+// envelope and gain of each chunk fit in small (stack-allocated) arrays that
+// stay in the L1 cache between passes:
+static constexpr int CHUNK_SIZE = 256;
+
+// The minimal set of vector operations needed to compute log2 and exp2 by
+// manipulating the exponent bits of floats:
+#if PEDALBOARD_USE_AVX2_DYNAMICS
+static constexpr int LANES = 8;
+using Vector = __m256;
+using IntVector = __m256i;
+inline Vector load(const float *p) { return _mm256_loadu_ps(p); }
+inline void store(float *p, Vector v) { _mm256_storeu_ps(p, v); }
+inline Vector broadcast(float x) { return _mm256_set1_ps(x); }
+inline Vector add(Vector a, Vector b) { return _mm256_add_ps(a, b); }
+inline Vector sub(Vector a, Vector b) { return _mm256_sub_ps(a, b); }
+inline Vector mul(Vector a, Vector b) { return _mm256_mul_ps(a, b); }
+inline Vector div(Vector a, Vector b) { return _mm256_div_ps(a, b); }
+inline Vector min(Vector a, Vector b) { return _mm256_min_ps(a, b); }
+inline Vector max(Vector a, Vector b) { return _mm256_max_ps(a, b); }
+inline IntVector broadcastInt(int32_t x) { return _mm256_set1_epi32(x); }
+inline IntVector addInt(IntVector a, IntVector b) {
+  return _mm256_add_epi32(a, b);
+}
+inline IntVector subInt(IntVector a, IntVector b) {
+  return _mm256_sub_epi32(a, b);
+}
+inline IntVector shiftLeft23(IntVector a) { return _mm256_slli_epi32(a, 23); }
+inline IntVector shiftRight23(IntVector a) { return _mm256_srai_epi32(a, 23); }
+inline IntVector truncate(Vector a) { return _mm256_cvttps_epi32(a); }
+inline Vector toFloat(IntVector a) { return _mm256_cvtepi32_ps(a); }
+inline IntVector bitsOf(Vector a) { return _mm256_castps_si256(a); }
+inline Vector fromBits(IntVector a) { return _mm256_castsi256_ps(a); }
+#elif PEDALBOARD_USE_SSE2_DYNAMICS
+static constexpr int LANES = 4;
+using Vector = __m128;
+using IntVector = __m128i;
+inline Vector load(const float *p) { return _mm_loadu_ps(p); }
+inline void store(float *p, Vector v) { _mm_storeu_ps(p, v); }
+inline Vector broadcast(float x) { return _mm_set1_ps(x); }
+inline Vector add(Vector a, Vector b) { return _mm_add_ps(a, b); }
+inline Vector sub(Vector a, Vector b) { return _mm_sub_ps(a, b); }
+inline Vector mul(Vector a, Vector b) { return _mm_mul_ps(a, b); }
+inline Vector div(Vector a, Vector b) { return _mm_div_ps(a, b); }
+inline Vector min(Vector a, Vector b) { return _mm_min_ps(a, b); }
+inline Vector max(Vector a, Vector b) { return _mm_max_ps(a, b); }
+inline IntVector broadcastInt(int32_t x) { return _mm_set1_epi32(x); }
+inline IntVector addInt(IntVector a, IntVector b) { return _mm_add_epi32(a, b); }
+inline IntVector subInt(IntVector a, IntVector b) { return _mm_sub_epi32(a, b); }
+inline IntVector shiftLeft23(IntVector a) { return _mm_slli_epi32(a, 23); }
+inline IntVector shiftRight23(IntVector a) { return _mm_srai_epi32(a, 23); }
+inline IntVector truncate(Vector a) { return _mm_cvttps_epi32(a); }
+inline Vector toFloat(IntVector a) { return _mm_cvtepi32_ps(a); }
+inline IntVector bitsOf(Vector a) { return _mm_castps_si128(a); }
+inline Vector fromBits(IntVector a) { return _mm_castsi128_ps(a); }
+#elif PEDALBOARD_USE_NEON_DYNAMICS
+static constexpr int LANES = 4;
+using Vector = float32x4_t;
+using IntVector = int32x4_t;
+inline Vector load(const float *p) { return vld1q_f32(p); }
+inline void store(float *p, Vector v) { vst1q_f32(p, v); }
+inline Vector broadcast(float x) { return vdupq_n_f32(x); }
+inline Vector add(Vector a, Vector b) { return vaddq_f32(a, b); }
+inline Vector sub(Vector a, Vector b) { return vsubq_f32(a, b); }
+inline Vector mul(Vector a, Vector b) { return vmulq_f32(a, b); }
+inline Vector div(Vector a, Vector b) { return vdivq_f32(a, b); }
+inline Vector min(Vector a, Vector b) { return vminq_f32(a, b); }
+inline Vector max(Vector a, Vector b) { return vmaxq_f32(a, b); }
+inline IntVector broadcastInt(int32_t x) { return vdupq_n_s32(x); }
+inline IntVector addInt(IntVector a, IntVector b) { return vaddq_s32(a, b); }
+inline IntVector subInt(IntVector a, IntVector b) { return vsubq_s32(a, b); }
+inline IntVector shiftLeft23(IntVector a) { return vshlq_n_s32(a, 23); }
+inline IntVector shiftRight23(IntVector a) { return vshrq_n_s32(a, 23); }
+inline IntVector truncate(Vector a) { return vcvtq_s32_f32(a); }
+inline Vector toFloat(IntVector a) { return vcvtq_f32_s32(a); }
+inline IntVector bitsOf(Vector a) { return vreinterpretq_s32_f32(a); }
+inline Vector fromBits(IntVector a) { return vreinterpretq_f32_s32(a); }
+#else
+static constexpr int LANES = 1;
+using Vector = float;
+using IntVector = int32_t;
+inline Vector load(const float *p) { return *p; }
+inline void store(float *p, Vector v) { *p = v; }
+inline Vector broadcast(float x) { return x; }
+inline Vector add(Vector a, Vector b) { return a + b; }
+inline Vector sub(Vector a, Vector b) { return a - b; }
+inline Vector mul(Vector a, Vector b) { return a * b; }
+inline Vector div(Vector a, Vector b) { return a / b; }
+inline Vector min(Vector a, Vector b) { return std::min(a, b); }
+inline Vector max(Vector a, Vector b) { return std::max(a, b); }
+inline IntVector broadcastInt(int32_t x) { return x; }
+inline IntVector addInt(IntVector a, IntVector b) { return a + b; }
+inline IntVector subInt(IntVector a, IntVector b) { return a - b; }
+inline IntVector shiftLeft23(IntVector a) {
+  return (int32_t)((uint32_t)a << 23);
+}
+inline IntVector shiftRight23(IntVector a) { return a >> 23; }
+inline IntVector truncate(Vector a) { return (int32_t)a; }
+inline Vector toFloat(IntVector a) { return (float)a; }
+inline IntVector bitsOf(Vector a) {
+  int32_t bits;
+  std::memcpy(&bits, &a, sizeof(bits));
+  return bits;
+}
+inline Vector fromBits(IntVector a) {
+  float value;
+  std::memcpy(&value, &a, sizeof(value));
+  return value;
+}
+#endif
+
+/**
+ * Approximate log2(x) for positive, normal x, to within about 1e-7 (plus
+ * float rounding of the result). log2(1) is exactly 0.
+ */
+inline Vector log2(Vector x) {
+  // Split x into an exponent and a mantissa in [sqrt(0.5), sqrt(2)), which
+  // keeps the argument of the series below small:
+  const IntVector bits = bitsOf(x);
+  const IntVector exponent =
+      shiftRight23(subInt(bits, broadcastInt(0x3F3504F3)));
+  const Vector mantissa = fromBits(subInt(bits, shiftLeft23(exponent)));
+
+  // log2(m) = 2 * atanh((m - 1) / (m + 1)) / ln(2):
+  const Vector one = broadcast(1.0f);
+  const Vector t = div(sub(mantissa, one), add(mantissa, one));
+  const Vector t2 = mul(t, t);
+  Vector series = broadcast(0.412198583f);
+  series = add(mul(series, t2), broadcast(0.577078016f));
+  series = add(mul(series, t2), broadcast(0.961796694f));
+  series = add(mul(series, t2), broadcast(2.88539008f));
+  return add(toFloat(exponent), mul(series, t));
+}
+
+/**
+ * Approximate 2^x (with x clamped to [-125, 126], keeping the result out of
+ * the denormal range) to within about 3e-7 relative error. 2^0 is exactly 1.
+ */
+inline Vector exp2(Vector x) {
+  x = min(max(x, broadcast(-125.0f)), broadcast(126.0f));
+
+  // Round x to the nearest integer (truncating, after adding an offset to
+  // make it positive) and compute 2^f for the remainder f in [-0.5, 0.5]:
+  const IntVector integer =
+      subInt(truncate(add(x, broadcast(127.5f))), broadcastInt(127));
+  const Vector f = sub(x, toFloat(integer));
+
+  // The Taylor series of e^(f * ln(2)):
+  Vector series = broadcast(0.000154035304f);
+  series = add(mul(series, f), broadcast(0.00133335581f));
+  series = add(mul(series, f), broadcast(0.00961812911f));
+  series = add(mul(series, f), broadcast(0.0555041087f));
+  series = add(mul(series, f), broadcast(0.240226507f));
+  series = add(mul(series, f), broadcast(0.693147181f));
+  series = add(mul(series, f), broadcast(1.0f));
+
+  const Vector scale =
+      fromBits(shiftLeft23(addInt(integer, broadcastInt(127))));
+  return mul(series, scale);
+}
+
+/**
+ * Round a number of samples up to a whole number of vectors.
+ */
+inline int roundUpToLanes(int numSamples) {
+  return (numSamples + LANES - 1) / LANES * LANES;
+}
+
+/**
+ * Compute the gain of a downward compressor from its envelope: 1 below the
+ * threshold and (envelope / threshold)^(1 / ratio - 1) above it, as in
+ * juce::dsp::Compressor. Reads and writes numSamples rounded up to a whole
+ * number of vectors.
+ */
+inline void computeCompressorGain(const float *envelope, float *gain,
+                                  int numSamples, float thresholdInverse,
+                                  float exponent) {
+  const Vector scale = broadcast(thresholdInverse);
+  const Vector power = broadcast(exponent);
+  const Vector one = broadcast(1.0f);
+  const Vector largest = broadcast(std::numeric_limits<float>::max());
+  for (int i = 0; i < roundUpToLanes(numSamples); i += LANES) {
+    Vector ratio = min(max(mul(load(envelope + i), scale), one), largest);
+    store(gain + i, exp2(mul(power, log2(ratio))));
+  }
+}
+
+/**
+ * Compute the gain of a downward expander (or gate) from its envelope: 1
+ * above the threshold and (envelope / threshold)^(ratio - 1) below it, as in
+ * juce::dsp::NoiseGate. Reads and writes numSamples rounded up to a whole
+ * number of vectors.
+ */
+inline void computeExpanderGain(const float *envelope, float *gain,
+                                int numSamples, float thresholdInverse,
+                                float exponent) {
+  const Vector scale = broadcast(thresholdInverse);
+  const Vector power = broadcast(exponent);
+  const Vector one = broadcast(1.0f);
+  const Vector smallest = broadcast(std::numeric_limits<float>::min());
+  for (int i = 0; i < roundUpToLanes(numSamples); i += LANES) {
+    Vector ratio = max(min(mul(load(envelope + i), scale), one), smallest);
+    store(gain + i, exp2(mul(power, log2(ratio))));
+  }
+}
+
+/**
+ * The level detection used by an envelope follower: either the absolute
+ * value of each sample (Peak), or its square (RMS).
+ */
+enum class Detection { Peak, RMS };
+
+/**
+ * Write the level of each sample of the given channels into `output`. If
+ * more than one channel is provided, the loudest channel's level is used
+ * for each sample (i.e.: for linked stereo detection).
+ */
+inline void detectLevel(Detection detection, const float *const *channels,
+                        int numChannels, int startSample, int numSamples,
+                        float *output) {
+  for (int c = 0; c < numChannels; c++) {
+    const float *input = channels[c] + startSample;
+    if (c == 0) {
+      if (detection == Detection::Peak) {
+        juce::FloatVectorOperations::abs(output, input, numSamples);
+      } else {
+        juce::FloatVectorOperations::multiply(output, input, input,
+                                              numSamples);
+      }
+    } else {
+      for (int i = 0; i < numSamples; i++) {
+        float level = detection == Detection::Peak ? std::abs(input[i])
+                                                   : input[i] * input[i];
+        output[i] = std::max(output[i], level);
+      }
+    }
+  }
+}
+
+/**
+ * A one-pole envelope follower with separate attack and release times for
+ * each of several channels, equivalent to juce::dsp::BallisticsFilter (but
+ * taking already-detected levels as input, a block at a time).
+ */
+class EnvelopeFollower {
+public:
+  void prepare(double newSampleRate, int numChannels) {
+    sampleRate = newSampleRate;
+    state.assign(std::max(numChannels, 1), 0.0f);
+    update();
+  }
+
+  void reset() { std::fill(state.begin(), state.end(), 0.0f); }
+
+  void setAttackTime(float attackTimeMs) {
+    attackTime = attackTimeMs;
+    update();
+  }
+
+  void setReleaseTime(float releaseTimeMs) {
+    releaseTime = releaseTimeMs;
+    update();
+  }
+
+  /**
+   * Advance an envelope by one sample of (non-negative) level.
+   */
+  float next(float envelope, float level) const {
+    float coefficient =
+        level > envelope ? attackCoefficient : releaseCoefficient;
+    return level + coefficient * (envelope - level);
+  }
+
+  float &getState(int channel) { return state[channel]; }
+
+  /**
+   * Follow the envelopes of N consecutive channels' levels in place. This
+   * recursion is the only part of a dynamics processor that has to run one
+   * sample at a time, but following two channels in the same loop lets
+   * their (independent) recursions overlap in the CPU's pipeline.
+   */
+  template <int N>
+  void process(int firstChannel, float *const *levels, int numSamples) {
+    float envelopes[N];
+    for (int c = 0; c < N; c++)
+      envelopes[c] = state[firstChannel + c];
+
+    for (int i = 0; i < numSamples; i++) {
+      for (int c = 0; c < N; c++) {
+        envelopes[c] = next(envelopes[c], levels[c][i]);
+        levels[c][i] = envelopes[c];
+      }
+    }
+
+    for (int c = 0; c < N; c++)
+      state[firstChannel + c] = envelopes[c];
+  }
+
+private:
+  void update() {
+    const float expFactor =
+        (float)(-2.0 * juce::MathConstants<double>::pi * 1000.0 / sampleRate);
+    attackCoefficient = getCoefficient(expFactor, attackTime);
+    releaseCoefficient = getCoefficient(expFactor, releaseTime);
+  }
+
+  static float getCoefficient(float expFactor, float timeMs) {
+    return timeMs < 1.0e-3f ? 0.0f : std::exp(expFactor / timeMs);
+  }
+
+  double sampleRate = 44100.0;
+  float attackTime = 1.0f;
+  float releaseTime = 100.0f;
+  float attackCoefficient = 0.0f;
+  float releaseCoefficient = 0.0f;
+  std::vector<float> state;
+};
+
+/**
+ * Run a dynamics processor over a buffer, a chunk at a time. For each group
+ * of channels with their own envelopes (every channel at once if linked, or
+ * otherwise pairs of channels, so that two envelopes can be followed in the
+ * same loop), this writes each group's levels into scratch arrays, calls
+ * `follow(std::integral_constant<int, N>(), firstChannel, levels,
+ * numSamples)` to turn the levels of N channels into envelopes in place,
+ * then calls `computeGain(envelope, gain, numSamples)` and applies the
+ * resulting gain to the group's channels.
+ */
+template <typename FollowFunction, typename GainFunction>
+void processInChunks(Detection detection, bool linked,
+                     float *const *channels, int numChannels, int numSamples,
+                     FollowFunction follow, GainFunction computeGain) {
+  // The gain computers read whole vectors, so the scratch arrays are padded
+  // with (harmless) zeros rather than left uninitialized:
+  alignas(32) float levels[2][CHUNK_SIZE] = {};
+  alignas(32) float gain[CHUNK_SIZE];
+  float *levelPointers[2] = {levels[0], levels[1]};
+
+  for (int start = 0; start < numSamples; start += CHUNK_SIZE) {
+    const int chunkSize = std::min(CHUNK_SIZE, numSamples - start);
+
+    if (linked) {
+      detectLevel(detection, channels, numChannels, start, chunkSize,
+                  levels[0]);
+      follow(std::integral_constant<int, 1>(), 0, levelPointers, chunkSize);
+      computeGain(levels[0], gain, chunkSize);
+      for (int c = 0; c < numChannels; c++)
+        juce::FloatVectorOperations::multiply(channels[c] + start, gain,
+                                              chunkSize);
+      continue;
+    }
+
+    for (int c = 0; c < numChannels; c += 2) {
+      const int groupSize = std::min(2, numChannels - c);
+      for (int i = 0; i < groupSize; i++)
+        detectLevel(detection, channels + c + i, 1, start, chunkSize,
+                    levels[i]);
+
+      if (groupSize == 2) {
+        follow(std::integral_constant<int, 2>(), c, levelPointers, chunkSize);
+      } else {
+        follow(std::integral_constant<int, 1>(), c, levelPointers, chunkSize);
+      }
+
+      for (int i = 0; i < groupSize; i++) {
+        computeGain(levels[i], gain, chunkSize);
+        juce::FloatVectorOperations::multiply(channels[c + i] + start, gain,
+                                              chunkSize);
+      }
+    }
+  }
+}
+
+} // namespace dynamics
+
+/**
+ * A block-based replacement for juce::dsp::Compressor, with the same
+ * parameters and (within about -120dB) the same output. Rather than
+ * computing each sample's envelope, gain, and output in turn, each chunk of
+ * audio is passed through the envelope follower and then through a
+ * vectorized gain computer, avoiding a call to std::pow for every sample.
+ *
+ * If linked, the envelope is computed from the loudest channel at each
+ * sample and the same gain is applied to every channel, preserving the
+ * stereo image. Otherwise (like JUCE's Compressor) each channel is
+ * compressed independently.
+ */
+template <typename SampleType> class DynamicsCompressor {
+  static_assert(std::is_same<SampleType, float>::value,
+                "DynamicsCompressor only supports 32-bit audio.");
+
+public:
+  DynamicsCompressor() { update(); }
+
+  void setThreshold(SampleType newThresholddB) {
+    thresholddB = newThresholddB;
+    update();
+  }
+
+  void setRatio(SampleType newRatio) {
+    jassert(newRatio >= 1.0);
+    ratio = newRatio;
+    update();
+  }
+
+  void setAttack(SampleType newAttack) {
+    envelopeFollower.setAttackTime(newAttack);
+  }
+
+  void setRelease(SampleType newRelease) {
+    envelopeFollower.setReleaseTime(newRelease);
+  }
+
+  void setLinked(bool newLinked) { linked = newLinked; }
+
+  void prepare(const juce::dsp::ProcessSpec &spec) {
+    jassert(spec.sampleRate > 0);
+    jassert(spec.numChannels > 0);
+    envelopeFollower.prepare(spec.sampleRate, spec.numChannels);
+    reset();
+  }
+
+  void reset() { envelopeFollower.reset(); }
+
+  template <typename ProcessContext>
+  void process(const ProcessContext &context) noexcept {
+    auto &outputBlock = context.getOutputBlock();
+    if (context.usesSeparateInputAndOutputBlocks())
+      outputBlock.copyFrom(context.getInputBlock());
+    if (context.isBypassed)
+      return;
+
+    const int numChannels = (int)outputBlock.getNumChannels();
+    const int numSamples = (int)outputBlock.getNumSamples();
+    float **channels = (float **)alloca(numChannels * sizeof(float *));
+    for (int c = 0; c < numChannels; c++)
+      channels[c] = outputBlock.getChannelPointer(c);
+
+    process(channels, numChannels, numSamples);
+  }
+
+  void process(float *const *channels, int numChannels, int numSamples) {
+    const float exponent = 1.0f / ratio - 1.0f;
+    dynamics::processInChunks(
+        dynamics::Detection::Peak, linked, channels, numChannels, numSamples,
+        [this](auto numEnvelopes, int firstChannel, float *const *levels,
+               int numLevels) {
+          envelopeFollower.template process<decltype(numEnvelopes)::value>(
+              firstChannel, levels, numLevels);
+        },
+        [&](const float *envelope, float *gain, int numLevels) {
+          dynamics::computeCompressorGain(envelope, gain, numLevels,
+                                          thresholdInverse, exponent);
+        });
+  }
+
+private:
+  void update() {
+    float threshold =
+        juce::Decibels::decibelsToGain(thresholddB, (SampleType)-200.0);
+    thresholdInverse = 1.0f / threshold;
+  }
+
+  SampleType thresholddB = 0.0, ratio = 1.0;
+  float thresholdInverse = 1.0f;
+  bool linked = false;
+  dynamics::EnvelopeFollower envelopeFollower;
+};
+
+/**
+ * A block-based replacement for juce::dsp::NoiseGate, with the same
+ * parameters and (within about -120dB) the same output. Like JUCE's
+ * NoiseGate, the level of the input is measured with a fast RMS detector
+ * (with a 50ms release time) before being passed through the envelope
+ * follower. See DynamicsCompressor for a description of linked processing.
+ */
+template <typename SampleType> class DynamicsNoiseGate {
+  static_assert(std::is_same<SampleType, float>::value,
+                "DynamicsNoiseGate only supports 32-bit audio.");
+
+public:
+  DynamicsNoiseGate() {
+    rmsFollower.setAttackTime(0.0f);
+    rmsFollower.setReleaseTime(50.0f);
+    update();
+  }
+
+  void setThreshold(SampleType newThresholddB) {
+    thresholddB = newThresholddB;
+    update();
+  }
+
+  void setRatio(SampleType newRatio) {
+    jassert(newRatio >= 1.0);
+    ratio = newRatio;
+  }
+
+  void setAttack(SampleType newAttack) {
+    envelopeFollower.setAttackTime(newAttack);
+  }
+
+  void setRelease(SampleType newRelease) {
+    envelopeFollower.setReleaseTime(newRelease);
+  }
+
+  void setLinked(bool newLinked) { linked = newLinked; }
+
+  void prepare(const juce::dsp::ProcessSpec &spec) {
+    jassert(spec.sampleRate > 0);
+    jassert(spec.numChannels > 0);
+    rmsFollower.prepare(spec.sampleRate, spec.numChannels);
+    envelopeFollower.prepare(spec.sampleRate, spec.numChannels);
+    reset();
+  }
+
+  void reset() {
+    rmsFollower.reset();
+    envelopeFollower.reset();
+  }
+
+  template <typename ProcessContext>
+  void process(const ProcessContext &context) noexcept {
+    auto &outputBlock = context.getOutputBlock();
+    if (context.usesSeparateInputAndOutputBlocks())
+      outputBlock.copyFrom(context.getInputBlock());
+    if (context.isBypassed)
+      return;
+
+    const int numChannels = (int)outputBlock.getNumChannels();
+    const int numSamples = (int)outputBlock.getNumSamples();
+    float **channels = (float **)alloca(numChannels * sizeof(float *));
+    for (int c = 0; c < numChannels; c++)
+      channels[c] = outputBlock.getChannelPointer(c);
+
+    const float exponent = ratio - 1.0f;
+    dynamics::processInChunks(
+        dynamics::Detection::RMS, linked, channels, numChannels, numSamples,
+        [this](auto numEnvelopes, int firstChannel, float *const *levels,
+               int numLevels) {
+          followLevels<decltype(numEnvelopes)::value>(firstChannel, levels,
+                                                      numLevels);
+        },
+        [&](const float *envelope, float *gain, int numLevels) {
+          dynamics::computeExpanderGain(envelope, gain, numLevels,
+                                        thresholdInverse, exponent);
+        });
+  }
+
+private:
+  void update() {
+    float threshold =
+        juce::Decibels::decibelsToGain(thresholddB, (SampleType)-200.0);
+    thresholdInverse = 1.0f / threshold;
+  }
+
+  /**
+   * Pass the squared levels of N consecutive channels through the RMS
+   * detector and then the envelope follower, in place, in a single loop.
+   */
+  template <int N>
+  void followLevels(int firstChannel, float *const *levels, int numSamples) {
+    float rms[N], envelopes[N];
+    for (int c = 0; c < N; c++) {
+      rms[c] = rmsFollower.getState(firstChannel + c);
+      envelopes[c] = envelopeFollower.getState(firstChannel + c);
+    }
+
+    for (int i = 0; i < numSamples; i++) {
+      for (int c = 0; c < N; c++) {
+        rms[c] = rmsFollower.next(rms[c], levels[c][i]);
+        envelopes[c] = envelopeFollower.next(envelopes[c], std::sqrt(rms[c]));
+        levels[c][i] = envelopes[c];
+      }
+    }
+
+    for (int c = 0; c < N; c++) {
+      rmsFollower.getState(firstChannel + c) = rms[c];
+      envelopeFollower.getState(firstChannel + c) = envelopes[c];
+    }
+  }
+
+  SampleType thresholddB = -100.0, ratio = 10.0;
+  float thresholdInverse = 1.0f;
+  bool linked = false;
+  dynamics::EnvelopeFollower rmsFollower, envelopeFollower;
+};
+
+/**
+ * A block-based replacement for juce::dsp::Limiter, built from two
+ * DynamicsCompressors with the same settings as JUCE's Limiter, followed by
+ * makeup gain and a hard clipper at 0dB.
+ */
+template <typename SampleType> class DynamicsLimiter {
+  static_assert(std::is_same<SampleType, float>::value,
+                "DynamicsLimiter only supports 32-bit audio.");
+
+public:
+  DynamicsLimiter() {
+    firstStageCompressor.setThreshold((SampleType)-10.0);
+    firstStageCompressor.setRatio((SampleType)4.0);
+    firstStageCompressor.setAttack((SampleType)2.0);
+    firstStageCompressor.setRelease((SampleType)200.0);
+    secondStageCompressor.setRatio((SampleType)1000.0);
+    secondStageCompressor.setAttack((SampleType)0.001);
+    update();
+  }
+
+  void setThreshold(SampleType newThresholddB) {
+    thresholddB = newThresholddB;
+    update();
+  }
+
+  void setRelease(SampleType newRelease) {
+    releaseTime = newRelease;
+    update();
+  }
+
+  void setLinked(bool newLinked) {
+    firstStageCompressor.setLinked(newLinked);
+    secondStageCompressor.setLinked(newLinked);
+  }
+
+  void prepare(const juce::dsp::ProcessSpec &spec) {
+    jassert(spec.sampleRate > 0);
+    jassert(spec.numChannels > 0);
+    sampleRate = spec.sampleRate;
+    firstStageCompressor.prepare(spec);
+    secondStageCompressor.prepare(spec);
+    update();
+    reset();
+  }
+
+  void reset() {
+    firstStageCompressor.reset();
+    secondStageCompressor.reset();
+    outputVolume.reset(sampleRate, 0.001);
+  }
+
+  template <typename ProcessContext>
+  void process(const ProcessContext &context) noexcept {
+    auto &outputBlock = context.getOutputBlock();
+    if (context.usesSeparateInputAndOutputBlocks())
+      outputBlock.copyFrom(context.getInputBlock());
+    if (context.isBypassed)
+      return;
+
+    const int numChannels = (int)outputBlock.getNumChannels();
+    const int numSamples = (int)outputBlock.getNumSamples();
+    float **channels = (float **)alloca(numChannels * sizeof(float *));
+    for (int c = 0; c < numChannels; c++)
+      channels[c] = outputBlock.getChannelPointer(c);
+
+    firstStageCompressor.process(channels, numChannels, numSamples);
+    secondStageCompressor.process(channels, numChannels, numSamples);
+
+    if (outputVolume.isSmoothing()) {
+      for (int i = 0; i < numSamples; i++) {
+        float gain = outputVolume.getNextValue();
+        for (int c = 0; c < numChannels; c++)
+          channels[c][i] *= gain;
+      }
+    } else {
+      for (int c = 0; c < numChannels; c++)
+        juce::FloatVectorOperations::multiply(
+            channels[c], outputVolume.getTargetValue(), numSamples);
+    }
+
+    for (int c = 0; c < numChannels; c++)
+      juce::FloatVectorOperations::clip(channels[c], channels[c], -1.0f, 1.0f,
+                                        numSamples);
+  }
+
+private:
+  void update() {
+    secondStageCompressor.setThreshold(thresholddB);
+    secondStageCompressor.setRelease(releaseTime);
+
+    // Makeup gain for both stages, as in juce::dsp::Limiter:
+    auto ratioInverse = (SampleType)(1.0 / 4.0);
+    auto gain = (SampleType)std::pow(10.0, 10.0 * (1.0 - ratioInverse) / 40.0);
+    gain *= juce::Decibels::decibelsToGain(-thresholddB, (SampleType)-100.0);
+    outputVolume.setTargetValue(gain);
+  }
+
+  DynamicsCompressor<SampleType> firstStageCompressor, secondStageCompressor;
+  juce::SmoothedValue<SampleType, juce::ValueSmoothingTypes::Linear>
+      outputVolume;
+  double sampleRate = 44100.0;
+  SampleType thresholddB = -10.0, releaseTime = 100.0;
+};
+
+} // namespace Pedalboard
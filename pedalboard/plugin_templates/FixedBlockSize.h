@@ -29,6 +29,13 @@ namespace Pedalboard {
  * but ensures that its process() function is only ever passed a fixed
  * block size. This block size can be set in the prepare() method, or as a
  * template argument.
+ *
+ * If the host's block size is a multiple of the fixed block size, each block
+ * is processed in place with no added latency. Otherwise, full blocks are
+ * still processed in place where possible, partial blocks are collected in a
+ * staging buffer, and output is read back out of a ring buffer, adding
+ * (blockSize - 1) samples of latency to the stream. All buffers are allocated
+ * in prepare(); nothing is allocated or shifted per call.
  */
 template <typename T, unsigned int DefaultBlockSize = 0,
           typename SampleType = float>
@@ -41,19 +48,17 @@ public:
         lastSpec.maximumBlockSize != spec.maximumBlockSize ||
         lastSpec.numChannels != spec.numChannels) {
       if (spec.maximumBlockSize % blockSize == 0) {
-        // We need much less intermediate memory in this case:
-        inputBuffer.setSize(spec.numChannels, blockSize);
-        outputBuffer.clear();
         inStreamLatency = 0;
       } else {
-        inputBuffer.setSize(spec.numChannels,
-                            blockSize * 2 + spec.maximumBlockSize * 2);
-        outputBuffer.setSize(spec.numChannels,
-                             blockSize * 2 + spec.maximumBlockSize * 2);
-        // Add enough latency to the stream to allow us to process an entire
-        // block:
-        inStreamLatency = blockSize;
+        // Add enough latency to the stream to allow us to always have a full
+        // block processed by the time its last sample needs to be output:
+        inStreamLatency = blockSize - 1;
       }
+
+      stagingBuffer.setSize(spec.numChannels, blockSize);
+      ringBuffer.setSize(spec.numChannels,
+                         spec.maximumBlockSize + blockSize * 3);
+      clearBufferedState();
       lastSpec = spec;
     }
 
@@ -67,165 +72,64 @@ public:
   virtual int
   process(const juce::dsp::ProcessContextReplacing<SampleType> &context) {
     auto ioBlock = context.getOutputBlock();
+    const int numSamples = (int)ioBlock.getNumSamples();
 
-    if (lastSpec.maximumBlockSize % blockSize == 0) {
-      // The best case scenario: the input is evenly divisible
-      // by the fixed block size, so we need no buffers!
-      int samplesOutput = 0;
-      for (int i = 0; i < ioBlock.getNumSamples(); i += blockSize) {
-        int samplesAvailable =
-            std::min((int)blockSize, (int)ioBlock.getNumSamples() - i);
-        if (samplesAvailable < blockSize)
-          break;
-
-        juce::dsp::AudioBlock<SampleType> subBlock =
-            ioBlock.getSubBlock(i, blockSize);
-        juce::dsp::ProcessContextReplacing<SampleType> subContext(subBlock);
-        int samplesOutputThisBlock = plugin.process(subContext);
-
-        if (samplesOutput > 0 && samplesOutputThisBlock < blockSize) {
-          throw std::runtime_error(
-              "Plugin that using FixedBlockSize "
-              "returned too few samples! This is an internal Pedalboard error "
-              "and should be reported.");
-        }
-        samplesOutput += samplesOutputThisBlock;
-      }
-
-      int remainderInSamples = ioBlock.getNumSamples() % blockSize;
-      if (remainderInSamples > 0) {
-        // We're at the end of our buffer, so pad with zeros.
-        int offset = ioBlock.getNumSamples() - remainderInSamples;
-
-        // Copy the remainder into inputBuffer:
-        juce::dsp::AudioBlock<SampleType> inputBlock(inputBuffer);
-        juce::dsp::AudioBlock<SampleType> subBlock =
-            inputBlock.getSubBlock(0, blockSize);
-
-        subBlock.clear();
-        subBlock.copyFrom(ioBlock.getSubBlock(offset, remainderInSamples));
-
-        juce::dsp::ProcessContextReplacing<SampleType> subContext(subBlock);
-        int samplesOutputThisBlock = plugin.process(subContext);
-
-        // Copy the output back into ioBlock, right-aligned:
-        ioBlock
-            .getSubBlock(ioBlock.getNumSamples() - remainderInSamples,
-                         remainderInSamples)
-            .copyFrom(subBlock);
-
-        samplesOutput += remainderInSamples;
-      }
-
-      samplesProcessed += samplesOutput;
-      return samplesOutput;
-    } else {
-      // We have to render three parts:
-      // 1) Push as many samples as possible into inputBuffer
-      if (inputBuffer.getNumSamples() - inputBufferSamples <
-          ioBlock.getNumSamples()) {
-        throw std::runtime_error("Input buffer overflow! This is an internal "
-                                 "Pedalboard error and should be reported.");
-      }
-
-      ioBlock.copyTo(inputBuffer, 0, inputBufferSamples,
-                     ioBlock.getNumSamples());
-      inputBufferSamples += ioBlock.getNumSamples();
-
-      // 2) Copy the output from the previous render call into the ioBlock
-      int samplesOutput = 0;
-
-      if (outputBufferSamples >= ioBlock.getNumSamples()) {
-        ioBlock.copyFrom(outputBuffer, 0, 0, ioBlock.getNumSamples());
-        outputBufferSamples -= ioBlock.getNumSamples();
-
-        // Move the remainder of the output buffer to the left:
-        if (outputBufferSamples > 0) {
-          for (int i = 0; i < outputBuffer.getNumChannels(); i++) {
-            std::memmove(outputBuffer.getWritePointer(i),
-                         outputBuffer.getWritePointer(i) +
-                             ioBlock.getNumSamples(),
-                         sizeof(SampleType) * outputBufferSamples);
-          }
-        }
-
-        samplesOutput = ioBlock.getNumSamples();
-      }
+    if (inStreamLatency == 0 && stagingSamples == 0 && ringSamples == 0 &&
+        numSamples % blockSize == 0) {
+      // The best case scenario: nothing is buffered and the input is evenly
+      // divisible by the fixed block size, so we need no buffers!
+      return processInPlace(ioBlock);
+    }
 
-      // 3) If the input buffer is large enough, process!
-      int samplesProcessed = 0;
-      int inputSamplesConsumed = 0;
-      juce::dsp::AudioBlock<SampleType> inputBlock(inputBuffer);
-      for (int i = 0; i < inputBufferSamples; i += blockSize) {
-        int samplesAvailable = std::min(blockSize, inputBufferSamples - i);
-        if (samplesAvailable < blockSize)
-          break;
-
-        juce::dsp::AudioBlock<SampleType> subBlock =
-            inputBlock.getSubBlock(i, blockSize);
-        juce::dsp::ProcessContextReplacing<SampleType> subContext(subBlock);
-        int samplesProcessedThisBlock = plugin.process(subContext);
-        inputSamplesConsumed += blockSize;
-
-        if (samplesProcessedThisBlock > 0) {
-          // Move the output to the left side of the buffer:
-          inputBlock.move(i + blockSize - samplesProcessedThisBlock,
-                          samplesProcessed, samplesProcessedThisBlock);
+    juce::dsp::AudioBlock<SampleType> stagingBlock(stagingBuffer);
+    for (int i = 0; i < numSamples;) {
+      if (stagingSamples == 0 && numSamples - i >= (int)blockSize) {
+        // A full block is available in ioBlock itself, so process it there:
+        processBlock(ioBlock.getSubBlock(i, blockSize));
+        i += blockSize;
+      } else {
+        int samplesToStage =
+            std::min((int)blockSize - stagingSamples, numSamples - i);
+        stagingBlock.getSubBlock(stagingSamples, samplesToStage)
+            .copyFrom(ioBlock.getSubBlock(i, samplesToStage));
+        stagingSamples += samplesToStage;
+        i += samplesToStage;
+
+        if (stagingSamples == (int)blockSize) {
+          processBlock(stagingBlock);
+          stagingSamples = 0;
         }
-
-        samplesProcessed += samplesProcessedThisBlock;
-      }
-
-      // Copy the newly-processed data into the output buffer:
-      if (outputBuffer.getNumSamples() <
-          outputBufferSamples + samplesProcessed) {
-        throw std::runtime_error("Output buffer overflow! This is an internal "
-                                 "Pedalboard error and should be reported.");
       }
-      inputBlock.copyTo(outputBuffer, 0, outputBufferSamples, samplesProcessed);
-      outputBufferSamples += samplesProcessed;
-
-      // ... and move the remaining input data to the left of the input buffer:
-      inputBlock.move(inputSamplesConsumed, 0,
-                      inputBufferSamples - inputSamplesConsumed);
-      inputBufferSamples -= inputSamplesConsumed;
-
-      // ... and try to output the remaining output buffer contents if we now
-      // have enough:
-      if (samplesOutput == 0 &&
-          outputBufferSamples >= ioBlock.getNumSamples()) {
-        ioBlock.copyFrom(outputBuffer, 0, 0, ioBlock.getNumSamples());
-        outputBufferSamples -= ioBlock.getNumSamples();
-
-        // Move the remainder of the output buffer to the left:
-        if (outputBufferSamples > 0) {
-          for (int i = 0; i < outputBuffer.getNumChannels(); i++) {
-            std::memmove(outputBuffer.getWritePointer(i),
-                         outputBuffer.getWritePointer(i) +
-                             ioBlock.getNumSamples(),
-                         sizeof(SampleType) * outputBufferSamples);
-          }
-        }
-
-        samplesOutput = ioBlock.getNumSamples();
-      }
-
-      samplesProcessed += samplesOutput;
-      return samplesOutput;
     }
+    samplesReceived += numSamples;
+
+    // Output everything up to the in-stream latency (and any latency added by
+    // the nested plugin itself), which is always available in the ring buffer
+    // once the stream has been primed:
+    long long nestedPluginLatency =
+        blocksProcessed * (long long)blockSize - samplesProduced;
+    long long samplesDue = samplesReceived - inStreamLatency -
+                           nestedPluginLatency - samplesEmitted;
+    int samplesToOutput = (int)std::max(
+        0LL, std::min(samplesDue, (long long)std::min(numSamples, ringSamples)));
+
+    popFromRing(ioBlock.getSubBlock(numSamples - samplesToOutput,
+                                    samplesToOutput));
+    samplesEmitted += samplesToOutput;
+    return samplesToOutput;
   }
 
   virtual void reset() {
-    inputBufferSamples = 0;
-    outputBufferSamples = 0;
-
-    inStreamLatency = 0;
-    samplesProcessed = 0;
+    clearBufferedState();
     lastSpec = {0};
     plugin.reset();
 
-    inputBuffer.clear();
-    outputBuffer.clear();
+    stagingBuffer.clear();
+    ringBuffer.clear();
+  }
+
+  virtual int getLatencyHint() {
+    return inStreamLatency + plugin.getLatencyHint();
   }
 
   T &getNestedPlugin() { return plugin; }
@@ -238,17 +142,119 @@ public:
   int getFixedBlockSize() const { return blockSize; }
 
 private:
+  /**
+   * Process a block whose length is a multiple of blockSize directly in
+   * place, returning the number of samples output (right-aligned, as usual).
+   */
+  int processInPlace(juce::dsp::AudioBlock<SampleType> ioBlock) {
+    const int numSamples = (int)ioBlock.getNumSamples();
+    int samplesOutput = 0;
+
+    for (int i = 0; i < numSamples; i += blockSize) {
+      juce::dsp::AudioBlock<SampleType> subBlock =
+          ioBlock.getSubBlock(i, blockSize);
+      juce::dsp::ProcessContextReplacing<SampleType> subContext(subBlock);
+      int samplesOutputThisBlock = plugin.process(subContext);
+
+      if (samplesOutput > 0 && samplesOutputThisBlock < (int)blockSize) {
+        // Keep the output contiguous by moving what we've already output up
+        // against the start of this block's (right-aligned) output:
+        ioBlock.move(i - samplesOutput,
+                     i + blockSize - samplesOutputThisBlock - samplesOutput,
+                     samplesOutput);
+      }
+      samplesOutput += samplesOutputThisBlock;
+    }
+
+    samplesReceived += numSamples;
+    blocksProcessed += numSamples / blockSize;
+    samplesProduced += samplesOutput;
+    samplesEmitted += samplesOutput;
+    return samplesOutput;
+  }
+
+  /**
+   * Process exactly blockSize samples in place, and push the plugin's output
+   * onto the end of the ring buffer.
+   */
+  void processBlock(juce::dsp::AudioBlock<SampleType> block) {
+    juce::dsp::ProcessContextReplacing<SampleType> subContext(block);
+    int samplesOutputThisBlock = plugin.process(subContext);
+
+    if (ringBuffer.getNumSamples() - ringSamples < samplesOutputThisBlock) {
+      throw std::runtime_error("Output buffer overflow! This is an internal "
+                               "Pedalboard error and should be reported.");
+    }
+
+    juce::dsp::AudioBlock<SampleType> ringBlock(ringBuffer);
+    const int capacity = ringBuffer.getNumSamples();
+    int writePosition = (ringReadPosition + ringSamples) % capacity;
+    int offset = blockSize - samplesOutputThisBlock;
+    int firstPart = std::min(samplesOutputThisBlock, capacity - writePosition);
+    ringBlock.getSubBlock(writePosition, firstPart)
+        .copyFrom(block.getSubBlock(offset, firstPart));
+    if (firstPart < samplesOutputThisBlock) {
+      ringBlock.getSubBlock(0, samplesOutputThisBlock - firstPart)
+          .copyFrom(block.getSubBlock(offset + firstPart,
+                                      samplesOutputThisBlock - firstPart));
+    }
+
+    ringSamples += samplesOutputThisBlock;
+    blocksProcessed++;
+    samplesProduced += samplesOutputThisBlock;
+  }
+
+  /**
+   * Move the oldest samples in the ring buffer into the given block, which
+   * must be no longer than the number of samples in the ring buffer.
+   */
+  void popFromRing(juce::dsp::AudioBlock<SampleType> destination) {
+    const int numSamples = (int)destination.getNumSamples();
+    if (numSamples == 0)
+      return;
+
+    juce::dsp::AudioBlock<SampleType> ringBlock(ringBuffer);
+    const int capacity = ringBuffer.getNumSamples();
+    int firstPart = std::min(numSamples, capacity - ringReadPosition);
+    destination.getSubBlock(0, firstPart)
+        .copyFrom(ringBlock.getSubBlock(ringReadPosition, firstPart));
+    if (firstPart < numSamples) {
+      destination.getSubBlock(firstPart, numSamples - firstPart)
+          .copyFrom(ringBlock.getSubBlock(0, numSamples - firstPart));
+    }
+
+    ringReadPosition = (ringReadPosition + numSamples) % capacity;
+    ringSamples -= numSamples;
+  }
+
+  void clearBufferedState() {
+    stagingSamples = 0;
+    ringReadPosition = 0;
+    ringSamples = 0;
+
+    samplesReceived = 0;
+    samplesEmitted = 0;
+    samplesProduced = 0;
+    blocksProcessed = 0;
+  }
+
   T plugin;
   unsigned int blockSize = DefaultBlockSize;
   int inStreamLatency = 0;
 
-  juce::AudioBuffer<SampleType> inputBuffer;
-  unsigned int inputBufferSamples = 0;
+  // Input samples waiting for a full block to be available:
+  juce::AudioBuffer<SampleType> stagingBuffer;
+  int stagingSamples = 0;
 
-  juce::AudioBuffer<SampleType> outputBuffer;
-  unsigned int outputBufferSamples = 0;
+  // Output samples produced by the plugin, but not yet returned:
+  juce::AudioBuffer<SampleType> ringBuffer;
+  int ringReadPosition = 0;
+  int ringSamples = 0;
 
-  unsigned int samplesProcessed = 0;
+  long long samplesReceived = 0;
+  long long samplesEmitted = 0;
+  long long samplesProduced = 0;
+  long long blocksProcessed = 0;
 };
 
 // TODO: Add plugin wrappers to make mono plugins stereo (and/or multichannel),
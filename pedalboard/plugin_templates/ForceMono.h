@@ -79,6 +79,10 @@ public:
 
   T &getNestedPlugin() { return plugin; }
 
+  // The nested plugin can't be copied generically, so specialize this for
+  // any nested plugin type that can be; see Plugin::clone.
+  virtual std::shared_ptr<Plugin> clone() override { return Plugin::clone(); }
+
 private:
   T plugin;
 };
@@ -0,0 +1,563 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "../JuceHeader.h"
+
+namespace Pedalboard {
+
+namespace modulation {
+
+// Audio is processed in chunks of at most this many samples, so that the
+// modulation tables computed for each chunk fit in small (stack-allocated)
+// arrays that stay in the L1 cache while each channel is processed:
+static constexpr int CHUNK_SIZE = 256;
+
+using SmoothedValue =
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear>;
+
+/**
+ * Fill `output` with the next `numSamples` values of `value`. Smoothed values
+ * are only stepped one sample at a time while they're actually smoothing.
+ */
+inline void fillFromSmoothedValue(SmoothedValue &value, float *output,
+                                  int numSamples) {
+  int i = 0;
+  for (; i < numSamples && value.isSmoothing(); i++)
+    output[i] = value.getNextValue();
+  std::fill(output + i, output + numSamples, value.getTargetValue());
+}
+
+/**
+ * A sine wave low-frequency oscillator, equivalent to a
+ * juce::dsp::Oscillator<float> initialised with std::sin (and so with the
+ * same phase and frequency smoothing), which renders whole blocks of its
+ * output at once instead of one sample at a time.
+ */
+class SineLFO {
+public:
+  void setFrequency(float newFrequency) {
+    frequency.setTargetValue(newFrequency);
+  }
+
+  void prepare(double newSampleRate) {
+    sampleRate = newSampleRate;
+    reset();
+  }
+
+  void reset() {
+    phase = 0;
+    frequency.reset(sampleRate, 0.05);
+  }
+
+  /**
+   * Write the LFO's phase (in [-pi, pi)) for each of the next `numSamples`
+   * samples to `output`. As the phase is accumulated serially, the calls to
+   * std::sin that turn these into LFO values are left to the caller, to be
+   * made in a separate (vectorizable) loop.
+   */
+  void renderPhases(float *output, int numSamples) {
+    constexpr float twoPi = juce::MathConstants<float>::twoPi;
+    const double baseIncrement = twoPi / sampleRate;
+
+    for (int i = 0; i < numSamples; i++) {
+      const float increment = (float)(baseIncrement * frequency.getNextValue());
+      output[i] = phase - juce::MathConstants<float>::pi;
+
+      float next = phase + increment;
+      while (next >= twoPi)
+        next -= twoPi;
+      phase = next;
+    }
+  }
+
+private:
+  SmoothedValue frequency;
+  double sampleRate = 44100.0;
+  float phase = 0;
+};
+
+/**
+ * Linear dry/wet mixing with the same smoothing as juce::dsp::DryWetMixer,
+ * applied to one chunk of audio at a time.
+ */
+class DryWetMix {
+public:
+  void setWetMixProportion(float newMix) {
+    const float mix = juce::jlimit(0.0f, 1.0f, newMix);
+    dryVolume.setTargetValue(1.0f - mix);
+    wetVolume.setTargetValue(mix);
+  }
+
+  void reset(double sampleRate) {
+    dryVolume.reset(sampleRate, 0.05);
+    wetVolume.reset(sampleRate, 0.05);
+  }
+
+  /**
+   * Render the dry and wet gains of the next `numSamples` samples, to be
+   * passed to `mix` for each channel.
+   */
+  void renderGains(float *dryGains, float *wetGains, int numSamples) {
+    fillFromSmoothedValue(dryVolume, dryGains, numSamples);
+    fillFromSmoothedValue(wetVolume, wetGains, numSamples);
+  }
+
+  static void mix(float *dryInOut, const float *wet, const float *dryGains,
+                  const float *wetGains, int numSamples) {
+    for (int i = 0; i < numSamples; i++)
+      dryInOut[i] = wet[i] * wetGains[i] + dryInOut[i] * dryGains[i];
+  }
+
+private:
+  SmoothedValue dryVolume, wetVolume;
+};
+
+} // namespace modulation
+
+/**
+ * A block-based replacement for juce::dsp::Chorus, with the same parameters
+ * and the same output.
+ *
+ * The LFO and the resulting delay times are computed for a whole chunk of
+ * audio at once, and are shared by every channel. As the delay is always at
+ * least one millisecond long, no sample read from the delay line depends on
+ * any sample written in the preceding millisecond; each channel's delay line
+ * is read and written in runs of that length, which (along with a
+ * power-of-two-sized buffer, which avoids the modulo operations in
+ * juce::dsp::DelayLine) lets the compiler vectorize the interpolated reads
+ * and the feedback path.
+ */
+template <typename SampleType> class BlockRateChorus {
+  static_assert(std::is_same<SampleType, float>::value,
+                "BlockRateChorus only supports 32-bit audio.");
+
+public:
+  BlockRateChorus() { update(); }
+
+  void setRate(SampleType newRateHz) {
+    rate = newRateHz;
+    update();
+  }
+
+  void setDepth(SampleType newDepth) {
+    depth = newDepth;
+    update();
+  }
+
+  void setCentreDelay(SampleType newDelayMs) {
+    centreDelay = juce::jlimit((SampleType)1.0, maxCentreDelayMs, newDelayMs);
+  }
+
+  void setFeedback(SampleType newFeedback) {
+    feedback = newFeedback;
+    update();
+  }
+
+  void setMix(SampleType newMix) {
+    mix = newMix;
+    update();
+  }
+
+  void prepare(const juce::dsp::ProcessSpec &spec) {
+    jassert(spec.sampleRate > 0);
+    jassert(spec.numChannels > 0);
+    sampleRate = spec.sampleRate;
+
+    // Identical to the maximum delay of juce::dsp::Chorus:
+    maximumDelay = (float)std::ceil(
+        (maximumDelayModulation * maxDepth * oscVolumeMultiplier +
+         maxCentreDelayMs) *
+        sampleRate / 1000.0);
+
+    int bufferSize = 1;
+    while (bufferSize < (int)maximumDelay + 2)
+      bufferSize *= 2;
+    delayBufferMask = bufferSize - 1;
+    delayBuffers.assign(spec.numChannels, std::vector<float>(bufferSize));
+    lastOutput.resize(spec.numChannels);
+
+    osc.prepare(sampleRate);
+    update();
+    reset();
+  }
+
+  void reset() {
+    std::fill(lastOutput.begin(), lastOutput.end(), 0.0f);
+    for (auto &buffer : delayBuffers)
+      std::fill(buffer.begin(), buffer.end(), 0.0f);
+    writePosition = 0;
+
+    osc.reset();
+    dryWet.reset(sampleRate);
+    oscVolume.reset(sampleRate, 0.05);
+    feedbackVolume.reset(sampleRate, 0.05);
+  }
+
+  template <typename ProcessContext>
+  void process(const ProcessContext &context) noexcept {
+    auto &outputBlock = context.getOutputBlock();
+    if (context.usesSeparateInputAndOutputBlocks())
+      outputBlock.copyFrom(context.getInputBlock());
+    if (context.isBypassed)
+      return;
+
+    const int numChannels = (int)outputBlock.getNumChannels();
+    const int numSamples = (int)outputBlock.getNumSamples();
+    jassert(numChannels == (int)delayBuffers.size());
+
+    for (int start = 0; start < numSamples;
+         start += modulation::CHUNK_SIZE) {
+      const int n = std::min(modulation::CHUNK_SIZE, numSamples - start);
+
+      int delayInts[modulation::CHUNK_SIZE];
+      float delayFracs[modulation::CHUNK_SIZE];
+      const int minimumDelay = renderDelays(delayInts, delayFracs, n);
+
+      float feedbackGains[modulation::CHUNK_SIZE];
+      float dryGains[modulation::CHUNK_SIZE];
+      float wetGains[modulation::CHUNK_SIZE];
+      modulation::fillFromSmoothedValue(feedbackVolume, feedbackGains, n);
+      dryWet.renderGains(dryGains, wetGains, n);
+
+      for (int c = 0; c < numChannels; c++) {
+        float *channel = outputBlock.getChannelPointer(c) + start;
+        float wet[modulation::CHUNK_SIZE];
+
+        if (minimumDelay > 0) {
+          for (int i = 0; i < n; i += minimumDelay) {
+            processRun(c, channel + i, wet + i, delayInts + i, delayFracs + i,
+                       feedbackGains + i, std::min(minimumDelay, n - i),
+                       writePosition + i);
+          }
+        } else {
+          // At very low sample rates, reads may depend on the sample just
+          // written, so we have to process one sample at a time:
+          for (int i = 0; i < n; i++) {
+            processRun(c, channel + i, wet + i, delayInts + i, delayFracs + i,
+                       feedbackGains + i, 1, writePosition + i);
+          }
+        }
+
+        modulation::DryWetMix::mix(channel, wet, dryGains, wetGains, n);
+      }
+
+      writePosition = (writePosition + n) & delayBufferMask;
+    }
+  }
+
+private:
+  void update() {
+    osc.setFrequency(rate);
+    oscVolume.setTargetValue(depth * oscVolumeMultiplier);
+    dryWet.setWetMixProportion(mix);
+    feedbackVolume.setTargetValue(feedback);
+  }
+
+  /**
+   * Render the (integer and fractional) delay times of the next
+   * `numSamples` samples, returning the smallest integer delay.
+   */
+  int renderDelays(int *delayInts, float *delayFracs, int numSamples) {
+    float lfo[modulation::CHUNK_SIZE];
+    osc.renderPhases(lfo, numSamples);
+    for (int i = 0; i < numSamples; i++)
+      lfo[i] = std::sin(lfo[i]);
+
+    if (oscVolume.isSmoothing()) {
+      for (int i = 0; i < numSamples; i++)
+        lfo[i] *= oscVolume.getNextValue();
+    } else {
+      const float volume = oscVolume.getTargetValue();
+      for (int i = 0; i < numSamples; i++)
+        lfo[i] *= volume;
+    }
+
+    int minimumDelay = std::numeric_limits<int>::max();
+    for (int i = 0; i < numSamples; i++) {
+      const float delayMs =
+          std::max(1.0f, maximumDelayModulation * lfo[i] + centreDelay);
+      const float delay = std::min(
+          maximumDelay,
+          std::max(0.0f, (float)(delayMs * sampleRate / 1000.0)));
+      delayInts[i] = (int)delay;
+      delayFracs[i] = delay - (float)delayInts[i];
+      minimumDelay = std::min(minimumDelay, delayInts[i]);
+    }
+    return minimumDelay;
+  }
+
+  /**
+   * Process a run of samples on one channel, none of which read from the
+   * delay line at a position written during the same run. `position` is the
+   * position in the delay buffer at which the first sample will be written.
+   */
+  void processRun(int channel, float *input, float *wet, const int *delayInts,
+                  const float *delayFracs, const float *feedbackGains,
+                  int numSamples, int position) {
+    float *buffer = delayBuffers[channel].data();
+    const int mask = delayBufferMask;
+
+    // If the delay is zero, we read the sample being written:
+    if (delayInts[0] == 0) {
+      buffer[position & mask] = input[0] - lastOutput[channel];
+    }
+
+    for (int i = 0; i < numSamples; i++) {
+      const int index = (position + i - delayInts[i]) & mask;
+      const float newer = buffer[index];
+      const float older = buffer[(index - 1) & mask];
+      wet[i] = newer + delayFracs[i] * (older - newer);
+    }
+
+    buffer[position & mask] = input[0] - lastOutput[channel];
+    for (int i = 1; i < numSamples; i++) {
+      buffer[(position + i) & mask] =
+          input[i] - wet[i - 1] * feedbackGains[i - 1];
+    }
+    lastOutput[channel] = wet[numSamples - 1] * feedbackGains[numSamples - 1];
+  }
+
+  static constexpr float maxDepth = 1.0f, maxCentreDelayMs = 100.0f,
+                         oscVolumeMultiplier = 0.5f,
+                         maximumDelayModulation = 20.0f;
+
+  SampleType rate = 1.0, depth = 0.25, feedback = 0.0, mix = 0.5,
+             centreDelay = 7.0;
+
+  modulation::SineLFO osc;
+  modulation::SmoothedValue oscVolume, feedbackVolume;
+  modulation::DryWetMix dryWet;
+
+  std::vector<std::vector<float>> delayBuffers;
+  std::vector<float> lastOutput;
+  int delayBufferMask = 0, writePosition = 0;
+  float maximumDelay = 0;
+  double sampleRate = 44100.0;
+};
+
+/**
+ * A block-based replacement for juce::dsp::Phaser, with the same parameters
+ * and the same output.
+ *
+ * Like JUCE's Phaser, the LFO only updates the cutoff frequency of the
+ * all-pass filters every four samples. Rather than recomputing each of the
+ * six filters' coefficients once per channel at each update (each requiring a
+ * call to std::tan), the coefficient is computed once per update for all
+ * channels. The filters of each pair of channels are then run together in
+ * the same loop, so that their (serial) dependency chains overlap.
+ */
+template <typename SampleType> class BlockRatePhaser {
+  static_assert(std::is_same<SampleType, float>::value,
+                "BlockRatePhaser only supports 32-bit audio.");
+
+public:
+  BlockRatePhaser() {
+    setCentreFrequency(centreFrequency);
+    update();
+  }
+
+  void setRate(SampleType newRateHz) {
+    rate = newRateHz;
+    update();
+  }
+
+  void setDepth(SampleType newDepth) {
+    depth = newDepth;
+    update();
+  }
+
+  void setCentreFrequency(SampleType newCentreHz) {
+    // As in juce::dsp::Phaser, this mapping uses the sample rate in effect
+    // when the centre frequency is set:
+    centreFrequency = newCentreHz;
+    normCentreFrequency = juce::mapFromLog10(
+        centreFrequency, (SampleType)20.0,
+        (SampleType)std::min(20000.0, 0.49 * sampleRate));
+  }
+
+  void setFeedback(SampleType newFeedback) {
+    feedback = newFeedback;
+    update();
+  }
+
+  void setMix(SampleType newMix) {
+    mix = newMix;
+    update();
+  }
+
+  void prepare(const juce::dsp::ProcessSpec &spec) {
+    jassert(spec.sampleRate > 0);
+    jassert(spec.numChannels > 0);
+    sampleRate = spec.sampleRate;
+    filterStates.resize(spec.numChannels);
+    lastOutput.resize(spec.numChannels);
+    osc.prepare(sampleRate / (double)updateInterval);
+    update();
+    reset();
+  }
+
+  void reset() {
+    std::fill(lastOutput.begin(), lastOutput.end(), 0.0f);
+    for (auto &states : filterStates)
+      std::fill(std::begin(states), std::end(states), 0.0f);
+    osc.reset();
+    dryWet.reset(sampleRate);
+    oscVolume.reset(sampleRate / (double)updateInterval, 0.05);
+    feedbackVolume.reset(sampleRate, 0.05);
+    updateCounter = 0;
+  }
+
+  template <typename ProcessContext>
+  void process(const ProcessContext &context) noexcept {
+    auto &outputBlock = context.getOutputBlock();
+    if (context.usesSeparateInputAndOutputBlocks())
+      outputBlock.copyFrom(context.getInputBlock());
+    if (context.isBypassed)
+      return;
+
+    const int numChannels = (int)outputBlock.getNumChannels();
+    const int numSamples = (int)outputBlock.getNumSamples();
+    jassert(numChannels == (int)filterStates.size());
+
+    for (int start = 0; start < numSamples;
+         start += modulation::CHUNK_SIZE) {
+      const int n = std::min(modulation::CHUNK_SIZE, numSamples - start);
+
+      float coefficients[modulation::CHUNK_SIZE];
+      float feedbackGains[modulation::CHUNK_SIZE];
+      float dryGains[modulation::CHUNK_SIZE];
+      float wetGains[modulation::CHUNK_SIZE];
+      renderCoefficients(coefficients, n);
+      modulation::fillFromSmoothedValue(feedbackVolume, feedbackGains, n);
+      dryWet.renderGains(dryGains, wetGains, n);
+
+      for (int c = 0; c < numChannels; c += 2) {
+        const int numChannelsInPair = std::min(2, numChannels - c);
+        float *channels[2];
+        float wet[2][modulation::CHUNK_SIZE];
+        float *wetPointers[2] = {wet[0], wet[1]};
+        for (int i = 0; i < numChannelsInPair; i++)
+          channels[i] = outputBlock.getChannelPointer(c + i) + start;
+
+        if (numChannelsInPair == 2)
+          processChannels<2>(c, channels, wetPointers, coefficients,
+                             feedbackGains, n);
+        else
+          processChannels<1>(c, channels, wetPointers, coefficients,
+                             feedbackGains, n);
+
+        for (int i = 0; i < numChannelsInPair; i++)
+          modulation::DryWetMix::mix(channels[i], wet[i], dryGains, wetGains,
+                                     n);
+      }
+    }
+  }
+
+private:
+  void update() {
+    osc.setFrequency(rate);
+    oscVolume.setTargetValue(depth * (SampleType)0.5);
+    dryWet.setWetMixProportion(mix);
+    feedbackVolume.setTargetValue(feedback);
+  }
+
+  /**
+   * Compute the all-pass coefficient (shared by every stage and every
+   * channel) for each of the next `numSamples` samples.
+   */
+  void renderCoefficients(float *coefficients, int numSamples) {
+    const float maximumFrequency =
+        (float)std::min(20000.0, 0.49 * sampleRate);
+
+    for (int i = 0; i < numSamples; i++) {
+      if (updateCounter == 0) {
+        float phase;
+        osc.renderPhases(&phase, 1);
+        const float lfo = std::sin(phase) * oscVolume.getNextValue();
+        const float cutoff = juce::mapToLog10(
+            juce::jlimit(0.0f, 1.0f, lfo + normCentreFrequency), 20.0f,
+            maximumFrequency);
+        const float g = (float)std::tan(juce::MathConstants<double>::pi *
+                                        cutoff / sampleRate);
+        coefficient = g / (1 + g);
+      }
+
+      coefficients[i] = coefficient;
+      updateCounter = (updateCounter + 1) % updateInterval;
+    }
+  }
+
+  template <int N>
+  void processChannels(int firstChannel, float *const *channels,
+                       float *const *wet, const float *coefficients,
+                       const float *feedbackGains, int numSamples) {
+    float states[N][numStages], last[N];
+    for (int c = 0; c < N; c++) {
+      std::copy(std::begin(filterStates[firstChannel + c]),
+                std::end(filterStates[firstChannel + c]), states[c]);
+      last[c] = lastOutput[firstChannel + c];
+    }
+
+    for (int i = 0; i < numSamples; i++) {
+      const float G = coefficients[i];
+      for (int c = 0; c < N; c++) {
+        float output = channels[c][i] - last[c];
+        for (int stage = 0; stage < numStages; stage++) {
+          float &s = states[c][stage];
+          const float v = G * (output - s);
+          const float y = v + s;
+          s = y + v;
+          output = 2 * y - output;
+        }
+        wet[c][i] = output;
+        last[c] = output * feedbackGains[i];
+      }
+    }
+
+    for (int c = 0; c < N; c++) {
+      std::copy(states[c], states[c] + numStages,
+                std::begin(filterStates[firstChannel + c]));
+      lastOutput[firstChannel + c] = last[c];
+    }
+  }
+
+  static constexpr int numStages = 6, updateInterval = 4;
+
+  SampleType rate = 1.0, depth = 0.5, feedback = 0.0, mix = 0.5,
+             centreFrequency = 1300.0, normCentreFrequency = 0.5;
+
+  modulation::SineLFO osc;
+  modulation::SmoothedValue oscVolume, feedbackVolume;
+  modulation::DryWetMix dryWet;
+
+  std::vector<std::array<float, numStages>> filterStates;
+  std::vector<float> lastOutput;
+  float coefficient = 0;
+  int updateCounter = 0;
+  double sampleRate = 44100.0;
+};
+
+} // namespace Pedalboard
@@ -0,0 +1,206 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "../JuceHeader.h"
+#include "../Plugin.h"
+#include <memory>
+
+namespace Pedalboard {
+
+/**
+ * A template class that wraps a Pedalboard plugin, and runs it at a multiple
+ * of the sample rate (upsampling and downsampling with
+ * juce::dsp::Oversampling's cascade of polyphase half-band filters). This
+ * reduces aliasing from plugins that apply non-linear functions to audio,
+ * like distortion or clipping.
+ *
+ * The wrapped plugin must return every sample it's given from process().
+ * The latency of the half-band filters is reported by getLatencyHint(), and
+ * is compensated for by the number of samples returned from process().
+ */
+template <typename T, typename SampleType = float>
+class Oversampled : public Plugin {
+public:
+  static constexpr int MAXIMUM_FACTOR = 16;
+
+  virtual ~Oversampled(){};
+
+  /**
+   * Set the oversampling factor, which must be a power of two between 1 and
+   * MAXIMUM_FACTOR. Takes effect the next time this plugin is prepared.
+   */
+  void setFactor(int newFactor) {
+    if (newFactor < 1 || newFactor > MAXIMUM_FACTOR ||
+        (newFactor & (newFactor - 1)) != 0) {
+      throw std::domain_error(
+          "Oversampling factor must be a power of two between 1 and " +
+          std::to_string(MAXIMUM_FACTOR) + ", but was " +
+          std::to_string(newFactor) + ".");
+    }
+    factor = newFactor;
+    oversampling.reset();
+  }
+  int getFactor() const { return factor; }
+
+  /**
+   * If true, use linear-phase (equiripple FIR) half-band filters, which have
+   * more latency than the default (polyphase IIR) filters but don't change
+   * the phase of the signal.
+   */
+  void setLinearPhase(bool newLinearPhase) {
+    linearPhase = newLinearPhase;
+    oversampling.reset();
+  }
+  bool getLinearPhase() const { return linearPhase; }
+
+  virtual void prepare(const juce::dsp::ProcessSpec &spec) override {
+    if (!oversampling || lastSpec.sampleRate != spec.sampleRate ||
+        lastSpec.maximumBlockSize < spec.maximumBlockSize ||
+        spec.numChannels != lastSpec.numChannels) {
+      size_t factorLog2 = 0;
+      while ((1 << factorLog2) < factor)
+        factorLog2++;
+
+      oversampling = std::make_unique<juce::dsp::Oversampling<SampleType>>(
+          spec.numChannels, factorLog2,
+          linearPhase ? juce::dsp::Oversampling<
+                            SampleType>::filterHalfBandFIREquiripple
+                      : juce::dsp::Oversampling<
+                            SampleType>::filterHalfBandPolyphaseIIR,
+          /* isMaxQuality= */ true, /* useIntegerLatency= */ true);
+      oversampling->initProcessing(spec.maximumBlockSize);
+      samplesOutput = 0;
+      lastSpec = spec;
+    }
+
+    juce::dsp::ProcessSpec oversampledSpec = spec;
+    oversampledSpec.sampleRate = spec.sampleRate * factor;
+    oversampledSpec.maximumBlockSize = spec.maximumBlockSize * factor;
+    plugin.prepare(oversampledSpec);
+  }
+
+  virtual int
+  process(const juce::dsp::ProcessContextReplacing<SampleType> &context)
+      override {
+    auto ioBlock = context.getOutputBlock();
+
+    auto oversampledBlock = oversampling->processSamplesUp(ioBlock);
+    juce::dsp::ProcessContextReplacing<SampleType> oversampledContext(
+        oversampledBlock);
+    plugin.process(oversampledContext);
+    oversampling->processSamplesDown(ioBlock);
+
+    // The first getLatencyHint() samples of output are filter delay:
+    samplesOutput += ioBlock.getNumSamples();
+    return (int)std::max(
+        0LL, std::min((long long)ioBlock.getNumSamples(),
+                      samplesOutput - (long long)getLatencyHint()));
+  }
+
+  virtual void reset() override {
+    if (oversampling)
+      oversampling->reset();
+    plugin.reset();
+    samplesOutput = 0;
+  }
+
+  virtual int getLatencyHint() override {
+    if (!oversampling)
+      return 0;
+    return (int)std::round(oversampling->getLatencyInSamples());
+  }
+
+  T &getNestedPlugin() { return plugin; }
+
+private:
+  T plugin;
+  int factor = 2;
+  bool linearPhase = false;
+  std::unique_ptr<juce::dsp::Oversampling<SampleType>> oversampling;
+  long long samplesOutput = 0;
+};
+
+/**
+ * A test plugin used to verify the behaviour of the Oversampled wrapper,
+ * which hard clips audio at ±0.5 (to produce aliasing at the original sample
+ * rate) and checks the sample rate it's prepared with.
+ */
+class ExpectsOversampledSampleRate : public Plugin {
+public:
+  virtual ~ExpectsOversampledSampleRate(){};
+
+  virtual void prepare(const juce::dsp::ProcessSpec &spec) override {
+    if (expectedSampleRate != 0 && spec.sampleRate != expectedSampleRate) {
+      throw std::runtime_error("Expected a sample rate of exactly " +
+                               std::to_string(expectedSampleRate) + "Hz!");
+    }
+  }
+
+  virtual int
+  process(const juce::dsp::ProcessContextReplacing<float> &context) override {
+    auto ioBlock = context.getOutputBlock();
+    for (size_t c = 0; c < ioBlock.getNumChannels(); c++) {
+      float *channel = ioBlock.getChannelPointer(c);
+      juce::FloatVectorOperations::clip(channel, channel, -0.5f, 0.5f,
+                                        (int)ioBlock.getNumSamples());
+    }
+    return (int)ioBlock.getNumSamples();
+  }
+
+  virtual void reset() override {}
+
+  void setExpectedSampleRate(double newExpectedSampleRate) {
+    expectedSampleRate = newExpectedSampleRate;
+  }
+
+private:
+  double expectedSampleRate = 0;
+};
+
+class OversampledTestPlugin : public Oversampled<ExpectsOversampledSampleRate> {
+public:
+  virtual void prepare(const juce::dsp::ProcessSpec &spec) override {
+    getNestedPlugin().setExpectedSampleRate(spec.sampleRate * getFactor());
+    Oversampled<ExpectsOversampledSampleRate>::prepare(spec);
+  }
+};
+
+inline void init_oversampled_test_plugin(py::module &m) {
+  py::class_<OversampledTestPlugin, Plugin,
+             std::shared_ptr<OversampledTestPlugin>>(m,
+                                                     "OversampledTestPlugin")
+      .def(py::init([](int factor, bool linearPhase) {
+             auto plugin = std::make_unique<OversampledTestPlugin>();
+             plugin->setFactor(factor);
+             plugin->setLinearPhase(linearPhase);
+             return plugin;
+           }),
+           py::arg("factor") = 2, py::arg("linear_phase") = false)
+      .def("__repr__", [](const OversampledTestPlugin &plugin) {
+        std::ostringstream ss;
+        ss << "<pedalboard.OversampledTestPlugin";
+        ss << " factor=" << plugin.getFactor();
+        ss << " linear_phase=" << (plugin.getLinearPhase() ? "True" : "False");
+        ss << " at " << &plugin;
+        ss << ">";
+        return ss.str();
+      });
+}
+
+} // namespace Pedalboard
@@ -0,0 +1,256 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../simd/Dispatch.h"
+
+namespace Pedalboard {
+
+/**
+ * A precomputed bank of Kaiser-windowed sinc filters, one for each of a
+ * number of evenly-spaced fractional delays ("phases") between two input
+ * samples. Banks are immutable once built, and are shared between all
+ * interpolators that use the same resampling ratio.
+ */
+class PolyphaseFilterBank {
+public:
+  // The number of zero crossings of the sinc on either side of its center:
+  static constexpr double ZERO_CROSSINGS = 32;
+  // The fraction of the lower of the two Nyquist frequencies to pass:
+  static constexpr double CUTOFF = 0.95;
+  static constexpr double KAISER_BETA = 8.0;
+
+  // Limits to keep extreme resampling ratios from using too much memory:
+  static constexpr double MAX_HALF_WIDTH = 1024;
+  static constexpr int MAX_EXACT_PHASES = 1024;
+  static constexpr int INTERPOLATED_PHASES = 512;
+  static constexpr size_t MAX_COEFFICIENTS = 1 << 21;
+
+  PolyphaseFilterBank(double speedRatio) {
+    // Lower the cutoff frequency when downsampling to prevent aliasing, and
+    // widen the filter to match:
+    double cutoff = CUTOFF / std::max(1.0, speedRatio);
+    halfWidth = std::min(ZERO_CROSSINGS / cutoff, MAX_HALF_WIDTH);
+
+    // Choose a latency that's a whole number of output samples, so that
+    // callers compensating for latency don't shift the signal by a fraction
+    // of a sample:
+    latency = std::ceil(halfWidth / speedRatio - 1e-9) * speedRatio;
+
+    numTaps = (int)std::ceil(latency + halfWidth) + 1;
+    numTaps = (numTaps + 7) & ~7;
+
+    // If the ratio is rational with a small enough denominator, every output
+    // sample falls exactly on one of a small number of phases:
+    numPhases = 0;
+    for (int denominator = 1; denominator <= MAX_EXACT_PHASES; denominator++) {
+      double numerator = speedRatio * denominator;
+      if (std::abs(numerator - std::round(numerator)) <
+          1e-9 * std::max(1.0, numerator)) {
+        numPhases = denominator;
+        break;
+      }
+    }
+
+    exactPhases = numPhases > 0 &&
+                  (size_t)(numPhases + 1) * numTaps <= MAX_COEFFICIENTS;
+    if (!exactPhases) {
+      numPhases = std::max(
+          16, std::min(INTERPOLATED_PHASES,
+                       (int)(MAX_COEFFICIENTS / numTaps) - 1));
+    }
+
+    // One extra phase allows interpolating up to (but not including) a
+    // fractional delay of 1.0:
+    coefficients.resize((size_t)(numPhases + 1) * numTaps);
+    double kaiserNormalization = besselI0(KAISER_BETA);
+    for (int phase = 0; phase <= numPhases; phase++) {
+      float *row = coefficients.data() + (size_t)phase * numTaps;
+
+      double sum = 0;
+      for (int tap = 0; tap < numTaps; tap++) {
+        // Taps run from the oldest input sample to the newest one:
+        double t =
+            (numTaps - 1 - tap) - latency + (double)phase / (double)numPhases;
+        double x = t / halfWidth;
+        double value = 0;
+        if (std::abs(x) < 1.0) {
+          double window =
+              besselI0(KAISER_BETA * std::sqrt(1.0 - x * x)) /
+              kaiserNormalization;
+          value = window * cutoff * sinc(cutoff * t);
+        }
+        row[tap] = (float)value;
+        sum += value;
+      }
+
+      // Normalize each phase to unity gain at DC:
+      if (sum != 0) {
+        for (int tap = 0; tap < numTaps; tap++) {
+          row[tap] = (float)(row[tap] / sum);
+        }
+      }
+    }
+  }
+
+  /**
+   * Return a (possibly cached) filter bank for the given resampling ratio.
+   */
+  static std::shared_ptr<const PolyphaseFilterBank> get(double speedRatio) {
+    static std::mutex cacheMutex;
+    static std::map<double, std::weak_ptr<const PolyphaseFilterBank>> cache;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::weak_ptr<const PolyphaseFilterBank> &entry = cache[speedRatio];
+    std::shared_ptr<const PolyphaseFilterBank> bank = entry.lock();
+    if (!bank) {
+      bank = std::make_shared<const PolyphaseFilterBank>(speedRatio);
+      entry = bank;
+    }
+    return bank;
+  }
+
+  int getNumTaps() const { return numTaps; }
+  double getLatency() const { return latency; }
+
+  /**
+   * Return the filtered value at the given fractional position (in [0, 1))
+   * past the newest of the provided numTaps input samples, which must be in
+   * order from oldest to newest.
+   */
+  float valueAt(const float *inputs, double position) const {
+    double scaledPosition = position * numPhases;
+
+    if (exactPhases) {
+      int phase = (int)std::round(scaledPosition);
+      return dotProduct(getPhase(phase), inputs, numTaps);
+    }
+
+    int phase = (int)scaledPosition;
+    float fraction = (float)(scaledPosition - phase);
+    float a = dotProduct(getPhase(phase), inputs, numTaps);
+    float b = dotProduct(getPhase(phase + 1), inputs, numTaps);
+    return a + fraction * (b - a);
+  }
+
+private:
+  const float *getPhase(int phase) const {
+    return coefficients.data() + (size_t)phase * numTaps;
+  }
+
+  // numTaps is always a multiple of 8, as required by the dispatched kernel.
+  // The summation order is fixed for each instruction set, so results are
+  // deterministic regardless of how the input is chunked:
+  static float dotProduct(const float *a, const float *b, int numSamples) {
+    return simd::getKernels().dotProduct(a, b, numSamples);
+  }
+
+  static double sinc(double x) {
+    if (x == 0)
+      return 1.0;
+    const double pi = 3.14159265358979323846;
+    return std::sin(pi * x) / (pi * x);
+  }
+
+  // The zeroth-order modified Bessel function of the first kind:
+  static double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 100; k++) {
+      term *= (x / (2.0 * k)) * (x / (2.0 * k));
+      sum += term;
+      if (term < sum * 1e-12)
+        break;
+    }
+    return sum;
+  }
+
+  double halfWidth = 0;
+  double latency = 0;
+  int numTaps = 0;
+  int numPhases = 0;
+  bool exactPhases = false;
+  std::vector<float> coefficients;
+};
+
+/**
+ * A windowed-sinc interpolator with the same interface and sub-sample
+ * position semantics as juce::GenericInterpolator, but which evaluates its
+ * filter with a precomputed polyphase filter bank (instead of computing the
+ * interpolation kernel for every output sample) and vectorized dot products.
+ *
+ * Unlike juce::Interpolators::WindowedSinc, the filter's cutoff is lowered
+ * when downsampling, so the speed ratio must be provided up front.
+ */
+class PolyphaseInterpolator {
+public:
+  PolyphaseInterpolator(double speedRatio = 1.0)
+      : bank(PolyphaseFilterBank::get(speedRatio)),
+        history(2 * bank->getNumTaps()) {
+    reset();
+  }
+
+  float getBaseLatency() const noexcept { return (float)bank->getLatency(); }
+
+  void reset() noexcept {
+    subSamplePos = 1.0;
+    writeIndex = 0;
+    std::fill(history.begin(), history.end(), 0.0f);
+  }
+
+  int process(double speedRatio, const float *inputSamples,
+              float *outputSamples, int numOutputSamplesToProduce) noexcept {
+    int numTaps = bank->getNumTaps();
+    double pos = subSamplePos;
+    int numUsed = 0;
+
+    while (numOutputSamplesToProduce > 0) {
+      while (pos >= 1.0) {
+        // Each sample is stored twice, so that the most recent numTaps
+        // samples are always contiguous in memory:
+        writeIndex = writeIndex + 1 == numTaps ? 0 : writeIndex + 1;
+        history[writeIndex] = inputSamples[numUsed];
+        history[writeIndex + numTaps] = inputSamples[numUsed];
+        numUsed++;
+        pos -= 1.0;
+      }
+
+      *outputSamples++ =
+          bank->valueAt(history.data() + writeIndex + 1, pos);
+      pos += speedRatio;
+      --numOutputSamplesToProduce;
+    }
+
+    subSamplePos = pos;
+    return numUsed;
+  }
+
+private:
+  std::shared_ptr<const PolyphaseFilterBank> bank;
+  std::vector<float> history;
+  int writeIndex = 0;
+  double subSamplePos = 1.0;
+};
+
+} // namespace Pedalboard
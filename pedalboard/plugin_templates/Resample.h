@@ -19,15 +19,16 @@
 #include "../JuceHeader.h"
 #include "../Plugin.h"
 #include "../plugins/AddLatency.h"
+#include "PolyphaseInterpolator.h"
 
 namespace Pedalboard {
 
 #include <variant>
 
 /**
- * The various levels of resampler quality available from JUCE.
- * More could be added here, but these should cover the vast
- * majority of use cases.
+ * The various levels of resampler quality available from JUCE, plus our own
+ * polyphase implementation. More could be added here, but these should cover
+ * the vast majority of use cases.
  */
 enum class ResamplingQuality {
   ZeroOrderHold = 0,
@@ -35,6 +36,7 @@ enum class ResamplingQuality {
   CatmullRom = 2,
   Lagrange = 3,
   WindowedSinc = 4,
+  Polyphase = 5,
 };
 
 /**
@@ -43,7 +45,13 @@ enum class ResamplingQuality {
  */
 class VariableQualityResampler {
 public:
-  void setQuality(const ResamplingQuality newQuality) {
+  /**
+   * Set the quality of this resampler. The speed ratio (the number of input
+   * samples per output sample) is only used by the Polyphase quality, which
+   * precomputes its filters for a specific ratio.
+   */
+  void setQuality(const ResamplingQuality newQuality,
+                  const double speedRatio = 1.0) {
     switch (newQuality) {
     case ResamplingQuality::ZeroOrderHold:
       interpolator = juce::Interpolators::ZeroOrderHold();
@@ -60,6 +68,9 @@ public:
     case ResamplingQuality::WindowedSinc:
       interpolator = juce::Interpolators::WindowedSinc();
       break;
+    case ResamplingQuality::Polyphase:
+      interpolator = PolyphaseInterpolator(speedRatio);
+      break;
     default:
       throw std::domain_error("Unknown resampler quality received!");
     }
@@ -87,6 +98,8 @@ public:
     } else if (auto *i = std::get_if<juce::Interpolators::WindowedSinc>(
                    &interpolator)) {
       return i->getBaseLatency();
+    } else if (auto *i = std::get_if<PolyphaseInterpolator>(&interpolator)) {
+      return i->getBaseLatency();
     } else {
       throw std::runtime_error("Unknown resampler quality!");
     }
@@ -110,6 +123,8 @@ public:
     } else if (auto *i = std::get_if<juce::Interpolators::WindowedSinc>(
                    &interpolator)) {
       i->reset();
+    } else if (auto *i = std::get_if<PolyphaseInterpolator>(&interpolator)) {
+      i->reset();
     } else {
       throw std::runtime_error("Unknown resampler quality!");
     }
@@ -139,6 +154,9 @@ public:
                    &interpolator)) {
       return i->process(speedRatio, inputSamples, outputSamples,
                         numOutputSamplesToProduce);
+    } else if (auto *i = std::get_if<PolyphaseInterpolator>(&interpolator)) {
+      return i->process(speedRatio, inputSamples, outputSamples,
+                        numOutputSamplesToProduce);
     } else {
       throw std::runtime_error("Unknown resampler quality!");
     }
@@ -147,7 +165,7 @@ public:
 private:
   std::variant<juce::Interpolators::ZeroOrderHold, juce::Interpolators::Linear,
                juce::Interpolators::CatmullRom, juce::Interpolators::Lagrange,
-               juce::Interpolators::WindowedSinc>
+               juce::Interpolators::WindowedSinc, PolyphaseInterpolator>
       interpolator;
 };
 
@@ -187,18 +205,18 @@ public:
     if (specChanged || nativeToTargetResamplers.empty()) {
       reset();
 
+      resamplerRatio = spec.sampleRate / targetSampleRate;
+      inverseResamplerRatio = targetSampleRate / spec.sampleRate;
+
       nativeToTargetResamplers.resize(spec.numChannels);
       targetToNativeResamplers.resize(spec.numChannels);
 
       for (int i = 0; i < spec.numChannels; i++) {
-        nativeToTargetResamplers[i].setQuality(quality);
+        nativeToTargetResamplers[i].setQuality(quality, resamplerRatio);
         nativeToTargetResamplers[i].reset();
-        targetToNativeResamplers[i].setQuality(quality);
+        targetToNativeResamplers[i].setQuality(quality, inverseResamplerRatio);
         targetToNativeResamplers[i].reset();
       }
-
-      resamplerRatio = spec.sampleRate / targetSampleRate;
-      inverseResamplerRatio = targetSampleRate / spec.sampleRate;
       maximumBlockSizeInTargetSampleRate =
           std::ceil(spec.maximumBlockSize / resamplerRatio);
 
@@ -211,10 +229,11 @@ public:
 
       inStreamLatency = 0;
 
-      // Add the resamplers' latencies so the output is properly aligned:
+      // Add the resamplers' latencies so the output is properly aligned. Each
+      // resampler's latency is measured in samples at its input sample rate:
       inStreamLatency += std::round(
-          nativeToTargetResamplers[0].getBaseLatency() * resamplerRatio +
-          targetToNativeResamplers[0].getBaseLatency());
+          nativeToTargetResamplers[0].getBaseLatency() +
+          targetToNativeResamplers[0].getBaseLatency() * resamplerRatio);
 
       resampledBuffer.setSize(spec.numChannels,
                               ((maximumBlockSizeInTargetSampleRate + 1) * 3) +
@@ -427,6 +446,10 @@ public:
 
   T &getNestedPlugin() { return plugin; }
 
+  // The nested plugin can't be copied generically, so specialize this for
+  // any nested plugin type that can be; see Plugin::clone.
+  virtual std::shared_ptr<Plugin> clone() override { return Plugin::clone(); }
+
   virtual void reset() override final {
     plugin.reset();
 
@@ -448,7 +471,10 @@ public:
   }
 
   virtual int getLatencyHint() override {
-    return inStreamLatency + (plugin.getLatencyHint() * resamplerRatio);
+    // Round the nested plugin's latency up, as a hint that's too small
+    // causes the output buffer to be reallocated during processing:
+    return inStreamLatency +
+           (int)std::ceil(plugin.getLatencyHint() * resamplerRatio);
   }
 
 private:
@@ -486,6 +512,14 @@ private:
   }
 };
 
+template <>
+inline std::shared_ptr<Plugin> Resample<Passthrough<float>, float>::clone() {
+  auto plugin = std::make_shared<Resample<Passthrough<float>, float>>();
+  plugin->setTargetSampleRate(getTargetSampleRate());
+  plugin->setQuality(getQuality());
+  return plugin;
+}
+
 inline void init_resample(py::module &m) {
   py::class_<Resample<Passthrough<float>, float>, Plugin,
              std::shared_ptr<Resample<Passthrough<float>, float>>>
@@ -512,6 +546,14 @@ inline void init_resample(py::module &m) {
       .value("WindowedSinc", ResamplingQuality::WindowedSinc,
              "The highest quality and slowest resampling method, with no "
              "audible artifacts.")
+      .value("Polyphase", ResamplingQuality::Polyphase,
+             "A high-quality windowed-sinc resampling method that uses a "
+             "precomputed bank of filters (exact for common ratios like "
+             "44.1kHz to 48kHz or 48kHz to 16kHz) and vectorized arithmetic, "
+             "making it much faster than WindowedSinc. Unlike WindowedSinc, "
+             "this method filters out frequencies above the target Nyquist "
+             "frequency when downsampling to avoid aliasing.\n\n*Introduced "
+             "in v0.9.0.*")
       .export_values();
 
   resample
@@ -546,6 +588,9 @@ inline void init_resample(py::module &m) {
              case ResamplingQuality::WindowedSinc:
                ss << "WindowedSinc";
                break;
+             case ResamplingQuality::Polyphase:
+               ss << "Polyphase";
+               break;
              default:
                ss << "unknown";
                break;
@@ -613,6 +658,9 @@ inline void init_resample_with_latency(py::module &m) {
              case ResamplingQuality::WindowedSinc:
                ss << "WindowedSinc";
                break;
+             case ResamplingQuality::Polyphase:
+               ss << "Polyphase";
+               break;
              default:
                ss << "unknown";
                break;
@@ -0,0 +1,171 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <optional>
+#include <variant>
+
+#include "../Automation.h"
+#include "../JuceHeader.h"
+#include "../PluginContainer.h"
+
+namespace Pedalboard {
+
+/**
+ * Call the process() method of the provided plugin's static type directly
+ * (allowing it to be inlined) if that type has an accessible overload for
+ * this context, or fall back to a virtual call otherwise.
+ */
+template <typename T, typename ContextType>
+auto processStatically(T &plugin, const ContextType &context, int)
+    -> decltype(plugin.T::process(context)) {
+  return plugin.T::process(context);
+}
+
+template <typename T, typename ContextType>
+int processStatically(T &plugin, const ContextType &context, long) {
+  return static_cast<Plugin &>(plugin).process(context);
+}
+
+/**
+ * A chain of plugins, each of which must be one of the provided types, that
+ * processes each block by calling every plugin's process() method directly
+ * rather than through Pedalboard's general-purpose process() loop (and
+ * without a virtual call, where possible). Each plugin must be tileable (see
+ * Plugin::isTileable), as every plugin is expected to return every sample.
+ *
+ * The types of the chain's plugins are looked up whenever it's prepared,
+ * rather than on each block, so this is much cheaper than a Chain when
+ * processing audio in small blocks.
+ */
+template <typename... PluginTypes> class StaticChain : public PluginContainer {
+public:
+  using Element = std::variant<PluginTypes *...>;
+
+  StaticChain(std::vector<std::shared_ptr<Plugin>> plugins)
+      : PluginContainer(plugins) {
+    for (auto &plugin : plugins) {
+      getElement(plugin.get());
+    }
+  }
+  virtual ~StaticChain(){};
+
+  /**
+   * Return the provided plugin as one of this chain's plugin types, or throw
+   * an exception if it isn't one of them.
+   */
+  static Element getElement(Plugin *plugin) {
+    std::optional<Element> element;
+    // Take the first matching type, as later types may be base classes:
+    if (plugin && (tryGetElement<PluginTypes>(plugin, element) || ...)) {
+      return *element;
+    }
+
+    throw std::invalid_argument(
+        "Only built-in plugins that process each sample independently (like "
+        "Gain, Compressor, or IIR filters) can be frozen, but " +
+        (plugin ? std::string("a plugin of an unsupported type")
+                : std::string("an empty slot")) +
+        " was provided.");
+  }
+
+  virtual void prepare(const juce::dsp::ProcessSpec &spec) override {
+    // The list of plugins may have been changed since the last call:
+    std::vector<Element> newElements;
+    newElements.reserve(plugins.size());
+    for (auto &plugin : plugins) {
+      newElements.push_back(getElement(plugin.get()));
+    }
+    elements = std::move(newElements);
+
+    for (auto &plugin : plugins) {
+      plugin->prepare(spec);
+    }
+    lastSpec = spec;
+  }
+
+  virtual int
+  process(const juce::dsp::ProcessContextReplacing<float> &context) override {
+    return processSamples(context);
+  }
+
+  virtual int
+  process(const juce::dsp::ProcessContextReplacing<double> &context) override {
+    return processSamples(context);
+  }
+
+  virtual void reset() override {
+    for (auto &plugin : plugins) {
+      if (plugin)
+        plugin->reset();
+    }
+  }
+
+  virtual bool isTileable() override { return true; }
+
+  virtual int getTailLengthSamples() override {
+    int tail = 0;
+    for (auto &plugin : plugins) {
+      int pluginTail = plugin->getTailLengthSamples();
+      if (pluginTail < 0)
+        return -1;
+      tail += pluginTail;
+    }
+    return tail;
+  }
+
+  virtual std::shared_ptr<Plugin> clone() override {
+    if (auto clonedPlugins = clonePlugins()) {
+      return std::make_shared<StaticChain<PluginTypes...>>(*clonedPlugins);
+    }
+    return nullptr;
+  }
+
+private:
+  template <typename T>
+  static bool tryGetElement(Plugin *plugin, std::optional<Element> &element) {
+    if (auto *typedPlugin = dynamic_cast<T *>(plugin)) {
+      element = typedPlugin;
+      return true;
+    }
+    return false;
+  }
+
+  template <typename SampleType>
+  int processSamples(
+      const juce::dsp::ProcessContextReplacing<SampleType> &context) {
+    for (auto &element : elements) {
+      std::visit(
+          [&](auto *plugin) {
+            // Automated plugins need their parameters updated within the
+            // block, so take the slower path for those:
+            if (isAutomated(*plugin)) {
+              processWithAutomation(*plugin, context, lastSpec.sampleRate);
+            } else if (!skipIfSilent(*plugin, context)) {
+              processStatically(*plugin, context, 0);
+            }
+          },
+          element);
+    }
+    return context.getOutputBlock().getNumSamples();
+  }
+
+  std::vector<Element> elements;
+};
+
+} // namespace Pedalboard
@@ -15,7 +15,9 @@
  * limitations under the License.
  */
 
+#include "../Automation.h"
 #include "../JucePlugin.h"
+#include "../simd/Dispatch.h"
 #include <cmath>
 
 namespace Pedalboard {
@@ -42,43 +44,67 @@ public:
     inverseScaleFactor = 1.0 / scaleFactor;
   }
   virtual void reset() override {}
+  bool isTileable() override { return true; }
+  int getTailLengthSamples() override { return 0; }
 
-  virtual int process(
-      const juce::dsp::ProcessContextReplacing<SampleType> &context) override {
-    auto block = context.getOutputBlock();
+  std::shared_ptr<Plugin> clone() override {
+    auto plugin = std::make_shared<Bitcrush<SampleType>>();
+    plugin->setBitDepth(getBitDepth());
+    return plugin;
+  }
 
-    block.multiplyBy(scaleFactor);
+  virtual int process(
+      const juce::dsp::ProcessContextReplacing<float> &context) override {
+    return processSamples(context);
+  }
 
-    for (int c = 0; c < block.getNumChannels(); c++) {
-      SampleType *channelPointer = block.getChannelPointer(c);
+  virtual int process(
+      const juce::dsp::ProcessContextReplacing<double> &context) override {
+    return processSamples(context);
+  }
 
-      // To allow for some SIMD optimization:
-      int numIterations = block.getNumSamples() / INNER_LOOP_DIMENSION;
+private:
+  template <typename T>
+  int processSamples(const juce::dsp::ProcessContextReplacing<T> &context) {
+    auto block = context.getOutputBlock();
+    const T scale = static_cast<T>(scaleFactor);
+    const T inverseScale = static_cast<T>(inverseScaleFactor);
+    const int numSamples = (int)block.getNumSamples();
 
-      for (int i = 0; i < numIterations; i++) {
-        for (int j = 0; j < INNER_LOOP_DIMENSION; j++) {
-          channelPointer[(i * INNER_LOOP_DIMENSION) + j] =
-              nearbyintf(channelPointer[(i * INNER_LOOP_DIMENSION) + j]);
-        }
-      }
+    // Scaling, rounding and scaling back in a single pass keeps each sample
+    // in a register, rather than reading and writing the buffer three times:
+    for (int c = 0; c < block.getNumChannels(); c++) {
+      T *channelPointer = block.getChannelPointer(c);
 
-      for (int i = numIterations * INNER_LOOP_DIMENSION;
-           i < block.getNumSamples(); i++) {
-        channelPointer[i] = nearbyintf(channelPointer[i]);
+      for (int i = vectorizedBitcrush(channelPointer, numSamples, scale,
+                                      inverseScale);
+           i < numSamples; i++) {
+        channelPointer[i] = std::nearbyint(channelPointer[i] * scale) *
+                            inverseScale;
       }
     }
 
-    block.multiplyBy(inverseScaleFactor);
     return block.getNumSamples();
   }
 
-private:
+  // The runtime-dispatched kernels process as many samples as they can, and
+  // leave the remainder to the scalar loop above:
+  static int vectorizedBitcrush(float *samples, int numSamples, float scale,
+                                float inverseScale) {
+    return simd::getKernels().bitcrushFloat(samples, numSamples, scale,
+                                            inverseScale);
+  }
+
+  static int vectorizedBitcrush(double *samples, int numSamples, double scale,
+                                double inverseScale) {
+    return simd::getKernels().bitcrushDouble(samples, numSamples, scale,
+                                             inverseScale);
+  }
+
   SampleType bitDepth = 8.0f;
 
   SampleType scaleFactor = 1.0f;
   SampleType inverseScaleFactor = 1.0f;
-
-  static constexpr int INNER_LOOP_DIMENSION = 16;
 };
 
 inline void init_bitcrush(py::module &m) {
@@ -115,5 +141,9 @@ inline void init_bitcrush(py::module &m) {
                                       "floating-point value. Each audio "
                                       "sample will be quantized onto ``2 ** "
                                       "bit_depth`` values.");
+
+  registerAutomatableParameter<Bitcrush<float>>(
+      "bit_depth", &Bitcrush<float>::getBitDepth,
+      &Bitcrush<float>::setBitDepth);
 }
 }; // namespace Pedalboard
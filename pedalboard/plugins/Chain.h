@@ -22,6 +22,7 @@
 
 #include "../PluginContainer.h"
 #include "../process.h"
+#include "FrozenChain.h"
 
 namespace Pedalboard {
 /**
@@ -29,12 +30,13 @@ namespace Pedalboard {
  */
 class Chain : public PluginContainer {
 public:
-  Chain(std::vector<std::shared_ptr<Plugin>> plugins)
-      : PluginContainer(plugins) {}
+  Chain(std::vector<std::shared_ptr<Plugin>> plugins, bool fused = false,
+        bool pipelined = false)
+      : PluginContainer(plugins), fused(fused), pipelined(pipelined) {}
   virtual ~Chain(){};
 
   virtual void prepare(const juce::dsp::ProcessSpec &spec) {
-    for (auto plugin : plugins) {
+    for (auto &plugin : plugins) {
       if (plugin) {
         plugin->prepare(spec);
       }
@@ -44,22 +46,16 @@ public:
 
   virtual int
   process(const juce::dsp::ProcessContextReplacing<float> &context) {
-    // assuming process context replacing
-    auto ioBlock = context.getOutputBlock();
-
-    float **channels =
-        (float **)alloca(ioBlock.getNumChannels() * sizeof(float *));
-    for (int i = 0; i < ioBlock.getNumChannels(); i++) {
-      channels[i] = ioBlock.getChannelPointer(i);
-    }
+    return processSamples(context);
+  }
 
-    juce::AudioBuffer<float> ioBuffer(channels, ioBlock.getNumChannels(),
-                                      ioBlock.getNumSamples());
-    return ::Pedalboard::process(ioBuffer, lastSpec, plugins, false);
+  virtual int
+  process(const juce::dsp::ProcessContextReplacing<double> &context) {
+    return processSamples(context);
   }
 
   virtual void reset() {
-    for (auto plugin : plugins) {
+    for (auto &plugin : plugins) {
       if (plugin) {
         plugin->reset();
       }
@@ -68,44 +64,166 @@ public:
 
   virtual int getLatencyHint() {
     int hint = 0;
-    for (auto plugin : plugins) {
+    for (auto &plugin : plugins) {
       if (plugin) {
         hint += plugin->getLatencyHint();
       }
     }
     return hint;
   }
+
+  virtual int getTailLengthSamples() {
+    int tail = 0;
+    for (auto &plugin : plugins) {
+      if (plugin) {
+        int pluginTail = plugin->getTailLengthSamples();
+        if (pluginTail < 0)
+          return -1;
+        tail += pluginTail;
+      }
+    }
+    return tail;
+  }
+
+  virtual std::shared_ptr<Plugin> clone() {
+    if (auto clonedPlugins = clonePlugins()) {
+      return std::make_shared<Chain>(*clonedPlugins, fused, pipelined);
+    }
+    return nullptr;
+  }
+
+  bool getFused() const { return fused; }
+  void setFused(bool value) { fused = value; }
+
+  bool getPipelined() const { return pipelined; }
+  void setPipelined(bool value) { pipelined = value; }
+
+  virtual std::vector<std::shared_ptr<Plugin>> getPipelineStages() {
+    if (!pipelined)
+      return {};
+
+    // Only called while processing, when this chain's plugins can't change:
+    std::vector<std::shared_ptr<Plugin>> stages;
+    for (auto &plugin : plugins) {
+      if (plugin)
+        stages.push_back(plugin);
+    }
+    return stages;
+  }
+
+private:
+  template <typename SampleType>
+  int processSamples(
+      const juce::dsp::ProcessContextReplacing<SampleType> &context) {
+    // assuming process context replacing
+    auto ioBlock = context.getOutputBlock();
+
+    SampleType **channels =
+        (SampleType **)alloca(ioBlock.getNumChannels() * sizeof(SampleType *));
+    for (int i = 0; i < ioBlock.getNumChannels(); i++) {
+      channels[i] = ioBlock.getChannelPointer(i);
+    }
+
+    juce::AudioBuffer<SampleType> ioBuffer(channels, ioBlock.getNumChannels(),
+                                           ioBlock.getNumSamples());
+    return ::Pedalboard::process(ioBuffer, lastSpec, plugins, false, fused);
+  }
+
+  bool fused = false;
+  bool pipelined = false;
 };
 
 inline void init_chain(py::module &m) {
   py::class_<Chain, PluginContainer, std::shared_ptr<Chain>>(
       m, "Chain",
       "Run zero or more plugins as a plugin. Useful when "
-      "used with the Mix plugin.")
-      .def(py::init([](std::vector<std::shared_ptr<Plugin>> plugins) {
-             return new Chain(plugins);
+      "used with the Mix plugin.\n\n"
+      "If ``fused`` is ``True``, each run of two or more consecutive "
+      "sample-wise plugins (:class:`Gain`, :class:`Invert`, "
+      ":class:`Clipping`, :class:`Bitcrush`, :class:`Compressor`, "
+      ":class:`Limiter`, and IIR filters like :class:`HighpassFilter`) is "
+      "run over small tiles of audio one plugin after the other, rather than "
+      "each plugin processing the whole buffer in turn. This keeps audio in "
+      "the CPU's cache between plugins, which can speed up long chains of "
+      "cheap plugins. The output is equivalent, although IIR filters may "
+      "differ by a tiny amount (below -140dB), as their state is rounded "
+      "differently at block boundaries.\n\n"
+      "If ``pipelined`` is ``True``, each plugin in this Chain (or each run "
+      "of consecutive sample-wise plugins) runs on its own thread when "
+      "rendering an entire buffer at once (i.e.: when calling "
+      ":py:meth:`process` with ``reset=True``), working on one block of "
+      "audio while the next plugin works on the previous block. This can "
+      "speed up long renders through chains of several expensive plugins "
+      "(like :class:`Convolution`, :class:`PitchShift`, or VST3 plugins) by "
+      "up to the number of plugins in the chain, and produces the same "
+      "output. Plugins in the chain are still only ever called from one "
+      "thread at a time.")
+      .def(py::init([](std::vector<std::shared_ptr<Plugin>> plugins,
+                       bool fused, bool pipelined) {
+             return new Chain(plugins, fused, pipelined);
            }),
-           py::arg("plugins"))
+           py::arg("plugins"), py::arg("fused") = false,
+           py::arg("pipelined") = false)
       .def(py::init([]() { return new Chain({}); }))
       .def("__repr__", [](Chain &plugin) {
+        // Copy the list of plugins rather than holding its lock, as calling
+        // __repr__ on each plugin may run arbitrary Python code:
+        std::vector<std::shared_ptr<Plugin>> plugins;
+        {
+          std::shared_lock lock(plugin.pluginListMutex);
+          plugins = plugin.getPlugins();
+        }
+
         std::ostringstream ss;
-        ss << "<pedalboard.Chain with " << plugin.getPlugins().size()
-           << " plugin";
-        if (plugin.getPlugins().size() != 1) {
+        ss << "<pedalboard.Chain with " << plugins.size() << " plugin";
+        if (plugins.size() != 1) {
           ss << "s";
         }
         ss << ": [";
-        for (int i = 0; i < plugin.getPlugins().size(); i++) {
-          py::object nestedPlugin = py::cast(plugin.getPlugins()[i]);
+        for (int i = 0; i < plugins.size(); i++) {
+          py::object nestedPlugin = py::cast(plugins[i]);
           ss << nestedPlugin.attr("__repr__")();
-          if (i < plugin.getPlugins().size() - 1) {
+          if (i < plugins.size() - 1) {
             ss << ", ";
           }
         }
-        ss << "] at " << &plugin;
+        ss << "]";
+        if (plugin.getFused()) {
+          ss << " fused=True";
+        }
+        if (plugin.getPipelined()) {
+          ss << " pipelined=True";
+        }
+        ss << " at " << &plugin;
         ss << ">";
         return ss.str();
-      });
+      })
+      .def_property(
+          "fused", &Chain::getFused, &Chain::setFused,
+          "If ``True``, runs of consecutive sample-wise plugins in this Chain "
+          "are processed together, over small tiles of audio that stay in the "
+          "CPU's cache. Changes take effect the next time audio is "
+          "processed.\n\n*Introduced in v0.9.0.*")
+      .def_property(
+          "pipelined", &Chain::getPipelined, &Chain::setPipelined,
+          "If ``True``, the plugins in this Chain each run on their own "
+          "thread (passing blocks of audio from one to the next) when "
+          "rendering an entire buffer at once. Changes take effect the next "
+          "time audio is processed.\n\n*Introduced in v0.9.0.*")
+      .def(
+          "freeze",
+          [](Chain &self) {
+            std::vector<std::shared_ptr<Plugin>> plugins;
+            {
+              std::shared_lock lock(self.pluginListMutex);
+              plugins = self.getPlugins();
+            }
+            return std::make_shared<FrozenChain>(plugins);
+          },
+          "Return a :class:`FrozenChain` containing the same plugins as this "
+          "chain, which processes audio with much less overhead per block. "
+          "Raises a ``ValueError`` if this chain contains any plugins that "
+          "can't be frozen.\n\n*Introduced in v0.9.0.*");
 }
 
 } // namespace Pedalboard
\ No newline at end of file
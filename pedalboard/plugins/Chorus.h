@@ -20,7 +20,9 @@
 
 namespace py = pybind11;
 
+#include "../Automation.h"
 #include "../JucePlugin.h"
+#include "../plugin_templates/ModulationProcessors.h"
 
 namespace Pedalboard {
 
@@ -30,7 +32,7 @@ namespace Pedalboard {
 #define CHORUS_MAX_RATE_HZ 100
 
 template <typename SampleType>
-class Chorus : public JucePlugin<juce::dsp::Chorus<SampleType>> {
+class Chorus : public JucePlugin<BlockRateChorus<SampleType>> {
   DEFINE_DSP_SETTER_AND_GETTER(SampleType, Rate, {
     if (value < CHORUS_MIN_RATE_HZ || value > CHORUS_MAX_RATE_HZ) {
       throw std::range_error("Rate must be between " TO_STRING(
@@ -45,6 +47,16 @@ class Chorus : public JucePlugin<juce::dsp::Chorus<SampleType>> {
       throw std::range_error("Mix must be between 0.0 and 1.0.");
     }
   });
+
+  std::shared_ptr<Plugin> clone() override {
+    auto plugin = std::make_shared<Chorus<SampleType>>();
+    plugin->setRate(getRate());
+    plugin->setDepth(getDepth());
+    plugin->setCentreDelay(getCentreDelay());
+    plugin->setFeedback(getFeedback());
+    plugin->setMix(getMix());
+    return plugin;
+  }
 };
 
 inline void init_chorus(py::module &m) {
@@ -97,5 +109,17 @@ inline void init_chorus(py::module &m) {
                     &Chorus<float>::setFeedback)
       .def_property("mix", &Chorus<float>::getMix, &Chorus<float>::setMix);
   ;
+
+  registerAutomatableParameter<Chorus<float>>(
+      "rate_hz", &Chorus<float>::getRate, &Chorus<float>::setRate);
+  registerAutomatableParameter<Chorus<float>>("depth", &Chorus<float>::getDepth,
+                                              &Chorus<float>::setDepth);
+  registerAutomatableParameter<Chorus<float>>(
+      "centre_delay_ms", &Chorus<float>::getCentreDelay,
+      &Chorus<float>::setCentreDelay);
+  registerAutomatableParameter<Chorus<float>>(
+      "feedback", &Chorus<float>::getFeedback, &Chorus<float>::setFeedback);
+  registerAutomatableParameter<Chorus<float>>("mix", &Chorus<float>::getMix,
+                                              &Chorus<float>::setMix);
 }
 }; // namespace Pedalboard
\ No newline at end of file
@@ -20,7 +20,9 @@
 
 namespace py = pybind11;
 
+#include "../Automation.h"
 #include "../JucePlugin.h"
+#include "../simd/Dispatch.h"
 
 namespace Pedalboard {
 template <typename SampleType> class Clipping : public Plugin {
@@ -37,23 +39,50 @@ public:
   virtual void prepare(const juce::dsp::ProcessSpec &spec) {}
 
   virtual int process(
-      const juce::dsp::ProcessContextReplacing<SampleType> &context) override {
+      const juce::dsp::ProcessContextReplacing<float> &context) override {
+    return processSamples(context);
+  }
+
+  virtual int process(
+      const juce::dsp::ProcessContextReplacing<double> &context) override {
+    return processSamples(context);
+  }
+
+  virtual void reset() {}
+
+  bool isTileable() override { return true; }
+  int getTailLengthSamples() override { return 0; }
+
+  std::shared_ptr<Plugin> clone() override {
+    auto plugin = std::make_shared<Clipping<SampleType>>();
+    plugin->setThresholdDecibels(getThresholdDecibels());
+    return plugin;
+  }
+
+private:
+  template <typename T>
+  int processSamples(const juce::dsp::ProcessContextReplacing<T> &context) {
     auto ioBlock = context.getOutputBlock();
 
     for (int c = 0; c < ioBlock.getNumChannels(); c++) {
-      SampleType *channelPointer = ioBlock.getChannelPointer(c);
+      T *channelPointer = ioBlock.getChannelPointer(c);
 
-      juce::FloatVectorOperations::clip(
-          channelPointer, channelPointer, negativeThresholdGain,
-          positiveThresholdGain, ioBlock.getNumSamples());
+      clip(channelPointer, (int)ioBlock.getNumSamples(),
+           static_cast<T>(negativeThresholdGain),
+           static_cast<T>(positiveThresholdGain));
     }
 
     return context.getOutputBlock().getNumSamples();
   }
 
-  virtual void reset() {}
+  static void clip(float *samples, int numSamples, float low, float high) {
+    simd::getKernels().clipFloat(samples, numSamples, low, high);
+  }
+
+  static void clip(double *samples, int numSamples, double low, double high) {
+    simd::getKernels().clipDouble(samples, numSamples, low, high);
+  }
 
-private:
   SampleType thresholdDecibels;
 
   SampleType negativeThresholdGain;
@@ -82,5 +111,9 @@ inline void init_clipping(py::module &m) {
            })
       .def_property("threshold_db", &Clipping<float>::getThresholdDecibels,
                     &Clipping<float>::setThresholdDecibels);
+
+  registerAutomatableParameter<Clipping<float>>(
+      "threshold_db", &Clipping<float>::getThresholdDecibels,
+      &Clipping<float>::setThresholdDecibels);
 }
 }; // namespace Pedalboard
\ No newline at end of file
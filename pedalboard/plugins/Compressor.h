@@ -20,11 +20,13 @@
 
 namespace py = pybind11;
 
+#include "../Automation.h"
 #include "../JucePlugin.h"
+#include "../plugin_templates/DynamicsProcessors.h"
 
 namespace Pedalboard {
 template <typename SampleType>
-class Compressor : public JucePlugin<juce::dsp::Compressor<SampleType>> {
+class Compressor : public JucePlugin<DynamicsCompressor<SampleType>> {
   DEFINE_DSP_SETTER_AND_GETTER(SampleType, Threshold, {});
   DEFINE_DSP_SETTER_AND_GETTER(SampleType, Ratio, {
     if (value < 1.0) {
@@ -33,6 +35,27 @@ class Compressor : public JucePlugin<juce::dsp::Compressor<SampleType>> {
   });
   DEFINE_DSP_SETTER_AND_GETTER(SampleType, Attack, {});
   DEFINE_DSP_SETTER_AND_GETTER(SampleType, Release, {});
+  DEFINE_DSP_SETTER_AND_GETTER(bool, Linked, {});
+
+  bool isTileable() override { return true; }
+
+  // The time taken for the compressor's envelope to release:
+  int getTailLengthSamples() override {
+    return Plugin::getDecaySamples(
+        std::exp(-2.0 * juce::MathConstants<double>::pi * 1000.0 /
+                 (this->lastSpec.sampleRate * getRelease())),
+        1);
+  }
+
+  std::shared_ptr<Plugin> clone() override {
+    auto plugin = std::make_shared<Compressor<SampleType>>();
+    plugin->setThreshold(getThreshold());
+    plugin->setRatio(getRatio());
+    plugin->setAttack(getAttack());
+    plugin->setRelease(getRelease());
+    plugin->setLinked(getLinked());
+    return plugin;
+  }
 };
 
 inline void init_compressor(py::module &m) {
@@ -43,16 +66,18 @@ inline void init_compressor(py::module &m) {
       "algorithm that introduces noise or artifacts, see "
       "``pedalboard.MP3Compressor`` or ``pedalboard.GSMCompressor``.")
       .def(py::init([](float thresholddB, float ratio, float attackMs,
-                       float releaseMs) {
+                       float releaseMs, bool linked) {
              auto plugin = std::make_unique<Compressor<float>>();
              plugin->setThreshold(thresholddB);
              plugin->setRatio(ratio);
              plugin->setAttack(attackMs);
              plugin->setRelease(releaseMs);
+             plugin->setLinked(linked);
              return plugin;
            }),
            py::arg("threshold_db") = 0, py::arg("ratio") = 1,
-           py::arg("attack_ms") = 1.0, py::arg("release_ms") = 100)
+           py::arg("attack_ms") = 1.0, py::arg("release_ms") = 100,
+           py::arg("linked") = false)
       .def("__repr__",
            [](const Compressor<float> &plugin) {
              std::ostringstream ss;
@@ -61,6 +86,7 @@ inline void init_compressor(py::module &m) {
              ss << " ratio=" << plugin.getRatio();
              ss << " attack_ms=" << plugin.getAttack();
              ss << " release_ms=" << plugin.getRelease();
+             ss << " linked=" << (plugin.getLinked() ? "True" : "False");
              ss << " at " << &plugin;
              ss << ">";
              return ss.str();
@@ -72,6 +98,25 @@ inline void init_compressor(py::module &m) {
       .def_property("attack_ms", &Compressor<float>::getAttack,
                     &Compressor<float>::setAttack)
       .def_property("release_ms", &Compressor<float>::getRelease,
-                    &Compressor<float>::setRelease);
+                    &Compressor<float>::setRelease)
+      .def_property("linked", &Compressor<float>::getLinked,
+                    &Compressor<float>::setLinked,
+                    "If ``True``, the compressor is driven by the loudest "
+                    "channel and applies the same gain to every channel, "
+                    "preserving the stereo image. If ``False`` (the default), "
+                    "each channel is processed independently."
+                    "\n\n*Introduced in v0.9.0.*");
+
+  registerAutomatableParameter<Compressor<float>>(
+      "threshold_db", &Compressor<float>::getThreshold,
+      &Compressor<float>::setThreshold);
+  registerAutomatableParameter<Compressor<float>>(
+      "ratio", &Compressor<float>::getRatio, &Compressor<float>::setRatio);
+  registerAutomatableParameter<Compressor<float>>(
+      "attack_ms", &Compressor<float>::getAttack,
+      &Compressor<float>::setAttack);
+  registerAutomatableParameter<Compressor<float>>(
+      "release_ms", &Compressor<float>::getRelease,
+      &Compressor<float>::setRelease);
 }
 }; // namespace Pedalboard
\ No newline at end of file
@@ -15,11 +15,14 @@
  * limitations under the License.
  */
 
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
 namespace py = pybind11;
 
+#include "../Automation.h"
+#include "../BufferUtils.h"
 #include "../JucePlugin.h"
 
 #include "../juce_overrides/juce_BlockingConvolution.h"
@@ -34,7 +37,23 @@ class ConvolutionWithMix {
 public:
   ConvolutionWithMix() = default;
 
-  juce::dsp::BlockingConvolution &getConvolution() { return convolution; }
+  juce::dsp::BlockingConvolution &getConvolution() { return *convolution; }
+
+  /**
+   * Switch to non-uniform partitioning, with a zero-latency head of the given
+   * size (or back to uniform partitioning if 0). As this replaces the
+   * underlying convolution, it must be called before loading an impulse
+   * response.
+   */
+  void setHeadSize(int newHeadSize) {
+    int numThreads = convolution->getNumThreads();
+    convolution = std::make_unique<juce::dsp::BlockingConvolution>(
+        juce::dsp::Convolution::NonUniform{newHeadSize});
+    convolution->setNumThreads(numThreads);
+    headSize = newHeadSize;
+  }
+
+  int getHeadSize() const noexcept { return headSize; }
 
   void setMix(double newMix) noexcept {
     mixer.setWetMixProportion(newMix);
@@ -43,22 +62,61 @@ public:
 
   double getMix() const noexcept { return mix; }
 
-  void setImpulseResponseFilename(std::string &filename) {
+  void setImpulseResponseFilename(const std::string &filename) {
     impulseResponseFilename = filename;
   }
 
-  const std::string &getImpulseResponseFilename() const {
+  const std::optional<std::string> &getImpulseResponseFilename() const {
     return impulseResponseFilename;
   }
 
+  /**
+   * Load an impulse response from a buffer, keeping a copy of it so that it
+   * can be returned to Python later.
+   */
+  void loadImpulseResponse(juce::AudioBuffer<float> &&buffer,
+                           double sampleRate) {
+    impulseResponse = std::make_shared<const juce::AudioBuffer<float>>(buffer);
+    impulseResponseSampleRate = sampleRate;
+    convolution->loadImpulseResponse(std::move(buffer), sampleRate,
+                                     juce::dsp::Convolution::Stereo::yes,
+                                     juce::dsp::Convolution::Trim::no,
+                                     juce::dsp::Convolution::Normalise::yes);
+  }
+
+  const std::shared_ptr<const juce::AudioBuffer<float>> &
+  getImpulseResponse() const {
+    return impulseResponse;
+  }
+
+  const std::optional<double> &getImpulseResponseSampleRate() const {
+    return impulseResponseSampleRate;
+  }
+
+  /**
+   * Copy the settings and impulse response of another ConvolutionWithMix.
+   * The impulse response isn't copied, but shared by reference (along with
+   * its transformed partitions), so this is cheap even for long IRs.
+   */
+  void copyFrom(ConvolutionWithMix &other) {
+    if (other.headSize)
+      setHeadSize(other.headSize);
+    convolution->setNumThreads(other.convolution->getNumThreads());
+    setMix(other.mix);
+    impulseResponseFilename = other.impulseResponseFilename;
+    impulseResponse = other.impulseResponse;
+    impulseResponseSampleRate = other.impulseResponseSampleRate;
+    convolution->loadImpulseResponseFrom(*other.convolution);
+  }
+
   void prepare(const juce::dsp::ProcessSpec &spec) {
-    convolution.prepare(spec);
+    convolution->prepare(spec);
     mixer.prepare(spec);
     mixer.setWetMixProportion(mix);
   }
 
   void reset() noexcept {
-    convolution.reset();
+    convolution->reset();
     mixer.reset();
     mixer.setWetMixProportion(mix);
   }
@@ -66,26 +124,126 @@ public:
   template <typename ProcessContext>
   void process(const ProcessContext &context) noexcept {
     mixer.pushDrySamples(context.getInputBlock());
-    convolution.process(context);
+    convolution->process(context);
     mixer.mixWetSamples(context.getOutputBlock());
   }
 
 private:
-  juce::dsp::BlockingConvolution convolution;
+  std::unique_ptr<juce::dsp::BlockingConvolution> convolution =
+      std::make_unique<juce::dsp::BlockingConvolution>();
   juce::dsp::DryWetMixer<float> mixer;
   float mix = 1.0;
-  std::string impulseResponseFilename;
+  int headSize = 0;
+  std::optional<std::string> impulseResponseFilename;
+  std::shared_ptr<const juce::AudioBuffer<float>> impulseResponse;
+  std::optional<double> impulseResponseSampleRate;
 };
 
+template <>
+inline int JucePlugin<ConvolutionWithMix>::getTailLengthSamples() {
+  auto &convolution = getDSP().getConvolution();
+  return convolution.getCurrentIRSize() + convolution.getLatency();
+}
+
+template <>
+inline std::shared_ptr<Plugin> JucePlugin<ConvolutionWithMix>::clone() {
+  auto plugin = std::make_shared<JucePlugin<ConvolutionWithMix>>();
+  plugin->getDSP().copyFrom(getDSP());
+  return plugin;
+}
+
 inline void init_convolution(py::module &m) {
   py::class_<JucePlugin<ConvolutionWithMix>, Plugin,
              std::shared_ptr<JucePlugin<ConvolutionWithMix>>>(
       m, "Convolution",
       "An audio convolution, suitable for things like speaker simulation or "
-      "reverb modeling.")
-      .def(py::init([](std::string &impulseResponseFilename, float mix) {
-             py::gil_scoped_release release;
+      "reverb modeling.\n\n"
+      "By default, the entire impulse response is convolved with uniformly "
+      "sized partitions no larger than the buffer size, which is expensive "
+      "for long impulse responses (i.e.: reverbs). Passing ``head_size`` "
+      "(in samples) switches to non-uniform partitioning: the first "
+      "``head_size`` samples of the impulse response are still convolved "
+      "with zero latency, but the remainder (the \"tail\") is convolved "
+      "using partitions of ``head_size`` samples, which is much cheaper. "
+      "Head sizes are rounded up to a power of two of at least 64 samples; "
+      "values between 1024 and 8192 work well for multi-second reverbs.\n\n"
+      "If ``num_threads`` is greater than 1, the head and tail of each "
+      "channel are convolved concurrently on a pool of background threads. "
+      "The output is bit-for-bit identical regardless of the number of "
+      "threads used.\n\n"
+      "The impulse response may be provided either as the path to an audio "
+      "file or as a mono or stereo NumPy array, in which case "
+      "``sample_rate`` must be provided too.\n\n"
+      "Impulse responses are decoded, resampled and transformed only once, "
+      "and shared between every :class:`Convolution` that uses the same file "
+      "(or an array with the same contents) and settings; modifying the file "
+      "on disk causes it to be loaded again.\n\n"
+      "*Support for non-uniform partitioning, multiple threads, and "
+      "in-memory impulse responses introduced in v0.9.0.*")
+      .def(py::init([](std::variant<std::string, py::array_t<float>>
+                           impulseResponseSource,
+                       float mix, std::optional<double> sampleRate,
+                       std::optional<int> headSize, int numThreads) {
+             if (headSize && *headSize <= 0) {
+               throw std::domain_error("head_size must be a positive number "
+                                       "of samples, or None.");
+             }
+             if (numThreads < 1) {
+               throw std::domain_error("num_threads must be at least 1.");
+             }
+
              auto plugin = std::make_unique<JucePlugin<ConvolutionWithMix>>();
+             if (headSize)
+               plugin->getDSP().setHeadSize(*headSize);
+             plugin->getDSP().getConvolution().setNumThreads(numThreads);
+             plugin->getDSP().setMix(mix);
+
+             if (auto *array =
+                     std::get_if<py::array_t<float>>(&impulseResponseSource)) {
+               if (!sampleRate) {
+                 throw std::domain_error(
+                     "sample_rate must be provided when passing an impulse "
+                     "response as a NumPy array.");
+               }
+               if (*sampleRate <= 0) {
+                 throw std::domain_error("sample_rate must be greater than 0.");
+               }
+
+               py::array_t<float, py::array::c_style> contiguous = *array;
+               // Impulse responses are usually much longer than they are
+               // wide, so either layout can be detected from their shape:
+               ChannelLayout layout = ChannelLayout::NotInterleaved;
+               if (contiguous.ndim() == 2 &&
+                   contiguous.shape(0) != contiguous.shape(1))
+                 layout = detectChannelLayout(contiguous);
+               auto buffer = copyPyArrayIntoJuceBuffer(contiguous, {layout});
+               if (buffer.getNumChannels() > 2) {
+                 throw std::domain_error(
+                     "Impulse responses may have at most 2 channels, but got "
+                     "an array with " +
+                     std::to_string(buffer.getNumChannels()) + " channels.");
+               }
+               if (buffer.getNumSamples() == 0) {
+                 throw std::domain_error(
+                     "The provided impulse response contains no samples.");
+               }
+
+               py::gil_scoped_release release;
+               plugin->getDSP().loadImpulseResponse(std::move(buffer),
+                                                    *sampleRate);
+               return plugin;
+             }
+
+             if (sampleRate) {
+               throw std::domain_error(
+                   "sample_rate can only be provided when passing an impulse "
+                   "response as a NumPy array, not a filename.");
+             }
+
+             const std::string &impulseResponseFilename =
+                 std::get<std::string>(impulseResponseSource);
+             py::gil_scoped_release release;
+
              // Load the IR file on construction, to handle errors
              auto inputFile = juce::File(impulseResponseFilename);
              // Test opening the file before we pass it to
@@ -101,17 +259,32 @@ inline void init_convolution(py::module &m) {
              plugin->getDSP().getConvolution().loadImpulseResponse(
                  inputFile, juce::dsp::Convolution::Stereo::yes,
                  juce::dsp::Convolution::Trim::no, 0);
-             plugin->getDSP().setMix(mix);
+             plugin->getDSP().setImpulseResponseFilename(
+                 impulseResponseFilename);
              return plugin;
            }),
-           py::arg("impulse_response_filename"), py::arg("mix") = 1.0)
+           py::arg("impulse_response_filename"), py::arg("mix") = 1.0,
+           py::arg("sample_rate") = py::none(), py::kw_only(),
+           py::arg("head_size") = py::none(),
+           py::arg("num_threads") = 1)
       .def("__repr__",
            [](JucePlugin<ConvolutionWithMix> &plugin) {
              std::ostringstream ss;
              ss << "<pedalboard.Convolution";
-             ss << " impulse_response_filename="
-                << plugin.getDSP().getImpulseResponseFilename();
+             if (auto &filename = plugin.getDSP().getImpulseResponseFilename())
+               ss << " impulse_response_filename=" << *filename;
+             else if (auto &impulseResponse =
+                          plugin.getDSP().getImpulseResponse())
+               ss << " impulse_response=<" << impulseResponse->getNumChannels()
+                  << "x" << impulseResponse->getNumSamples() << " array>"
+                  << " sample_rate="
+                  << *plugin.getDSP().getImpulseResponseSampleRate();
              ss << " mix=" << plugin.getDSP().getMix();
+             if (plugin.getDSP().getHeadSize())
+               ss << " head_size=" << plugin.getDSP().getHeadSize();
+             if (plugin.getDSP().getConvolution().getNumThreads() > 1)
+               ss << " num_threads="
+                  << plugin.getDSP().getConvolution().getNumThreads();
              ss << " at " << &plugin;
              ss << ">";
              return ss.str();
@@ -120,7 +293,48 @@ inline void init_convolution(py::module &m) {
           "impulse_response_filename",
           [](JucePlugin<ConvolutionWithMix> &plugin) {
             return plugin.getDSP().getImpulseResponseFilename();
-          })
+          },
+          "The path of the audio file that the impulse response was loaded "
+          "from, or ``None`` if it was provided as a NumPy array.")
+      .def_property_readonly(
+          "impulse_response",
+          [](JucePlugin<ConvolutionWithMix> &plugin)
+              -> std::optional<py::array_t<float>> {
+            if (auto &impulseResponse = plugin.getDSP().getImpulseResponse())
+              return copyJuceBufferIntoPyArray(
+                  *impulseResponse, ChannelLayout::NotInterleaved, 0);
+            return {};
+          },
+          "A copy of the impulse response provided as a NumPy array, with "
+          "shape ``(num_channels, num_samples)``, or ``None`` if it was "
+          "loaded from a file.\n\n*Introduced in v0.9.0.*")
+      .def_property_readonly(
+          "sample_rate",
+          [](JucePlugin<ConvolutionWithMix> &plugin) {
+            return plugin.getDSP().getImpulseResponseSampleRate();
+          },
+          "The sample rate of the impulse response provided as a NumPy "
+          "array, or ``None`` if it was loaded from a file (in which case "
+          "the file's own sample rate is used).\n\n*Introduced in v0.9.0.*")
+      .def_property_readonly(
+          "head_size",
+          [](JucePlugin<ConvolutionWithMix> &plugin) -> std::optional<int> {
+            if (plugin.getDSP().getHeadSize())
+              return plugin.getDSP().getHeadSize();
+            return {};
+          },
+          "The number of samples at the start of the impulse response that "
+          "are convolved with zero latency using short partitions, with the "
+          "rest of the impulse response convolved using longer (and cheaper) "
+          "partitions of this size. ``None`` if the whole impulse response "
+          "uses uniform partitioning.\n\n*Introduced in v0.9.0.*")
+      .def_property_readonly(
+          "num_threads",
+          [](JucePlugin<ConvolutionWithMix> &plugin) {
+            return plugin.getDSP().getConvolution().getNumThreads();
+          },
+          "The number of threads used to convolve audio.\n\n*Introduced in "
+          "v0.9.0.*")
       .def_property(
           "mix",
           [](JucePlugin<ConvolutionWithMix> &plugin) {
@@ -129,5 +343,14 @@ inline void init_convolution(py::module &m) {
           [](JucePlugin<ConvolutionWithMix> &plugin, double newMix) {
             return plugin.getDSP().setMix(newMix);
           });
+
+  registerAutomatableParameter<JucePlugin<ConvolutionWithMix>>(
+      "mix",
+      [](JucePlugin<ConvolutionWithMix> &plugin) {
+        return plugin.getDSP().getMix();
+      },
+      [](JucePlugin<ConvolutionWithMix> &plugin, double newMix) {
+        plugin.getDSP().setMix(newMix);
+      });
 }
 }; // namespace Pedalboard
\ No newline at end of file
@@ -15,12 +15,20 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+
+#include "../Automation.h"
 #include "../JucePlugin.h"
 
 namespace Pedalboard {
-template <typename SampleType>
-class Delay : public JucePlugin<juce::dsp::DelayLine<
-                  SampleType, juce::dsp::DelayLineInterpolationTypes::None>> {
+/**
+ * A feedback delay line. Audio is delayed through a circular buffer that can
+ * hold the maximum delay time (plus one block), which allows each block to be
+ * processed in chunks of up to the delay time with whole-chunk vector
+ * operations, as no sample in a chunk depends on another sample in the same
+ * chunk.
+ */
+template <typename SampleType> class Delay : public Plugin {
 public:
   SampleType getDelaySeconds() const { return delaySeconds; }
   void setDelaySeconds(const SampleType value) {
@@ -49,47 +57,107 @@ public:
     if (this->lastSpec.sampleRate != spec.sampleRate ||
         this->lastSpec.maximumBlockSize < spec.maximumBlockSize ||
         spec.numChannels != this->lastSpec.numChannels) {
-      this->getDSP().setMaximumDelayInSamples(
-          (int)(MAXIMUM_DELAY_TIME_SECONDS * spec.sampleRate));
-      this->getDSP().prepare(spec);
+      // The extra block of space ensures that the samples written while
+      // processing a chunk never overlap the samples read for it:
+      delayBuffer.setSize(
+          (int)spec.numChannels,
+          (int)(MAXIMUM_DELAY_TIME_SECONDS * spec.sampleRate) +
+              (int)spec.maximumBlockSize + 1);
+      reset();
       this->lastSpec = spec;
     }
+  }
 
-    this->getDSP().setDelay((int)(delaySeconds * spec.sampleRate));
+  virtual void reset() override {
+    delayBuffer.clear();
+    writePosition = 0;
   }
 
-  virtual void reset() override { this->getDSP().reset(); }
+  std::shared_ptr<Plugin> clone() override {
+    auto plugin = std::make_shared<Delay<SampleType>>();
+    plugin->setDelaySeconds(getDelaySeconds());
+    plugin->setFeedback(getFeedback());
+    plugin->setMix(getMix());
+    return plugin;
+  }
 
   virtual int process(
       const juce::dsp::ProcessContextReplacing<SampleType> &context) override {
     // TODO: More advanced mixing rules than "linear?"
-    SampleType dryVolume = 1.0f - getMix();
-    SampleType wetVolume = getMix();
+    const SampleType dryVolume = 1.0f - getMix();
+    const SampleType wetVolume = getMix();
+    const SampleType feedbackVolume = getFeedback();
+
+    const int delaySamples = (int)(delaySeconds * this->lastSpec.sampleRate);
+    const int numSamples = (int)context.getInputBlock().getNumSamples();
+    const int bufferSize = delayBuffer.getNumSamples();
 
-    if (delaySeconds == 0.0f) {
-      // Special case where DelayLine doesn't do anything for us.
+    if (delaySamples == 0 || bufferSize == 0) {
+      // Special case where the delay line doesn't do anything for us.
       // Regardless of the mix or feedback parameters, the input will sound
       // identical.
-      return context.getInputBlock().getNumSamples();
+      return numSamples;
     }
 
-    this->getDSP().setDelay((int)(delaySeconds * this->lastSpec.sampleRate));
-
-    // Pass samples through the delay line with feedback:
     for (size_t c = 0; c < context.getInputBlock().getNumChannels(); c++) {
       jassert(context.getInputBlock().getChannelPointer(c) ==
               context.getOutputBlock().getChannelPointer(c));
       SampleType *channelBuffer = context.getOutputBlock().getChannelPointer(c);
+      SampleType *delayData = delayBuffer.getWritePointer((int)c);
+
+      int writeIndex = writePosition;
+      int readIndex = writePosition - delaySamples;
+      if (readIndex < 0)
+        readIndex += bufferSize;
 
-      for (size_t i = 0; i < context.getInputBlock().getNumSamples(); i++) {
-        SampleType delayOutput = this->getDSP().popSample(c);
-        this->getDSP().pushSample(c, channelBuffer[i] +
-                                         (getFeedback() * delayOutput));
-        channelBuffer[i] =
-            (channelBuffer[i] * dryVolume) + (wetVolume * delayOutput);
+      if (delaySamples < MINIMUM_BLOCK_DELAY_SAMPLES) {
+        // Chunks this short would spend more time on overhead than on
+        // processing, so process one sample at a time instead:
+        for (int i = 0; i < numSamples; i++) {
+          SampleType delayOutput = delayData[readIndex];
+          delayData[writeIndex] =
+              channelBuffer[i] + (feedbackVolume * delayOutput);
+          channelBuffer[i] =
+              (channelBuffer[i] * dryVolume) + (wetVolume * delayOutput);
+
+          if (++readIndex == bufferSize)
+            readIndex = 0;
+          if (++writeIndex == bufferSize)
+            writeIndex = 0;
+        }
+        continue;
+      }
+
+      for (int i = 0; i < numSamples;) {
+        // Each chunk must not span the end of the circular buffer, and must
+        // only read delayed samples that were written before it started:
+        int chunkSize = std::min({numSamples - i, delaySamples,
+                                  bufferSize - readIndex,
+                                  bufferSize - writeIndex});
+        SampleType *input = channelBuffer + i;
+        const SampleType *delayOutput = delayData + readIndex;
+
+        juce::FloatVectorOperations::copy(delayData + writeIndex, input,
+                                          chunkSize);
+        juce::FloatVectorOperations::addWithMultiply(
+            delayData + writeIndex, delayOutput, feedbackVolume, chunkSize);
+
+        juce::FloatVectorOperations::multiply(input, dryVolume, chunkSize);
+        juce::FloatVectorOperations::addWithMultiply(input, delayOutput,
+                                                     wetVolume, chunkSize);
+
+        i += chunkSize;
+        readIndex += chunkSize;
+        if (readIndex == bufferSize)
+          readIndex = 0;
+        writeIndex += chunkSize;
+        if (writeIndex == bufferSize)
+          writeIndex = 0;
       }
     }
-    return context.getInputBlock().getNumSamples();
+
+    writePosition = (writePosition + numSamples) % bufferSize;
+    return numSamples;
   }
 
 private:
@@ -97,6 +165,12 @@ private:
   SampleType feedback = 0.0f;
   SampleType mix = 1.0f;
   static constexpr int MAXIMUM_DELAY_TIME_SECONDS = 30;
+
+  // Delays shorter than this are processed one sample at a time:
+  static constexpr int MINIMUM_BLOCK_DELAY_SAMPLES = 16;
+
+  juce::AudioBuffer<SampleType> delayBuffer;
+  int writePosition = 0;
 };
 
 inline void init_delay(py::module &m) {
@@ -129,5 +203,13 @@ inline void init_delay(py::module &m) {
       .def_property("feedback", &Delay<float>::getFeedback,
                     &Delay<float>::setFeedback)
       .def_property("mix", &Delay<float>::getMix, &Delay<float>::setMix);
+
+  registerAutomatableParameter<Delay<float>>(
+      "delay_seconds", &Delay<float>::getDelaySeconds,
+      &Delay<float>::setDelaySeconds);
+  registerAutomatableParameter<Delay<float>>(
+      "feedback", &Delay<float>::getFeedback, &Delay<float>::setFeedback);
+  registerAutomatableParameter<Delay<float>>("mix", &Delay<float>::getMix,
+                                             &Delay<float>::setMix);
 }
 }; // namespace Pedalboard
@@ -20,6 +20,7 @@
 
 namespace py = pybind11;
 
+#include "../Automation.h"
 #include "../JucePlugin.h"
 
 namespace Pedalboard {
@@ -41,6 +42,12 @@ public:
         [](SampleType x) { return std::tanh(x); };
   }
 
+  std::shared_ptr<Plugin> clone() override {
+    auto plugin = std::make_shared<Distortion<SampleType>>();
+    plugin->setDriveDecibels(getDriveDecibels());
+    return plugin;
+  }
+
 private:
   SampleType driveDecibels;
 
@@ -72,5 +79,9 @@ inline void init_distortion(py::module &m) {
            })
       .def_property("drive_db", &Distortion<float>::getDriveDecibels,
                     &Distortion<float>::setDriveDecibels);
+
+  registerAutomatableParameter<Distortion<float>>(
+      "drive_db", &Distortion<float>::getDriveDecibels,
+      &Distortion<float>::setDriveDecibels);
 }
 }; // namespace Pedalboard
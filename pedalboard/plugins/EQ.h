@@ -0,0 +1,338 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cmath>
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include "../Plugin.h"
+#include "../plugin_templates/BiquadCascade.h"
+#include "HighpassFilter.h"
+#include "IIRFilters.h"
+#include "LowpassFilter.h"
+
+namespace Pedalboard {
+
+/**
+ * A multi-band equalizer that runs a list of filter plugins (used only as
+ * descriptions of each band) as a single BiquadCascade.
+ *
+ * Band parameters are read at the start of every call to process(). Changes
+ * are ramped in over SMOOTHING_SECONDS, recomputing coefficients every
+ * SMOOTHING_INTERVAL_SAMPLES samples, so that bands can be automated block
+ * by block without zipper noise.
+ */
+class EQ : public Plugin {
+public:
+  EQ(std::vector<std::shared_ptr<Plugin>> bands = {}) { setBands(bands); }
+  virtual ~EQ(){};
+
+  std::vector<std::shared_ptr<Plugin>> getBands() const { return bands; }
+  void setBands(std::vector<std::shared_ptr<Plugin>> newBands) {
+    for (auto &band : newBands) {
+      if (!band) {
+        throw py::type_error("EQ bands must not be None.");
+      }
+      getBandType(band);
+    }
+    bands = newBands;
+  }
+
+  virtual void prepare(const juce::dsp::ProcessSpec &spec) override {
+    if (lastSpec.sampleRate != spec.sampleRate ||
+        lastSpec.maximumBlockSize < spec.maximumBlockSize ||
+        lastSpec.numChannels != spec.numChannels) {
+      reset();
+      lastSpec = spec;
+    }
+  }
+
+  virtual void reset() override {
+    cascade.reset();
+    bandStates.clear();
+  }
+
+  virtual int
+  process(const juce::dsp::ProcessContextReplacing<float> &context) override {
+    juce::ScopedNoDenormals noDenormals;
+
+    auto ioBlock = context.getOutputBlock();
+    int numChannels = (int)ioBlock.getNumChannels();
+    int numSamples = (int)ioBlock.getNumSamples();
+
+    updateBandStates();
+    cascade.prepare(numChannels, (int)bandStates.size());
+
+    float **channels = (float **)alloca(numChannels * sizeof(float *));
+    for (int i = 0; i < numSamples;) {
+      int samplesToProcess = numSamples - i;
+      if (isSmoothing()) {
+        samplesToProcess =
+            std::min(samplesToProcess, SMOOTHING_INTERVAL_SAMPLES);
+        for (auto &state : bandStates) {
+          state.frequencyHz.skip(samplesToProcess);
+          state.q.skip(samplesToProcess);
+          state.gainDecibels.skip(samplesToProcess);
+        }
+      }
+
+      for (size_t b = 0; b < bandStates.size(); b++) {
+        cascade.setCoefficients((int)b,
+                                makeCoefficients(bandStates[b],
+                                                 lastSpec.sampleRate));
+      }
+
+      for (int c = 0; c < numChannels; c++) {
+        channels[c] = ioBlock.getChannelPointer(c) + i;
+      }
+      cascade.process(channels, samplesToProcess);
+      i += samplesToProcess;
+    }
+
+    return numSamples;
+  }
+
+  std::shared_ptr<Plugin> clone() override {
+    std::vector<std::shared_ptr<Plugin>> clonedBands;
+    for (auto &band : bands) {
+      auto clonedBand = band->clone();
+      if (!clonedBand)
+        return nullptr;
+      clonedBands.push_back(clonedBand);
+    }
+    return std::make_shared<EQ>(clonedBands);
+  }
+
+private:
+  enum class BandType {
+    Peak,
+    LowShelf,
+    HighShelf,
+    FirstOrderHighPass,
+    FirstOrderLowPass,
+  };
+
+  struct BandState {
+    BandType type;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative>
+        frequencyHz;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> q;
+    juce::SmoothedValue<float> gainDecibels;
+  };
+
+  static BandType getBandType(const std::shared_ptr<Plugin> &band) {
+    if (std::dynamic_pointer_cast<PeakFilter<float>>(band))
+      return BandType::Peak;
+    if (std::dynamic_pointer_cast<LowShelfFilter<float>>(band))
+      return BandType::LowShelf;
+    if (std::dynamic_pointer_cast<HighShelfFilter<float>>(band))
+      return BandType::HighShelf;
+    if (std::dynamic_pointer_cast<HighpassFilter<float>>(band))
+      return BandType::FirstOrderHighPass;
+    if (std::dynamic_pointer_cast<LowpassFilter<float>>(band))
+      return BandType::FirstOrderLowPass;
+    throw py::type_error(
+        "EQ bands must be PeakFilter, LowShelfFilter, HighShelfFilter, "
+        "HighpassFilter, or LowpassFilter plugins.");
+  }
+
+  /**
+   * Read the current parameters of each band into bandStates. Bands that
+   * are new (or have changed type) start at their parameters immediately;
+   * other bands ramp towards them.
+   */
+  void updateBandStates() {
+    if (bandStates.size() > bands.size())
+      bandStates.resize(bands.size());
+
+    for (size_t b = 0; b < bands.size(); b++) {
+      BandType type = getBandType(bands[b]);
+
+      float frequencyHz, q = 1.0f, gainDecibels = 0.0f;
+      if (auto filter = std::dynamic_pointer_cast<IIRFilter<float>>(bands[b])) {
+        frequencyHz = filter->getCutoffFrequencyHz();
+        q = filter->getQ();
+        gainDecibels = filter->getGainDecibels();
+      } else if (auto highpass =
+                     std::dynamic_pointer_cast<HighpassFilter<float>>(
+                         bands[b])) {
+        frequencyHz = highpass->getCutoffFrequencyHz();
+      } else {
+        frequencyHz = std::dynamic_pointer_cast<LowpassFilter<float>>(bands[b])
+                          ->getCutoffFrequencyHz();
+      }
+      frequencyHz =
+          clampCutoffFrequency(frequencyHz, (float)lastSpec.sampleRate);
+
+      if (b >= bandStates.size() || bandStates[b].type != type) {
+        if (b >= bandStates.size())
+          bandStates.emplace_back();
+        BandState &state = bandStates[b];
+        state.type = type;
+        state.frequencyHz.reset(lastSpec.sampleRate, SMOOTHING_SECONDS);
+        state.q.reset(lastSpec.sampleRate, SMOOTHING_SECONDS);
+        state.gainDecibels.reset(lastSpec.sampleRate, SMOOTHING_SECONDS);
+        state.frequencyHz.setCurrentAndTargetValue(frequencyHz);
+        state.q.setCurrentAndTargetValue(q);
+        state.gainDecibels.setCurrentAndTargetValue(gainDecibels);
+      } else {
+        BandState &state = bandStates[b];
+        state.frequencyHz.setTargetValue(frequencyHz);
+        state.q.setTargetValue(q);
+        state.gainDecibels.setTargetValue(gainDecibels);
+      }
+    }
+  }
+
+  bool isSmoothing() const {
+    for (auto &state : bandStates) {
+      if (state.frequencyHz.isSmoothing() || state.q.isSmoothing() ||
+          state.gainDecibels.isSmoothing())
+        return true;
+    }
+    return false;
+  }
+
+  /**
+   * Compute normalized coefficients for the given band with the same designs
+   * as juce::dsp::IIR::Coefficients (and therefore the same frequency
+   * response as the plugin the band was created from).
+   */
+  static BiquadCascade::Coefficients makeCoefficients(const BandState &state,
+                                                      double sampleRate) {
+    const double pi = juce::MathConstants<double>::pi;
+    double frequency = state.frequencyHz.getCurrentValue();
+    double b0, b1, b2 = 0, a0, a1, a2 = 0;
+
+    switch (state.type) {
+    case BandType::FirstOrderHighPass:
+    case BandType::FirstOrderLowPass: {
+      double n = std::tan(pi * frequency / sampleRate);
+      bool isHighPass = state.type == BandType::FirstOrderHighPass;
+      b0 = isHighPass ? 1 : n;
+      b1 = isHighPass ? -1 : n;
+      a0 = n + 1;
+      a1 = n - 1;
+      break;
+    }
+    case BandType::Peak: {
+      double A = std::sqrt(juce::Decibels::decibelsToGain<double>(
+          state.gainDecibels.getCurrentValue()));
+      double omega = (2 * pi * std::max(frequency, 2.0)) / sampleRate;
+      double alpha = std::sin(omega) / (state.q.getCurrentValue() * 2);
+      double c2 = -2 * std::cos(omega);
+      b0 = 1 + alpha * A;
+      b1 = c2;
+      b2 = 1 - alpha * A;
+      a0 = 1 + alpha / A;
+      a1 = c2;
+      a2 = 1 - alpha / A;
+      break;
+    }
+    case BandType::LowShelf:
+    case BandType::HighShelf: {
+      double A = std::sqrt(juce::Decibels::decibelsToGain<double>(
+          state.gainDecibels.getCurrentValue()));
+      double omega = (2 * pi * std::max(frequency, 2.0)) / sampleRate;
+      double coso = std::cos(omega);
+      double beta = std::sin(omega) * std::sqrt(A) / state.q.getCurrentValue();
+      double aminus1TimesCoso = (A - 1) * coso;
+      if (state.type == BandType::LowShelf) {
+        b0 = A * ((A + 1) - aminus1TimesCoso + beta);
+        b1 = A * 2 * ((A - 1) - (A + 1) * coso);
+        b2 = A * ((A + 1) - aminus1TimesCoso - beta);
+        a0 = (A + 1) + aminus1TimesCoso + beta;
+        a1 = -2 * ((A - 1) + (A + 1) * coso);
+        a2 = (A + 1) + aminus1TimesCoso - beta;
+      } else {
+        b0 = A * ((A + 1) + aminus1TimesCoso + beta);
+        b1 = A * -2 * ((A - 1) + (A + 1) * coso);
+        b2 = A * ((A + 1) + aminus1TimesCoso - beta);
+        a0 = (A + 1) - aminus1TimesCoso + beta;
+        a1 = 2 * ((A - 1) - (A + 1) * coso);
+        a2 = (A + 1) - aminus1TimesCoso - beta;
+      }
+      break;
+    }
+    }
+
+    BiquadCascade::Coefficients coefficients;
+    coefficients.b0 = (float)(b0 / a0);
+    coefficients.b1 = (float)(b1 / a0);
+    coefficients.b2 = (float)(b2 / a0);
+    coefficients.a1 = (float)(a1 / a0);
+    coefficients.a2 = (float)(a2 / a0);
+    return coefficients;
+  }
+
+  static constexpr double SMOOTHING_SECONDS = 0.05;
+  static constexpr int SMOOTHING_INTERVAL_SAMPLES = 32;
+
+  std::vector<std::shared_ptr<Plugin>> bands;
+  std::vector<BandState> bandStates;
+  BiquadCascade cascade;
+};
+
+inline void init_eq(py::module &m) {
+  py::class_<EQ, Plugin, std::shared_ptr<EQ>>(
+      m, "EQ",
+      "A multi-band equalizer, which applies a list of filters (each of "
+      "which must be a :class:`PeakFilter`, :class:`LowShelfFilter`, "
+      ":class:`HighShelfFilter`, :class:`HighpassFilter`, or "
+      ":class:`LowpassFilter`) in order.\n\n"
+      "The output is equivalent to running each filter in a "
+      ":class:`Pedalboard`, but all bands are processed together, with "
+      "multiple channels and multiple bands computed at once with SIMD "
+      "instructions.\n\n"
+      "The parameters of each band are read every time audio is processed, "
+      "so filters in the list can be changed between calls (i.e.: when "
+      "processing audio in chunks with ``reset=False``). Such changes are "
+      "smoothly ramped in over 50 milliseconds to avoid audible artifacts.\n\n"
+      "*Introduced in v0.9.0.*")
+      .def(py::init([](std::vector<std::shared_ptr<Plugin>> bands) {
+             return std::make_unique<EQ>(bands);
+           }),
+           py::arg("bands") = std::vector<std::shared_ptr<Plugin>>())
+      .def("__repr__",
+           [](const EQ &plugin) {
+             auto bands = plugin.getBands();
+             std::ostringstream ss;
+             ss << "<pedalboard.EQ with " << bands.size() << " band";
+             if (bands.size() != 1) {
+               ss << "s";
+             }
+             ss << ": [";
+             for (size_t i = 0; i < bands.size(); i++) {
+               ss << py::cast(bands[i]).attr("__repr__")();
+               if (i < bands.size() - 1) {
+                 ss << ", ";
+               }
+             }
+             ss << "]";
+             ss << " at " << &plugin;
+             ss << ">";
+             return ss.str();
+           })
+      .def_property("bands", &EQ::getBands, &EQ::setBands,
+                    "The filters applied by this EQ, in order.");
+}
+}; // namespace Pedalboard
@@ -0,0 +1,92 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "../JuceHeader.h"
+
+#include "../plugin_templates/StaticChain.h"
+#include "Bitcrush.h"
+#include "Clipping.h"
+#include "Compressor.h"
+#include "Gain.h"
+#include "HighpassFilter.h"
+#include "IIRFilters.h"
+#include "Invert.h"
+#include "Limiter.h"
+#include "LowpassFilter.h"
+
+namespace Pedalboard {
+
+/**
+ * A StaticChain specialized for every built-in tileable plugin. (IIRFilter
+ * covers HighShelfFilter, LowShelfFilter, and PeakFilter, none of which
+ * override its process() method.)
+ */
+using FrozenChain =
+    StaticChain<Gain<float>, Invert<float>, Clipping<float>, Bitcrush<float>,
+                Compressor<float>, Limiter<float>, HighpassFilter<float>,
+                LowpassFilter<float>, IIRFilter<float>>;
+
+inline void init_frozen_chain(py::module &m) {
+  py::class_<FrozenChain, PluginContainer, std::shared_ptr<FrozenChain>>(
+      m, "FrozenChain",
+      "A version of :class:`Chain` that can only contain sample-wise "
+      "built-in plugins (:class:`Gain`, :class:`Invert`, :class:`Clipping`, "
+      ":class:`Bitcrush`, :class:`Compressor`, :class:`Limiter`, and IIR "
+      "filters like :class:`HighpassFilter`), but that calls each of them "
+      "directly on every block of audio rather than through Pedalboard's "
+      "general-purpose processing loop. This makes processing much faster "
+      "when using small buffer sizes (i.e.: in an "
+      ":class:`pedalboard.io.AudioStream`) and produces identical output.\n\n"
+      "Usually created with :py:meth:`Chain.freeze`. The plugins in a "
+      "FrozenChain aren't copied, and can still be changed (i.e.: by "
+      "setting their parameters) while frozen.\n\n"
+      ".. note::\n"
+      "    :py:meth:`Plugin.profile` reports only the total time taken by a "
+      "FrozenChain, not the time taken by each of its plugins.\n\n"
+      "*Introduced in v0.9.0.*")
+      .def(py::init([](std::vector<std::shared_ptr<Plugin>> plugins) {
+             return new FrozenChain(plugins);
+           }),
+           py::arg("plugins"))
+      .def("__repr__", [](FrozenChain &plugin) {
+        std::vector<std::shared_ptr<Plugin>> plugins;
+        {
+          std::shared_lock lock(plugin.pluginListMutex);
+          plugins = plugin.getPlugins();
+        }
+
+        std::ostringstream ss;
+        ss << "<pedalboard.FrozenChain with " << plugins.size() << " plugin";
+        if (plugins.size() != 1) {
+          ss << "s";
+        }
+        ss << ": [";
+        for (int i = 0; i < plugins.size(); i++) {
+          py::object nestedPlugin = py::cast(plugins[i]);
+          ss << nestedPlugin.attr("__repr__")();
+          if (i < plugins.size() - 1) {
+            ss << ", ";
+          }
+        }
+        ss << "] at " << &plugin << ">";
+        return ss.str();
+      });
+}
+
+} // namespace Pedalboard
@@ -76,6 +76,7 @@ public:
         throw std::runtime_error("Failed to initialize GSM decoder.");
       }
 
+      frames.resize(spec.maximumBlockSize);
       lastSpec = spec;
     }
   }
@@ -83,11 +84,12 @@ public:
   int process(
       const juce::dsp::ProcessContextReplacing<float> &context) override final {
     auto ioBlock = context.getOutputBlock();
+    const int numSamples = (int)ioBlock.getNumSamples();
 
-    if (ioBlock.getNumSamples() != GSM_FRAME_SIZE_SAMPLES) {
-      throw std::runtime_error("GSMCompressor plugin must be passed exactly " +
-                               std::to_string(GSM_FRAME_SIZE_SAMPLES) +
-                               " at a time.");
+    if (numSamples % GSM_FRAME_SIZE_SAMPLES != 0) {
+      throw std::runtime_error(
+          "GSMCompressor plugin must be passed a multiple of " +
+          std::to_string(GSM_FRAME_SIZE_SAMPLES) + " samples at a time.");
     }
 
     if (ioBlock.getNumChannels() != 1) {
@@ -95,26 +97,30 @@ public:
           "GSMCompressor plugin must be passed mono input!");
     }
 
-    // Convert samples to signed 16-bit integer first,
-    // then pass to the GSM Encoder, then immediately back
-    // around to the GSM decoder.
-    short frame[GSM_FRAME_SIZE_SAMPLES];
+    if ((int)frames.size() < numSamples)
+      frames.resize(numSamples);
 
+    // Convert all of the frames to signed 16-bit integer at once,
+    // then pass each frame to the GSM Encoder, then immediately back
+    // around to the GSM decoder.
     juce::AudioDataConverters::convertFloatToInt16LE(
-        ioBlock.getChannelPointer(0), frame, GSM_FRAME_SIZE_SAMPLES);
-
-    // Actually do the GSM processing!
-    gsm_frame encodedFrame;
-
-    gsm_encode(encoder.getContext(), frame, encodedFrame);
-    if (gsm_decode(decoder.getContext(), encodedFrame, frame) < 0) {
-      throw std::runtime_error("GSM decoder could not decode frame!");
+        ioBlock.getChannelPointer(0), frames.data(), numSamples);
+
+    gsm encoderContext = encoder.getContext();
+    gsm decoderContext = decoder.getContext();
+    for (int i = 0; i < numSamples; i += GSM_FRAME_SIZE_SAMPLES) {
+      // Actually do the GSM processing!
+      gsm_frame encodedFrame;
+      gsm_encode(encoderContext, frames.data() + i, encodedFrame);
+      if (gsm_decode(decoderContext, encodedFrame, frames.data() + i) < 0) {
+        throw std::runtime_error("GSM decoder could not decode frame!");
+      }
     }
 
     juce::AudioDataConverters::convertInt16LEToFloat(
-        frame, ioBlock.getChannelPointer(0), GSM_FRAME_SIZE_SAMPLES);
+        frames.data(), ioBlock.getChannelPointer(0), numSamples);
 
-    return GSM_FRAME_SIZE_SAMPLES;
+    return numSamples;
   }
 
   void reset() override final {
@@ -125,14 +131,22 @@ public:
   static constexpr size_t GSM_FRAME_SIZE_SAMPLES = 160;
   static constexpr int GSM_SAMPLE_RATE = 8000;
 
+  // The number of frames to encode and decode in each call to process(), to
+  // amortize the cost of each call through the plugin templates wrapping this
+  // one. (GSM frames are independent of how they're grouped into blocks, so
+  // this has no effect on the output.)
+  static constexpr size_t GSM_FRAMES_PER_BLOCK = 4;
+
 private:
   GSMWrapper encoder;
   GSMWrapper decoder;
+  std::vector<short> frames;
 };
 
 /**
  * Use the GSMFullRateCompressorInternal plugin, but:
- *  - ensure that it only ever sees fixed-size blocks of 160 samples
+ *  - ensure that it only ever sees fixed-size blocks of several 160-sample
+ *    frames
  *  - prime the input with a single block of silence
  *  - resample whatever input sample rate is provided down to 8kHz
  *  - only provide mono input to the plugin, and copy the mono signal
@@ -140,11 +154,20 @@ private:
  */
 using GSMFullRateCompressor = ForceMono<Resample<
     PrimeWithSilence<
-        FixedBlockSize<GSMFullRateCompressorInternal,
-                       GSMFullRateCompressorInternal::GSM_FRAME_SIZE_SAMPLES>,
+        FixedBlockSize<
+            GSMFullRateCompressorInternal,
+            GSMFullRateCompressorInternal::GSM_FRAME_SIZE_SAMPLES *
+                GSMFullRateCompressorInternal::GSM_FRAMES_PER_BLOCK>,
         float, GSMFullRateCompressorInternal::GSM_FRAME_SIZE_SAMPLES>,
     float, GSMFullRateCompressorInternal::GSM_SAMPLE_RATE>>;
 
+// The GSM codec itself has no settings, so only the resampler's need copying:
+template <> inline std::shared_ptr<Plugin> GSMFullRateCompressor::clone() {
+  auto plugin = std::make_shared<GSMFullRateCompressor>();
+  plugin->getNestedPlugin().setQuality(getNestedPlugin().getQuality());
+  return plugin;
+}
+
 inline void init_gsm_full_rate_compressor(py::module &m) {
   py::class_<GSMFullRateCompressor, Plugin,
              std::shared_ptr<GSMFullRateCompressor>>(
@@ -154,7 +177,10 @@ inline void init_gsm_full_rate_compressor(py::module &m) {
       "2G cellular phone connection. This plugin internally resamples the "
       "input audio to a fixed sample rate of 8kHz (required by the GSM Full "
       "Rate codec), although the quality of the resampling algorithm "
-      "can be specified.")
+      "can be specified.\n\nFor processing large amounts of audio, "
+      "``quality=Resample.Quality.Polyphase`` is usually several times "
+      "faster than the default ``WindowedSinc`` quality, with very "
+      "similar output.")
       .def(py::init([](ResamplingQuality quality) {
              auto plugin = std::make_unique<GSMFullRateCompressor>();
              plugin->getNestedPlugin().setQuality(quality);
@@ -20,12 +20,55 @@
 
 namespace py = pybind11;
 
+#include "../Automation.h"
 #include "../JucePlugin.h"
+#include "../simd/Dispatch.h"
 
 namespace Pedalboard {
 template <typename SampleType>
 class Gain : public JucePlugin<juce::dsp::Gain<SampleType>> {
   DEFINE_DSP_SETTER_AND_GETTER(SampleType, GainDecibels, {});
+
+public:
+  int process(
+      const juce::dsp::ProcessContextReplacing<float> &context) override {
+    return processSamples(context);
+  }
+
+  int process(
+      const juce::dsp::ProcessContextReplacing<double> &context) override {
+    return processSamples(context);
+  }
+
+  bool isTileable() override { return true; }
+  int getTailLengthSamples() override { return 0; }
+
+  std::shared_ptr<Plugin> clone() override {
+    auto plugin = std::make_shared<Gain<SampleType>>();
+    plugin->setGainDecibels(getGainDecibels());
+    return plugin;
+  }
+
+private:
+  template <typename T>
+  int processSamples(const juce::dsp::ProcessContextReplacing<T> &context) {
+    // juce::dsp::Gain only ramps between values if given a ramp duration,
+    // which we never do, so applying its gain directly is equivalent:
+    auto block = context.getOutputBlock();
+    const T gain = static_cast<T>(this->getDSP().getGainLinear());
+    for (size_t c = 0; c < block.getNumChannels(); c++) {
+      multiply(block.getChannelPointer(c), (int)block.getNumSamples(), gain);
+    }
+    return block.getNumSamples();
+  }
+
+  static void multiply(float *samples, int numSamples, float gain) {
+    simd::getKernels().multiplyFloat(samples, numSamples, gain);
+  }
+
+  static void multiply(double *samples, int numSamples, double gain) {
+    simd::getKernels().multiplyDouble(samples, numSamples, gain);
+  }
 };
 
 inline void init_gain(py::module &m) {
@@ -52,5 +95,8 @@ inline void init_gain(py::module &m) {
            })
       .def_property("gain_db", &Gain<float>::getGainDecibels,
                     &Gain<float>::setGainDecibels);
+
+  registerAutomatableParameter<Gain<float>>(
+      "gain_db", &Gain<float>::getGainDecibels, &Gain<float>::setGainDecibels);
 }
 }; // namespace Pedalboard
\ No newline at end of file
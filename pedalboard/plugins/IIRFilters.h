@@ -15,11 +15,14 @@
  * limitations under the License.
  */
 
+#pragma once
+
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
 namespace py = pybind11;
 
+#include "../Automation.h"
 #include "../JucePlugin.h"
 
 namespace Pedalboard {
@@ -73,6 +76,12 @@ public:
     }
   }
 
+  bool isTileable() override { return true; }
+
+  int getTailLengthSamples() override {
+    return Pedalboard::getTailLengthSamples(*this->getDSP().state);
+  }
+
 protected:
   float cutoffFrequencyHz;
   float Q;
@@ -91,6 +100,14 @@ public:
 
     IIRFilter<SampleType>::prepare(spec);
   }
+
+  std::shared_ptr<Plugin> clone() override {
+    auto plugin = std::make_shared<HighShelfFilter<SampleType>>();
+    plugin->setCutoffFrequencyHz(this->getCutoffFrequencyHz());
+    plugin->setGainDecibels(this->getGainDecibels());
+    plugin->setQ(this->getQ());
+    return plugin;
+  }
 };
 
 template <typename SampleType>
@@ -105,6 +122,14 @@ public:
 
     IIRFilter<SampleType>::prepare(spec);
   }
+
+  std::shared_ptr<Plugin> clone() override {
+    auto plugin = std::make_shared<LowShelfFilter<SampleType>>();
+    plugin->setCutoffFrequencyHz(this->getCutoffFrequencyHz());
+    plugin->setGainDecibels(this->getGainDecibels());
+    plugin->setQ(this->getQ());
+    return plugin;
+  }
 };
 
 template <typename SampleType> class PeakFilter : public IIRFilter<SampleType> {
@@ -117,6 +142,14 @@ public:
             this->Q, this->gainFactor);
     IIRFilter<SampleType>::prepare(spec);
   }
+
+  std::shared_ptr<Plugin> clone() override {
+    auto plugin = std::make_shared<PeakFilter<SampleType>>();
+    plugin->setCutoffFrequencyHz(this->getCutoffFrequencyHz());
+    plugin->setGainDecibels(this->getGainDecibels());
+    plugin->setQ(this->getQ());
+    return plugin;
+  }
 };
 
 inline void init_iir_filters(py::module &m) {
@@ -233,5 +266,30 @@ inline void init_iir_filters(py::module &m) {
       .def_property("gain_db", &PeakFilter<float>::getGainDecibels,
                     &PeakFilter<float>::setGainDecibels)
       .def_property("q", &PeakFilter<float>::getQ, &PeakFilter<float>::setQ);
+
+  registerAutomatableParameter<HighShelfFilter<float>>(
+      "cutoff_frequency_hz", &HighShelfFilter<float>::getCutoffFrequencyHz,
+      &HighShelfFilter<float>::setCutoffFrequencyHz);
+  registerAutomatableParameter<HighShelfFilter<float>>(
+      "gain_db", &HighShelfFilter<float>::getGainDecibels,
+      &HighShelfFilter<float>::setGainDecibels);
+  registerAutomatableParameter<HighShelfFilter<float>>(
+      "q", &HighShelfFilter<float>::getQ, &HighShelfFilter<float>::setQ);
+  registerAutomatableParameter<LowShelfFilter<float>>(
+      "cutoff_frequency_hz", &LowShelfFilter<float>::getCutoffFrequencyHz,
+      &LowShelfFilter<float>::setCutoffFrequencyHz);
+  registerAutomatableParameter<LowShelfFilter<float>>(
+      "gain_db", &LowShelfFilter<float>::getGainDecibels,
+      &LowShelfFilter<float>::setGainDecibels);
+  registerAutomatableParameter<LowShelfFilter<float>>(
+      "q", &LowShelfFilter<float>::getQ, &LowShelfFilter<float>::setQ);
+  registerAutomatableParameter<PeakFilter<float>>(
+      "cutoff_frequency_hz", &PeakFilter<float>::getCutoffFrequencyHz,
+      &PeakFilter<float>::setCutoffFrequencyHz);
+  registerAutomatableParameter<PeakFilter<float>>(
+      "gain_db", &PeakFilter<float>::getGainDecibels,
+      &PeakFilter<float>::setGainDecibels);
+  registerAutomatableParameter<PeakFilter<float>>("q", &PeakFilter<float>::getQ,
+                                                  &PeakFilter<float>::setQ);
 }
 }; // namespace Pedalboard
@@ -25,12 +25,23 @@ namespace py = pybind11;
 namespace Pedalboard {
 template <typename SampleType> class Invert : public Plugin {
   virtual void prepare(const juce::dsp::ProcessSpec &spec) override {}
-  int process(const juce::dsp::ProcessContextReplacing<SampleType> &context)
+  int process(const juce::dsp::ProcessContextReplacing<float> &context)
+      override final {
+    context.getOutputBlock().negate();
+    return context.getOutputBlock().getNumSamples();
+  }
+  int process(const juce::dsp::ProcessContextReplacing<double> &context)
       override final {
     context.getOutputBlock().negate();
     return context.getOutputBlock().getNumSamples();
   }
   void reset() noexcept override {}
+  bool isTileable() override { return true; }
+  int getTailLengthSamples() override { return 0; }
+
+  std::shared_ptr<Plugin> clone() override {
+    return std::make_shared<Invert<SampleType>>();
+  }
 };
 
 inline void init_invert(py::module &m) {
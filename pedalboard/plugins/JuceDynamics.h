@@ -0,0 +1,94 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <pybind11/pybind11.h>
+
+namespace py = pybind11;
+
+#include "../JucePlugin.h"
+
+namespace Pedalboard {
+
+/**
+ * The original JUCE implementations of Compressor, NoiseGate and Limiter,
+ * which the public plugins replaced with the block-wise implementations in
+ * DynamicsProcessors.h. These are kept (in the _internal module) only to
+ * verify that the two produce the same output, and to benchmark one against
+ * the other.
+ */
+class JuceCompressor : public JucePlugin<juce::dsp::Compressor<float>> {
+  DEFINE_DSP_SETTER_AND_GETTER(float, Threshold, {});
+  DEFINE_DSP_SETTER_AND_GETTER(float, Ratio, {});
+  DEFINE_DSP_SETTER_AND_GETTER(float, Attack, {});
+  DEFINE_DSP_SETTER_AND_GETTER(float, Release, {});
+};
+
+class JuceNoiseGate : public JucePlugin<juce::dsp::NoiseGate<float>> {
+  DEFINE_DSP_SETTER_AND_GETTER(float, Threshold, {});
+  DEFINE_DSP_SETTER_AND_GETTER(float, Ratio, {});
+  DEFINE_DSP_SETTER_AND_GETTER(float, Attack, {});
+  DEFINE_DSP_SETTER_AND_GETTER(float, Release, {});
+};
+
+class JuceLimiter : public JucePlugin<juce::dsp::Limiter<float>> {
+  DEFINE_DSP_SETTER_AND_GETTER(float, Threshold, {});
+  DEFINE_DSP_SETTER_AND_GETTER(float, Release, {});
+};
+
+inline void init_juce_dynamics_test_plugins(py::module &m) {
+  py::class_<JuceCompressor, Plugin, std::shared_ptr<JuceCompressor>>(
+      m, "JuceCompressor")
+      .def(py::init([](float thresholddB, float ratio, float attackMs,
+                       float releaseMs) {
+             auto plugin = std::make_unique<JuceCompressor>();
+             plugin->setThreshold(thresholddB);
+             plugin->setRatio(ratio);
+             plugin->setAttack(attackMs);
+             plugin->setRelease(releaseMs);
+             return plugin;
+           }),
+           py::arg("threshold_db") = 0, py::arg("ratio") = 1,
+           py::arg("attack_ms") = 1.0, py::arg("release_ms") = 100);
+
+  py::class_<JuceNoiseGate, Plugin, std::shared_ptr<JuceNoiseGate>>(
+      m, "JuceNoiseGate")
+      .def(py::init([](float thresholddB, float ratio, float attackMs,
+                       float releaseMs) {
+             auto plugin = std::make_unique<JuceNoiseGate>();
+             plugin->setThreshold(thresholddB);
+             plugin->setRatio(ratio);
+             plugin->setAttack(attackMs);
+             plugin->setRelease(releaseMs);
+             return plugin;
+           }),
+           py::arg("threshold_db") = -100.0, py::arg("ratio") = 10,
+           py::arg("attack_ms") = 1.0, py::arg("release_ms") = 100.0);
+
+  py::class_<JuceLimiter, Plugin, std::shared_ptr<JuceLimiter>>(m,
+                                                                "JuceLimiter")
+      .def(py::init([](float thresholdDb, float releaseMs) {
+             auto plugin = std::make_unique<JuceLimiter>();
+             plugin->setThreshold(thresholdDb);
+             plugin->setRelease(releaseMs);
+             return plugin;
+           }),
+           py::arg("threshold_db") = -10.0, py::arg("release_ms") = 100.0);
+}
+
+} // namespace Pedalboard
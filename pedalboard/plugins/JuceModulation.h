@@ -0,0 +1,82 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <pybind11/pybind11.h>
+
+namespace py = pybind11;
+
+#include "../JucePlugin.h"
+
+namespace Pedalboard {
+
+/**
+ * The original JUCE implementations of Chorus and Phaser, which the public
+ * plugins replaced with the block-based implementations in
+ * ModulationProcessors.h. Like the plugins in JuceDynamics.h, these are
+ * only kept to test and benchmark the new implementations against.
+ */
+class JuceChorus : public JucePlugin<juce::dsp::Chorus<float>> {
+  DEFINE_DSP_SETTER_AND_GETTER(float, Rate, {});
+  DEFINE_DSP_SETTER_AND_GETTER(float, Depth, {});
+  DEFINE_DSP_SETTER_AND_GETTER(float, CentreDelay, {});
+  DEFINE_DSP_SETTER_AND_GETTER(float, Feedback, {});
+  DEFINE_DSP_SETTER_AND_GETTER(float, Mix, {});
+};
+
+class JucePhaser : public JucePlugin<juce::dsp::Phaser<float>> {
+  DEFINE_DSP_SETTER_AND_GETTER(float, Rate, {});
+  DEFINE_DSP_SETTER_AND_GETTER(float, Depth, {});
+  DEFINE_DSP_SETTER_AND_GETTER(float, CentreFrequency, {});
+  DEFINE_DSP_SETTER_AND_GETTER(float, Feedback, {});
+  DEFINE_DSP_SETTER_AND_GETTER(float, Mix, {});
+};
+
+inline void init_juce_modulation_test_plugins(py::module &m) {
+  py::class_<JuceChorus, Plugin, std::shared_ptr<JuceChorus>>(m, "JuceChorus")
+      .def(py::init([](float rateHz, float depth, float centreDelayMs,
+                       float feedback, float mix) {
+             auto plugin = std::make_unique<JuceChorus>();
+             plugin->setRate(rateHz);
+             plugin->setDepth(depth);
+             plugin->setCentreDelay(centreDelayMs);
+             plugin->setFeedback(feedback);
+             plugin->setMix(mix);
+             return plugin;
+           }),
+           py::arg("rate_hz") = 1.0, py::arg("depth") = 0.25,
+           py::arg("centre_delay_ms") = 7.0, py::arg("feedback") = 0.0,
+           py::arg("mix") = 0.5);
+
+  py::class_<JucePhaser, Plugin, std::shared_ptr<JucePhaser>>(m, "JucePhaser")
+      .def(py::init([](float rateHz, float depth, float centreFrequency,
+                       float feedback, float mix) {
+             auto plugin = std::make_unique<JucePhaser>();
+             plugin->setRate(rateHz);
+             plugin->setDepth(depth);
+             plugin->setCentreFrequency(centreFrequency);
+             plugin->setFeedback(feedback);
+             plugin->setMix(mix);
+             return plugin;
+           }),
+           py::arg("rate_hz") = 1.0, py::arg("depth") = 0.5,
+           py::arg("centre_frequency_hz") = 1300.0, py::arg("feedback") = 0.0,
+           py::arg("mix") = 0.5);
+}
+
+} // namespace Pedalboard
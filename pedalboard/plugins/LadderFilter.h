@@ -20,6 +20,7 @@
 
 namespace py = pybind11;
 
+#include "../Automation.h"
 #include "../JucePlugin.h"
 
 namespace Pedalboard {
@@ -55,6 +56,15 @@ class LadderFilter : public JucePlugin<juce::dsp::LadderFilter<SampleType>> {
                              "BPF12, LPF24, HPF24, or BPF24.");
     }
   });
+
+  std::shared_ptr<Plugin> clone() override {
+    auto plugin = std::make_shared<LadderFilter<SampleType>>();
+    plugin->setMode(getMode());
+    plugin->setCutoffFrequencyHz(getCutoffFrequencyHz());
+    plugin->setResonance(getResonance());
+    plugin->setDrive(getDrive());
+    return plugin;
+  }
 };
 
 inline void init_ladderfilter(py::module &m) {
@@ -150,5 +160,14 @@ inline void init_ladderfilter(py::module &m) {
       .def_property("drive", &LadderFilter<float>::getDrive,
                     &LadderFilter<float>::setDrive);
   ;
+
+  registerAutomatableParameter<LadderFilter<float>>(
+      "cutoff_hz", &LadderFilter<float>::getCutoffFrequencyHz,
+      &LadderFilter<float>::setCutoffFrequencyHz);
+  registerAutomatableParameter<LadderFilter<float>>(
+      "resonance", &LadderFilter<float>::getResonance,
+      &LadderFilter<float>::setResonance);
+  registerAutomatableParameter<LadderFilter<float>>(
+      "drive", &LadderFilter<float>::getDrive, &LadderFilter<float>::setDrive);
 }
 }; // namespace Pedalboard
\ No newline at end of file
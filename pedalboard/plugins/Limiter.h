@@ -20,13 +20,36 @@
 
 namespace py = pybind11;
 
+#include "../Automation.h"
 #include "../JucePlugin.h"
+#include "../plugin_templates/DynamicsProcessors.h"
 
 namespace Pedalboard {
 template <typename SampleType>
-class Limiter : public JucePlugin<juce::dsp::Limiter<SampleType>> {
+class Limiter : public JucePlugin<DynamicsLimiter<SampleType>> {
   DEFINE_DSP_SETTER_AND_GETTER(SampleType, Threshold, {});
   DEFINE_DSP_SETTER_AND_GETTER(SampleType, Release, {});
+  DEFINE_DSP_SETTER_AND_GETTER(bool, Linked, {});
+
+  bool isTileable() override { return true; }
+
+  // The time taken for the envelopes of both of the limiter's compressors
+  // to release (the first of which has a fixed release time of 200ms):
+  int getTailLengthSamples() override {
+    return Plugin::getDecaySamples(
+        std::exp(-2.0 * juce::MathConstants<double>::pi * 1000.0 /
+                 (this->lastSpec.sampleRate *
+                  std::max<double>(200.0, getRelease()))),
+        1);
+  }
+
+  std::shared_ptr<Plugin> clone() override {
+    auto plugin = std::make_shared<Limiter<SampleType>>();
+    plugin->setThreshold(getThreshold());
+    plugin->setRelease(getRelease());
+    plugin->setLinked(getLinked());
+    return plugin;
+  }
 };
 
 inline void init_limiter(py::module &m) {
@@ -34,19 +57,22 @@ inline void init_limiter(py::module &m) {
       m, "Limiter",
       "A simple limiter with standard threshold and release time controls, "
       "featuring two compressors and a hard clipper at 0 dB.")
-      .def(py::init([](float thresholdDb, float releaseMs) {
+      .def(py::init([](float thresholdDb, float releaseMs, bool linked) {
              auto plugin = std::make_unique<Limiter<float>>();
              plugin->setThreshold(thresholdDb);
              plugin->setRelease(releaseMs);
+             plugin->setLinked(linked);
              return plugin;
            }),
-           py::arg("threshold_db") = -10.0, py::arg("release_ms") = 100.0)
+           py::arg("threshold_db") = -10.0, py::arg("release_ms") = 100.0,
+           py::arg("linked") = false)
       .def("__repr__",
            [](const Limiter<float> &plugin) {
              std::ostringstream ss;
              ss << "<pedalboard.Limiter";
              ss << " threshold_db=" << plugin.getThreshold();
              ss << " release_ms=" << plugin.getRelease();
+             ss << " linked=" << (plugin.getLinked() ? "True" : "False");
              ss << " at " << &plugin;
              ss << ">";
              return ss.str();
@@ -54,6 +80,19 @@ inline void init_limiter(py::module &m) {
       .def_property("threshold_db", &Limiter<float>::getThreshold,
                     &Limiter<float>::setThreshold)
       .def_property("release_ms", &Limiter<float>::getRelease,
-                    &Limiter<float>::setRelease);
+                    &Limiter<float>::setRelease)
+      .def_property("linked", &Limiter<float>::getLinked,
+                    &Limiter<float>::setLinked,
+                    "If ``True``, the limiter is driven by the loudest "
+                    "channel and applies the same gain to every channel, "
+                    "preserving the stereo image. If ``False`` (the default), "
+                    "each channel is processed independently."
+                    "\n\n*Introduced in v0.9.0.*");
+
+  registerAutomatableParameter<Limiter<float>>(
+      "threshold_db", &Limiter<float>::getThreshold,
+      &Limiter<float>::setThreshold);
+  registerAutomatableParameter<Limiter<float>>(
+      "release_ms", &Limiter<float>::getRelease, &Limiter<float>::setRelease);
 }
 }; // namespace Pedalboard
\ No newline at end of file
@@ -0,0 +1,479 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <pybind11/pybind11.h>
+
+namespace py = pybind11;
+
+#include "../Plugin.h"
+#include "../ScratchBuffers.h"
+#include "../plugin_templates/BiquadCascade.h"
+
+namespace Pedalboard {
+
+/**
+ * A plugin that passes audio through unchanged, while measuring its loudness
+ * as specified by ITU-R BS.1770-4 and EBU R128: integrated, momentary and
+ * short-term loudness (in LUFS), and true peak level (in dBTP).
+ *
+ * Audio is K-weighted with a BiquadCascade, and the mean square of each
+ * channel is accumulated over 100ms steps; each gating block (400ms, with 75%
+ * overlap) is made of four consecutive steps. Rather than storing the
+ * loudness of every gating block to compute integrated loudness, blocks are
+ * counted in a fixed-size histogram of loudness values (each bin of which
+ * also keeps the total energy of its blocks), so memory usage is constant
+ * regardless of how much audio is measured.
+ *
+ * True peak is measured by 4x oversampling with a polyphase windowed-sinc
+ * interpolator.
+ */
+class LoudnessMeter : public Plugin {
+public:
+  LoudnessMeter() { reset(); }
+  virtual ~LoudnessMeter(){};
+
+  virtual void prepare(const juce::dsp::ProcessSpec &spec) override {
+    if (lastSpec.sampleRate != spec.sampleRate ||
+        lastSpec.numChannels != spec.numChannels) {
+      lastSpec = spec;
+      reset();
+    }
+  }
+
+  virtual void reset() override {
+    int numChannels = (int)lastSpec.numChannels;
+
+    weighting.prepare(numChannels, 2);
+    if (lastSpec.sampleRate > 0) {
+      weighting.setCoefficients(0, makeHighShelfCoefficients());
+      weighting.setCoefficients(1, makeHighPassCoefficients());
+    }
+    weighting.reset();
+
+    stepSamples = std::max(1, (int)std::round(lastSpec.sampleRate *
+                                              GATING_STEP_SECONDS));
+    samplesInStep = 0;
+    stepEnergy.assign(numChannels, 0.0);
+    recentStepEnergies.fill(0.0);
+    numStepsMeasured = 0;
+
+    histogramCounts.assign(HISTOGRAM_NUM_BINS, 0);
+    histogramEnergies.assign(HISTOGRAM_NUM_BINS, 0.0);
+
+    momentaryEnergy = shortTermEnergy = 0;
+    maxMomentaryEnergy = maxShortTermEnergy = 0;
+
+    truePeakHistory.assign(numChannels,
+                           std::vector<float>(TRUE_PEAK_TAPS_PER_PHASE - 1));
+    truePeak = 0;
+    makeTruePeakFilters();
+  }
+
+  virtual int
+  process(const juce::dsp::ProcessContextReplacing<float> &context) override {
+    return measure(context);
+  }
+
+  virtual int
+  process(const juce::dsp::ProcessContextReplacing<double> &context) override {
+    return measure(context);
+  }
+
+  // Note: getTailLengthSamples() is deliberately left unknown, so that this
+  // plugin is never skipped on silent input (which would stop time passing).
+  bool isTileable() override { return true; }
+
+  std::shared_ptr<Plugin> clone() override {
+    return std::make_shared<LoudnessMeter>();
+  }
+
+  double getIntegratedLoudness() const {
+    // Absolute gating (at -70 LUFS) is done by only counting blocks above
+    // that level in the histogram. Then, gate relative to the mean of those:
+    double absoluteGatedEnergy = getMeanEnergyOfBinsFrom(0);
+    if (absoluteGatedEnergy <= 0)
+      return -std::numeric_limits<double>::infinity();
+
+    double relativeThreshold =
+        energyToLoudness(absoluteGatedEnergy) + RELATIVE_GATE_LU;
+    int firstBin =
+        std::max(0, (int)std::ceil(getBinPosition(relativeThreshold)));
+    return energyToLoudness(getMeanEnergyOfBinsFrom(firstBin));
+  }
+
+  double getMomentaryLoudness() const {
+    return energyToLoudness(momentaryEnergy);
+  }
+  double getShortTermLoudness() const {
+    return energyToLoudness(shortTermEnergy);
+  }
+  double getMaxMomentaryLoudness() const {
+    return energyToLoudness(maxMomentaryEnergy);
+  }
+  double getMaxShortTermLoudness() const {
+    return energyToLoudness(maxShortTermEnergy);
+  }
+
+  double getTruePeak() const {
+    return truePeak > 0 ? 20.0 * std::log10(truePeak)
+                        : -std::numeric_limits<double>::infinity();
+  }
+
+private:
+  template <typename SampleType>
+  int measure(const juce::dsp::ProcessContextReplacing<SampleType> &context) {
+    juce::ScopedNoDenormals noDenormals;
+
+    auto ioBlock = context.getOutputBlock();
+    int numChannels = (int)ioBlock.getNumChannels();
+    int numSamples = (int)ioBlock.getNumSamples();
+    if (numChannels != (int)lastSpec.numChannels) {
+      throw std::runtime_error(
+          "LoudnessMeter was prepared for a different number of channels "
+          "than it was given. This is an internal Pedalboard error and "
+          "should be reported.");
+    }
+
+    // One channel of K-weighted audio per input channel, followed by two
+    // channels of scratch space for true peak measurement:
+    auto scratch = ScratchBuffers<float>::acquire(
+        numChannels + 2, numSamples + TRUE_PEAK_TAPS_PER_PHASE - 1);
+    float **weighted = (float **)alloca(numChannels * sizeof(float *));
+    for (int c = 0; c < numChannels; c++) {
+      const SampleType *input = ioBlock.getChannelPointer(c);
+      weighted[c] = scratch->getWritePointer(c);
+      std::copy(input, input + numSamples, weighted[c]);
+      measureTruePeak(c, weighted[c], numSamples,
+                      scratch->getWritePointer(numChannels),
+                      scratch->getWritePointer(numChannels + 1));
+    }
+
+    weighting.process(weighted, numSamples);
+
+    for (int i = 0; i < numSamples;) {
+      int samplesToAccumulate =
+          std::min(numSamples - i, stepSamples - samplesInStep);
+      for (int c = 0; c < numChannels; c++) {
+        const float *samples = weighted[c] + i;
+        double sumOfSquares = 0;
+        for (int j = 0; j < samplesToAccumulate; j++)
+          sumOfSquares += (double)samples[j] * samples[j];
+        stepEnergy[c] += sumOfSquares;
+      }
+
+      i += samplesToAccumulate;
+      samplesInStep += samplesToAccumulate;
+      if (samplesInStep == stepSamples)
+        finishStep();
+    }
+
+    return numSamples;
+  }
+
+  /**
+   * Record the channel-weighted mean square of the last step, then update
+   * the momentary (last 4 steps) and short-term (last 30 steps) loudness.
+   */
+  void finishStep() {
+    int numChannels = (int)stepEnergy.size();
+    double energy = 0;
+    for (int c = 0; c < numChannels; c++) {
+      energy += getChannelWeight(c, numChannels) * stepEnergy[c];
+      stepEnergy[c] = 0;
+    }
+    energy /= stepSamples;
+    samplesInStep = 0;
+
+    recentStepEnergies[numStepsMeasured % SHORT_TERM_STEPS] = energy;
+    numStepsMeasured++;
+
+    if (numStepsMeasured >= MOMENTARY_STEPS) {
+      momentaryEnergy = getMeanOfRecentSteps(MOMENTARY_STEPS);
+      maxMomentaryEnergy = std::max(maxMomentaryEnergy, momentaryEnergy);
+
+      // Each momentary block is also a gating block for integrated loudness:
+      double binPosition = getBinPosition(energyToLoudness(momentaryEnergy));
+      if (binPosition >= 0) {
+        int bin = std::min(HISTOGRAM_NUM_BINS - 1, (int)binPosition);
+        histogramCounts[bin]++;
+        histogramEnergies[bin] += momentaryEnergy;
+      }
+    }
+
+    if (numStepsMeasured >= SHORT_TERM_STEPS) {
+      shortTermEnergy = getMeanOfRecentSteps(SHORT_TERM_STEPS);
+      maxShortTermEnergy = std::max(maxShortTermEnergy, shortTermEnergy);
+    }
+  }
+
+  double getMeanOfRecentSteps(int numSteps) const {
+    double sum = 0;
+    for (int i = 1; i <= numSteps; i++)
+      sum += recentStepEnergies[(numStepsMeasured - i) % SHORT_TERM_STEPS];
+    return sum / numSteps;
+  }
+
+  double getMeanEnergyOfBinsFrom(int firstBin) const {
+    long long count = 0;
+    double energy = 0;
+    for (int bin = firstBin; bin < HISTOGRAM_NUM_BINS; bin++) {
+      count += histogramCounts[bin];
+      energy += histogramEnergies[bin];
+    }
+    return count ? energy / count : 0;
+  }
+
+  /**
+   * Find the maximum absolute value of the given samples (the next
+   * numSamples of channel c) and of three interpolated values between each
+   * pair of them. The two scratch arrays must each have room for
+   * numSamples + TRUE_PEAK_TAPS_PER_PHASE - 1 samples.
+   */
+  void measureTruePeak(int c, const float *samples, int numSamples,
+                       float *history, float *interpolated) {
+    // As the interpolator's first phase is a pure delay, the samples
+    // themselves are also its output:
+    auto range =
+        juce::FloatVectorOperations::findMinAndMax(samples, numSamples);
+    truePeak = std::max(truePeak, (double)std::max(-range.getStart(),
+                                                   range.getEnd()));
+
+    // Put the last few samples from the previous call in front of this call's
+    // samples, so that each output only needs one contiguous input:
+    const int historySize = TRUE_PEAK_TAPS_PER_PHASE - 1;
+    std::copy(truePeakHistory[c].begin(), truePeakHistory[c].end(), history);
+    std::copy(samples, samples + numSamples, history + historySize);
+    std::copy(history + numSamples, history + numSamples + historySize,
+              truePeakHistory[c].begin());
+
+    for (int phase = 1; phase < TRUE_PEAK_OVERSAMPLING; phase++) {
+      juce::FloatVectorOperations::clear(interpolated, numSamples);
+      for (int tap = 0; tap < TRUE_PEAK_TAPS_PER_PHASE; tap++) {
+        juce::FloatVectorOperations::addWithMultiply(
+            interpolated, history + tap, truePeakFilters[phase][tap],
+            numSamples);
+      }
+      range = juce::FloatVectorOperations::findMinAndMax(interpolated,
+                                                         numSamples);
+      truePeak = std::max(truePeak, (double)std::max(-range.getStart(),
+                                                     range.getEnd()));
+    }
+  }
+
+  /**
+   * Compute the filter for each phase of the true peak interpolator, in the
+   * order in which they're applied to the input history (oldest first).
+   */
+  void makeTruePeakFilters() {
+    const double pi = juce::MathConstants<double>::pi;
+    const int center = TRUE_PEAK_OVERSAMPLING * (TRUE_PEAK_TAPS_PER_PHASE / 2);
+
+    for (int phase = 0; phase < TRUE_PEAK_OVERSAMPLING; phase++) {
+      for (int tap = 0; tap < TRUE_PEAK_TAPS_PER_PHASE; tap++) {
+        int n = phase + TRUE_PEAK_OVERSAMPLING * tap;
+        double x = (double)(n - center) / TRUE_PEAK_OVERSAMPLING;
+        double sinc = x == 0 ? 1.0 : std::sin(pi * x) / (pi * x);
+        double r = (double)(n - center) / center;
+        double window = besselI0(TRUE_PEAK_KAISER_BETA *
+                                 std::sqrt(std::max(0.0, 1 - r * r))) /
+                        besselI0(TRUE_PEAK_KAISER_BETA);
+        truePeakFilters[phase][TRUE_PEAK_TAPS_PER_PHASE - 1 - tap] =
+            (float)(sinc * window);
+      }
+    }
+  }
+
+  static double besselI0(double x) {
+    double sum = 1, term = 1;
+    for (int k = 1; k < 50; k++) {
+      term *= (x / (2 * k)) * (x / (2 * k));
+      sum += term;
+    }
+    return sum;
+  }
+
+  /**
+   * The weight of each channel when summing their energies. Five-channel
+   * audio is assumed to be laid out as L, R, C, Ls, Rs and six-channel audio
+   * as L, R, C, LFE, Ls, Rs (with the LFE channel ignored); all channels are
+   * weighted equally for all other layouts.
+   */
+  static double getChannelWeight(int channel, int numChannels) {
+    if (numChannels == 5 && channel >= 3)
+      return SURROUND_CHANNEL_WEIGHT;
+    if (numChannels == 6 && channel == 3)
+      return 0;
+    if (numChannels == 6 && channel >= 4)
+      return SURROUND_CHANNEL_WEIGHT;
+    return 1;
+  }
+
+  static double energyToLoudness(double energy) {
+    return energy > 0 ? LOUDNESS_OFFSET + 10.0 * std::log10(energy)
+                      : -std::numeric_limits<double>::infinity();
+  }
+
+  static double getBinPosition(double loudness) {
+    return (loudness - ABSOLUTE_GATE_LUFS) * HISTOGRAM_BINS_PER_LU;
+  }
+
+  /**
+   * The first stage of the K-weighting filter, which models the acoustic
+   * effect of the head. (The analog prototype from BS.1770 is re-derived for
+   * each sample rate, so that sample rates other than 48kHz are supported.)
+   */
+  BiquadCascade::Coefficients makeHighShelfCoefficients() const {
+    const double f0 = 1681.974450955533, gainDb = 3.999843853973347,
+                 q = 0.7071752369554196;
+    double k = std::tan(juce::MathConstants<double>::pi * f0 /
+                        lastSpec.sampleRate);
+    double vh = std::pow(10.0, gainDb / 20.0);
+    double vb = std::pow(vh, 0.4996667741545416);
+    double a0 = 1.0 + k / q + k * k;
+
+    BiquadCascade::Coefficients coefficients;
+    coefficients.b0 = (float)((vh + vb * k / q + k * k) / a0);
+    coefficients.b1 = (float)(2.0 * (k * k - vh) / a0);
+    coefficients.b2 = (float)((vh - vb * k / q + k * k) / a0);
+    coefficients.a1 = (float)(2.0 * (k * k - 1.0) / a0);
+    coefficients.a2 = (float)((1.0 - k / q + k * k) / a0);
+    return coefficients;
+  }
+
+  /**
+   * The second stage of the K-weighting filter (the "RLB" high-pass filter).
+   */
+  BiquadCascade::Coefficients makeHighPassCoefficients() const {
+    const double f0 = 38.13547087602444, q = 0.5003270373238773;
+    double k = std::tan(juce::MathConstants<double>::pi * f0 /
+                        lastSpec.sampleRate);
+    double a0 = 1.0 + k / q + k * k;
+
+    BiquadCascade::Coefficients coefficients;
+    coefficients.b0 = 1.0f;
+    coefficients.b1 = -2.0f;
+    coefficients.b2 = 1.0f;
+    coefficients.a1 = (float)(2.0 * (k * k - 1.0) / a0);
+    coefficients.a2 = (float)((1.0 - k / q + k * k) / a0);
+    return coefficients;
+  }
+
+  static constexpr double LOUDNESS_OFFSET = -0.691;
+  static constexpr double SURROUND_CHANNEL_WEIGHT = 1.41;
+  static constexpr double GATING_STEP_SECONDS = 0.1;
+  static constexpr int MOMENTARY_STEPS = 4;
+  static constexpr int SHORT_TERM_STEPS = 30;
+  static constexpr double ABSOLUTE_GATE_LUFS = -70.0;
+  static constexpr double RELATIVE_GATE_LU = -10.0;
+
+  // Gating blocks from -70 LUFS up to +30 LUFS are counted in bins 0.05 LU
+  // wide (and louder blocks in the last bin). As each bin's total energy is
+  // kept, this only affects which blocks fall under the relative gate:
+  static constexpr int HISTOGRAM_BINS_PER_LU = 20;
+  static constexpr int HISTOGRAM_NUM_BINS = 100 * HISTOGRAM_BINS_PER_LU;
+
+  // A 16-tap-per-phase Kaiser-windowed sinc is flat to within 0.05dB up to
+  // 40% of the sample rate:
+  static constexpr int TRUE_PEAK_OVERSAMPLING = 4;
+  static constexpr int TRUE_PEAK_TAPS_PER_PHASE = 16;
+  static constexpr double TRUE_PEAK_KAISER_BETA = 5.0;
+
+  juce::dsp::ProcessSpec lastSpec = {0, 0, 0};
+  BiquadCascade weighting;
+
+  int stepSamples = 1;
+  int samplesInStep = 0;
+  std::vector<double> stepEnergy;
+  std::array<double, SHORT_TERM_STEPS> recentStepEnergies = {};
+  long long numStepsMeasured = 0;
+
+  std::vector<long long> histogramCounts;
+  std::vector<double> histogramEnergies;
+
+  double momentaryEnergy = 0, shortTermEnergy = 0;
+  double maxMomentaryEnergy = 0, maxShortTermEnergy = 0;
+
+  std::array<std::array<float, TRUE_PEAK_TAPS_PER_PHASE>,
+             TRUE_PEAK_OVERSAMPLING>
+      truePeakFilters = {};
+  std::vector<std::vector<float>> truePeakHistory;
+  double truePeak = 0;
+};
+
+inline void init_loudness_meter(py::module &m) {
+  py::class_<LoudnessMeter, Plugin, std::shared_ptr<LoudnessMeter>>(
+      m, "LoudnessMeter",
+      "A plugin that measures the loudness of the audio passing through it "
+      "(as specified by ITU-R BS.1770-4 and EBU R128) without changing it. "
+      "Add a :class:`LoudnessMeter` to the end of a :class:`Pedalboard` to "
+      "measure the loudness of its output while rendering, rather than "
+      "making another pass over the output afterwards.\n\n"
+      "Measurements start when the meter is reset (i.e.: at the start of "
+      "every call to :meth:`process` with ``reset=True``) and continue to "
+      "accumulate across calls made with ``reset=False``, so audio can be "
+      "measured in chunks (i.e.: with :func:`pedalboard.render_file`). "
+      "Integrated loudness is computed from a fixed-size histogram, so "
+      "measuring audio of any length takes a constant amount of memory.\n\n"
+      "Five-channel audio is assumed to be laid out as L, R, C, Ls, Rs, and "
+      "six-channel audio as L, R, C, LFE, Ls, Rs; surround channels are "
+      "weighted by +1.5dB and the LFE channel is ignored. All channels are "
+      "weighted equally for other channel counts.\n\n"
+      "Loudness values that have not yet been measured (i.e.: short-term "
+      "loudness, before three seconds of audio have been processed) are "
+      "``-inf``.\n\n"
+      "*Introduced in v0.9.0.*")
+      .def(py::init([]() { return std::make_unique<LoudnessMeter>(); }))
+      .def("__repr__",
+           [](const LoudnessMeter &plugin) {
+             std::ostringstream ss;
+             ss << "<pedalboard.LoudnessMeter";
+             ss << " integrated_loudness=" << plugin.getIntegratedLoudness();
+             ss << " true_peak=" << plugin.getTruePeak();
+             ss << " at " << &plugin;
+             ss << ">";
+             return ss.str();
+           })
+      .def_property_readonly(
+          "integrated_loudness", &LoudnessMeter::getIntegratedLoudness,
+          "The integrated (gated) loudness of all audio measured so far, in "
+          "LUFS.")
+      .def_property_readonly(
+          "momentary_loudness", &LoudnessMeter::getMomentaryLoudness,
+          "The loudness of the most recent 400 milliseconds of audio, in "
+          "LUFS.")
+      .def_property_readonly(
+          "short_term_loudness", &LoudnessMeter::getShortTermLoudness,
+          "The loudness of the most recent three seconds of audio, in LUFS.")
+      .def_property_readonly(
+          "max_momentary_loudness", &LoudnessMeter::getMaxMomentaryLoudness,
+          "The largest momentary loudness measured so far, in LUFS.")
+      .def_property_readonly(
+          "max_short_term_loudness", &LoudnessMeter::getMaxShortTermLoudness,
+          "The largest short-term loudness measured so far, in LUFS.")
+      .def_property_readonly(
+          "true_peak", &LoudnessMeter::getTruePeak,
+          "The largest true peak level (the peak level of the audio after "
+          "4x oversampling) measured so far, in dBTP.");
+}
+}; // namespace Pedalboard
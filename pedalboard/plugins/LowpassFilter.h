@@ -15,11 +15,14 @@
  * limitations under the License.
  */
 
+#pragma once
+
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
 namespace py = pybind11;
 
+#include "../Automation.h"
 #include "../JucePlugin.h"
 
 namespace Pedalboard {
@@ -40,6 +43,18 @@ public:
         juce::dsp::IIR::Coefficients<SampleType>>>::prepare(spec);
   }
 
+  bool isTileable() override { return true; }
+
+  int getTailLengthSamples() override {
+    return Pedalboard::getTailLengthSamples(*this->getDSP().state);
+  }
+
+  std::shared_ptr<Plugin> clone() override {
+    auto plugin = std::make_shared<LowpassFilter<SampleType>>();
+    plugin->setCutoffFrequencyHz(getCutoffFrequencyHz());
+    return plugin;
+  }
+
 private:
   float cutoffFrequencyHz;
 };
@@ -69,5 +84,9 @@ inline void init_lowpass(py::module &m) {
       .def_property("cutoff_frequency_hz",
                     &LowpassFilter<float>::getCutoffFrequencyHz,
                     &LowpassFilter<float>::setCutoffFrequencyHz);
+
+  registerAutomatableParameter<LowpassFilter<float>>(
+      "cutoff_frequency_hz", &LowpassFilter<float>::getCutoffFrequencyHz,
+      &LowpassFilter<float>::setCutoffFrequencyHz);
 }
 }; // namespace Pedalboard
@@ -17,6 +17,10 @@
 #pragma once
 
 #include "../Plugin.h"
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
 
 extern "C" {
 #include <lame.h>
@@ -47,10 +51,137 @@ public:
     return lame;
   }
 
+  /**
+   * Take ownership of an existing LAME context, closing any current one.
+   */
+  void adopt(lame_t newLame) {
+    reset();
+    lame = newLame;
+  }
+
+  /**
+   * Give up ownership of the current LAME context (if any) without closing
+   * it, returning it to the caller.
+   */
+  lame_t release() {
+    lame_t released = lame;
+    lame = nullptr;
+    return released;
+  }
+
 private:
   lame_t lame = nullptr;
 };
 
+/*
+ * A process-wide pool of LAME encoders that have already been configured
+ * (with lame_init_params) for a given sample rate, channel count and VBR
+ * quality. Configuring an encoder is expensive enough to dominate the cost of
+ * compressing short clips, so encoders are flushed and returned to this pool
+ * when a stream ends instead of being destroyed.
+ *
+ * Only used by MP3Compressors with reuse_encoders enabled: flushing an
+ * encoder clears the audio it holds, but not its psychoacoustic model or bit
+ * reservoir, so a reused encoder's output is close to (but not bit-identical
+ * to) that of a new encoder.
+ */
+class LameEncoderPool {
+public:
+  using Key = std::tuple<double, int, float>;
+
+  struct Entry {
+    lame_t lame = nullptr;
+
+    // The encoder's position in its stream (see getStreamPosition) just after
+    // it was first configured and primed, used to compute how much more
+    // latency a reused encoder has than a new one:
+    long initialStreamPosition = 0;
+  };
+
+  static constexpr size_t MAX_ENCODERS_PER_KEY = 16;
+
+  /**
+   * The number of samples passed to an encoder since its bitstream was last
+   * initialized, including the (constant) number of samples it starts off
+   * expecting to buffer. Independent of how many frames have been written.
+   */
+  static long getStreamPosition(lame_t lame) {
+    return lame_get_mf_samples_to_encode(lame) +
+           (long)lame_get_frameNum(lame) * lame_get_framesize(lame);
+  }
+
+  static LameEncoderPool &getInstance() {
+    // Never destroyed, as plugins may return encoders to the pool during
+    // interpreter shutdown:
+    static LameEncoderPool *instance = new LameEncoderPool();
+    return *instance;
+  }
+
+  /**
+   * Take an encoder from the pool, returning false if none are available.
+   */
+  bool acquire(const Key &key, Entry &entry) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = pool.find(key);
+    if (it == pool.end() || it->second.empty())
+      return false;
+
+    entry = it->second.back();
+    it->second.pop_back();
+    return true;
+  }
+
+  /**
+   * Flush an encoder (discarding its output) so that it can start a new
+   * stream, and return it to the pool. Takes ownership of entry.lame.
+   */
+  void release(const Key &key, Entry entry) {
+    if (!flush(entry.lame)) {
+      lame_close(entry.lame);
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      std::vector<Entry> &entries = pool[key];
+      if (entries.size() < MAX_ENCODERS_PER_KEY) {
+        entries.push_back(entry);
+        return;
+      }
+    }
+    lame_close(entry.lame);
+  }
+
+private:
+  static constexpr int FLUSH_CHUNK_SIZE_SAMPLES = 32;
+
+  /**
+   * Push silence through the encoder until no audio from its previous stream
+   * remains in its buffers, then start a new bitstream with
+   * lame_encode_flush_nogap and lame_init_bitstream. Unlike
+   * lame_encode_flush, this leaves the encoder's configuration intact.
+   */
+  static bool flush(lame_t lame) {
+    short silence[FLUSH_CHUNK_SIZE_SAMPLES] = {0};
+    unsigned char discarded[(int)(1.25 * FLUSH_CHUNK_SIZE_SAMPLES) + 7200];
+
+    int samplesToFlush =
+        lame_get_mf_samples_to_encode(lame) + 2 * lame_get_framesize(lame);
+    for (int i = 0; i < samplesToFlush; i += FLUSH_CHUNK_SIZE_SAMPLES) {
+      if (lame_encode_buffer(lame, silence, silence, FLUSH_CHUNK_SIZE_SAMPLES,
+                             discarded, sizeof(discarded)) < 0) {
+        return false;
+      }
+    }
+
+    return lame_encode_flush_nogap(lame, discarded, sizeof(discarded)) >= 0 &&
+           lame_init_bitstream(lame) == 0;
+  }
+
+  std::mutex mutex;
+  std::map<Key, std::vector<Entry>> pool;
+};
+
 /*
  * A small C++ wrapper around the C-based LAME MP3 decoding functions.
  * Used mostly to avoid leaking memory.
@@ -77,82 +208,112 @@ private:
 };
 
 /**
- * A class analogous to juce::AudioBuffer, but supporting
- * signed Int16 audio data (as provided by LAME).
+ * A buffer of decoded audio waiting to be returned from MP3Compressor, which
+ * LAME's decoder writes (unclipped) floating-point samples into directly.
  */
-class Int16OutputBuffer {
+class DecodedOutputBuffer {
 public:
   void reset() {
-    outputBuffers[0].fillWith(0);
-    outputBuffers[1].fillWith(0);
-    lastSample = 0;
+    buffer.clear();
+    readPosition = 0;
+    writePosition = 0;
+  }
+
+  /**
+   * Ensure that at least numSamples samples can be written to the pointers
+   * returned by getWritePointerAtEnd().
+   */
+  void ensureSpaceAtEnd(int numSamples) {
+    if (buffer.getNumSamples() - writePosition >= numSamples)
+      return;
+
+    // Move the remaining content to the left hand side. (This happens rarely,
+    // as the buffer has room for several calls' worth of output.)
+    int numSamplesRemaining = getNumSamples();
+    if (numSamplesRemaining > 0 && readPosition > 0) {
+      for (int c = 0; c < buffer.getNumChannels(); c++) {
+        std::memmove(buffer.getWritePointer(c),
+                     buffer.getWritePointer(c) + readPosition,
+                     numSamplesRemaining * sizeof(float));
+      }
+    }
+    readPosition = 0;
+    writePosition = numSamplesRemaining;
+
+    if (buffer.getNumSamples() - writePosition < numSamples) {
+      throw std::runtime_error("Ran out of MP3 output buffer space! This is an "
+                               "internal Pedalboard error and should be "
+                               "reported.");
+    }
   }
 
   /**
    * Given a channel, return a write pointer that can be
-   * used to write signed mono 16-bit integer audio.
+   * used to write mono float audio, scaled to the range of a signed 16-bit
+   * integer (as LAME's decoder produces).
    */
-  short *getWritePointerAtEnd(int channel) {
-    return (short *)outputBuffers[channel].getData() + lastSample;
+  float *getWritePointerAtEnd(int channel) {
+    return buffer.getWritePointer(channel) + writePosition;
+  }
+
+  /**
+   * Mark numSamples samples as having been written at getWritePointerAtEnd(),
+   * and rescale them to the range [-1, 1].
+   */
+  void incrementSampleCountBy(int numSamples) {
+    for (int c = 0; c < buffer.getNumChannels(); c++) {
+      juce::FloatVectorOperations::multiply(getWritePointerAtEnd(c),
+                                            INT16_SCALE, numSamples);
+    }
+    writePosition += numSamples;
   }
 
   /*
-   * Copy the data in this buffer into the provided AudioBlock<float>.
-   * Returns the number of samples copied.
+   * Copy the data in this buffer into the right-hand side of the provided
+   * AudioBlock<float>. Returns the number of samples copied.
    */
   int copyToRightSideOf(juce::dsp::AudioBlock<float> outputBlock) {
     int samplesToOutput =
-        std::min((unsigned long)outputBlock.getNumSamples(), lastSample);
+        std::min((int)outputBlock.getNumSamples(), getNumSamples());
 
     if (samplesToOutput) {
-      int offsetInOutputBuffer = 0;
-      if (samplesToOutput < outputBlock.getNumSamples()) {
-        offsetInOutputBuffer = outputBlock.getNumSamples() - samplesToOutput;
-      }
-
+      int offsetInOutputBuffer = outputBlock.getNumSamples() - samplesToOutput;
       for (int c = 0; c < outputBlock.getNumChannels(); c++) {
-        juce::AudioDataConverters::convertInt16LEToFloat(
-            (short *)outputBuffers[c].getData(),
+        juce::FloatVectorOperations::copy(
             outputBlock.getChannelPointer(c) + offsetInOutputBuffer,
-            samplesToOutput);
+            buffer.getReadPointer(c) + readPosition, samplesToOutput);
       }
 
-      // Move the remaining content in the output buffer to the left hand side:
-      if (samplesToOutput < lastSample) {
-        unsigned long numSamplesRemaining = lastSample - samplesToOutput;
-        for (int c = 0; c < outputBlock.getNumChannels(); c++) {
-          std::memmove((short *)outputBuffers[c].getData(),
-                       (short *)outputBuffers[c].getData() + samplesToOutput,
-                       numSamplesRemaining * sizeof(short));
-        }
-        lastSample = numSamplesRemaining;
-      } else {
-        lastSample = 0;
+      readPosition += samplesToOutput;
+      if (readPosition == writePosition) {
+        readPosition = 0;
+        writePosition = 0;
       }
     }
 
     return samplesToOutput;
   }
 
-  void incrementSampleCountBy(int add) { lastSample += add; }
-
-  int getNumSamples() const { return lastSample; }
+  int getNumSamples() const { return writePosition - readPosition; }
 
   void setSize(int samples) {
-    for (int i = 0; i < 2; i++) {
-      outputBuffers[i].ensureSize(sizeof(short) * samples);
-      outputBuffers[i].fillWith(0);
-    }
+    buffer.setSize(2, samples);
+    reset();
   }
 
 private:
-  juce::MemoryBlock outputBuffers[2];
-  unsigned long lastSample = 0;
+  // The same scale factor used by juce::AudioDataConverters::
+  // convertInt16LEToFloat, which this buffer replaces:
+  static constexpr float INT16_SCALE = 1.0f / 0x7fff;
+
+  juce::AudioBuffer<float> buffer;
+  int readPosition = 0;
+  int writePosition = 0;
 };
 
 class MP3Compressor : public Plugin {
 public:
-  virtual ~MP3Compressor(){};
+  virtual ~MP3Compressor() { releaseEncoder(); };
 
   void setVBRQuality(float newLevel) {
     if (newLevel < 0 || newLevel > 10) {
@@ -161,11 +322,25 @@ public:
     }
 
     vbrLevel = newLevel;
-    encoder.reset();
+    releaseEncoder();
   }
 
   float getVBRQuality() const { return vbrLevel; }
 
+  void setReuseEncoders(bool newReuseEncoders) {
+    reuseEncoders = newReuseEncoders;
+    releaseEncoder();
+  }
+
+  bool getReuseEncoders() const { return reuseEncoders; }
+
+  std::shared_ptr<Plugin> clone() override {
+    auto plugin = std::make_shared<MP3Compressor>();
+    plugin->setVBRQuality(getVBRQuality());
+    plugin->setReuseEncoders(getReuseEncoders());
+    return plugin;
+  }
+
   virtual void prepare(const juce::dsp::ProcessSpec &spec) override {
     bool specChanged = lastSpec.sampleRate != spec.sampleRate ||
                        lastSpec.maximumBlockSize < spec.maximumBlockSize ||
@@ -173,39 +348,17 @@ public:
     if (!encoder || specChanged) {
       reset();
 
-      if (lame_set_in_samplerate(encoder.getContext(), spec.sampleRate) != 0 ||
-          lame_set_out_samplerate(encoder.getContext(), spec.sampleRate) != 0) {
-        // TODO: It would be possible to add a resampler here to support
-        // arbitrary-sample-rate audio.
-        throw std::domain_error(
-            "MP3 only supports 32kHz, 44.1kHz, and 48kHz audio. (Was passed " +
-            juce::String(spec.sampleRate / 1000, 1).toStdString() +
-            "kHz audio.)");
-      }
+      encoderKey = {spec.sampleRate, (int)spec.numChannels, vbrLevel};
+      LameEncoderPool::Entry pooledEncoder;
+      bool reusingEncoder =
+          reuseEncoders &&
+          LameEncoderPool::getInstance().acquire(encoderKey, pooledEncoder);
 
-      if (lame_set_num_channels(encoder.getContext(), spec.numChannels) != 0) {
-        // TODO: It would be possible to run multiple independent mono encoders.
-        throw std::domain_error(
-            "MP3Compressor only supports mono or stereo audio. (Was passed " +
-            std::to_string(spec.numChannels) + "-channel audio.)");
-      }
-
-      if (lame_set_VBR(encoder.getContext(), vbr_default) != 0) {
-        throw std::domain_error(
-            "MP3 encoder failed to set variable bit rate flag.");
-      }
-
-      if (lame_set_VBR_quality(encoder.getContext(), vbrLevel) != 0) {
-        throw std::domain_error(
-            "MP3 encoder failed to set variable bit rate quality to " +
-            std::to_string(vbrLevel) + "!");
-      }
-
-      int ret = lame_init_params(encoder.getContext());
-      if (ret != 0) {
-        throw std::runtime_error(
-            "MP3 encoder failed to initialize MP3 encoder! (error " +
-            std::to_string(ret) + ")");
+      if (reusingEncoder) {
+        encoder.adopt(pooledEncoder.lame);
+        encoderInitialStreamPosition = pooledEncoder.initialStreamPosition;
+      } else {
+        configureEncoder(spec);
       }
 
       // Why + 528 + 1? Pulled directly from the libmp3lame code.
@@ -230,12 +383,13 @@ public:
       // Feed in some silence at the start so that LAME buffers up enough
       // samples Without this, we underrun our output buffer at the end of the
       // stream.
-      std::vector<short> silence(ADDED_SILENCE_SAMPLES_AT_START);
+      short silence[ADDED_SILENCE_SAMPLES_AT_START] = {0};
       // Use the integer version rather than the float version for a bit of
       // extra speed.
       mp3BufferBytesFilled = lame_encode_buffer(
-          encoder.getContext(), silence.data(), silence.data(), silence.size(),
-          (unsigned char *)mp3Buffer.getData(), mp3Buffer.getSize());
+          encoder.getContext(), silence, silence,
+          ADDED_SILENCE_SAMPLES_AT_START, (unsigned char *)mp3Buffer.getData(),
+          mp3Buffer.getSize());
 
       if (mp3BufferBytesFilled < 0) {
         throw std::runtime_error(
@@ -243,11 +397,24 @@ public:
             "and should be reported.");
       }
 
-      encoderInStreamLatency += silence.size();
+      encoderInStreamLatency += ADDED_SILENCE_SAMPLES_AT_START;
+
+      // A reused encoder still holds some silence from the end of its
+      // previous stream, which delays everything we pass it from here on:
+      long streamPosition =
+          LameEncoderPool::getStreamPosition(encoder.getContext());
+      if (reusingEncoder) {
+        encoderInStreamLatency += streamPosition - encoderInitialStreamPosition;
+      } else {
+        encoderInitialStreamPosition = streamPosition;
+      }
+      encoderReusable = true;
 
       // Allow us to buffer up to (expected latency + 1 block of audio)
-      // between the output of LAME and data returned back to Pedalboard.
-      outputBuffer.setSize(encoderInStreamLatency + spec.maximumBlockSize);
+      // between the output of LAME and data returned back to Pedalboard,
+      // plus room for a few decoded frames beyond that:
+      outputBuffer.setSize(encoderInStreamLatency + spec.maximumBlockSize +
+                           2 * MAX_DECODED_SAMPLES_PER_CALL);
 
       lastSpec = spec;
     }
@@ -258,13 +425,7 @@ public:
     auto ioBlock = context.getOutputBlock();
 
     if (mp3BufferBytesFilled > 0) {
-      int samplesDecoded = hip_decode_threadsafe(
-          decoder.getContext(), (unsigned char *)mp3Buffer.getData(),
-          mp3BufferBytesFilled, outputBuffer.getWritePointerAtEnd(0),
-          outputBuffer.getWritePointerAtEnd(1));
-
-      outputBuffer.incrementSampleCountBy(samplesDecoded);
-      mp3BufferBytesFilled = 0;
+      decodeMP3Buffer();
     }
 
     for (int blockStart = 0; blockStart < ioBlock.getNumSamples();
@@ -298,14 +459,7 @@ public:
 
       // Decode frames from the buffer as soon as we get them:
       if (mp3BufferBytesFilled > 0) {
-
-        int samplesDecoded = hip_decode_threadsafe(
-            decoder.getContext(), (unsigned char *)mp3Buffer.getData(),
-            mp3BufferBytesFilled, outputBuffer.getWritePointerAtEnd(0),
-            outputBuffer.getWritePointerAtEnd(1));
-        mp3BufferBytesFilled = 0;
-
-        outputBuffer.incrementSampleCountBy(samplesDecoded);
+        decodeMP3Buffer();
       }
     }
 
@@ -320,7 +474,7 @@ public:
   }
 
   void reset() override final {
-    encoder.reset();
+    releaseEncoder();
     decoder.reset();
     outputBuffer.reset();
 
@@ -337,23 +491,104 @@ protected:
   }
 
 private:
+  /**
+   * Create and configure a new LAME encoder for the provided spec.
+   */
+  void configureEncoder(const juce::dsp::ProcessSpec &spec) {
+    if (lame_set_in_samplerate(encoder.getContext(), spec.sampleRate) != 0 ||
+        lame_set_out_samplerate(encoder.getContext(), spec.sampleRate) != 0) {
+      // TODO: It would be possible to add a resampler here to support
+      // arbitrary-sample-rate audio.
+      throw std::domain_error(
+          "MP3 only supports 32kHz, 44.1kHz, and 48kHz audio. (Was passed " +
+          juce::String(spec.sampleRate / 1000, 1).toStdString() +
+          "kHz audio.)");
+    }
+
+    if (lame_set_num_channels(encoder.getContext(), spec.numChannels) != 0) {
+      // TODO: It would be possible to run multiple independent mono encoders.
+      throw std::domain_error(
+          "MP3Compressor only supports mono or stereo audio. (Was passed " +
+          std::to_string(spec.numChannels) + "-channel audio.)");
+    }
+
+    if (lame_set_VBR(encoder.getContext(), vbr_default) != 0) {
+      throw std::domain_error(
+          "MP3 encoder failed to set variable bit rate flag.");
+    }
+
+    if (lame_set_VBR_quality(encoder.getContext(), vbrLevel) != 0) {
+      throw std::domain_error(
+          "MP3 encoder failed to set variable bit rate quality to " +
+          std::to_string(vbrLevel) + "!");
+    }
+
+    int ret = lame_init_params(encoder.getContext());
+    if (ret != 0) {
+      throw std::runtime_error(
+          "MP3 encoder failed to initialize MP3 encoder! (error " +
+          std::to_string(ret) + ")");
+    }
+  }
+
+  /**
+   * Decode the MP3 frames in mp3Buffer straight into outputBuffer.
+   */
+  void decodeMP3Buffer() {
+    outputBuffer.ensureSpaceAtEnd(MAX_DECODED_SAMPLES_PER_CALL);
+    int samplesDecoded = hip_decode_unclipped_threadsafe(
+        decoder.getContext(), (unsigned char *)mp3Buffer.getData(),
+        mp3BufferBytesFilled, outputBuffer.getWritePointerAtEnd(0),
+        outputBuffer.getWritePointerAtEnd(1));
+    mp3BufferBytesFilled = 0;
+
+    if (samplesDecoded < 0) {
+      throw std::runtime_error("MP3 decoder failed to decode frame!");
+    }
+    outputBuffer.incrementSampleCountBy(samplesDecoded);
+  }
+
+  /**
+   * Return the current encoder (if it was fully configured and reuse is
+   * enabled) to the shared pool, so that the next stream with the same
+   * parameters can skip configuring a new one.
+   */
+  void releaseEncoder() {
+    if (encoder && encoderReusable && reuseEncoders) {
+      LameEncoderPool::getInstance().release(
+          encoderKey, {encoder.release(), encoderInitialStreamPosition});
+    }
+    encoder.reset();
+    encoderReusable = false;
+  }
+
   float vbrLevel = 2.0;
+  bool reuseEncoders = false;
 
   EncoderWrapper encoder;
   DecoderWrapper decoder;
 
+  LameEncoderPool::Key encoderKey;
+  long encoderInitialStreamPosition = 0;
+  bool encoderReusable = false;
+
   // The maximum number of samples to pass to LAME at once.
   // Determines roughly how big our output MP3 buffer has to be.
   static constexpr size_t MAX_LAME_MP3_BUFFER_SIZE_SAMPLES = 32;
   static constexpr size_t MAX_MP3_FRAME_SIZE_SAMPLES = 1152;
 
+  // The most samples we expect LAME's decoder to produce from one call to
+  // decodeMP3Buffer() (which is usually at most one frame):
+  static constexpr int MAX_DECODED_SAMPLES_PER_CALL =
+      4 * MAX_MP3_FRAME_SIZE_SAMPLES;
+
   // This is the number of samples we add at the start of the LAME stream to
   // give us enough of a "head start" to avoid underflowing our MP3 buffer when
   // the stream finishes. This value, like many others, was determined
   // empirically.
   static constexpr long ADDED_SILENCE_SAMPLES_AT_START = 200;
 
-  Int16OutputBuffer outputBuffer;
+  DecodedOutputBuffer outputBuffer;
   long samplesProduced = 0;
   long encoderInStreamLatency = 0;
 
@@ -372,23 +607,37 @@ inline void init_mp3_compressor(py::module &m) {
       "MP3 format only supports 32kHz, 44.1kHz, and 48kHz audio; if an "
       "unsupported sample rate is provided, an exception will be thrown at "
       "processing time.")
-      .def(py::init([](float vbr_quality) {
+      .def(py::init([](float vbr_quality, bool reuse_encoders) {
              auto plugin = std::make_unique<MP3Compressor>();
              plugin->setVBRQuality(vbr_quality);
+             plugin->setReuseEncoders(reuse_encoders);
              return plugin;
            }),
-           py::arg("vbr_quality") = 2.0)
+           py::arg("vbr_quality") = 2.0, py::arg("reuse_encoders") = false)
       .def("__repr__",
            [](const MP3Compressor &plugin) {
              std::ostringstream ss;
              ss << "<pedalboard.MP3Compressor";
              ss << " vbr_quality=" << plugin.getVBRQuality();
+             ss << " reuse_encoders="
+                << (plugin.getReuseEncoders() ? "True" : "False");
              ss << " at " << &plugin;
              ss << ">";
              return ss.str();
            })
       .def_property("vbr_quality", &MP3Compressor::getVBRQuality,
-                    &MP3Compressor::setVBRQuality);
+                    &MP3Compressor::setVBRQuality)
+      .def_property(
+          "reuse_encoders", &MP3Compressor::getReuseEncoders,
+          &MP3Compressor::setReuseEncoders,
+          "If ``True``, configured MP3 encoders are kept in a shared pool "
+          "between calls and reused, which makes compressing many short "
+          "clips much faster. A reused encoder carries some internal state "
+          "over from its previous stream, so its output is not bit-identical "
+          "to that of a new encoder and may differ between otherwise "
+          "identical calls. If ``False`` (the default), every call uses a "
+          "new encoder and produces deterministic output."
+          "\n\n*Introduced in v0.9.0.*");
 }
 
 }; // namespace Pedalboard
\ No newline at end of file
@@ -18,184 +18,425 @@
 #pragma once
 
 #include "../JuceHeader.h"
+#include <condition_variable>
+#include <exception>
 #include <mutex>
+#include <thread>
 
+#include "../Automation.h"
 #include "../PluginContainer.h"
 
 namespace Pedalboard {
+/**
+ * A buffer of audio output from one branch of a Mix, stored in a circular
+ * buffer so that samples can be added and removed without moving any of the
+ * samples already stored.
+ *
+ * Also contains a scratch buffer of one block in size, into which each block
+ * of input is copied and processed before its output is added to the
+ * circular buffer.
+ */
+template <typename SampleType> class MixBranchBuffer {
+public:
+  /**
+   * Allocate enough space to store `capacity` samples of output, and to
+   * process blocks of up to `maximumBlockSize` samples. Clears any samples
+   * currently stored.
+   */
+  void prepare(int numChannels, int capacity, int maximumBlockSize) {
+    if (ring.getNumChannels() != numChannels ||
+        ring.getNumSamples() != capacity) {
+      ring.setSize(numChannels, capacity);
+    }
+    if (scratch.getNumChannels() != numChannels ||
+        scratch.getNumSamples() < maximumBlockSize) {
+      scratch.setSize(numChannels, maximumBlockSize);
+    }
+    clear();
+  }
+
+  void clear() {
+    readPosition = 0;
+    numSamplesStored = 0;
+  }
+
+  int getNumSamplesStored() const { return numSamplesStored; }
+
+  /**
+   * Copy the provided input into this branch's scratch buffer, returning a
+   * block (backed by the scratch buffer) that can be processed in place.
+   */
+  juce::dsp::AudioBlock<SampleType>
+  copyToScratch(const juce::dsp::AudioBlock<const SampleType> &input) {
+    int numSamples = (int)input.getNumSamples();
+    if (scratch.getNumSamples() < numSamples) {
+      // Should only happen if prepare() was given the wrong block size:
+      scratch.setSize(scratch.getNumChannels(), numSamples);
+    }
+
+    auto block = juce::dsp::AudioBlock<SampleType>(scratch).getSubBlock(
+        0, numSamples);
+    block.copyFrom(input);
+    return block;
+  }
+
+  /**
+   * Append `numSamples` samples from the provided block (starting at
+   * `startSample`) to the end of this buffer.
+   */
+  void push(const juce::dsp::AudioBlock<SampleType> &block, int startSample,
+            int numSamples) {
+    if (numSamples <= 0)
+      return;
+
+    if (numSamplesStored + numSamples > ring.getNumSamples()) {
+      // A plugin buffered more audio than its latency hint suggested it
+      // would. (Reluctantly) reallocate, as this is the "audio thread!"
+      grow(numSamplesStored + numSamples);
+    }
+
+    int capacity = ring.getNumSamples();
+    int writePosition = (readPosition + numSamplesStored) % capacity;
+    int firstPart = std::min(numSamples, capacity - writePosition);
+
+    for (int c = 0; c < ring.getNumChannels(); c++) {
+      const SampleType *source = block.getChannelPointer(c) + startSample;
+      SampleType *destination = ring.getWritePointer(c);
+      juce::FloatVectorOperations::copy(destination + writePosition, source,
+                                        firstPart);
+      juce::FloatVectorOperations::copy(destination, source + firstPart,
+                                        numSamples - firstPart);
+    }
+    numSamplesStored += numSamples;
+  }
+
+  /**
+   * Add the oldest `numSamples` samples stored in this buffer to the provided
+   * block, then remove them from this buffer.
+   */
+  void popAndAddTo(juce::dsp::AudioBlock<SampleType> &block, int numSamples) {
+    jassert(numSamples <= numSamplesStored);
+    if (numSamples <= 0)
+      return;
+
+    int capacity = ring.getNumSamples();
+    int firstPart = std::min(numSamples, capacity - readPosition);
+
+    for (int c = 0; c < block.getNumChannels(); c++) {
+      const SampleType *source = ring.getReadPointer(c);
+      SampleType *destination = block.getChannelPointer(c);
+      juce::FloatVectorOperations::add(destination, source + readPosition,
+                                       firstPart);
+      juce::FloatVectorOperations::add(destination + firstPart, source,
+                                       numSamples - firstPart);
+    }
+
+    readPosition = (readPosition + numSamples) % capacity;
+    numSamplesStored -= numSamples;
+  }
+
+private:
+  void grow(int minimumCapacity) {
+    int oldCapacity = ring.getNumSamples();
+    int newCapacity = std::max(minimumCapacity, oldCapacity * 2);
+    juce::AudioBuffer<SampleType> newRing(ring.getNumChannels(), newCapacity);
+
+    // Unwrap the stored samples to the start of the new buffer:
+    int firstPart = std::min(numSamplesStored, oldCapacity - readPosition);
+    for (int c = 0; c < ring.getNumChannels(); c++) {
+      newRing.copyFrom(c, 0, ring, c, readPosition, firstPart);
+      newRing.copyFrom(c, firstPart, ring, c, 0, numSamplesStored - firstPart);
+    }
+
+    ring = std::move(newRing);
+    readPosition = 0;
+  }
+
+  juce::AudioBuffer<SampleType> ring;
+  juce::AudioBuffer<SampleType> scratch;
+  int readPosition = 0;
+  int numSamplesStored = 0;
+};
+
 /**
  * A class that allows parallel processing of zero or more separate plugin
  * chains.
  */
 class Mix : public PluginContainer {
 public:
-  Mix(std::vector<std::shared_ptr<Plugin>> plugins)
+  Mix(std::vector<std::shared_ptr<Plugin>> plugins, bool parallel = false)
       : PluginContainer(plugins), pluginBuffers(plugins.size()),
-        samplesAvailablePerPlugin(plugins.size()) {}
+        parallel(parallel) {}
   virtual ~Mix(){};
 
   virtual void prepare(const juce::dsp::ProcessSpec &spec) {
-    for (auto plugin : plugins) {
+    for (auto &plugin : plugins) {
       if (plugin) {
         plugin->prepare(spec);
       }
     }
 
-    int maximumBufferSize = getLatencyHint() + spec.maximumBlockSize;
+    // Each branch may need to buffer up to (the maximum latency of all
+    // branches) + (one block) samples before its output can be mixed.
+    int capacity = getLatencyHint() + spec.maximumBlockSize;
+    pluginBuffers.resize(plugins.size());
     for (auto &buffer : pluginBuffers)
-      buffer.setSize(spec.numChannels, maximumBufferSize);
-    for (int i = 0; i < samplesAvailablePerPlugin.size(); i++)
-      samplesAvailablePerPlugin[i] = 0;
+      buffer.prepare(spec.numChannels, capacity, spec.maximumBlockSize);
+
+    // Buffers for 64-bit audio are only allocated once they're first used, as
+    // most callers will only ever process 32-bit audio:
+    if (!doublePrecisionPluginBuffers.empty()) {
+      doublePrecisionPluginBuffers.resize(plugins.size());
+      for (auto &buffer : doublePrecisionPluginBuffers)
+        buffer.prepare(spec.numChannels, capacity, spec.maximumBlockSize);
+    }
+
+    // The calling thread processes the first branch itself, so we only need
+    // worker threads for the rest:
+    int numWorkerThreads = std::min(
+        (int)plugins.size() - 1,
+        std::max(1, (int)std::thread::hardware_concurrency() - 1));
+    if (!parallel || numWorkerThreads < 1) {
+      threadPool.reset();
+    } else if (!threadPool || threadPool->getNumThreads() != numWorkerThreads) {
+      threadPool = std::make_unique<juce::ThreadPool>(numWorkerThreads);
+    }
+
     lastSpec = spec;
   }
 
   virtual int
   process(const juce::dsp::ProcessContextReplacing<float> &context) {
-    auto ioBlock = context.getOutputBlock();
+    return processSamples(context, pluginBuffers);
+  }
 
-    for (int i = 0; i < plugins.size(); i++) {
-      std::shared_ptr<Plugin> plugin = plugins[i];
-      juce::AudioBuffer<float> &buffer = pluginBuffers[i];
+  virtual int
+  process(const juce::dsp::ProcessContextReplacing<double> &context) {
+    if (doublePrecisionPluginBuffers.size() != plugins.size()) {
+      doublePrecisionPluginBuffers.resize(plugins.size());
+      for (auto &buffer : doublePrecisionPluginBuffers)
+        buffer.prepare(lastSpec.numChannels,
+                       getLatencyHint() + lastSpec.maximumBlockSize,
+                       lastSpec.maximumBlockSize);
+    }
+    return processSamples(context, doublePrecisionPluginBuffers);
+  }
 
-      int startInBuffer = samplesAvailablePerPlugin[i];
-      int endInBuffer = startInBuffer + ioBlock.getNumSamples();
-      // If we don't have enough space, reallocate. (Reluctantly. This is the
-      // "audio thread!")
-      if (endInBuffer > buffer.getNumSamples()) {
-        buffer.setSize(buffer.getNumChannels(), endInBuffer);
+  virtual void reset() {
+    for (auto &plugin : plugins) {
+      if (plugin) {
+        plugin->reset();
       }
+    }
+
+    for (auto &buffer : pluginBuffers)
+      buffer.clear();
+    for (auto &buffer : doublePrecisionPluginBuffers)
+      buffer.clear();
+  }
 
-      // Copy the audio input into each of these buffers:
-      context.getInputBlock().copyTo(buffer, 0, samplesAvailablePerPlugin[i]);
+  virtual int getLatencyHint() {
+    int maxHint = 0;
+    for (auto &plugin : plugins) {
+      if (plugin) {
+        maxHint = std::max(maxHint, plugin->getLatencyHint());
+      }
+    }
+    return maxHint;
+  }
 
-      float **channelPointers =
-          (float **)alloca(ioBlock.getNumChannels() * sizeof(float *));
-      for (int c = 0; c < buffer.getNumChannels(); c++) {
-        channelPointers[c] = buffer.getWritePointer(c, startInBuffer);
+  virtual int getTailLengthSamples() {
+    int maxTail = 0;
+    for (auto &plugin : plugins) {
+      if (plugin) {
+        int pluginTail = plugin->getTailLengthSamples();
+        if (pluginTail < 0)
+          return -1;
+        maxTail = std::max(maxTail, pluginTail);
       }
+    }
+    return maxTail;
+  }
 
-      auto subBlock = juce::dsp::AudioBlock<float>(
-          channelPointers, buffer.getNumChannels(), ioBlock.getNumSamples());
+  virtual std::shared_ptr<Plugin> clone() {
+    if (auto clonedPlugins = clonePlugins()) {
+      return std::make_shared<Mix>(*clonedPlugins, parallel);
+    }
+    return nullptr;
+  }
 
-      juce::dsp::ProcessContextReplacing<float> subContext(subBlock);
+  bool getParallel() const { return parallel; }
+  void setParallel(bool value) { parallel = value; }
 
-      int samplesRendered = subBlock.getNumSamples();
+protected:
+  template <typename SampleType>
+  int processSamples(
+      const juce::dsp::ProcessContextReplacing<SampleType> &context,
+      std::vector<MixBranchBuffer<SampleType>> &buffers) {
+    auto ioBlock = context.getOutputBlock();
 
-      if (plugin) {
-        samplesRendered = plugin->process(subContext);
-      }
-      samplesAvailablePerPlugin[i] += samplesRendered;
-
-      if (samplesRendered < subBlock.getNumSamples()) {
-        // Left-align the results in the buffer, as we'll need all
-        // of the plugins' outputs to be aligned:
-        for (int c = 0; c < pluginBuffers[i].getNumChannels(); c++) {
-          std::memmove(channelPointers[c],
-                       channelPointers[c] +
-                           (subBlock.getNumSamples() - samplesRendered),
-                       sizeof(float) * samplesRendered);
-        }
+    if (threadPool && plugins.size() > 1) {
+      processBranchesInParallel(context, buffers);
+    } else {
+      for (int i = 0; i < plugins.size(); i++) {
+        processBranch(i, context, buffers);
       }
     }
 
     // Figure out the maximum number of samples we can return,
     // which is the min across all buffers:
     int maxSamplesAvailable = ioBlock.getNumSamples();
-    for (int i = 0; i < plugins.size(); i++) {
+    for (auto &buffer : buffers) {
       maxSamplesAvailable =
-          std::min(samplesAvailablePerPlugin[i], maxSamplesAvailable);
+          std::min(buffer.getNumSamplesStored(), maxSamplesAvailable);
     }
 
-    // Now that each plugin has rendered into its own buffer, mix the output:
+    // Now that each plugin has rendered into its own buffer, mix the output,
+    // right-aligned in the output block, and remove the samples we've just
+    // returned from each branch's buffer:
     ioBlock.clear();
     if (maxSamplesAvailable) {
       int leftEdge = ioBlock.getNumSamples() - maxSamplesAvailable;
       auto subBlock = ioBlock.getSubBlock(leftEdge, maxSamplesAvailable);
 
-      for (auto &pluginBuffer : pluginBuffers) {
-        // Right-align exactly `maxSamplesAvailable` samples from each buffer:
-        juce::dsp::AudioBlock<float> pluginBufferAsBlock(pluginBuffer);
-
-        // Add as many samples as we can (which is maxSamplesAvailable,
-        // because subBlock is only that size):
-        subBlock.add(pluginBufferAsBlock);
+      for (auto &buffer : buffers) {
+        buffer.popAndAddTo(subBlock, maxSamplesAvailable);
       }
     }
 
-    // Delete the samples we just returned from each buffer and shift the
-    // remaining content left:
-    int samplesToDelete = maxSamplesAvailable;
-    if (samplesToDelete) {
-      for (int i = 0; i < plugins.size(); i++) {
-        int samplesRemaining = samplesAvailablePerPlugin[i] - samplesToDelete;
-        for (int c = 0; c < pluginBuffers[i].getNumChannels(); c++) {
-          float *channelBuffer = pluginBuffers[i].getWritePointer(c);
+    return maxSamplesAvailable;
+  }
 
-          // Shift the remaining samples to the start of the buffer:
-          std::memmove(channelBuffer, channelBuffer + samplesToDelete,
-                       sizeof(float) * samplesRemaining);
-        }
-        samplesAvailablePerPlugin[i] -= samplesToDelete;
-      }
+  /**
+   * Run the plugin at the given index over a copy of the provided input,
+   * appending its output to the end of that plugin's buffer. Each branch only
+   * touches its own plugin and buffer, so multiple branches can safely be
+   * processed at the same time.
+   */
+  template <typename SampleType>
+  void
+  processBranch(int i,
+                const juce::dsp::ProcessContextReplacing<SampleType> &context,
+                std::vector<MixBranchBuffer<SampleType>> &buffers) {
+    std::shared_ptr<Plugin> plugin = plugins[i];
+    MixBranchBuffer<SampleType> &buffer = buffers[i];
+
+    auto subBlock = buffer.copyToScratch(context.getInputBlock());
+    juce::dsp::ProcessContextReplacing<SampleType> subContext(subBlock);
+
+    int samplesRendered = subBlock.getNumSamples();
+    if (plugin) {
+      samplesRendered =
+          processWithAutomation(*plugin, subContext, lastSpec.sampleRate);
     }
 
-    return maxSamplesAvailable;
+    // Output is right-aligned in the block:
+    buffer.push(subBlock, subBlock.getNumSamples() - samplesRendered,
+                samplesRendered);
   }
 
-  virtual void reset() {
-    for (auto plugin : plugins) {
-      if (plugin) {
-        plugin->reset();
-      }
+  /**
+   * Process every branch of this Mix, farming all but the first branch out to
+   * this Mix's thread pool. Returns once all branches have been processed.
+   */
+  template <typename SampleType>
+  void processBranchesInParallel(
+      const juce::dsp::ProcessContextReplacing<SampleType> &context,
+      std::vector<MixBranchBuffer<SampleType>> &buffers) {
+    std::vector<std::exception_ptr> branchExceptions(plugins.size());
+    std::mutex branchesRemainingMutex;
+    std::condition_variable allBranchesDone;
+    size_t branchesRemaining = plugins.size() - 1;
+
+    for (int i = 1; i < plugins.size(); i++) {
+      threadPool->addJob([&, i]() {
+        try {
+          processBranch(i, context, buffers);
+        } catch (...) {
+          branchExceptions[i] = std::current_exception();
+        }
+
+        // Notify while holding the lock, as the waiting thread will destroy
+        // this condition variable as soon as it's able to return:
+        std::lock_guard<std::mutex> lock(branchesRemainingMutex);
+        if (--branchesRemaining == 0) {
+          allBranchesDone.notify_one();
+        }
+      });
     }
 
-    for (auto buffer : pluginBuffers)
-      buffer.clear();
-  }
+    try {
+      processBranch(0, context, buffers);
+    } catch (...) {
+      branchExceptions[0] = std::current_exception();
+    }
 
-  virtual int getLatencyHint() {
-    int maxHint = 0;
-    for (auto plugin : plugins) {
-      if (plugin) {
-        maxHint = std::max(maxHint, plugin->getLatencyHint());
-      }
+    {
+      std::unique_lock<std::mutex> lock(branchesRemainingMutex);
+      allBranchesDone.wait(lock, [&]() { return branchesRemaining == 0; });
+    }
+
+    for (auto &exception : branchExceptions) {
+      if (exception)
+        std::rethrow_exception(exception);
     }
-    return maxHint;
   }
 
-protected:
-  std::vector<juce::AudioBuffer<float>> pluginBuffers;
-  std::vector<int> samplesAvailablePerPlugin;
+  std::vector<MixBranchBuffer<float>> pluginBuffers;
+  std::vector<MixBranchBuffer<double>> doublePrecisionPluginBuffers;
+
+  bool parallel = false;
+  std::unique_ptr<juce::ThreadPool> threadPool;
 };
 
 inline void init_mix(py::module &m) {
   py::class_<Mix, PluginContainer, std::shared_ptr<Mix>>(
       m, "Mix",
       "A utility plugin that allows running other plugins in parallel. All "
-      "plugins provided will be mixed equally.")
-      .def(py::init([](std::vector<std::shared_ptr<Plugin>> plugins) {
-             return new Mix(plugins);
-           }),
-           py::arg("plugins"))
+      "plugins provided will be mixed equally.\n\nIf ``parallel`` is "
+      "``True``, each plugin will be run on its own thread (from a pool of "
+      "threads owned by this Mix) rather than one after another. This can "
+      "speed up processing when each plugin does a lot of work (i.e.: when "
+      "each is a Chain of several effects), and produces exactly the same "
+      "output as processing each plugin in turn.")
+      .def(py::init([](std::vector<std::shared_ptr<Plugin>> plugins,
+                       bool parallel) { return new Mix(plugins, parallel); }),
+           py::arg("plugins"), py::arg("parallel") = false)
       .def(py::init([]() { return new Mix({}); }))
       .def("__repr__", [](Mix &plugin) {
+        // Copy the list of plugins rather than holding its lock, as calling
+        // __repr__ on each plugin may run arbitrary Python code:
+        std::vector<std::shared_ptr<Plugin>> plugins;
+        {
+          std::shared_lock lock(plugin.pluginListMutex);
+          plugins = plugin.getPlugins();
+        }
+
         std::ostringstream ss;
-        ss << "<pedalboard.Mix with " << plugin.getPlugins().size()
-           << " plugin";
-        if (plugin.getPlugins().size() != 1) {
+        ss << "<pedalboard.Mix with " << plugins.size() << " plugin";
+        if (plugins.size() != 1) {
           ss << "s";
         }
         ss << ": [";
-        for (int i = 0; i < plugin.getPlugins().size(); i++) {
-          py::object nestedPlugin = py::cast(plugin.getPlugins()[i]);
+        for (int i = 0; i < plugins.size(); i++) {
+          py::object nestedPlugin = py::cast(plugins[i]);
           ss << nestedPlugin.attr("__repr__")();
-          if (i < plugin.getPlugins().size() - 1) {
+          if (i < plugins.size() - 1) {
             ss << ", ";
           }
         }
-        ss << "] at " << &plugin;
+        ss << "]";
+        if (plugin.getParallel()) {
+          ss << " parallel=True";
+        }
+        ss << " at " << &plugin;
         ss << ">";
         return ss.str();
-      });
+      })
+      .def_property(
+          "parallel", &Mix::getParallel, &Mix::setParallel,
+          "If ``True``, each plugin in this Mix will be run concurrently on "
+          "its own thread. Changes take effect the next time audio is "
+          "processed.\n\n*Introduced in v0.9.0.*");
 }
 } // namespace Pedalboard
\ No newline at end of file
@@ -20,15 +20,28 @@
 
 namespace py = pybind11;
 
+#include "../Automation.h"
 #include "../JucePlugin.h"
+#include "../plugin_templates/DynamicsProcessors.h"
 
 namespace Pedalboard {
 template <typename SampleType>
-class NoiseGate : public JucePlugin<juce::dsp::NoiseGate<SampleType>> {
+class NoiseGate : public JucePlugin<DynamicsNoiseGate<SampleType>> {
   DEFINE_DSP_SETTER_AND_GETTER(SampleType, Threshold, {});
   DEFINE_DSP_SETTER_AND_GETTER(SampleType, Ratio, {});
   DEFINE_DSP_SETTER_AND_GETTER(SampleType, Attack, {});
   DEFINE_DSP_SETTER_AND_GETTER(SampleType, Release, {});
+  DEFINE_DSP_SETTER_AND_GETTER(bool, Linked, {});
+
+  std::shared_ptr<Plugin> clone() override {
+    auto plugin = std::make_shared<NoiseGate<SampleType>>();
+    plugin->setThreshold(getThreshold());
+    plugin->setRatio(getRatio());
+    plugin->setAttack(getAttack());
+    plugin->setRelease(getRelease());
+    plugin->setLinked(getLinked());
+    return plugin;
+  }
 };
 
 inline void init_noisegate(py::module &m) {
@@ -38,16 +51,18 @@ inline void init_noisegate(py::module &m) {
       "A simple noise gate with standard threshold, ratio, attack time and "
       "release time controls. Can be used as an expander if the ratio is low.")
       .def(py::init([](float thresholddB, float ratio, float attackMs,
-                       float releaseMs) {
+                       float releaseMs, bool linked) {
              auto plugin = std::make_unique<NoiseGate<float>>();
              plugin->setThreshold(thresholddB);
              plugin->setRatio(ratio);
              plugin->setAttack(attackMs);
              plugin->setRelease(releaseMs);
+             plugin->setLinked(linked);
              return plugin;
            }),
            py::arg("threshold_db") = -100.0, py::arg("ratio") = 10,
-           py::arg("attack_ms") = 1.0, py::arg("release_ms") = 100.0)
+           py::arg("attack_ms") = 1.0, py::arg("release_ms") = 100.0,
+           py::arg("linked") = false)
       .def("__repr__",
            [](const NoiseGate<float> &plugin) {
              std::ostringstream ss;
@@ -56,6 +71,7 @@ inline void init_noisegate(py::module &m) {
              ss << " ratio=" << plugin.getRatio();
              ss << " attack_ms=" << plugin.getAttack();
              ss << " release_ms=" << plugin.getRelease();
+             ss << " linked=" << (plugin.getLinked() ? "True" : "False");
              ss << " at " << &plugin;
              ss << ">";
              return ss.str();
@@ -67,6 +83,24 @@ inline void init_noisegate(py::module &m) {
       .def_property("attack_ms", &NoiseGate<float>::getAttack,
                     &NoiseGate<float>::setAttack)
       .def_property("release_ms", &NoiseGate<float>::getRelease,
-                    &NoiseGate<float>::setRelease);
+                    &NoiseGate<float>::setRelease)
+      .def_property("linked", &NoiseGate<float>::getLinked,
+                    &NoiseGate<float>::setLinked,
+                    "If ``True``, the noise gate is driven by the loudest "
+                    "channel and applies the same gain to every channel, "
+                    "preserving the stereo image. If ``False`` (the default), "
+                    "each channel is processed independently."
+                    "\n\n*Introduced in v0.9.0.*");
+
+  registerAutomatableParameter<NoiseGate<float>>(
+      "threshold_db", &NoiseGate<float>::getThreshold,
+      &NoiseGate<float>::setThreshold);
+  registerAutomatableParameter<NoiseGate<float>>(
+      "ratio", &NoiseGate<float>::getRatio, &NoiseGate<float>::setRatio);
+  registerAutomatableParameter<NoiseGate<float>>(
+      "attack_ms", &NoiseGate<float>::getAttack, &NoiseGate<float>::setAttack);
+  registerAutomatableParameter<NoiseGate<float>>(
+      "release_ms", &NoiseGate<float>::getRelease,
+      &NoiseGate<float>::setRelease);
 }
 }; // namespace Pedalboard
@@ -20,16 +20,28 @@
 
 namespace py = pybind11;
 
+#include "../Automation.h"
 #include "../JucePlugin.h"
+#include "../plugin_templates/ModulationProcessors.h"
 
 namespace Pedalboard {
 template <typename SampleType>
-class Phaser : public JucePlugin<juce::dsp::Phaser<SampleType>> {
+class Phaser : public JucePlugin<BlockRatePhaser<SampleType>> {
   DEFINE_DSP_SETTER_AND_GETTER(SampleType, Rate, {});
   DEFINE_DSP_SETTER_AND_GETTER(SampleType, Depth, {});
   DEFINE_DSP_SETTER_AND_GETTER(SampleType, CentreFrequency, {});
   DEFINE_DSP_SETTER_AND_GETTER(SampleType, Feedback, {});
   DEFINE_DSP_SETTER_AND_GETTER(SampleType, Mix, {});
+
+  std::shared_ptr<Plugin> clone() override {
+    auto plugin = std::make_shared<Phaser<SampleType>>();
+    plugin->setRate(getRate());
+    plugin->setDepth(getDepth());
+    plugin->setCentreFrequency(getCentreFrequency());
+    plugin->setFeedback(getFeedback());
+    plugin->setMix(getMix());
+    return plugin;
+  }
 };
 
 inline void init_phaser(py::module &m) {
@@ -74,5 +86,17 @@ inline void init_phaser(py::module &m) {
       .def_property("feedback", &Phaser<float>::getFeedback,
                     &Phaser<float>::setFeedback)
       .def_property("mix", &Phaser<float>::getMix, &Phaser<float>::setMix);
+
+  registerAutomatableParameter<Phaser<float>>(
+      "rate_hz", &Phaser<float>::getRate, &Phaser<float>::setRate);
+  registerAutomatableParameter<Phaser<float>>("depth", &Phaser<float>::getDepth,
+                                              &Phaser<float>::setDepth);
+  registerAutomatableParameter<Phaser<float>>(
+      "centre_frequency_hz", &Phaser<float>::getCentreFrequency,
+      &Phaser<float>::setCentreFrequency);
+  registerAutomatableParameter<Phaser<float>>(
+      "feedback", &Phaser<float>::getFeedback, &Phaser<float>::setFeedback);
+  registerAutomatableParameter<Phaser<float>>("mix", &Phaser<float>::getMix,
+                                              &Phaser<float>::setMix);
 }
 }; // namespace Pedalboard
\ No newline at end of file
@@ -20,6 +20,7 @@
 
 namespace py = pybind11;
 
+#include "../Automation.h"
 #include "../RubberbandPlugin.h"
 #include "../plugin_templates/PrimeWithSilence.h"
 
@@ -56,6 +57,12 @@ public:
     PrimeWithSilence<RubberbandPlugin>::prepare(spec);
     getNestedPlugin().getStretcher().setPitchScale(getScaleFactor());
   }
+
+  std::shared_ptr<Plugin> clone() override {
+    auto plugin = std::make_shared<PitchShift>();
+    plugin->setSemitones(getSemitones());
+    return plugin;
+  }
 };
 
 inline void init_pitch_shift(py::module &m) {
@@ -82,5 +89,8 @@ inline void init_pitch_shift(py::module &m) {
            })
       .def_property("semitones", &PitchShift::getSemitones,
                     &PitchShift::setSemitones);
+
+  registerAutomatableParameter<PitchShift>(
+      "semitones", &PitchShift::getSemitones, &PitchShift::setSemitones);
 }
 }; // namespace Pedalboard
@@ -17,40 +17,210 @@
 
 #pragma once
 #include "JuceHeader.h"
+#include <atomic>
+#include <optional>
+#include <thread>
+#include <variant>
 
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 
+#include "AudioRingBuffer.h"
+#include "Automation.h"
 #include "BufferUtils.h"
 #include "Plugin.h"
 #include "PluginContainer.h"
+#include "Profiling.h"
+#include "RealtimeAudit.h"
+#include "ScratchBuffers.h"
 
 namespace py = pybind11;
 
 namespace Pedalboard {
 
-inline int process(juce::AudioBuffer<float> &ioBuffer,
-                   juce::dsp::ProcessSpec spec,
-                   const std::vector<std::shared_ptr<Plugin>> &plugins,
-                   bool isProbablyLastProcessCall) {
-  int totalOutputLatencySamples = 0;
-  int expectedOutputLatency = 0;
+/**
+ * The number of bytes of audio (across all channels) to pass through each run
+ * of tileable plugins at once when fusing them; small enough to stay in L1
+ * cache from one plugin to the next.
+ */
+static constexpr size_t FUSED_TILE_SIZE_BYTES = 16 * 1024;
 
-  for (auto plugin : plugins) {
-    if (!plugin)
-      continue;
-    expectedOutputLatency += plugin->getLatencyHint();
+/**
+ * Run each of a run of tileable plugins (see Plugin::isTileable) over
+ * [startSample, endSample) of the provided buffer, one cache-sized tile at a
+ * time. As tileable plugins never buffer audio, this is equivalent to running
+ * each plugin over the whole range in turn.
+ */
+template <typename SampleType>
+void processTiles(juce::AudioBuffer<SampleType> &ioBuffer,
+                  const juce::dsp::ProcessSpec &spec,
+                  const std::vector<Plugin *> &tileablePlugins,
+                  unsigned int startSample, unsigned int endSample) {
+  const unsigned int tileSize = std::max(
+      16u, std::min(spec.maximumBlockSize,
+                    (unsigned int)(FUSED_TILE_SIZE_BYTES /
+                                   (sizeof(SampleType) *
+                                    std::max(1, ioBuffer.getNumChannels())))));
+
+  for (unsigned int tileStart = startSample; tileStart < endSample;
+       tileStart += tileSize) {
+    unsigned int thisTileSize = std::min(tileSize, endSample - tileStart);
+    auto tile = juce::dsp::AudioBlock<SampleType>(
+        ioBuffer.getArrayOfWritePointers(), ioBuffer.getNumChannels(),
+        tileStart, thisTileSize);
+    juce::dsp::ProcessContextReplacing<SampleType> context(tile);
+
+    for (auto *plugin : tileablePlugins) {
+      RealtimeAuditScope auditScope(*plugin);
+      if (skipIfSilent(*plugin, context))
+        continue;
+      ProfilingScope profilingScope(*plugin, thisTileSize);
+      if (plugin->process(context) != (int)thisTileSize) {
+        throw std::runtime_error(
+            "A tileable plugin returned fewer samples than it was given! "
+            "This is an internal Pedalboard error and should be reported.");
+      }
+    }
   }
+}
+
+/**
+ * The number of blocks of audio (of the spec's maximum block size) that can be
+ * queued between each pair of adjacent stages when processing a pipeline.
+ */
+static constexpr int PIPELINE_QUEUE_BLOCKS = 4;
 
-  int intendedOutputBufferSize = ioBuffer.getNumSamples();
+/**
+ * How long a pipeline stage waits to be woken up before checking whether
+ * another stage has failed.
+ */
+static constexpr int PIPELINE_WAIT_TIMEOUT_MS = 10;
+
+inline void
+appendPipelineStages(const std::shared_ptr<Plugin> &plugin,
+                     std::vector<std::shared_ptr<Plugin>> &stagePlugins) {
+  if (!plugin)
+    return;
+  auto nestedPlugins = plugin->getPipelineStages();
+  if (nestedPlugins.empty()) {
+    stagePlugins.push_back(plugin);
+    return;
+  }
+  for (auto &nestedPlugin : nestedPlugins) {
+    appendPipelineStages(nestedPlugin, stagePlugins);
+  }
+}
+
+/**
+ * If any of the provided plugins asks to be run as a pipeline (see
+ * Plugin::getPipelineStages), return the stages of that pipeline: lists of
+ * plugins, each of which is run on its own thread. Runs of consecutive
+ * tileable plugins (which are cheap, and never buffer audio) share a stage.
+ * Returns an empty list if the plugins shouldn't be pipelined.
+ */
+inline std::vector<std::vector<std::shared_ptr<Plugin>>>
+getPipelineStages(const std::vector<std::shared_ptr<Plugin>> &plugins) {
+  bool isPipelined = false;
+  std::vector<std::shared_ptr<Plugin>> stagePlugins;
+  for (auto &plugin : plugins) {
+    if (plugin && !plugin->getPipelineStages().empty())
+      isPipelined = true;
+    appendPipelineStages(plugin, stagePlugins);
+  }
+  if (!isPipelined)
+    return {};
+
+  std::vector<std::vector<std::shared_ptr<Plugin>>> stages;
+  bool lastStageIsTileable = false;
+  for (auto &plugin : stagePlugins) {
+    bool isTileable = plugin->isTileable() && !isAutomated(*plugin);
+    if (isTileable && lastStageIsTileable) {
+      stages.back().push_back(plugin);
+    } else {
+      stages.push_back({plugin});
+    }
+    lastStageIsTileable = isTileable;
+  }
+
+  if (stages.size() < 2)
+    return {};
+  return stages;
+}
+
+template <typename SampleType>
+int processPipelined(
+    juce::AudioBuffer<SampleType> &ioBuffer, juce::dsp::ProcessSpec spec,
+    const std::vector<std::vector<std::shared_ptr<Plugin>>> &stages,
+    int numSamples, bool fused);
+
+/**
+ * Return the total latency (in samples) that the provided plugins expect to
+ * add to their output. Only valid once the plugins have been prepared.
+ */
+inline int
+getTotalLatencyHint(const std::vector<std::shared_ptr<Plugin>> &plugins) {
+  int totalLatency = 0;
+  for (auto &plugin : plugins) {
+    if (plugin)
+      totalLatency += plugin->getLatencyHint();
+  }
+  return totalLatency;
+}
+
+/**
+ * Run the provided plugins over the buffer in turn. If `fused` is true, every
+ * run of two or more consecutive tileable plugins is run together, tile by
+ * tile (see processTiles), rather than one plugin after the other.
+ *
+ * If `tileMajor` is true, every plugin is run over each block of
+ * spec.maximumBlockSize samples before any plugin sees the next block, rather
+ * than each plugin processing the entire buffer before the next plugin starts.
+ * This produces the same audio, but avoids streaming the entire buffer through
+ * memory once per plugin when processing long buffers.
+ *
+ * If `numInputSamples` is provided, only that many samples at the start of
+ * ioBuffer contain input audio; the rest must be silent, and is used as room
+ * for any latency the plugins add. Callers that size ioBuffer with
+ * getTotalLatencyHint() this way avoid reallocating it here.
+ */
+template <typename SampleType>
+int process(juce::AudioBuffer<SampleType> &ioBuffer,
+            juce::dsp::ProcessSpec spec,
+            const std::vector<std::shared_ptr<Plugin>> &plugins,
+            bool isProbablyLastProcessCall, bool fused = false,
+            bool tileMajor = false, int numInputSamples = -1) {
+  int totalOutputLatencySamples = 0;
+  int expectedOutputLatency = getTotalLatencyHint(plugins);
 
-  if (expectedOutputLatency > 0 && isProbablyLastProcessCall) {
+  int intendedOutputBufferSize =
+      numInputSamples < 0 ? ioBuffer.getNumSamples() : numInputSamples;
+
+  // Pipelines compensate for latency stage by stage, so only run them when
+  // it's fine to flush each stage with silence (i.e.: on the last call):
+  if (isProbablyLastProcessCall) {
+    auto stages = getPipelineStages(plugins);
+    if (!stages.empty()) {
+      return processPipelined(ioBuffer, spec, stages, intendedOutputBufferSize,
+                              fused);
+    }
+  }
+
+  if (expectedOutputLatency > 0 && isProbablyLastProcessCall &&
+      intendedOutputBufferSize + expectedOutputLatency >
+          ioBuffer.getNumSamples()) {
     // This is a hint - it's possible that the plugin(s) latency values
     // will change and we'll have to reallocate again later on.
     ioBuffer.setSize(ioBuffer.getNumChannels(),
-                     ioBuffer.getNumSamples() + expectedOutputLatency,
+                     intendedOutputBufferSize + expectedOutputLatency,
                      /* keepExistingContent= */ true,
                      /* clearExtraSpace= */ true);
+
+    if (getProfilingEnabled()) {
+      for (auto &plugin : plugins) {
+        if (plugin && plugin->getLatencyHint() > 0)
+          ProfilingScope::recordReallocation(plugin.get());
+      }
+    }
   }
 
   // Actually run the plugins over the ioBuffer, in small chunks, to minimize
@@ -58,10 +228,13 @@ inline int process(juce::AudioBuffer<float> &ioBuffer,
   int startOfOutputInBuffer = 0;
   int lastSampleInBuffer = 0;
 
-  for (auto plugin : plugins) {
-    if (!plugin)
-      continue;
+  // The plugin run by the current stage (if there's only one), to which any
+  // reallocations of ioBuffer are attributed when profiling:
+  Plugin *stagePlugin = nullptr;
 
+  // Run a single stage (a plugin, or every plugin at once) over the whole
+  // buffer, one block at a time, compensating for any latency it introduces:
+  const auto runStage = [&](auto &&processBlock) {
     int pluginSamplesReceived = 0;
 
     unsigned int blockSize = spec.maximumBlockSize;
@@ -73,12 +246,12 @@ inline int process(juce::AudioBuffer<float> &ioBuffer,
                    static_cast<unsigned int>(intendedOutputBufferSize));
       blockSize = blockEnd - blockStart;
 
-      auto ioBlock = juce::dsp::AudioBlock<float>(
+      auto ioBlock = juce::dsp::AudioBlock<SampleType>(
           ioBuffer.getArrayOfWritePointers(), ioBuffer.getNumChannels(),
           blockStart, blockSize);
-      juce::dsp::ProcessContextReplacing<float> context(ioBlock);
+      juce::dsp::ProcessContextReplacing<SampleType> context(ioBlock);
 
-      int outputSamples = plugin->process(context);
+      int outputSamples = processBlock(context);
       if (outputSamples < 0) {
         throw std::runtime_error(
             "A plugin returned a negative number of output samples! "
@@ -112,14 +285,14 @@ inline int process(juce::AudioBuffer<float> &ioBuffer,
           // Only move the samples received before this latest block was
           // rendered, as audio is right-aligned within blocks by convention.
           int samplesToMove = pluginSamplesReceived - outputSamples;
-          float *outputStart =
+          SampleType *outputStart =
               ioBuffer.getWritePointer(c) + totalOutputLatencySamples;
-          float *expectedOutputEnd =
+          SampleType *expectedOutputEnd =
               ioBuffer.getWritePointer(c) + blockEnd - outputSamples;
-          float *expectedOutputStart = expectedOutputEnd - samplesToMove;
+          SampleType *expectedOutputStart = expectedOutputEnd - samplesToMove;
 
           std::memmove((char *)expectedOutputStart, (char *)outputStart,
-                       sizeof(float) * samplesToMove);
+                       sizeof(SampleType) * samplesToMove);
         }
       }
 
@@ -139,8 +312,68 @@ inline int process(juce::AudioBuffer<float> &ioBuffer,
           ioBuffer.setSize(ioBuffer.getNumChannels(), intendedOutputBufferSize,
                            /* keepExistingContent= */ true,
                            /* clearExtraSpace= */ true);
+          ProfilingScope::recordReallocation(stagePlugin);
+        }
+      }
+    }
+  };
+
+  const auto numPlugins =
+      std::count_if(plugins.begin(), plugins.end(),
+                    [](auto &plugin) { return plugin != nullptr; });
+
+  if (tileMajor && numPlugins > 1) {
+    // Run every plugin over each block before moving on to the next block,
+    // so that each block is still in cache when the next plugin processes it
+    // (just as a Chain does). Each plugin buffers its own latency, so the
+    // output of this block may be shorter than the block itself:
+    SampleType **blockChannels = (SampleType **)alloca(
+        ioBuffer.getNumChannels() * sizeof(SampleType *));
+    runStage(
+        [&](const juce::dsp::ProcessContextReplacing<SampleType> &context) {
+          auto block = context.getOutputBlock();
+          for (int c = 0; c < ioBuffer.getNumChannels(); c++) {
+            blockChannels[c] = block.getChannelPointer(c);
+          }
+          juce::AudioBuffer<SampleType> blockBuffer(
+              blockChannels, ioBuffer.getNumChannels(),
+              (int)block.getNumSamples());
+          return process(blockBuffer, spec, plugins, false, fused);
+        });
+  } else {
+    std::vector<Plugin *> tileablePlugins;
+    for (size_t pluginIndex = 0; pluginIndex < plugins.size(); pluginIndex++) {
+      auto &plugin = plugins[pluginIndex];
+      if (!plugin)
+        continue;
+
+      // Automated plugins are run in shorter sub-blocks of their own (see
+      // processWithAutomation), so can't be fused with their neighbours:
+      if (fused && plugin->isTileable() && !isAutomated(*plugin)) {
+        tileablePlugins.clear();
+        size_t runEnd = pluginIndex;
+        for (; runEnd < plugins.size(); runEnd++) {
+          if (!plugins[runEnd])
+            continue;
+          if (!plugins[runEnd]->isTileable() ||
+              isAutomated(*plugins[runEnd]))
+            break;
+          tileablePlugins.push_back(plugins[runEnd].get());
+        }
+
+        if (tileablePlugins.size() > 1) {
+          processTiles(ioBuffer, spec, tileablePlugins, startOfOutputInBuffer,
+                       intendedOutputBufferSize);
+          pluginIndex = runEnd - 1;
+          continue;
         }
       }
+
+      stagePlugin = plugin.get();
+      runStage(
+          [&](const juce::dsp::ProcessContextReplacing<SampleType> &context) {
+            return processWithAutomation(*plugin, context, spec.sampleRate);
+          });
     }
   }
 
@@ -155,45 +388,85 @@ inline int process(juce::AudioBuffer<float> &ioBuffer,
 }
 
 /**
- * Process a given audio buffer through a list of
- * Pedalboard plugins at a given sample rate.
- * Only supports float processing, not double, at the moment.
+ * Get a sorted list of every plugin in the provided list, including any
+ * plugins nested within PluginContainers.
  */
-py::array_t<float>
-processFloat32(const py::array_t<float, py::array::c_style> inputArray,
-               double sampleRate, std::vector<std::shared_ptr<Plugin>> plugins,
-               unsigned int bufferSize, bool reset) {
-  const ChannelLayout inputChannelLayout = detectChannelLayout(inputArray);
-  juce::AudioBuffer<float> ioBuffer = copyPyArrayIntoJuceBuffer(inputArray);
-  int totalOutputLatencySamples;
+inline std::vector<std::shared_ptr<Plugin>>
+getAllPluginsSorted(const std::vector<std::shared_ptr<Plugin>> &plugins) {
+  std::vector<std::shared_ptr<Plugin>> allPlugins;
+  for (auto &plugin : plugins) {
+    if (!plugin)
+      continue;
+    allPlugins.push_back(plugin);
+    if (auto pluginContainer = dynamic_cast<PluginContainer *>(plugin.get())) {
+      auto children = pluginContainer->getAllPlugins();
+      allPlugins.insert(allPlugins.end(), children.begin(), children.end());
+    }
+  }
 
-  {
-    py::gil_scoped_release release;
+  std::sort(
+      allPlugins.begin(), allPlugins.end(),
+      [](const std::shared_ptr<Plugin> lhs, const std::shared_ptr<Plugin> rhs) {
+        return lhs.get() < rhs.get();
+      });
+  return allPlugins;
+}
 
-    bufferSize = std::min(bufferSize, (unsigned int)ioBuffer.getNumSamples());
+/**
+ * Holds the processing mutex of each of a list of plugins, and releases them
+ * (in reverse order) when destroyed. Returned by lockAllPlugins().
+ */
+class PluginLocks {
+public:
+  PluginLocks(std::vector<std::shared_ptr<Plugin>> &&pluginsToLock)
+      : lockedPlugins(std::move(pluginsToLock)) {
+    for (auto &plugin : lockedPlugins)
+      plugin->mutex.lock();
+  }
 
-    // We'd pass multiple arguments to scoped_lock here, but we don't know how
-    // many plugins have been passed at compile time - so instead, we do our own
-    // deadlock-avoiding multiple-lock algorithm here. By locking each plugin
-    // only in order of its pointers, we're guaranteed to avoid deadlocks with
-    // other threads that may be running this same code on the same plugins.
-    std::vector<std::shared_ptr<Plugin>> allPlugins;
-    for (auto plugin : plugins) {
-      if (!plugin)
-        continue;
-      allPlugins.push_back(plugin);
-      if (auto pluginContainer =
-              dynamic_cast<PluginContainer *>(plugin.get())) {
-        auto children = pluginContainer->getAllPlugins();
-        allPlugins.insert(allPlugins.end(), children.begin(), children.end());
-      }
-    }
+  PluginLocks(PluginLocks &&other)
+      : lockedPlugins(std::move(other.lockedPlugins)) {
+    other.lockedPlugins.clear();
+  }
 
-    std::sort(allPlugins.begin(), allPlugins.end(),
-              [](const std::shared_ptr<Plugin> lhs,
-                 const std::shared_ptr<Plugin> rhs) {
-                return lhs.get() < rhs.get();
-              });
+  PluginLocks(const PluginLocks &) = delete;
+  PluginLocks &operator=(const PluginLocks &) = delete;
+  PluginLocks &operator=(PluginLocks &&) = delete;
+
+  ~PluginLocks() {
+    for (auto it = lockedPlugins.rbegin(); it != lockedPlugins.rend(); ++it)
+      (*it)->mutex.unlock();
+  }
+
+  const std::vector<std::shared_ptr<Plugin>> &getLockedPlugins() const {
+    return lockedPlugins;
+  }
+
+private:
+  std::vector<std::shared_ptr<Plugin>> lockedPlugins;
+};
+
+/**
+ * Lock every plugin in the provided list (including any plugins nested within
+ * PluginContainers) for the lifetime of the returned object.
+ *
+ * We'd pass multiple arguments to scoped_lock here, but we don't know how
+ * many plugins have been passed at compile time - so instead, we do our own
+ * deadlock-avoiding multiple-lock algorithm here. By locking each plugin
+ * only in order of its pointers, we're guaranteed to avoid deadlocks with
+ * other threads that may be running this same code on the same plugins.
+ *
+ * Only each plugin's processing mutex is held; the plugin lists of any
+ * PluginContainers are not locked, so they can still be read from other
+ * threads during processing. (Modifying a container requires its processing
+ * mutex, so containers can't be modified until the returned locks are
+ * released.)
+ */
+inline PluginLocks
+lockAllPlugins(const std::vector<std::shared_ptr<Plugin>> &plugins) {
+  while (true) {
+    std::vector<std::shared_ptr<Plugin>> allPlugins =
+        getAllPluginsSorted(plugins);
 
     bool containsDuplicates =
         std::adjacent_find(allPlugins.begin(), allPlugins.end()) !=
@@ -206,33 +479,113 @@ processFloat32(const py::array_t<float, py::array::c_style> inputArray,
           "ensure that no duplicate plugins are present before calling.");
     }
 
-    std::vector<std::unique_ptr<std::scoped_lock<std::mutex>>> pluginLocks;
-    for (auto plugin : allPlugins) {
-      pluginLocks.push_back(
-          std::make_unique<std::scoped_lock<std::mutex>>(plugin->mutex));
-    }
+    PluginLocks pluginLocks(std::move(allPlugins));
 
-    if (reset) {
-      for (auto plugin : plugins) {
-        if (!plugin)
-          continue;
-        plugin->reset();
-      }
+    // A container may have been modified between listing its plugins and
+    // locking it. If so, we may have locked the wrong set of plugins, so
+    // release everything and try again:
+    if (getAllPluginsSorted(plugins) == pluginLocks.getLockedPlugins()) {
+      return pluginLocks;
     }
+  }
+}
 
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = static_cast<juce::uint32>(bufferSize);
-    spec.numChannels = static_cast<juce::uint32>(ioBuffer.getNumChannels());
+/**
+ * Prepare and run a list of (already locked) plugins over an entire buffer of
+ * audio, optionally resetting them first. Returns the number of samples of
+ * latency at the start of the buffer that should be discarded.
+ */
+inline juce::dsp::ProcessSpec
+preparePlugins(int numChannels, int numSamples, double sampleRate,
+               const std::vector<std::shared_ptr<Plugin>> &plugins,
+               unsigned int bufferSize, bool reset) {
+  bufferSize = std::min(bufferSize, (unsigned int)numSamples);
 
-    for (auto plugin : plugins) {
+  if (reset) {
+    for (auto &plugin : plugins) {
       if (!plugin)
         continue;
-      plugin->prepare(spec);
+      plugin->reset();
     }
+    rewindAutomation(getAllPluginsSorted(plugins));
+  }
+
+  juce::dsp::ProcessSpec spec;
+  spec.sampleRate = sampleRate;
+  spec.maximumBlockSize = static_cast<juce::uint32>(bufferSize);
+  spec.numChannels = static_cast<juce::uint32>(numChannels);
+
+  for (auto &plugin : plugins) {
+    if (!plugin)
+      continue;
+    plugin->prepare(spec);
+  }
+
+  return spec;
+}
+
+template <typename SampleType>
+juce::dsp::ProcessSpec
+preparePlugins(const juce::AudioBuffer<SampleType> &ioBuffer, double sampleRate,
+               const std::vector<std::shared_ptr<Plugin>> &plugins,
+               unsigned int bufferSize, bool reset) {
+  return preparePlugins(ioBuffer.getNumChannels(), ioBuffer.getNumSamples(),
+                        sampleRate, plugins, bufferSize, reset);
+}
+
+template <typename SampleType>
+int processBuffer(juce::AudioBuffer<SampleType> &ioBuffer, double sampleRate,
+                  const std::vector<std::shared_ptr<Plugin>> &plugins,
+                  unsigned int bufferSize, bool reset) {
+  juce::dsp::ProcessSpec spec =
+      preparePlugins(ioBuffer, sampleRate, plugins, bufferSize, reset);
+
+  // Actually run the process method of all plugins.
+  int samplesReturned = process(ioBuffer, spec, plugins, reset,
+                                /* fused= */ false, /* tileMajor= */ true);
+  return ioBuffer.getNumSamples() - samplesReturned;
+}
+
+/**
+ * Process a given audio buffer through a list of
+ * Pedalboard plugins at a given sample rate.
+ * Audio is processed (and returned) with the same sample type as the input;
+ * plugins that can't process 64-bit audio natively will convert each block
+ * to 32-bit and back as necessary.
+ */
+template <typename SampleType>
+py::array_t<SampleType>
+processArray(const py::array_t<SampleType, py::array::c_style> inputArray,
+             double sampleRate, std::vector<std::shared_ptr<Plugin>> plugins,
+             unsigned int bufferSize, bool reset) {
+  const ChannelLayout inputChannelLayout = detectChannelLayout(inputArray);
+  py::buffer_info inputInfo = inputArray.request();
+  auto [numChannels, numSamples] =
+      getNumChannelsAndSamples(inputInfo, inputChannelLayout);
+  auto ioBufferLease =
+      ScratchBuffers<SampleType>::acquire(numChannels, numSamples);
+  juce::AudioBuffer<SampleType> &ioBuffer = *ioBufferLease;
+  int totalOutputLatencySamples;
+
+  {
+    py::gil_scoped_release release;
+    auto pluginLocks = lockAllPlugins(plugins);
+    juce::dsp::ProcessSpec spec = preparePlugins(
+        numChannels, numSamples, sampleRate, plugins, bufferSize, reset);
 
-    // Actually run the process method of all plugins.
-    int samplesReturned = process(ioBuffer, spec, plugins, reset);
+    // Now that the plugins know their latency, size the output buffer once
+    // with enough room for it, rather than growing it in process():
+    int latencyHint = reset ? getTotalLatencyHint(plugins) : 0;
+    ioBuffer.setSize(numChannels, numSamples + latencyHint,
+                     /* keepExistingContent= */ false,
+                     /* clearExtraSpace= */ false,
+                     /* avoidReallocating= */ true);
+    copyBufferInfoIntoJuceBuffer(inputInfo, inputChannelLayout, ioBuffer);
+    ioBuffer.clear(numSamples, latencyHint);
+
+    int samplesReturned = process(ioBuffer, spec, plugins, reset,
+                                  /* fused= */ false, /* tileMajor= */ true,
+                                  /* numInputSamples= */ numSamples);
     totalOutputLatencySamples = ioBuffer.getNumSamples() - samplesReturned;
   }
 
@@ -241,24 +594,941 @@ processFloat32(const py::array_t<float, py::array::c_style> inputArray,
                                    inputArray.request().ndim);
 }
 
-py::array_t<float> process(py::array inputArray, double sampleRate,
-                           const std::vector<std::shared_ptr<Plugin>> plugins,
-                           unsigned int bufferSize, bool reset) {
-  py::array_t<float, py::array::c_style> float32InputArray;
+/**
+ * Return one list of plugins per worker thread, for up to `numWorkers`
+ * workers (by default, one per CPU core) but no more than `numItems`. The
+ * first worker uses the plugins provided; every other worker gets its own
+ * clone of them. Must be called while the provided plugins are locked.
+ *
+ * If any of the provided plugins cannot be cloned (or are automated, as
+ * clones don't copy automation curves), only one worker is returned.
+ */
+inline std::vector<std::vector<std::shared_ptr<Plugin>>>
+clonePluginsForWorkers(const std::vector<std::shared_ptr<Plugin>> &plugins,
+                       size_t numItems,
+                       std::optional<unsigned int> numWorkers) {
+  unsigned int maximumWorkers =
+      numWorkers ? *numWorkers
+                 : std::max(1u, std::thread::hardware_concurrency());
+  maximumWorkers =
+      std::min(maximumWorkers, static_cast<unsigned int>(numItems));
+
+  for (auto &plugin : getAllPluginsSorted(plugins)) {
+    if (isAutomated(*plugin))
+      maximumWorkers = 1;
+  }
+
+  std::vector<std::vector<std::shared_ptr<Plugin>>> pluginsPerWorker = {
+      plugins};
+  for (unsigned int i = 1; i < maximumWorkers; i++) {
+    std::vector<std::shared_ptr<Plugin>> clones;
+    for (auto &plugin : plugins) {
+      if (!plugin)
+        continue;
+      auto clone = plugin->clone();
+      if (!clone) {
+        // At least one plugin can't be cloned; fall back to a single worker.
+        return {plugins};
+      }
+      clones.push_back(clone);
+    }
+    pluginsPerWorker.push_back(clones);
+  }
+  return pluginsPerWorker;
+}
+
+/**
+ * Call processItem(itemIndex, workerIndex) once for every item in
+ * [0, numItems), spread across one native thread per worker (the first of
+ * which is the calling thread). Items are handed out to whichever worker is
+ * free next. If any call throws, no further items are started and the first
+ * worker's exception is rethrown once all workers have stopped.
+ */
+template <typename ProcessItem>
+void runOnWorkers(size_t numItems, size_t numWorkers,
+                  ProcessItem &&processItem) {
+  std::atomic<size_t> nextItemIndex{0};
+  std::vector<std::exception_ptr> workerExceptions(numWorkers);
+
+  auto runWorker = [&](size_t workerIndex) {
+    try {
+      while (true) {
+        size_t itemIndex = nextItemIndex++;
+        if (itemIndex >= numItems)
+          break;
+        processItem(itemIndex, workerIndex);
+      }
+    } catch (...) {
+      workerExceptions[workerIndex] = std::current_exception();
+      // Stop all other workers from picking up new items:
+      nextItemIndex = numItems;
+    }
+  };
+
+  std::vector<std::thread> workerThreads;
+  for (size_t i = 1; i < numWorkers; i++) {
+    workerThreads.emplace_back(runWorker, i);
+  }
+  runWorker(0);
+  for (auto &thread : workerThreads) {
+    thread.join();
+  }
+
+  for (auto &exception : workerExceptions) {
+    if (exception)
+      std::rethrow_exception(exception);
+  }
+}
+
+/**
+ * Run a list of stages (each of which is a list of plugins) over the first
+ * `numSamples` samples of ioBuffer, with each stage on its own thread. Each
+ * stage processes one block (of spec.maximumBlockSize samples) at a time,
+ * passing its output to the next stage through a lock-free queue, so that
+ * every stage can work on a different block at once. Produces the same
+ * output as running each stage over the entire buffer in turn with
+ * isProbablyLastProcessCall set: each stage is fed silence after the end of
+ * its input until it has compensated for its own latency, so every stage
+ * outputs exactly `numSamples` samples, which are written back into
+ * ioBuffer. Returns `numSamples`.
+ */
+template <typename SampleType>
+int processPipelined(
+    juce::AudioBuffer<SampleType> &ioBuffer, juce::dsp::ProcessSpec spec,
+    const std::vector<std::vector<std::shared_ptr<Plugin>>> &stages,
+    int numSamples, bool fused) {
+  struct Queue {
+    AudioRingBuffer<SampleType> audio;
+    juce::WaitableEvent audioAvailable;
+    juce::WaitableEvent spaceAvailable;
+  };
+
+  const int numChannels = ioBuffer.getNumChannels();
+  const int blockSize = std::max(1, (int)spec.maximumBlockSize);
+
+  // The queue between stage i and stage i + 1:
+  std::vector<std::unique_ptr<Queue>> queues;
+  for (size_t i = 0; i + 1 < stages.size(); i++) {
+    queues.push_back(std::make_unique<Queue>());
+    queues.back()->audio.setSize(numChannels,
+                                 blockSize * PIPELINE_QUEUE_BLOCKS);
+  }
+
+  // Taken up front, as getWritePointer isn't safe to call from several
+  // threads at once. The first stage reads from (and the last stage writes
+  // to) ioBuffer; the last stage never writes past where the first stage has
+  // already read, so they never touch the same samples at once.
+  SampleType *const *ioChannels = ioBuffer.getArrayOfWritePointers();
+
+  // Set if any stage fails, so that the others stop waiting for it:
+  std::atomic<bool> failed{false};
+  const auto waitUntil = [&](juce::WaitableEvent &event, auto &&isReady) {
+    while (!isReady()) {
+      if (failed)
+        return false;
+      event.wait(PIPELINE_WAIT_TIMEOUT_MS);
+    }
+    return true;
+  };
+
+  const auto runStage = [&](size_t stageIndex) {
+    Queue *input = stageIndex > 0 ? queues[stageIndex - 1].get() : nullptr;
+    Queue *output =
+        stageIndex < queues.size() ? queues[stageIndex].get() : nullptr;
+
+    juce::AudioBuffer<SampleType> stageBuffer(numChannels, blockSize);
+    SampleType **channels =
+        (SampleType **)alloca(numChannels * sizeof(SampleType *));
+
+    // The number of samples this stage has been given (including any
+    // silence after the end of its input), and has output:
+    int samplesConsumed = 0;
+    int samplesProduced = 0;
+
+    while (samplesProduced < numSamples) {
+      // Mirrors process(): this stage's input is extended by however much
+      // latency it has added so far, so the blocks it sees are identical.
+      int thisBlockSize = std::min(blockSize, numSamples - samplesProduced);
+      int samplesOfInput =
+          std::max(0, std::min(thisBlockSize, numSamples - samplesConsumed));
+
+      for (int c = 0; c < numChannels; c++)
+        channels[c] = stageBuffer.getWritePointer(c);
+
+      if (!input) {
+        for (int c = 0; c < numChannels; c++) {
+          std::memcpy(channels[c], ioChannels[c] + samplesConsumed,
+                      samplesOfInput * sizeof(SampleType));
+        }
+      } else if (samplesOfInput > 0) {
+        if (!waitUntil(input->audioAvailable, [&]() {
+              return input->audio.getNumReady() >= samplesOfInput;
+            }))
+          return;
+        input->audio.read(channels, numChannels, samplesOfInput);
+        input->spaceAvailable.signal();
+      }
+      stageBuffer.clear(samplesOfInput, thisBlockSize - samplesOfInput);
+      samplesConsumed += thisBlockSize;
+
+      juce::AudioBuffer<SampleType> block(channels, numChannels,
+                                          thisBlockSize);
+      int outputSamples = process(block, spec, stages[stageIndex], false,
+                                  fused);
+
+      // As per Plugin::process, output is right-aligned in the block:
+      for (int c = 0; c < numChannels; c++)
+        channels[c] += thisBlockSize - outputSamples;
+
+      if (!output) {
+        for (int c = 0; c < numChannels; c++) {
+          std::memcpy(ioChannels[c] + samplesProduced, channels[c],
+                      outputSamples * sizeof(SampleType));
+        }
+      } else if (outputSamples > 0) {
+        if (!waitUntil(output->spaceAvailable, [&]() {
+              return output->audio.getFreeSpace() >= outputSamples;
+            }))
+          return;
+        output->audio.write(channels, numChannels, outputSamples);
+        output->audioAvailable.signal();
+      }
+      samplesProduced += outputSamples;
+    }
+  };
+
+  runOnWorkers(stages.size(), stages.size(),
+               [&](size_t stageIndex, size_t) {
+                 try {
+                   runStage(stageIndex);
+                 } catch (...) {
+                   failed = true;
+                   for (auto &queue : queues) {
+                     queue->audioAvailable.signal();
+                     queue->spaceAvailable.signal();
+                   }
+                   throw;
+                 }
+               });
+
+  ioBuffer.setSize(numChannels, numSamples,
+                   /* keepExistingContent= */ true,
+                   /* clearExtraSpace= */ true,
+                   /* avoidReallocating= */ true);
+  return numSamples;
+}
+
+/**
+ * Process a 3D array of shape (batch_size, num_channels, num_samples) (or
+ * (batch_size, num_samples, num_channels)) through a list of plugins,
+ * treating each item along the first axis as an independent stream of audio
+ * that's processed from a clean state, as if passed to processArray with
+ * reset=true. Items are processed in parallel, as in processBatch, and written
+ * into a single output array of the same shape as the input.
+ */
+template <typename SampleType>
+py::array_t<SampleType> processBatchedArray(
+    const py::array_t<SampleType, py::array::c_style> inputArray,
+    double sampleRate, const std::vector<std::shared_ptr<Plugin>> &plugins,
+    unsigned int bufferSize, std::optional<unsigned int> numWorkers = {}) {
+  py::buffer_info inputInfo = inputArray.request();
+  if (inputInfo.ndim != 3) {
+    throw std::runtime_error(
+        "Number of input dimensions must be 3 for batched processing (got " +
+        std::to_string(inputInfo.ndim) + ").");
+  }
+
+  const size_t batchSize = inputInfo.shape[0];
+  ChannelLayout channelLayout;
+  if (inputInfo.shape[2] < inputInfo.shape[1]) {
+    channelLayout = ChannelLayout::Interleaved;
+  } else if (inputInfo.shape[1] < inputInfo.shape[2]) {
+    channelLayout = ChannelLayout::NotInterleaved;
+  } else {
+    throw std::runtime_error("Unable to determine channel layout from shape!");
+  }
+
+  const unsigned int numChannels =
+      channelLayout == ChannelLayout::NotInterleaved ? inputInfo.shape[1]
+                                                     : inputInfo.shape[2];
+  const unsigned int numSamples =
+      channelLayout == ChannelLayout::NotInterleaved ? inputInfo.shape[2]
+                                                     : inputInfo.shape[1];
+  if (numChannels == 0) {
+    throw std::runtime_error("No channels passed!");
+  }
+
+  py::array_t<SampleType> outputArray(
+      {inputInfo.shape[0], inputInfo.shape[1], inputInfo.shape[2]});
+  const SampleType *inputPointer = static_cast<SampleType *>(inputInfo.ptr);
+  SampleType *outputPointer =
+      static_cast<SampleType *>(outputArray.request().ptr);
+  const size_t itemSize = (size_t)numChannels * numSamples;
+
+  if (batchSize == 0 || numSamples == 0) {
+    std::copy(inputPointer, inputPointer + batchSize * itemSize,
+              outputPointer);
+    return outputArray;
+  }
+
+  {
+    py::gil_scoped_release release;
+    auto pluginLocks = lockAllPlugins(plugins);
+    auto pluginsPerWorker =
+        clonePluginsForWorkers(plugins, batchSize, numWorkers);
+
+    // Each worker reuses the same buffer for every item it processes:
+    std::vector<juce::AudioBuffer<SampleType>> workerBuffers(
+        pluginsPerWorker.size());
+
+    runOnWorkers(batchSize, pluginsPerWorker.size(), [&](size_t itemIndex,
+                                                         size_t workerIndex) {
+      auto &workerPlugins = pluginsPerWorker[workerIndex];
+      auto &ioBuffer = workerBuffers[workerIndex];
+      const SampleType *itemInput = inputPointer + itemIndex * itemSize;
+      SampleType *itemOutput = outputPointer + itemIndex * itemSize;
+
+      juce::dsp::ProcessSpec spec =
+          preparePlugins(numChannels, numSamples, sampleRate, workerPlugins,
+                         bufferSize, /* reset= */ true);
+      int latencyHint = getTotalLatencyHint(workerPlugins);
+      ioBuffer.setSize(numChannels, numSamples + latencyHint,
+                       /* keepExistingContent= */ false,
+                       /* clearExtraSpace= */ false,
+                       /* avoidReallocating= */ true);
+
+      if (channelLayout == ChannelLayout::Interleaved) {
+        deinterleaveSamples(itemInput, ioBuffer.getArrayOfWritePointers(),
+                            numChannels, numSamples);
+      } else {
+        for (unsigned int c = 0; c < numChannels; c++) {
+          ioBuffer.copyFrom(c, 0, itemInput + (size_t)c * numSamples,
+                            numSamples);
+        }
+      }
+      ioBuffer.clear(numSamples, latencyHint);
+
+      int samplesReturned =
+          process(ioBuffer, spec, workerPlugins,
+                  /* isProbablyLastProcessCall= */ true,
+                  /* fused= */ false, /* tileMajor= */ true,
+                  /* numInputSamples= */ numSamples);
+
+      // Every item in the output has the same length as its input, so if the
+      // plugins returned fewer samples than expected, right-align what they
+      // did return (as processInPlace does) and leave silence before it:
+      int samplesToCopy = std::min(samplesReturned, (int)numSamples);
+      int outputLatencySamples = numSamples - samplesToCopy;
+      int outputStart = ioBuffer.getNumSamples() - samplesReturned;
+
+      if (channelLayout == ChannelLayout::Interleaved) {
+        SampleType *outputFrames =
+            itemOutput + (size_t)outputLatencySamples * numChannels;
+        std::fill(itemOutput, outputFrames, (SampleType)0);
+        const SampleType **channelPointers =
+            (const SampleType **)alloca(numChannels * sizeof(SampleType *));
+        for (unsigned int c = 0; c < numChannels; c++) {
+          channelPointers[c] = ioBuffer.getReadPointer(c, outputStart);
+        }
+        interleaveSamples(channelPointers, outputFrames, numChannels,
+                          samplesToCopy);
+      } else {
+        for (unsigned int c = 0; c < numChannels; c++) {
+          SampleType *channelOutput = itemOutput + (size_t)c * numSamples;
+          std::fill(channelOutput, channelOutput + outputLatencySamples,
+                    (SampleType)0);
+          const SampleType *channelBuffer =
+              ioBuffer.getReadPointer(c, outputStart);
+          std::copy(channelBuffer, channelBuffer + samplesToCopy,
+                    channelOutput + outputLatencySamples);
+        }
+      }
+    });
+  }
+
+  return outputArray;
+}
+
+inline void throwIfUnsupportedSampleType(const py::array &inputArray) {
   switch (inputArray.dtype().char_()) {
   case 'f':
-    float32InputArray = inputArray;
-    break;
   case 'd':
-    float32InputArray = inputArray.attr("astype")("float32");
-    break;
+    return;
   default:
     throw py::type_error("Pedalboard only supports 32-bit and 64-bit floating "
                          "point audio for processing.");
   }
+}
+
+inline py::array process(py::array inputArray, double sampleRate,
+                         const std::vector<std::shared_ptr<Plugin>> plugins,
+                         unsigned int bufferSize, bool reset) {
+  throwIfUnsupportedSampleType(inputArray);
+  if (inputArray.ndim() == 3) {
+    // Each item in a batch is an independent stream, so can't continue on
+    // from a previous call:
+    if (!reset) {
+      throw std::domain_error(
+          "Batched (3-dimensional) audio can only be processed with "
+          "reset=True, as each item in the batch is processed independently.");
+    }
+    if (inputArray.dtype().char_() == 'd') {
+      return processBatchedArray<double>(
+          py::array_t<double, py::array::c_style>::ensure(inputArray),
+          sampleRate, plugins, bufferSize);
+    }
+    return processBatchedArray<float>(
+        py::array_t<float, py::array::c_style>::ensure(inputArray), sampleRate,
+        plugins, bufferSize);
+  }
 
-  return processFloat32(float32InputArray, sampleRate, plugins, bufferSize,
-                        reset);
+  if (inputArray.dtype().char_() == 'd') {
+    return processArray<double>(
+        py::array_t<double, py::array::c_style>::ensure(inputArray),
+        sampleRate, plugins, bufferSize, reset);
+  }
+  return processArray<float>(
+      py::array_t<float, py::array::c_style>::ensure(inputArray), sampleRate,
+      plugins, bufferSize, reset);
 }
 
-} // namespace Pedalboard
\ No newline at end of file
+/**
+ * Return the number of samples (per channel) in a 1D, channels-first, or
+ * channels-last audio array.
+ */
+inline py::ssize_t getNumSamples(const py::array &array) {
+  if (array.ndim() == 1) {
+    return array.shape(0);
+  }
+  return std::max(array.shape(0), array.shape(1));
+}
+
+/**
+ * Return a view of the provided (1D, channels-first, or channels-last) audio
+ * array that skips the first `startSample` samples of each channel.
+ */
+inline py::array sliceSamplesFrom(py::array array, py::ssize_t startSample) {
+  py::slice samples(startSample, getNumSamples(array), 1);
+  if (array.ndim() == 2 && array.shape(0) < array.shape(1)) {
+    // Channels-first (non-interleaved):
+    return array[py::make_tuple(py::ellipsis(), samples)]
+        .cast<py::array>();
+  }
+  return array[samples].cast<py::array>();
+}
+
+/**
+ * Process a writeable, C-contiguous, channels-first (or mono) array through a
+ * list of plugins, directly in the array's memory where possible. Returns the
+ * number of samples at the start of the array that were not overwritten with
+ * output (i.e.: because the plugins introduced latency).
+ */
+template <typename SampleType>
+int processInPlaceWithoutCopying(
+    py::array_t<SampleType, py::array::c_style> &inputArray, double sampleRate,
+    const std::vector<std::shared_ptr<Plugin>> &plugins,
+    unsigned int bufferSize, bool reset) {
+  juce::AudioBuffer<SampleType> wrappedBuffer =
+      wrapPyArrayAsJuceBuffer(inputArray);
+  int numSamples = wrappedBuffer.getNumSamples();
+
+  py::gil_scoped_release release;
+  auto pluginLocks = lockAllPlugins(plugins);
+
+  juce::dsp::ProcessSpec spec =
+      preparePlugins(wrappedBuffer, sampleRate, plugins, bufferSize, reset);
+
+  int expectedOutputLatency = getTotalLatencyHint(plugins);
+  if (expectedOutputLatency == 0) {
+    // Never allow process() to grow this buffer, as its memory is owned by
+    // NumPy. If a plugin unexpectedly adds latency anyways, we'll return
+    // fewer samples (as if reset were false).
+    int samplesReturned = process(wrappedBuffer, spec, plugins, false,
+                                  /* fused= */ false, /* tileMajor= */ true);
+    return numSamples - samplesReturned;
+  }
+
+  // These plugins add latency, so we need more room than the provided
+  // array has. Process a copy (with room for that latency), then copy the
+  // (latency-compensated) result back into the provided array.
+  int latencyHint = reset ? expectedOutputLatency : 0;
+  auto ioBufferLease = ScratchBuffers<SampleType>::acquire(
+      wrappedBuffer.getNumChannels(), numSamples + latencyHint);
+  juce::AudioBuffer<SampleType> &ioBuffer = *ioBufferLease;
+  for (int c = 0; c < wrappedBuffer.getNumChannels(); c++) {
+    ioBuffer.copyFrom(c, 0, wrappedBuffer, c, 0, numSamples);
+  }
+  ioBuffer.clear(numSamples, latencyHint);
+  int samplesReturned = process(ioBuffer, spec, plugins, reset,
+                                /* fused= */ false, /* tileMajor= */ true,
+                                /* numInputSamples= */ numSamples);
+  int samplesToCopy = std::min(samplesReturned, numSamples);
+  int outputLatencySamples = numSamples - samplesToCopy;
+
+  for (int c = 0; c < wrappedBuffer.getNumChannels(); c++) {
+    wrappedBuffer.copyFrom(c, outputLatencySamples, ioBuffer, c,
+                           ioBuffer.getNumSamples() - samplesReturned,
+                           samplesToCopy);
+  }
+  return outputLatencySamples;
+}
+
+/**
+ * Process a buffer of audio through a list of plugins, overwriting the
+ * contents of the provided array with the processed audio.
+ *
+ * If the provided array is a writeable, C-contiguous, channels-first (or
+ * mono) float32 or float64 array and the plugins report no latency, the
+ * plugins will operate directly on the array's memory without any copies
+ * being made. Otherwise, the audio will be processed as usual and copied back
+ * into the provided array afterwards.
+ *
+ * Returns the provided array, or (if the plugins returned fewer samples than
+ * were passed in) a view of the end of the provided array that contains only
+ * the samples that were returned.
+ */
+inline py::array
+processInPlace(py::array inputArray, double sampleRate,
+               const std::vector<std::shared_ptr<Plugin>> plugins,
+               unsigned int bufferSize, bool reset) {
+  if (!inputArray.writeable()) {
+    throw std::domain_error(
+        "In-place processing requires a writeable array, but the provided "
+        "array is read-only.");
+  }
+
+  throwIfUnsupportedSampleType(inputArray);
+
+  // Arrays that aren't aligned or aren't in native byte order (i.e.: ">f4")
+  // would be silently converted into a copy by py::array_t::ensure, leaving
+  // the provided array untouched:
+  bool hasNativeSampleType = py::array_t<float>::check_(inputArray) ||
+                             py::array_t<double>::check_(inputArray);
+  bool canProcessWithoutCopying =
+      hasNativeSampleType && (inputArray.flags() & py::array::aligned) &&
+      (inputArray.flags() & py::array::c_style) &&
+      (inputArray.ndim() == 1 ||
+       (inputArray.ndim() == 2 && inputArray.shape(0) < inputArray.shape(1)));
+
+  if (!canProcessWithoutCopying) {
+    py::array outputArray =
+        process(inputArray, sampleRate, plugins, bufferSize, reset);
+    if (inputArray.ndim() == 3) {
+      // Batched output always has the same shape as its input:
+      inputArray[py::ellipsis()] = outputArray;
+      return inputArray;
+    }
+    py::ssize_t numSamples = getNumSamples(inputArray);
+    py::ssize_t samplesReturned = getNumSamples(outputArray);
+    py::array destination =
+        sliceSamplesFrom(inputArray, numSamples - samplesReturned);
+    destination[py::ellipsis()] = outputArray;
+    return numSamples == samplesReturned ? inputArray : destination;
+  }
+
+  int outputLatencySamples;
+  if (inputArray.dtype().char_() == 'd') {
+    auto float64InputArray =
+        py::array_t<double, py::array::c_style>::ensure(inputArray);
+    outputLatencySamples = processInPlaceWithoutCopying(
+        float64InputArray, sampleRate, plugins, bufferSize, reset);
+  } else {
+    auto float32InputArray =
+        py::array_t<float, py::array::c_style>::ensure(inputArray);
+    outputLatencySamples = processInPlaceWithoutCopying(
+        float32InputArray, sampleRate, plugins, bufferSize, reset);
+  }
+
+  if (outputLatencySamples == 0) {
+    return inputArray;
+  }
+  return sliceSamplesFrom(inputArray, outputLatencySamples);
+}
+
+/**
+ * The minimum number of samples (per channel) copied from the input into
+ * memory at once by processInto. Larger windows mean fewer calls into the
+ * plugins; smaller windows use less memory.
+ */
+static constexpr int PROCESS_INTO_WINDOW_SAMPLES = 65536;
+
+/**
+ * A 1D, channels-first, or channels-last audio array of any strides, which
+ * may be longer than a juce::AudioBuffer can hold (i.e.: a memory-mapped
+ * file of many gigabytes).
+ */
+template <typename SampleType> struct StridedAudio {
+  char *data;
+  int numChannels;
+  long long numSamples;
+  py::ssize_t channelStride;
+  py::ssize_t sampleStride;
+
+  StridedAudio(const py::buffer_info &info) : data((char *)info.ptr) {
+    if (info.ndim == 1) {
+      numChannels = 1;
+      numSamples = info.shape[0];
+      channelStride = 0;
+      sampleStride = info.strides[0];
+    } else if (info.ndim == 2 && info.shape[0] < info.shape[1]) {
+      numChannels = info.shape[0];
+      numSamples = info.shape[1];
+      channelStride = info.strides[0];
+      sampleStride = info.strides[1];
+    } else if (info.ndim == 2 && info.shape[1] < info.shape[0]) {
+      numChannels = info.shape[1];
+      numSamples = info.shape[0];
+      channelStride = info.strides[1];
+      sampleStride = info.strides[0];
+    } else if (info.ndim == 2) {
+      throw std::runtime_error(
+          "Unable to determine channel layout from shape!");
+    } else {
+      throw std::runtime_error(
+          "Number of input dimensions must be 1 or 2 (got " +
+          std::to_string(info.ndim) + ").");
+    }
+  }
+
+  void copyTo(juce::AudioBuffer<SampleType> &buffer, long long startSample,
+              int numSamplesToCopy) const {
+    for (int c = 0; c < numChannels; c++) {
+      const char *source =
+          data + c * channelStride + startSample * sampleStride;
+      SampleType *destination = buffer.getWritePointer(c);
+      if (sampleStride == sizeof(SampleType)) {
+        std::memcpy(destination, source, numSamplesToCopy * sizeof(SampleType));
+      } else {
+        for (int i = 0; i < numSamplesToCopy; i++)
+          destination[i] =
+              *(const SampleType *)(source + (py::ssize_t)i * sampleStride);
+      }
+    }
+  }
+
+  void copyFrom(const juce::AudioBuffer<SampleType> &buffer,
+                int bufferStartSample, long long startSample,
+                int numSamplesToCopy) {
+    for (int c = 0; c < numChannels; c++) {
+      char *destination = data + c * channelStride + startSample * sampleStride;
+      const SampleType *source = buffer.getReadPointer(c, bufferStartSample);
+      if (sampleStride == sizeof(SampleType)) {
+        std::memcpy(destination, source, numSamplesToCopy * sizeof(SampleType));
+      } else {
+        for (int i = 0; i < numSamplesToCopy; i++)
+          *(SampleType *)(destination + (py::ssize_t)i * sampleStride) =
+              source[i];
+      }
+    }
+  }
+
+  void clear(long long startSample) {
+    for (int c = 0; c < numChannels; c++) {
+      for (long long i = startSample; i < numSamples; i++)
+        *(SampleType *)(data + c * channelStride + i * sampleStride) = 0;
+    }
+  }
+};
+
+/**
+ * Process an entire audio array through a list of plugins, one window of
+ * samples at a time, writing the output into another array of the same shape.
+ * Only one window of audio (plus whatever the plugins buffer internally) is
+ * ever held in memory, so either array may be larger than memory.
+ *
+ * If `reset` is true, the plugins are flushed with silence after the last
+ * window, so that the output is latency-compensated and fills the entire
+ * output array, just as process() would return. Otherwise, output is written
+ * to the start of the output array as it's produced. Returns the number of
+ * samples written.
+ *
+ * The output array may be the input array itself, as the output never gets
+ * ahead of the input.
+ */
+template <typename SampleType>
+long long processInto(const StridedAudio<SampleType> &input,
+                      StridedAudio<SampleType> &output, double sampleRate,
+                      const std::vector<std::shared_ptr<Plugin>> &plugins,
+                      unsigned int bufferSize, bool reset) {
+  int numChannels = input.numChannels;
+  long long numSamples = input.numSamples;
+  if (numSamples == 0)
+    return 0;
+
+  // Use a whole number of blocks per window, so that the plugins see the same
+  // block sizes as they would if the entire array were processed at once:
+  long long windowSize =
+      ((PROCESS_INTO_WINDOW_SAMPLES + bufferSize - 1) / bufferSize) *
+      (long long)bufferSize;
+  windowSize = std::min(windowSize, numSamples);
+
+  auto pluginLocks = lockAllPlugins(plugins);
+  juce::dsp::ProcessSpec spec =
+      preparePlugins(numChannels, (int)windowSize, sampleRate, plugins,
+                     bufferSize, reset);
+
+  auto ioBufferLease =
+      ScratchBuffers<SampleType>::acquire(numChannels, (int)windowSize);
+  juce::AudioBuffer<SampleType> &ioBuffer = *ioBufferLease;
+
+  long long samplesWritten = 0;
+  const auto writeOutput = [&](int samplesReturned) {
+    int samplesToCopy =
+        (int)std::min((long long)samplesReturned, numSamples - samplesWritten);
+    output.copyFrom(ioBuffer, ioBuffer.getNumSamples() - samplesReturned,
+                    samplesWritten, samplesToCopy);
+    samplesWritten += samplesToCopy;
+  };
+
+  for (long long windowStart = 0; windowStart < numSamples;
+       windowStart += windowSize) {
+    int windowLength = (int)std::min(windowSize, numSamples - windowStart);
+    ioBuffer.setSize(numChannels, windowLength,
+                     /* keepExistingContent= */ false,
+                     /* clearExtraSpace= */ false,
+                     /* avoidReallocating= */ true);
+    input.copyTo(ioBuffer, windowStart, windowLength);
+    writeOutput(process(ioBuffer, spec, plugins, false,
+                        /* fused= */ false, /* tileMajor= */ true));
+  }
+
+  if (reset) {
+    // Feed in silence until the plugins have returned all of their buffered
+    // output, but don't loop forever if a plugin never returns its output:
+    long long maximumSilenceSamples = (numSamples - samplesWritten) +
+                                      getTotalLatencyHint(plugins) + bufferSize;
+    for (long long silenceSamples = 0; samplesWritten < numSamples &&
+                                       silenceSamples < maximumSilenceSamples;
+         silenceSamples += windowSize) {
+      ioBuffer.setSize(numChannels, (int)windowSize,
+                       /* keepExistingContent= */ false,
+                       /* clearExtraSpace= */ false,
+                       /* avoidReallocating= */ true);
+      ioBuffer.clear();
+      writeOutput(process(ioBuffer, spec, plugins, false,
+                          /* fused= */ false, /* tileMajor= */ true));
+    }
+
+    if (samplesWritten < numSamples) {
+      output.clear(samplesWritten);
+      samplesWritten = numSamples;
+    }
+  }
+
+  return samplesWritten;
+}
+
+/**
+ * Return a view of the provided (1D, channels-first, or channels-last) audio
+ * array that contains only the first `endSample` samples of each channel.
+ */
+inline py::array sliceSamplesTo(py::array array, py::ssize_t endSample) {
+  py::slice samples(0, endSample, 1);
+  if (array.ndim() == 2 && array.shape(0) < array.shape(1)) {
+    // Channels-first (non-interleaved):
+    return array[py::make_tuple(py::ellipsis(), samples)]
+        .cast<py::array>();
+  }
+  return array[samples].cast<py::array>();
+}
+
+/**
+ * Process a buffer of audio through a list of plugins, writing the processed
+ * audio into `outputArray` (which must have the same shape and datatype) in
+ * windows of a fixed size, rather than copying the entire input into memory
+ * and allocating a new output array. Either array may be a NumPy memmap.
+ *
+ * Returns the output array, or (if reset is false and the plugins returned
+ * fewer samples than were passed in) a view of the start of the output array
+ * that contains only the samples that were returned.
+ */
+inline py::array processInto(py::array inputArray, py::array outputArray,
+                             double sampleRate,
+                             const std::vector<std::shared_ptr<Plugin>> plugins,
+                             unsigned int bufferSize, bool reset) {
+  throwIfUnsupportedSampleType(inputArray);
+
+  if (bufferSize == 0) {
+    throw std::domain_error("buffer_size must be at least 1.");
+  }
+
+  if (!outputArray.writeable()) {
+    throw std::domain_error("The provided output array is read-only.");
+  }
+
+  if (inputArray.dtype().char_() != outputArray.dtype().char_()) {
+    throw py::type_error(
+        "The output array must have the same datatype as the input (" +
+        py::str(inputArray.dtype()).cast<std::string>() + "), but has " +
+        py::str(outputArray.dtype()).cast<std::string>() + ".");
+  }
+
+  // Samples are read and written in place, so (unlike process()) can't be
+  // converted from another byte order or alignment on the fly:
+  for (const py::array &array : {inputArray, outputArray}) {
+    bool hasNativeSampleType = py::array_t<float>::check_(array) ||
+                               py::array_t<double>::check_(array);
+    if (!hasNativeSampleType || !(array.flags() & py::array::aligned)) {
+      throw py::type_error(
+          "Processing into an output array requires aligned arrays in "
+          "native byte order, but got an array with datatype " +
+          py::str(array.dtype()).cast<std::string>() + ".");
+    }
+  }
+
+  bool sameShape = inputArray.ndim() == outputArray.ndim();
+  for (py::ssize_t i = 0; sameShape && i < inputArray.ndim(); i++) {
+    sameShape = inputArray.shape(i) == outputArray.shape(i);
+  }
+  if (!sameShape) {
+    throw std::domain_error(
+        "The output array must have the same shape as the input (" +
+        py::str(inputArray.attr("shape")).cast<std::string>() +
+        "), but has shape " +
+        py::str(outputArray.attr("shape")).cast<std::string>() + ".");
+  }
+
+  if (inputArray.ndim() == 3) {
+    throw std::domain_error(
+        "Batched (3-dimensional) audio can't be processed into an output "
+        "array; pass each item in the batch separately instead.");
+  }
+
+  py::buffer_info inputInfo = inputArray.request();
+  py::buffer_info outputInfo = outputArray.request(/* writable= */ true);
+
+  long long samplesWritten;
+  {
+    py::gil_scoped_release release;
+    if (inputArray.dtype().char_() == 'd') {
+      StridedAudio<double> input(inputInfo), output(outputInfo);
+      samplesWritten = processInto(input, output, sampleRate, plugins,
+                                   bufferSize, reset);
+    } else {
+      StridedAudio<float> input(inputInfo), output(outputInfo);
+      samplesWritten = processInto(input, output, sampleRate, plugins,
+                                   bufferSize, reset);
+    }
+  }
+
+  if (samplesWritten == getNumSamples(outputArray)) {
+    return outputArray;
+  }
+  return sliceSamplesTo(outputArray, samplesWritten);
+}
+
+/**
+ * Process a NumPy array or DLPack-compatible tensor (see asArray) through a
+ * list of plugins, either in-place, into a provided output array (see
+ * processInto), or into a new array, returning the output as the same kind
+ * of object as was passed in (or as `out`, if provided; see wrapArrayLike).
+ */
+inline py::object
+processArrayOrTensor(py::object input, double sampleRate,
+                     const std::vector<std::shared_ptr<Plugin>> plugins,
+                     unsigned int bufferSize, bool reset, bool inplace,
+                     py::object out = py::none()) {
+  py::array inputArray = asArray(input);
+  if (!out.is_none()) {
+    if (inplace) {
+      throw std::domain_error(
+          "inplace=True and out can't be used together; to process audio "
+          "in-place in windows, pass the same array as both the input and "
+          "out.");
+    }
+    py::array outputArray = asArray(out, /* allowConversion= */ false);
+    return wrapArrayLike(processInto(inputArray, outputArray, sampleRate,
+                                     plugins, bufferSize, reset),
+                         out);
+  }
+  if (inplace) {
+    if (!inputArray.writeable() && isDLPackTensor(input)) {
+      // Older versions of NumPy import DLPack tensors as read-only, even if
+      // the tensor itself can be written to:
+      inputArray = py::module_::import("numpy")
+                       .attr("asarray")(input)
+                       .cast<py::array>();
+    }
+    return wrapArrayLike(
+        processInPlace(inputArray, sampleRate, plugins, bufferSize, reset),
+        input);
+  }
+  return wrapArrayLike(
+      process(inputArray, sampleRate, plugins, bufferSize, reset), input);
+}
+
+/**
+ * Process many independent audio buffers through the same list of plugins,
+ * spreading the work across a pool of native threads. Each worker thread
+ * other than the first runs on its own clone of the provided plugins, so
+ * no plugin instance is ever used by more than one thread at a time.
+ *
+ * If any of the provided plugins cannot be cloned, all buffers will be
+ * processed on a single worker thread instead.
+ *
+ * Each buffer is processed from a clean state, as if process() were called
+ * once per buffer with reset=True.
+ */
+inline std::vector<py::array>
+processBatch(const std::vector<py::array> inputArrays, double sampleRate,
+             const std::vector<std::shared_ptr<Plugin>> plugins,
+             unsigned int bufferSize, std::optional<unsigned int> numWorkers) {
+  if (numWorkers && *numWorkers == 0) {
+    throw std::domain_error("num_workers must be at least 1.");
+  }
+
+  std::vector<ChannelLayout> channelLayouts;
+  std::vector<int> numDimensions;
+  std::vector<std::variant<juce::AudioBuffer<float>, juce::AudioBuffer<double>>>
+      ioBuffers;
+  for (const py::array &inputArray : inputArrays) {
+    throwIfUnsupportedSampleType(inputArray);
+    if (inputArray.dtype().char_() == 'd') {
+      auto float64InputArray =
+          py::array_t<double, py::array::c_style>::ensure(inputArray);
+      channelLayouts.push_back(detectChannelLayout(float64InputArray));
+      numDimensions.push_back(float64InputArray.request().ndim);
+      ioBuffers.push_back(
+          copyPyArrayIntoJuceBuffer(float64InputArray, channelLayouts.back()));
+    } else {
+      auto float32InputArray =
+          py::array_t<float, py::array::c_style>::ensure(inputArray);
+      channelLayouts.push_back(detectChannelLayout(float32InputArray));
+      numDimensions.push_back(float32InputArray.request().ndim);
+      ioBuffers.push_back(
+          copyPyArrayIntoJuceBuffer(float32InputArray, channelLayouts.back()));
+    }
+  }
+
+  std::vector<int> outputLatencySamples(ioBuffers.size());
+
+  {
+    py::gil_scoped_release release;
+    auto pluginLocks = lockAllPlugins(plugins);
+    auto pluginsPerWorker =
+        clonePluginsForWorkers(plugins, ioBuffers.size(), numWorkers);
+
+    runOnWorkers(ioBuffers.size(), pluginsPerWorker.size(),
+                 [&](size_t bufferIndex, size_t workerIndex) {
+                   outputLatencySamples[bufferIndex] = std::visit(
+                       [&](auto &ioBuffer) {
+                         return processBuffer(ioBuffer, sampleRate,
+                                              pluginsPerWorker[workerIndex],
+                                              bufferSize, true);
+                       },
+                       ioBuffers[bufferIndex]);
+                 });
+  }
+
+  std::vector<py::array> outputArrays;
+  for (size_t i = 0; i < ioBuffers.size(); i++) {
+    outputArrays.push_back(std::visit(
+        [&](const auto &ioBuffer) -> py::array {
+          return copyJuceBufferIntoPyArray(ioBuffer, channelLayouts[i],
+                                           outputLatencySamples[i],
+                                           numDimensions[i]);
+        },
+        ioBuffers[i]));
+  }
+  return outputArrays;
+}
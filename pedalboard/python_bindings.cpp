@@ -27,15 +27,22 @@
 
 namespace py = pybind11;
 
+#include "CpuFeatures.h"
 #include "ExternalPlugin.h"
 #include "JucePlugin.h"
 #include "Plugin.h"
 #include "PluginContainer.h"
+#include "Profiling.h"
+#include "RealtimeAudit.h"
+#include "RenderFile.h"
+#include "Spectrogram.h"
+#include "StreamingProcessor.h"
 #include "TimeStretch.h"
 #include "process.h"
 
 #include "plugin_templates/FixedBlockSize.h"
 #include "plugin_templates/ForceMono.h"
+#include "plugin_templates/Oversampled.h"
 #include "plugin_templates/PrimeWithSilence.h"
 #include "plugin_templates/Resample.h"
 
@@ -48,13 +55,18 @@ namespace py = pybind11;
 #include "plugins/Convolution.h"
 #include "plugins/Delay.h"
 #include "plugins/Distortion.h"
+#include "plugins/EQ.h"
+#include "plugins/FrozenChain.h"
 #include "plugins/GSMFullRateCompressor.h"
 #include "plugins/Gain.h"
 #include "plugins/HighpassFilter.h"
 #include "plugins/IIRFilters.h"
 #include "plugins/Invert.h"
+#include "plugins/JuceDynamics.h"
+#include "plugins/JuceModulation.h"
 #include "plugins/LadderFilter.h"
 #include "plugins/Limiter.h"
+#include "plugins/LoudnessMeter.h"
 #include "plugins/LowpassFilter.h"
 #include "plugins/MP3Compressor.h"
 #include "plugins/Mix.h"
@@ -65,6 +77,9 @@ namespace py = pybind11;
 
 #include "io/AudioFileInit.h"
 #include "io/AudioStream.h"
+#include "io/DecodeCache.h"
+#include "io/IOStatistics.h"
+#include "io/ReadMany.h"
 #include "io/ReadableAudioFile.h"
 #include "io/ResampledReadableAudioFile.h"
 #include "io/StreamResampler.h"
@@ -85,17 +100,20 @@ PYBIND11_MODULE(pedalboard_native, m) {
       "A generic audio processing plugin. Base class of all Pedalboard "
       "plugins.");
 
+  init_streaming_processor(m);
+
   m.def(
       "process",
-      [](const py::array inputArray, double sampleRate,
+      [](py::object input, double sampleRate,
          const std::vector<std::shared_ptr<Plugin>> plugins,
-         unsigned int bufferSize, bool reset) {
-        return process(inputArray, sampleRate, plugins, bufferSize, reset);
+         unsigned int bufferSize, bool reset, bool inplace, py::object out) {
+        return processArrayOrTensor(input, sampleRate, plugins, bufferSize,
+                                    reset, inplace, out);
       },
       R"(
 Run a 32-bit or 64-bit floating point audio buffer through a
 list of Pedalboard plugins. If the provided buffer uses a 64-bit datatype,
-it will be converted to 32-bit for processing.
+it will be processed and returned as 64-bit audio.
 
 The provided ``buffer_size`` argument will be used to control the size of
 each chunk of audio provided into the plugins. Higher buffer sizes may speed up
@@ -106,10 +124,17 @@ processing begins, clearing any state from previous calls to ``process``.
 If calling ``process`` multiple times while processing the same audio file
 or buffer, set ``reset`` to ``False``.
 
+If ``inplace`` is ``True``, the provided buffer will be overwritten with the
+processed audio and returned.
+
+If ``out`` is provided, audio will be processed in fixed-size windows and
+written into ``out`` (see :py:meth:`Plugin.process`).
+
 :meta private:
 )",
       py::arg("input_array"), py::arg("sample_rate"), py::arg("plugins"),
-      py::arg("buffer_size") = DEFAULT_BUFFER_SIZE, py::arg("reset") = true);
+      py::arg("buffer_size") = DEFAULT_BUFFER_SIZE, py::arg("reset") = true,
+      py::arg("inplace") = false, py::kw_only(), py::arg("out") = py::none());
 
   plugin
       .def(py::init([]() {
@@ -121,15 +146,235 @@ or buffer, set ``reset`` to ``False``.
         // type inference.
         return nullptr;
       }))
-      .def("reset", &Plugin::reset,
-           "Clear any internal state stored by this plugin (e.g.: reverb "
-           "tails, delay lines, LFO state, etc). The values of plugin "
-           "parameters will remain unchanged. ")
+      .def(
+          "reset",
+          [](std::shared_ptr<Plugin> self) {
+            self->reset();
+            rewindAutomation(getAllPluginsSorted({self}));
+          },
+          "Clear any internal state stored by this plugin (e.g.: reverb "
+          "tails, delay lines, LFO state, etc). The values of plugin "
+          "parameters will remain unchanged. ")
+      .def(
+          "clone",
+          [](std::shared_ptr<Plugin> self) {
+            std::shared_ptr<Plugin> clone;
+            {
+              py::gil_scoped_release release;
+              auto pluginLocks = lockAllPlugins({self});
+              clone = self->clone();
+            }
+            if (!clone) {
+              throw std::runtime_error(
+                  "This plugin (or a plugin it contains) cannot be cloned.");
+            }
+            return clone;
+          },
+          R"(
+Return a new, independent copy of this plugin (and of any plugins it
+contains) with the same parameters, but without any of its internal state
+(i.e.: reverb tails). Copies can be used on other threads at the same time as
+the original, making it easy to process audio in parallel with one copy per
+thread.
+
+Cloning is much cheaper than constructing a new plugin: the impulse responses
+of :class:`Convolution` plugins are shared between copies rather than being
+loaded again, and external plugins (i.e.: :class:`VST3Plugin`) have their
+state copied with ``getStateInformation`` rather than being reconfigured from
+Python.
+
+Automated parameters (see :py:meth:`automate`) are not copied. Raises a
+``RuntimeError`` if the plugin can't be cloned (for example, external
+plugins that must be reloaded after being reset, or clones requested from a
+thread other than the main thread).
+
+*Introduced in v0.9.0.*
+)")
+      .def(
+          "automate",
+          [](std::shared_ptr<Plugin> self, std::string parameterName,
+             py::object values) {
+            auto &automatableParameters = getAutomatableParameters();
+            auto parameter = automatableParameters.find(
+                {std::type_index(typeid(*self)), parameterName});
+            if (parameter == automatableParameters.end()) {
+              std::string validNames;
+              for (const auto &name : getAutomatableParameterNames(*self)) {
+                validNames += (validNames.empty() ? "" : ", ") + name;
+              }
+              throw std::invalid_argument(
+                  "Parameter \"" + parameterName +
+                  "\" cannot be automated on this plugin." +
+                  (validNames.empty()
+                       ? std::string(" This plugin has no automatable "
+                                     "parameters.")
+                       : " Valid options: " + validNames));
+            }
+
+            std::optional<AutomationCurve> curve;
+            if (!values.is_none()) {
+              curve = parseAutomationCurve(values);
+
+              // Let the parameter's setter validate the extremes of the
+              // curve now, rather than raising an exception mid-render:
+              auto getValue = parameter->second.getValue;
+              auto setValue = parameter->second.setValue;
+              float originalValue = getValue(*self);
+              try {
+                setValue(*self, curve->getMinimumValue());
+                setValue(*self, curve->getMaximumValue());
+              } catch (...) {
+                setValue(*self, originalValue);
+                throw;
+              }
+              setValue(*self, originalValue);
+            }
+
+            auto setValue = parameter->second.setValue;
+            Plugin *plugin = self.get();
+            setParameterAutomation(
+                *self, parameterName, curve,
+                [setValue, plugin](float value) { setValue(*plugin, value); });
+          },
+          R"(
+Change the value of one of this plugin's parameters over time while audio is
+processed, rather than keeping it fixed for the duration of each call to
+:py:meth:`process`.
+
+``values`` may be either a one-dimensional NumPy array containing one value
+per sample, or a list of ``(time_in_seconds, value)`` pairs (sorted by time)
+between which the value is linearly interpolated. Before the first (or after
+the last) value, the first (or last) value is held. Pass ``None`` to stop
+automating the parameter, leaving it at its most recent value.
+
+Curves start from the beginning each time this plugin is reset, and continue
+across calls to :py:meth:`process` with ``reset=False``. Automated
+parameters are updated every :py:attr:`automation_interval` samples inside
+the processing loop, so the same audio is produced regardless of the
+``buffer_size`` used::
+
+   from pedalboard import LowpassFilter
+   import numpy as np
+
+   lowpass = LowpassFilter()
+   # Sweep the cutoff from 200Hz to 8kHz over two seconds:
+   lowpass.automate("cutoff_frequency_hz", [(0, 200), (2, 8000)])
+   output = lowpass(audio, sample_rate)
+
+   # Or provide one value per sample:
+   lowpass.automate("cutoff_frequency_hz", np.geomspace(200, 8000, len(audio)))
+
+Built-in plugins support automating most of their numeric parameters. For
+:class:`pedalboard.VST3Plugin` and :class:`pedalboard.AudioUnitPlugin`,
+any parameter in :py:attr:`parameters` can be automated.
+
+*Introduced in v0.9.0.*
+)",
+          py::arg("parameter_name"), py::arg("values"))
+      .def(
+          "clear_automation",
+          [](std::shared_ptr<Plugin> self) {
+            py::gil_scoped_release release;
+            std::lock_guard<std::mutex> lock(self->mutex);
+            if (self->automation)
+              self->automation->parameters.clear();
+          },
+          "Stop automating all of this plugin's parameters, leaving each at "
+          "its most recent value.\n\n*Introduced in v0.9.0.*")
+      .def_property_readonly(
+          "automated_parameters",
+          [](std::shared_ptr<Plugin> self) {
+            std::vector<std::string> names;
+            py::gil_scoped_release release;
+            std::lock_guard<std::mutex> lock(self->mutex);
+            if (self->automation) {
+              for (const auto &[name, parameter] : self->automation->parameters)
+                names.push_back(name);
+            }
+            return names;
+          },
+          "The names of this plugin's parameters that are currently "
+          "automated (see :py:meth:`automate`), in alphabetical order.\n\n"
+          "*Introduced in v0.9.0.*")
+      .def_property(
+          "automation_interval",
+          [](std::shared_ptr<Plugin> self) {
+            return self->automation ? self->automation->interval
+                                    : DEFAULT_AUTOMATION_INTERVAL;
+          },
+          [](std::shared_ptr<Plugin> self, int interval) {
+            if (interval < 1) {
+              throw std::domain_error(
+                  "automation_interval must be at least 1 sample, but was " +
+                  std::to_string(interval) + ".");
+            }
+            py::gil_scoped_release release;
+            std::lock_guard<std::mutex> lock(self->mutex);
+            if (!self->automation)
+              self->automation = std::make_shared<PluginAutomation>();
+            self->automation->interval = interval;
+          },
+          "The number of samples between updates of this plugin's automated "
+          "parameters (see :py:meth:`automate`). Set this to 1 to update "
+          "parameters on every sample, at the cost of calling the plugin "
+          "once per sample. Defaults to 32.\n\n*Introduced in v0.9.0.*")
+      .def_property(
+          "skip_silence",
+          [](std::shared_ptr<Plugin> self) { return self->skipSilence; },
+          [](std::shared_ptr<Plugin> self, bool skipSilence) {
+            py::gil_scoped_release release;
+            std::lock_guard<std::mutex> lock(self->mutex);
+            self->skipSilence = skipSilence;
+            self->silentInputSamples = 0;
+            self->skippingSilence = false;
+          },
+          R"(
+If ``True``, this plugin stops processing audio while its input is silent,
+once any sound it was already producing (i.e.: a reverb tail) has decayed
+below -120dB. The plugin is reset when it stops processing, and starts again
+as soon as its input is no longer silent. This can save a lot of time when
+processing audio with long silent regions, and changes the output by an
+inaudible amount (if at all).
+
+Only plugins with a known tail length are skipped: :class:`Gain`,
+:class:`Invert`, :class:`Clipping`, :class:`Bitcrush`, :class:`Compressor`,
+:class:`Limiter`, :class:`Reverb` (unless ``freeze_mode`` is enabled),
+:class:`Convolution`, and IIR filters like :class:`LowpassFilter`, as well
+as :class:`Chain`, :class:`Mix`, and :class:`Pedalboard` objects that only
+contain those plugins. Plugins with latency or with automated parameters
+(see :py:meth:`automate`) are never skipped. Defaults to ``False``.
+
+*Introduced in v0.9.0.*
+)")
+      .def("profile", &getProfile, py::arg("reset") = false, R"(
+Return the profiling statistics collected for this plugin and every plugin
+nested within it while profiling was enabled (see
+:py:func:`pedalboard.set_profiling_enabled`), as a dictionary mapping each
+plugin to a dictionary of:
+
+ - ``calls``: the number of times the plugin processed a block of audio.
+ - ``samples_processed``: the total number of samples in those blocks.
+ - ``seconds``: the total wall-clock time spent processing those blocks.
+   For plugins that contain other plugins (like :class:`Chain` or
+   :class:`Mix`), this includes the time spent in those plugins.
+ - ``reallocations``: the number of times the output buffer of
+   :py:meth:`process` had to be grown to make room for the latency of
+   this plugin.
+ - ``latency_samples``: the latency currently reported by the plugin, in
+   samples.
+
+If ``reset`` is ``True``, each plugin's statistics are set back to zero (other
+than ``latency_samples``, which is not cumulative).
+
+*Introduced in v0.9.0.*
+)")
       .def(
           "process",
-          [](std::shared_ptr<Plugin> self, const py::array inputArray,
-             double sampleRate, unsigned int bufferSize, bool reset) {
-            return process(inputArray, sampleRate, {self}, bufferSize, reset);
+          [](std::shared_ptr<Plugin> self, py::object input,
+             double sampleRate, unsigned int bufferSize, bool reset,
+             bool inplace, py::object out) {
+            return processArrayOrTensor(input, sampleRate, {self}, bufferSize,
+                                        reset, inplace, out);
           },
           R"(
 Run a 32-bit or 64-bit floating point audio buffer through this plugin.
@@ -142,8 +387,21 @@ plugin has likely buffered audio inside itself. To receive the remaining
 audio, pass another audio buffer into ``process`` with ``reset`` set to
 ``True``.
 
-If the provided buffer uses a 64-bit datatype, it will be converted to 32-bit
-for processing.
+If the provided buffer uses a 64-bit datatype, it will be processed and
+returned as 64-bit audio. (Plugins that don't support 64-bit processing
+natively will still process audio with 32-bit precision internally.)
+
+A batch of independent audio clips can be processed in one call by passing a
+3-dimensional array of shape ``(batch_size, num_channels, num_samples)``. Each
+clip is processed from a clean state (as if :py:meth:`process` were called
+once per clip with ``reset=True``), in parallel across native threads, and
+the results are returned in a single array of the same shape. ``reset`` must
+be ``True`` when passing a batch.
+
+A PyTorch (or other DLPack-compatible) tensor in CPU memory may be passed
+instead of a NumPy array. Its memory will be read directly, without first
+being copied into a NumPy array, and the output will be returned as a tensor
+of the same type.
 
 The provided ``buffer_size`` argument will be used to control the size of
 each chunk of audio provided to the plugin. Higher buffer sizes may speed up
@@ -154,6 +412,26 @@ processing begins, clearing any state from previous calls to ``process``.
 If calling ``process`` multiple times while processing the same audio file
 or buffer, set ``reset`` to ``False``.
 
+If ``inplace`` is ``True``, the provided buffer will be overwritten with the
+processed audio and returned, rather than allocating a new buffer. If the
+buffer is a writeable, contiguous, floating point array with shape
+``(num_channels, num_samples)`` (or ``(num_samples,)``) and this plugin adds
+no latency, audio will be processed directly in the buffer's memory without
+making any copies. If fewer samples are returned than were provided, the
+returned array will be a view onto the end of the provided buffer.
+
+If an ``out`` array (i.e.: a ``numpy.memmap``) with the same shape and
+datatype as the input is provided, the input will be read (and the output
+written) in windows of a fixed size, rather than copying the entire input
+into memory and allocating a new output array. This keeps memory usage
+constant regardless of the length of the audio, allowing arrays larger than
+memory to be processed. The output is identical to that returned without
+``out``, and ``out`` itself is returned. (If ``reset`` is ``False`` and fewer
+samples are returned than were provided, the returned array will be a view
+onto the start of ``out``, and the rest of ``out`` will be left untouched.)
+The input array may also be passed as ``out`` to process it in-place.
+``out`` can't be combined with ``inplace`` or with batched input.
+
 .. note::
     The :py:meth:`process` method can also be used via :py:meth:`__call__`;
     i.e.: just calling this object like a function (``my_plugin(...)``) will
@@ -161,16 +439,72 @@ or buffer, set ``reset`` to ``False``.
 
           )",
           py::arg("input_array"), py::arg("sample_rate"),
-          py::arg("buffer_size") = DEFAULT_BUFFER_SIZE, py::arg("reset") = true)
+          py::arg("buffer_size") = DEFAULT_BUFFER_SIZE, py::arg("reset") = true,
+          py::arg("inplace") = false, py::kw_only(),
+          py::arg("out") = py::none())
       .def(
           "__call__",
-          [](std::shared_ptr<Plugin> self, const py::array inputArray,
-             double sampleRate, unsigned int bufferSize, bool reset) {
-            return process(inputArray, sampleRate, {self}, bufferSize, reset);
+          [](std::shared_ptr<Plugin> self, py::object input,
+             double sampleRate, unsigned int bufferSize, bool reset,
+             bool inplace, py::object out) {
+            return processArrayOrTensor(input, sampleRate, {self}, bufferSize,
+                                        reset, inplace, out);
           },
           "Run an audio buffer through this plugin. Alias for "
           ":py:meth:`process`.",
           py::arg("input_array"), py::arg("sample_rate"),
+          py::arg("buffer_size") = DEFAULT_BUFFER_SIZE, py::arg("reset") = true,
+          py::arg("inplace") = false, py::kw_only(),
+          py::arg("out") = py::none())
+      .def(
+          "process_batch",
+          [](std::shared_ptr<Plugin> self,
+             const std::vector<py::array> inputArrays, double sampleRate,
+             std::optional<unsigned int> numWorkers, unsigned int bufferSize) {
+            return processBatch(inputArrays, sampleRate, {self}, bufferSize,
+                                numWorkers);
+          },
+          R"(
+Run many independent 32-bit or 64-bit floating point audio buffers through
+this plugin, returning a list of processed buffers in the same order.
+
+Each buffer is processed from a clean state, exactly as if :py:meth:`process`
+had been called once per buffer with ``reset=True``. Buffers may have
+different lengths and channel counts.
+
+Processing is spread across ``num_workers`` native threads (by default, one
+per CPU core) without holding Python's Global Interpreter Lock. Each thread
+processes buffers with its own independent copy of this plugin (and of any
+plugins it contains), so the results are identical regardless of the number
+of workers used.
+
+.. note::
+    If this plugin (or any plugin it contains) cannot be copied - for example,
+    a :class:`VST3Plugin` or :class:`AudioUnitPlugin` - all buffers will be
+    processed one at a time on the calling thread instead.
+
+*Introduced in v0.9.0.*
+)",
+          py::arg("input_arrays"), py::arg("sample_rate"),
+          py::arg("num_workers") = py::none(),
+          py::arg("buffer_size") = DEFAULT_BUFFER_SIZE)
+      .def(
+          "stream",
+          [](std::shared_ptr<Plugin> self, double sampleRate, int numChannels,
+             unsigned int bufferSize, bool reset) {
+            return std::make_shared<StreamingProcessor>(
+                std::vector<std::shared_ptr<Plugin>>{self}, sampleRate,
+                numChannels, bufferSize, reset);
+          },
+          R"(
+Create a :class:`StreamingProcessor` that runs a stream of audio through this
+plugin one chunk at a time, preparing this plugin only once and reusing its
+buffers between chunks. Prefer this over calling :py:meth:`process`
+repeatedly with ``reset=False`` when processing long recordings in chunks.
+
+*Introduced in v0.9.0.*
+)",
+          py::arg("sample_rate"), py::arg("num_channels"),
           py::arg("buffer_size") = DEFAULT_BUFFER_SIZE, py::arg("reset") = true)
       .def_property_readonly(
           "is_effect",
@@ -197,6 +531,7 @@ or buffer, set ``reset`` to ``False``.
   init_convolution(m);
   init_delay(m);
   init_distortion(m);
+  init_eq(m);
   init_gain(m);
 
   // Init Resample before GSMFullRateCompressor, which uses Resample::Quality:
@@ -208,6 +543,7 @@ or buffer, set ``reset`` to ``False``.
   init_invert(m);
   init_ladderfilter(m);
   init_limiter(m);
+  init_loudness_meter(m);
   init_lowpass(m);
   init_mp3_compressor(m);
   init_noisegate(m);
@@ -220,8 +556,11 @@ or buffer, set ``reset`` to ``False``.
   // Classes that don't perform any audio effects, but that add other utilities:
   py::module utils = m.def_submodule("utils");
   init_mix(utils);
+  // Init FrozenChain before Chain, as Chain.freeze() returns a FrozenChain:
+  init_frozen_chain(utils);
   init_chain(utils);
   init_time_stretch(utils);
+  init_spectrogram(utils);
 
   // Internal plugins for testing, debugging, etc:
   py::module internal = m.def_submodule("_internal");
@@ -230,6 +569,9 @@ or buffer, set ``reset`` to ``False``.
   init_resample_with_latency(internal);
   init_fixed_size_block_test_plugin(internal);
   init_force_mono_test_plugin(internal);
+  init_oversampled_test_plugin(internal);
+  init_juce_dynamics_test_plugins(internal);
+  init_juce_modulation_test_plugins(internal);
 
   // I/O helpers and utilities:
   py::module io = m.def_submodule("io");
@@ -248,4 +590,18 @@ or buffer, set ``reset`` to ``False``.
 
   init_stream_resampler(io);
   init_audio_stream(io);
+  init_read_many(io);
+  init_decode_cache(io);
+  init_io_statistics(io);
+
+  // Helpers that combine I/O and processing, which must be initialized after
+  // the I/O classes they use:
+  init_render_file(m);
+
+  // Debugging helpers for finding slow or real-time-unsafe plugins:
+  init_profiling(m);
+  init_realtime_audit(m);
+
+  // Report (and choose) the SIMD kernels used by this process:
+  init_cpu_features(m);
 };
@@ -0,0 +1,159 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "Kernels.h"
+
+#if PEDALBOARD_SIMD_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace Pedalboard {
+namespace simd {
+
+/**
+ * The instruction set extensions that both the CPU and the operating system
+ * (which must save the wider registers on context switches) support.
+ */
+struct CpuFeatures {
+  bool sse2 = false;
+  bool sse41 = false;
+  bool avx = false;
+  bool avx2 = false;
+  bool fma = false;
+  bool avx512f = false;
+  bool neon = false;
+};
+
+#if PEDALBOARD_SIMD_X86
+inline void cpuid(unsigned int leaf, unsigned int subleaf,
+                  unsigned int registers[4]) {
+#if defined(_MSC_VER)
+  int values[4];
+  __cpuidex(values, (int)leaf, (int)subleaf);
+  for (int i = 0; i < 4; i++)
+    registers[i] = (unsigned int)values[i];
+#else
+  __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2],
+                registers[3]);
+#endif
+}
+
+// Read the extended control register that says which register states the OS
+// saves. Only valid if CPUID reports OSXSAVE:
+inline unsigned long long xgetbv() {
+#if defined(_MSC_VER)
+  return _xgetbv(0);
+#else
+  unsigned int eax, edx;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return ((unsigned long long)edx << 32) | eax;
+#endif
+}
+#endif
+
+inline CpuFeatures detectCpuFeatures() {
+  CpuFeatures features;
+#if PEDALBOARD_SIMD_X86
+  unsigned int leaf0[4] = {0}, leaf1[4] = {0}, leaf7[4] = {0};
+  cpuid(0, 0, leaf0);
+  if (leaf0[0] >= 1)
+    cpuid(1, 0, leaf1);
+  if (leaf0[0] >= 7)
+    cpuid(7, 0, leaf7);
+
+  // Registers are in the order EAX, EBX, ECX, EDX:
+  const bool osxsave = leaf1[2] & (1u << 27);
+  const unsigned long long xcr0 = osxsave ? xgetbv() : 0;
+  // XMM and YMM state, plus the opmask and both halves of the ZMM state:
+  const bool osSavesYmm = (xcr0 & 0x6) == 0x6;
+  const bool osSavesZmm = (xcr0 & 0xe6) == 0xe6;
+
+  features.sse2 = leaf1[3] & (1u << 26);
+  features.sse41 = leaf1[2] & (1u << 19);
+  features.avx = (leaf1[2] & (1u << 28)) && osSavesYmm;
+  features.fma = (leaf1[2] & (1u << 12)) && osSavesYmm;
+  features.avx2 = (leaf7[1] & (1u << 5)) && osSavesYmm;
+  features.avx512f = (leaf7[1] & (1u << 16)) && osSavesZmm;
+#elif defined(__aarch64__) || defined(_M_ARM64)
+  // NEON is part of the baseline of every 64-bit ARM CPU:
+  features.neon = true;
+#endif
+  return features;
+}
+
+inline const CpuFeatures &getCpuFeatures() {
+  static const CpuFeatures features = detectCpuFeatures();
+  return features;
+}
+
+/**
+ * Return every set of kernels compiled into this build that the given CPU
+ * supports, from least to most capable.
+ */
+inline std::vector<const Kernels *>
+getSupportedKernels(const CpuFeatures &features) {
+  std::vector<const Kernels *> supported = {&baselineKernels};
+#if PEDALBOARD_SIMD_X86
+  if (features.avx2 && features.fma) {
+    supported.push_back(&avx2Kernels);
+    if (features.avx512f)
+      supported.push_back(&avx512Kernels);
+  }
+#endif
+  return supported;
+}
+
+/**
+ * Choose the most capable kernels this CPU supports, unless the
+ * PEDALBOARD_SIMD environment variable names another supported set of
+ * kernels (i.e.: to compare the output or speed of different kernels).
+ */
+inline const Kernels &chooseKernels() {
+  std::vector<const Kernels *> supported =
+      getSupportedKernels(getCpuFeatures());
+  const Kernels *chosen = supported.back();
+
+  if (const char *requested = std::getenv("PEDALBOARD_SIMD")) {
+    for (const Kernels *kernels : supported) {
+      if (std::strcmp(kernels->name, requested) == 0)
+        chosen = kernels;
+    }
+  }
+  return *chosen;
+}
+
+/**
+ * Return the kernels used by this process, which are chosen once (when
+ * Pedalboard is imported) and never change.
+ */
+inline const Kernels &getKernels() {
+  static const Kernels &kernels = chooseKernels();
+  return kernels;
+}
+
+} // namespace simd
+} // namespace Pedalboard
@@ -0,0 +1,736 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * The implementations of every kernel in Kernels.h. This file is included
+ * once by each of KernelsBaseline.cpp, KernelsAVX2.cpp and KernelsAVX512.cpp,
+ * which set PEDALBOARD_KERNELS_AVX2 or PEDALBOARD_KERNELS_AVX512 (or neither,
+ * to use whatever the compiler targets by default) and
+ * PEDALBOARD_KERNELS_TABLE to the name of the table to define.
+ *
+ * Rather than relying on per-file compiler flags (which can't be used when
+ * building universal binaries for macOS, or with MSVC), the AVX2 and AVX-512
+ * kernels ask the compiler to target those instruction sets with pragmas, so
+ * nothing else should be included after the pragmas below. Everything here is
+ * in an anonymous namespace, so that no code compiled for one instruction set
+ * can be shared with (and run by) a CPU that only supports another.
+ */
+
+#pragma once
+
+#include "Kernels.h"
+
+#if PEDALBOARD_KERNELS_AVX512
+#define PEDALBOARD_KERNELS_AVX2 1
+#endif
+
+#if PEDALBOARD_KERNELS_AVX2
+#define PEDALBOARD_KERNELS_SSE2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) ||                                 \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PEDALBOARD_KERNELS_SSE2 1
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define PEDALBOARD_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if PEDALBOARD_KERNELS_AVX512
+#define PEDALBOARD_KERNELS_NAME "avx512"
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f,avx2,fma"))),   \
+                             apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx2,fma")
+// GCC 12 warns about the deliberately-undefined values in its own intrinsics
+// when they're used through a target pragma:
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#elif PEDALBOARD_KERNELS_AVX2
+#define PEDALBOARD_KERNELS_NAME "avx2"
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,fma"))),           \
+                             apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+// GCC 12 warns about the deliberately-undefined values in its own intrinsics
+// when they're used through a target pragma:
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#elif PEDALBOARD_KERNELS_SSE2
+#define PEDALBOARD_KERNELS_NAME "sse2"
+#elif PEDALBOARD_KERNELS_NEON
+#define PEDALBOARD_KERNELS_NAME "neon"
+#else
+#define PEDALBOARD_KERNELS_NAME "scalar"
+#endif
+
+namespace Pedalboard {
+namespace simd {
+namespace {
+
+// AVX-512 shuffles are no faster than AVX2's for (de-)interleaving, as moving
+// 64 bytes at a time from unaligned buffers splits almost every access across
+// two cache lines, so both of these kernels stop at AVX2:
+unsigned int deinterleaveStereo(const float *interleaved, float *left,
+                                float *right, unsigned int numFrames) {
+  unsigned int i = 0;
+#if PEDALBOARD_KERNELS_AVX2
+  for (; i + 8 <= numFrames; i += 8) {
+    // a = [L0 R0 L1 R1 | L2 R2 L3 R3], b = [L4 R4 L5 R5 | L6 R6 L7 R7]
+    __m256 a = _mm256_loadu_ps(interleaved + i * 2);
+    __m256 b = _mm256_loadu_ps(interleaved + i * 2 + 8);
+    // Shuffling within each 128-bit lane gives [L0 L1 L4 L5 | L2 L3 L6 L7],
+    // so swap the middle two 64-bit pairs back into order:
+    __m256 l = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+    __m256 r = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    _mm256_storeu_ps(left + i,
+                     _mm256_castpd_ps(_mm256_permute4x64_pd(
+                         _mm256_castps_pd(l), _MM_SHUFFLE(3, 1, 2, 0))));
+    _mm256_storeu_ps(right + i,
+                     _mm256_castpd_ps(_mm256_permute4x64_pd(
+                         _mm256_castps_pd(r), _MM_SHUFFLE(3, 1, 2, 0))));
+  }
+#endif
+#if PEDALBOARD_KERNELS_SSE2
+  for (; i + 4 <= numFrames; i += 4) {
+    __m128 a = _mm_loadu_ps(interleaved + i * 2);
+    __m128 b = _mm_loadu_ps(interleaved + i * 2 + 4);
+    _mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+  }
+#elif PEDALBOARD_KERNELS_NEON
+  for (; i + 4 <= numFrames; i += 4) {
+    float32x4x2_t frames = vld2q_f32(interleaved + i * 2);
+    vst1q_f32(left + i, frames.val[0]);
+    vst1q_f32(right + i, frames.val[1]);
+  }
+#endif
+  return i;
+}
+
+unsigned int interleaveStereo(const float *left, const float *right,
+                              float *interleaved, unsigned int numFrames) {
+  unsigned int i = 0;
+#if PEDALBOARD_KERNELS_AVX2
+  for (; i + 8 <= numFrames; i += 8) {
+    __m256 l = _mm256_loadu_ps(left + i);
+    __m256 r = _mm256_loadu_ps(right + i);
+    // lo = [L0 R0 L1 R1 | L4 R4 L5 R5], hi = [L2 R2 L3 R3 | L6 R6 L7 R7]
+    __m256 lo = _mm256_unpacklo_ps(l, r);
+    __m256 hi = _mm256_unpackhi_ps(l, r);
+    _mm256_storeu_ps(interleaved + i * 2, _mm256_permute2f128_ps(lo, hi, 0x20));
+    _mm256_storeu_ps(interleaved + i * 2 + 8,
+                     _mm256_permute2f128_ps(lo, hi, 0x31));
+  }
+#endif
+#if PEDALBOARD_KERNELS_SSE2
+  for (; i + 4 <= numFrames; i += 4) {
+    __m128 l = _mm_loadu_ps(left + i);
+    __m128 r = _mm_loadu_ps(right + i);
+    _mm_storeu_ps(interleaved + i * 2, _mm_unpacklo_ps(l, r));
+    _mm_storeu_ps(interleaved + i * 2 + 4, _mm_unpackhi_ps(l, r));
+  }
+#elif PEDALBOARD_KERNELS_NEON
+  for (; i + 4 <= numFrames; i += 4) {
+    float32x4x2_t frames;
+    frames.val[0] = vld1q_f32(left + i);
+    frames.val[1] = vld1q_f32(right + i);
+    vst2q_f32(interleaved + i * 2, frames);
+  }
+#endif
+  return i;
+}
+
+#if PEDALBOARD_KERNELS_AVX2
+inline __m128 roundToNearest(__m128 x) {
+  return _mm_round_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+}
+
+inline __m128d roundToNearest(__m128d x) {
+  return _mm_round_pd(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+}
+#elif PEDALBOARD_KERNELS_SSE2
+// Without SSE4.1's round instructions, adding and subtracting 2^23 (or 2^52)
+// rounds to the nearest integer. Larger values (and NaNs and infinities) are
+// already integral, and the sign is restored so that -0.4 rounds to -0.0:
+inline __m128 roundToNearest(__m128 x) {
+  const __m128 signMask = _mm_set1_ps(-0.0f);
+  const __m128 magic = _mm_set1_ps(8388608.0f);
+  __m128 magnitude = _mm_andnot_ps(signMask, x);
+  __m128 rounded = _mm_sub_ps(_mm_add_ps(magnitude, magic), magic);
+  rounded = _mm_or_ps(rounded, _mm_and_ps(x, signMask));
+  __m128 isSmall = _mm_cmplt_ps(magnitude, magic);
+  return _mm_or_ps(_mm_and_ps(isSmall, rounded), _mm_andnot_ps(isSmall, x));
+}
+
+inline __m128d roundToNearest(__m128d x) {
+  const __m128d signMask = _mm_set1_pd(-0.0);
+  const __m128d magic = _mm_set1_pd(4503599627370496.0);
+  __m128d magnitude = _mm_andnot_pd(signMask, x);
+  __m128d rounded = _mm_sub_pd(_mm_add_pd(magnitude, magic), magic);
+  rounded = _mm_or_pd(rounded, _mm_and_pd(x, signMask));
+  __m128d isSmall = _mm_cmplt_pd(magnitude, magic);
+  return _mm_or_pd(_mm_and_pd(isSmall, rounded), _mm_andnot_pd(isSmall, x));
+}
+#endif
+
+int bitcrushFloat(float *samples, int numSamples, float scale,
+                  float inverseScale) {
+  int i = 0;
+#if PEDALBOARD_KERNELS_AVX512
+  {
+    const __m512 scaleVector = _mm512_set1_ps(scale);
+    const __m512 inverseScaleVector = _mm512_set1_ps(inverseScale);
+    for (; i + 16 <= numSamples; i += 16) {
+      __m512 x = _mm512_mul_ps(_mm512_loadu_ps(samples + i), scaleVector);
+      x = _mm512_roundscale_ps(x,
+                               _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+      _mm512_storeu_ps(samples + i, _mm512_mul_ps(x, inverseScaleVector));
+    }
+  }
+#endif
+#if PEDALBOARD_KERNELS_AVX2
+  {
+    const __m256 scaleVector = _mm256_set1_ps(scale);
+    const __m256 inverseScaleVector = _mm256_set1_ps(inverseScale);
+    for (; i + 8 <= numSamples; i += 8) {
+      __m256 x = _mm256_mul_ps(_mm256_loadu_ps(samples + i), scaleVector);
+      x = _mm256_round_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+      _mm256_storeu_ps(samples + i, _mm256_mul_ps(x, inverseScaleVector));
+    }
+  }
+#endif
+#if PEDALBOARD_KERNELS_SSE2
+  const __m128 scaleVector = _mm_set1_ps(scale);
+  const __m128 inverseScaleVector = _mm_set1_ps(inverseScale);
+  for (; i + 4 <= numSamples; i += 4) {
+    __m128 x = _mm_mul_ps(_mm_loadu_ps(samples + i), scaleVector);
+    _mm_storeu_ps(samples + i,
+                  _mm_mul_ps(roundToNearest(x), inverseScaleVector));
+  }
+#elif PEDALBOARD_KERNELS_NEON
+  const float32x4_t scaleVector = vdupq_n_f32(scale);
+  const float32x4_t inverseScaleVector = vdupq_n_f32(inverseScale);
+  for (; i + 4 <= numSamples; i += 4) {
+    float32x4_t x = vmulq_f32(vld1q_f32(samples + i), scaleVector);
+    vst1q_f32(samples + i, vmulq_f32(vrndnq_f32(x), inverseScaleVector));
+  }
+#endif
+  return i;
+}
+
+int bitcrushDouble(double *samples, int numSamples, double scale,
+                   double inverseScale) {
+  int i = 0;
+#if PEDALBOARD_KERNELS_AVX512
+  {
+    const __m512d scaleVector = _mm512_set1_pd(scale);
+    const __m512d inverseScaleVector = _mm512_set1_pd(inverseScale);
+    for (; i + 8 <= numSamples; i += 8) {
+      __m512d x = _mm512_mul_pd(_mm512_loadu_pd(samples + i), scaleVector);
+      x = _mm512_roundscale_pd(x,
+                               _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+      _mm512_storeu_pd(samples + i, _mm512_mul_pd(x, inverseScaleVector));
+    }
+  }
+#endif
+#if PEDALBOARD_KERNELS_AVX2
+  {
+    const __m256d scaleVector = _mm256_set1_pd(scale);
+    const __m256d inverseScaleVector = _mm256_set1_pd(inverseScale);
+    for (; i + 4 <= numSamples; i += 4) {
+      __m256d x = _mm256_mul_pd(_mm256_loadu_pd(samples + i), scaleVector);
+      x = _mm256_round_pd(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+      _mm256_storeu_pd(samples + i, _mm256_mul_pd(x, inverseScaleVector));
+    }
+  }
+#endif
+#if PEDALBOARD_KERNELS_SSE2
+  const __m128d scaleVector = _mm_set1_pd(scale);
+  const __m128d inverseScaleVector = _mm_set1_pd(inverseScale);
+  for (; i + 2 <= numSamples; i += 2) {
+    __m128d x = _mm_mul_pd(_mm_loadu_pd(samples + i), scaleVector);
+    _mm_storeu_pd(samples + i,
+                  _mm_mul_pd(roundToNearest(x), inverseScaleVector));
+  }
+#elif PEDALBOARD_KERNELS_NEON
+  const float64x2_t scaleVector = vdupq_n_f64(scale);
+  const float64x2_t inverseScaleVector = vdupq_n_f64(inverseScale);
+  for (; i + 2 <= numSamples; i += 2) {
+    float64x2_t x = vmulq_f64(vld1q_f64(samples + i), scaleVector);
+    vst1q_f64(samples + i, vmulq_f64(vrndnq_f64(x), inverseScaleVector));
+  }
+#endif
+  return i;
+}
+
+// Clipping takes the minimum with the upper bound first, and the maximum with
+// the lower bound second, with the sample as the second operand of each. On
+// x86, this passes NaNs through just like the scalar loop does:
+void clipFloat(float *samples, int numSamples, float low, float high) {
+  int i = 0;
+#if PEDALBOARD_KERNELS_AVX512
+  {
+    const __m512 lowVector = _mm512_set1_ps(low);
+    const __m512 highVector = _mm512_set1_ps(high);
+    for (; i + 16 <= numSamples; i += 16) {
+      __m512 x = _mm512_loadu_ps(samples + i);
+      _mm512_storeu_ps(samples + i,
+                       _mm512_max_ps(lowVector, _mm512_min_ps(highVector, x)));
+    }
+  }
+#endif
+#if PEDALBOARD_KERNELS_AVX2
+  {
+    const __m256 lowVector = _mm256_set1_ps(low);
+    const __m256 highVector = _mm256_set1_ps(high);
+    for (; i + 8 <= numSamples; i += 8) {
+      __m256 x = _mm256_loadu_ps(samples + i);
+      _mm256_storeu_ps(samples + i,
+                       _mm256_max_ps(lowVector, _mm256_min_ps(highVector, x)));
+    }
+  }
+#endif
+#if PEDALBOARD_KERNELS_SSE2
+  const __m128 lowVector = _mm_set1_ps(low);
+  const __m128 highVector = _mm_set1_ps(high);
+  for (; i + 4 <= numSamples; i += 4) {
+    __m128 x = _mm_loadu_ps(samples + i);
+    _mm_storeu_ps(samples + i,
+                  _mm_max_ps(lowVector, _mm_min_ps(highVector, x)));
+  }
+#elif PEDALBOARD_KERNELS_NEON
+  const float32x4_t lowVector = vdupq_n_f32(low);
+  const float32x4_t highVector = vdupq_n_f32(high);
+  for (; i + 4 <= numSamples; i += 4) {
+    float32x4_t x = vld1q_f32(samples + i);
+    vst1q_f32(samples + i, vmaxq_f32(lowVector, vminq_f32(highVector, x)));
+  }
+#endif
+  for (; i < numSamples; i++) {
+    float x = samples[i];
+    samples[i] = x < low ? low : (high < x ? high : x);
+  }
+}
+
+void clipDouble(double *samples, int numSamples, double low, double high) {
+  int i = 0;
+#if PEDALBOARD_KERNELS_AVX512
+  {
+    const __m512d lowVector = _mm512_set1_pd(low);
+    const __m512d highVector = _mm512_set1_pd(high);
+    for (; i + 8 <= numSamples; i += 8) {
+      __m512d x = _mm512_loadu_pd(samples + i);
+      _mm512_storeu_pd(samples + i,
+                       _mm512_max_pd(lowVector, _mm512_min_pd(highVector, x)));
+    }
+  }
+#endif
+#if PEDALBOARD_KERNELS_AVX2
+  {
+    const __m256d lowVector = _mm256_set1_pd(low);
+    const __m256d highVector = _mm256_set1_pd(high);
+    for (; i + 4 <= numSamples; i += 4) {
+      __m256d x = _mm256_loadu_pd(samples + i);
+      _mm256_storeu_pd(samples + i,
+                       _mm256_max_pd(lowVector, _mm256_min_pd(highVector, x)));
+    }
+  }
+#endif
+#if PEDALBOARD_KERNELS_SSE2
+  const __m128d lowVector = _mm_set1_pd(low);
+  const __m128d highVector = _mm_set1_pd(high);
+  for (; i + 2 <= numSamples; i += 2) {
+    __m128d x = _mm_loadu_pd(samples + i);
+    _mm_storeu_pd(samples + i,
+                  _mm_max_pd(lowVector, _mm_min_pd(highVector, x)));
+  }
+#elif PEDALBOARD_KERNELS_NEON
+  const float64x2_t lowVector = vdupq_n_f64(low);
+  const float64x2_t highVector = vdupq_n_f64(high);
+  for (; i + 2 <= numSamples; i += 2) {
+    float64x2_t x = vld1q_f64(samples + i);
+    vst1q_f64(samples + i, vmaxq_f64(lowVector, vminq_f64(highVector, x)));
+  }
+#endif
+  for (; i < numSamples; i++) {
+    double x = samples[i];
+    samples[i] = x < low ? low : (high < x ? high : x);
+  }
+}
+
+void multiplyFloat(float *samples, int numSamples, float gain) {
+  int i = 0;
+#if PEDALBOARD_KERNELS_AVX512
+  {
+    const __m512 gainVector = _mm512_set1_ps(gain);
+    for (; i + 16 <= numSamples; i += 16) {
+      _mm512_storeu_ps(samples + i,
+                       _mm512_mul_ps(_mm512_loadu_ps(samples + i), gainVector));
+    }
+  }
+#endif
+#if PEDALBOARD_KERNELS_AVX2
+  {
+    const __m256 gainVector = _mm256_set1_ps(gain);
+    for (; i + 8 <= numSamples; i += 8) {
+      _mm256_storeu_ps(samples + i,
+                       _mm256_mul_ps(_mm256_loadu_ps(samples + i), gainVector));
+    }
+  }
+#endif
+#if PEDALBOARD_KERNELS_SSE2
+  const __m128 gainVector = _mm_set1_ps(gain);
+  for (; i + 4 <= numSamples; i += 4) {
+    _mm_storeu_ps(samples + i,
+                  _mm_mul_ps(_mm_loadu_ps(samples + i), gainVector));
+  }
+#elif PEDALBOARD_KERNELS_NEON
+  for (; i + 4 <= numSamples; i += 4) {
+    vst1q_f32(samples + i, vmulq_n_f32(vld1q_f32(samples + i), gain));
+  }
+#endif
+  for (; i < numSamples; i++) {
+    samples[i] *= gain;
+  }
+}
+
+void multiplyDouble(double *samples, int numSamples, double gain) {
+  int i = 0;
+#if PEDALBOARD_KERNELS_AVX512
+  {
+    const __m512d gainVector = _mm512_set1_pd(gain);
+    for (; i + 8 <= numSamples; i += 8) {
+      _mm512_storeu_pd(samples + i,
+                       _mm512_mul_pd(_mm512_loadu_pd(samples + i), gainVector));
+    }
+  }
+#endif
+#if PEDALBOARD_KERNELS_AVX2
+  {
+    const __m256d gainVector = _mm256_set1_pd(gain);
+    for (; i + 4 <= numSamples; i += 4) {
+      _mm256_storeu_pd(samples + i,
+                       _mm256_mul_pd(_mm256_loadu_pd(samples + i), gainVector));
+    }
+  }
+#endif
+#if PEDALBOARD_KERNELS_SSE2
+  const __m128d gainVector = _mm_set1_pd(gain);
+  for (; i + 2 <= numSamples; i += 2) {
+    _mm_storeu_pd(samples + i,
+                  _mm_mul_pd(_mm_loadu_pd(samples + i), gainVector));
+  }
+#elif PEDALBOARD_KERNELS_NEON
+  for (; i + 2 <= numSamples; i += 2) {
+    vst1q_f64(samples + i, vmulq_n_f64(vld1q_f64(samples + i), gain));
+  }
+#endif
+  for (; i < numSamples; i++) {
+    samples[i] *= gain;
+  }
+}
+
+// The minimal set of vector operations needed to run one transposed direct
+// form II biquad per lane, using the widest vectors available:
+#if PEDALBOARD_KERNELS_AVX512
+constexpr int BIQUAD_LANES = 16;
+using BiquadVector = __m512;
+inline BiquadVector load(const float *p) { return _mm512_loadu_ps(p); }
+inline void store(float *p, BiquadVector v) { _mm512_storeu_ps(p, v); }
+inline BiquadVector add(BiquadVector a, BiquadVector b) {
+  return _mm512_add_ps(a, b);
+}
+inline BiquadVector sub(BiquadVector a, BiquadVector b) {
+  return _mm512_sub_ps(a, b);
+}
+inline BiquadVector mul(BiquadVector a, BiquadVector b) {
+  return _mm512_mul_ps(a, b);
+}
+#elif PEDALBOARD_KERNELS_AVX2
+constexpr int BIQUAD_LANES = 8;
+using BiquadVector = __m256;
+inline BiquadVector load(const float *p) { return _mm256_loadu_ps(p); }
+inline void store(float *p, BiquadVector v) { _mm256_storeu_ps(p, v); }
+inline BiquadVector add(BiquadVector a, BiquadVector b) {
+  return _mm256_add_ps(a, b);
+}
+inline BiquadVector sub(BiquadVector a, BiquadVector b) {
+  return _mm256_sub_ps(a, b);
+}
+inline BiquadVector mul(BiquadVector a, BiquadVector b) {
+  return _mm256_mul_ps(a, b);
+}
+#elif PEDALBOARD_KERNELS_SSE2
+constexpr int BIQUAD_LANES = 4;
+using BiquadVector = __m128;
+inline BiquadVector load(const float *p) { return _mm_loadu_ps(p); }
+inline void store(float *p, BiquadVector v) { _mm_storeu_ps(p, v); }
+inline BiquadVector add(BiquadVector a, BiquadVector b) {
+  return _mm_add_ps(a, b);
+}
+inline BiquadVector sub(BiquadVector a, BiquadVector b) {
+  return _mm_sub_ps(a, b);
+}
+inline BiquadVector mul(BiquadVector a, BiquadVector b) {
+  return _mm_mul_ps(a, b);
+}
+#elif PEDALBOARD_KERNELS_NEON
+constexpr int BIQUAD_LANES = 4;
+using BiquadVector = float32x4_t;
+inline BiquadVector load(const float *p) { return vld1q_f32(p); }
+inline void store(float *p, BiquadVector v) { vst1q_f32(p, v); }
+inline BiquadVector add(BiquadVector a, BiquadVector b) {
+  return vaddq_f32(a, b);
+}
+inline BiquadVector sub(BiquadVector a, BiquadVector b) {
+  return vsubq_f32(a, b);
+}
+inline BiquadVector mul(BiquadVector a, BiquadVector b) {
+  return vmulq_f32(a, b);
+}
+#else
+constexpr int BIQUAD_LANES = 1;
+using BiquadVector = float;
+inline BiquadVector load(const float *p) { return *p; }
+inline void store(float *p, BiquadVector v) { *p = v; }
+inline BiquadVector add(BiquadVector a, BiquadVector b) { return a + b; }
+inline BiquadVector sub(BiquadVector a, BiquadVector b) { return a - b; }
+inline BiquadVector mul(BiquadVector a, BiquadVector b) { return a * b; }
+#endif
+
+void biquadSteps(const BiquadStageGroup &group, int firstStep,
+                 int lastStep) {
+  const int C = group.lanesPerChannelGroup;
+  const int P = BIQUAD_LANES / C;
+  float *scratch = group.scratch;
+  float *outputs = scratch + C;
+
+  const BiquadVector vb0 = load(group.b0);
+  const BiquadVector vb1 = load(group.b1);
+  const BiquadVector vb2 = load(group.b2);
+  const BiquadVector va1 = load(group.a1);
+  const BiquadVector va2 = load(group.a2);
+  BiquadVector vz1 = load(group.z1);
+  BiquadVector vz2 = load(group.z2);
+
+  for (int t = firstStep; t < lastStep; t++) {
+    for (int c = 0; c < C; c++)
+      scratch[c] = group.channels[c][t];
+
+    BiquadVector x = load(scratch);
+    BiquadVector y = add(mul(vb0, x), vz1);
+    vz1 = add(sub(mul(vb1, x), mul(va1, y)), vz2);
+    vz2 = sub(mul(vb2, x), mul(va2, y));
+    store(outputs, y);
+
+    for (int c = 0; c < C; c++)
+      group.channels[c][t - P + 1] = outputs[BIQUAD_LANES - C + c];
+  }
+
+  store(group.z1, vz1);
+  store(group.z2, vz2);
+}
+
+#if PEDALBOARD_KERNELS_AVX2
+inline float horizontalSum(__m256 sum) {
+  __m128 half =
+      _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+  half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+  half = _mm_add_ss(half, _mm_shuffle_ps(half, half, 1));
+  return _mm_cvtss_f32(half);
+}
+#endif
+
+float dotProduct(const float *a, const float *b, int numSamples) {
+  int i = 0;
+#if PEDALBOARD_KERNELS_AVX512
+  // Two accumulators hide the latency of each fused multiply-add:
+  __m512 sum0 = _mm512_setzero_ps();
+  __m512 sum1 = _mm512_setzero_ps();
+  for (; i + 32 <= numSamples; i += 32) {
+    sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i),
+                           sum0);
+    sum1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16),
+                           _mm512_loadu_ps(b + i + 16), sum1);
+  }
+  for (; i + 16 <= numSamples; i += 16) {
+    sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i),
+                           sum0);
+  }
+  __m512 sum512 = _mm512_add_ps(sum0, sum1);
+  __m256 sum = _mm256_add_ps(
+      _mm512_castps512_ps256(sum512),
+      _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(sum512), 1)));
+  if (i < numSamples) {
+    sum = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum);
+  }
+  return horizontalSum(sum);
+#elif PEDALBOARD_KERNELS_AVX2
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+  for (; i + 16 <= numSamples; i += 16) {
+    sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i),
+                           sum0);
+    sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8),
+                           _mm256_loadu_ps(b + i + 8), sum1);
+  }
+  if (i < numSamples) {
+    sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i),
+                           sum0);
+  }
+  return horizontalSum(_mm256_add_ps(sum0, sum1));
+#elif PEDALBOARD_KERNELS_SSE2
+  __m128 sum0 = _mm_setzero_ps();
+  __m128 sum1 = _mm_setzero_ps();
+  for (; i < numSamples; i += 8) {
+    sum0 = _mm_add_ps(sum0,
+                      _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(a + i + 4),
+                                       _mm_loadu_ps(b + i + 4)));
+  }
+  __m128 sum = _mm_add_ps(sum0, sum1);
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+  return _mm_cvtss_f32(sum);
+#elif PEDALBOARD_KERNELS_NEON
+  float32x4_t sum0 = vdupq_n_f32(0);
+  float32x4_t sum1 = vdupq_n_f32(0);
+  for (; i < numSamples; i += 8) {
+    sum0 = vmlaq_f32(sum0, vld1q_f32(a + i), vld1q_f32(b + i));
+    sum1 = vmlaq_f32(sum1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+  }
+  float32x4_t sum = vaddq_f32(sum0, sum1);
+  float32x2_t pairs = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+  return vget_lane_f32(vpadd_f32(pairs, pairs), 0);
+#else
+  float sums[8] = {0};
+  for (; i < numSamples; i += 8) {
+    for (int j = 0; j < 8; j++) {
+      sums[j] += a[i + j] * b[i + j];
+    }
+  }
+  return ((sums[0] + sums[4]) + (sums[2] + sums[6])) +
+         ((sums[1] + sums[5]) + (sums[3] + sums[7]));
+#endif
+}
+
+// Computes the same sums as juce::dsp::Convolution's four separate
+// multiply-accumulate passes over the spectra, but in a single pass (and
+// with fused multiply-adds, where available):
+void complexMultiplyAccumulate(float *output, const float *input,
+                               const float *impulse, int numBins) {
+  float *outputReal = output;
+  float *outputImag = output + numBins;
+  const float *inputReal = input;
+  const float *inputImag = input + numBins;
+  const float *impulseReal = impulse;
+  const float *impulseImag = impulse + numBins;
+
+  int i = 0;
+#if PEDALBOARD_KERNELS_AVX512
+  for (; i + 16 <= numBins; i += 16) {
+    __m512 xr = _mm512_loadu_ps(inputReal + i);
+    __m512 xi = _mm512_loadu_ps(inputImag + i);
+    __m512 hr = _mm512_loadu_ps(impulseReal + i);
+    __m512 hi = _mm512_loadu_ps(impulseImag + i);
+    __m512 real = _mm512_fmadd_ps(xr, hr, _mm512_loadu_ps(outputReal + i));
+    __m512 imag = _mm512_fmadd_ps(xr, hi, _mm512_loadu_ps(outputImag + i));
+    _mm512_storeu_ps(outputReal + i, _mm512_fnmadd_ps(xi, hi, real));
+    _mm512_storeu_ps(outputImag + i, _mm512_fmadd_ps(xi, hr, imag));
+  }
+#endif
+#if PEDALBOARD_KERNELS_AVX2
+  for (; i + 8 <= numBins; i += 8) {
+    __m256 xr = _mm256_loadu_ps(inputReal + i);
+    __m256 xi = _mm256_loadu_ps(inputImag + i);
+    __m256 hr = _mm256_loadu_ps(impulseReal + i);
+    __m256 hi = _mm256_loadu_ps(impulseImag + i);
+    __m256 real = _mm256_fmadd_ps(xr, hr, _mm256_loadu_ps(outputReal + i));
+    __m256 imag = _mm256_fmadd_ps(xr, hi, _mm256_loadu_ps(outputImag + i));
+    _mm256_storeu_ps(outputReal + i, _mm256_fnmadd_ps(xi, hi, real));
+    _mm256_storeu_ps(outputImag + i, _mm256_fmadd_ps(xi, hr, imag));
+  }
+#elif PEDALBOARD_KERNELS_SSE2
+  for (; i + 4 <= numBins; i += 4) {
+    __m128 xr = _mm_loadu_ps(inputReal + i);
+    __m128 xi = _mm_loadu_ps(inputImag + i);
+    __m128 hr = _mm_loadu_ps(impulseReal + i);
+    __m128 hi = _mm_loadu_ps(impulseImag + i);
+    __m128 real = _mm_add_ps(_mm_loadu_ps(outputReal + i), _mm_mul_ps(xr, hr));
+    __m128 imag = _mm_add_ps(_mm_loadu_ps(outputImag + i), _mm_mul_ps(xr, hi));
+    _mm_storeu_ps(outputReal + i, _mm_sub_ps(real, _mm_mul_ps(xi, hi)));
+    _mm_storeu_ps(outputImag + i, _mm_add_ps(imag, _mm_mul_ps(xi, hr)));
+  }
+#elif PEDALBOARD_KERNELS_NEON
+  for (; i + 4 <= numBins; i += 4) {
+    float32x4_t xr = vld1q_f32(inputReal + i);
+    float32x4_t xi = vld1q_f32(inputImag + i);
+    float32x4_t hr = vld1q_f32(impulseReal + i);
+    float32x4_t hi = vld1q_f32(impulseImag + i);
+    float32x4_t real = vfmaq_f32(vld1q_f32(outputReal + i), xr, hr);
+    float32x4_t imag = vfmaq_f32(vld1q_f32(outputImag + i), xr, hi);
+    vst1q_f32(outputReal + i, vfmsq_f32(real, xi, hi));
+    vst1q_f32(outputImag + i, vfmaq_f32(imag, xi, hr));
+  }
+#endif
+  for (; i < numBins; i++) {
+    float real = outputReal[i] + inputReal[i] * impulseReal[i];
+    float imag = outputImag[i] + inputReal[i] * impulseImag[i];
+    outputReal[i] = real - inputImag[i] * impulseImag[i];
+    outputImag[i] = imag + inputImag[i] * impulseReal[i];
+  }
+}
+
+} // namespace
+
+const Kernels PEDALBOARD_KERNELS_TABLE = {
+    PEDALBOARD_KERNELS_NAME,
+    deinterleaveStereo,
+    interleaveStereo,
+    bitcrushFloat,
+    bitcrushDouble,
+    clipFloat,
+    clipDouble,
+    multiplyFloat,
+    multiplyDouble,
+    BIQUAD_LANES,
+    biquadSteps,
+    dotProduct,
+    complexMultiplyAccumulate,
+};
+
+} // namespace simd
+} // namespace Pedalboard
+
+#if PEDALBOARD_KERNELS_AVX2
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC diagnostic pop
+#pragma GCC pop_options
+#endif
+#endif
@@ -0,0 +1,112 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) ||           \
+    defined(_M_IX86)
+#define PEDALBOARD_SIMD_X86 1
+#endif
+
+namespace Pedalboard {
+namespace simd {
+
+/**
+ * The per-lane coefficients and state of one group of biquad stages in a
+ * BiquadCascade, and the channels it filters. Each array holds one value per
+ * SIMD lane (see Kernels::biquadLanes).
+ */
+struct BiquadStageGroup {
+  const float *b0, *b1, *b2, *a1, *a2;
+  float *z1, *z2;
+
+  // One pointer per channel lane:
+  float *const *channels;
+  int lanesPerChannelGroup;
+
+  // Room for 2 * biquadLanes floats: the next input sample of each channel,
+  // followed by the most recent output of every lane.
+  float *scratch;
+};
+
+/**
+ * A table of the hot inner loops used throughout Pedalboard, compiled once for
+ * each instruction set we support (see KernelImplementations.h). Only one
+ * table is used by each process: the most capable one the CPU supports, as
+ * chosen by getKernels() in Dispatch.h.
+ *
+ * Kernels that return a number of samples leave any remainder after that
+ * number to a scalar loop in the caller. All others process every sample.
+ */
+struct Kernels {
+  // The name of the instruction set these kernels use, as reported by
+  // pedalboard.cpu_features():
+  const char *name;
+
+  // Split interleaved stereo floats into two channels, or vice versa:
+  unsigned int (*deinterleaveStereo)(const float *interleaved, float *left,
+                                     float *right, unsigned int numFrames);
+  unsigned int (*interleaveStereo)(const float *left, const float *right,
+                                   float *interleaved, unsigned int numFrames);
+
+  // Compute nearbyint(x * scale) * inverseScale in place, rounding halfway
+  // cases to even:
+  int (*bitcrushFloat)(float *samples, int numSamples, float scale,
+                       float inverseScale);
+  int (*bitcrushDouble)(double *samples, int numSamples, double scale,
+                        double inverseScale);
+
+  // Limit each sample to [low, high] in place:
+  void (*clipFloat)(float *samples, int numSamples, float low, float high);
+  void (*clipDouble)(double *samples, int numSamples, double low,
+                     double high);
+
+  // Multiply each sample by a constant in place:
+  void (*multiplyFloat)(float *samples, int numSamples, float gain);
+  void (*multiplyDouble)(double *samples, int numSamples, double gain);
+
+  // The number of biquads run at once by biquadSteps:
+  int biquadLanes;
+
+  // Run the steps [firstStep, lastStep) of a BiquadCascade's stage group,
+  // all of which must have every lane's pipeline full:
+  void (*biquadSteps)(const BiquadStageGroup &group, int firstStep,
+                      int lastStep);
+
+  // The dot product of two arrays whose length is a multiple of 8, summed in
+  // an order that depends only on the instruction set:
+  float (*dotProduct)(const float *a, const float *b, int numSamples);
+
+  // Accumulate the product of two complex spectra, each stored as numBins
+  // real parts followed by numBins imaginary parts, into output:
+  void (*complexMultiplyAccumulate)(float *output, const float *input,
+                                    const float *impulse, int numBins);
+};
+
+// Defined in KernelsBaseline.cpp, compiled for the instruction set the rest
+// of Pedalboard is built for (SSE2 on x86, NEON on ARM, or plain C++):
+extern const Kernels baselineKernels;
+
+#if PEDALBOARD_SIMD_X86
+// Defined in KernelsAVX2.cpp and KernelsAVX512.cpp, which are compiled for
+// their instruction sets regardless of the compiler flags used:
+extern const Kernels avx2Kernels;
+extern const Kernels avx512Kernels;
+#endif
+
+} // namespace simd
+} // namespace Pedalboard
@@ -0,0 +1,26 @@
+/*
+ * pedalboard
+ * Copyright 2023 Spotify AB
+ *
+ * Licensed under the GNU Public License, Version 3.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Kernels for x86 CPUs with AVX2 and FMA (Intel Haswell and AMD Excavator, and
+// newer). Only selected at runtime if the CPU and OS support both.
+#include "Kernels.h"
+
+#if PEDALBOARD_SIMD_X86
+#define PEDALBOARD_KERNELS_AVX2 1
+#define PEDALBOARD_KERNELS_TABLE avx2Kernels
+#include "KernelImplementations.h"
+#endif
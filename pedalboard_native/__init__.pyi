@@ -41,6 +41,7 @@ __all__ = [
     "Convolution",
     "Delay",
     "Distortion",
+    "EQ",
     "ExternalPlugin",
     "GSMFullRateCompressor",
     "Gain",
@@ -50,6 +51,7 @@ __all__ = [
     "Invert",
     "LadderFilter",
     "Limiter",
+    "LoudnessMeter",
     "LowShelfFilter",
     "LowpassFilter",
     "MP3Compressor",
@@ -61,9 +63,15 @@ __all__ = [
     "PluginContainer",
     "Resample",
     "Reverb",
+    "StreamingProcessor",
     "VST3Plugin",
     "io",
+    "cpu_features",
+    "get_realtime_audit_report",
     "process",
+    "render_file",
+    "set_profiling_enabled",
+    "set_realtime_audit_mode",
     "utils",
 ]
 
@@ -78,6 +86,9 @@ class Plugin:
         sample_rate: float,
         buffer_size: int = 8192,
         reset: bool = True,
+        inplace: bool = False,
+        *,
+        out: typing.Optional[numpy.ndarray] = None,
     ) -> numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]]:
         """
         Run an audio buffer through this plugin. Alias for :py:meth:`process`.
@@ -88,6 +99,9 @@ class Plugin:
         sample_rate: float,
         buffer_size: int = 8192,
         reset: bool = True,
+        inplace: bool = False,
+        *,
+        out: typing.Optional[numpy.ndarray] = None,
     ) -> numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]]:
         """
         Run a 32-bit or 64-bit floating point audio buffer through this plugin.
@@ -100,8 +114,21 @@ class Plugin:
         audio, pass another audio buffer into ``process`` with ``reset`` set to
         ``True``.
 
-        If the provided buffer uses a 64-bit datatype, it will be converted to 32-bit
-        for processing.
+        If the provided buffer uses a 64-bit datatype, it will be processed and
+        returned as 64-bit audio. (Plugins that don't support 64-bit processing
+        natively will still process audio with 32-bit precision internally.)
+
+        A batch of independent audio clips can be processed in one call by passing a
+        3-dimensional array of shape ``(batch_size, num_channels, num_samples)``. Each
+        clip is processed from a clean state (as if :py:meth:`process` were called
+        once per clip with ``reset=True``), in parallel across native threads, and
+        the results are returned in a single array of the same shape. ``reset`` must
+        be ``True`` when passing a batch.
+
+        A PyTorch (or other DLPack-compatible) tensor in CPU memory may be passed
+        instead of a NumPy array. Its memory will be read directly, without first
+        being copied into a NumPy array, and the output will be returned as a tensor
+        of the same type.
 
         The provided ``buffer_size`` argument will be used to control the size of
         each chunk of audio provided to the plugin. Higher buffer sizes may speed up
@@ -112,6 +139,26 @@ class Plugin:
         If calling ``process`` multiple times while processing the same audio file
         or buffer, set ``reset`` to ``False``.
 
+        If ``inplace`` is ``True``, the provided buffer will be overwritten with the
+        processed audio and returned, rather than allocating a new buffer. If the
+        buffer is a writeable, contiguous, floating point array with shape
+        ``(num_channels, num_samples)`` (or ``(num_samples,)``) and this plugin adds
+        no latency, audio will be processed directly in the buffer's memory without
+        making any copies. If fewer samples are returned than were provided, the
+        returned array will be a view onto the end of the provided buffer.
+
+        If an ``out`` array (i.e.: a ``numpy.memmap``) with the same shape and
+        datatype as the input is provided, the input will be read (and the output
+        written) in windows of a fixed size, rather than copying the entire input
+        into memory and allocating a new output array. This keeps memory usage
+        constant regardless of the length of the audio, allowing arrays larger than
+        memory to be processed. The output is identical to that returned without
+        ``out``, and ``out`` itself is returned. (If ``reset`` is ``False`` and fewer
+        samples are returned than were provided, the returned array will be a view
+        onto the start of ``out``, and the rest of ``out`` will be left untouched.)
+        The input array may also be passed as ``out`` to process it in-place.
+        ``out`` can't be combined with ``inplace`` or with batched input.
+
         .. note::
             The :py:meth:`process` method can also be used via :py:meth:`__call__`;
             i.e.: just calling this object like a function (``my_plugin(...)``) will
@@ -123,6 +170,140 @@ class Plugin:
         """
         Clear any internal state stored by this plugin (e.g.: reverb tails, delay lines, LFO state, etc). The values of plugin parameters will remain unchanged.
         """
+    def clone(self) -> Plugin:
+        """
+        Return a new, independent copy of this plugin (and of any plugins it
+        contains) with the same parameters, but without any of its internal state
+        (i.e.: reverb tails). Copies can be used on other threads at the same time as
+        the original, making it easy to process audio in parallel with one copy per
+        thread.
+
+        Cloning is much cheaper than constructing a new plugin: the impulse responses
+        of :class:`Convolution` plugins are shared between copies rather than being
+        loaded again, and external plugins (i.e.: :class:`VST3Plugin`) have their
+        state copied with ``getStateInformation`` rather than being reconfigured from
+        Python.
+
+        Automated parameters (see :py:meth:`automate`) are not copied. Raises a
+        ``RuntimeError`` if the plugin can't be cloned (for example, external
+        plugins that must be reloaded after being reset, or clones requested from a
+        thread other than the main thread).
+
+        *Introduced in v0.9.0.*
+        """
+    def automate(
+        self,
+        parameter_name: str,
+        values: typing.Union[numpy.ndarray, typing.List[typing.Tuple[float, typing.Any]], None],
+    ) -> None:
+        """
+        Change the value of one of this plugin's parameters over time while audio is
+        processed, rather than keeping it fixed for the duration of each call to
+        :py:meth:`process`.
+
+        ``values`` may be either a one-dimensional NumPy array containing one value
+        per sample, or a list of ``(time_in_seconds, value)`` pairs (sorted by time)
+        between which the value is linearly interpolated. Before the first (or after
+        the last) value, the first (or last) value is held. Pass ``None`` to stop
+        automating the parameter, leaving it at its most recent value.
+
+        Curves start from the beginning each time this plugin is reset, and continue
+        across calls to :py:meth:`process` with ``reset=False``. Automated
+        parameters are updated every :py:attr:`automation_interval` samples inside
+        the processing loop, so the same audio is produced regardless of the
+        ``buffer_size`` used::
+
+           from pedalboard import LowpassFilter
+           import numpy as np
+
+           lowpass = LowpassFilter()
+           # Sweep the cutoff from 200Hz to 8kHz over two seconds:
+           lowpass.automate("cutoff_frequency_hz", [(0, 200), (2, 8000)])
+           output = lowpass(audio, sample_rate)
+
+           # Or provide one value per sample:
+           lowpass.automate("cutoff_frequency_hz", np.geomspace(200, 8000, len(audio)))
+
+        Built-in plugins support automating most of their numeric parameters. For
+        :class:`pedalboard.VST3Plugin` and :class:`pedalboard.AudioUnitPlugin`,
+        any parameter in :py:attr:`parameters` can be automated.
+
+        *Introduced in v0.9.0.*
+        """
+    def clear_automation(self) -> None:
+        """
+        Stop automating all of this plugin's parameters, leaving each at its most recent value.
+
+        *Introduced in v0.9.0.*
+        """
+    def profile(
+        self, reset: bool = False
+    ) -> typing.Dict[Plugin, typing.Dict[str, typing.Union[int, float]]]:
+        """
+        Return the profiling statistics collected for this plugin and every plugin
+        nested within it while profiling was enabled (see
+        :py:func:`pedalboard.set_profiling_enabled`), as a dictionary mapping each
+        plugin to a dictionary of:
+
+         - ``calls``: the number of times the plugin processed a block of audio.
+         - ``samples_processed``: the total number of samples in those blocks.
+         - ``seconds``: the total wall-clock time spent processing those blocks.
+           For plugins that contain other plugins (like :class:`Chain` or
+           :class:`Mix`), this includes the time spent in those plugins.
+         - ``reallocations``: the number of times the output buffer of
+           :py:meth:`process` had to be grown to make room for the latency of
+           this plugin.
+         - ``latency_samples``: the latency currently reported by the plugin, in
+           samples.
+
+        If ``reset`` is ``True``, each plugin's statistics are set back to zero (other
+        than ``latency_samples``, which is not cumulative).
+
+        *Introduced in v0.9.0.*
+        """
+    def process_batch(
+        self,
+        input_arrays: typing.List[numpy.ndarray],
+        sample_rate: float,
+        num_workers: typing.Optional[int] = None,
+        buffer_size: int = 8192,
+    ) -> typing.List[numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]]]:
+        """
+        Run many independent 32-bit or 64-bit floating point audio buffers through
+        this plugin, returning a list of processed buffers in the same order.
+
+        Each buffer is processed from a clean state, exactly as if :py:meth:`process`
+        had been called once per buffer with ``reset=True``. Buffers may have
+        different lengths and channel counts.
+
+        Processing is spread across ``num_workers`` native threads (by default, one
+        per CPU core) without holding Python's Global Interpreter Lock. Each thread
+        processes buffers with its own independent copy of this plugin (and of any
+        plugins it contains), so the results are identical regardless of the number
+        of workers used.
+
+        .. note::
+            If this plugin (or any plugin it contains) cannot be copied - for example,
+            a :class:`VST3Plugin` or :class:`AudioUnitPlugin` - all buffers will be
+            processed one at a time on the calling thread instead.
+
+        *Introduced in v0.9.0.*
+        """
+    def stream(
+        self,
+        sample_rate: float,
+        num_channels: int,
+        buffer_size: int = 8192,
+        reset: bool = True,
+    ) -> StreamingProcessor:
+        """
+        Create a :class:`StreamingProcessor` that runs a stream of audio through this
+        plugin one chunk at a time, preparing this plugin only once and reusing its
+        buffers between chunks. Prefer this over calling :py:meth:`process`
+        repeatedly with ``reset=False`` when processing long recordings in chunks.
+
+        *Introduced in v0.9.0.*
+        """
     @property
     def is_effect(self) -> bool:
         """
@@ -141,6 +322,46 @@ class Plugin:
 
 
         """
+    @property
+    def automated_parameters(self) -> typing.List[str]:
+        """
+        The names of this plugin's parameters that are currently automated (see :py:meth:`automate`), in alphabetical order.
+
+        *Introduced in v0.9.0.*
+        """
+    @property
+    def automation_interval(self) -> int:
+        """
+        The number of samples between updates of this plugin's automated parameters (see :py:meth:`automate`). Set this to 1 to update parameters on every sample, at the cost of calling the plugin once per sample. Defaults to 32.
+
+        *Introduced in v0.9.0.*
+        """
+    @automation_interval.setter
+    def automation_interval(self, arg1: int) -> None:
+        pass
+    @property
+    def skip_silence(self) -> bool:
+        """
+        If ``True``, this plugin stops processing audio while its input is silent,
+        once any sound it was already producing (i.e.: a reverb tail) has decayed
+        below -120dB. The plugin is reset when it stops processing, and starts again
+        as soon as its input is no longer silent. This can save a lot of time when
+        processing audio with long silent regions, and changes the output by an
+        inaudible amount (if at all).
+
+        Only plugins with a known tail length are skipped: :class:`Gain`,
+        :class:`Invert`, :class:`Clipping`, :class:`Bitcrush`, :class:`Compressor`,
+        :class:`Limiter`, :class:`Reverb` (unless ``freeze_mode`` is enabled),
+        :class:`Convolution`, and IIR filters like :class:`LowpassFilter`, as well
+        as :class:`Chain`, :class:`Mix`, and :class:`Pedalboard` objects that only
+        contain those plugins. Plugins with latency or with automated parameters
+        (see :py:meth:`automate`) are never skipped. Defaults to ``False``.
+
+        *Introduced in v0.9.0.*
+        """
+    @skip_silence.setter
+    def skip_silence(self, arg1: bool) -> None:
+        pass
     pass
 
 class Bitcrush(Plugin):
@@ -250,6 +471,7 @@ class Compressor(Plugin):
         ratio: float = 1,
         attack_ms: float = 1.0,
         release_ms: float = 100,
+        linked: bool = False,
     ) -> None: ...
     def __repr__(self) -> str: ...
     @property
@@ -259,6 +481,20 @@ class Compressor(Plugin):
     def attack_ms(self, arg1: float) -> None:
         pass
     @property
+    def linked(self) -> bool:
+        """
+        If ``True``, the compressor is driven by the loudest channel and applies the same gain to every channel, preserving the stereo image. If ``False`` (the default), each channel is processed independently.
+
+        *Introduced in v0.9.0.*
+        """
+    @linked.setter
+    def linked(self, arg1: bool) -> None:
+        """
+        If ``True``, the compressor is driven by the loudest channel and applies the same gain to every channel, preserving the stereo image. If ``False`` (the default), each channel is processed independently.
+
+        *Introduced in v0.9.0.*
+        """
+    @property
     def ratio(self) -> float:
         """ """
     @ratio.setter
@@ -281,19 +517,71 @@ class Compressor(Plugin):
 class Convolution(Plugin):
     """
     An audio convolution, suitable for things like speaker simulation or reverb modeling.
+
+    By default, the entire impulse response is convolved with uniformly sized partitions no larger than the buffer size, which is expensive for long impulse responses (i.e.: reverbs). Passing ``head_size`` (in samples) switches to non-uniform partitioning: the first ``head_size`` samples of the impulse response are still convolved with zero latency, but the remainder (the "tail") is convolved using partitions of ``head_size`` samples, which is much cheaper. Head sizes are rounded up to a power of two of at least 64 samples; values between 1024 and 8192 work well for multi-second reverbs.
+
+    If ``num_threads`` is greater than 1, the head and tail of each channel are convolved concurrently on a pool of background threads. The output is bit-for-bit identical regardless of the number of threads used.
+
+    The impulse response may be provided either as the path to an audio file or as a mono or stereo NumPy array, in which case ``sample_rate`` must be provided too.
+
+    Impulse responses are decoded, resampled and transformed only once, and shared between every :class:`Convolution` that uses the same file (or an array with the same contents) and settings; modifying the file on disk causes it to be loaded again.
+
+    *Support for non-uniform partitioning, multiple threads, and in-memory impulse responses introduced in v0.9.0.*
     """
 
-    def __init__(self, impulse_response_filename: str, mix: float = 1.0) -> None: ...
+    def __init__(
+        self,
+        impulse_response_filename: typing.Union[
+            str, numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]]
+        ],
+        mix: float = 1.0,
+        sample_rate: typing.Optional[float] = None,
+        *,
+        head_size: typing.Optional[int] = None,
+        num_threads: int = 1,
+    ) -> None: ...
     def __repr__(self) -> str: ...
     @property
-    def impulse_response_filename(self) -> str:
-        """ """
+    def head_size(self) -> typing.Optional[int]:
+        """
+        The number of samples at the start of the impulse response that are convolved with zero latency using short partitions, with the rest of the impulse response convolved using longer (and cheaper) partitions of this size. ``None`` if the whole impulse response uses uniform partitioning.
+
+        *Introduced in v0.9.0.*
+        """
+    @property
+    def impulse_response(
+        self,
+    ) -> typing.Optional[numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]]]:
+        """
+        A copy of the impulse response provided as a NumPy array, with shape ``(num_channels, num_samples)``, or ``None`` if it was loaded from a file.
+
+        *Introduced in v0.9.0.*
+        """
+    @property
+    def impulse_response_filename(self) -> typing.Optional[str]:
+        """
+        The path of the audio file that the impulse response was loaded from, or ``None`` if it was provided as a NumPy array.
+        """
     @property
     def mix(self) -> float:
         """ """
     @mix.setter
     def mix(self, arg1: float) -> None:
         pass
+    @property
+    def num_threads(self) -> int:
+        """
+        The number of threads used to convolve audio.
+
+        *Introduced in v0.9.0.*
+        """
+    @property
+    def sample_rate(self) -> typing.Optional[float]:
+        """
+        The sample rate of the impulse response provided as a NumPy array, or ``None`` if it was loaded from a file (in which case the file's own sample rate is used).
+
+        *Introduced in v0.9.0.*
+        """
     pass
 
 class Delay(Plugin):
@@ -342,6 +630,28 @@ class Distortion(Plugin):
         pass
     pass
 
+class EQ(Plugin):
+    """
+    A multi-band equalizer, which applies a list of filters (each of which must be a :class:`PeakFilter`, :class:`LowShelfFilter`, :class:`HighShelfFilter`, :class:`HighpassFilter`, or :class:`LowpassFilter`) in order.
+
+    The output is equivalent to running each filter in a :class:`Pedalboard`, but all bands are processed together, with multiple channels and multiple bands computed at once with SIMD instructions.
+
+    The parameters of each band are read every time audio is processed, so filters in the list can be changed between calls (i.e.: when processing audio in chunks with ``reset=False``). Such changes are smoothly ramped in over 50 milliseconds to avoid audible artifacts.
+
+    *Introduced in v0.9.0.*
+    """
+
+    def __init__(self, bands: typing.List[Plugin] = []) -> None: ...
+    def __repr__(self) -> str: ...
+    @property
+    def bands(self) -> typing.List[Plugin]:
+        """
+        The filters applied by this EQ, in order.
+        """
+    @bands.setter
+    def bands(self, arg1: typing.List[Plugin]) -> None: ...
+    pass
+
 class ExternalPlugin(Plugin):
     """
     A wrapper around a third-party effect plugin.
@@ -395,8 +705,9 @@ class ExternalPlugin(Plugin):
         itself. To receive the remaining audio, pass another audio buffer into
         ``process`` with ``reset`` set to ``True``.
 
-        If the provided buffer uses a 64-bit datatype, it will be converted to 32-bit
-        for processing.
+        If the provided buffer uses a 64-bit datatype, it will be processed and
+        returned as 64-bit audio. (Plugins that don't support 64-bit processing
+        natively will still process audio with 32-bit precision internally.)
 
         If provided MIDI messages as input, the provided ``midi_messages`` must be
         a Python ``List`` containing one of the following types:
@@ -479,8 +790,9 @@ class ExternalPlugin(Plugin):
         itself. To receive the remaining audio, pass another audio buffer into
         ``process`` with ``reset`` set to ``True``.
 
-        If the provided buffer uses a 64-bit datatype, it will be converted to 32-bit
-        for processing.
+        If the provided buffer uses a 64-bit datatype, it will be processed and
+        returned as 64-bit audio. (Plugins that don't support 64-bit processing
+        natively will still process audio with 32-bit precision internally.)
 
         If provided MIDI messages as input, the provided ``midi_messages`` must be
         a Python ``List`` containing one of the following types:
@@ -558,6 +870,25 @@ class ExternalPlugin(Plugin):
         buffer_size: int = 8192,
         reset: bool = True,
     ) -> numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]]: ...
+    def automate(
+        self,
+        parameter_name: str,
+        values: typing.Union[numpy.ndarray, typing.List[typing.Tuple[float, typing.Any]], None],
+    ) -> None:
+        """
+        Change the value of one of this plugin's parameters over time while audio is processed. ``parameter_name`` must be one of the keys of :py:attr:`parameters`, and ``values`` (in the same units used when setting that parameter as an attribute) may be a one-dimensional NumPy array with one value per sample, or a list of ``(time_in_seconds, value)`` pairs. See :py:meth:`pedalboard.Plugin.automate` for details.
+
+        .. note::
+            Values between ``(time_in_seconds, value)`` pairs are interpolated linearly in the parameter's raw value (see :py:attr:`AudioProcessorParameter.raw_value`), which may not be linear in the parameter's units.
+
+        *Introduced in v0.9.0.*
+        """
+    scan_cache_path: typing.ClassVar[typing.Optional[str]]
+    """
+    The path of a file in which to cache the results of scanning plugin files, or ``None`` (the default) to scan plugin files every time they're loaded. Each plugin file is only re-scanned if its modification time has changed since it was last scanned, which can make loading plugins much faster. The file will be created if it does not exist, and may be shared between processes.
+
+    *Introduced in v0.9.0.*
+    """
     pass
 
 class Gain(Plugin):
@@ -719,9 +1050,23 @@ class Limiter(Plugin):
     A simple limiter with standard threshold and release time controls, featuring two compressors and a hard clipper at 0 dB.
     """
 
-    def __init__(self, threshold_db: float = -10.0, release_ms: float = 100.0) -> None: ...
+    def __init__(self, threshold_db: float = -10.0, release_ms: float = 100.0, linked: bool = False) -> None: ...
     def __repr__(self) -> str: ...
     @property
+    def linked(self) -> bool:
+        """
+        If ``True``, the limiter is driven by the loudest channel and applies the same gain to every channel, preserving the stereo image. If ``False`` (the default), each channel is processed independently.
+
+        *Introduced in v0.9.0.*
+        """
+    @linked.setter
+    def linked(self, arg1: bool) -> None:
+        """
+        If ``True``, the limiter is driven by the loudest channel and applies the same gain to every channel, preserving the stereo image. If ``False`` (the default), each channel is processed independently.
+
+        *Introduced in v0.9.0.*
+        """
+    @property
     def release_ms(self) -> float:
         """ """
     @release_ms.setter
@@ -735,6 +1080,53 @@ class Limiter(Plugin):
         pass
     pass
 
+class LoudnessMeter(Plugin):
+    """
+    A plugin that measures the loudness of the audio passing through it (as specified by ITU-R BS.1770-4 and EBU R128) without changing it. Add a :class:`LoudnessMeter` to the end of a :class:`Pedalboard` to measure the loudness of its output while rendering, rather than making another pass over the output afterwards.
+
+    Measurements start when the meter is reset (i.e.: at the start of every call to :meth:`process` with ``reset=True``) and continue to accumulate across calls made with ``reset=False``, so audio can be measured in chunks (i.e.: with :func:`pedalboard.render_file`). Integrated loudness is computed from a fixed-size histogram, so measuring audio of any length takes a constant amount of memory.
+
+    Five-channel audio is assumed to be laid out as L, R, C, Ls, Rs, and six-channel audio as L, R, C, LFE, Ls, Rs; surround channels are weighted by +1.5dB and the LFE channel is ignored. All channels are weighted equally for other channel counts.
+
+    Loudness values that have not yet been measured (i.e.: short-term loudness, before three seconds of audio have been processed) are ``-inf``.
+
+    *Introduced in v0.9.0.*
+    """
+
+    def __init__(self) -> None: ...
+    def __repr__(self) -> str: ...
+    @property
+    def integrated_loudness(self) -> float:
+        """
+        The integrated (gated) loudness of all audio measured so far, in LUFS.
+        """
+    @property
+    def max_momentary_loudness(self) -> float:
+        """
+        The largest momentary loudness measured so far, in LUFS.
+        """
+    @property
+    def max_short_term_loudness(self) -> float:
+        """
+        The largest short-term loudness measured so far, in LUFS.
+        """
+    @property
+    def momentary_loudness(self) -> float:
+        """
+        The loudness of the most recent 400 milliseconds of audio, in LUFS.
+        """
+    @property
+    def short_term_loudness(self) -> float:
+        """
+        The loudness of the most recent three seconds of audio, in LUFS.
+        """
+    @property
+    def true_peak(self) -> float:
+        """
+        The largest true peak level (the peak level of the audio after 4x oversampling) measured so far, in dBTP.
+        """
+    pass
+
 class LowShelfFilter(IIRFilter, Plugin):
     """
     A low shelf filter with variable Q and gain, as would be used in an equalizer. Frequencies below the cutoff frequency will be boosted (or cut) by the provided gain value.
@@ -788,9 +1180,23 @@ class MP3Compressor(Plugin):
     Note that the MP3 format only supports 32kHz, 44.1kHz, and 48kHz audio; if an unsupported sample rate is provided, an exception will be thrown at processing time.
     """
 
-    def __init__(self, vbr_quality: float = 2.0) -> None: ...
+    def __init__(self, vbr_quality: float = 2.0, reuse_encoders: bool = False) -> None: ...
     def __repr__(self) -> str: ...
     @property
+    def reuse_encoders(self) -> bool:
+        """
+        If ``True``, configured MP3 encoders are kept in a shared pool between calls and reused, which makes compressing many short clips much faster. A reused encoder carries some internal state over from its previous stream, so its output is not bit-identical to that of a new encoder and may differ between otherwise identical calls. If ``False`` (the default), every call uses a new encoder and produces deterministic output.
+
+        *Introduced in v0.9.0.*
+        """
+    @reuse_encoders.setter
+    def reuse_encoders(self, arg1: bool) -> None:
+        """
+        If ``True``, configured MP3 encoders are kept in a shared pool between calls and reused, which makes compressing many short clips much faster. A reused encoder carries some internal state over from its previous stream, so its output is not bit-identical to that of a new encoder and may differ between otherwise identical calls. If ``False`` (the default), every call uses a new encoder and produces deterministic output.
+
+        *Introduced in v0.9.0.*
+        """
+    @property
     def vbr_quality(self) -> float:
         """ """
     @vbr_quality.setter
@@ -809,6 +1215,7 @@ class NoiseGate(Plugin):
         ratio: float = 10,
         attack_ms: float = 1.0,
         release_ms: float = 100.0,
+        linked: bool = False,
     ) -> None: ...
     def __repr__(self) -> str: ...
     @property
@@ -818,6 +1225,20 @@ class NoiseGate(Plugin):
     def attack_ms(self, arg1: float) -> None:
         pass
     @property
+    def linked(self) -> bool:
+        """
+        If ``True``, the noise gate is driven by the loudest channel and applies the same gain to every channel, preserving the stereo image. If ``False`` (the default), each channel is processed independently.
+
+        *Introduced in v0.9.0.*
+        """
+    @linked.setter
+    def linked(self, arg1: bool) -> None:
+        """
+        If ``True``, the noise gate is driven by the loudest channel and applies the same gain to every channel, preserving the stereo image. If ``False`` (the default), each channel is processed independently.
+
+        *Introduced in v0.9.0.*
+        """
+    @property
     def ratio(self) -> float:
         """ """
     @ratio.setter
@@ -985,9 +1406,33 @@ class AudioUnitPlugin(ExternalPlugin):
         parameter_values: object = None,
         plugin_name: typing.Optional[str] = None,
         initialization_timeout: float = 10.0,
+        pooled: bool = False,
     ) -> None: ...
     def __repr__(self) -> str: ...
     def _get_parameter(self, arg0: str) -> _AudioProcessorParameter: ...
+    def _get_parameter_text_ranges(
+        self, name: str, search_steps: int = 1000, slow: bool = False
+    ) -> typing.List[typing.Tuple[float, float, str]]: ...
+    def _get_raw_parameter_values(self) -> typing.Dict[str, typing.Tuple[float, str]]: ...
+    def _set_raw_parameter_values(self, raw_values: typing.Dict[str, float]) -> None: ...
+    def _automate_raw(
+        self,
+        name: str,
+        raw_values: typing.Union[numpy.ndarray, typing.List[typing.Tuple[float, float]], None],
+    ) -> None: ...
+    @staticmethod
+    def clear_instance_pool() -> int:
+        """
+        Delete all idle plugin instances of this format that were created with
+        ``pooled=True`` and returned to the instance pool when their plugin objects
+        were destroyed. Returns the number of instances deleted.
+
+        Pooled instances are kept loaded (along with the global state that
+        plugins depend on) until this method is called, which happens automatically
+        at interpreter exit.
+
+        *Introduced in v0.9.0.*
+        """
     @staticmethod
     def get_plugin_names_for_file(filename: str) -> typing.List[str]:
         """
@@ -1016,8 +1461,9 @@ class AudioUnitPlugin(ExternalPlugin):
         itself. To receive the remaining audio, pass another audio buffer into
         ``process`` with ``reset`` set to ``True``.
 
-        If the provided buffer uses a 64-bit datatype, it will be converted to 32-bit
-        for processing.
+        If the provided buffer uses a 64-bit datatype, it will be processed and
+        returned as 64-bit audio. (Plugins that don't support 64-bit processing
+        natively will still process audio with 32-bit precision internally.)
 
         If provided MIDI messages as input, the provided ``midi_messages`` must be
         a Python ``List`` containing one of the following types:
@@ -1100,8 +1546,9 @@ class AudioUnitPlugin(ExternalPlugin):
         itself. To receive the remaining audio, pass another audio buffer into
         ``process`` with ``reset`` set to ``True``.
 
-        If the provided buffer uses a 64-bit datatype, it will be converted to 32-bit
-        for processing.
+        If the provided buffer uses a 64-bit datatype, it will be processed and
+        returned as 64-bit audio. (Plugins that don't support 64-bit processing
+        natively will still process audio with 32-bit precision internally.)
 
         If provided MIDI messages as input, the provided ``midi_messages`` must be
         a Python ``List`` containing one of the following types:
@@ -1181,6 +1628,54 @@ class AudioUnitPlugin(ExternalPlugin):
         buffer_size: int = 8192,
         reset: bool = True,
     ) -> numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]]: ...
+    @typing.overload
+    def process_batch(
+        self,
+        midi_clips: typing.List[object],
+        duration: typing.Union[float, typing.List[float]],
+        sample_rate: float,
+        num_channels: int = 2,
+        num_workers: typing.Optional[int] = None,
+        buffer_size: int = 8192,
+    ) -> typing.List[numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]]]:
+        """
+        Run many independent audio buffers *or* MIDI clips through this plugin,
+        returning a list of rendered buffers in the same order.
+
+        When provided MIDI clips (each a list of MIDI messages, in any of the
+        formats accepted by :py:meth:`process`), each clip is rendered into
+        ``duration`` seconds of audio. ``duration`` may be a single number, or a
+        list with one duration per clip.
+
+        Clips are spread across ``num_workers`` native threads (by default, one
+        per CPU core) without holding Python's Global Interpreter Lock. Every
+        thread other than the first renders clips through its own clone of this
+        plugin, with its state copied from this plugin (via its
+        ``getStateInformation`` and ``setStateInformation`` methods) on every call.
+        Clones are created the first time they're needed and are kept for later
+        calls, as loading a plugin can be slow; as with loading a plugin, clones
+        can only be created on the main thread.
+
+        Before rendering each clip, the plugin rendering it is reset with its
+        own ``reset`` method rather than being reloaded from scratch (as
+        :py:meth:`process` does with ``reset=True`` for most instrument plugins),
+        so instruments that keep sounding after being reset may produce sound
+        from one clip at the start of the next.
+
+        Audio buffers are processed exactly as they would be by
+        :py:meth:`pedalboard.Plugin.process_batch`; only plugins that clear their
+        internal buffers when reset can be processed on multiple threads.
+
+        *Introduced in v0.9.0.*
+        """
+    @typing.overload
+    def process_batch(
+        self,
+        input_arrays: typing.List[numpy.ndarray],
+        sample_rate: float,
+        num_workers: typing.Optional[int] = None,
+        buffer_size: int = 8192,
+    ) -> typing.List[numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]]]: ...
     def show_editor(self, close_event: typing.Optional[threading.Event] = None) -> None:
         """
         Show the UI of this plugin as a native window.
@@ -1234,6 +1729,13 @@ class AudioUnitPlugin(ExternalPlugin):
         The name of this plugin, as reported by the plugin itself.
 
 
+        """
+    @property
+    def pooled(self) -> bool:
+        """
+        Whether this plugin's instance will be returned to the instance pool (rather than being unloaded) when this object is destroyed, as set by passing ``pooled=True`` to the constructor.
+
+        *Introduced in v0.9.0.*
         """
     pass
 
@@ -1305,6 +1807,12 @@ class Resample(Plugin):
         """
         The highest quality and slowest resampling method, with no audible artifacts.
         """
+        Polyphase = 5  # fmt: skip
+        """
+        A high-quality windowed-sinc resampling method that uses a precomputed bank of filters (exact for common ratios like 44.1kHz to 48kHz or 48kHz to 16kHz) and vectorized arithmetic, making it much faster than WindowedSinc. Unlike WindowedSinc, this method filters out frequencies above the target Nyquist frequency when downsampling to avoid aliasing.
+
+        *Introduced in v0.9.0.*
+        """
     def __init__(
         self, target_sample_rate: float = 8000.0, quality: Quality = Quality.WindowedSinc
     ) -> None: ...
@@ -1336,6 +1844,7 @@ class Resample(Plugin):
     CatmullRom: pedalboard_native.Resample.Quality  # value = <Quality.CatmullRom: 2>
     Lagrange: pedalboard_native.Resample.Quality  # value = <Quality.Lagrange: 3>
     Linear: pedalboard_native.Resample.Quality  # value = <Quality.Linear: 1>
+    Polyphase: pedalboard_native.Resample.Quality  # value = <Quality.Polyphase: 5>
     WindowedSinc: pedalboard_native.Resample.Quality  # value = <Quality.WindowedSinc: 4>
     ZeroOrderHold: pedalboard_native.Resample.Quality  # value = <Quality.ZeroOrderHold: 0>
     pass
@@ -1343,6 +1852,8 @@ class Resample(Plugin):
 class Reverb(Plugin):
     """
     A simple reverb effect. Uses a simple stereo reverb algorithm, based on the technique and tunings used in `FreeVerb <https://ccrma.stanford.edu/~jos/pasp/Freeverb.html>_`.
+
+    Pass ``vectorized=True`` to use a faster, vectorized implementation of the same algorithm, which is recommended when processing long files.
     """
 
     def __init__(
@@ -1353,6 +1864,7 @@ class Reverb(Plugin):
         dry_level: float = 0.4,
         width: float = 1.0,
         freeze_mode: float = 0.0,
+        vectorized: bool = False,
     ) -> None: ...
     def __repr__(self) -> str: ...
     @property
@@ -1380,6 +1892,15 @@ class Reverb(Plugin):
     def room_size(self, arg1: float) -> None:
         pass
     @property
+    def vectorized(self) -> bool:
+        """
+        If ``True``, this reverb is processed in chunks, with all of its comb filters running side by side in SIMD lanes, which is about three times faster than the default implementation. The output is equivalent, but may differ by a tiny amount due to floating point rounding. Changes take effect the next time audio is processed, but the reverb tail is not carried over between the two implementations.
+
+        *Introduced in v0.9.0.*
+        """
+    @vectorized.setter
+    def vectorized(self, arg1: bool) -> None: ...
+    @property
     def wet_level(self) -> float:
         """ """
     @wet_level.setter
@@ -1446,9 +1967,33 @@ class VST3Plugin(ExternalPlugin):
         parameter_values: object = None,
         plugin_name: typing.Optional[str] = None,
         initialization_timeout: float = 10.0,
+        pooled: bool = False,
     ) -> None: ...
     def __repr__(self) -> str: ...
     def _get_parameter(self, arg0: str) -> _AudioProcessorParameter: ...
+    def _get_parameter_text_ranges(
+        self, name: str, search_steps: int = 1000, slow: bool = False
+    ) -> typing.List[typing.Tuple[float, float, str]]: ...
+    def _get_raw_parameter_values(self) -> typing.Dict[str, typing.Tuple[float, str]]: ...
+    def _set_raw_parameter_values(self, raw_values: typing.Dict[str, float]) -> None: ...
+    def _automate_raw(
+        self,
+        name: str,
+        raw_values: typing.Union[numpy.ndarray, typing.List[typing.Tuple[float, float]], None],
+    ) -> None: ...
+    @staticmethod
+    def clear_instance_pool() -> int:
+        """
+        Delete all idle plugin instances of this format that were created with
+        ``pooled=True`` and returned to the instance pool when their plugin objects
+        were destroyed. Returns the number of instances deleted.
+
+        Pooled instances are kept loaded (along with the global state that
+        plugins depend on) until this method is called, which happens automatically
+        at interpreter exit.
+
+        *Introduced in v0.9.0.*
+        """
     @staticmethod
     def get_plugin_names_for_file(arg0: str) -> typing.List[str]:
         """
@@ -1479,8 +2024,9 @@ class VST3Plugin(ExternalPlugin):
         itself. To receive the remaining audio, pass another audio buffer into
         ``process`` with ``reset`` set to ``True``.
 
-        If the provided buffer uses a 64-bit datatype, it will be converted to 32-bit
-        for processing.
+        If the provided buffer uses a 64-bit datatype, it will be processed and
+        returned as 64-bit audio. (Plugins that don't support 64-bit processing
+        natively will still process audio with 32-bit precision internally.)
 
         If provided MIDI messages as input, the provided ``midi_messages`` must be
         a Python ``List`` containing one of the following types:
@@ -1563,8 +2109,9 @@ class VST3Plugin(ExternalPlugin):
         itself. To receive the remaining audio, pass another audio buffer into
         ``process`` with ``reset`` set to ``True``.
 
-        If the provided buffer uses a 64-bit datatype, it will be converted to 32-bit
-        for processing.
+        If the provided buffer uses a 64-bit datatype, it will be processed and
+        returned as 64-bit audio. (Plugins that don't support 64-bit processing
+        natively will still process audio with 32-bit precision internally.)
 
         If provided MIDI messages as input, the provided ``midi_messages`` must be
         a Python ``List`` containing one of the following types:
@@ -1644,6 +2191,54 @@ class VST3Plugin(ExternalPlugin):
         buffer_size: int = 8192,
         reset: bool = True,
     ) -> numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]]: ...
+    @typing.overload
+    def process_batch(
+        self,
+        midi_clips: typing.List[object],
+        duration: typing.Union[float, typing.List[float]],
+        sample_rate: float,
+        num_channels: int = 2,
+        num_workers: typing.Optional[int] = None,
+        buffer_size: int = 8192,
+    ) -> typing.List[numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]]]:
+        """
+        Run many independent audio buffers *or* MIDI clips through this plugin,
+        returning a list of rendered buffers in the same order.
+
+        When provided MIDI clips (each a list of MIDI messages, in any of the
+        formats accepted by :py:meth:`process`), each clip is rendered into
+        ``duration`` seconds of audio. ``duration`` may be a single number, or a
+        list with one duration per clip.
+
+        Clips are spread across ``num_workers`` native threads (by default, one
+        per CPU core) without holding Python's Global Interpreter Lock. Every
+        thread other than the first renders clips through its own clone of this
+        plugin, with its state copied from this plugin (via its
+        ``getStateInformation`` and ``setStateInformation`` methods) on every call.
+        Clones are created the first time they're needed and are kept for later
+        calls, as loading a plugin can be slow; as with loading a plugin, clones
+        can only be created on the main thread.
+
+        Before rendering each clip, the plugin rendering it is reset with its
+        own ``reset`` method rather than being reloaded from scratch (as
+        :py:meth:`process` does with ``reset=True`` for most instrument plugins),
+        so instruments that keep sounding after being reset may produce sound
+        from one clip at the start of the next.
+
+        Audio buffers are processed exactly as they would be by
+        :py:meth:`pedalboard.Plugin.process_batch`; only plugins that clear their
+        internal buffers when reset can be processed on multiple threads.
+
+        *Introduced in v0.9.0.*
+        """
+    @typing.overload
+    def process_batch(
+        self,
+        input_arrays: typing.List[numpy.ndarray],
+        sample_rate: float,
+        num_workers: typing.Optional[int] = None,
+        buffer_size: int = 8192,
+    ) -> typing.List[numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]]]: ...
     def show_editor(self, close_event: typing.Optional[threading.Event] = None) -> None:
         """
         Show the UI of this plugin as a native window.
@@ -1697,6 +2292,13 @@ class VST3Plugin(ExternalPlugin):
         The name of this plugin.
 
 
+        """
+    @property
+    def pooled(self) -> bool:
+        """
+        Whether this plugin's instance will be returned to the instance pool (rather than being unloaded) when this object is destroyed, as set by passing ``pooled=True`` to the constructor.
+
+        *Introduced in v0.9.0.*
         """
     pass
 
@@ -1809,17 +2411,104 @@ class _AudioProcessorParameter:
         """
     pass
 
+class StreamingProcessor:
+    """
+    Processes a potentially-unbounded stream of audio through one or more plugins,
+    one chunk at a time, using a constant amount of memory.
+
+    Unlike calling :py:meth:`Plugin.process` repeatedly with ``reset=False``, a
+    :class:`StreamingProcessor` prepares its plugins only once per stream and
+    reuses its internal buffers between chunks. The audio returned across all
+    calls to :py:meth:`push` and :py:meth:`flush` is latency-compensated and
+    exactly as long as the audio that was pushed, just as if the entire stream had
+    been passed to :py:meth:`Plugin.process` at once.
+
+    Create one with :py:meth:`Plugin.stream`, or by passing a list of plugins::
+
+       with AudioFile("podcast.mp3") as f, AudioFile("out.wav", "w", f.samplerate, f.num_channels) as o:
+           stream = board.stream(f.samplerate, f.num_channels)
+           while f.tell() < f.frames:
+               o.write(stream.push(f.read(f.samplerate)))
+           o.write(stream.flush())
+
+    .. note::
+        The plugins used by a :class:`StreamingProcessor` should not be used to
+        process other audio until the stream has been flushed, as doing so would
+        change their internal state.
+
+    *Introduced in v0.9.0.*
+    """
+
+    def __init__(
+        self,
+        plugins: typing.List[Plugin],
+        sample_rate: float,
+        num_channels: int,
+        buffer_size: int = 8192,
+        reset: bool = True,
+    ) -> None:
+        """
+        Create a new StreamingProcessor that will run audio through the provided plugins, in order. If ``reset`` is ``True``, the plugins will be reset before the first chunk is processed.
+        """
+    def __repr__(self) -> str: ...
+    def flush(self) -> numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]]:
+        """
+        Return all of the audio that remains buffered in the plugins, such that the total amount of audio returned is the same length as the audio that was pushed. After flushing, the next call to :py:meth:`push` will start a new stream.
+        """
+    def push(self, chunk: numpy.ndarray) -> numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]]:
+        """
+        Process the provided chunk of 32-bit or 64-bit floating point audio, returning all of the output that is available so far in the same format. Fewer samples than were provided may be returned if the plugins introduce latency; the remaining audio will be returned by later calls to :py:meth:`push` or :py:meth:`flush`.
+        """
+    def reset(self) -> None:
+        """
+        Discard any buffered audio and start a new stream. The plugins will be reset when the next chunk is pushed.
+        """
+    @property
+    def buffer_size(self) -> int:
+        """
+        The maximum number of samples passed to the plugins at once.
+        """
+    @property
+    def num_channels(self) -> int:
+        """
+        The number of channels expected to be passed in every call to :py:meth:`push`.
+        """
+    @property
+    def plugins(self) -> typing.List[Plugin]:
+        """
+        The plugins that audio is processed through.
+        """
+    @property
+    def sample_rate(self) -> float:
+        """
+        The sample rate of the audio in this stream.
+        """
+    @property
+    def samples_pushed(self) -> int:
+        """
+        The number of samples (per channel) pushed into the current stream.
+        """
+    @property
+    def samples_returned(self) -> int:
+        """
+        The number of samples (per channel) returned from the current stream so far.
+        """
+    pass
+
 def process(
     input_array: numpy.ndarray,
     sample_rate: float,
     plugins: typing.List[Plugin],
     buffer_size: int = 8192,
     reset: bool = True,
+    inplace: bool = False,
+    *,
+    out: typing.Optional[numpy.ndarray] = None,
 ) -> numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]]:
     """
     Run a 32-bit or 64-bit floating point audio buffer through a
     list of Pedalboard plugins. If the provided buffer uses a 64-bit datatype,
-    it will be converted to 32-bit for processing.
+    it will be processed and returned as 64-bit audio.
 
     The provided ``buffer_size`` argument will be used to control the size of
     each chunk of audio provided into the plugins. Higher buffer sizes may speed up
@@ -1830,12 +2519,137 @@ def process(
     If calling ``process`` multiple times while processing the same audio file
     or buffer, set ``reset`` to ``False``.
 
+    If ``inplace`` is ``True``, the provided buffer will be overwritten with the
+    processed audio and returned.
+
+    If ``out`` is provided, audio will be processed in fixed-size windows and
+    written into ``out`` (see :py:meth:`Plugin.process`).
+
     :meta private:
     """
 
+def render_file(
+    input: typing.Union[str, pedalboard_native.io.ReadableAudioFile],
+    output: typing.Union[str, pedalboard_native.io.WriteableAudioFile],
+    plugin: Plugin,
+    buffer_size: int = 8192,
+    chunk_size: int = 32768,
+    queue_size: int = 4,
+    reset: bool = True,
+    bit_depth: int = 16,
+    quality: typing.Optional[typing.Union[str, float]] = None,
+) -> int:
+    """
+    Read an audio file, process it with the provided plugin (or
+    :class:`pedalboard.Pedalboard`), and write the result to another audio file.
+
+    Decoding, processing, and encoding each run on their own native thread without
+    holding Python's Global Interpreter Lock, passing chunks of ``chunk_size``
+    frames between them through queues that hold at most ``queue_size`` chunks.
+    This makes rendering a file take roughly as long as the slowest of those three
+    stages (rather than all three added together) while using a constant amount of
+    memory, regardless of the length of the file.
+
+    ``input`` may be a filename or a :class:`pedalboard.io.ReadableAudioFile`, and
+    ``output`` may be a filename or a :class:`pedalboard.io.WriteableAudioFile`. If
+    ``output`` is a filename, it will be opened with the same sample rate and number
+    of channels as the input file (plus the provided ``bit_depth`` and ``quality``)
+    and closed once rendering is complete. Files passed in as objects are not
+    closed. Reading starts from the input file's current position.
+
+    The rendered audio is latency-compensated and exactly as long as the audio that
+    was read, just as if the entire file had been passed to :py:meth:`Plugin.process`
+    at once. Returns the number of frames written.
+
+    *Introduced in v0.9.0.*
+    """
+
+def set_profiling_enabled(enabled: bool) -> None:
+    """
+    Enable or disable collection of per-plugin profiling statistics (read with
+    :py:meth:`Plugin.profile`) whenever any plugin processes audio. Profiling is
+    disabled by default, and costs almost nothing while disabled.
+
+    *Introduced in v0.9.0.*
+    """
+
+def set_realtime_audit_mode(mode: Literal["off", "count", "trap"]) -> None:
+    """
+    Enable or disable auditing of real-time safety while plugins process audio.
+    Useful for finding the source of buffer underruns (xruns) when streaming audio
+    with :class:`pedalboard.io.AudioStream`.
+
+    While enabled, every heap allocation and mutex acquisition made by
+    Pedalboard's native code while a plugin is processing audio (whether through
+    :py:meth:`Plugin.process`, a :class:`Chain`, or an
+    :class:`pedalboard.io.AudioStream`) is attributed to that plugin. ``mode`` may
+    be one of:
+
+     - ``"off"`` (the default): nothing is audited.
+     - ``"count"``: violations are counted per plugin, and can be read with
+       :py:func:`get_realtime_audit_report`.
+     - ``"trap"``: the process is aborted with a message on the first violation,
+       to allow inspecting the stack in a debugger.
+
+    .. note::
+        Auditing is only available in builds of Pedalboard compiled with the
+        ``USE_REALTIME_AUDIT=1`` environment variable set, and lock acquisitions
+        are only counted on macOS and Linux. Only allocations and locks made by
+        Pedalboard itself (including JUCE) are seen; those made inside of
+        third-party VST3 or Audio Unit plugins are not.
+
+    *Introduced in v0.9.0.*
+    """
+
+def get_realtime_audit_report(
+    plugin: Plugin, reset: bool = False
+) -> typing.Dict[Plugin, typing.Dict[str, int]]:
+    """
+    Return the number of real-time safety violations (see
+    :py:func:`set_realtime_audit_mode`) counted for the provided plugin and every
+    plugin nested within it, as a dictionary mapping each plugin with one or more
+    violations to a dictionary of ``allocations`` and ``lock_acquisitions``.
+
+    If ``reset`` is ``True``, the counts of each plugin are set back to zero.
+
+    *Introduced in v0.9.0.*
+    """
+
+def cpu_features() -> typing.Dict[str, typing.Union[bool, str, typing.List[str]]]:
+    """
+    Return a dictionary describing the SIMD instruction sets supported by this
+    CPU, and which of Pedalboard's SIMD kernels are in use.
+
+    Pedalboard's hottest inner loops (including those used by :class:`Gain`,
+    :class:`Clipping`, :class:`Bitcrush`, :class:`Convolution`, the filters used
+    by :class:`EQ` and :class:`LoudnessMeter`, polyphase resampling, and the
+    conversion of stereo audio to and from NumPy arrays) are compiled several
+    times, once for each instruction set, and the most capable set of kernels
+    supported by the CPU is chosen when Pedalboard is imported:
+
+     - ``"avx512"``: x86 CPUs with AVX-512F, AVX2, and FMA.
+     - ``"avx2"``: x86 CPUs with AVX2 and FMA.
+     - ``"sse2"``: all other 64-bit x86 CPUs.
+     - ``"neon"``: 64-bit ARM CPUs (including Apple Silicon and AWS Graviton).
+     - ``"scalar"``: any other CPU.
+
+    The returned dictionary contains a boolean for each of the instruction set
+    extensions ``sse2``, ``sse4_1``, ``avx``, ``avx2``, ``fma``, ``avx512f``, and
+    ``neon``, along with ``available_kernels`` (a list of the names of every set of
+    kernels this CPU can run) and ``kernels`` (the name of the set in use).
+
+    To use a specific set of kernels (i.e.: to compare their output or
+    performance), set the ``PEDALBOARD_SIMD`` environment variable to one of the
+    names in ``available_kernels`` before importing Pedalboard.
+
+    *Introduced in v0.9.0.*
+    """
+
 class GSMFullRateCompressor(Plugin):
     """
     An audio degradation/compression plugin that applies the GSM "Full Rate" compression algorithm to emulate the sound of a 2G cellular phone connection. This plugin internally resamples the input audio to a fixed sample rate of 8kHz (required by the GSM Full Rate codec), although the quality of the resampling algorithm can be specified.
+
+    For processing large amounts of audio, ``quality=Resample.Quality.Polyphase`` is usually several times faster than the default ``WindowedSinc`` quality, with very similar output.
     """
 
     def __init__(self, quality: Resample.Quality = Resample.Quality.WindowedSinc) -> None: ...
@@ -31,6 +31,12 @@ __all__ = [
     "AddLatency",
     "FixedSizeBlockTestPlugin",
     "ForceMonoTestPlugin",
+    "JuceChorus",
+    "JuceCompressor",
+    "JuceLimiter",
+    "JuceNoiseGate",
+    "JucePhaser",
+    "OversampledTestPlugin",
     "PrimeWithSilenceTestPlugin",
     "ResampleWithLatency",
 ]
@@ -52,6 +58,57 @@ class ForceMonoTestPlugin(pedalboard_native.Plugin):
     def __repr__(self) -> str: ...
     pass
 
+class JuceChorus(pedalboard_native.Plugin):
+    def __init__(
+        self,
+        rate_hz: float = 1.0,
+        depth: float = 0.25,
+        centre_delay_ms: float = 7.0,
+        feedback: float = 0.0,
+        mix: float = 0.5,
+    ) -> None: ...
+    pass
+
+class JuceCompressor(pedalboard_native.Plugin):
+    def __init__(
+        self,
+        threshold_db: float = 0,
+        ratio: float = 1,
+        attack_ms: float = 1.0,
+        release_ms: float = 100,
+    ) -> None: ...
+    pass
+
+class JuceLimiter(pedalboard_native.Plugin):
+    def __init__(self, threshold_db: float = -10.0, release_ms: float = 100.0) -> None: ...
+    pass
+
+class JuceNoiseGate(pedalboard_native.Plugin):
+    def __init__(
+        self,
+        threshold_db: float = -100.0,
+        ratio: float = 10,
+        attack_ms: float = 1.0,
+        release_ms: float = 100.0,
+    ) -> None: ...
+    pass
+
+class JucePhaser(pedalboard_native.Plugin):
+    def __init__(
+        self,
+        rate_hz: float = 1.0,
+        depth: float = 0.5,
+        centre_frequency_hz: float = 1300.0,
+        feedback: float = 0.0,
+        mix: float = 0.5,
+    ) -> None: ...
+    pass
+
+class OversampledTestPlugin(pedalboard_native.Plugin):
+    def __init__(self, factor: int = 2, linear_phase: bool = False) -> None: ...
+    def __repr__(self) -> str: ...
+    pass
+
 class PrimeWithSilenceTestPlugin(pedalboard_native.Plugin):
     def __init__(self, expected_silent_samples: int = 160) -> None: ...
     def __repr__(self) -> str: ...
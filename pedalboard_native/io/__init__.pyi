@@ -40,8 +40,12 @@ __all__ = [
     "ResampledReadableAudioFile",
     "StreamResampler",
     "WriteableAudioFile",
+    "get_io_statistics",
     "get_supported_read_formats",
     "get_supported_write_formats",
+    "open_cached",
+    "read_many",
+    "set_io_statistics_enabled",
 ]
 
 class AudioFile:
@@ -130,14 +134,25 @@ class AudioFile:
 
     @classmethod
     @typing.overload
-    def __new__(cls, filename: str, mode: Literal["r"] = "r") -> ReadableAudioFile:
+    def __new__(
+        cls,
+        buffer: typing.Union[bytes, bytearray, memoryview, numpy.ndarray],
+        mode: Literal["r"] = "r",
+    ) -> ReadableAudioFile:
         """
-        Open an audio file for reading.
+        Open an audio file stored in memory for reading. The provided object may be any object that supports Python's buffer protocol (i.e.: ``bytes``, ``bytearray``, ``memoryview``, or a contiguous NumPy array). Audio is decoded directly from the object's memory without copying it, and the object cannot be resized while the returned file is open.
+
+        Open an audio file for reading. If ``memory_map`` is ``True`` and the file is uncompressed (i.e.: WAV or AIFF), it will be read directly from a memory mapping rather than through a stream.
 
         Open a file-like object for reading. The provided object must have ``read``, ``seek``, ``tell``, and ``seekable`` methods, and must return binary data (i.e.: ``open(..., "w")`` or ``io.BinaryIO``, etc.).
         """
     @classmethod
     @typing.overload
+    def __new__(
+        cls, filename: str, mode: Literal["r"] = "r", *, memory_map: bool = False
+    ) -> ReadableAudioFile: ...
+    @classmethod
+    @typing.overload
     def __new__(cls, file_like: typing.BinaryIO, mode: Literal["r"] = "r") -> ReadableAudioFile: ...
     @classmethod
     @typing.overload
@@ -149,6 +164,9 @@ class AudioFile:
         num_channels: int = 1,
         bit_depth: int = 16,
         quality: typing.Optional[typing.Union[str, float]] = None,
+        *,
+        num_threads: int = 1,
+        dither: bool = False,
     ) -> WriteableAudioFile: ...
     @classmethod
     @typing.overload
@@ -161,7 +179,40 @@ class AudioFile:
         bit_depth: int = 16,
         quality: typing.Optional[typing.Union[str, float]] = None,
         format: typing.Optional[str] = None,
+        *,
+        num_threads: int = 1,
+        dither: bool = False,
     ) -> WriteableAudioFile: ...
+    def stats(self, reset: bool = False) -> typing.Dict[str, typing.Union[int, float]]:
+        """
+        Return the I/O statistics collected for this file while I/O statistics were
+        enabled (see :func:`set_io_statistics_enabled`), as a dictionary with the
+        following keys:
+
+         - ``bytes_read`` and ``bytes_written``: the number of bytes read from or
+           written to a Python file-like object (not including any files on disk or
+           buffers in memory, which are accessed directly)
+         - ``python_read_calls``, ``python_seek_calls``, ``python_tell_calls`` and
+           ``python_write_calls``: the number of calls made to each method of a
+           Python file-like object
+         - ``python_seconds``: the time spent calling methods of a Python
+           file-like object, including the time taken to acquire the GIL
+         - ``frames_decoded`` and ``decode_seconds``: the number of frames decoded
+           and the time spent decoding them
+         - ``frames_encoded`` and ``encode_seconds``: the number of frames encoded
+           and the time spent encoding (and flushing) them
+         - ``frames_resampled`` and ``resample_seconds``: the number of frames
+           produced by a :class:`ResampledReadableAudioFile`, and the time spent
+           resampling them
+
+        Decoding and encoding times include any time spent in calls to Python
+        file-like objects. A :class:`ResampledReadableAudioFile` shares its
+        statistics with the file it resamples.
+
+        If ``reset`` is ``True``, every counter is set to zero after being read.
+
+        *Introduced in v0.9.0.*
+        """
     pass
 
 class AudioStream:
@@ -202,6 +253,17 @@ class AudioStream:
         Python code; the only way to interact with the audio stream is through
         the :py:attr:`plugins` attribute.
 
+    By default, plugins are run directly in the audio device's callback, in blocks
+    of the device's buffer size. If any plugin takes too long, the device runs out
+    of audio to play, causing audible dropouts. Passing ``engine_block_size``
+    instead runs plugins on a separate high-priority thread, in blocks of exactly
+    ``engine_block_size`` samples, which exchanges audio with the device through
+    lock-free queues. ``ring_buffer_blocks`` engine blocks of audio are buffered
+    ahead of the device (at the cost of that much extra latency), which absorbs
+    occasional slow blocks; :py:attr:`underrun_count`, :py:attr:`overrun_count`
+    and :py:attr:`round_trip_latency` can be used to tune these settings.
+    *Engine mode introduced in v0.9.0.*
+
     .. warning::
         The :class:`AudioStream` class implements a context manager interface
         to ensure that audio streams are never left "dangling" (i.e.: running in
@@ -236,6 +298,9 @@ class AudioStream:
         sample_rate: typing.Optional[float] = None,
         buffer_size: int = 512,
         allow_feedback: bool = False,
+        *,
+        engine_block_size: typing.Optional[int] = None,
+        ring_buffer_blocks: int = 2,
     ) -> None: ...
     def __repr__(self) -> str: ...
     def run(self) -> None:
@@ -255,11 +320,46 @@ class AudioStream:
         The Pedalboard object that this AudioStream will use to process audio.
         """
     @property
+    def engine_block_size(self) -> typing.Optional[int]:
+        """
+        The number of samples that plugins are given at once when running on a separate engine thread, or :py:const:`None` if plugins are run directly in the audio device's callback.
+
+        *Introduced in v0.9.0.*
+        """
+    @property
+    def overrun_count(self) -> int:
+        """
+        The number of times that input audio has been dropped because the engine thread had fallen too far behind to accept it. Always 0 unless :py:attr:`engine_block_size` is set.
+
+        *Introduced in v0.9.0.*
+        """
+    @property
+    def ring_buffer_blocks(self) -> int:
+        """
+        The number of extra engine blocks of audio buffered between the engine thread and the audio device, if :py:attr:`engine_block_size` is set.
+
+        *Introduced in v0.9.0.*
+        """
+    @property
+    def round_trip_latency(self) -> float:
+        """
+        The total time (in seconds) that audio takes to get from the input device to the output device while this stream is running, as reported by the devices themselves plus any buffering added by the engine thread.
+
+        *Introduced in v0.9.0.*
+        """
+    @property
     def running(self) -> bool:
         """
         :py:const:`True` if this stream is currently streaming live audio from input to output, :py:const:`False` otherwise.
 
 
+        """
+    @property
+    def underrun_count(self) -> int:
+        """
+        The number of times that the audio device has needed more audio than the engine thread had finished processing, causing a dropout. Always 0 unless :py:attr:`engine_block_size` is set.
+
+        *Introduced in v0.9.0.*
         """
     input_device_names: typing.List[str] = []
     output_device_names: typing.List[str] = []
@@ -304,12 +404,17 @@ class ReadableAudioFile(AudioFile):
         Stop using this :class:`ReadableAudioFile` as a context manager, close the file, release its resources.
         """
     @typing.overload
-    def __init__(self, filename: str) -> None: ...
+    def __init__(self, buffer: typing.Union[bytes, bytearray, memoryview, numpy.ndarray]) -> None: ...
+    @typing.overload
+    def __init__(self, filename: str, *, memory_map: bool = False) -> None: ...
     @typing.overload
     def __init__(self, file_like: typing.BinaryIO) -> None: ...
     @classmethod
     @typing.overload
-    def __new__(cls, filename: str) -> ReadableAudioFile: ...
+    def __new__(cls, buffer: typing.Union[bytes, bytearray, memoryview, numpy.ndarray]) -> ReadableAudioFile: ...
+    @classmethod
+    @typing.overload
+    def __new__(cls, filename: str, *, memory_map: bool = False) -> ReadableAudioFile: ...
     @classmethod
     @typing.overload
     def __new__(cls, file_like: typing.BinaryIO) -> ReadableAudioFile: ...
@@ -317,9 +422,28 @@ class ReadableAudioFile(AudioFile):
     def close(self) -> None:
         """
         Close this file, rendering this object unusable.
+        """
+    def compute_exact_duration(self) -> int:
+        """
+        Find the exact number of frames in this file (without changing the current
+        read position), update :py:attr:`frames` and :py:attr:`duration` to match,
+        and return it. After this call, :py:attr:`exact_duration_known` will be
+        :py:const:`True`.
+
+        For MP3 files without a ``Xing`` or ``Info`` header, this reads only the
+        header of each MP3 frame and skips over the compressed audio in between,
+        which takes a small fraction of the time required to decode the file. If the
+        file's frame headers can't be followed to the end of the file (i.e.: if the
+        file is corrupt), or for any other file whose duration is not exactly known,
+        the entire file is decoded instead.
+
+        For all other files, this returns :py:attr:`frames` immediately.
+
+        *Introduced in v0.9.0.*
+
         """
     def read(
-        self, num_frames: typing.Union[float, int] = 0
+        self, num_frames: typing.Union[float, int] = 0, *, num_threads: int = 1
     ) -> numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]]:
         """
         Read the given number of frames (samples in each channel) from this audio file at its current position.
@@ -342,11 +466,43 @@ class ReadableAudioFile(AudioFile):
         For most (but not all) audio files, the minimum possible sample value will be ``-1.0f`` and the
         maximum sample value will be ``+1.0f``.
 
+        If this file was opened with ``memory_map=True`` and stores its samples as ``float32``
+        (as is common for uncompressed WAV files), the returned array will be a read-only view
+        directly into the file's memory mapping instead of a copy. Opening and reading such files
+        is nearly instant, and the operating system's page cache is shared between all processes
+        that read the same file. Call ``.copy()`` on the returned array to get a writeable copy.
+
+        If ``num_threads`` is greater than 1 and this file was opened by filename, long reads from
+        WAV, AIFF, and FLAC files are split into up to ``num_threads`` segments (each at least
+        262,144 frames long), which are decoded at the same time by separate readers of the same
+        file. For FLAC files, segments start on frame boundaries, so no audio is decoded twice. The
+        returned audio is identical to that returned with ``num_threads=1``. Reads from other formats
+        (or files opened from file-like objects or memory, or with :py:attr:`prefetch_frames` set)
+        ignore this argument. *Introduced in v0.9.0.*
+
         .. note::
             For convenience, the ``num_frames`` argument may be a floating-point number. However, if the
             provided number of frames contains a fractional part (i.e.: ``1.01`` instead of ``1.00``) then
             an exception will be thrown, as a fractional number of samples cannot be returned.
         """
+    def read_into(self, output: numpy.ndarray) -> int:
+        """
+        Read audio from this file at its current position directly into ``output``,
+        a preallocated, writable ``float32`` :class:`numpy.ndarray`, instead of
+        allocating a new array like :meth:`read` does. This allows reading many
+        fixed-size windows of audio without allocating memory for each one.
+
+        ``output`` may be shaped either ``(num_channels, num_frames)`` or
+        ``(num_frames, num_channels)`` (or ``(num_frames,)`` for mono audio), and may
+        be any strided view of a larger array. As many frames are read as ``output``
+        can hold.
+
+        Returns the number of frames written into ``output``, which will be smaller
+        than the number of frames ``output`` can hold only if the end of the file was
+        reached. Any remaining frames in ``output`` are left unchanged.
+
+        *Introduced in v0.9.0.*
+        """
     def read_raw(self, num_frames: typing.Union[float, int] = 0) -> numpy.ndarray:
         """
         Read the given number of frames (samples in each channel) from this audio file at its current position.
@@ -404,6 +560,13 @@ class ReadableAudioFile(AudioFile):
 
         """
     @property
+    def memory_mapped(self) -> bool:
+        """
+        True iff this file was opened with ``memory_map=True`` and is being read directly from a memory mapping. Only uncompressed formats (i.e.: WAV and AIFF) can be memory-mapped; other files opened with ``memory_map=True`` are read normally.
+
+        *Introduced in v0.9.0.*
+        """
+    @property
     def duration(self) -> float:
         """
         The duration of this file in seconds (``frames`` divided by ``samplerate``).
@@ -469,7 +632,9 @@ class ReadableAudioFile(AudioFile):
             bitrate and size. This may result in an overestimate of the file's duration
             if there is additional data present in the file after the audio stream is finished.
 
-            If the exact number of frames in the file is required, read the entire file
+            If the exact number of frames in the file is required, call
+            :meth:`compute_exact_duration`, which quickly scans the file's frame headers
+            without decoding any audio. Alternatively, read the entire file
             first before accessing the :py:attr:`frames` or :py:attr:`duration` properties.
             This operation forces each frame to be parsed and guarantees that
             :py:attr:`frames` and :py:attr:`duration` are correct, at the expense of
@@ -509,6 +674,40 @@ class ReadableAudioFile(AudioFile):
 
         """
     @property
+    def prefetch_frames(self) -> int:
+        """
+        The number of frames to decode ahead of time on a background thread, or ``0``
+        (the default) to decode audio only when :meth:`read` is called.
+
+        When reading a file sequentially in chunks, setting this to (at least) the size
+        of each chunk allows the next chunk to be decoded while the current one is being
+        processed, hiding the latency of decoding. Up to two chunks of
+        ``prefetch_frames`` frames each are kept in memory. Any prefetched audio is
+        discarded when :meth:`seek` is called.
+
+        Prefetching is not supported when reading from a Python file-like object.
+
+        *Introduced in v0.9.0.*
+
+
+        """
+    @prefetch_frames.setter
+    def prefetch_frames(self, arg1: int) -> None:
+        """
+        The number of frames to decode ahead of time on a background thread, or ``0``
+        (the default) to decode audio only when :meth:`read` is called.
+
+        When reading a file sequentially in chunks, setting this to (at least) the size
+        of each chunk allows the next chunk to be decoded while the current one is being
+        processed, hiding the latency of decoding. Up to two chunks of
+        ``prefetch_frames`` frames each are kept in memory. Any prefetched audio is
+        discarded when :meth:`seek` is called.
+
+        Prefetching is not supported when reading from a Python file-like object.
+
+        *Introduced in v0.9.0.*
+        """
+    @property
     def samplerate(self) -> typing.Union[float, int]:
         """
         The sample rate of this file in samples (per channel) per second (Hz). Sample rates are represented as floating-point numbers by default, but this property will be an integer if the file's sample rate has no fractional part.
@@ -541,10 +740,21 @@ class ResampledReadableAudioFile(AudioFile):
     Under the hood, :class:`ResampledReadableAudioFile` uses a stateful
     :class:`StreamResampler` instance, which uses a constant amount of
     memory to resample potentially-unbounded streams of audio. The audio
-    output by :class:`ResampledReadableAudioFile` will always be identical
-    to the result obtained by passing the entire audio file through a
-    :class:`StreamResampler`, with the added benefits of allowing chunked
-    reads, seeking through files, and using a constant amount of memory.
+    output by :class:`ResampledReadableAudioFile` will be identical to the
+    result obtained by passing the entire audio file through a
+    :class:`StreamResampler` (except for some MP3 files, as noted below),
+    with the added benefits of allowing chunked reads, seeking through
+    files, and using a constant amount of memory.
+
+    .. note::
+        When reading an MP3 file from disk at a sample rate of at most half (or
+        a quarter) of its native sample rate, the file is decoded directly at that
+        reduced rate by skipping the synthesis of its upper frequency bands, and
+        only the remaining difference is resampled. This is much faster than
+        decoding the entire file at its native rate, but may produce very slightly
+        different output near the target Nyquist frequency.
+
+        *Introduced in v0.9.0.*
     """
 
     def __enter__(self) -> ResampledReadableAudioFile:
@@ -604,6 +814,24 @@ class ResampledReadableAudioFile(AudioFile):
             provided number of frames contains a fractional part (i.e.: ``1.01`` instead of ``1.00``) then
             an exception will be thrown, as a fractional number of samples cannot be returned.
         """
+    def read_into(self, output: numpy.ndarray) -> int:
+        """
+        Read audio from this file at its current position directly into ``output``,
+        a preallocated, writable ``float32`` :class:`numpy.ndarray`, instead of
+        allocating a new array like :meth:`read` does. This allows reading many
+        fixed-size windows of audio without allocating memory for each one.
+
+        ``output`` may be shaped either ``(num_channels, num_frames)`` or
+        ``(num_frames, num_channels)`` (or ``(num_frames,)`` for mono audio), and may
+        be any strided view of a larger array. As many frames are read as ``output``
+        can hold (at the target sample rate).
+
+        Returns the number of frames written into ``output``, which will be smaller
+        than the number of frames ``output`` can hold only if the end of the file was
+        reached. Any remaining frames in ``output`` are left unchanged.
+
+        *Introduced in v0.9.0.*
+        """
     def seek(self, position: int) -> None:
         """
         Seek this file to the provided location in frames at the target sample rate. Future reads will start from this position.
@@ -698,6 +926,40 @@ class ResampledReadableAudioFile(AudioFile):
 
         """
     @property
+    def prefetch_frames(self) -> int:
+        """
+        The number of frames to decode and resample ahead of time on a background
+        thread, or ``0`` (the default) to do so only when :meth:`read` is called.
+
+        When reading a file sequentially in chunks, setting this to (at least) the size
+        of each chunk allows the next chunk to be decoded and resampled while the
+        current one is being processed. Up to two chunks of ``prefetch_frames`` frames
+        each are kept in memory. Any prefetched audio is discarded when :meth:`seek` is
+        called.
+
+        Prefetching is not supported when reading from a Python file-like object.
+
+        *Introduced in v0.9.0.*
+
+
+        """
+    @prefetch_frames.setter
+    def prefetch_frames(self, arg1: int) -> None:
+        """
+        The number of frames to decode and resample ahead of time on a background
+        thread, or ``0`` (the default) to do so only when :meth:`read` is called.
+
+        When reading a file sequentially in chunks, setting this to (at least) the size
+        of each chunk allows the next chunk to be decoded and resampled while the
+        current one is being processed. Up to two chunks of ``prefetch_frames`` frames
+        each are kept in memory. Any prefetched audio is discarded when :meth:`seek` is
+        called.
+
+        Prefetching is not supported when reading from a Python file-like object.
+
+        *Introduced in v0.9.0.*
+        """
+    @property
     def resampling_quality(self) -> pedalboard_native.Resample.Quality:
         """
         The resampling algorithm used to resample from the original file's sample rate to the ``target_sample_rate``.
@@ -738,6 +1000,35 @@ class StreamResampler:
     ) -> numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]]:
         """
         Resample a 32-bit floating-point audio buffer. The returned buffer may be smaller than the provided buffer depending on the quality method used. Call :meth:`process()` without any arguments to flush the internal buffers and return all remaining audio.
+
+        A PyTorch (or other DLPack-compatible) tensor in CPU memory may be passed instead of a NumPy array, in which case a tensor of the same type is returned.
+        """
+    def process_into(
+        self,
+        input: typing.Optional[numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]]],
+        output: numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]],
+    ) -> typing.Tuple[int, int]:
+        """
+        Resample a 32-bit floating-point audio buffer, writing the resampled audio
+        directly into the provided ``output`` array rather than allocating a new one.
+        This allows long streams to be resampled without allocating any memory after
+        the first call, and without copying any audio more than once.
+
+        ``input`` may be shaped either ``(num_channels, num_frames)`` or
+        ``(num_frames, num_channels)``, and may be any (strided) view of a ``float32``
+        array. ``output`` must be a writable ``float32`` array of shape
+        ``(num_channels, num_frames)`` (or ``(num_frames,)`` for mono audio).
+
+        Returns a tuple of ``(input_frames_consumed, output_frames_written)``. The
+        resampler buffers only a small, fixed amount of input, so if ``output`` is too
+        small to hold all of the resampled audio, fewer than all of the input frames
+        may be consumed; the remaining frames should be passed to the next call.
+
+        To flush the resampler's internal buffers, pass ``None`` as ``input`` and call
+        :meth:`process_into` repeatedly until it writes fewer frames than fit into
+        ``output``.
+
+        *Introduced in v0.9.0.*
         """
     def reset(self) -> None:
         """
@@ -819,6 +1110,27 @@ class WriteableAudioFile(AudioFile):
             may be passed as a string. The strings ``"best"``, ``"worst"``,
             ``"fastest"``, and ``"slowest"`` will also work for any codec.
 
+        num_threads:
+            The number of threads to use when encoding audio. Only FLAC files
+            currently support encoding on multiple threads; other formats will
+            always be encoded on a single thread. Audio is encoded in segments of
+            a few seconds each, so multiple threads only help when writing more
+            than a few seconds of audio at a time. Files written with more than
+            one thread are valid FLAC files with the same audio content, but may
+            not be byte-for-byte identical to files encoded on one thread.
+
+            *Introduced in v0.9.0.*
+
+        dither:
+            If ``True``, add triangular (TPDF) dither when converting floating-point
+            audio to a lower integer bit depth (i.e.: writing float32 audio to a
+            16-bit WAV file), rounding each sample to the nearest integer value
+            instead of truncating it. This trades a small amount of noise for the
+            removal of quantization distortion on quiet signals. Has no effect on
+            integer input audio or on formats that store floating-point samples.
+
+            *Introduced in v0.9.0.*
+
     .. note::
         You probably don't want to use this class directly: all of the parameters
         accepted by the :class:`WriteableAudioFile` constructor will be accepted by
@@ -836,6 +1148,9 @@ class WriteableAudioFile(AudioFile):
         num_channels: int = 1,
         bit_depth: int = 16,
         quality: typing.Optional[typing.Union[str, float]] = None,
+        *,
+        num_threads: int = 1,
+        dither: bool = False,
     ) -> None: ...
     @typing.overload
     def __init__(
@@ -846,6 +1161,9 @@ class WriteableAudioFile(AudioFile):
         bit_depth: int = 16,
         quality: typing.Optional[typing.Union[str, float]] = None,
         format: typing.Optional[str] = None,
+        *,
+        num_threads: int = 1,
+        dither: bool = False,
     ) -> None: ...
     @classmethod
     @typing.overload
@@ -856,6 +1174,9 @@ class WriteableAudioFile(AudioFile):
         num_channels: int = 1,
         bit_depth: int = 16,
         quality: typing.Optional[typing.Union[str, float]] = None,
+        *,
+        num_threads: int = 1,
+        dither: bool = False,
     ) -> WriteableAudioFile: ...
     @classmethod
     @typing.overload
@@ -867,6 +1188,9 @@ class WriteableAudioFile(AudioFile):
         bit_depth: int = 16,
         quality: typing.Optional[typing.Union[str, float]] = None,
         format: typing.Optional[str] = None,
+        *,
+        num_threads: int = 1,
+        dither: bool = False,
     ) -> WriteableAudioFile: ...
     def __repr__(self) -> str: ...
     def close(self) -> None:
@@ -886,6 +1210,8 @@ class WriteableAudioFile(AudioFile):
         Encode an array of audio data and write it to this file. The number of channels in the array must match the number of channels used to open the file. The array may contain audio in any shape. If the file's bit depth or format does not match the provided data type, the audio will be automatically converted.
 
         Arrays of type int8, int16, int32, float32, and float64 are supported. If an array of an unsupported ``dtype`` is provided, a ``TypeError`` will be raised.
+
+        PyTorch (or other DLPack-compatible) tensors in CPU memory may also be written directly, without first being copied into a NumPy array.
         """
     @property
     def closed(self) -> bool:
@@ -933,8 +1259,94 @@ class WriteableAudioFile(AudioFile):
         """
     pass
 
+def get_io_statistics(
+    reset: bool = False,
+) -> typing.Dict[str, typing.Dict[str, typing.Union[int, float]]]:
+    """
+    Return the I/O statistics collected from every audio file opened by this
+    process while I/O statistics were enabled (see
+    :func:`set_io_statistics_enabled`), as a dictionary mapping the name of each
+    audio format (i.e.: ``"WAV file"``) to a dictionary with the same keys as
+    :py:meth:`AudioFile.stats`, ready to be exported to a metrics system. If
+    ``reset`` is ``True``, all totals are set to zero after being read.
+
+    *Introduced in v0.9.0.*
+    """
+
 def get_supported_read_formats() -> typing.List[str]:
     pass
 
 def get_supported_write_formats() -> typing.List[str]:
     pass
+
+def open_cached(
+    filename: str,
+    cache_dir: str,
+    target_sample_rate: typing.Optional[float] = None,
+    quality: pedalboard_native.Resample.Quality = pedalboard_native.Resample.Quality.WindowedSinc,
+    memory_map: bool = True,
+) -> ReadableAudioFile:
+    """
+    Open an audio file through a persistent cache of decoded audio stored in
+    ``cache_dir``, returning a :class:`ReadableAudioFile`.
+
+    The first time a file is opened, its entire contents are decoded (and
+    resampled to ``target_sample_rate``, if provided and different from the file's
+    own sample rate) and stored in ``cache_dir`` as an uncompressed 32-bit
+    floating-point WAV file. Later calls with the same arguments skip decoding and
+    resampling entirely, and (with ``memory_map=True``, the default) read audio
+    directly from the memory-mapped cache file without copying it.
+
+    Cache entries are keyed by the file's path, size, and modification time (and
+    the target sample rate and resampling quality), so modifying a file will cause
+    it to be decoded again. Cache entries are never deleted by Pedalboard; the
+    cache directory may be cleared at any time when no files are being opened.
+
+    .. note::
+        The returned :class:`ReadableAudioFile` reads from the cache file, so its
+        :py:attr:`name` will point into ``cache_dir``, and its
+        :py:attr:`file_dtype` will always be ``"float32"``.
+
+    *Introduced in v0.9.0.*
+    """
+
+def read_many(
+    filenames: typing.List[str],
+    offsets: typing.Optional[typing.List[int]] = None,
+    num_frames: typing.Union[int, typing.List[int], None] = None,
+    num_workers: typing.Optional[int] = None,
+    pad: bool = False,
+) -> typing.Union[
+    typing.List[numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]]],
+    numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]],
+]:
+    """
+    Read many audio files at once, decoding them in parallel on a pool of native
+    threads without holding Python's Global Interpreter Lock. This is much faster
+    than opening each file with :class:`AudioFile` in a loop, especially when
+    reading many short files (i.e.: in a data loader).
+
+    ``offsets`` may contain the frame to start reading from in each file (by
+    default, the start of the file), and ``num_frames`` may be either a single
+    number of frames to read from every file or one number per file. If
+    ``num_frames`` is not provided, each file is read until its end; files that end
+    before ``num_frames`` will return fewer frames.
+
+    By default, a list of ``float32`` arrays (each with shape
+    ``(num_channels, num_frames)``, just like :py:meth:`ReadableAudioFile.read`)
+    is returned in the same order as ``filenames``. If ``pad`` is ``True``, a single
+    array of shape ``(num_files, max_num_channels, max_num_frames)`` is returned
+    instead, with shorter files (or files with fewer channels) padded with silence.
+
+    *Introduced in v0.9.0.*
+    """
+
+def set_io_statistics_enabled(enabled: bool) -> None:
+    """
+    Enable or disable collection of I/O statistics (read with
+    :py:meth:`AudioFile.stats` or :func:`get_io_statistics`) whenever audio files
+    are read, written, or resampled. I/O statistics are disabled by default, and
+    cost almost nothing while disabled.
+
+    *Introduced in v0.9.0.*
+    """
@@ -27,33 +27,216 @@ from enum import Enum
 import threading
 import numpy
 import pedalboard_native
+import pedalboard_native.io
 
 _Shape = typing.Tuple[int, ...]
 
-__all__ = ["Chain", "Mix", "time_stretch"]
+__all__ = ["Chain", "FrozenChain", "MelSpectrogram", "Mix", "stft", "time_stretch"]
 
 class Chain(pedalboard_native.PluginContainer, pedalboard_native.Plugin):
     """
     Run zero or more plugins as a plugin. Useful when used with the Mix plugin.
+
+    If ``fused`` is ``True``, each run of two or more consecutive sample-wise plugins (:class:`Gain`, :class:`Invert`, :class:`Clipping`, :class:`Bitcrush`, :class:`Compressor`, :class:`Limiter`, and IIR filters like :class:`HighpassFilter`) is run over small tiles of audio one plugin after the other, rather than each plugin processing the whole buffer in turn. This keeps audio in the CPU's cache between plugins, which can speed up long chains of cheap plugins. The output is equivalent, although IIR filters may differ by a tiny amount (below -140dB), as their state is rounded differently at block boundaries.
+
+    If ``pipelined`` is ``True``, each plugin in this Chain (or each run of consecutive sample-wise plugins) runs on its own thread when rendering an entire buffer at once (i.e.: when calling :py:meth:`process` with ``reset=True``), working on one block of audio while the next plugin works on the previous block. This can speed up long renders through chains of several expensive plugins (like :class:`Convolution`, :class:`PitchShift`, or VST3 plugins) by up to the number of plugins in the chain, and produces the same output. Plugins in the chain are still only ever called from one thread at a time.
     """
 
     @typing.overload
-    def __init__(self, plugins: typing.List[pedalboard_native.Plugin]) -> None: ...
+    def __init__(
+        self,
+        plugins: typing.List[pedalboard_native.Plugin],
+        fused: bool = False,
+        pipelined: bool = False,
+    ) -> None: ...
     @typing.overload
     def __repr__(self) -> str: ...
+    def freeze(self) -> FrozenChain:
+        """
+        Return a :class:`FrozenChain` containing the same plugins as this chain, which processes audio with much less overhead per block. Raises a ``ValueError`` if this chain contains any plugins that can't be frozen.
+
+        *Introduced in v0.9.0.*
+        """
+    @property
+    def fused(self) -> bool:
+        """
+        If ``True``, runs of consecutive sample-wise plugins in this Chain are processed together, over small tiles of audio that stay in the CPU's cache. Changes take effect the next time audio is processed.
+
+        *Introduced in v0.9.0.*
+        """
+    @fused.setter
+    def fused(self, arg1: bool) -> None: ...
+    @property
+    def pipelined(self) -> bool:
+        """
+        If ``True``, the plugins in this Chain each run on their own thread (passing blocks of audio from one to the next) when rendering an entire buffer at once. Changes take effect the next time audio is processed.
+
+        *Introduced in v0.9.0.*
+        """
+    @pipelined.setter
+    def pipelined(self, arg1: bool) -> None: ...
+    pass
+
+class FrozenChain(pedalboard_native.PluginContainer, pedalboard_native.Plugin):
+    """
+    A version of :class:`Chain` that can only contain sample-wise built-in plugins (:class:`Gain`, :class:`Invert`, :class:`Clipping`, :class:`Bitcrush`, :class:`Compressor`, :class:`Limiter`, and IIR filters like :class:`HighpassFilter`), but that calls each of them directly on every block of audio rather than through Pedalboard's general-purpose processing loop. This makes processing much faster when using small buffer sizes (i.e.: in an :class:`pedalboard.io.AudioStream`) and produces identical output.
+
+    Usually created with :py:meth:`Chain.freeze`. The plugins in a FrozenChain aren't copied, and can still be changed (i.e.: by setting their parameters) while frozen.
+
+    .. note::
+        :py:meth:`Plugin.profile` reports only the total time taken by a FrozenChain, not the time taken by each of its plugins.
+
+    *Introduced in v0.9.0.*
+    """
+
+    def __init__(self, plugins: typing.List[pedalboard_native.Plugin]) -> None: ...
+    def __repr__(self) -> str: ...
+    pass
+
+class MelSpectrogram:
+    """
+    Computes mel-scaled spectrograms of audio buffers or audio files, with the same
+    conventions (and default parameters) as ``librosa.feature.melspectrogram``.
+
+    Each frame's magnitude spectrum (raised to ``power``) is weighted by a bank of
+    ``n_mels`` triangular filters, evenly spaced on the mel scale between ``f_min``
+    and ``f_max`` (which defaults to half of ``sample_rate``). As in librosa, the
+    mel scale and filter normalization follow Slaney's Auditory Toolbox.
+
+    See :func:`stft` for a description of the other parameters.
+
+    *Introduced in v0.9.0.*
+    """
+
+    def __call__(
+        self,
+        input: typing.Union[
+            pedalboard_native.io.ReadableAudioFile,
+            pedalboard_native.io.ResampledReadableAudioFile,
+            numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]],
+        ],
+    ) -> numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]]:
+        """
+        Compute the mel spectrogram of ``input``, which may be a ``float32``
+        :class:`numpy.ndarray` of audio or a :class:`pedalboard.io.ReadableAudioFile`
+        (or resampled file) to be read from its current position to its end.
+
+        Returns a ``float32`` :class:`numpy.ndarray` with the shape
+        ``(n_mels, num_frames)`` for 1D input, or ``(num_channels, n_mels, num_frames)``
+        for 2D input or audio files.
+        """
+    def __init__(
+        self,
+        sample_rate: float,
+        n_fft: int = 2048,
+        hop_length: typing.Optional[int] = None,
+        n_mels: int = 128,
+        f_min: float = 0.0,
+        f_max: typing.Optional[float] = None,
+        power: float = 2.0,
+        window: str = "hann",
+        center: bool = True,
+    ) -> None: ...
+    def __repr__(self) -> str: ...
+    @property
+    def center(self) -> bool:
+        """ """
+    @property
+    def f_max(self) -> float:
+        """ """
+    @property
+    def f_min(self) -> float:
+        """ """
+    @property
+    def hop_length(self) -> int:
+        """ """
+    @property
+    def n_fft(self) -> int:
+        """ """
+    @property
+    def n_mels(self) -> int:
+        """ """
+    @property
+    def power(self) -> float:
+        """ """
+    @property
+    def sample_rate(self) -> float:
+        """ """
+    @property
+    def window(self) -> str:
+        """ """
     pass
 
 class Mix(pedalboard_native.PluginContainer, pedalboard_native.Plugin):
     """
     A utility plugin that allows running other plugins in parallel. All plugins provided will be mixed equally.
+
+    If ``parallel`` is ``True``, each plugin will be run on its own thread (from a pool of threads owned by this Mix) rather than one after another. This can speed up processing when each plugin does a lot of work (i.e.: when each is a Chain of several effects), and produces exactly the same output as processing each plugin in turn.
     """
 
     @typing.overload
-    def __init__(self, plugins: typing.List[pedalboard_native.Plugin]) -> None: ...
+    def __init__(
+        self, plugins: typing.List[pedalboard_native.Plugin], parallel: bool = False
+    ) -> None: ...
     @typing.overload
     def __repr__(self) -> str: ...
+    @property
+    def parallel(self) -> bool:
+        """
+        If ``True``, each plugin in this Mix will be run concurrently on its own thread. Changes take effect the next time audio is processed.
+
+        *Introduced in v0.9.0.*
+        """
+    @parallel.setter
+    def parallel(self, arg1: bool) -> None:
+        """
+        If ``True``, each plugin in this Mix will be run concurrently on its own thread. Changes take effect the next time audio is processed.
+
+        *Introduced in v0.9.0.*
+        """
     pass
 
+def stft(
+    input: typing.Union[
+        pedalboard_native.io.ReadableAudioFile,
+        pedalboard_native.io.ResampledReadableAudioFile,
+        numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]],
+    ],
+    n_fft: int = 2048,
+    hop_length: typing.Optional[int] = None,
+    window: str = "hann",
+    center: bool = True,
+) -> numpy.ndarray[typing.Any, numpy.dtype[numpy.complex64]]:
+    """
+    Compute the short-time Fourier transform (STFT) of a buffer of audio, or of an
+    audio file, returning a complex-valued :class:`numpy.ndarray` of frequency bins
+    per frame.
+
+    ``input`` may be a ``float32`` :class:`numpy.ndarray` of audio, or a
+    :class:`pedalboard.io.ReadableAudioFile` (or resampled file) to be read from its
+    current position to its end. When passed a file, its audio is decoded and
+    transformed a few frames at a time, without ever holding the entire file in
+    memory and without holding Python's Global Interpreter Lock.
+
+    The returned array has the shape ``(1 + n_fft // 2, num_frames)`` for 1D input,
+    or ``(num_channels, 1 + n_fft // 2, num_frames)`` for 2D input or audio files.
+    The transform follows the same conventions as ``librosa.stft``:
+
+     - ``n_fft`` is the size of each frame (and must be a power of 2).
+     - ``hop_length`` is the number of samples between the starts of consecutive
+       frames, and defaults to ``n_fft // 4``.
+     - ``window`` is the name of a periodic window function to apply to each
+       frame: one of ``"hann"`` (the default), ``"hamming"``, ``"blackman"``,
+       or ``"boxcar"``.
+     - If ``center`` is ``True`` (the default), the audio is padded with
+       ``n_fft // 2`` zeros on either side, so that frame ``t`` is centered on
+       sample ``t * hop_length``.
+
+    FFT plans are created once per size and reused across calls.
+
+    *Introduced in v0.9.0.*
+    """
+
 def time_stretch(
     input_audio: numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]],
     samplerate: float,
@@ -66,6 +249,9 @@ def time_stretch(
     use_long_fft_window: typing.Optional[bool] = None,
     use_time_domain_smoothing: bool = False,
     preserve_formants: bool = True,
+    streaming: bool = False,
+    independent_channels: bool = False,
+    num_workers: typing.Optional[int] = 1,
 ) -> numpy.ndarray[typing.Any, numpy.dtype[numpy.float32]]:
     """
     Time-stretch (and optionally pitch-shift) a buffer of audio, changing its length.
@@ -110,6 +296,24 @@ def time_stretch(
       - ``preserve_formants`` allows shifting the pitch of notes without substantially
         affecting the pitch profile (formants) of a voice or instrument.
 
+      - ``streaming`` uses Rubber Band's real-time engine, which processes the audio
+        in small chunks rather than studying the entire buffer first. This uses less
+        memory for long inputs (and returns the same number of samples), but may
+        sound slightly different. *Introduced in v0.9.0.*
+
+      - ``independent_channels`` stretches each channel separately, rather than
+        keeping the channels in phase with each other. This may sound better for
+        inputs whose channels are unrelated (e.g.: different instruments), and
+        allows each channel to be stretched on its own thread. *Introduced in v0.9.0.*
+
+      - ``num_workers`` controls how many native threads are used (or, if
+        ``None``, one per CPU core). With more than one worker, inputs longer than
+        about 20 seconds are split into overlapping segments (at the quietest
+        point near each split, to avoid splitting transients), which are stretched
+        in parallel and crossfaded back together. The output may differ very
+        slightly around each join from stretching the input all at once, which is
+        what the default of ``num_workers=1`` does. *Introduced in v0.9.0.*
+
     .. warning::
         This is a function, not a :py:class:`Plugin` instance, and cannot be
         used in :py:class:`Pedalboard` objects, as it changes the duration of
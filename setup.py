@@ -169,6 +169,14 @@ elif bool(int(os.environ.get("USE_MSAN", 0))):
     ALL_CPPFLAGS += ["-fsanitize=memory", "-fsanitize-memory-track-origins"]
     ALL_LINK_ARGS += ["-fsanitize=memory"]
 
+if bool(int(os.environ.get("USE_REALTIME_AUDIT", 0))):
+    # Allow counting heap allocations and lock acquisitions made while processing
+    # audio (see pedalboard/RealtimeAudit.cpp):
+    ALL_CPPFLAGS += ["-DPEDALBOARD_REALTIME_AUDIT=1"]
+    if platform.system() == "Linux":
+        hooked_symbols = ["malloc", "calloc", "realloc", "pthread_mutex_lock", "_Znwm", "_Znam"]
+        ALL_LINK_ARGS += ["-Wl," + ",".join("--wrap=" + symbol for symbol in hooked_symbols)]
+
 
 # Regardless of platform, allow our compiler to compile .mm files as Objective-C (required on MacOS)
 UnixCCompiler.src_extensions.append(".mm")
@@ -73,3 +73,47 @@ def test_create_stream(input_device_name: str, output_device_name: str):
 def test_create_stream_fails_on_linux():
     with pytest.raises(RuntimeError):
         pedalboard.io.AudioStream("input", "output")
+
+
+@pytest.mark.parametrize("input_device_name", INPUT_DEVICE_NAMES[:1])
+@pytest.mark.parametrize("output_device_name", pedalboard.io.AudioStream.output_device_names[:1])
+@pytest.mark.parametrize("engine_block_size", [64, 1024])
+@pytest.mark.skipif(platform.system() == "Linux", reason="AudioStream not supported on Linux yet.")
+def test_stream_with_engine_thread(
+    input_device_name: str, output_device_name: str, engine_block_size: int
+):
+    try:
+        stream = pedalboard.io.AudioStream(
+            input_device_name,
+            output_device_name,
+            allow_feedback=True,
+            engine_block_size=engine_block_size,
+            ring_buffer_blocks=3,
+        )
+    except Exception as e:
+        if any(substr in str(e) for substr in ACCEPTABLE_ERRORS_ON_CI):
+            return
+        raise
+
+    assert stream.engine_block_size == engine_block_size
+    assert stream.ring_buffer_blocks == 3
+    assert f"engine_block_size={engine_block_size}" in repr(stream)
+    with stream:
+        stream.plugins.append(pedalboard.Gain(gain_db=-120))
+        time.sleep(0.25)
+        assert stream.running
+
+        # At least the engine thread's buffering should be reported:
+        sample_rate = float(repr(stream).split("sample_rate=")[1].split(" ")[0])
+        assert stream.round_trip_latency >= (3 * engine_block_size) / sample_rate
+        assert stream.underrun_count >= 0
+        assert stream.overrun_count >= 0
+    assert not stream.running
+
+
+@pytest.mark.parametrize(
+    "kwargs", [{"engine_block_size": 0}, {"engine_block_size": 512, "ring_buffer_blocks": 0}]
+)
+def test_stream_rejects_invalid_engine_settings(kwargs):
+    with pytest.raises(ValueError):
+        pedalboard.io.AudioStream("input", "output", **kwargs)
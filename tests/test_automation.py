@@ -0,0 +1,145 @@
+#! /usr/bin/env python
+#
+# Copyright 2023 Spotify AB
+#
+# Licensed under the GNU Public License, Version 3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import numpy as np
+import pytest
+
+from pedalboard import Delay, Gain, LowpassFilter, Pedalboard, Reverb
+
+
+SAMPLE_RATE = 44100
+NUM_SAMPLES = SAMPLE_RATE
+
+
+def expected_gain_sweep(gain_db: np.ndarray, interval: int) -> np.ndarray:
+    # Each parameter update holds for `interval` samples:
+    held = gain_db[(np.arange(len(gain_db)) // interval) * interval]
+    return np.power(10.0, held / 20.0).astype(np.float32)
+
+
+@pytest.mark.parametrize("interval", [1, 32, 100])
+def test_per_sample_automation(interval: int):
+    gain_db = np.linspace(-30, 6, NUM_SAMPLES)
+    plugin = Gain()
+    plugin.automation_interval = interval
+    plugin.automate("gain_db", gain_db)
+
+    output = plugin.process(np.ones(NUM_SAMPLES, dtype=np.float32), SAMPLE_RATE)
+    np.testing.assert_allclose(output, expected_gain_sweep(gain_db, interval), rtol=1e-4)
+
+
+@pytest.mark.parametrize("buffer_size", [1, 100, 8192, NUM_SAMPLES])
+def test_automation_is_independent_of_buffer_size(buffer_size: int):
+    noise = np.random.default_rng(0).uniform(-1, 1, size=(2, NUM_SAMPLES)).astype(np.float32)
+
+    def render(buffer_size: int) -> np.ndarray:
+        board = Pedalboard([LowpassFilter(), Delay(delay_seconds=0.01, mix=0.5)])
+        board[0].automate("cutoff_frequency_hz", [(0, 200), (0.5, 8000)])
+        board[1].automate("feedback", [(0, 0), (1, 0.9)])
+        return board.process(noise, SAMPLE_RATE, buffer_size=buffer_size)
+
+    np.testing.assert_allclose(render(buffer_size), render(512), atol=1e-6)
+
+
+def test_breakpoints_are_interpolated_and_held():
+    plugin = Gain()
+    plugin.automation_interval = 1
+    plugin.automate("gain_db", [(0.25, -20), (0.75, 0)])
+
+    output = plugin.process(np.ones(NUM_SAMPLES, dtype=np.float32), SAMPLE_RATE)
+    times = np.arange(NUM_SAMPLES) / SAMPLE_RATE
+    expected_db = np.interp(times, [0.25, 0.75], [-20, 0])
+    np.testing.assert_allclose(output, np.power(10.0, expected_db / 20.0), rtol=1e-4)
+
+
+def test_automation_continues_until_reset():
+    gain_db = np.linspace(-30, 0, NUM_SAMPLES)
+    plugin = Gain()
+    plugin.automate("gain_db", gain_db)
+    expected = expected_gain_sweep(gain_db, plugin.automation_interval)
+
+    ones = np.ones(NUM_SAMPLES // 2, dtype=np.float32)
+    first_half = plugin.process(ones, SAMPLE_RATE, reset=True)
+    second_half = plugin.process(ones, SAMPLE_RATE, reset=False)
+    np.testing.assert_allclose(np.concatenate([first_half, second_half]), expected, rtol=1e-4)
+
+    # Resetting starts the curve from the beginning again:
+    np.testing.assert_allclose(
+        plugin.process(ones, SAMPLE_RATE), expected[: NUM_SAMPLES // 2], rtol=1e-4
+    )
+
+
+def test_automated_parameters():
+    plugin = LowpassFilter()
+    assert plugin.automated_parameters == []
+
+    plugin.automate("cutoff_frequency_hz", [(0, 200), (1, 8000)])
+    assert plugin.automated_parameters == ["cutoff_frequency_hz"]
+
+    plugin.automate("cutoff_frequency_hz", None)
+    assert plugin.automated_parameters == []
+
+
+def test_clearing_automation_keeps_most_recent_value():
+    plugin = Gain()
+    plugin.automate("gain_db", [(0, -12), (0.1, -6)])
+    plugin.process(np.ones(NUM_SAMPLES, dtype=np.float32), SAMPLE_RATE)
+    assert plugin.gain_db == pytest.approx(-6)
+
+    plugin.clear_automation()
+    output = plugin.process(np.ones(NUM_SAMPLES, dtype=np.float32), SAMPLE_RATE)
+    np.testing.assert_allclose(output, np.power(10.0, -6 / 20.0), rtol=1e-4)
+
+    plugin.automate("gain_db", [(0, -12)])
+    plugin.automate("gain_db", None)
+    assert plugin.gain_db == pytest.approx(-6)
+
+
+def test_process_batch_with_automation():
+    gain_db = np.linspace(-30, 0, NUM_SAMPLES)
+    plugin = Gain()
+    plugin.automate("gain_db", gain_db)
+    expected = expected_gain_sweep(gain_db, plugin.automation_interval)
+
+    inputs = [np.ones(NUM_SAMPLES, dtype=np.float32) for _ in range(4)]
+    for output in plugin.process_batch(inputs, SAMPLE_RATE, num_workers=4):
+        np.testing.assert_allclose(output, expected, rtol=1e-4)
+
+
+def test_invalid_automation():
+    plugin = Reverb()
+    with pytest.raises(ValueError, match="room_size"):
+        plugin.automate("not_a_parameter", [(0, 1)])
+
+    # Values outside of the parameter's range are rejected up front:
+    original_room_size = plugin.room_size
+    with pytest.raises(ValueError):
+        plugin.automate("room_size", [(0, 0.5), (1, 2.0)])
+    assert plugin.room_size == original_room_size
+
+    with pytest.raises(ValueError):
+        plugin.automate("room_size", [(1, 0.5), (0, 0.5)])
+    with pytest.raises(ValueError):
+        plugin.automate("room_size", np.zeros((2, 10)))
+    with pytest.raises(ValueError):
+        plugin.automate("room_size", np.array([], dtype=np.float32))
+    with pytest.raises(ValueError):
+        plugin.automate("room_size", np.array([0.5, np.nan]))
+    with pytest.raises(TypeError):
+        plugin.automate("room_size", "loud")
+    with pytest.raises(ValueError):
+        plugin.automation_interval = 0
@@ -15,13 +15,25 @@
 # limitations under the License.
 
 
+import os
+import subprocess
+import sys
 import time
+import tracemalloc
 
 import pytest
 import numpy as np
 
 import sox
 import pedalboard
+from pedalboard.io import AudioFile, StreamResampler, get_supported_write_formats
+from pedalboard_native._internal import (
+    JuceChorus,
+    JuceCompressor,
+    JuceLimiter,
+    JuceNoiseGate,
+    JucePhaser,
+)
 
 
 class timer(object):
@@ -69,3 +81,389 @@ def test_pysox_performance_difference():
     # This test ensures we're at least 100x faster to account for
     # variations across test run environments.
     assert average_pysox_time / average_pedalboard_time > 100
+
+
+@pytest.mark.skip
+@pytest.mark.parametrize("num_channels", [2, 6, 8])
+def test_interleaving_overhead(num_channels: int):
+    # Processing interleaved audio requires de-interleaving it on input and
+    # re-interleaving it on output. With vectorized (de-)interleaving, that
+    # should only be a small fraction of the cost of processing:
+    sr = 48000
+    channels_first = np.random.rand(num_channels, sr * 30).astype(np.float32)
+    interleaved = np.ascontiguousarray(channels_first.T)
+    plugin = pedalboard.Gain(0)
+
+    def measure(audio):
+        measurements = []
+        for _ in range(0, 10):
+            with timer() as time_taken:
+                plugin(audio, sample_rate=sr)
+            measurements.append(float(time_taken))
+        return np.median(measurements)
+
+    assert measure(interleaved) / measure(channels_first) < 2
+
+
+@pytest.mark.skip
+@pytest.mark.parametrize("num_channels", [2, 6])
+def test_interleaved_write_performance(tmp_path, num_channels: int):
+    sr = 48000
+    channels_first = np.random.rand(num_channels, sr * 30).astype(np.float32)
+    interleaved = np.ascontiguousarray(channels_first.T)
+    filename = str(tmp_path / "test.wav")
+
+    def measure(audio):
+        measurements = []
+        for _ in range(0, 5):
+            with timer() as time_taken:
+                with pedalboard.io.AudioFile(filename, "w", sr, num_channels) as f:
+                    f.write(audio)
+            measurements.append(float(time_taken))
+        return np.median(measurements)
+
+    assert measure(interleaved) / measure(channels_first) < 1.5
+
+
+@pytest.mark.skip
+@pytest.mark.parametrize(
+    "plugin", [pedalboard.Bitcrush(8), pedalboard.Clipping(-6), pedalboard.Invert()]
+)
+@pytest.mark.parametrize("dtype", [np.float32, np.float64])
+def test_sample_wise_plugin_performance(plugin, dtype):
+    # Sample-wise plugins are vectorized, so they should all run at roughly
+    # the speed of a plain multiplication (and much faster than NumPy, which
+    # needs several passes over the buffer to do the same thing):
+    sr = 48000
+    noise = np.random.rand(2, sr * 30).astype(dtype)
+    gain = pedalboard.Gain(0)
+
+    def measure(function):
+        measurements = []
+        for _ in range(0, 10):
+            with timer() as time_taken:
+                function()
+            measurements.append(float(time_taken))
+        return np.median(measurements)
+
+    plugin_time = measure(lambda: plugin(noise, sample_rate=sr))
+    assert plugin_time / measure(lambda: gain(noise, sample_rate=sr)) < 2
+
+    if isinstance(plugin, pedalboard.Bitcrush):
+        scale = 2.0**plugin.bit_depth
+        assert plugin_time < measure(lambda: np.around(noise * scale) / scale)
+
+
+@pytest.mark.skip
+@pytest.mark.parametrize("num_channels", [1, 2])
+def test_vectorized_reverb_performance(num_channels: int):
+    sr = 48000
+    noise = np.random.rand(num_channels, sr * 30).astype(np.float32)
+
+    def measure(plugin):
+        measurements = []
+        for _ in range(0, 5):
+            with timer() as time_taken:
+                plugin(noise, sample_rate=sr)
+            measurements.append(float(time_taken))
+        return np.median(measurements)
+
+    default_time = measure(pedalboard.Reverb())
+    vectorized_time = measure(pedalboard.Reverb(vectorized=True))
+
+    # In local tests, the vectorized reverb is about 3x faster.
+    # This test ensures it's at least 2x faster to account for
+    # variations across test run environments.
+    assert default_time / vectorized_time > 2
+
+
+@pytest.mark.skip
+def test_polyphase_gsm_compressor_performance():
+    sr = 44100
+    noise = np.random.rand(1, sr * 30).astype(np.float32) * 0.5
+
+    def measure(plugin):
+        measurements = []
+        for _ in range(0, 5):
+            with timer() as time_taken:
+                plugin(noise, sample_rate=sr)
+            measurements.append(float(time_taken))
+        return np.median(measurements)
+
+    default_time = measure(pedalboard.GSMFullRateCompressor())
+    polyphase_time = measure(
+        pedalboard.GSMFullRateCompressor(quality=pedalboard.Resample.Quality.Polyphase)
+    )
+
+    # The polyphase resampler should be much faster than the default
+    # windowed sinc resampler; this test ensures it's at least 3x faster
+    # to account for variations across test run environments.
+    assert default_time / polyphase_time > 3
+
+
+@pytest.mark.skip
+@pytest.mark.parametrize(
+    "plugin,reference",
+    [
+        (pedalboard.Compressor(-20, 4), JuceCompressor(-20, 4)),
+        (pedalboard.NoiseGate(-20, 4), JuceNoiseGate(-20, 4)),
+        (pedalboard.Limiter(-6), JuceLimiter(-6)),
+    ],
+)
+def test_dynamics_processor_performance(plugin, reference):
+    sr = 48000
+    noise = (np.random.rand(2, sr * 30).astype(np.float32) - 0.5) * 2
+
+    def measure(plugin):
+        measurements = []
+        for _ in range(0, 5):
+            with timer() as time_taken:
+                plugin(noise, sample_rate=sr)
+            measurements.append(float(time_taken))
+        return np.median(measurements)
+
+    # In local tests, the block-wise implementations are between 1.5x and 2x
+    # faster than JUCE's sample-by-sample implementations. This test only
+    # ensures they're not slower, to account for variations across test run
+    # environments (and because the envelope followers dominate on slow CPUs).
+    assert measure(plugin) < measure(reference) * 1.1
+
+
+@pytest.mark.skip
+@pytest.mark.parametrize(
+    "plugin,reference",
+    [
+        (pedalboard.Chorus(), JuceChorus()),
+        (pedalboard.Phaser(), JucePhaser()),
+    ],
+)
+@pytest.mark.parametrize("num_channels", [1, 2])
+def test_modulation_effect_performance(plugin, reference, num_channels: int):
+    sr = 48000
+    noise = (np.random.rand(num_channels, sr * 30).astype(np.float32) - 0.5) * 2
+
+    def measure(plugin):
+        measurements = []
+        for _ in range(0, 5):
+            with timer() as time_taken:
+                plugin(noise, sample_rate=sr)
+            measurements.append(float(time_taken))
+        return np.median(measurements)
+
+    # In local tests, the block-based implementations are about 1.5x faster
+    # than JUCE's on mono audio (although the Phaser is only slightly faster)
+    # and about 2x faster on stereo audio. This test only ensures they're not
+    # slower, to account for variations across test run environments.
+    assert measure(plugin) < measure(reference) * 1.1
+
+
+# The benchmarks below use pytest-benchmark to catch performance regressions
+# between releases. They take several minutes to run, so are only run when the
+# PEDALBOARD_BENCHMARK environment variable is set. To compare two builds:
+#
+#   PEDALBOARD_BENCHMARK=1 pytest tests/test_benchmark.py --benchmark-autosave
+#   (switch to the other build)
+#   PEDALBOARD_BENCHMARK=1 pytest tests/test_benchmark.py \
+#       --benchmark-compare --benchmark-compare-fail=mean:10%
+#
+# Each benchmark also reports its throughput (in samples per second) and
+# allocation statistics in its `extra_info`, visible with --benchmark-json.
+requires_benchmarking = pytest.mark.skipif(
+    not os.environ.get("PEDALBOARD_BENCHMARK"),
+    reason="Set PEDALBOARD_BENCHMARK=1 to run benchmarks.",
+)
+
+BENCHMARK_SAMPLE_RATE = 48000
+BENCHMARK_NUM_CHANNELS = 2
+BENCHMARK_NUM_SECONDS = 5
+IMPULSE_RESPONSE_PATH = os.path.join(os.path.dirname(__file__), "impulse_response.wav")
+
+
+def all_subclasses(cls):
+    for subclass in cls.__subclasses__():
+        yield subclass
+        yield from all_subclasses(subclass)
+
+
+# Every built-in plugin that can be constructed with its default arguments,
+# plus those that can't (with reasonable arguments):
+BENCHMARKABLE_PLUGINS = {
+    "Convolution": lambda: pedalboard.Convolution(IMPULSE_RESPONSE_PATH),
+}
+for plugin_class in all_subclasses(pedalboard.Plugin):
+    if issubclass(plugin_class, pedalboard.PluginContainer):
+        continue
+    try:
+        plugin_class()
+    except Exception:
+        continue
+    BENCHMARKABLE_PLUGINS[plugin_class.__name__] = plugin_class
+
+
+def benchmark_audio(num_seconds: float = BENCHMARK_NUM_SECONDS) -> np.ndarray:
+    num_samples = int(BENCHMARK_SAMPLE_RATE * num_seconds)
+    return (np.random.rand(BENCHMARK_NUM_CHANNELS, num_samples).astype(np.float32) - 0.5) * 0.5
+
+
+def measure_allocations(benchmark_fixture, function, plugin=None):
+    """
+    Run ``function`` once more (outside of the timed runs), recording the peak
+    Python-visible memory it used (including NumPy arrays) and, if ``plugin`` is
+    provided, the number of native allocations made by that plugin.
+    """
+    tracemalloc.start()
+    try:
+        function()
+        _, peak = tracemalloc.get_traced_memory()
+    finally:
+        tracemalloc.stop()
+    benchmark_fixture.extra_info["peak_memory_bytes"] = peak
+
+    if plugin is None:
+        return
+
+    plugin.profile(reset=True)
+    pedalboard.set_profiling_enabled(True)
+    try:
+        function()
+    finally:
+        pedalboard.set_profiling_enabled(False)
+    benchmark_fixture.extra_info["reallocations"] = sum(
+        stats["reallocations"] for stats in plugin.profile(reset=True).values()
+    )
+
+    # Native allocations can only be counted in builds with real-time auditing:
+    try:
+        pedalboard.set_realtime_audit_mode("count")
+    except RuntimeError:
+        return
+    try:
+        function()
+    finally:
+        pedalboard.set_realtime_audit_mode("off")
+    benchmark_fixture.extra_info["allocations"] = sum(
+        counts["allocations"]
+        for counts in pedalboard.get_realtime_audit_report(plugin, reset=True).values()
+    )
+
+
+def run_benchmark(benchmark_fixture, function, num_samples: int, plugin=None):
+    result = benchmark_fixture(function)
+    if benchmark_fixture.stats:
+        benchmark_fixture.extra_info["samples_per_second"] = (
+            num_samples / benchmark_fixture.stats.stats.mean
+        )
+    measure_allocations(benchmark_fixture, function, plugin)
+    return result
+
+
+@requires_benchmarking
+@pytest.mark.parametrize("plugin_name", sorted(BENCHMARKABLE_PLUGINS.keys()))
+def test_plugin_benchmark(benchmark, plugin_name: str):
+    plugin = BENCHMARKABLE_PLUGINS[plugin_name]()
+    audio = benchmark_audio()
+    run_benchmark(
+        benchmark,
+        lambda: plugin(audio, BENCHMARK_SAMPLE_RATE),
+        audio.shape[-1],
+        plugin,
+    )
+
+
+@requires_benchmarking
+@pytest.mark.parametrize("buffer_size", [32, 128, 512, 2048, 8192])
+def test_process_block_size_benchmark(benchmark, buffer_size: int):
+    board = pedalboard.Pedalboard(
+        [pedalboard.Gain(-3), pedalboard.Compressor(), pedalboard.Reverb()]
+    )
+    audio = benchmark_audio()
+    run_benchmark(
+        benchmark,
+        lambda: board(audio, BENCHMARK_SAMPLE_RATE, buffer_size=buffer_size),
+        audio.shape[-1],
+        board,
+    )
+
+
+def nested_mix(depth: int) -> pedalboard.Plugin:
+    if depth == 0:
+        return pedalboard.Gain(-1)
+    return pedalboard.Mix([pedalboard.Chain([nested_mix(depth - 1)]), pedalboard.Gain(-1)])
+
+
+@requires_benchmarking
+@pytest.mark.parametrize("depth", [1, 2, 4, 8])
+def test_mix_and_chain_nesting_benchmark(benchmark, depth: int):
+    board = pedalboard.Pedalboard([nested_mix(depth)])
+    audio = benchmark_audio()
+    run_benchmark(
+        benchmark,
+        lambda: board(audio, BENCHMARK_SAMPLE_RATE),
+        audio.shape[-1],
+        board,
+    )
+
+
+@requires_benchmarking
+@pytest.mark.parametrize("extension", get_supported_write_formats())
+def test_read_benchmark(benchmark, tmp_path, extension: str):
+    filename = str(tmp_path / f"benchmark{extension}")
+    with AudioFile(filename, "w", BENCHMARK_SAMPLE_RATE, BENCHMARK_NUM_CHANNELS) as f:
+        f.write(benchmark_audio())
+
+    def read():
+        with AudioFile(filename) as f:
+            return f.read(f.frames)
+
+    run_benchmark(benchmark, read, int(BENCHMARK_SAMPLE_RATE * BENCHMARK_NUM_SECONDS))
+
+
+@requires_benchmarking
+@pytest.mark.parametrize("extension", get_supported_write_formats())
+@pytest.mark.parametrize("quality", [None, "worst", "best"])
+def test_write_benchmark(benchmark, tmp_path, extension: str, quality):
+    filename = str(tmp_path / f"benchmark{extension}")
+    audio = benchmark_audio()
+
+    def write():
+        with AudioFile(
+            filename, "w", BENCHMARK_SAMPLE_RATE, BENCHMARK_NUM_CHANNELS, quality=quality
+        ) as f:
+            f.write(audio)
+
+    try:
+        write()
+    except ValueError:
+        pytest.skip(f"{extension} files do not support quality={quality!r}.")
+
+    run_benchmark(benchmark, write, audio.shape[-1])
+
+
+@requires_benchmarking
+@pytest.mark.parametrize(
+    "quality", sorted(pedalboard.Resample.Quality.__members__.values(), key=int)
+)
+def test_stream_resampler_benchmark(benchmark, quality):
+    audio = benchmark_audio()
+    chunk_size = 8192
+
+    def resample():
+        resampler = StreamResampler(
+            BENCHMARK_SAMPLE_RATE, 44100, BENCHMARK_NUM_CHANNELS, quality
+        )
+        for start in range(0, audio.shape[-1], chunk_size):
+            resampler.process(audio[:, start : start + chunk_size])
+        resampler.process()
+
+    run_benchmark(benchmark, resample, audio.shape[-1])
+
+
+@requires_benchmarking
+@pytest.mark.parametrize("module", ["pedalboard", "pedalboard.io"])
+def test_import_benchmark(benchmark, module: str):
+    # Each import needs a fresh interpreter; the time taken to start Python
+    # (and import NumPy) is included, as that's what a cold start costs:
+    def import_module():
+        subprocess.check_call([sys.executable, "-c", f"import {module}"])
+
+    benchmark.pedantic(import_module, rounds=10, warmup_rounds=1)
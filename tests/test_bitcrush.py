@@ -37,3 +37,18 @@ def test_bitcrush(bit_depth: float, fundamental_hz: float, sample_rate: float, n
 
     expected_output = np.around(sine_wave.astype(np.float64) * (2**bit_depth)) / (2**bit_depth)
     np.testing.assert_allclose(output, expected_output, atol=0.01)
+
+
+@pytest.mark.parametrize("bit_depth", [1, 4, 8, 16, 24, 32])
+@pytest.mark.parametrize("dtype", [np.float32, np.float64])
+def test_bitcrush_rounds_half_to_even(bit_depth: float, dtype):
+    scale = dtype(2**bit_depth)
+    # Include values that land exactly halfway between two quantization steps:
+    halfway = (np.arange(-64, 64, dtype=dtype) + dtype(0.5)) / scale
+    noise = np.random.rand(2, 4099).astype(dtype) * 2 - 1
+    audio = np.concatenate([np.stack([halfway, -halfway]), noise], axis=1)
+
+    output = Bitcrush(bit_depth).process(audio, 44100)
+
+    expected = np.around(audio * scale) * (dtype(1) / scale)
+    np.testing.assert_array_equal(output, expected)
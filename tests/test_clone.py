@@ -0,0 +1,109 @@
+#! /usr/bin/env python
+#
+# Copyright 2023 Spotify AB
+#
+# Licensed under the GNU Public License, Version 3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import os
+from concurrent.futures import ThreadPoolExecutor
+
+import numpy as np
+import pytest
+
+from pedalboard import (
+    Chorus,
+    Compressor,
+    Convolution,
+    Gain,
+    GSMFullRateCompressor,
+    Mix,
+    Chain,
+    Pedalboard,
+    Resample,
+    Reverb,
+)
+from pedalboard_native._internal import AddLatency
+
+SAMPLE_RATE = 44100
+IMPULSE_RESPONSE_PATH = os.path.join(os.path.dirname(__file__), "impulse_response.wav")
+
+
+def make_board():
+    return Pedalboard(
+        [
+            Gain(-3),
+            Compressor(threshold_db=-20, ratio=4),
+            Mix([Chain([Chorus()]), Reverb(room_size=0.7)]),
+            Convolution(IMPULSE_RESPONSE_PATH, 0.5),
+        ],
+        fused=True,
+    )
+
+
+@pytest.mark.parametrize(
+    "plugin_factory",
+    [
+        make_board,
+        lambda: Convolution(np.random.default_rng(1).random(4096, dtype=np.float32), 0.8, 44100),
+        lambda: Resample(16000, quality=Resample.Quality.Polyphase),
+        lambda: GSMFullRateCompressor(quality=Resample.Quality.Linear),
+    ],
+)
+def test_clone_produces_identical_output(plugin_factory):
+    audio = np.random.default_rng(1234).random((2, SAMPLE_RATE), dtype=np.float32) - 0.5
+    original = plugin_factory()
+    clone = original.clone()
+
+    assert clone is not original
+    assert type(clone) is type(original)
+    np.testing.assert_allclose(clone(audio, SAMPLE_RATE), original(audio, SAMPLE_RATE), atol=1e-6)
+
+
+def test_clone_is_independent():
+    board = make_board()
+    clone = board.clone()
+    assert isinstance(clone, Pedalboard)
+    assert clone.fused
+    assert clone[0] is not board[0]
+
+    clone[0].gain_db = 6
+    assert board[0].gain_db == -3
+
+
+def test_clone_shares_convolution_impulse_response():
+    ir = np.random.default_rng(1).random((2, 8192), dtype=np.float32)
+    original = Convolution(ir, 1.0, 44100, head_size=1024, num_threads=2)
+    clone = original.clone()
+    assert clone.head_size == original.head_size
+    assert clone.num_threads == 2
+    np.testing.assert_array_equal(clone.impulse_response, ir)
+
+
+def test_clones_can_be_used_in_parallel():
+    board = make_board()
+    clips = [
+        np.random.default_rng(i).random((2, SAMPLE_RATE // 2), dtype=np.float32) for i in range(8)
+    ]
+    expected = [board(clip, SAMPLE_RATE) for clip in clips]
+
+    clones = [board.clone() for _ in clips]
+    with ThreadPoolExecutor(4) as executor:
+        outputs = list(executor.map(lambda args: args[0](args[1], SAMPLE_RATE), zip(clones, clips)))
+    for o, e in zip(outputs, expected):
+        np.testing.assert_allclose(o, e, atol=1e-6)
+
+
+def test_clone_raises_for_uncloneable_plugins():
+    with pytest.raises(RuntimeError):
+        Pedalboard([Gain(), AddLatency(10)]).clone()
@@ -0,0 +1,118 @@
+#! /usr/bin/env python
+#
+# Copyright 2023 Spotify AB
+#
+# Licensed under the GNU Public License, Version 3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import os
+import subprocess
+import sys
+
+import numpy as np
+import pytest
+
+import pedalboard
+
+FEATURE_KEYS = {"sse2", "sse4_1", "avx", "avx2", "fma", "avx512f", "neon"}
+
+# Renders audio through every plugin that uses a runtime-dispatched kernel, and
+# saves the results to the filename given as the first argument:
+RENDER_SCRIPT = """
+import sys
+import numpy as np
+from pedalboard import (
+    EQ, Bitcrush, Clipping, Convolution, Gain, HighShelfFilter, LowShelfFilter,
+    PeakFilter, Resample, cpu_features
+)
+from pedalboard.io import AudioFile
+
+sample_rate = 44100
+rng = np.random.default_rng(1234)
+audio = rng.standard_normal((2, sample_rate)).astype(np.float32) * 0.5
+impulse_response = rng.standard_normal(8192).astype(np.float32) * np.exp(-np.arange(8192) / 1000)
+
+outputs = {"kernels": np.array(cpu_features()["kernels"])}
+outputs["gain"] = Gain(-6)(audio, sample_rate)
+outputs["gain64"] = Gain(-6)(audio.astype(np.float64), sample_rate)
+outputs["clipping"] = Clipping(-6)(audio, sample_rate)
+outputs["clipping64"] = Clipping(-6)(audio.astype(np.float64), sample_rate)
+outputs["bitcrush"] = Bitcrush(6)(audio, sample_rate)
+outputs["bitcrush64"] = Bitcrush(6)(audio.astype(np.float64), sample_rate)
+bands = [LowShelfFilter(200, 6), PeakFilter(1000, -6, 2), HighShelfFilter(8000, 3)]
+outputs["eq"] = EQ(bands)(audio, sample_rate)
+outputs["eq_surround"] = EQ(bands)(np.concatenate([audio] * 3), sample_rate)
+outputs["resample"] = Resample(8000, quality=Resample.Quality.Polyphase)(audio, sample_rate)
+outputs["convolution"] = Convolution(impulse_response, sample_rate=sample_rate)(audio, sample_rate)
+
+filename = sys.argv[1] + ".wav"
+with AudioFile(filename, "w", sample_rate, 2, bit_depth=32) as f:
+    f.write(audio)
+with AudioFile(filename) as f:
+    outputs["io"] = f.read(f.frames)
+
+np.savez(sys.argv[1], **outputs)
+"""
+
+
+def render_with_kernels(kernels: str, tmp_path, name: str = "output") -> dict:
+    prefix = str(tmp_path / f"{name}_{kernels}")
+    subprocess.check_call(
+        [sys.executable, "-c", RENDER_SCRIPT, prefix],
+        env={**os.environ, "PEDALBOARD_SIMD": kernels, "PYTHONPATH": os.pathsep.join(sys.path)},
+    )
+    with np.load(prefix + ".npz") as outputs:
+        return dict(outputs)
+
+
+def test_cpu_features():
+    features = pedalboard.cpu_features()
+    assert FEATURE_KEYS < set(features.keys())
+    for key in FEATURE_KEYS:
+        assert isinstance(features[key], bool)
+
+    available = features["available_kernels"]
+    assert available
+    assert features["kernels"] in available
+    if os.environ.get("PEDALBOARD_SIMD") not in available:
+        # Without an override, the most capable kernels should be used:
+        assert features["kernels"] == available[-1]
+
+    if features["avx2"] and features["fma"]:
+        assert "avx2" in available
+    if features["neon"]:
+        assert available == ["neon"]
+
+
+def test_unsupported_kernels_are_ignored(tmp_path):
+    expected = pedalboard.cpu_features()["available_kernels"][-1]
+    assert render_with_kernels("not-a-real-instruction-set", tmp_path)["kernels"] == expected
+
+
+@pytest.mark.parametrize("kernels", pedalboard.cpu_features()["available_kernels"])
+def test_all_kernels_produce_the_same_output(kernels: str, tmp_path):
+    baseline_kernels = pedalboard.cpu_features()["available_kernels"][0]
+    expected = render_with_kernels(baseline_kernels, tmp_path, "expected")
+    actual = render_with_kernels(kernels, tmp_path)
+    assert actual["kernels"] == kernels
+
+    for key in expected:
+        if key == "kernels":
+            continue
+        if key in {"gain", "gain64", "clipping", "clipping64", "bitcrush", "bitcrush64", "io"}:
+            # Element-wise kernels should be bit-exact on every instruction set:
+            np.testing.assert_array_equal(actual[key], expected[key], err_msg=key)
+        else:
+            # ...while others may sum in a different order, or use fused
+            # multiply-adds:
+            np.testing.assert_allclose(actual[key], expected[key], atol=1e-4, err_msg=key)
@@ -0,0 +1,92 @@
+#! /usr/bin/env python
+#
+# Copyright 2023 Spotify AB
+#
+# Licensed under the GNU Public License, Version 3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import io
+
+import numpy as np
+import pytest
+
+from pedalboard import Gain, Pedalboard, Reverb
+from pedalboard.io import AudioFile, StreamResampler
+
+SAMPLE_RATE = 44100
+
+
+class DLPackOnlyTensor:
+    """A minimal tensor that can only be read via the DLPack protocol."""
+
+    def __init__(self, array: np.ndarray, device_type: int = 1):
+        self.array = array
+        self.device_type = device_type
+
+    def __dlpack__(self, **kwargs):
+        return self.array.__dlpack__(**kwargs)
+
+    def __dlpack_device__(self):
+        return (self.device_type, 0)
+
+
+@pytest.mark.skipif(not hasattr(np, "from_dlpack"), reason="Requires NumPy 1.22+")
+def test_process_dlpack_tensor():
+    audio = np.random.rand(2, SAMPLE_RATE).astype(np.float32)
+    board = Pedalboard([Gain(-6), Reverb()])
+    output = board(DLPackOnlyTensor(audio), SAMPLE_RATE)
+    np.testing.assert_allclose(output, board(audio, SAMPLE_RATE))
+
+
+def test_process_rejects_non_cpu_tensors():
+    audio = np.random.rand(2, SAMPLE_RATE).astype(np.float32)
+    with pytest.raises(TypeError):
+        Gain()(DLPackOnlyTensor(audio, device_type=2), SAMPLE_RATE)
+
+
+@pytest.mark.skipif(not hasattr(np, "from_dlpack"), reason="Requires NumPy 1.22+")
+def test_write_dlpack_tensor():
+    audio = np.random.rand(2, 1000).astype(np.float32)
+    file_like = io.BytesIO()
+    with AudioFile(file_like, "w", SAMPLE_RATE, 2, format="wav", bit_depth=32) as f:
+        f.write(DLPackOnlyTensor(audio))
+    file_like.seek(0)
+    with AudioFile(file_like) as f:
+        np.testing.assert_allclose(f.read(f.frames), audio)
+
+
+def test_write_rejects_other_objects():
+    with AudioFile(io.BytesIO(), "w", SAMPLE_RATE, 1, format="wav") as f:
+        with pytest.raises(TypeError):
+            f.write([0.0, 0.0])
+
+
+def test_torch_tensors_round_trip():
+    torch = pytest.importorskip("torch")
+    audio = torch.rand(2, SAMPLE_RATE)
+    board = Pedalboard([Gain(-6)])
+
+    output = board(audio, SAMPLE_RATE)
+    assert isinstance(output, torch.Tensor)
+    np.testing.assert_allclose(output.numpy(), board(audio.numpy(), SAMPLE_RATE))
+
+    resampled = StreamResampler(SAMPLE_RATE, 22050, 2).process(audio)
+    assert isinstance(resampled, torch.Tensor)
+
+
+def test_torch_tensors_processed_inplace():
+    torch = pytest.importorskip("torch")
+    audio = torch.rand(2, SAMPLE_RATE)
+    expected = Gain(-6)(audio.numpy(), SAMPLE_RATE)
+    Gain(-6)(audio, SAMPLE_RATE, inplace=True)
+    np.testing.assert_allclose(audio.numpy(), expected)
@@ -0,0 +1,134 @@
+#! /usr/bin/env python
+#
+# Copyright 2023 Spotify AB
+#
+# Licensed under the GNU Public License, Version 3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import numpy as np
+import pytest
+
+from pedalboard import Compressor, Limiter, NoiseGate
+from pedalboard_native._internal import JuceCompressor, JuceLimiter, JuceNoiseGate
+
+SAMPLE_RATE = 48000
+
+
+def enveloped_noise(num_channels: int, num_seconds: float = 2, seed: int = 1234) -> np.ndarray:
+    # Noise with a slowly varying level, so that the envelope followers spend
+    # time attacking, releasing and crossing the threshold in both directions:
+    rng = np.random.default_rng(seed)
+    num_samples = int(SAMPLE_RATE * num_seconds)
+    level = 0.5 + 0.5 * np.sin(2 * np.pi * 1.5 * np.arange(num_samples) / SAMPLE_RATE)
+    return (rng.uniform(-1, 1, (num_channels, num_samples)) * level).astype(np.float32)
+
+
+@pytest.mark.parametrize("threshold_db", [0, -12, -30])
+@pytest.mark.parametrize("ratio", [1, 2.5, 20])
+@pytest.mark.parametrize("attack_ms", [0, 1, 30])
+@pytest.mark.parametrize("release_ms", [10, 200])
+@pytest.mark.parametrize("num_channels", [1, 2, 3])
+def test_compressor_matches_juce(threshold_db, ratio, attack_ms, release_ms, num_channels):
+    audio = enveloped_noise(num_channels)
+    args = (threshold_db, ratio, attack_ms, release_ms)
+    expected = JuceCompressor(*args)(audio, SAMPLE_RATE)
+    np.testing.assert_allclose(Compressor(*args)(audio, SAMPLE_RATE), expected, atol=1e-5)
+
+
+@pytest.mark.parametrize("threshold_db", [-6, -20, -40])
+@pytest.mark.parametrize("ratio", [1.5, 10])
+@pytest.mark.parametrize("attack_ms", [0, 1, 30])
+@pytest.mark.parametrize("release_ms", [10, 200])
+@pytest.mark.parametrize("num_channels", [1, 2, 3])
+def test_noise_gate_matches_juce(threshold_db, ratio, attack_ms, release_ms, num_channels):
+    audio = enveloped_noise(num_channels)
+    args = (threshold_db, ratio, attack_ms, release_ms)
+    expected = JuceNoiseGate(*args)(audio, SAMPLE_RATE)
+    np.testing.assert_allclose(NoiseGate(*args)(audio, SAMPLE_RATE), expected, atol=1e-5)
+
+
+@pytest.mark.parametrize("threshold_db", [0, -6, -20])
+@pytest.mark.parametrize("release_ms", [1, 100, 500])
+@pytest.mark.parametrize("num_channels", [1, 2, 3])
+def test_limiter_matches_juce(threshold_db, release_ms, num_channels):
+    audio = enveloped_noise(num_channels) * 2
+    expected = JuceLimiter(threshold_db, release_ms)(audio, SAMPLE_RATE)
+    np.testing.assert_allclose(
+        Limiter(threshold_db, release_ms)(audio, SAMPLE_RATE), expected, atol=1e-5
+    )
+
+
+@pytest.mark.parametrize("buffer_size", [1, 100, 8192])
+@pytest.mark.parametrize(
+    "plugin,reference",
+    [
+        (Compressor(-20, 4), JuceCompressor(-20, 4)),
+        (NoiseGate(-20, 4), JuceNoiseGate(-20, 4)),
+        (Limiter(-6), JuceLimiter(-6)),
+    ],
+)
+def test_buffer_size_does_not_change_output(buffer_size, plugin, reference):
+    audio = enveloped_noise(2, num_seconds=0.5)
+    expected = reference(audio, SAMPLE_RATE)
+    np.testing.assert_allclose(
+        plugin(audio, SAMPLE_RATE, buffer_size=buffer_size), expected, atol=1e-5
+    )
+
+
+@pytest.mark.parametrize(
+    "plugin_class,kwargs",
+    [
+        (Compressor, {"threshold_db": -20, "ratio": 4}),
+        (NoiseGate, {"threshold_db": -20, "ratio": 4}),
+        (Limiter, {"threshold_db": -6}),
+    ],
+)
+def test_linked_mode_applies_the_same_gain_to_all_channels(plugin_class, kwargs):
+    # A loud left channel and a much quieter, independent right channel:
+    audio = enveloped_noise(2)
+    audio[1] *= 0.05
+    # Avoid dividing by zero when computing the gain below:
+    audio[np.abs(audio) < 1e-3] = 1e-3
+
+    linked = plugin_class(**kwargs, linked=True)
+    assert linked.linked
+    assert "linked=True" in repr(linked)
+
+    output = linked(audio, SAMPLE_RATE)
+    gain = output / audio
+    np.testing.assert_allclose(gain[0], gain[1], rtol=1e-4)
+
+    # Unlinked, each channel gets its own gain:
+    unlinked = plugin_class(**kwargs)
+    assert not unlinked.linked
+    unlinked_gain = unlinked(audio, SAMPLE_RATE) / audio
+    assert not np.allclose(unlinked_gain[0], unlinked_gain[1], rtol=1e-4)
+
+
+@pytest.mark.parametrize("plugin_class", [Compressor, NoiseGate])
+def test_linked_mode_follows_the_loudest_channel(plugin_class):
+    # Processing a stereo pair in linked mode should apply the gain that
+    # unlinked processing would apply to the per-sample maximum of both channels:
+    audio = enveloped_noise(2)
+    loudest = np.amax(np.abs(audio), axis=0, keepdims=True)
+    loudest[loudest < 1e-3] = 1e-3
+
+    kwargs = {"threshold_db": -20, "ratio": 4}
+    expected_gain = plugin_class(**kwargs)(loudest, SAMPLE_RATE) / loudest
+    output = plugin_class(**kwargs, linked=True)(audio, SAMPLE_RATE)
+    np.testing.assert_allclose(output, audio * expected_gain, atol=1e-5)
+
+
+def test_linked_is_cloned():
+    plugin = Compressor(-20, 4, linked=True)
+    assert plugin.clone().linked
@@ -16,6 +16,7 @@
 
 
 import atexit
+import gc
 import math
 import os
 import platform
@@ -675,6 +676,41 @@ def test_string_parameter_valdation(plugin_filename: str, parameter_name: str):
         setattr(plugin, parameter_name, "some value not present")
 
 
+@pytest.mark.parametrize("plugin_filename", AVAILABLE_EFFECT_PLUGINS_IN_TEST_ENVIRONMENT)
+def test_bulk_parameter_values(plugin_filename: str):
+    plugin = load_test_plugin(plugin_filename)
+
+    values = plugin.get_parameter_values()
+    assert set(values.keys()) == set(plugin.parameters.keys())
+    for name, value in values.items():
+        attribute_value = getattr(plugin, name)
+        if isinstance(value, float) and math.isnan(value):
+            continue
+        assert value == attribute_value, f"Expected {name} to be {attribute_value}, got {value}"
+
+    new_values = {
+        name: parameter.min_value
+        for name, parameter in plugin.parameters.items()
+        if parameter.type == float
+    }
+    plugin.set_parameter_values(new_values)
+    for name, expected in new_values.items():
+        actual = getattr(plugin, name)
+        if math.isnan(actual):
+            continue
+        assert actual == expected, f"Expected attribute {name} to be {expected}, but was {actual}"
+
+    # No parameters should change if any of them are invalid:
+    raw_values_before = {name: p.raw_value for name, p in plugin.parameters.items()}
+    invalid_values = {
+        name: p.max_value for name, p in plugin.parameters.items() if p.type == float
+    }
+    invalid_values["missing_parameter"] = 123
+    with pytest.raises(AttributeError):
+        plugin.set_parameter_values(invalid_values)
+    assert {name: p.raw_value for name, p in plugin.parameters.items()} == raw_values_before
+
+
 @pytest.mark.parametrize("plugin_filename", AVAILABLE_EFFECT_PLUGINS_IN_TEST_ENVIRONMENT)
 def test_plugin_parameters_persist_between_calls(plugin_filename: str):
     plugin = load_test_plugin(plugin_filename)
@@ -1050,3 +1086,141 @@ def test_external_instrument_cannot_be_reset_on_non_main_thread(plugin_filename:
         plugin = load_test_plugin(plugin_filename)
         with pytest.raises(RuntimeError, match="main thread"):
             executor.submit(plugin.reset).result()
+
+
+@pytest.mark.parametrize("plugin_filename", AVAILABLE_EFFECT_PLUGINS_IN_TEST_ENVIRONMENT)
+def test_pooled_external_plugin_reuses_instances(plugin_filename: str):
+    plugin = load_test_plugin(plugin_filename, disable_caching=True, pooled=True)
+    assert plugin.pooled
+    plugin_class = type(plugin)
+
+    if plugin._reload_type != pedalboard.ExternalPluginReloadType.ClearsAudioOnReset:
+        pytest.skip("Plugins that do not clear audio on reset are never pooled.")
+
+    sr = 44100
+    noise = np.random.rand(sr, 2)
+    expected_output = plugin(noise, sr)
+    expected_parameters = {name: getattr(plugin, name) for name in plugin.parameters.keys()}
+
+    del plugin
+    gc.collect()
+
+    plugin = load_test_plugin(plugin_filename, disable_caching=True, pooled=True)
+    # The idle instance should have been handed out again:
+    assert plugin_class.clear_instance_pool() == 0
+    assert {name: getattr(plugin, name) for name in plugin.parameters.keys()} == (
+        expected_parameters
+    )
+    np.testing.assert_allclose(plugin(noise, sr), expected_output, atol=0.05)
+
+    del plugin
+    gc.collect()
+    assert plugin_class.clear_instance_pool() == 1
+
+
+@pytest.mark.parametrize("plugin_filename", AVAILABLE_PLUGINS_IN_TEST_ENVIRONMENT)
+def test_plugin_scan_cache(plugin_filename: str, tmp_path: Path):
+    cache_path = str(tmp_path / "plugin_scan_cache.xml")
+    pedalboard.ExternalPlugin.scan_cache_path = cache_path
+    try:
+        assert pedalboard.ExternalPlugin.scan_cache_path == cache_path
+        plugin = load_test_plugin(plugin_filename, disable_caching=True)
+        assert os.path.isfile(cache_path)
+        with open(cache_path) as f:
+            assert plugin.name in f.read()
+
+        # Loading from the cache should give the same plugin:
+        cached_plugin = load_test_plugin(plugin_filename, disable_caching=True)
+        assert cached_plugin.name == plugin.name
+        assert cached_plugin.parameters.keys() == plugin.parameters.keys()
+    finally:
+        pedalboard.ExternalPlugin.scan_cache_path = None
+    assert pedalboard.ExternalPlugin.scan_cache_path is None
+
+
+@pytest.mark.parametrize("plugin_filename", AVAILABLE_EFFECT_PLUGINS_IN_TEST_ENVIRONMENT)
+def test_out_of_process_effect_plugin_matches_in_process(plugin_filename: str):
+    plugin = load_test_plugin(plugin_filename, disable_caching=True)
+    if plugin._reload_type != pedalboard.ExternalPluginReloadType.ClearsAudioOnReset:
+        pytest.skip("Plugin output is not repeatable if it does not clear audio on reset.")
+
+    if plugin_filename.endswith(".component"):
+        pytest.skip("Audio Units must be installed before being loaded out-of-process.")
+
+    sr = 44100
+    noise = np.random.rand(2, sr).astype(np.float32)
+    expected = plugin(noise, sr)
+
+    with pedalboard.OutOfProcessPlugin(find_plugin_path(plugin_filename)) as oop_plugin:
+        assert oop_plugin.name == plugin.name
+        assert oop_plugin.is_effect
+        assert oop_plugin.get_parameter_values().keys() == plugin.parameters.keys()
+        output = oop_plugin(noise, sr)
+        assert output.dtype == np.float32
+        np.testing.assert_allclose(output, expected, atol=0.05)
+        assert oop_plugin(noise.astype(np.float64), sr).dtype == np.float64
+    assert not oop_plugin.is_alive
+
+
+@pytest.mark.parametrize("plugin_filename", AVAILABLE_EFFECT_PLUGINS_IN_TEST_ENVIRONMENT)
+def test_out_of_process_plugin_crash_raises(plugin_filename: str):
+    if plugin_filename.endswith(".component"):
+        pytest.skip("Audio Units must be installed before being loaded out-of-process.")
+
+    oop_plugin = pedalboard.OutOfProcessPlugin(find_plugin_path(plugin_filename))
+    # Simulate the plugin crashing its host process:
+    oop_plugin._host.process.kill()
+    oop_plugin._host.process.join()
+
+    with pytest.raises(RuntimeError, match="exited unexpectedly"):
+        oop_plugin(np.zeros((2, 1024), dtype=np.float32), 44100)
+    with pytest.raises(RuntimeError, match="no longer running"):
+        oop_plugin(np.zeros((2, 1024), dtype=np.float32), 44100)
+
+
+@pytest.mark.parametrize("plugin_filename", AVAILABLE_INSTRUMENT_PLUGINS_IN_TEST_ENVIRONMENT)
+@pytest.mark.parametrize("num_workers", [1, 3])
+def test_instrument_plugin_process_batch(plugin_filename: str, num_workers: int):
+    plugin = load_test_plugin(plugin_filename)
+    clips = [
+        [
+            mido.Message("note_on", note=note, velocity=127, time=0),
+            mido.Message("note_off", note=note, time=0.5),
+        ]
+        for note in (48, 60, 72, 84)
+    ]
+    durations = [0.5, 1.0, 1.5, 2.0]
+
+    outputs = plugin.process_batch(clips, durations, 44100, num_workers=num_workers)
+    assert len(outputs) == len(clips)
+    for output, duration in zip(outputs, durations):
+        assert output.shape == (2, int(duration * 44100))
+        assert max_volume_of(output) > 0
+
+    # The same clip should render identically, regardless of which instance renders it:
+    repeated = plugin.process_batch([clips[0]] * 4, 1.0, 44100, num_workers=num_workers)
+    for output in repeated[1:]:
+        np.testing.assert_allclose(output, repeated[0], atol=0.05)
+
+
+def test_instrument_plugin_process_batch_validates_durations():
+    if not AVAILABLE_INSTRUMENT_PLUGINS_IN_TEST_ENVIRONMENT:
+        pytest.skip("No instrument plugins available.")
+    plugin = load_test_plugin(AVAILABLE_INSTRUMENT_PLUGINS_IN_TEST_ENVIRONMENT[0])
+    with pytest.raises(ValueError, match="one duration per MIDI clip"):
+        plugin.process_batch([[], []], [1.0], 44100)
+
+
+@pytest.mark.parametrize("plugin_filename", AVAILABLE_EFFECT_PLUGINS_IN_TEST_ENVIRONMENT)
+def test_effect_plugin_process_batch(plugin_filename: str):
+    plugin = load_test_plugin(plugin_filename)
+    if plugin.is_instrument:
+        pytest.skip("Not an effect plugin.")
+
+    sr = 44100
+    buffers = [np.random.rand(2, sr // (i + 1)).astype(np.float32) for i in range(4)]
+    expected = [plugin(buffer, sr) for buffer in buffers]
+    outputs = plugin.process_batch(buffers, sr, num_workers=2)
+    assert len(outputs) == len(buffers)
+    for output, expected_output in zip(outputs, expected):
+        np.testing.assert_allclose(output, expected_output, atol=0.05)
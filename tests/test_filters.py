@@ -17,7 +17,16 @@
 
 import pytest
 import numpy as np
-from pedalboard import HighpassFilter, LowpassFilter, HighShelfFilter, LowShelfFilter, PeakFilter
+from pedalboard import (
+    EQ,
+    Gain,
+    HighpassFilter,
+    LowpassFilter,
+    HighShelfFilter,
+    LowShelfFilter,
+    PeakFilter,
+    Pedalboard,
+)
 from .utils import generate_sine_at, db_to_gain
 
 
@@ -138,3 +147,64 @@ def test_getters_and_setters(klass):
     for x in dir(plugin):
         if not x.startswith("_"):
             getattr(plugin, x)
+
+
+def make_eq_bands():
+    return [
+        HighpassFilter(40),
+        LowShelfFilter(120, gain_db=3, q=0.8),
+        PeakFilter(440, gain_db=-6, q=2),
+        PeakFilter(1500, gain_db=4, q=1),
+        PeakFilter(3000, gain_db=-2, q=4),
+        HighShelfFilter(8000, gain_db=-3),
+        LowpassFilter(16000),
+    ]
+
+
+@pytest.mark.parametrize("num_channels", [1, 2, 3, 8])
+@pytest.mark.parametrize("num_bands", [0, 1, 2, 7])
+@pytest.mark.parametrize("buffer_size", [1, 5, 8192])
+def test_eq_matches_individual_filters(num_channels, num_bands, buffer_size):
+    sample_rate = 44100
+    noise = np.random.rand(num_channels, sample_rate // 4).astype(np.float32) - 0.5
+    bands = make_eq_bands()[:num_bands]
+
+    expected = Pedalboard(bands)(noise, sample_rate, buffer_size=buffer_size)
+    actual = EQ(bands)(noise, sample_rate, buffer_size=buffer_size)
+    np.testing.assert_allclose(actual, expected, atol=1e-4)
+
+
+def test_eq_smooths_parameter_changes():
+    sample_rate = 44100
+    band = PeakFilter(1000, gain_db=0, q=1)
+    eq = EQ([band])
+    sine = generate_sine_at(sample_rate, 1000, num_seconds=1).astype(np.float32)
+    chunk_size = 512
+
+    switch_at = chunk_size * 40
+    output = []
+    for i in range(0, sine.shape[-1], chunk_size):
+        # Jump from 0dB to +12dB at a chunk boundary:
+        band.gain_db = 12 if i >= switch_at else 0
+        output.append(eq.process(sine[i : i + chunk_size], sample_rate, reset=False))
+    output = np.concatenate(output)
+
+    # (Avoiding the fade in and fade out at either end of the sine wave:)
+    expected_rms = rms(sine[switch_at - 4410 : switch_at])
+    assert rms(output[switch_at - 4410 : switch_at]) == pytest.approx(expected_rms, rel=0.01)
+    # The gain should ramp up over 50ms rather than jumping immediately:
+    assert rms(output[switch_at : switch_at + 64]) < expected_rms * db_to_gain(3)
+    assert rms(output[-8820:-4410]) == pytest.approx(expected_rms * db_to_gain(12), rel=0.02)
+
+
+def test_eq_bands():
+    bands = make_eq_bands()
+    eq = EQ(bands)
+    assert eq.bands == bands
+    assert "7 bands" in repr(eq)
+
+    eq.bands = bands[:1]
+    assert eq.bands == bands[:1]
+
+    with pytest.raises(TypeError):
+        EQ([Gain()])
@@ -17,6 +17,7 @@
 
 import pytest
 import numpy as np
+from pedalboard import Gain, Pedalboard
 from pedalboard_native._internal import FixedSizeBlockTestPlugin
 from .utils import generate_sine_at
 
@@ -31,3 +32,14 @@ def test_fixed_size_blocks_plugin(sample_rate, buffer_size, fixed_buffer_size, n
     plugin = FixedSizeBlockTestPlugin(fixed_buffer_size)
     output = plugin.process(signal, sample_rate, buffer_size=buffer_size)
     np.testing.assert_allclose(signal, output)
+
+
+@pytest.mark.parametrize("buffer_size", [160, 480, 1000, 8000])
+@pytest.mark.parametrize("num_channels", [1, 2])
+def test_fixed_size_blocks_plugin_in_chain(buffer_size, num_channels):
+    sample_rate = 44100
+    signal = generate_sine_at(sample_rate, num_seconds=1.0, num_channels=num_channels)
+
+    board = Pedalboard([Gain(6), FixedSizeBlockTestPlugin(160), Gain(-6)])
+    output = board.process(signal, sample_rate, buffer_size=buffer_size)
+    np.testing.assert_allclose(signal, output, atol=1e-6)
@@ -0,0 +1,95 @@
+#! /usr/bin/env python
+#
+# Copyright 2023 Spotify AB
+#
+# Licensed under the GNU Public License, Version 3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import numpy as np
+import pytest
+
+from pedalboard import (
+    Bitcrush,
+    Chain,
+    Clipping,
+    Compressor,
+    Delay,
+    Gain,
+    HighShelfFilter,
+    Invert,
+    Mix,
+    Pedalboard,
+    Reverb,
+)
+
+
+SAMPLE_RATE = 44100
+
+
+def make_audio(dtype, shape=(2, SAMPLE_RATE)):
+    return (np.random.default_rng(42).random(shape) - 0.5).astype(dtype)
+
+
+@pytest.mark.parametrize("dtype", [np.float32, np.float64])
+@pytest.mark.parametrize("shape", [(SAMPLE_RATE,), (2, SAMPLE_RATE), (SAMPLE_RATE, 2)])
+def test_output_dtype_matches_input(dtype, shape):
+    audio = make_audio(dtype, shape)
+    output = Pedalboard([Gain(-6), Reverb()])(audio, SAMPLE_RATE)
+    assert output.dtype == dtype
+    assert output.shape == audio.shape
+
+
+@pytest.mark.parametrize(
+    "board",
+    [
+        Gain(0),
+        Pedalboard([Invert(), Invert()]),
+        Chain([Gain(0), Clipping(threshold_db=20)]),
+    ],
+)
+def test_native_float64_plugins_do_not_lose_precision(board):
+    # All of these plugins are no-ops; processing them natively at 64-bit
+    # should return exactly the same values, which wouldn't fit in 32 bits:
+    audio = make_audio(np.float64)
+    output = board(audio, SAMPLE_RATE)
+    assert output.dtype == np.float64
+    np.testing.assert_array_equal(output, audio)
+
+
+def test_native_float64_mix_cancels_exactly():
+    audio = make_audio(np.float64)
+    output = Mix([Gain(0), Invert()])(audio, SAMPLE_RATE)
+    np.testing.assert_array_equal(output, np.zeros_like(audio))
+
+
+def test_float64_bitcrush():
+    audio = make_audio(np.float64)
+    output = Bitcrush(bit_depth=20)(audio, SAMPLE_RATE)
+    np.testing.assert_allclose(output, np.around(audio * 2**20) / 2**20, atol=1e-12)
+
+
+@pytest.mark.parametrize(
+    "plugin_factory",
+    [
+        lambda: Reverb(),
+        lambda: Compressor(threshold_db=-20, ratio=4),
+        lambda: Delay(delay_seconds=0.01, mix=0.5),
+        lambda: HighShelfFilter(cutoff_frequency_hz=2000, gain_db=6),
+    ],
+)
+def test_float32_only_plugins_accept_float64(plugin_factory):
+    audio = make_audio(np.float64)
+    expected = plugin_factory()(audio.astype(np.float32), SAMPLE_RATE)
+    output = plugin_factory()(audio, SAMPLE_RATE)
+    assert output.dtype == np.float64
+    np.testing.assert_allclose(output, expected, atol=1e-6)
@@ -39,6 +39,7 @@ SINE_WAVE_VOLUME = 0.9
         Resample.Quality.Lagrange,
         Resample.Quality.CatmullRom,
         Resample.Quality.WindowedSinc,
+        Resample.Quality.Polyphase,
     ],
 )
 @pytest.mark.parametrize("num_channels", [1, 2])
@@ -66,6 +67,7 @@ def test_gsm_compressor(
         Resample.Quality.Lagrange,
         Resample.Quality.CatmullRom,
         Resample.Quality.WindowedSinc,
+        Resample.Quality.Polyphase,
     ],
 )
 @pytest.mark.parametrize("num_channels", [1, 2])
@@ -0,0 +1,35 @@
+#! /usr/bin/env python
+#
+# Copyright 2023 Spotify AB
+#
+# Licensed under the GNU Public License, Version 3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import subprocess
+import sys
+
+import pytest
+
+# Modules that are only needed by rarely-used features, and which are expensive
+# enough to import that they shouldn't be loaded by `import pedalboard`:
+LAZILY_IMPORTED_MODULES = ["multiprocessing"]
+
+
+@pytest.mark.parametrize("module", ["pedalboard", "pedalboard.io"])
+def test_import_does_not_load_unused_modules(module: str):
+    script = (
+        f"import sys, {module}; "
+        f"print(','.join(m for m in {LAZILY_IMPORTED_MODULES!r} if m in sys.modules))"
+    )
+    output = subprocess.check_output([sys.executable, "-c", script], text=True)
+    assert output.strip() == ""
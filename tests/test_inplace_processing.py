@@ -0,0 +1,89 @@
+#! /usr/bin/env python
+#
+# Copyright 2023 Spotify AB
+#
+# Licensed under the GNU Public License, Version 3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import numpy as np
+import pytest
+
+from pedalboard import Compressor, Gain, Pedalboard, Reverb
+from pedalboard_native._internal import AddLatency
+
+
+SAMPLE_RATE = 44100
+
+
+def make_board():
+    return Pedalboard([Gain(-6), Compressor(threshold_db=-12, ratio=4), Reverb()])
+
+
+@pytest.mark.parametrize("shape", [(SAMPLE_RATE,), (1, SAMPLE_RATE), (2, SAMPLE_RATE)])
+@pytest.mark.parametrize("dtype", [np.float32, np.float64])
+def test_inplace_aliases_input(shape, dtype):
+    audio = np.random.rand(*shape).astype(dtype)
+    expected = make_board().process(audio, SAMPLE_RATE)
+
+    output = make_board().process(audio, SAMPLE_RATE, inplace=True)
+    assert output is audio
+    np.testing.assert_allclose(audio, expected, atol=1e-6)
+
+
+@pytest.mark.parametrize(
+    "audio",
+    [
+        # Interleaved audio can't be processed without copying:
+        np.random.rand(SAMPLE_RATE, 2).astype(np.float32),
+        # ...nor can non-contiguous audio:
+        np.random.rand(2, SAMPLE_RATE * 2).astype(np.float32)[:, ::2],
+        # ...nor can audio that isn't in native byte order:
+        np.random.rand(2, SAMPLE_RATE).astype(">f4"),
+        np.random.rand(2, SAMPLE_RATE).astype(">f8"),
+    ],
+)
+def test_inplace_falls_back_to_copying(audio: np.ndarray):
+    expected = make_board().process(audio, SAMPLE_RATE)
+
+    output = make_board().process(audio, SAMPLE_RATE, inplace=True)
+    assert output is audio
+    np.testing.assert_allclose(audio, expected, atol=1e-6)
+
+
+def test_inplace_with_latency():
+    audio = np.random.rand(2, SAMPLE_RATE).astype(np.float32)
+    plugin = Pedalboard([AddLatency(1000), Gain(-6)])
+    expected = plugin.process(audio, SAMPLE_RATE)
+
+    output = plugin.process(audio, SAMPLE_RATE, inplace=True)
+    assert output is audio
+    np.testing.assert_allclose(audio, expected, atol=1e-6)
+
+
+def test_inplace_with_latency_and_no_reset_returns_view():
+    audio = np.random.rand(2, SAMPLE_RATE).astype(np.float32)
+    plugin = AddLatency(1000)
+    expected = plugin.process(audio, SAMPLE_RATE, reset=False)
+
+    plugin.reset()
+    output = plugin.process(audio, SAMPLE_RATE, reset=False, inplace=True)
+    assert output.shape == expected.shape
+    assert np.shares_memory(output, audio)
+    np.testing.assert_allclose(output, expected, atol=1e-6)
+
+
+def test_inplace_rejects_read_only_arrays():
+    audio = np.random.rand(2, SAMPLE_RATE).astype(np.float32)
+    audio.flags.writeable = False
+    with pytest.raises(ValueError):
+        Gain(-6).process(audio, SAMPLE_RATE, inplace=True)
@@ -312,6 +312,93 @@ def test_read_from_seekable_stream(audio_filename: str, samplerate: float):
         af.read(1)
 
 
+class CountingBytesIO(io.BytesIO):
+    def __init__(self, *args, **kwargs):
+        super().__init__(*args, **kwargs)
+        self.read_calls = 0
+
+    def read(self, *args, **kwargs):
+        self.read_calls += 1
+        return super().read(*args, **kwargs)
+
+
+@pytest.mark.parametrize("extension", [".wav", ".flac", ".mp3"])
+def test_small_reads_from_file_like_are_buffered(extension: str):
+    audio_filename = [f for f in TEST_AUDIO_FILES[44100] if f.endswith(extension)][0]
+    with open(audio_filename, "rb") as f:
+        stream = CountingBytesIO(f.read())
+
+    with pedalboard.io.AudioFile(audio_filename) as af:
+        expected = af.read(af.frames)
+
+    with pedalboard.io.AudioFile(stream) as af:
+        chunks = [af.read(100) for _ in range(expected.shape[1] // 100 + 1)]
+    np.testing.assert_allclose(np.concatenate(chunks, axis=1), expected)
+
+    # Without buffering, each call to read(...) above would call into Python:
+    assert stream.read_calls < 20
+
+
+def test_bytes_io_is_not_locked_after_reading():
+    audio_filename = [f for f in TEST_AUDIO_FILES[44100] if f.endswith(".wav")][0]
+    with open(audio_filename, "rb") as f:
+        stream = io.BytesIO(f.read())
+
+    with pedalboard.io.AudioFile(stream) as af:
+        af.read(af.frames)
+        # No views of the BytesIO's buffer should be held between reads, so it
+        # can still be resized:
+        stream.seek(0, 2)
+        stream.write(b"\0" * 16)
+
+
+@pytest.mark.parametrize(
+    "audio_filename,samplerate",
+    [
+        (f, sr)
+        for f, sr in FILENAMES_AND_SAMPLERATES
+        if any(f.endswith(ext) for ext in (".wav", ".flac", ".mp3", ".ogg"))
+    ],
+)
+@pytest.mark.parametrize("buffer_type", [bytes, bytearray, memoryview, np.frombuffer])
+def test_read_from_buffer(audio_filename: str, samplerate: float, buffer_type):
+    with open(audio_filename, "rb") as f:
+        buffer = buffer_type(f.read())
+
+    with pedalboard.io.AudioFile(audio_filename) as af:
+        expected = af.read(af.frames)
+
+    with pedalboard.io.AudioFile(buffer) as af:
+        assert af.samplerate == samplerate
+        np.testing.assert_allclose(af.read(af.frames), expected)
+
+        af.seek(expected.shape[1] // 2)
+        np.testing.assert_allclose(af.read(100), expected[:, expected.shape[1] // 2 :][:, :100])
+
+    with pedalboard.io.ReadableAudioFile(buffer) as af:
+        np.testing.assert_allclose(af.read(af.frames), expected)
+
+
+def test_buffer_is_pinned_while_file_is_open():
+    audio_filename = [f for f in TEST_AUDIO_FILES[44100] if f.endswith(".wav")][0]
+    with open(audio_filename, "rb") as f:
+        buffer = bytearray(f.read())
+
+    with pedalboard.io.AudioFile(buffer) as af:
+        with pytest.raises(BufferError):
+            buffer.extend(b"\0" * 16)
+        assert af.read(1).shape == (1, 1)
+
+    # Once closed, the buffer should be released:
+    buffer.extend(b"\0" * 16)
+
+
+def test_read_from_empty_buffer_produces_helpful_error_message():
+    with pytest.raises(ValueError) as exc_info:
+        pedalboard.io.AudioFile(b"")
+    assert "is empty" in str(exc_info.value)
+
+
 @pytest.mark.parametrize(
     "mp3_filename",
     [f for f in sum(TEST_AUDIO_FILES.values(), []) if f.endswith("mp3")],
@@ -1143,6 +1230,49 @@ def test_mp3_duration_estimate(samplerate: float, target_samplerate: float, chun
         assert f.frames <= original_frame_estimate
 
 
+@pytest.mark.parametrize("samplerate", [44100, 32000])
+@pytest.mark.parametrize("quality", [128, 320])
+def test_mp3_compute_exact_duration(samplerate: float, quality: int):
+    buf = io.BytesIO()
+    buf.name = "output.mp3"
+
+    num_frames = int(samplerate * 5)
+    with pedalboard.io.AudioFile(buf, "w", samplerate, 2, quality=quality) as f:
+        f.write(np.random.rand(2, num_frames))
+
+    # Skip the VBR header to force Pedalboard to estimate length:
+    buf.seek(1044)
+
+    with pedalboard.io.AudioFile(buf) as f:
+        assert not f.exact_duration_known
+        f.read(1000)
+
+        exact_frames = f.compute_exact_duration()
+        assert f.exact_duration_known
+        assert f.frames == exact_frames
+        assert f.duration == exact_frames / samplerate
+        # Encoders add some padding, but each MP3 frame contains 1152 samples:
+        assert exact_frames % 1152 == 0
+        assert num_frames <= exact_frames <= num_frames + 3 * 1152
+
+        # Computing the duration shouldn't move the read position:
+        assert f.tell() == 1000
+        assert f.read(f.frames).shape[1] == exact_frames - 1000
+        assert f.compute_exact_duration() == exact_frames
+
+
+def test_compute_exact_duration_of_wav_is_frames():
+    buf = io.BytesIO()
+    buf.name = "output.wav"
+    with pedalboard.io.AudioFile(buf, "w", 44100, 1) as f:
+        f.write(np.zeros((1, 12345), dtype=np.float32))
+
+    buf.seek(0)
+    with pedalboard.io.AudioFile(buf) as f:
+        assert f.exact_duration_known
+        assert f.compute_exact_duration() == 12345
+
+
 @pytest.mark.parametrize("chunk_duration", [16, 1024, 2048, 1024 * 1024])
 @pytest.mark.parametrize(
     "granularity,max_num_frames",
@@ -1279,6 +1409,36 @@ def test_mp3_at_all_samplerates(quality: str, samplerate: float, num_channels: i
         assert np.amax(np.mean(af.read(samplerate * secs), axis=0)) < 0.01
 
 
+class CountingWritesBytesIO(io.BytesIO):
+    def __init__(self, *args, **kwargs):
+        super().__init__(*args, **kwargs)
+        self.write_calls = 0
+
+    def write(self, *args, **kwargs):
+        self.write_calls += 1
+        return super().write(*args, **kwargs)
+
+
+@pytest.mark.parametrize("extension", pedalboard.io.get_supported_write_formats())
+def test_small_writes_to_file_like_are_buffered(tmp_path: pathlib.Path, extension: str):
+    audio = generate_sine_at(44100, num_channels=2)
+    filename = str(tmp_path / f"output{extension}")
+    with pedalboard.io.AudioFile(filename, "w", 44100, 2) as af:
+        af.write(audio)
+
+    stream = CountingWritesBytesIO()
+    with pedalboard.io.AudioFile(stream, "w", 44100, 2, format=extension) as af:
+        af.write(audio)
+
+    stream.seek(0)
+    with pedalboard.io.AudioFile(filename) as expected, pedalboard.io.AudioFile(stream) as actual:
+        np.testing.assert_allclose(actual.read(actual.frames), expected.read(expected.frames))
+
+    # Encoders write many small chunks of data, which should be combined into
+    # only a handful of calls to write(...):
+    assert stream.write_calls < 20
+
+
 def test_useful_exception_when_writing_to_unseekable_file_like():
     """
     Sigh.
@@ -1315,3 +1475,520 @@ def test_useful_exception_when_writing_to_unseekable_file_like():
         with pedalboard.io.AudioFile(ILieAboutSeekability(), "w", 44100, 2) as f:
             f.write(np.random.rand(2, 44100))
     assert "What's a seek?" in str(e)
+
+
+@pytest.mark.parametrize("num_channels", [1, 2, 6])
+def test_memory_mapped_float32_wav_returns_views(tmp_path: pathlib.Path, num_channels: int):
+    filename = str(tmp_path / "float.wav")
+    audio = np.random.rand(num_channels, 44100).astype(np.float32)
+    with pedalboard.io.AudioFile(filename, "w", 44100, num_channels, bit_depth=32) as f:
+        f.write(audio)
+
+    with pedalboard.io.AudioFile(filename, memory_map=True) as f:
+        assert f.memory_mapped
+        first = f.read(1000)
+        rest = f.read(f.frames)
+        assert f.tell() == f.frames
+
+        f.seek(0)
+        again = f.read(1000)
+
+    # Views remain usable after the file is closed:
+    np.testing.assert_array_equal(first, audio[:, :1000])
+    np.testing.assert_array_equal(rest, audio[:, 1000:])
+    assert not first.flags.writeable
+    assert np.shares_memory(first, again)
+
+
+@pytest.mark.parametrize("extension", ["wav", "aiff"])
+@pytest.mark.parametrize("bit_depth", [16, 24])
+def test_memory_mapped_integer_files_match_regular_reads(
+    tmp_path: pathlib.Path, extension: str, bit_depth: int
+):
+    filename = str(tmp_path / f"int.{extension}")
+    audio = np.random.rand(2, 44100).astype(np.float32) - 0.5
+    with pedalboard.io.AudioFile(filename, "w", 44100, 2, bit_depth=bit_depth) as f:
+        f.write(audio)
+
+    with pedalboard.io.AudioFile(filename) as f:
+        expected = f.read(f.frames)
+
+    with pedalboard.io.AudioFile(filename, memory_map=True) as f:
+        assert f.memory_mapped
+        actual = f.read(f.frames)
+        assert actual.flags.writeable
+
+    np.testing.assert_array_equal(actual, expected)
+
+
+@pytest.mark.parametrize("extension", ["flac", "mp3", "ogg"])
+def test_memory_map_falls_back_for_compressed_files(extension: str):
+    filename = os.path.join(
+        os.path.dirname(__file__), "audio", "correct", f"mono_sine_at_44100Hz.{extension}"
+    )
+    with pedalboard.io.AudioFile(filename) as f:
+        expected = f.read(1000)
+
+    with pedalboard.io.AudioFile(filename, memory_map=True) as f:
+        assert not f.memory_mapped
+        np.testing.assert_array_equal(f.read(1000), expected)
+
+
+def write_read_many_fixtures(tmp_path: pathlib.Path, lengths, num_channels=(2,)):
+    filenames = []
+    expected = []
+    for i, length in enumerate(lengths):
+        channels = num_channels[i % len(num_channels)]
+        filename = str(tmp_path / f"file_{i}.wav")
+        audio = np.random.rand(channels, length).astype(np.float32) - 0.5
+        with pedalboard.io.AudioFile(filename, "w", 44100, channels, bit_depth=32) as f:
+            f.write(audio)
+        filenames.append(filename)
+        expected.append(audio)
+    return filenames, expected
+
+
+@pytest.mark.parametrize("num_workers", [None, 1, 3, 64])
+def test_read_many_matches_individual_reads(tmp_path: pathlib.Path, num_workers):
+    filenames, expected = write_read_many_fixtures(tmp_path, [1000, 44100, 1, 12345, 500])
+    results = pedalboard.io.read_many(filenames, num_workers=num_workers)
+    assert len(results) == len(expected)
+    for result, audio in zip(results, expected):
+        assert result.dtype == np.float32
+        np.testing.assert_array_equal(result, audio)
+
+
+def test_read_many_with_offsets_and_num_frames(tmp_path: pathlib.Path):
+    filenames, expected = write_read_many_fixtures(tmp_path, [1000, 2000, 3000])
+    results = pedalboard.io.read_many(filenames, offsets=[0, 500, 2900], num_frames=200)
+    np.testing.assert_array_equal(results[0], expected[0][:, :200])
+    np.testing.assert_array_equal(results[1], expected[1][:, 500:700])
+    # Reads past the end of a file return fewer frames:
+    np.testing.assert_array_equal(results[2], expected[2][:, 2900:])
+
+    results = pedalboard.io.read_many(filenames, num_frames=[10, 20, 30])
+    assert [r.shape[1] for r in results] == [10, 20, 30]
+
+
+def test_read_many_with_padding(tmp_path: pathlib.Path):
+    filenames, expected = write_read_many_fixtures(tmp_path, [1000, 300], num_channels=(2, 1))
+    result = pedalboard.io.read_many(filenames, pad=True)
+    assert result.shape == (2, 2, 1000)
+    np.testing.assert_array_equal(result[0], expected[0])
+    np.testing.assert_array_equal(result[1, :1, :300], expected[1])
+    assert not np.any(result[1, 1:])
+    assert not np.any(result[1, :, 300:])
+
+
+def test_read_many_errors(tmp_path: pathlib.Path):
+    filenames, _ = write_read_many_fixtures(tmp_path, [100, 100])
+    with pytest.raises(ValueError):
+        pedalboard.io.read_many(filenames, offsets=[0])
+    with pytest.raises(ValueError):
+        pedalboard.io.read_many(filenames, num_frames=[1, 2, 3])
+    with pytest.raises(ValueError):
+        pedalboard.io.read_many(filenames, num_workers=0)
+    with pytest.raises(Exception):
+        pedalboard.io.read_many(filenames + [str(tmp_path / "missing.wav")])
+
+
+def test_file_like_probing_with_misleading_extensions(tmp_path: pathlib.Path):
+    audio = np.random.rand(1, 1000).astype(np.float32) - 0.5
+    encoded = {}
+    for extension in ["wav", "flac", "aiff"]:
+        buf = io.BytesIO()
+        buf.name = f"original.{extension}"
+        with pedalboard.io.AudioFile(buf, "w", 44100, 1, bit_depth=16) as f:
+            f.write(audio)
+        encoded[extension] = buf.getvalue()
+
+    # Each format is remembered for file-likes with this (unknown) extension,
+    # but other formats must still be detected correctly afterwards:
+    for _ in range(2):
+        for extension, data in encoded.items():
+            stream = io.BytesIO(data)
+            stream.name = "audio.bin"
+            with pedalboard.io.AudioFile(stream) as f:
+                assert f.frames == 1000
+                np.testing.assert_allclose(f.read(f.frames), audio, atol=1e-4)
+
+
+@pytest.mark.parametrize("quality", ["V2", "128 kbps"])
+def test_mp3_seeking_is_consistent(tmp_path: pathlib.Path, quality: str):
+    filename = str(tmp_path / "long.mp3")
+    audio = generate_sine_at(44100, num_seconds=30, num_channels=2).astype(np.float32) * 0.5
+    with pedalboard.io.AudioFile(filename, "w", 44100, 2, quality=quality) as f:
+        f.write(audio)
+
+    positions = [44100 * 25, 1234, 44100 * 10 + 17, 0, 44100 * 29]
+    reads = []
+    for _ in range(2):
+        # The second time through, each file's seek table will be cached:
+        with pedalboard.io.AudioFile(filename) as f:
+            reads.append([])
+            for position in positions:
+                f.seek(position)
+                reads[-1].append(f.read(4096))
+
+    with open(filename, "rb") as stream:
+        with pedalboard.io.AudioFile(io.BytesIO(stream.read())) as f:
+            reads.append([])
+            for position in positions:
+                f.seek(position)
+                reads[-1].append(f.read(4096))
+
+    for first, second, from_stream in zip(*reads):
+        assert first.shape == (2, 4096)
+        np.testing.assert_array_equal(first, second)
+        np.testing.assert_array_equal(first, from_stream)
+
+
+def test_open_cached_matches_regular_reads(tmp_path: pathlib.Path):
+    filename = os.path.join(
+        os.path.dirname(__file__), "audio", "correct", "mono_sine_at_44100Hz.mp3"
+    )
+    cache_dir = tmp_path / "cache"
+
+    with pedalboard.io.AudioFile(filename) as f:
+        expected = f.read(f.frames)
+
+    with pedalboard.io.open_cached(filename, str(cache_dir)) as f:
+        assert f.memory_mapped
+        assert f.file_dtype == "float32"
+        assert f.name.startswith(str(cache_dir))
+        np.testing.assert_array_equal(f.read(f.frames), expected)
+
+    cache_files = sorted(os.listdir(cache_dir))
+    modification_times = [os.path.getmtime(cache_dir / name) for name in cache_files]
+
+    # Opening the file again should reuse the existing cache entry:
+    with pedalboard.io.open_cached(filename, str(cache_dir)) as f:
+        np.testing.assert_array_equal(f.read(f.frames), expected)
+    assert sorted(os.listdir(cache_dir)) == cache_files
+    assert [os.path.getmtime(cache_dir / name) for name in cache_files] == modification_times
+
+
+def test_open_cached_with_resampling(tmp_path: pathlib.Path):
+    filename = os.path.join(
+        os.path.dirname(__file__), "audio", "correct", "mono_sine_at_44100Hz.flac"
+    )
+    with pedalboard.io.AudioFile(filename).resampled_to(22050) as f:
+        expected = f.read(f.frames)
+
+    for _ in range(2):
+        with pedalboard.io.open_cached(filename, str(tmp_path), target_sample_rate=22050) as f:
+            assert f.samplerate == 22050
+            np.testing.assert_allclose(f.read(f.frames), expected, atol=1e-6)
+
+    # The original sample rate and the resampled version are cached separately:
+    with pedalboard.io.open_cached(filename, str(tmp_path)) as f:
+        assert f.samplerate == 44100
+    assert len([n for n in os.listdir(tmp_path) if n.endswith(".wav")]) == 2
+
+
+def test_open_cached_invalidates_modified_files(tmp_path: pathlib.Path):
+    filename = str(tmp_path / "source.flac")
+    cache_dir = str(tmp_path / "cache")
+    for value in [0.25, 0.5]:
+        with pedalboard.io.AudioFile(filename, "w", 44100, 1) as f:
+            f.write(np.full((1, 1000 if value == 0.25 else 2000), value, dtype=np.float32))
+        with pedalboard.io.open_cached(filename, cache_dir) as f:
+            np.testing.assert_allclose(f.read(f.frames), value, atol=1e-4)
+
+
+@pytest.mark.parametrize("num_channels", [1, 2])
+def test_flac_seeking_is_sample_accurate(tmp_path: pathlib.Path, num_channels: int):
+    filename = str(tmp_path / "long.flac")
+    audio = (np.random.rand(num_channels, 44100 * 20).astype(np.float32) - 0.5) * 0.5
+    with pedalboard.io.AudioFile(filename, "w", 44100, num_channels, bit_depth=24) as f:
+        f.write(audio)
+
+    with pedalboard.io.AudioFile(filename) as f:
+        expected = f.read(f.frames)
+
+    positions = [44100 * 15 + 3, 17, 44100 * 5, 4096, 4095, 44100 * 20 - 100, 0]
+
+    with open(filename, "rb") as stream:
+        data = stream.read()
+
+    for _ in range(2):
+        # The second time through, the frame index for this file will be cached:
+        for file_like in [filename, io.BytesIO(data)]:
+            with pedalboard.io.AudioFile(file_like) as f:
+                for position in positions:
+                    f.seek(position)
+                    np.testing.assert_array_equal(
+                        f.read(1000), expected[:, position : position + 1000]
+                    )
+
+
+@pytest.mark.parametrize("num_channels", [1, 2])
+@pytest.mark.parametrize("bit_depth", [16, 24])
+@pytest.mark.parametrize("quality", [None, 0, 8])
+def test_multithreaded_flac_encoding(
+    tmp_path: pathlib.Path, num_channels: int, bit_depth: int, quality: Optional[int]
+):
+    audio = (np.random.rand(num_channels, 44100 * 20).astype(np.float32) - 0.5) * 0.5
+
+    decoded = {}
+    for num_threads in [1, 4]:
+        filename = str(tmp_path / f"{num_threads}.flac")
+        with pedalboard.io.AudioFile(
+            filename,
+            "w",
+            44100,
+            num_channels,
+            bit_depth=bit_depth,
+            quality=quality,
+            num_threads=num_threads,
+        ) as f:
+            # Write in uneven chunks to cross segment boundaries mid-write:
+            for start in range(0, audio.shape[1], 100_000):
+                f.write(audio[:, start : start + 100_000])
+
+        with pedalboard.io.AudioFile(filename) as f:
+            assert f.frames == audio.shape[1]
+            decoded[num_threads] = f.read(f.frames)
+
+            # Seeking should work across renumbered frames:
+            for position in [44100 * 15 + 3, 4095, 44100 * 20 - 100, 0]:
+                f.seek(position)
+                np.testing.assert_array_equal(
+                    f.read(1000), decoded[num_threads][:, position : position + 1000]
+                )
+
+    # FLAC is lossless, so both files should decode to exactly the same audio:
+    np.testing.assert_array_equal(decoded[1], decoded[4])
+
+
+def test_multithreaded_flac_encoding_to_file_like():
+    audio = (np.random.rand(2, 44100 * 10).astype(np.float32) - 0.5) * 0.5
+    stream = io.BytesIO()
+    with pedalboard.io.AudioFile(stream, "w", 44100, 2, format="flac", num_threads=3) as f:
+        f.write(audio)
+
+    stream.seek(0)
+    with pedalboard.io.AudioFile(stream) as f:
+        np.testing.assert_allclose(f.read(f.frames), audio, atol=1e-4)
+
+
+def test_num_threads_must_be_positive(tmp_path: pathlib.Path):
+    with pytest.raises(ValueError):
+        pedalboard.io.AudioFile(str(tmp_path / "out.flac"), "w", 44100, 1, num_threads=0)
+
+
+@pytest.mark.parametrize("extension", [".flac", ".wav", ".aiff"])
+@pytest.mark.parametrize("bit_depth", [16, 24])
+@pytest.mark.parametrize("num_threads", [2, 3, 8])
+def test_parallel_read_matches_serial_read(
+    tmp_path: pathlib.Path, extension: str, bit_depth: int, num_threads: int
+):
+    filename = str(tmp_path / f"long{extension}")
+    audio = (np.random.rand(2, 44100 * 30).astype(np.float32) - 0.5) * 0.5
+    with pedalboard.io.AudioFile(filename, "w", 44100, 2, bit_depth=bit_depth) as f:
+        f.write(audio)
+
+    with pedalboard.io.AudioFile(filename) as f:
+        expected = f.read(f.frames)
+
+    with pedalboard.io.AudioFile(filename) as f:
+        # Start (and end) reads part of the way through frames:
+        f.seek(12345)
+        np.testing.assert_array_equal(
+            f.read(44100 * 20, num_threads=num_threads), expected[:, 12345 : 12345 + 44100 * 20]
+        )
+        assert f.tell() == 12345 + 44100 * 20
+
+        # Reads past the end of the file return as much audio as is available:
+        np.testing.assert_array_equal(
+            f.read(f.frames, num_threads=num_threads), expected[:, 12345 + 44100 * 20 :]
+        )
+        assert f.tell() == f.frames
+
+
+def test_parallel_read_num_threads_must_be_positive(tmp_path: pathlib.Path):
+    filename = str(tmp_path / "short.wav")
+    with pedalboard.io.AudioFile(filename, "w", 44100, 1) as f:
+        f.write(np.zeros((1, 100), dtype=np.float32))
+    with pedalboard.io.AudioFile(filename) as f:
+        with pytest.raises(ValueError):
+            f.read(100, num_threads=0)
+
+
+@pytest.mark.parametrize("bit_depth", [8, 16, 24, 32])
+@pytest.mark.parametrize("num_channels", [1, 2, 3])
+@pytest.mark.parametrize("input_format", [np.float32, np.float64, np.int8, np.int16, np.int32])
+def test_write_layouts_produce_identical_files(
+    tmp_path: pathlib.Path, bit_depth: int, num_channels: int, input_format
+):
+    audio = (np.random.rand(num_channels, 10_007) - 0.5) * 2.2
+    if np.issubdtype(input_format, np.signedinteger):
+        audio = np.clip(audio, -1, 1) * np.iinfo(input_format).max
+    audio = audio.astype(input_format)
+
+    raw = {}
+    for layout, samples in [("planar", audio), ("interleaved", np.ascontiguousarray(audio.T))]:
+        filename = str(tmp_path / f"{layout}.wav")
+        with pedalboard.io.AudioFile(filename, "w", 44100, num_channels, bit_depth) as f:
+            f.write(samples)
+        with pedalboard.io.AudioFile(filename) as f:
+            raw[layout] = f.read_raw(f.frames)
+    np.testing.assert_array_equal(raw["planar"], raw["interleaved"])
+
+    if input_format == np.float64:
+        # Double-precision audio should be written exactly like float32 audio:
+        filename = str(tmp_path / "float32.wav")
+        with pedalboard.io.AudioFile(filename, "w", 44100, num_channels, bit_depth) as f:
+            f.write(audio.astype(np.float32))
+        with pedalboard.io.AudioFile(filename) as f:
+            np.testing.assert_array_equal(f.read_raw(f.frames), raw["planar"])
+
+
+@pytest.mark.parametrize("interleaved", [False, True])
+def test_dither_preserves_quiet_signals(tmp_path: pathlib.Path, interleaved: bool):
+    # A signal a quarter of a 16-bit step above zero vanishes when truncated,
+    # but survives (on average) when dithered:
+    lsb = 1 / np.iinfo(np.int16).max
+    audio = np.full((2, 100_000), lsb / 4, dtype=np.float32)
+    if interleaved:
+        audio = np.ascontiguousarray(audio.T)
+
+    for dither in [False, True]:
+        filename = str(tmp_path / f"dither-{dither}.wav")
+        with pedalboard.io.AudioFile(filename, "w", 44100, 2, 16, dither=dither) as f:
+            f.write(audio)
+        with pedalboard.io.AudioFile(filename) as f:
+            written = f.read_raw(f.frames)
+
+        if dither:
+            assert np.abs(written).max() <= 1
+            np.testing.assert_allclose(written.mean(), 0.25, atol=0.02)
+        else:
+            assert not np.any(written)
+
+
+def test_dither_does_not_affect_float_files(tmp_path: pathlib.Path):
+    audio = np.random.rand(1, 1000).astype(np.float32) - 0.5
+    filename = str(tmp_path / "float.wav")
+    with pedalboard.io.AudioFile(filename, "w", 44100, 1, 32, dither=True) as f:
+        f.write(audio)
+    with pedalboard.io.AudioFile(filename) as f:
+        np.testing.assert_array_equal(f.read(f.frames), audio)
+
+
+@pytest.mark.parametrize("extension", ["wav", "flac"])
+@pytest.mark.parametrize("prefetch_frames", [1, 1000, 44100])
+def test_prefetching_matches_regular_reads(
+    tmp_path: pathlib.Path, extension: str, prefetch_frames: int
+):
+    filename = str(tmp_path / f"prefetch.{extension}")
+    audio = (np.random.rand(2, 44100 * 2).astype(np.float32) - 0.5) * 0.5
+    with pedalboard.io.AudioFile(filename, "w", 44100, 2) as f:
+        f.write(audio)
+
+    with pedalboard.io.AudioFile(filename) as f:
+        expected = f.read(f.frames)
+
+    with pedalboard.io.AudioFile(filename) as f:
+        assert f.prefetch_frames == 0
+        f.prefetch_frames = prefetch_frames
+        assert f.prefetch_frames == prefetch_frames
+
+        chunks = []
+        while f.tell() < f.frames:
+            chunk = f.read(1234)
+            assert f.tell() == sum(c.shape[1] for c in chunks) + chunk.shape[1]
+            chunks.append(chunk)
+            if not chunk.shape[1]:
+                break
+        np.testing.assert_array_equal(np.concatenate(chunks, axis=1), expected)
+
+        # Seeking discards any prefetched audio:
+        for position in [100, 50000, 0, 10]:
+            f.seek(position)
+            assert f.tell() == position
+            np.testing.assert_array_equal(f.read(2000), expected[:, position : position + 2000])
+            assert f.tell() == position + 2000
+
+        # Raw reads and disabling prefetching don't affect the read position:
+        f.seek(500)
+        f.read(100)
+        f.read_raw(100)
+        f.prefetch_frames = 0
+        np.testing.assert_array_equal(f.read(100), expected[:, 700:800])
+
+
+def test_prefetching_errors(tmp_path: pathlib.Path):
+    filename = str(tmp_path / "prefetch.wav")
+    with pedalboard.io.AudioFile(filename, "w", 44100, 1) as f:
+        f.write(np.zeros((1, 100), dtype=np.float32))
+
+    with pedalboard.io.AudioFile(filename) as f:
+        with pytest.raises(ValueError):
+            f.prefetch_frames = -1
+
+    with open(filename, "rb") as handle:
+        with pedalboard.io.AudioFile(handle) as f:
+            with pytest.raises(ValueError):
+                f.prefetch_frames = 1000
+            f.prefetch_frames = 0
+
+    # Closing a file stops prefetching:
+    f = pedalboard.io.AudioFile(filename)
+    f.prefetch_frames = 10
+    f.read(10)
+    f.close()
+    with pytest.raises(RuntimeError):
+        f.read(10)
+
+
+@pytest.mark.parametrize("num_channels", [1, 2])
+def test_read_into(tmp_path: pathlib.Path, num_channels: int):
+    filename = str(tmp_path / "read_into.flac")
+    audio = np.round((np.random.rand(num_channels, 20000) - 0.5) * 32767) / 32767
+    with pedalboard.io.AudioFile(filename, "w", 44100, num_channels, bit_depth=16) as f:
+        f.write(audio.astype(np.float32))
+
+    with pedalboard.io.AudioFile(filename) as f:
+        expected = f.read(f.frames)
+
+    with pedalboard.io.AudioFile(filename) as f:
+        # Channels-first output:
+        output = np.zeros((num_channels, 1000), dtype=np.float32)
+        assert f.read_into(output) == 1000
+        np.testing.assert_array_equal(output, expected[:, :1000])
+
+        # Interleaved output:
+        output = np.zeros((1000, num_channels), dtype=np.float32)
+        assert f.read_into(output) == 1000
+        np.testing.assert_array_equal(output, expected[:, 1000:2000].T)
+
+        # Strided views of larger arrays:
+        larger = np.zeros((num_channels * 2, 3000), dtype=np.float32)
+        assert f.read_into(larger[::2, ::3]) == 1000
+        np.testing.assert_array_equal(larger[::2, ::3], expected[:, 2000:3000])
+        assert not np.any(larger[1::2])
+
+        assert f.tell() == 3000
+
+        # Reading past the end of the file fills only part of the output:
+        f.seek(19500)
+        output = np.full((num_channels, 1000), 2.0, dtype=np.float32)
+        assert f.read_into(output) == 500
+        np.testing.assert_array_equal(output[:, :500], expected[:, 19500:])
+        assert np.all(output[:, 500:] == 2.0)
+
+        if num_channels == 1:
+            output = np.zeros(100, dtype=np.float32)
+            f.seek(0)
+            assert f.read_into(output) == 100
+            np.testing.assert_array_equal(output, expected[0, :100])
+
+        with pytest.raises(TypeError):
+            f.read_into(np.zeros((num_channels, 100), dtype=np.float64))
+        with pytest.raises(ValueError):
+            f.read_into(np.zeros((num_channels + 1, 100), dtype=np.float32))
+        read_only = np.zeros((num_channels, 100), dtype=np.float32)
+        read_only.setflags(write=False)
+        with pytest.raises(Exception):
+            f.read_into(read_only)
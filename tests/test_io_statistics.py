@@ -0,0 +1,150 @@
+#! /usr/bin/env python
+#
+# Copyright 2023 Spotify AB
+#
+# Licensed under the GNU Public License, Version 3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+from io import BytesIO
+
+import numpy as np
+import pytest
+
+from pedalboard.io import AudioFile, get_io_statistics, set_io_statistics_enabled
+
+EXPECTED_KEYS = {
+    "bytes_read",
+    "bytes_written",
+    "python_read_calls",
+    "python_seek_calls",
+    "python_tell_calls",
+    "python_write_calls",
+    "python_seconds",
+    "frames_decoded",
+    "decode_seconds",
+    "frames_encoded",
+    "encode_seconds",
+    "frames_resampled",
+    "resample_seconds",
+}
+
+SAMPLE_RATE = 44100
+NUM_FRAMES = SAMPLE_RATE
+
+
+@pytest.fixture
+def io_statistics():
+    set_io_statistics_enabled(True)
+    get_io_statistics(reset=True)
+    try:
+        yield
+    finally:
+        set_io_statistics_enabled(False)
+
+
+def write_wav(buffer: BytesIO) -> None:
+    audio = np.random.rand(2, NUM_FRAMES).astype(np.float32) * 0.5
+    with AudioFile(buffer, "w", SAMPLE_RATE, num_channels=2, format="wav") as f:
+        f.write(audio)
+
+
+def test_nothing_is_collected_when_disabled():
+    buffer = BytesIO()
+    write_wav(buffer)
+    buffer.seek(0)
+    with AudioFile(buffer) as f:
+        f.read(f.frames)
+        stats = f.stats()
+    assert set(stats.keys()) == EXPECTED_KEYS
+    assert all(value == 0 for value in stats.values())
+
+
+def test_reading_from_file_like(io_statistics):
+    buffer = BytesIO()
+    write_wav(buffer)
+    buffer.seek(0)
+    with AudioFile(buffer) as f:
+        f.read(f.frames)
+        stats = f.stats()
+
+    assert stats["frames_decoded"] == NUM_FRAMES
+    assert stats["decode_seconds"] > 0
+    assert stats["python_read_calls"] > 0
+    assert stats["bytes_read"] >= NUM_FRAMES * 2 * 2
+    assert stats["python_seconds"] > 0
+    assert stats["bytes_written"] == 0
+    assert stats["frames_encoded"] == 0
+
+    totals = get_io_statistics()
+    assert set(totals["WAV file"].keys()) == EXPECTED_KEYS
+    assert totals["WAV file"]["frames_decoded"] == NUM_FRAMES
+    assert totals["WAV file"]["bytes_read"] == stats["bytes_read"]
+
+
+def test_reading_from_disk_counts_no_python_calls(io_statistics, tmp_path):
+    filename = str(tmp_path / "test.wav")
+    with AudioFile(filename, "w", SAMPLE_RATE, num_channels=2) as f:
+        f.write(np.zeros((2, NUM_FRAMES), dtype=np.float32))
+
+    with AudioFile(filename) as f:
+        f.read(f.frames)
+        stats = f.stats()
+
+    assert stats["frames_decoded"] == NUM_FRAMES
+    assert stats["bytes_read"] == 0
+    assert stats["python_read_calls"] == 0
+
+
+def test_writing_to_file_like(io_statistics):
+    buffer = BytesIO()
+    f = AudioFile(buffer, "w", SAMPLE_RATE, num_channels=2, format="wav")
+    f.write(np.zeros((2, NUM_FRAMES), dtype=np.float32))
+    f.close()
+    stats = f.stats()
+
+    assert stats["frames_encoded"] == NUM_FRAMES
+    assert stats["encode_seconds"] > 0
+    assert stats["python_write_calls"] > 0
+    # WAV headers are rewritten when closing, so some bytes are written twice:
+    assert stats["bytes_written"] >= len(buffer.getvalue())
+    assert stats["frames_decoded"] == 0
+
+    assert get_io_statistics()["WAV file"]["frames_encoded"] == NUM_FRAMES
+
+
+def test_resampling_shares_statistics(io_statistics):
+    buffer = BytesIO()
+    write_wav(buffer)
+    buffer.seek(0)
+    with AudioFile(buffer) as source:
+        with source.resampled_to(SAMPLE_RATE / 2) as f:
+            num_frames = f.read(f.frames).shape[-1]
+            assert f.stats() == source.stats()
+            stats = f.stats()
+
+    assert stats["frames_resampled"] == num_frames
+    assert stats["resample_seconds"] > 0
+    assert 0 < stats["frames_decoded"] <= NUM_FRAMES
+
+
+def test_reset(io_statistics):
+    buffer = BytesIO()
+    write_wav(buffer)
+    buffer.seek(0)
+    with AudioFile(buffer) as f:
+        f.read(f.frames)
+        assert f.stats(reset=True)["frames_decoded"] == NUM_FRAMES
+        assert f.stats()["frames_decoded"] == 0
+
+    assert get_io_statistics(reset=True)["WAV file"]["frames_decoded"] == NUM_FRAMES
+    assert get_io_statistics()["WAV file"]["frames_decoded"] == 0
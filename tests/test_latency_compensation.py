@@ -17,6 +17,7 @@
 
 import pytest
 import numpy as np
+from pedalboard import Gain, Pedalboard, process, set_profiling_enabled
 from pedalboard_native._internal import AddLatency
 
 
@@ -29,3 +30,36 @@ def test_latency_compensation(sample_rate, buffer_size, latency_seconds):
     plugin = AddLatency(int(latency_seconds * sample_rate))
     output = plugin.process(noise, sample_rate, buffer_size=buffer_size)
     np.testing.assert_allclose(output, noise)
+
+
+@pytest.mark.parametrize("buffer_size", [1, 128, 1000, 8192])
+def test_latency_compensation_across_plugins(buffer_size):
+    # Each block is run through every plugin in turn before the next block is
+    # read; latency from earlier plugins must still be compensated for.
+    sample_rate = 44100
+    noise = np.random.rand(2, sample_rate).astype(np.float32)
+    plugins = [AddLatency(1000), Gain(6), AddLatency(333), Gain(-6)]
+    output = process(noise, sample_rate, plugins, buffer_size=buffer_size)
+    assert output.shape == noise.shape
+    np.testing.assert_allclose(output, noise, rtol=1e-5, atol=1e-6)
+
+
+@pytest.mark.parametrize("buffer_size", [128, 8192])
+@pytest.mark.parametrize("inplace", [False, True])
+def test_output_buffer_is_not_reallocated(buffer_size: int, inplace: bool):
+    # The output buffer is allocated with room for each plugin's latency hint
+    # up front, so accurate hints mean it never needs to be grown:
+    sample_rate = 44100
+    noise = np.random.rand(2, sample_rate).astype(np.float32)
+    expected = noise.copy()
+    board = Pedalboard([AddLatency(1000), Gain(6), AddLatency(333), Gain(-6)])
+
+    set_profiling_enabled(True)
+    try:
+        output = board.process(noise, sample_rate, buffer_size=buffer_size, inplace=inplace)
+    finally:
+        set_profiling_enabled(False)
+
+    np.testing.assert_allclose(output, expected, rtol=1e-5, atol=1e-6)
+    profile = board.profile(reset=True)
+    assert sum(stats["reallocations"] for stats in profile.values()) == 0
@@ -16,6 +16,7 @@
 
 
 import random
+import time
 import pytest
 from concurrent.futures import ThreadPoolExecutor
 
@@ -64,3 +65,50 @@ def test_multiple_threads_using_same_plugin_instances(
     first_result = processed[0]
     for other_result in processed[1:]:
         assert np.allclose(first_result, other_result)
+
+
+def test_container_can_be_read_during_render():
+    """
+    Reading a Pedalboard's list of plugins (or their parameters) should not
+    have to wait for a long render on another thread to finish.
+    """
+    sr = 48000
+    board = pedalboard.Pedalboard([pedalboard.Gain(-6), pedalboard.Reverb()])
+    noise = np.random.rand(2, sr * 120).astype(np.float32)
+
+    with ThreadPoolExecutor(max_workers=1) as e:
+        render = e.submit(board.process, noise, sample_rate=sr)
+        while not render.running():
+            time.sleep(0.001)
+        # Give the render a moment to actually start processing:
+        time.sleep(0.05)
+
+        start = time.time()
+        for _ in range(100):
+            assert len(board) == 2
+            assert board[0].gain_db == -6
+            assert board[-1] in board
+            repr(board)
+        reads_finished_during_render = not render.done()
+        time_taken = time.time() - start
+        render.result()
+
+    assert reads_finished_during_render, f"Reads took {time_taken:.2f}s, blocking on the render."
+
+
+def test_container_modification_waits_for_render():
+    sr = 48000
+    board = pedalboard.Pedalboard([pedalboard.Gain(-6)])
+    noise = np.random.rand(2, sr * 30).astype(np.float32)
+    expected = pedalboard.Gain(-6)(noise, sr)
+
+    with ThreadPoolExecutor(max_workers=1) as e:
+        render = e.submit(board.process, noise, sample_rate=sr)
+        while not render.running():
+            time.sleep(0.001)
+        board.append(pedalboard.Gain(-6))
+        output = render.result()
+
+    # The render should have used either one or both plugins - never a mix:
+    assert np.allclose(output, expected) or np.allclose(output, pedalboard.Gain(-12)(noise, sr))
+    assert len(board) == 2
@@ -0,0 +1,125 @@
+#! /usr/bin/env python
+#
+# Copyright 2023 Spotify AB
+#
+# Licensed under the GNU Public License, Version 3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import numpy as np
+import pytest
+
+from pedalboard import Gain, LoudnessMeter, Pedalboard
+
+from .utils import db_to_gain
+
+
+def sine(sample_rate: float, hz: float, num_seconds: float, phase: float = 0.0) -> np.ndarray:
+    t = np.arange(int(sample_rate * num_seconds)) / sample_rate
+    return np.sin(2 * np.pi * hz * t + phase).astype(np.float32)
+
+
+@pytest.mark.parametrize("sample_rate", [44100, 48000])
+def test_full_scale_sine_is_minus_three_lufs(sample_rate: int):
+    meter = LoudnessMeter()
+    audio = sine(sample_rate, 997, 10)
+    output = meter(audio, sample_rate)
+
+    # The meter should not change the audio passing through it:
+    np.testing.assert_array_equal(output, audio)
+
+    assert meter.integrated_loudness == pytest.approx(-3.01, abs=0.05)
+    assert meter.momentary_loudness == pytest.approx(-3.01, abs=0.05)
+    assert meter.short_term_loudness == pytest.approx(-3.01, abs=0.05)
+    assert meter.max_momentary_loudness == pytest.approx(-3.01, abs=0.05)
+    assert meter.max_short_term_loudness == pytest.approx(-3.01, abs=0.05)
+    assert meter.true_peak == pytest.approx(0.0, abs=0.05)
+
+
+@pytest.mark.parametrize("level_db", [-10, -23, -40])
+def test_stereo_sine_loudness_matches_level(level_db: float):
+    # Per EBU Tech 3341, a stereo 1kHz sine at -23 dBFS measures -23 LUFS:
+    sample_rate = 48000
+    audio = np.stack([sine(sample_rate, 1000, 20)] * 2) * db_to_gain(level_db)
+    meter = LoudnessMeter()
+    meter(audio, sample_rate)
+    assert meter.integrated_loudness == pytest.approx(level_db, abs=0.1)
+
+
+def test_silence_is_gated():
+    sample_rate = 48000
+    tone = sine(sample_rate, 1000, 5) * db_to_gain(-20)
+
+    meter = LoudnessMeter()
+    meter(tone, sample_rate)
+    expected = meter.integrated_loudness
+
+    meter(np.concatenate([tone, np.zeros(sample_rate * 5, dtype=np.float32)]), sample_rate)
+    assert meter.integrated_loudness == pytest.approx(expected, abs=0.05)
+    assert meter.momentary_loudness < -70
+
+    meter(np.zeros(sample_rate * 5, dtype=np.float32), sample_rate)
+    assert meter.integrated_loudness == float("-inf")
+    assert meter.true_peak == float("-inf")
+
+
+def test_short_term_loudness_needs_three_seconds():
+    sample_rate = 48000
+    meter = LoudnessMeter()
+    meter(sine(sample_rate, 1000, 2), sample_rate)
+    assert meter.short_term_loudness == float("-inf")
+    assert meter.momentary_loudness > -4
+
+
+def test_true_peak_finds_intersample_peaks():
+    # A sine at a quarter of the sample rate, sampled 45 degrees away from its
+    # peaks, has a sample peak 3dB lower than its true peak:
+    sample_rate = 48000
+    audio = sine(sample_rate, sample_rate / 4, 1, phase=np.pi / 4)
+    assert 20 * np.log10(np.amax(np.abs(audio))) == pytest.approx(-3.01, abs=0.01)
+
+    meter = LoudnessMeter()
+    meter(audio, sample_rate)
+    assert meter.true_peak == pytest.approx(0.0, abs=0.1)
+
+
+@pytest.mark.parametrize("chunk_size", [1, 1000, 4800, 12345])
+def test_chunked_measurement_matches_single_pass(chunk_size: int):
+    sample_rate = 48000
+    rng = np.random.default_rng(1234)
+    audio = rng.standard_normal((2, sample_rate * 5)).astype(np.float32) * 0.1
+    if chunk_size == 1:
+        audio = audio[:, : sample_rate // 2]
+
+    expected = LoudnessMeter()
+    expected(audio, sample_rate)
+
+    meter = LoudnessMeter()
+    for i in range(0, audio.shape[1], chunk_size):
+        meter(audio[:, i : i + chunk_size], sample_rate, reset=i == 0)
+
+    assert meter.integrated_loudness == pytest.approx(expected.integrated_loudness, abs=1e-4)
+    assert meter.momentary_loudness == pytest.approx(expected.momentary_loudness, abs=1e-4)
+    assert meter.true_peak == pytest.approx(expected.true_peak, abs=1e-4)
+
+
+def test_meter_in_pedalboard_measures_output():
+    sample_rate = 48000
+    audio = sine(sample_rate, 1000, 5) * db_to_gain(-30)
+    meter = LoudnessMeter()
+    board = Pedalboard([Gain(gain_db=10), meter])
+    board(audio, sample_rate)
+    assert meter.integrated_loudness == pytest.approx(-23.0, abs=0.1)
+
+    # float64 audio should measure the same:
+    board(audio.astype(np.float64), sample_rate)
+    assert meter.integrated_loudness == pytest.approx(-23.0, abs=0.1)
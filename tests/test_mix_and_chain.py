@@ -19,12 +19,20 @@ import pytest
 import numpy as np
 from pedalboard import (
     Pedalboard,
+    Bitcrush,
+    Clipping,
     Compressor,
     Delay,
     Distortion,
     Gain,
+    HighpassFilter,
+    Invert,
+    Limiter,
+    LowpassFilter,
     Mix,
     Chain,
+    FrozenChain,
+    PeakFilter,
     PitchShift,
     Reverb,
 )
@@ -309,3 +317,198 @@ def test_none_as_argument(cls):
     noise = np.random.rand(int(NUM_SECONDS * sample_rate))
     output = container(noise, sample_rate)
     np.testing.assert_allclose(noise, output)
+
+
+def make_branches():
+    return [
+        Chain([Gain(-3), Reverb(room_size=0.8)]),
+        Chain([Delay(delay_seconds=0.1, mix=0.5), Distortion(drive_db=12)]),
+        Chain([Compressor(threshold_db=-20), Gain(-6)]),
+        AddLatency(1000),
+    ]
+
+
+@pytest.mark.parametrize("buffer_size", [128, 8192, 65536])
+def test_parallel_mix_matches_serial_mix(buffer_size):
+    sr = 44100
+    noise = np.random.rand(2, NUM_SECONDS * sr).astype(np.float32)
+
+    serial = Mix(make_branches())(noise, sr, buffer_size=buffer_size)
+    parallel_mix = Mix(make_branches(), parallel=True)
+    assert parallel_mix.parallel
+    parallel = parallel_mix(noise, sr, buffer_size=buffer_size)
+
+    # Each branch is processed independently, so results should be identical:
+    np.testing.assert_array_equal(serial, parallel)
+
+
+def test_parallel_mix_can_be_toggled():
+    sr = 44100
+    noise = np.random.rand(2, sr).astype(np.float32)
+    mix = Mix(make_branches())
+    expected = mix(noise, sr)
+
+    mix.parallel = True
+    np.testing.assert_array_equal(mix(noise, sr), expected)
+    assert "parallel=True" in repr(mix)
+
+    mix.parallel = False
+    np.testing.assert_array_equal(mix(noise, sr), expected)
+
+
+@pytest.mark.parametrize("buffer_size", [1, 77, 1000, 1013])
+@pytest.mark.parametrize("dtype", [np.float32, np.float64])
+def test_mix_latency_compensation_with_uneven_buffer_sizes(buffer_size, dtype):
+    # Buffer sizes that don't evenly divide the branches' latencies cause each
+    # branch's buffered output to wrap around in memory:
+    sr = 44100
+    noise = np.random.rand(2, sr // 4).astype(dtype)
+    mix = Mix([AddLatency(1000), AddLatency(333), Gain(0)])
+    output = mix(noise, sr, buffer_size=buffer_size)
+    np.testing.assert_allclose(output, noise * 3, rtol=1e-6)
+
+
+def make_sample_wise_plugins():
+    return [
+        Gain(6),
+        Invert(),
+        Clipping(-3),
+        Compressor(threshold_db=-12, ratio=4),
+        AddLatency(100),
+        Bitcrush(12),
+        Limiter(),
+        Reverb(),
+        Gain(-3),
+    ]
+
+
+@pytest.mark.parametrize("buffer_size", [1, 100, 8192, 65536])
+@pytest.mark.parametrize("dtype", [np.float32, np.float64])
+def test_fused_chain_matches_unfused_chain(buffer_size, dtype):
+    sr = 44100
+    noise = (np.random.rand(2, sr) - 0.5).astype(dtype)
+
+    expected = Chain(make_sample_wise_plugins())(noise, sr, buffer_size=buffer_size)
+    fused = Chain(make_sample_wise_plugins(), fused=True)
+    assert fused.fused
+    assert "fused=True" in repr(fused)
+    np.testing.assert_array_equal(fused(noise, sr, buffer_size=buffer_size), expected)
+
+
+@pytest.mark.parametrize("buffer_size", [100, 8192])
+def test_fused_chain_with_filters(buffer_size):
+    sr = 44100
+    noise = (np.random.rand(2, sr) - 0.5).astype(np.float32)
+
+    def make_plugins():
+        return [Gain(6), HighpassFilter(100), Compressor(-20), LowpassFilter(5000), Limiter()]
+
+    expected = Pedalboard(make_plugins())(noise, sr, buffer_size=buffer_size)
+    board = Pedalboard(make_plugins(), fused=True)
+    np.testing.assert_allclose(board(noise, sr, buffer_size=buffer_size), expected, atol=1e-6)
+
+    board.fused = False
+    np.testing.assert_array_equal(board(noise, sr, buffer_size=buffer_size), expected)
+
+
+@pytest.mark.parametrize("buffer_size", [1, 100, 8192])
+@pytest.mark.parametrize("dtype", [np.float32, np.float64])
+def test_pipelined_chain_matches_chain(buffer_size, dtype):
+    sr = 44100
+    noise = (np.random.rand(2, sr) - 0.5).astype(dtype)
+
+    def make_plugins():
+        return [
+            Gain(6),
+            AddLatency(1000),
+            Reverb(),
+            HighpassFilter(100),
+            Compressor(-20),
+            AddLatency(333),
+            Chain([Delay(0.01), AddLatency(10)]),
+            Limiter(),
+        ]
+
+    expected = Pedalboard(make_plugins())(noise, sr, buffer_size=buffer_size)
+    board = Pedalboard(make_plugins(), pipelined=True)
+    assert board.pipelined
+    assert "pipelined=True" in repr(Chain([], pipelined=True))
+    np.testing.assert_array_equal(board(noise, sr, buffer_size=buffer_size), expected)
+
+    # Nested pipelined chains are flattened into one pipeline:
+    nested = Pedalboard([Chain(make_plugins()[:4], pipelined=True), *make_plugins()[4:]])
+    np.testing.assert_array_equal(nested(noise, sr, buffer_size=buffer_size), expected)
+
+
+def test_pipelined_chain_streaming():
+    # Streaming (reset=False) calls aren't pipelined, but still work:
+    sr = 44100
+    noise = (np.random.rand(2, sr) - 0.5).astype(np.float32)
+    board = Pedalboard([Gain(-6), Reverb(), Delay(0.01)], pipelined=True)
+    expected = Pedalboard([Gain(-6), Reverb(), Delay(0.01)])
+
+    for chunk in np.split(noise, 4, axis=1):
+        np.testing.assert_array_equal(
+            board(chunk, sr, reset=False), expected(chunk, sr, reset=False)
+        )
+
+
+def make_frozen_chain_plugins():
+    return [
+        Gain(3),
+        HighpassFilter(200),
+        Compressor(threshold_db=-12),
+        PeakFilter(1000, gain_db=6),
+        Clipping(-3),
+        Bitcrush(12),
+        Invert(),
+        Limiter(),
+        LowpassFilter(5000),
+    ]
+
+
+@pytest.mark.parametrize("buffer_size", [1, 32, 128, 8192])
+def test_frozen_chain_matches_chain(buffer_size: int):
+    sr = 44100
+    noise = np.random.rand(2, sr).astype(np.float32) - 0.5
+    expected = Pedalboard(make_frozen_chain_plugins())(noise, sr, buffer_size=buffer_size)
+
+    frozen = Pedalboard(make_frozen_chain_plugins()).freeze()
+    assert isinstance(frozen, FrozenChain)
+    np.testing.assert_allclose(frozen(noise, sr, buffer_size=buffer_size), expected, atol=1e-6)
+
+
+def test_frozen_chain_shares_plugins():
+    gain = Gain(0)
+    frozen = Pedalboard([gain]).freeze()
+    assert frozen[0] is gain
+
+    noise = np.random.rand(1, 1000).astype(np.float32)
+    gain.gain_db = -6
+    np.testing.assert_allclose(frozen(noise, 44100), noise * 0.5, rtol=1e-2)
+
+
+def test_frozen_chain_supports_automation():
+    sr = 44100
+    noise = np.random.rand(1, sr).astype(np.float32)
+    ramp = np.linspace(-12, 0, sr)
+
+    gain = Gain()
+    gain.automate("gain_db", ramp)
+    expected = Pedalboard([gain])(noise, sr)
+
+    frozen_gain = Gain()
+    frozen_gain.automate("gain_db", ramp)
+    np.testing.assert_allclose(FrozenChain([frozen_gain])(noise, sr), expected, atol=1e-6)
+
+
+def test_frozen_chain_rejects_unsupported_plugins():
+    with pytest.raises(ValueError):
+        Pedalboard([Gain(), Reverb()]).freeze()
+    with pytest.raises(ValueError):
+        FrozenChain([Chain([Gain()])])
+
+    frozen = FrozenChain([Gain()])
+    frozen.append(Reverb())
+    with pytest.raises(ValueError):
+        frozen(np.random.rand(1, 1000).astype(np.float32), 44100)
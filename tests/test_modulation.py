@@ -0,0 +1,90 @@
+#! /usr/bin/env python
+#
+# Copyright 2023 Spotify AB
+#
+# Licensed under the GNU Public License, Version 3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import numpy as np
+import pytest
+
+from pedalboard import Chorus, Phaser
+from pedalboard_native._internal import JuceChorus, JucePhaser
+
+
+def noise(
+    num_channels: int, sample_rate: float, num_seconds: float = 1, seed: int = 1234
+) -> np.ndarray:
+    rng = np.random.default_rng(seed)
+    return rng.uniform(-1, 1, (num_channels, int(sample_rate * num_seconds))).astype(np.float32)
+
+
+@pytest.mark.parametrize("sample_rate", [22050, 48000])
+@pytest.mark.parametrize("num_channels", [1, 2, 3])
+@pytest.mark.parametrize(
+    "kwargs",
+    [
+        {},
+        {"rate_hz": 3, "depth": 0.8, "centre_delay_ms": 2, "feedback": 0.7, "mix": 1.0},
+        {"rate_hz": 0.2, "depth": 1.0, "centre_delay_ms": 30, "feedback": -0.5, "mix": 0.3},
+        {"rate_hz": 10, "depth": 0.1, "centre_delay_ms": 0.5},
+    ],
+)
+def test_chorus_matches_juce(sample_rate, num_channels, kwargs):
+    audio = noise(num_channels, sample_rate)
+    expected = JuceChorus(**kwargs)(audio, sample_rate)
+    np.testing.assert_allclose(Chorus(**kwargs)(audio, sample_rate), expected, atol=1e-6)
+
+
+@pytest.mark.parametrize("sample_rate", [22050, 48000])
+@pytest.mark.parametrize("num_channels", [1, 2, 3])
+@pytest.mark.parametrize(
+    "kwargs",
+    [
+        {},
+        {"rate_hz": 5, "depth": 0.9, "centre_frequency_hz": 400, "feedback": 0.8, "mix": 0.7},
+        {"rate_hz": 0.3, "depth": 0.2, "centre_frequency_hz": 5000, "feedback": -0.6, "mix": 1.0},
+    ],
+)
+def test_phaser_matches_juce(sample_rate, num_channels, kwargs):
+    audio = noise(num_channels, sample_rate)
+    expected = JucePhaser(**kwargs)(audio, sample_rate)
+    np.testing.assert_allclose(Phaser(**kwargs)(audio, sample_rate), expected, atol=1e-6)
+
+
+@pytest.mark.parametrize("buffer_size", [1, 3, 100, 8192])
+@pytest.mark.parametrize(
+    "plugin_class,reference_class,changes",
+    [
+        (Chorus, JuceChorus, {"rate_hz": 4, "feedback": 0.5, "mix": 0.9}),
+        (Phaser, JucePhaser, {"rate_hz": 4, "depth": 0.1, "feedback": -0.5, "mix": 0.9}),
+    ],
+)
+def test_parameter_changes_while_streaming_match_juce(
+    buffer_size, plugin_class, reference_class, changes
+):
+    # Changing parameters between calls with reset=False smooths them over
+    # the following 50ms; the new implementations should smooth identically:
+    sample_rate = 44100
+    audio = noise(2, sample_rate, num_seconds=0.5)
+    half = audio.shape[1] // 2
+
+    outputs = []
+    for plugin in (plugin_class(), reference_class()):
+        first_half = plugin(audio[:, :half], sample_rate, buffer_size=buffer_size)
+        for name, value in changes.items():
+            setattr(plugin, name, value)
+        second_half = plugin(audio[:, half:], sample_rate, buffer_size=buffer_size, reset=False)
+        outputs.append(np.concatenate([first_half, second_half], axis=1))
+
+    np.testing.assert_allclose(outputs[0], outputs[1], atol=1e-6)
@@ -90,3 +90,56 @@ def test_mp3_compressor_fails_on_invalid_sample_rate(sample_rate: int, num_chann
 
     with pytest.raises(ValueError):
         MP3Compressor(1)(sine_wave, sample_rate)
+
+
+@pytest.mark.parametrize("sample_rate", [44100, 48000])
+@pytest.mark.parametrize("num_channels", [1, 2])
+def test_mp3_compressor_reuses_encoders_without_leaking_audio(
+    sample_rate: int, num_channels: int
+):
+    sine_wave = generate_sine_at(sample_rate, num_seconds=1.0, num_channels=num_channels)
+    noise = np.random.rand(*sine_wave.shape) * 2 - 1
+    silence = np.zeros_like(sine_wave)
+
+    plugin = MP3Compressor(2, reuse_encoders=True)
+    for _ in range(3):
+        # Encoders are reused between calls, so each call must start with a
+        # clean stream, with the same latency compensation as a new encoder:
+        plugin(noise, sample_rate)
+        np.testing.assert_allclose(plugin(silence, sample_rate), silence, atol=1e-3)
+        np.testing.assert_allclose(
+            plugin(sine_wave, sample_rate), sine_wave, atol=MP3_ABSOLUTE_TOLERANCE
+        )
+        np.testing.assert_allclose(
+            MP3Compressor(2, reuse_encoders=True)(sine_wave, sample_rate),
+            sine_wave,
+            atol=MP3_ABSOLUTE_TOLERANCE,
+        )
+
+
+@pytest.mark.parametrize("sample_rate", [44100, 48000])
+@pytest.mark.parametrize("num_channels", [1, 2])
+def test_mp3_compressor_is_deterministic_by_default(sample_rate: int, num_channels: int):
+    sine_wave = generate_sine_at(sample_rate, num_seconds=1.0, num_channels=num_channels)
+    noise = np.random.rand(*sine_wave.shape) * 2 - 1
+
+    expected = MP3Compressor(2)(sine_wave, sample_rate)
+
+    plugin = MP3Compressor(2)
+    for _ in range(3):
+        plugin(noise, sample_rate)
+        assert np.array_equal(plugin(sine_wave, sample_rate), expected)
+
+    # Other plugins returning encoders to the pool must not affect the default:
+    MP3Compressor(2, reuse_encoders=True)(noise, sample_rate)
+    assert np.array_equal(MP3Compressor(2)(sine_wave, sample_rate), expected)
+
+
+def test_mp3_compressor_reuse_encoders_property():
+    plugin = MP3Compressor(2)
+    assert not plugin.reuse_encoders
+    assert "reuse_encoders=False" in repr(plugin)
+
+    plugin.reuse_encoders = True
+    assert plugin.reuse_encoders
+    assert "reuse_encoders=True" in repr(plugin)
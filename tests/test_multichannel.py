@@ -0,0 +1,106 @@
+#! /usr/bin/env python
+#
+# Copyright 2023 Spotify AB
+#
+# Licensed under the GNU Public License, Version 3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import os
+
+import numpy as np
+import pytest
+
+from pedalboard import (
+    Chain,
+    Chorus,
+    Compressor,
+    Convolution,
+    Delay,
+    Gain,
+    HighpassFilter,
+    LadderFilter,
+    Mix,
+    Pedalboard,
+    Phaser,
+    Reverb,
+)
+
+
+SAMPLE_RATE = 44100
+IMPULSE_RESPONSE_PATH = os.path.join(os.path.dirname(__file__), "impulse_response.wav")
+
+
+def make_audio(num_channels: int, num_samples: int = SAMPLE_RATE) -> np.ndarray:
+    rng = np.random.default_rng(42)
+    return (rng.random((num_channels, num_samples), dtype=np.float32) - 0.5) * 0.5
+
+
+@pytest.mark.parametrize("num_channels", [3, 6, 8, 16])
+@pytest.mark.parametrize(
+    "plugin_factory",
+    [
+        lambda: Gain(-6),
+        lambda: Compressor(threshold_db=-20, ratio=4),
+        lambda: HighpassFilter(1000),
+        lambda: Delay(delay_seconds=0.01, mix=0.5),
+        lambda: LadderFilter(),
+        lambda: Chorus(),
+        lambda: Phaser(),
+    ],
+)
+def test_per_channel_plugins_match_mono(plugin_factory, num_channels: int):
+    # These plugins process every channel independently, so processing
+    # multichannel audio should be the same as processing each channel alone.
+    audio = make_audio(num_channels)
+    output = plugin_factory()(audio, SAMPLE_RATE)
+    assert output.shape == audio.shape
+
+    for c in range(num_channels):
+        expected = plugin_factory()(audio[c : c + 1], SAMPLE_RATE)
+        np.testing.assert_allclose(output[c : c + 1], expected, atol=1e-5)
+
+
+@pytest.mark.parametrize("num_channels", [3, 6, 8])
+@pytest.mark.parametrize(
+    "plugin_factory",
+    [lambda: Reverb(room_size=0.8), lambda: Convolution(IMPULSE_RESPONSE_PATH)],
+)
+def test_stereo_plugins_process_channel_pairs(plugin_factory, num_channels: int):
+    # Stereo-only plugins should process each pair of channels independently:
+    audio = make_audio(num_channels)
+    output = plugin_factory()(audio, SAMPLE_RATE)
+    assert output.shape == audio.shape
+
+    for start in range(0, num_channels, 2):
+        expected = plugin_factory()(audio[start : start + 2], SAMPLE_RATE)
+        np.testing.assert_allclose(output[start : start + 2], expected, atol=1e-5)
+
+
+@pytest.mark.parametrize("num_channels", [3, 6, 8])
+def test_interleaved_multichannel_matches_non_interleaved(num_channels: int):
+    audio = make_audio(num_channels)
+    board = Pedalboard([Gain(-3), Compressor(threshold_db=-10), Reverb()])
+
+    non_interleaved = board(audio, SAMPLE_RATE)
+    interleaved = board(np.ascontiguousarray(audio.T), SAMPLE_RATE)
+    assert interleaved.shape == (audio.shape[1], num_channels)
+    np.testing.assert_allclose(interleaved.T, non_interleaved, atol=1e-6)
+
+
+@pytest.mark.parametrize("num_channels", [3, 6])
+def test_multichannel_through_mix_and_chain(num_channels: int):
+    audio = make_audio(num_channels)
+    board = Pedalboard([Mix([Chain([Gain(-6), Delay(0.01)]), Chain([Reverb()])])])
+    output = board(audio, SAMPLE_RATE)
+    assert output.shape == audio.shape
+    assert np.all(np.isfinite(output))
@@ -18,6 +18,7 @@
 import os
 import pytest
 import numpy as np
+from pedalboard.io import AudioFile
 from pedalboard import process, Delay, Distortion, Invert, Gain, Compressor, Convolution, Reverb
 
 IMPULSE_RESPONSE_PATH = os.path.join(os.path.dirname(__file__), "impulse_response.wav")
@@ -78,6 +79,110 @@ def test_throw_on_inaccessible_convolution_file():
         Convolution("missing_impulse_response.wav")
 
 
+@pytest.mark.parametrize("num_channels", [1, 2])
+@pytest.mark.parametrize("head_size", [64, 1000, 8192])
+def test_non_uniform_convolution_matches_uniform(num_channels: int, head_size: int, sr=44100):
+    noise = np.random.rand(num_channels, sr * 2).astype(np.float32) - 0.5
+
+    expected = Convolution(IMPULSE_RESPONSE_PATH)(noise, sr)
+    plugin = Convolution(IMPULSE_RESPONSE_PATH, head_size=head_size)
+    assert plugin.head_size == head_size
+    np.testing.assert_allclose(plugin(noise, sr), expected, atol=1e-4)
+
+
+@pytest.mark.parametrize("num_channels", [1, 2, 3])
+@pytest.mark.parametrize("head_size", [None, 256])
+@pytest.mark.parametrize("buffer_size", [100, 512, 8192])
+def test_multithreaded_convolution_is_bit_identical(
+    num_channels: int, head_size, buffer_size: int, sr=44100
+):
+    noise = np.random.rand(num_channels, sr * 2).astype(np.float32) - 0.5
+
+    single_threaded = Convolution(IMPULSE_RESPONSE_PATH, head_size=head_size)
+    expected = single_threaded(noise, sr, buffer_size=buffer_size)
+
+    multithreaded = Convolution(IMPULSE_RESPONSE_PATH, head_size=head_size, num_threads=4)
+    assert multithreaded.num_threads == 4
+    for _ in range(3):
+        np.testing.assert_array_equal(
+            multithreaded(noise, sr, buffer_size=buffer_size, reset=True), expected
+        )
+
+
+def test_convolution_instances_share_impulse_responses(tmp_path, sr=44100):
+    noise = np.random.rand(2, sr).astype(np.float32) - 0.5
+
+    expected = Convolution(IMPULSE_RESPONSE_PATH)(noise, sr)
+    plugins = [Convolution(IMPULSE_RESPONSE_PATH) for _ in range(4)]
+    for plugin in plugins:
+        np.testing.assert_array_equal(plugin(noise, sr), expected)
+
+    # Changing the file on disk should not return stale cached data:
+    ir_path = str(tmp_path / "impulse_response.wav")
+    for length in [1, 100]:
+        impulse_response = np.zeros((1, length), dtype=np.float32)
+        impulse_response[0, -1] = 0.5
+        with AudioFile(ir_path, "w", sr, 1) as f:
+            f.write(impulse_response)
+
+        # The impulse response is normalized, so only check its delay:
+        result = Convolution(ir_path)(noise, sr)
+        delayed = noise[:, : sr - length + 1]
+        scale = np.sum(result[:, length - 1 :] * delayed) / np.sum(delayed**2)
+        assert scale > 0
+        np.testing.assert_allclose(result[:, length - 1 :], delayed * scale, atol=1e-4)
+
+
+@pytest.mark.parametrize("layout", ["mono", "channels_first", "channels_last"])
+def test_convolution_from_array_matches_file(tmp_path, layout: str, sr=44100):
+    noise = np.random.rand(2, sr).astype(np.float32) - 0.5
+    impulse_response = (np.random.rand(2, 2048).astype(np.float32) - 0.5) * np.exp(
+        -np.arange(2048, dtype=np.float32) / 256
+    )
+    if layout == "mono":
+        impulse_response = impulse_response[0]
+
+    ir_path = str(tmp_path / "impulse_response.wav")
+    with AudioFile(ir_path, "w", sr, 1 if layout == "mono" else 2) as f:
+        f.write(impulse_response)
+    expected = Convolution(ir_path)(noise, sr)
+
+    if layout == "channels_last":
+        impulse_response = impulse_response.T
+    plugin = Convolution(impulse_response, sample_rate=sr)
+    assert plugin.impulse_response_filename is None
+    assert plugin.impulse_response.shape[-1] == 2048
+    np.testing.assert_allclose(plugin(noise, sr), expected, atol=1e-5)
+
+    # Passing the same impulse response again should produce the same output:
+    np.testing.assert_array_equal(
+        Convolution(impulse_response, sample_rate=sr)(noise, sr), plugin(noise, sr)
+    )
+
+    assert Convolution(ir_path).impulse_response_filename == ir_path
+    assert Convolution(ir_path).impulse_response is None
+
+
+def test_convolution_from_array_is_validated():
+    with pytest.raises(ValueError):
+        Convolution(np.ones(100, dtype=np.float32))
+    with pytest.raises(ValueError):
+        Convolution(np.ones((3, 100), dtype=np.float32), sample_rate=44100)
+    with pytest.raises(ValueError):
+        Convolution(np.zeros(0, dtype=np.float32), sample_rate=44100)
+    with pytest.raises(ValueError):
+        Convolution(IMPULSE_RESPONSE_PATH, sample_rate=44100)
+
+
+def test_convolution_partitioning_arguments_are_validated():
+    with pytest.raises(ValueError):
+        Convolution(IMPULSE_RESPONSE_PATH, head_size=0)
+    with pytest.raises(ValueError):
+        Convolution(IMPULSE_RESPONSE_PATH, num_threads=0)
+    assert Convolution(IMPULSE_RESPONSE_PATH).head_size is None
+    assert Convolution(IMPULSE_RESPONSE_PATH).num_threads == 1
+
+
 @pytest.mark.parametrize("gain_db", [-12, -6, 0, 1.1, 6, 12, 24, 48, 96])
 @pytest.mark.parametrize("shape", [(44100,), (44100, 1), (44100, 2), (1, 44100), (2, 44100)])
 def test_distortion(gain_db, shape, sr=44100):
@@ -121,6 +226,44 @@ def test_delay():
     np.testing.assert_allclose(expected, result, rtol=4e-7, atol=2e-7)
 
 
+@pytest.mark.parametrize("delay_samples", [1, 15, 16, 100, 511, 512, 513, 22050])
+@pytest.mark.parametrize("feedback", [0.0, 0.5, 0.9])
+@pytest.mark.parametrize("buffer_size", [128, 512])
+def test_delay_with_feedback(delay_samples: int, feedback: float, buffer_size: int):
+    sr = 44100
+    mix = 0.25
+    noise = (np.random.rand(2, sr) - 0.5).astype(np.float32)
+    plugin = Delay(delay_samples / sr, feedback, mix)
+    # Delay times are stored as 32-bit floats, so may round down by a sample:
+    delay_samples = int(float(np.float32(delay_samples / sr)) * sr)
+
+    # Process in two halves to ensure the delay line persists between calls:
+    half = noise.shape[1] // 2
+    result = np.concatenate(
+        [
+            plugin(noise[:, :half], sr, buffer_size=buffer_size),
+            plugin(noise[:, half:], sr, buffer_size=buffer_size, reset=False),
+        ],
+        axis=1,
+    )
+
+    # No sample depends on any other sample within delay_samples of it, so a
+    # reference implementation can process that many samples at a time:
+    noise = noise.astype(np.float64)
+    delay_line = np.zeros_like(noise)
+    expected = np.zeros_like(noise)
+    for start in range(0, noise.shape[1], delay_samples):
+        end = min(start + delay_samples, noise.shape[1])
+        if start >= delay_samples:
+            delayed = delay_line[:, start - delay_samples : end - delay_samples]
+        else:
+            delayed = np.zeros((noise.shape[0], end - start))
+        delay_line[:, start:end] = noise[:, start:end] + feedback * delayed
+        expected[:, start:end] = noise[:, start:end] * (1 - mix) + mix * delayed
+
+    np.testing.assert_allclose(result, expected, atol=1e-5)
+
+
 @pytest.mark.parametrize("reset", (True, False))
 def test_plugin_state_not_cleared_between_invocations(reset: bool):
     """
@@ -167,3 +310,26 @@ def test_plugin_state_not_cleared_if_passed_smaller_buffer():
     effected_silence_noise_floor = np.amax(np.abs(effected_silence))
 
     assert effected_silence_noise_floor > 0.25
+
+
+@pytest.mark.parametrize("num_channels", [1, 2, 3])
+@pytest.mark.parametrize("buffer_size", [1, 100, 8192])
+@pytest.mark.parametrize("freeze_mode", [0.0, 1.0])
+def test_vectorized_reverb_matches_reverb(num_channels: int, buffer_size: int, freeze_mode: float):
+    sr = 44100
+    noise = np.random.rand(num_channels, sr).astype(np.float32) - 0.5
+
+    outputs = []
+    for vectorized in (False, True):
+        reverb = Reverb(room_size=0.9, width=0.5, freeze_mode=freeze_mode, vectorized=vectorized)
+        assert reverb.vectorized == vectorized
+        first_half = reverb.process(noise[:, : sr // 2], sr, buffer_size=buffer_size, reset=False)
+        # Parameter changes should be smoothed identically, too:
+        reverb.damping = 0.9
+        reverb.wet_level = 0.8
+        second_half = reverb.process(noise[:, sr // 2 :], sr, buffer_size=buffer_size, reset=False)
+        outputs.append(np.concatenate([first_half, second_half], axis=1))
+
+    np.testing.assert_allclose(outputs[1], outputs[0], atol=1e-6)
+    assert "vectorized=True" in repr(Reverb(vectorized=True))
+    assert "vectorized" not in repr(Reverb())
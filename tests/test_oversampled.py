@@ -0,0 +1,73 @@
+#! /usr/bin/env python
+#
+# Copyright 2022 Spotify AB
+#
+# Licensed under the GNU Public License, Version 3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import pytest
+import numpy as np
+from pedalboard_native._internal import OversampledTestPlugin
+
+
+@pytest.mark.parametrize("factor", [1, 2, 4, 16])
+@pytest.mark.parametrize("linear_phase", [False, True])
+@pytest.mark.parametrize("num_channels", [1, 2])
+@pytest.mark.parametrize("buffer_size", [1, 128, 8192])
+def test_oversampling_compensates_for_latency(factor, linear_phase, num_channels, buffer_size):
+    sample_rate = 44100
+    # Quiet enough to pass through the test plugin's clipper untouched:
+    t = np.arange(sample_rate) / sample_rate
+    sine = np.stack([0.25 * np.sin(2 * np.pi * 100 * t)] * num_channels).astype(np.float32)
+
+    plugin = OversampledTestPlugin(factor=factor, linear_phase=linear_phase)
+    output = plugin.process(sine, sample_rate, buffer_size=buffer_size)
+    assert output.shape == sine.shape
+
+    # Skip the first few milliseconds, while the filters settle:
+    np.testing.assert_allclose(output[:, 2048:], sine[:, 2048:], atol=0.01)
+
+
+def alias_energy(audio: np.ndarray, sample_rate: int, harmonics_hz) -> float:
+    spectrum = np.abs(np.fft.rfft(audio * np.hanning(len(audio)))) ** 2
+    frequencies = np.fft.rfftfreq(len(audio), 1 / sample_rate)
+    is_alias = np.ones_like(frequencies, dtype=bool)
+    for harmonic_hz in harmonics_hz:
+        is_alias &= np.abs(frequencies - harmonic_hz) > 50
+    return np.sum(spectrum[is_alias])
+
+
+@pytest.mark.parametrize("linear_phase", [False, True])
+def test_oversampling_reduces_aliasing(linear_phase):
+    sample_rate = 44100
+    t = np.arange(sample_rate) / sample_rate
+    sine = np.sin(2 * np.pi * 5000 * t).astype(np.float32)
+
+    # The only harmonics of a clipped 5kHz sine below Nyquist are 5kHz and
+    # 15kHz; anything else is aliasing:
+    aliased = OversampledTestPlugin(factor=1)(sine, sample_rate)
+    oversampled = OversampledTestPlugin(factor=8, linear_phase=linear_phase)(sine, sample_rate)
+    assert np.max(np.abs(aliased)) == pytest.approx(0.5)
+
+    harmonics_hz = [0, 5000, 15000]
+    reduction_db = 10 * np.log10(
+        alias_energy(aliased, sample_rate, harmonics_hz)
+        / alias_energy(oversampled, sample_rate, harmonics_hz)
+    )
+    assert reduction_db > 10
+
+
+@pytest.mark.parametrize("factor", [0, 3, 32])
+def test_oversampling_factor_is_validated(factor):
+    with pytest.raises(ValueError):
+        OversampledTestPlugin(factor=factor)
@@ -0,0 +1,146 @@
+#! /usr/bin/env python
+#
+# Copyright 2023 Spotify AB
+#
+# Licensed under the GNU Public License, Version 3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import numpy as np
+import pytest
+
+from pedalboard import (
+    Chorus,
+    Compressor,
+    Delay,
+    Distortion,
+    Gain,
+    HighShelfFilter,
+    Mix,
+    Chain,
+    Pedalboard,
+    Reverb,
+)
+from pedalboard_native._internal import AddLatency
+
+
+SAMPLE_RATE = 44100
+
+
+def make_board():
+    return Pedalboard(
+        [
+            Gain(-3),
+            Compressor(threshold_db=-20, ratio=4),
+            Mix([Chain([Delay(delay_seconds=0.01, mix=0.5)]), Distortion(drive_db=6)]),
+            HighShelfFilter(cutoff_frequency_hz=2000, gain_db=3),
+            Chorus(),
+            Reverb(room_size=0.7),
+        ]
+    )
+
+
+def make_buffers(num_buffers: int, num_channels: int = 2):
+    rng = np.random.default_rng(1234)
+    return [
+        rng.random((num_channels, int(SAMPLE_RATE * (0.1 + 0.05 * i))), dtype=np.float32) - 0.5
+        for i in range(num_buffers)
+    ]
+
+
+@pytest.mark.parametrize("num_workers", [None, 1, 2, 8])
+def test_process_batch_matches_process(num_workers: int):
+    buffers = make_buffers(12)
+    board = make_board()
+
+    expected = [board.process(buffer, SAMPLE_RATE) for buffer in buffers]
+    actual = board.process_batch(buffers, SAMPLE_RATE, num_workers=num_workers)
+
+    assert len(actual) == len(expected)
+    for a, e in zip(actual, expected):
+        assert a.shape == e.shape
+        np.testing.assert_allclose(a, e, atol=1e-6)
+
+
+def test_process_batch_preserves_shapes_and_dtypes():
+    buffers = [
+        np.zeros(1000, dtype=np.float32),
+        np.zeros((2, 2000), dtype=np.float64),
+        np.zeros((3000, 2), dtype=np.float32),
+    ]
+    outputs = Gain(0).process_batch(buffers, SAMPLE_RATE, num_workers=3)
+    assert [o.shape for o in outputs] == [b.shape for b in buffers]
+    assert [o.dtype for o in outputs] == [b.dtype for b in buffers]
+
+
+def test_process_batch_does_not_modify_parameters():
+    board = make_board()
+    board.process_batch(make_buffers(4), SAMPLE_RATE, num_workers=4)
+    assert board[0].gain_db == -3
+    assert board[-1].room_size == pytest.approx(0.7)
+
+
+def test_process_batch_falls_back_when_plugins_cannot_be_cloned():
+    # AddLatency doesn't support cloning, so this should be processed serially:
+    board = Pedalboard([AddLatency(100), Gain(-6)])
+    buffers = make_buffers(6)
+
+    expected = [board.process(buffer, SAMPLE_RATE) for buffer in buffers]
+    actual = board.process_batch(buffers, SAMPLE_RATE, num_workers=4)
+    for a, e in zip(actual, expected):
+        np.testing.assert_allclose(a, e, atol=1e-6)
+
+
+def test_process_batch_empty_list():
+    assert Gain(0).process_batch([], SAMPLE_RATE) == []
+
+
+def test_process_batch_invalid_num_workers():
+    with pytest.raises(ValueError):
+        Gain(0).process_batch(make_buffers(2), SAMPLE_RATE, num_workers=0)
+
+
+@pytest.mark.parametrize("dtype", [np.float32, np.float64])
+@pytest.mark.parametrize("channels_last", [False, True])
+def test_process_3d_array_matches_process(dtype, channels_last: bool):
+    batch = np.random.default_rng(1234).random((6, 2, SAMPLE_RATE // 4), dtype=dtype) - 0.5
+    if channels_last:
+        batch = np.ascontiguousarray(np.transpose(batch, (0, 2, 1)))
+    board = make_board()
+
+    expected = np.stack([board.process(item, SAMPLE_RATE) for item in batch])
+    actual = board.process(batch, SAMPLE_RATE)
+
+    assert actual.shape == batch.shape
+    assert actual.dtype == batch.dtype
+    np.testing.assert_allclose(actual, expected, atol=1e-6)
+
+
+def test_process_3d_array_with_latency():
+    board = Pedalboard([AddLatency(100), Gain(-6)])
+    batch = np.stack(make_buffers(1) * 4)
+
+    expected = np.stack([board.process(item, SAMPLE_RATE) for item in batch])
+    np.testing.assert_allclose(board.process(batch, SAMPLE_RATE), expected, atol=1e-6)
+
+
+def test_process_3d_array_inplace():
+    batch = np.stack(make_buffers(1) * 3)
+    expected = Gain(-6).process(batch, SAMPLE_RATE)
+    output = Gain(-6).process(batch, SAMPLE_RATE, inplace=True)
+    assert output is batch
+    np.testing.assert_allclose(batch, expected)
+
+
+def test_process_3d_array_requires_reset():
+    with pytest.raises(ValueError):
+        Gain(0).process(np.zeros((2, 2, 1000), dtype=np.float32), SAMPLE_RATE, reset=False)
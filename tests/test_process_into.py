@@ -0,0 +1,150 @@
+#! /usr/bin/env python
+#
+# Copyright 2023 Spotify AB
+#
+# Licensed under the GNU Public License, Version 3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import numpy as np
+import pytest
+
+from pedalboard import Compressor, Gain, Pedalboard, Reverb
+from pedalboard_native._internal import AddLatency
+
+SAMPLE_RATE = 44100
+
+# Longer than a few of the windows that process() reads at once when given an
+# output array, so that plugin state and latency must carry across windows:
+NUM_SAMPLES = SAMPLE_RATE * 5
+
+
+def make_board():
+    return Pedalboard([Gain(-6), Compressor(threshold_db=-12, ratio=4), Reverb()])
+
+
+@pytest.mark.parametrize("shape", [(NUM_SAMPLES,), (2, NUM_SAMPLES), (NUM_SAMPLES, 2)])
+@pytest.mark.parametrize("dtype", [np.float32, np.float64])
+@pytest.mark.parametrize("buffer_size", [128, 8192, 100_000])
+def test_process_into_matches_process(shape, dtype, buffer_size: int):
+    audio = np.random.rand(*shape).astype(dtype)
+    expected = make_board().process(audio, SAMPLE_RATE, buffer_size=buffer_size)
+
+    out = np.zeros_like(audio)
+    output = make_board().process(audio, SAMPLE_RATE, buffer_size=buffer_size, out=out)
+    assert output is out
+    assert output.dtype == dtype
+    np.testing.assert_allclose(out, expected, atol=1e-6)
+
+
+@pytest.mark.parametrize("latency", [1, 1000, SAMPLE_RATE * 2])
+def test_process_into_compensates_for_latency(latency: int):
+    audio = np.random.rand(2, NUM_SAMPLES).astype(np.float32)
+    plugin = Pedalboard([AddLatency(latency), Gain(-6)])
+    expected = plugin.process(audio, SAMPLE_RATE)
+
+    out = np.zeros_like(audio)
+    plugin.process(audio, SAMPLE_RATE, out=out)
+    np.testing.assert_allclose(out, expected, atol=1e-6)
+
+
+def test_process_into_without_reset_returns_view():
+    audio = np.random.rand(2, NUM_SAMPLES).astype(np.float32)
+    plugin = AddLatency(1000)
+    expected = plugin.process(audio, SAMPLE_RATE, reset=False)
+
+    plugin.reset()
+    out = np.zeros_like(audio)
+    output = plugin.process(audio, SAMPLE_RATE, reset=False, out=out)
+    assert output.shape == expected.shape
+    assert np.shares_memory(output, out)
+    np.testing.assert_allclose(output, expected, atol=1e-6)
+
+
+def test_process_into_input_array():
+    audio = np.random.rand(2, NUM_SAMPLES).astype(np.float32)
+    plugin = Pedalboard([AddLatency(1000), Gain(-6)])
+    expected = plugin.process(audio, SAMPLE_RATE)
+
+    output = plugin.process(audio, SAMPLE_RATE, out=audio)
+    assert output is audio
+    np.testing.assert_allclose(audio, expected, atol=1e-6)
+
+
+def test_process_into_non_contiguous_arrays():
+    audio = np.random.rand(2, NUM_SAMPLES * 2).astype(np.float32)[:, ::2]
+    expected = make_board().process(audio, SAMPLE_RATE)
+
+    out = np.zeros((NUM_SAMPLES * 3, 2), dtype=np.float32)[::3].T
+    make_board().process(audio, SAMPLE_RATE, out=out)
+    np.testing.assert_allclose(out, expected, atol=1e-6)
+
+
+def test_process_into_memmaps(tmp_path):
+    audio = np.random.rand(2, NUM_SAMPLES).astype(np.float32)
+    expected = make_board().process(audio, SAMPLE_RATE)
+
+    input_path = str(tmp_path / "input.f32")
+    audio.tofile(input_path)
+    input_map = np.memmap(input_path, dtype=np.float32, mode="r", shape=audio.shape)
+    output_map = np.memmap(
+        str(tmp_path / "output.f32"), dtype=np.float32, mode="w+", shape=audio.shape
+    )
+
+    output = make_board().process(input_map, SAMPLE_RATE, out=output_map)
+    assert output is output_map
+    output_map.flush()
+    np.testing.assert_allclose(
+        np.fromfile(str(tmp_path / "output.f32"), dtype=np.float32).reshape(audio.shape),
+        expected,
+        atol=1e-6,
+    )
+
+
+@pytest.mark.parametrize(
+    "out",
+    [
+        np.zeros((2, NUM_SAMPLES - 1), dtype=np.float32),
+        np.zeros((NUM_SAMPLES, 2), dtype=np.float32),
+    ],
+)
+def test_process_into_rejects_other_shapes(out: np.ndarray):
+    with pytest.raises(ValueError):
+        Gain(-6).process(np.zeros((2, NUM_SAMPLES), dtype=np.float32), SAMPLE_RATE, out=out)
+
+
+def test_process_into_rejects_other_dtypes():
+    with pytest.raises(TypeError):
+        Gain(-6).process(
+            np.zeros((2, NUM_SAMPLES), dtype=np.float32),
+            SAMPLE_RATE,
+            out=np.zeros((2, NUM_SAMPLES), dtype=np.float64),
+        )
+
+
+def test_process_into_rejects_non_native_byte_order():
+    audio = np.zeros((2, NUM_SAMPLES), dtype=">f4")
+    with pytest.raises(TypeError):
+        Gain(-6).process(audio, SAMPLE_RATE, out=np.zeros_like(audio))
+
+
+def test_process_into_rejects_read_only_arrays():
+    out = np.zeros((2, NUM_SAMPLES), dtype=np.float32)
+    out.flags.writeable = False
+    with pytest.raises(ValueError):
+        Gain(-6).process(np.zeros_like(out), SAMPLE_RATE, out=out)
+
+
+def test_process_into_rejects_inplace():
+    audio = np.zeros((2, NUM_SAMPLES), dtype=np.float32)
+    with pytest.raises(ValueError):
+        Gain(-6).process(audio, SAMPLE_RATE, inplace=True, out=np.zeros_like(audio))
@@ -0,0 +1,84 @@
+#! /usr/bin/env python
+#
+# Copyright 2023 Spotify AB
+#
+# Licensed under the GNU Public License, Version 3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import numpy as np
+import pytest
+
+from pedalboard import Gain, Mix, Pedalboard, Reverb, set_profiling_enabled
+
+EXPECTED_KEYS = {
+    "calls",
+    "samples_processed",
+    "seconds",
+    "reallocations",
+    "latency_samples",
+}
+
+
+@pytest.fixture
+def profiling():
+    set_profiling_enabled(True)
+    try:
+        yield
+    finally:
+        set_profiling_enabled(False)
+
+
+def test_nothing_is_collected_when_disabled():
+    board = Pedalboard([Gain(), Mix([Reverb(), Gain()])])
+    board(np.random.rand(2, 44100).astype(np.float32), 44100)
+    profile = board.profile()
+    assert len(profile) == 5
+    for stats in profile.values():
+        assert set(stats.keys()) == EXPECTED_KEYS
+        assert stats["calls"] == 0
+        assert stats["seconds"] == 0
+
+
+@pytest.mark.parametrize("buffer_size", [128, 8192])
+def test_every_plugin_is_profiled(profiling, buffer_size: int):
+    gain = Gain()
+    reverb = Reverb()
+    board = Pedalboard([gain, Mix([reverb, Gain()])])
+    num_samples = 44100
+    board(
+        np.random.rand(2, num_samples).astype(np.float32),
+        44100,
+        buffer_size=buffer_size,
+    )
+
+    profile = board.profile()
+    assert profile[board]["samples_processed"] == num_samples
+    assert profile[gain]["samples_processed"] == num_samples
+    assert profile[reverb]["calls"] > 0
+    assert profile[gain]["calls"] >= num_samples // buffer_size
+    for stats in profile.values():
+        assert stats["seconds"] > 0
+    # Containers include the time spent in the plugins they contain:
+    assert profile[board]["seconds"] >= profile[reverb]["seconds"]
+
+
+def test_reset(profiling):
+    gain = Gain()
+    gain(np.random.rand(2, 44100).astype(np.float32), 44100)
+    assert gain.profile(reset=True)[gain]["calls"] > 0
+    assert gain.profile()[gain]["calls"] == 0
+
+
+def test_latency_is_reported():
+    gain = Gain()
+    assert gain.profile()[gain]["latency_samples"] == 0
@@ -0,0 +1,68 @@
+#! /usr/bin/env python
+#
+# Copyright 2023 Spotify AB
+#
+# Licensed under the GNU Public License, Version 3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import numpy as np
+import pytest
+
+from pedalboard import (
+    Gain,
+    Mix,
+    Pedalboard,
+    Reverb,
+    get_realtime_audit_report,
+    set_realtime_audit_mode,
+)
+
+
+def realtime_audit_is_available() -> bool:
+    try:
+        set_realtime_audit_mode("count")
+    except RuntimeError:
+        return False
+    set_realtime_audit_mode("off")
+    return True
+
+
+def test_invalid_mode():
+    with pytest.raises(ValueError):
+        set_realtime_audit_mode("loud")
+
+
+def test_report_is_empty_when_off():
+    set_realtime_audit_mode("off")
+    board = Pedalboard([Gain(), Mix([Reverb(), Gain()])])
+    board(np.random.rand(2, 44100).astype(np.float32), 44100)
+    assert get_realtime_audit_report(board) == {}
+
+
+@pytest.mark.skipif(
+    not realtime_audit_is_available(), reason="Built without USE_REALTIME_AUDIT=1."
+)
+def test_allocations_are_attributed_to_plugins():
+    board = Pedalboard([Gain(), Mix([Gain(), Reverb()])])
+
+    set_realtime_audit_mode("count")
+    try:
+        board(np.random.rand(2, 44100).astype(np.float32), 44100)
+    finally:
+        set_realtime_audit_mode("off")
+
+    report = get_realtime_audit_report(board, reset=True)
+    for counts in report.values():
+        assert set(counts.keys()) == {"allocations", "lock_acquisitions"}
+        assert counts["allocations"] + counts["lock_acquisitions"] > 0
+    assert get_realtime_audit_report(board) == {}
@@ -0,0 +1,172 @@
+#! /usr/bin/env python
+#
+# Copyright 2023 Spotify AB
+#
+# Licensed under the GNU Public License, Version 3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import os
+
+import numpy as np
+import pytest
+
+from pedalboard import (
+    Chain,
+    Compressor,
+    Convolution,
+    Gain,
+    LoudnessMeter,
+    LowpassFilter,
+    Mix,
+    Pedalboard,
+    RenderCache,
+    Reverb,
+)
+from pedalboard.io import AudioFile
+
+SAMPLE_RATE = 44100
+
+
+@pytest.fixture
+def noise() -> np.ndarray:
+    return np.random.default_rng(0).uniform(-0.5, 0.5, size=(2, SAMPLE_RATE)).astype(np.float32)
+
+
+def make_board() -> Pedalboard:
+    return Pedalboard(
+        [
+            Gain(-6),
+            Mix(
+                [
+                    Reverb(room_size=0.3),
+                    Chain(
+                        [
+                            LowpassFilter(1000),
+                            Compressor(),
+                        ]
+                    ),
+                ]
+            ),
+        ]
+    )
+
+
+def test_cached_output_matches_rendered_output(noise: np.ndarray):
+    cache = RenderCache()
+    expected = make_board()(noise, SAMPLE_RATE)
+
+    first = cache.process(make_board(), noise, SAMPLE_RATE)
+    second = cache.process(make_board(), noise, SAMPLE_RATE)
+
+    np.testing.assert_array_equal(first, expected)
+    assert second is first
+    assert not second.flags.writeable
+    assert (cache.hits, cache.misses, cache.uncacheable) == (1, 1, 0)
+
+
+def test_key_depends_on_every_input(noise: np.ndarray):
+    cache = RenderCache()
+    key = cache.get_key(make_board(), noise, SAMPLE_RATE)
+    assert key == cache.get_key(make_board(), noise.copy(), SAMPLE_RATE)
+
+    nested_change = make_board()
+    nested_change[1][1][0].cutoff_frequency_hz = 1001
+    different_keys = [
+        cache.get_key(make_board(), noise[::-1], SAMPLE_RATE),
+        cache.get_key(make_board(), noise.astype(np.float64), SAMPLE_RATE),
+        cache.get_key(make_board(), noise, 48000),
+        cache.get_key(make_board(), noise, SAMPLE_RATE, buffer_size=512),
+        cache.get_key(nested_change, noise, SAMPLE_RATE),
+        cache.get_key(Chain([Gain(-6), Chain(list(make_board()[1]))]), noise, SAMPLE_RATE),
+    ]
+    assert key not in different_keys
+    assert len(set(different_keys)) == len(different_keys)
+
+
+def make_automated_board() -> Pedalboard:
+    board = Pedalboard([Gain(-6), Mix([LowpassFilter()])])
+    board[1][0].automate("cutoff_frequency_hz", [(0, 200), (1, 8000)])
+    return board
+
+
+@pytest.mark.parametrize(
+    "make_uncacheable_board",
+    [lambda: Pedalboard([Gain(-6), Chain([LoudnessMeter()])]), make_automated_board],
+)
+def test_uncacheable_boards_are_rendered_every_time(noise: np.ndarray, make_uncacheable_board):
+    board = make_uncacheable_board()
+    cache = RenderCache()
+    assert cache.get_key(board, noise, SAMPLE_RATE) is None
+
+    expected = board(noise, SAMPLE_RATE)
+    np.testing.assert_array_equal(cache.process(board, noise, SAMPLE_RATE), expected)
+    np.testing.assert_array_equal(cache.process(board, noise, SAMPLE_RATE), expected)
+    assert (cache.hits, cache.misses, cache.uncacheable) == (0, 0, 2)
+
+
+def test_disk_cache_is_shared_and_memory_mapped(tmp_path, noise: np.ndarray):
+    directory = str(tmp_path / "renders")
+    expected = RenderCache(directory).process(make_board(), noise, SAMPLE_RATE)
+    assert len(os.listdir(directory)) == 1
+
+    cache = RenderCache(directory)
+    output = cache.process(make_board(), noise, SAMPLE_RATE)
+    assert isinstance(output, np.memmap)
+    np.testing.assert_array_equal(output, expected)
+    assert (cache.hits, cache.misses) == (1, 0)
+
+
+def test_memory_is_bounded(noise: np.ndarray):
+    cache = RenderCache(max_memory_bytes=noise.nbytes)
+    cache.process(Gain(-1), noise, SAMPLE_RATE)
+    cache.process(Gain(-2), noise, SAMPLE_RATE)
+    cache.process(Gain(-2), noise, SAMPLE_RATE)
+    cache.process(Gain(-1), noise, SAMPLE_RATE)
+    assert (cache.hits, cache.misses) == (1, 3)
+
+    cache.clear()
+    cache.process(Gain(-2), noise, SAMPLE_RATE)
+    assert (cache.hits, cache.misses) == (1, 4)
+
+
+def test_key_depends_on_impulse_response_sample_rate(noise: np.ndarray):
+    impulse_response = np.random.default_rng(1).uniform(-1, 1, size=(2, 1000)).astype(np.float32)
+    low = Convolution(impulse_response, sample_rate=22050)
+    high = Convolution(impulse_response, sample_rate=SAMPLE_RATE)
+    assert (low.sample_rate, high.sample_rate) == (22050, SAMPLE_RATE)
+
+    cache = RenderCache()
+    assert cache.get_key(low, noise, SAMPLE_RATE) != cache.get_key(high, noise, SAMPLE_RATE)
+
+    np.testing.assert_array_equal(cache.process(low, noise, SAMPLE_RATE), low(noise, SAMPLE_RATE))
+    np.testing.assert_array_equal(cache.process(high, noise, SAMPLE_RATE), high(noise, SAMPLE_RATE))
+    assert (cache.hits, cache.misses) == (0, 2)
+
+
+def test_key_depends_on_impulse_response_file_contents(tmp_path, noise: np.ndarray):
+    filename = str(tmp_path / "impulse_response.wav")
+    rng = np.random.default_rng(1)
+    with AudioFile(filename, "w", SAMPLE_RATE, num_channels=2) as f:
+        f.write(rng.uniform(-1, 1, size=(2, 1000)).astype(np.float32))
+
+    cache = RenderCache()
+    key = cache.get_key(Convolution(filename), noise, SAMPLE_RATE)
+    assert key == cache.get_key(Convolution(filename), noise, SAMPLE_RATE)
+
+    with AudioFile(filename, "w", SAMPLE_RATE, num_channels=2) as f:
+        f.write(rng.uniform(-1, 1, size=(2, 2000)).astype(np.float32))
+    # Ensure the modification time changes, even on file systems with coarse timestamps:
+    stat = os.stat(filename)
+    os.utime(filename, ns=(stat.st_atime_ns, stat.st_mtime_ns + 1_000_000_000))
+
+    assert cache.get_key(Convolution(filename), noise, SAMPLE_RATE) != key
@@ -0,0 +1,80 @@
+#! /usr/bin/env python
+#
+# Copyright 2023 Spotify AB
+#
+# Licensed under the GNU Public License, Version 3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import numpy as np
+import pytest
+
+from pedalboard import Gain, Pedalboard, Reverb, render_file
+from pedalboard.io import AudioFile
+from pedalboard_native._internal import AddLatency
+
+
+SAMPLE_RATE = 44100
+
+
+def write_noise(path, num_channels: int = 2, num_samples: int = SAMPLE_RATE * 3) -> np.ndarray:
+    audio = (np.random.rand(num_channels, num_samples).astype(np.float32) - 0.5) * 0.5
+    with AudioFile(str(path), "w", SAMPLE_RATE, num_channels, bit_depth=32) as f:
+        f.write(audio)
+    return audio
+
+
+def read_all(path) -> np.ndarray:
+    with AudioFile(str(path)) as f:
+        return f.read(f.frames)
+
+
+@pytest.mark.parametrize("chunk_size", [100, 4096, 32768, SAMPLE_RATE * 10])
+@pytest.mark.parametrize("queue_size", [1, 4])
+def test_render_file_matches_process(tmp_path, chunk_size: int, queue_size: int):
+    audio = write_noise(tmp_path / "input.wav")
+    board = Pedalboard([Gain(-6), AddLatency(1000), Reverb()])
+    expected = board.process(audio, SAMPLE_RATE)
+
+    frames = render_file(
+        str(tmp_path / "input.wav"),
+        str(tmp_path / "output.wav"),
+        board,
+        chunk_size=chunk_size,
+        queue_size=queue_size,
+        bit_depth=32,
+    )
+    assert frames == audio.shape[1]
+
+    output = read_all(tmp_path / "output.wav")
+    assert output.shape == expected.shape
+    np.testing.assert_allclose(output, expected, atol=1e-5)
+
+
+def test_render_file_with_open_files(tmp_path):
+    audio = write_noise(tmp_path / "input.wav", num_channels=1)
+
+    with AudioFile(str(tmp_path / "input.wav")) as i:
+        with AudioFile(str(tmp_path / "output.wav"), "w", i.samplerate, 1, bit_depth=32) as o:
+            assert render_file(i, o, Gain(0)) == audio.shape[1]
+            # Files passed in should be left open:
+            assert not o.closed
+            assert o.frames == audio.shape[1]
+
+    np.testing.assert_allclose(read_all(tmp_path / "output.wav"), audio, atol=1e-6)
+
+
+def test_render_file_rejects_mismatched_channels(tmp_path):
+    write_noise(tmp_path / "input.wav", num_channels=2)
+    with AudioFile(str(tmp_path / "output.wav"), "w", SAMPLE_RATE, 1) as o:
+        with pytest.raises(ValueError):
+            render_file(str(tmp_path / "input.wav"), o, Gain(0))
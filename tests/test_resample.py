@@ -170,3 +170,18 @@ def test_quality_can_change(
     plugin.quality = original_quality
     output3 = plugin.process(sine_wave, sample_rate, buffer_size=buffer_size)
     np.testing.assert_allclose(output1, output3)
+
+
+@pytest.mark.parametrize("sample_rate", [44100, 48000])
+@pytest.mark.parametrize("target_sample_rate", [8000, 16000, 22050, 44100, 48000])
+@pytest.mark.parametrize("buffer_size", [1, 8192])
+@pytest.mark.parametrize("num_channels", [1, 2])
+def test_polyphase_resample(
+    sample_rate: float, target_sample_rate: float, buffer_size: int, num_channels: int
+):
+    sine_wave = generate_sine_at(
+        sample_rate, 440, num_seconds=DURATIONS[0], num_channels=num_channels
+    )
+    plugin = Resample(target_sample_rate, quality=Resample.Quality.Polyphase)
+    output = plugin.process(sine_wave, sample_rate, buffer_size=buffer_size)
+    np.testing.assert_allclose(sine_wave, output, atol=0.05)
@@ -14,6 +14,7 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import os
 import time
 import pytest
 from pedalboard import Resample
@@ -176,6 +177,29 @@ def test_seek_resampled_is_constant_time(sample_rate: float, target_sample_rate:
         assert np.std(timings) < 0.02
 
 
+@pytest.mark.parametrize("quality", QUALITIES)
+def test_deep_seek_resampled_matches_linear_read(quality):
+    sample_rate = 8000
+    target_sample_rate = 12345.67
+    signal = np.random.rand(sample_rate * 120).astype(np.float32)
+
+    read_buffer = BytesIO()
+    read_buffer.name = "test.wav"
+    with AudioFile(read_buffer, "w", sample_rate, 1, bit_depth=32) as f:
+        f.write(signal)
+
+    with AudioFile(BytesIO(read_buffer.getvalue())).resampled_to(target_sample_rate, quality) as f:
+        expected = f.read(f.frames)
+
+    with AudioFile(BytesIO(read_buffer.getvalue())).resampled_to(target_sample_rate, quality) as f:
+        # Seek backwards and forwards, both before and after positions that
+        # have already been seeked to:
+        for position in [f.frames - 5000, 123456, f.frames // 2, 654321, 10]:
+            f.seek(position)
+            assert f.tell() == position
+            np.testing.assert_allclose(f.read(1000), expected[:, position : position + 1000])
+
+
 @pytest.mark.parametrize("sample_rate", [8000, 11025, 22050, 44100, 48000])
 @pytest.mark.parametrize("target_sample_rate", [8000, 11025, 12345.67, 22050, 44100, 48000])
 @pytest.mark.parametrize("chunk_size", [1000])
@@ -238,3 +262,99 @@ def test_frame_count(sample_rate: float, target_sample_rate: float, quality):
 
     with AudioFile(BytesIO(read_buffer.getvalue())).resampled_to(target_sample_rate, quality) as f:
         assert f.frames == expected_signal.shape[-1]
+
+
+@pytest.mark.parametrize("native_sample_rate", [44100, 48000])
+@pytest.mark.parametrize("target_sample_rate", [8000, 11025, 16000, 22050, 24000])
+def test_mp3_decoded_at_reduced_sample_rate(native_sample_rate: int, target_sample_rate: int):
+    filename = os.path.join(
+        os.path.dirname(__file__), "audio", "correct", f"mono_sine_at_{native_sample_rate}Hz.mp3"
+    )
+
+    # Files opened by filename may be decoded at a reduced sample rate:
+    with AudioFile(filename) as f:
+        with f.resampled_to(target_sample_rate) as r:
+            assert r.samplerate == target_sample_rate
+            fast = r.read(r.frames)
+            fast_frames = r.frames
+        assert r.closed
+        assert not f.closed
+
+    # ...but file-like objects are always decoded at their native sample rate:
+    with open(filename, "rb") as handle:
+        buf = BytesIO(handle.read())
+        buf.name = os.path.basename(filename)
+    with AudioFile(buf).resampled_to(target_sample_rate) as r:
+        slow = r.read(r.frames)
+        slow_frames = r.frames
+
+    assert abs(fast_frames - slow_frames) <= 1
+    num_frames = min(fast.shape[-1], slow.shape[-1])
+    assert abs(fast.shape[-1] - slow.shape[-1]) <= 1
+    np.testing.assert_allclose(fast[:, :num_frames], slow[:, :num_frames], atol=0.05)
+
+
+@pytest.mark.parametrize("prefetch_frames", [1, 1000, 44100])
+@pytest.mark.parametrize("quality", [Resample.Quality.Linear, Resample.Quality.WindowedSinc])
+def test_read_resampled_with_prefetching(tmp_path, prefetch_frames: int, quality):
+    filename = str(tmp_path / "prefetch.wav")
+    signal = generate_sine_at(44100, 440, num_seconds=2, num_channels=2).astype(np.float32)
+    with AudioFile(filename, "w", 44100, 2, bit_depth=32) as f:
+        f.write(signal)
+
+    with AudioFile(filename).resampled_to(22050, quality) as f:
+        expected = f.read(f.frames)
+
+    with AudioFile(filename).resampled_to(22050, quality) as f:
+        f.prefetch_frames = prefetch_frames
+        assert f.prefetch_frames == prefetch_frames
+
+        chunks = []
+        while True:
+            chunk = f.read(777)
+            if not chunk.shape[1]:
+                break
+            chunks.append(chunk)
+            assert f.tell() == sum(c.shape[1] for c in chunks)
+        np.testing.assert_array_equal(np.concatenate(chunks, axis=1), expected)
+
+        for position in [1000, 20000, 0]:
+            f.seek(position)
+            assert f.tell() == position
+            np.testing.assert_allclose(
+                f.read(1000), expected[:, position : position + 1000], atol=1e-5
+            )
+
+        # Turning prefetching off continues from the same position:
+        f.prefetch_frames = 0
+        np.testing.assert_allclose(f.read(1000), expected[:, 1000:2000], atol=1e-5)
+
+    with AudioFile(BytesIO(open(filename, "rb").read())).resampled_to(22050) as f:
+        with pytest.raises(ValueError):
+            f.prefetch_frames = 1000
+
+
+def test_read_resampled_into():
+    signal = generate_sine_at(44100, 440, num_seconds=1, num_channels=2).astype(np.float32)
+    read_buffer = BytesIO()
+    read_buffer.name = "test.wav"
+    with AudioFile(read_buffer, "w", 44100, 2, bit_depth=32) as f:
+        f.write(signal)
+
+    with AudioFile(BytesIO(read_buffer.getvalue())).resampled_to(22050) as f:
+        expected = f.read(f.frames)
+
+    with AudioFile(BytesIO(read_buffer.getvalue())).resampled_to(22050) as f:
+        output = np.zeros((2, 5000), dtype=np.float32)
+        assert f.read_into(output) == 5000
+        np.testing.assert_array_equal(output, expected[:, :5000])
+
+        interleaved = np.zeros((5000, 2), dtype=np.float32)
+        assert f.read_into(interleaved) == 5000
+        np.testing.assert_array_equal(interleaved, expected[:, 5000:10000].T)
+
+        remaining = np.zeros((2, 100000), dtype=np.float32)
+        num_frames = f.read_into(remaining)
+        assert num_frames == expected.shape[1] - 10000
+        np.testing.assert_array_equal(remaining[:, :num_frames], expected[:, 10000:])
+        assert f.tell() == expected.shape[1]
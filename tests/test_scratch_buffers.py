@@ -0,0 +1,46 @@
+#! /usr/bin/env python
+#
+# Copyright 2023 Spotify AB
+#
+# Licensed under the GNU Public License, Version 3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import numpy as np
+import pytest
+
+from pedalboard import Gain, Pedalboard, Reverb
+from pedalboard.io import StreamResampler
+from pedalboard_native._internal import AddLatency
+
+SAMPLE_RATE = 44100
+
+
+@pytest.mark.parametrize("num_channels", [1, 2])
+def test_reused_buffers_do_not_leak_between_calls(num_channels: int):
+    # Scratch buffers are reused from call to call on the same thread, so
+    # make sure a large, loud call doesn't affect a smaller one afterwards:
+    board = Pedalboard([AddLatency(100), Gain(-6), Reverb()])
+    quiet = np.zeros((num_channels, 1000), dtype=np.float32)
+    expected = board(quiet, SAMPLE_RATE)
+
+    for length in [SAMPLE_RATE, 1000, 10, SAMPLE_RATE * 2, 1000]:
+        board(np.ones((num_channels, length), dtype=np.float32), SAMPLE_RATE)
+        np.testing.assert_array_equal(board(quiet, SAMPLE_RATE), expected)
+
+
+def test_stream_resampler_output_is_not_shared_between_calls():
+    resampler = StreamResampler(SAMPLE_RATE, 22050, 1)
+    first = resampler.process(np.ones(SAMPLE_RATE, dtype=np.float32))
+    snapshot = first.copy()
+    resampler.process(np.zeros(SAMPLE_RATE, dtype=np.float32))
+    np.testing.assert_array_equal(first, snapshot)
@@ -0,0 +1,95 @@
+#! /usr/bin/env python
+#
+# Copyright 2023 Spotify AB
+#
+# Licensed under the GNU Public License, Version 3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import numpy as np
+import pytest
+
+from pedalboard import (
+    Compressor,
+    Gain,
+    LowpassFilter,
+    PeakFilter,
+    Pedalboard,
+    Reverb,
+    set_profiling_enabled,
+)
+
+SAMPLE_RATE = 44100
+
+
+@pytest.fixture
+def profiling():
+    set_profiling_enabled(True)
+    try:
+        yield
+    finally:
+        set_profiling_enabled(False)
+
+
+def bursts_with_silence(silence_seconds: float = 10) -> np.ndarray:
+    burst = np.random.default_rng(1234).uniform(-1, 1, SAMPLE_RATE // 4)
+    silence = np.zeros(int(SAMPLE_RATE * silence_seconds))
+    return np.concatenate([burst, silence, burst, silence]).astype(np.float32)
+
+
+def test_skip_silence_defaults_to_false():
+    assert not Reverb().skip_silence
+    plugin = Reverb()
+    plugin.skip_silence = True
+    assert plugin.skip_silence
+
+
+@pytest.mark.parametrize(
+    "plugin_factory",
+    [
+        lambda: Reverb(room_size=0.5),
+        lambda: Compressor(threshold_db=-20, release_ms=200),
+        lambda: LowpassFilter(cutoff_frequency_hz=50),
+        lambda: PeakFilter(cutoff_frequency_hz=100, gain_db=12, q=8),
+        lambda: Pedalboard([Gain(6), Reverb(), LowpassFilter()]),
+    ],
+)
+def test_skipping_silence_matches_output(plugin_factory, profiling):
+    audio = bursts_with_silence()
+    expected = plugin_factory()(audio, SAMPLE_RATE, buffer_size=1024)
+
+    plugin = plugin_factory()
+    plugin.skip_silence = True
+    output = plugin(audio, SAMPLE_RATE, buffer_size=1024)
+
+    np.testing.assert_allclose(output, expected, atol=1e-5)
+    # The second burst must have been processed, even after skipping the
+    # silence before it:
+    assert np.any(output[-int(SAMPLE_RATE * 10) :] != 0)
+    assert plugin.profile()[plugin]["samples_processed"] < len(audio)
+
+
+def test_freeze_mode_is_never_skipped(profiling):
+    plugin = Reverb(freeze_mode=1)
+    plugin.skip_silence = True
+    audio = bursts_with_silence(silence_seconds=2)
+    plugin(audio, SAMPLE_RATE, buffer_size=1024)
+    assert plugin.profile()[plugin]["samples_processed"] == len(audio)
+
+
+def test_automated_plugins_are_never_skipped(profiling):
+    plugin = LowpassFilter()
+    plugin.skip_silence = True
+    plugin.automate("cutoff_frequency_hz", [(0, 200), (1, 8000)])
+    audio = bursts_with_silence(silence_seconds=2)
+    plugin(audio, SAMPLE_RATE, buffer_size=1024)
+    assert plugin.profile()[plugin]["samples_processed"] == len(audio)
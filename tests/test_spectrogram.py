@@ -0,0 +1,230 @@
+#! /usr/bin/env python
+#
+# Copyright 2023 Spotify AB
+#
+# Licensed under the GNU Public License, Version 3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import numpy as np
+import pytest
+
+from pedalboard import MelSpectrogram, stft
+from pedalboard.io import AudioFile
+
+def blackman(n: int) -> np.ndarray:
+    phase = 2 * np.pi * np.arange(n) / n
+    return 0.42 - 0.5 * np.cos(phase) + 0.08 * np.cos(2 * phase)
+
+
+WINDOWS = {
+    "hann": lambda n: 0.5 - 0.5 * np.cos(2 * np.pi * np.arange(n) / n),
+    "hamming": lambda n: 0.54 - 0.46 * np.cos(2 * np.pi * np.arange(n) / n),
+    "blackman": blackman,
+    "boxcar": lambda n: np.ones(n),
+}
+
+
+def reference_stft(
+    audio: np.ndarray, n_fft: int, hop_length: int, window: str, center: bool
+) -> np.ndarray:
+    if center:
+        audio = np.pad(audio, [(0, 0)] * (audio.ndim - 1) + [(n_fft // 2, n_fft // 2)])
+    num_frames = 1 + (audio.shape[-1] - n_fft) // hop_length
+    frames = np.stack(
+        [audio[..., i * hop_length : i * hop_length + n_fft] for i in range(num_frames)], axis=-1
+    )
+    window_values = WINDOWS[window](n_fft).reshape(-1, 1)
+    return np.fft.rfft(frames * window_values, axis=-2)
+
+
+def reference_mel_filters(
+    sample_rate: float, n_fft: int, n_mels: int, f_min: float, f_max: float
+) -> np.ndarray:
+    # Slaney-style mel filters, as computed by librosa.filters.mel:
+    def hz_to_mel(hz):
+        hz = np.asanyarray(hz, dtype=np.float64)
+        return np.where(
+            hz < 1000, hz * 3 / 200, 15 + np.log(np.maximum(hz, 1e-10) / 1000) / (np.log(6.4) / 27)
+        )
+
+    def mel_to_hz(mel):
+        return np.where(mel < 15, mel * 200 / 3, 1000 * np.exp(np.log(6.4) / 27 * (mel - 15)))
+
+    fft_frequencies = np.linspace(0, sample_rate / 2, 1 + n_fft // 2)
+    edges = mel_to_hz(np.linspace(hz_to_mel(f_min), hz_to_mel(f_max), n_mels + 2))
+    lower = (fft_frequencies[None, :] - edges[:-2, None]) / np.diff(edges)[:-1, None]
+    upper = (edges[2:, None] - fft_frequencies[None, :]) / np.diff(edges)[1:, None]
+    weights = np.maximum(0, np.minimum(lower, upper))
+    return weights * (2.0 / (edges[2:] - edges[:-2]))[:, None]
+
+
+def noise(shape, seed: int = 1234) -> np.ndarray:
+    return np.random.default_rng(seed).standard_normal(shape).astype(np.float32) * 0.5
+
+
+@pytest.mark.parametrize("n_fft", [256, 1024])
+@pytest.mark.parametrize("hop_length", [None, 100, 256])
+@pytest.mark.parametrize("window", list(WINDOWS.keys()))
+@pytest.mark.parametrize("center", [True, False])
+@pytest.mark.parametrize("shape", [(12345,), (2, 12345)])
+def test_stft_matches_reference(n_fft: int, hop_length, window: str, center: bool, shape):
+    audio = noise(shape)
+    actual = stft(audio, n_fft=n_fft, hop_length=hop_length, window=window, center=center)
+    expected = reference_stft(audio, n_fft, hop_length or n_fft // 4, window, center)
+
+    assert actual.dtype == np.complex64
+    assert actual.shape == expected.shape
+    np.testing.assert_allclose(actual, expected, atol=2e-3 * np.sqrt(n_fft))
+
+
+@pytest.mark.parametrize("num_samples", [0, 1, 100, 5000])
+def test_stft_of_short_input(num_samples: int):
+    audio = noise((num_samples,))
+    actual = stft(audio, n_fft=512)
+    expected_frames = 1 + num_samples // 128
+    assert actual.shape == (257, expected_frames)
+    if num_samples:
+        np.testing.assert_allclose(actual, reference_stft(audio, 512, 128, "hann", True), atol=0.05)
+
+
+def test_stft_of_file_matches_array(tmp_path):
+    filename = str(tmp_path / "noise.wav")
+    audio = noise((2, 44100 * 3))
+    with AudioFile(filename, "w", 44100, 2, bit_depth=32) as f:
+        f.write(audio)
+
+    expected = stft(audio, n_fft=2048, hop_length=512)
+    with AudioFile(filename) as f:
+        np.testing.assert_array_equal(stft(f, n_fft=2048, hop_length=512), expected)
+        # The file is read to its end:
+        assert f.tell() == f.frames
+
+    # Files are read from their current position:
+    with AudioFile(filename) as f:
+        f.seek(10000)
+        np.testing.assert_array_equal(
+            stft(f, n_fft=2048, hop_length=512), stft(audio[:, 10000:], 2048, 512)
+        )
+
+    # ...including resampled files:
+    with AudioFile(filename).resampled_to(22050) as f:
+        chunks = []
+        while True:
+            chunk = f.read(10000)
+            if not chunk.shape[1]:
+                break
+            chunks.append(chunk)
+        resampled = np.concatenate(chunks, axis=1)
+    with AudioFile(filename).resampled_to(22050) as f:
+        np.testing.assert_allclose(stft(f, n_fft=1024), stft(resampled, n_fft=1024), atol=1e-3)
+
+
+def test_stft_of_mono_file_has_channel_axis(tmp_path):
+    filename = str(tmp_path / "mono.wav")
+    with AudioFile(filename, "w", 44100, 1) as f:
+        f.write(noise((1, 10000)))
+    with AudioFile(filename) as f:
+        assert stft(f, n_fft=1024).shape == (1, 513, 1 + 10000 // 256)
+
+
+@pytest.mark.parametrize("n_fft", [0, 1000, 2047])
+def test_stft_requires_power_of_two(n_fft: int):
+    with pytest.raises(ValueError):
+        stft(noise((1000,)), n_fft=n_fft)
+
+
+@pytest.mark.parametrize("hop_length", [0, -1, 1025])
+def test_stft_requires_valid_hop_length(hop_length: int):
+    with pytest.raises(ValueError):
+        stft(noise((1000,)), n_fft=1024, hop_length=hop_length)
+
+
+def test_stft_requires_valid_window():
+    with pytest.raises(ValueError):
+        stft(noise((1000,)), window="triangle")
+
+
+def test_stft_of_closed_file_fails(tmp_path):
+    filename = str(tmp_path / "closed.wav")
+    with AudioFile(filename, "w", 44100, 1) as f:
+        f.write(noise((1, 1000)))
+    f = AudioFile(filename)
+    f.close()
+    with pytest.raises(RuntimeError):
+        stft(f)
+
+
+@pytest.mark.parametrize("sample_rate", [22050, 44100])
+@pytest.mark.parametrize("n_mels", [40, 128])
+@pytest.mark.parametrize("power", [1.0, 2.0])
+@pytest.mark.parametrize("f_max", [None, 8000])
+def test_mel_spectrogram_matches_reference(sample_rate: int, n_mels: int, power: float, f_max):
+    audio = noise((2, sample_rate))
+    mel = MelSpectrogram(
+        sample_rate,
+        n_fft=2048,
+        hop_length=512,
+        n_mels=n_mels,
+        power=power,
+        f_max=f_max,
+    )
+    actual = mel(audio)
+
+    spectrogram = np.abs(reference_stft(audio, 2048, 512, "hann", True)) ** power
+    filters = reference_mel_filters(sample_rate, 2048, n_mels, 0.0, f_max or sample_rate / 2)
+    expected = np.einsum("mb,cbf->cmf", filters, spectrogram)
+
+    assert actual.dtype == np.float32
+    assert actual.shape == expected.shape
+    np.testing.assert_allclose(actual, expected, rtol=1e-3, atol=1e-3 * np.amax(expected))
+
+
+def test_mel_spectrogram_of_file_matches_array(tmp_path):
+    filename = str(tmp_path / "noise.wav")
+    audio = noise((2, 44100 * 2))
+    with AudioFile(filename, "w", 44100, 2, bit_depth=32) as f:
+        f.write(audio)
+
+    mel = MelSpectrogram(44100)
+    with AudioFile(filename) as f:
+        np.testing.assert_array_equal(mel(f), mel(audio))
+    assert mel(audio[0]).shape == (128, 1 + audio.shape[1] // 512)
+
+
+def test_mel_spectrogram_properties():
+    mel = MelSpectrogram(16000, n_fft=512, n_mels=64)
+    assert mel.sample_rate == 16000
+    assert mel.n_fft == 512
+    assert mel.hop_length == 128
+    assert mel.n_mels == 64
+    assert mel.f_min == 0
+    assert mel.f_max == 8000
+    assert mel.power == 2.0
+    assert mel.window == "hann"
+    assert mel.center
+    assert "MelSpectrogram" in repr(mel)
+
+
+@pytest.mark.parametrize(
+    "kwargs",
+    [
+        {"sample_rate": 0},
+        {"sample_rate": 44100, "n_mels": 0},
+        {"sample_rate": 44100, "f_min": 1000, "f_max": 500},
+        {"sample_rate": 44100, "power": 0},
+        {"sample_rate": 44100, "n_fft": 1000},
+    ],
+)
+def test_mel_spectrogram_requires_valid_parameters(kwargs):
+    with pytest.raises(ValueError):
+        MelSpectrogram(**kwargs)
@@ -27,6 +27,7 @@ TOLERANCE_PER_QUALITY = {
     Resample.Quality.CatmullRom: 0.16,
     Resample.Quality.Lagrange: 0.16,
     Resample.Quality.WindowedSinc: 0.151,
+    Resample.Quality.Polyphase: 0.151,
 }
 
 
@@ -195,3 +196,97 @@ def test_returned_sample_count(
         f"{output.shape[1]:,} samples were output by resampler (in chunks:"
         f" {[o.shape[1] for o in outputs]}) when {expected_output.shape[1]:,} were expected."
     )
+
+
+def resample_into(resampler: StreamResampler, audio: np.ndarray, chunk_size: int, output_size: int):
+    output = np.zeros((resampler.num_channels, output_size), dtype=np.float32)
+    outputs = []
+    for i in range(0, audio.shape[-1], chunk_size):
+        chunk = audio[..., i : i + chunk_size]
+        while chunk.shape[-1]:
+            consumed, written = resampler.process_into(chunk, output)
+            outputs.append(output[:, :written].copy())
+            chunk = chunk[..., consumed:]
+    while True:
+        _, written = resampler.process_into(None, output)
+        outputs.append(output[:, :written].copy())
+        if written < output_size:
+            break
+    return np.concatenate(outputs, axis=1)
+
+
+@pytest.mark.parametrize("sample_rate", [8000, 22050, 48000])
+@pytest.mark.parametrize("target_sample_rate", [8000, 12345.67, 44100])
+@pytest.mark.parametrize("chunk_size", [1, 256, 100_000])
+@pytest.mark.parametrize("output_size", [1, 100, 100_000])
+@pytest.mark.parametrize("num_channels", [1, 2])
+def test_process_into_matches_process(
+    sample_rate: float,
+    target_sample_rate: float,
+    chunk_size: int,
+    output_size: int,
+    num_channels: int,
+):
+    audio = np.random.rand(num_channels, sample_rate // 2).astype(np.float32)
+
+    resampler = StreamResampler(sample_rate, target_sample_rate, num_channels)
+    expected = np.concatenate([resampler.process(audio), resampler.process(None)], axis=1)
+
+    resampler = StreamResampler(sample_rate, target_sample_rate, num_channels)
+    actual = resample_into(resampler, audio, chunk_size, output_size)
+    np.testing.assert_allclose(expected, actual)
+
+    # Once flushed, the resampler should be reusable for another stream:
+    actual = resample_into(resampler, audio, chunk_size, output_size)
+    np.testing.assert_allclose(expected, actual)
+
+
+def test_process_into_accepts_interleaved_and_strided_input():
+    audio = np.random.rand(2, 22050).astype(np.float32)
+    resampler = StreamResampler(22050, 44100, 2)
+    expected = np.concatenate([resampler.process(audio), resampler.process(None)], axis=1)
+
+    # Interleaved, then every other frame of a larger array:
+    inputs = [np.ascontiguousarray(audio.T), np.repeat(audio, 2, axis=1)[:, ::2]]
+    for _input in inputs:
+        resampler.reset()
+        output = np.zeros_like(expected)
+        consumed, written = resampler.process_into(_input, output)
+        assert consumed == audio.shape[1]
+        _, flushed = resampler.process_into(None, output[:, written:])
+        assert written + flushed == expected.shape[1]
+        np.testing.assert_allclose(expected, output)
+
+
+def test_process_into_rejects_invalid_output():
+    resampler = StreamResampler(44100, 22050, 2)
+    audio = np.zeros((2, 1000), dtype=np.float32)
+
+    with pytest.raises(TypeError):
+        resampler.process_into(audio, np.zeros((2, 1000), dtype=np.float64))
+
+    with pytest.raises(ValueError):
+        resampler.process_into(audio, np.zeros((1, 1000), dtype=np.float32))
+
+    with pytest.raises(ValueError):
+        resampler.process_into(audio, np.zeros((1000, 2), dtype=np.float32))
+
+    with pytest.raises(ValueError):
+        resampler.process_into(
+            np.zeros((3, 1000), dtype=np.float32), np.zeros((2, 1000), dtype=np.float32)
+        )
+
+    read_only = np.zeros((2, 1000), dtype=np.float32)
+    read_only.flags.writeable = False
+    with pytest.raises(ValueError):
+        resampler.process_into(audio, read_only)
+
+
+@pytest.mark.parametrize("sample_rate,target_sample_rate", [(48000, 16000), (44100, 16000)])
+def test_polyphase_resampling_does_not_alias(sample_rate: float, target_sample_rate: float):
+    # A tone above the target Nyquist frequency should be filtered out entirely:
+    tone = generate_sine_at(sample_rate, 10_000, num_seconds=1).astype(np.float32)
+
+    resampler = StreamResampler(sample_rate, target_sample_rate, 1, Resample.Quality.Polyphase)
+    output = np.concatenate([resampler.process(tone), resampler.process(None)], axis=1)
+    assert np.sqrt(np.mean(output**2)) < 0.01
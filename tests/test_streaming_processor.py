@@ -0,0 +1,128 @@
+#! /usr/bin/env python
+#
+# Copyright 2023 Spotify AB
+#
+# Licensed under the GNU Public License, Version 3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import threading
+
+import numpy as np
+import pytest
+
+from pedalboard import Gain, Mix, Pedalboard, Reverb, StreamingProcessor
+from pedalboard_native._internal import AddLatency
+
+
+SAMPLE_RATE = 44100
+
+
+def make_board():
+    return Pedalboard([Gain(-6), AddLatency(1234), Mix([Gain(0), AddLatency(100)]), Reverb()])
+
+
+def stream_in_chunks(stream, audio: np.ndarray, chunk_size: int) -> np.ndarray:
+    outputs = []
+    for start in range(0, audio.shape[-1], chunk_size):
+        outputs.append(stream.push(audio[..., start : start + chunk_size]))
+    outputs.append(stream.flush())
+    return np.concatenate(outputs, axis=-1)
+
+
+@pytest.mark.parametrize("chunk_size", [1, 100, 4096, 10000, SAMPLE_RATE * 2])
+@pytest.mark.parametrize("dtype", [np.float32, np.float64])
+def test_streaming_matches_process(chunk_size: int, dtype):
+    audio = np.random.rand(2, SAMPLE_RATE).astype(dtype)
+    expected = make_board().process(audio, SAMPLE_RATE)
+
+    stream = make_board().stream(SAMPLE_RATE, 2)
+    output = stream_in_chunks(stream, audio, chunk_size)
+
+    assert output.shape == expected.shape
+    assert output.dtype == dtype
+    np.testing.assert_allclose(output, expected, atol=1e-5)
+
+
+def test_streaming_returns_latency_compensated_output():
+    audio = np.random.rand(1, 10000).astype(np.float32)
+    stream = StreamingProcessor([AddLatency(1000)], SAMPLE_RATE, 1, buffer_size=512)
+
+    first = stream.push(audio[:, :600])
+    assert first.shape == (1, 0)
+    assert stream.samples_pushed == 600
+    assert stream.samples_returned == 0
+
+    rest = stream.push(audio[:, 600:])
+    assert rest.shape == (1, 10000 - 1000)
+    np.testing.assert_allclose(rest, audio[:, : rest.shape[1]])
+
+    tail = stream.flush()
+    assert tail.shape == (1, 1000)
+    np.testing.assert_allclose(tail, audio[:, -1000:])
+
+
+def test_streaming_preserves_channel_layout():
+    audio = np.random.rand(5000, 2).astype(np.float32)
+    stream = Gain(0).stream(SAMPLE_RATE, 2)
+    output = np.concatenate([stream.push(audio[:2500]), stream.push(audio[2500:]), stream.flush()])
+    np.testing.assert_allclose(output, audio)
+
+    mono = np.random.rand(5000).astype(np.float32)
+    stream = Gain(0).stream(SAMPLE_RATE, 1)
+    output = np.concatenate([stream.push(mono), stream.flush()])
+    assert output.shape == mono.shape
+
+
+def test_streaming_can_be_reused_after_flush():
+    audio = np.random.rand(2, SAMPLE_RATE).astype(np.float32)
+    stream = make_board().stream(SAMPLE_RATE, 2)
+    first = stream_in_chunks(stream, audio, 1000)
+    second = stream_in_chunks(stream, audio, 1000)
+    np.testing.assert_allclose(first, second, atol=1e-6)
+
+
+def test_streaming_rejects_wrong_channel_count_and_dtype():
+    stream = Gain(0).stream(SAMPLE_RATE, 2)
+    with pytest.raises(ValueError):
+        stream.push(np.zeros((3, 100), dtype=np.float32))
+
+    stream.push(np.zeros((2, 100), dtype=np.float32))
+    with pytest.raises(TypeError):
+        stream.push(np.zeros((2, 100), dtype=np.float64))
+
+
+def test_concurrent_pushes_return_whole_chunks():
+    # Each push returns a copy of its output made while the stream was locked,
+    # so other threads pushing into the same stream can't overwrite (or
+    # resize) it before it's returned:
+    stream = StreamingProcessor([Gain(-6)], SAMPLE_RATE, 2)
+    chunk_size = 4096
+    errors = []
+
+    def push_many(value: float):
+        chunk = np.full((2, chunk_size), value, dtype=np.float32)
+        expected = np.float32(value * 10 ** (-6 / 20))
+        try:
+            for _ in range(200):
+                output = stream.push(chunk)
+                assert output.shape == (2, chunk_size)
+                np.testing.assert_allclose(output, expected, rtol=1e-5)
+        except Exception as e:
+            errors.append(e)
+
+    threads = [threading.Thread(target=push_many, args=(i + 1,)) for i in range(4)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    assert not errors
@@ -110,11 +110,19 @@ int decode1_headersB_clipchoice(
     switch (pmp->fr.stereo) {
     case 1:
       processed_samples = processed_bytes / decoded_sample_size;
-      COPY_MONO(short, short)
+      if (decoded_sample_size == sizeof(FLOAT)) {
+        COPY_MONO(float, FLOAT)
+      } else {
+        COPY_MONO(short, short)
+      }
       break;
     case 2:
       processed_samples = (processed_bytes / decoded_sample_size) >> 1;
-      COPY_STEREO(short, short)
+      if (decoded_sample_size == sizeof(FLOAT)) {
+        COPY_STEREO(float, FLOAT)
+      } else {
+        COPY_STEREO(short, short)
+      }
       break;
     default:
       processed_samples = -1;
@@ -167,7 +175,7 @@ int hip_decode_threadsafe(hip_t hip, unsigned char *buffer, size_t len,
 
   for (;;) {
     int ret = decode1_headersB_clipchoice(
-        hip, buffer, len, (char *)pcm_l + totsize, (char *)pcm_r + totsize,
+        hip, buffer, len, (char *)(pcm_l + totsize), (char *)(pcm_r + totsize),
         &mp3data, &enc_delay, &enc_padding, out, OUTSIZE_CLIPPED, sizeof(short),
         decodeMP3);
 
@@ -182,4 +190,43 @@ int hip_decode_threadsafe(hip_t hip, unsigned char *buffer, size_t len,
       break;
     }
   }
-}
\ No newline at end of file
+}
+
+#define OUTSIZE_UNCLIPPED (1152 * 2 * sizeof(FLOAT))
+
+/*
+ * As hip_decode_threadsafe, but outputs unclipped floating-point samples
+ * (scaled to the range of a signed 16-bit integer) instead of clipping them to
+ * 16-bit integers.
+ */
+int hip_decode_unclipped_threadsafe(hip_t hip, unsigned char *buffer,
+                                    size_t len, float pcm_l[],
+                                    float pcm_r[]) {
+  mp3data_struct mp3data;
+  int totsize = 0; /* number of decoded samples per channel */
+  int enc_delay, enc_padding;
+
+  if (!hip) {
+    return -1;
+  }
+
+  char out[OUTSIZE_UNCLIPPED];
+
+  for (;;) {
+    int ret = decode1_headersB_clipchoice(
+        hip, buffer, len, (char *)(pcm_l + totsize), (char *)(pcm_r + totsize),
+        &mp3data, &enc_delay, &enc_padding, out, OUTSIZE_UNCLIPPED,
+        sizeof(FLOAT), decodeMP3_unclipped);
+
+    switch (ret) {
+    case -1:
+      return ret;
+    case 0:
+      return totsize;
+    default:
+      totsize += ret;
+      len = 0; /* future calls to decodeMP3 are just to flush buffers */
+      break;
+    }
+  }
+}
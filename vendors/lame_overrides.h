@@ -14,4 +14,11 @@
  * file.
  */
 int hip_decode_threadsafe(hip_t hip, unsigned char *buffer, size_t len,
-                          short pcm_l[], short pcm_r[]);
\ No newline at end of file
+                          short pcm_l[], short pcm_r[]);
+
+/*
+ * As hip_decode_threadsafe, but outputs unclipped floating-point samples
+ * (scaled to the range of a signed 16-bit integer).
+ */
+int hip_decode_unclipped_threadsafe(hip_t hip, unsigned char *buffer,
+                                    size_t len, float pcm_l[], float pcm_r[]);